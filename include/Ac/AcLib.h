@@ -11,7 +11,27 @@
 
 #include "AudioSystem.h"
 #include "WaveBuffer.h"
+#include "WaveBufferView.h"
+#include "SampleAllocator.h"
+#include "ThreadPool.h"
+#include "Resampler.h"
+#include "ChannelMixer.h"
 #include "Synthesizer.h"
+#include "Oscillator.h"
+#include "NoiseGenerator.h"
+#include "FFT.h"
+#include "STFT.h"
+#include "AudioEffect.h"
+#include "EffectStream.h"
+#include "ConvolutionReverb.h"
+#include "FDNReverb.h"
+#include "BiquadFilter.h"
+#include "ParametricEqualizer.h"
+#include "Compressor.h"
+#include "Limiter.h"
+#include "Ducker.h"
+#include "CrossfadeCurve.h"
+#include "CrossfadeStream.h"
 #include "ChannelTypes.h"
 #include "Visualizer.h"
 
@@ -0,0 +1,83 @@
+/*
+ * AudioEffect.h
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef AC_AUDIO_EFFECT_H
+#define AC_AUDIO_EFFECT_H
+
+
+#include <Ac/Export.h>
+#include <Ac/WaveBufferView.h>
+#include <cstddef>
+#include <cstdint>
+
+
+namespace Ac
+{
+
+
+/**
+\brief Audio effect interface for block processing.
+\remarks An effect processes interleaved floating-point samples in place and keeps its state between the blocks,
+so the block sizes can vary from call to call. Effects can be chained in an EffectStream to process an AudioStream,
+or applied directly to the blocks which are queued with Sound::QueueBuffer.
+\see EffectStream
+*/
+class AC_EXPORT AudioEffect
+{
+
+    public:
+
+        virtual ~AudioEffect()
+        {
+        }
+
+        /**
+        \brief Processes the specified interleaved sample frames in place.
+        \param[in,out] samples Pointer to the interleaved samples. This must contain at least 'frames * GetChannels()' samples.
+        \param[in] frames Specifies the number of sample frames.
+        */
+        virtual void Process(float* samples, std::size_t frames) = 0;
+
+        //! Resets the processing state, e.g. clears all delay lines and pending samples.
+        virtual void Reset() = 0;
+
+        //! Returns the number of interleaved channels this effect processes.
+        virtual std::uint16_t GetChannels() const = 0;
+
+        //! Returns the number of sample frames by which the output lags behind the input. By default 0.
+        virtual std::size_t GetLatency() const
+        {
+            return 0;
+        }
+
+        /**
+        \brief Returns the number of sample frames the effect still produces output after the input has ended (e.g. the reverberation). By default 0.
+        \remarks The latency is not included, i.e. the entire output ends 'GetLatency() + GetTailFrames()' sample frames after the input.
+        */
+        virtual std::size_t GetTailFrames() const
+        {
+            return 0;
+        }
+
+        /**
+        \brief Processes the samples of the specified view in place, which are converted from and to floating-point samples in small blocks.
+        \param[in] view Specifies the sample frames which are to be processed. Its number of channels must be equal to 'GetChannels()'.
+        \throws std::invalid_argument If the number of channels of the view does not match this effect.
+        */
+        void ProcessWaveBuffer(const WaveBufferView& view);
+
+};
+
+
+} // /namespace Ac
+
+
+#endif
+
+
+
+// ================================================================================
@@ -9,7 +9,7 @@
 #define AC_AUDIO_STREAM_H
 
 
-#include <Ac/WaveBuffer.h>
+#include <Ac/WaveBufferView.h>
 #include <Ac/Export.h>
 #include <istream>
 #include <vector>
@@ -30,13 +30,29 @@ class AC_EXPORT AudioStream
         {
         }
 
+        /**
+        \brief Reads the audio data from the active stream and stores it in the referenced sample frames.
+        \param[out] buffer Specifies the output view. Its format must be equal to the format of this stream (see GetFormat) with interleaved storage.
+        This can be used to stream directly into a range of a larger wave buffer.
+        \return Number of bytes read from the input stream. If this is zero, the end of the stream has been reached.
+        \throws std::invalid_argument If the format or storage of the view does not match this stream.
+        \throws std::runtime_exception If something went wrong while reading.
+        */
+        virtual std::size_t StreamWaveBuffer(const WaveBufferView& buffer) = 0;
+
         /**
         \brief Reads the audio data from the active stream and stores it in the wave buffer.
-        \param[out] buffer Specifies the output wave buffer.
+        \param[out] buffer Specifies the output wave buffer. Its storage and format will be changed to match this stream, but its size remains unchanged.
         \return Number of bytes read from the input stream. If this is zero, the end of the stream has been reached.
         \throws std::runtime_exception If something went wrong while reading.
+        \see StreamWaveBuffer(const WaveBufferView&)
         */
-        virtual std::size_t StreamWaveBuffer(WaveBuffer& buffer) = 0;
+        inline std::size_t StreamWaveBuffer(WaveBuffer& buffer)
+        {
+            buffer.SetStorage(WaveBufferStorage::Interleaved);
+            buffer.SetFormat(GetFormat());
+            return StreamWaveBuffer(WaveBufferView(buffer));
+        }
 
         /**
         \briefs Sets the new time point from where to stream the audio data.
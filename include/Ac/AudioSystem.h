@@ -214,6 +214,19 @@ class AC_EXPORT AudioSystem
         */
         WaveBuffer ReadWaveBuffer(std::istream& stream);
 
+        /**
+        \brief Maps the audio data of the specified file into memory and returns a read-only wave buffer which refers to it.
+        \param[in] filename Specifies the filename of the input file.
+        \remarks If the PCM payload of the file is stored exactly like the interleaved wave buffer storage (e.g. uncompressed RIFF WAVE files on little-endian systems),
+        the wave buffer refers directly to the memory-mapped file, so the samples are loaded on demand and shared between processes by the page cache of the operating system.
+        Otherwise, or if the file can not be mapped, the audio data is read like with "ReadWaveBuffer".
+        The memory-mapped samples are duplicated on the first write access to the wave buffer.
+        \throws std::runtime_exception If something went wrong while reading.
+        \see WaveBuffer::AttachExternalData
+        \see ReadWaveBuffer(const std::string&)
+        */
+        WaveBuffer MapWaveBuffer(const std::string& filename);
+
         /**
         \brief Opens a new audio stream form the specified file.
         \param[in] filename Specifies the filename of the input file stream.
@@ -233,9 +246,18 @@ class AC_EXPORT AudioSystem
         /**
         \brief Writes the audio data to the specified stream.
         \param[in,out] stream Specifies the output stream to write to. This stream must be opened in binary mode!
-        \param[out] waveBuffer Specifies the input wave buffer.
+        \param[in] waveBuffer Specifies the input wave buffer or a view onto a range of sample frames.
         \return True if the stream has been written successfully.
         \throws std::runtime_exception If something went wrong while writing.
+        \see WaveBufferConstView
+        */
+        bool WriteAudioBuffer(const AudioFormats format, std::ostream& stream, const WaveBufferConstView& waveBuffer);
+
+        /**
+        \brief Writes the audio data of the specified wave buffer to the stream.
+        \remarks In contrast to the overload with a view, the chunks of the wave buffer are written one after another without flattening them.
+        \see WriteAudioBuffer(const AudioFormats, std::ostream&, const WaveBufferConstView&)
+        \see WaveBuffer::SetChunkSize
         */
         bool WriteAudioBuffer(const AudioFormats format, std::ostream& stream, const WaveBuffer& waveBuffer);
 
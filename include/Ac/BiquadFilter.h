@@ -0,0 +1,166 @@
+/*
+ * BiquadFilter.h
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef AC_BIQUAD_FILTER_H
+#define AC_BIQUAD_FILTER_H
+
+
+#include <Ac/Export.h>
+#include <Ac/AudioEffect.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace Ac
+{
+
+
+//! Biquad filter type enumeration (see the "Audio EQ Cookbook" by Robert Bristow-Johnson).
+enum class BiquadType
+{
+    LowPass,    //!< Low-pass filter. The Q factor specifies the resonance at the cutoff frequency.
+    HighPass,   //!< High-pass filter. The Q factor specifies the resonance at the cutoff frequency.
+    BandPass,   //!< Band-pass filter with a peak gain of 0 dB. The Q factor specifies the bandwidth.
+    Notch,      //!< Notch (band-stop) filter. The Q factor specifies the bandwidth.
+    LowShelf,   //!< Low-shelf filter, which amplifies the frequencies below the corner frequency by the gain.
+    HighShelf,  //!< High-shelf filter, which amplifies the frequencies above the corner frequency by the gain.
+    Peaking,    //!< Peaking (bell) filter, which amplifies the frequencies around the center frequency by the gain.
+};
+
+//! Normalized coefficients of a biquad filter: H(z) = (b0 + b1*z^-1 + b2*z^-2) / (1 + a1*z^-1 + a2*z^-2).
+struct AC_EXPORT BiquadCoefficients
+{
+    /**
+    \brief Computes the coefficients of the specified filter type.
+    \param[in] type Specifies the filter type.
+    \param[in] sampleRate Specifies the sample rate (in Hz).
+    \param[in] frequency Specifies the cutoff, corner, or center frequency (in Hz). This will be clamped to the range (0, sampleRate/2).
+    \param[in] q Specifies the Q factor. By default 1/sqrt(2), i.e. a Butterworth response for low-pass and high-pass filters.
+    \param[in] gain Specifies the gain (in dB) of shelf and peaking filters. Ignored for all other filter types. By default 0.
+    \throws std::invalid_argument If the sample rate is zero or the Q factor is not positive.
+    */
+    static BiquadCoefficients Compute(
+        const BiquadType    type,
+        std::uint32_t       sampleRate,
+        double              frequency,
+        double              q       = 0.7071067811865476,
+        double              gain    = 0.0
+    );
+
+    float b0 = 1.0f;
+    float b1 = 0.0f;
+    float b2 = 0.0f;
+    float a1 = 0.0f;
+    float a2 = 0.0f;
+};
+
+/**
+\brief Bank of independent biquad filters, which are processed in parallel lanes.
+\remarks Each lane is a biquad filter in transposed direct form II with its own coefficients and state.
+The lanes are filtered in groups of up to 8 adjacent lanes, whose coefficients and states are kept in SIMD registers,
+i.e. the filter update of a group is a loop over the lanes the compiler vectorizes.
+A lane can be a channel of interleaved samples (see Process), or a separate signal like the samples of a voice (see ProcessPlanar).
+New coefficients are approached smoothly (see SetSmoothingFrames) to avoid clicks when filters are modulated.
+\code
+// Filter 256 voices with individual low-pass filters
+Ac::BiquadFilterBank bank(256);
+for (std::size_t i = 0; i < 256; ++i)
+    bank.SetFilter(i, Ac::BiquadCoefficients::Compute(Ac::BiquadType::LowPass, 44100, voiceCutoff[i]));
+bank.ProcessPlanar(voiceSamples, frames);
+\endcode
+*/
+class AC_EXPORT BiquadFilterBank : public AudioEffect
+{
+
+    public:
+
+        /**
+        \brief Initializes the filter bank with pass-through filters.
+        \param[in] lanes Specifies the number of filters.
+        \throws std::invalid_argument If the number of lanes is zero or greater than 65535.
+        */
+        BiquadFilterBank(std::size_t lanes);
+
+        /**
+        \brief Sets the coefficients of the specified lane.
+        \param[in] lane Specifies the lane index.
+        \param[in] coefficients Specifies the new coefficients.
+        \param[in] immediate Specifies whether the coefficients are applied immediately (e.g. for a new voice) instead of smoothly. By default false.
+        \throws std::out_of_range If the lane index is out of range.
+        */
+        void SetFilter(std::size_t lane, const BiquadCoefficients& coefficients, bool immediate = false);
+
+        //! Sets the coefficients of all lanes. \see SetFilter(std::size_t, const BiquadCoefficients&, bool)
+        void SetFilter(const BiquadCoefficients& coefficients, bool immediate = false);
+
+        //! Returns the (target) coefficients of the specified lane. \throws std::out_of_range If the lane index is out of range.
+        BiquadCoefficients GetFilter(std::size_t lane) const;
+
+        /**
+        \brief Sets the time constant (in sample frames) of the coefficient smoothing. By default 256.
+        \remarks The coefficients approach the new coefficients exponentially, i.e. by about 63% after the specified number of sample frames.
+        If this is zero, new coefficients are applied immediately.
+        */
+        void SetSmoothingFrames(std::size_t frames);
+
+        //! Filters the interleaved samples in place, where each sample frame contains one sample for each lane.
+        void Process(float* samples, std::size_t frames) override;
+
+        /**
+        \brief Filters the separate sample arrays of all lanes in place.
+        \param[in,out] lanes Array of 'GetNumLanes()' pointers to the samples of each lane.
+        \param[in] frames Specifies the number of samples of each lane.
+        */
+        void ProcessPlanar(float* const* lanes, std::size_t frames);
+
+        //! Clears the filter states and applies all pending coefficients immediately.
+        void Reset() override;
+
+        //! Returns the number of lanes (for the AudioEffect interface).
+        std::uint16_t GetChannels() const override;
+
+        //! Returns the number of lanes.
+        inline std::size_t GetNumLanes() const
+        {
+            return b0_.size();
+        }
+
+    private:
+
+        void UpdateCoefficients();
+        void ProcessSteps(float* samples, float* const* lanes, std::size_t frames);
+        void ProcessFrames(float* samples, std::size_t frames);
+        void ProcessFramesPlanar(float* const* lanes, std::size_t offset, std::size_t frames);
+        void FlushDenormals();
+
+    private:
+
+        // Current coefficients of all lanes
+        std::vector<float>  b0_, b1_, b2_, a1_, a2_;
+
+        // Target coefficients of all lanes
+        std::vector<float>  targetB0_, targetB1_, targetB2_, targetA1_, targetA2_;
+
+        // Filter states (transposed direct form II) of all lanes
+        std::vector<float>  z1_, z2_;
+
+        float               smoothingFactor_    = 0.0f;     // Factor by which the coefficients approach the targets per smoothing step
+        bool                smoothing_          = false;    // Specifies whether any coefficients differ from the targets
+        std::size_t         smoothingPhase_     = 0;        // Number of sample frames processed since the last smoothing step
+
+};
+
+
+} // /namespace Ac
+
+
+#endif
+
+
+
+// ================================================================================
@@ -0,0 +1,136 @@
+/*
+ * ChannelMixer.h
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef AC_CHANNEL_MIXER_H
+#define AC_CHANNEL_MIXER_H
+
+
+#include <Ac/Export.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace Ac
+{
+
+
+/**
+\brief Channel remixing matrix engine.
+\remarks Each output channel is a weighted sum of all input channels, i.e. the mixer applies a gain matrix
+with 'outputChannels' rows and 'inputChannels' columns (in row-major order) to every sample frame.
+The standard matrices are derived from the channel layouts in "ChannelTypes.h":
+\code
+1 channel:  Mono (treated as front center)
+2 channels: ChannelTypes2
+3 channels: ChannelTypes3
+4 channels: ChannelTypes4
+5 channels: ChannelTypes5
+6 channels: ChannelTypes5_1
+7 channels: ChannelTypes6_1
+8 channels: ChannelTypes7_1
+\endcode
+Speakers which are missing in the output layout are folded down with -3 dB into the nearest speakers (ITU-R BS.775 style),
+the LFE channel is dropped on downmix, and each matrix row is normalized to avoid clipping.
+Channel counts without a known layout are mapped one-to-one.
+\code
+// Downmix a 5.1 surround block to stereo
+Ac::ChannelMixer mixer(6, 2);
+mixer.Process(surroundSamples.data(), frames, stereoSamples.data());
+\endcode
+\see ChannelTypes5_1
+\see ChannelTypes7_1
+\see WaveBuffer::RemixChannels
+*/
+class AC_EXPORT ChannelMixer
+{
+
+    public:
+
+        /**
+        \brief Initializes the mixer with the standard matrix for the specified channel layouts.
+        \throws std::invalid_argument If any of the channel counts is zero.
+        \see StandardMatrix
+        */
+        ChannelMixer(std::uint16_t inputChannels, std::uint16_t outputChannels);
+
+        /**
+        \brief Initializes the mixer with a user-supplied gain matrix.
+        \param[in] matrix Specifies the gains in row-major order, i.e. 'matrix[outputChannel * inputChannels + inputChannel]'.
+        \throws std::invalid_argument If any of the channel counts is zero or the matrix does not have 'outputChannels * inputChannels' elements.
+        */
+        ChannelMixer(std::uint16_t inputChannels, std::uint16_t outputChannels, const std::vector<float>& matrix);
+
+        /**
+        \brief Remixes the specified interleaved sample frames.
+        \param[in] input Pointer to the interleaved input samples. This must contain at least 'frames * inputChannels' samples.
+        \param[in] frames Specifies the number of sample frames.
+        \param[out] output Pointer to the interleaved output samples. This must contain at least 'frames * outputChannels' samples.
+        \remarks The input and output must not overlap. Samples are not clamped.
+        */
+        void Process(const float* input, std::size_t frames, float* output);
+
+        /**
+        \brief Remixes the specified planar sample frames.
+        \param[in] inputs Array of 'inputChannels' pointers to the input samples of each channel.
+        \param[in] frames Specifies the number of sample frames.
+        \param[out] outputs Array of 'outputChannels' pointers to the output samples of each channel.
+        \remarks The output planes must not overlap with the input planes. Samples are not clamped.
+        */
+        void ProcessPlanar(const float* const* inputs, std::size_t frames, float* const* outputs) const;
+
+        //! Sets the gain of the specified input channel for the specified output channel.
+        void SetGain(std::uint16_t outputChannel, std::uint16_t inputChannel, float gain);
+
+        //! Returns the gain of the specified input channel for the specified output channel.
+        float GetGain(std::uint16_t outputChannel, std::uint16_t inputChannel) const;
+
+        //! Returns the gain matrix in row-major order.
+        inline const std::vector<float>& GetMatrix() const
+        {
+            return matrix_;
+        }
+
+        //! Returns the number of input channels.
+        inline std::uint16_t GetInputChannels() const
+        {
+            return inputChannels_;
+        }
+
+        //! Returns the number of output channels.
+        inline std::uint16_t GetOutputChannels() const
+        {
+            return outputChannels_;
+        }
+
+        /**
+        \brief Returns the standard gain matrix (in row-major order) to remix the specified input layout into the specified output layout.
+        \remarks If both channel counts are equal, this is the identity matrix.
+        */
+        static std::vector<float> StandardMatrix(std::uint16_t inputChannels, std::uint16_t outputChannels);
+
+    private:
+
+        std::uint16_t               inputChannels_  = 0;
+        std::uint16_t               outputChannels_ = 0;
+        std::vector<float>          matrix_;
+
+        std::vector<float>          planes_;        // Scratch memory for the planar input and output samples of "Process"
+        std::vector<const float*>   inputPlanes_;
+        std::vector<float*>         outputPlanes_;
+
+};
+
+
+} // /namespace Ac
+
+
+#endif
+
+
+
+// ================================================================================
@@ -0,0 +1,106 @@
+/*
+ * Compressor.h
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef AC_COMPRESSOR_H
+#define AC_COMPRESSOR_H
+
+
+#include <Ac/Export.h>
+#include <Ac/AudioEffect.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace Ac
+{
+
+
+//! Parameters of the dynamic range compressor.
+struct AC_EXPORT CompressorParameters
+{
+    double  threshold   = -18.0;    //!< Level (in dB) above which the signal is compressed.
+    double  ratio       = 4.0;      //!< Compression ratio (at least 1), i.e. a level 'ratio' dB above the threshold is reduced to 1 dB above the threshold.
+    double  knee        = 6.0;      //!< Width (in dB) of the soft knee around the threshold. Zero for a hard knee.
+    double  attackTime  = 0.01;     //!< Time (in seconds) in which the gain reduction reaches about 63% of a rising level.
+    double  releaseTime = 0.15;     //!< Time (in seconds) in which the gain reduction recovers by about 63% from a falling level.
+    double  makeupGain  = 0.0;      //!< Gain (in dB) which is applied after the compression.
+    bool    linked      = true;     //!< Specifies whether all channels are reduced by the same gain (from the loudest channel), which keeps the stereo image.
+};
+
+/**
+\brief Dynamic range compressor with soft knee and peak detection.
+\remarks The samples are processed in blocks: the peak levels of a block are detected and converted to decibels,
+and the gain reduction is computed and applied to the block with vector kernels. Only the attack and release of the
+gain reduction is a recursion from sample to sample (one per channel if the channels are not linked).
+\code
+Ac::CompressorParameters params;
+params.threshold    = -20.0;
+params.ratio        = 3.0;
+params.makeupGain   = 4.0;
+
+Ac::Compressor compressor(44100, 2, params);
+compressor.ProcessWaveBuffer(waveBuffer);
+\endcode
+\see Limiter
+*/
+class AC_EXPORT Compressor : public AudioEffect
+{
+
+    public:
+
+        /**
+        \brief Initializes the compressor with the specified parameters.
+        \param[in] sampleRate Specifies the sample rate (in Hz) of the processed samples.
+        \param[in] channels Specifies the number of interleaved channels.
+        \param[in] parameters Specifies the compressor parameters.
+        \throws std::invalid_argument If the sample rate or the number of channels is zero.
+        */
+        Compressor(std::uint32_t sampleRate, std::uint16_t channels, const CompressorParameters& parameters = {});
+
+        //! Compresses the interleaved samples in place.
+        void Process(float* samples, std::size_t frames) override;
+
+        //! Resets the gain reduction.
+        void Reset() override;
+
+        std::uint16_t GetChannels() const override;
+
+        //! Sets the new parameters. The parameters are clamped to their valid ranges.
+        void SetParameters(const CompressorParameters& parameters);
+
+        //! Returns the (clamped) compressor parameters.
+        inline const CompressorParameters& GetParameters() const
+        {
+            return parameters_;
+        }
+
+        //! Returns the current gain reduction (in dB) of the most reduced channel, e.g. for a level meter. This is zero or positive.
+        float GetGainReduction() const;
+
+    private:
+
+        std::uint32_t           sampleRate_     = 0;
+        std::uint16_t           channels_       = 0;
+        CompressorParameters    parameters_;
+
+        float                   attack_         = 0.0f;     // Smoothing coefficient for the attack
+        float                   release_        = 0.0f;     // Smoothing coefficient for the release
+        std::vector<float>      envelopes_;                 // Gain reduction (in dB) of each detector lane
+        std::vector<float>      levels_;                    // Levels, gain reductions, and gains of the current block
+
+};
+
+
+} // /namespace Ac
+
+
+#endif
+
+
+
+// ================================================================================
@@ -0,0 +1,160 @@
+/*
+ * ConvolutionReverb.h
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef AC_CONVOLUTION_REVERB_H
+#define AC_CONVOLUTION_REVERB_H
+
+
+#include <Ac/AudioEffect.h>
+#include <Ac/FFT.h>
+#include <Ac/WaveBufferView.h>
+#include <complex>
+#include <memory>
+#include <vector>
+
+
+namespace Ac
+{
+
+
+/**
+\brief Streaming convolution reverb with an impulse response (IR) of arbitrary length.
+\remarks The IR is split into partitions which grow with the distance from the beginning of the IR (non-uniform partitioned convolution):
+the first partitions have the block size, and each following group of partitions is four times larger, up to 16384 sample frames.
+All partitions are transformed once on construction, and the spectra of the input blocks are reused for all partitions of the same size,
+so the costs per sample grow only logarithmically with the length of the IR. The output lags behind the input by exactly one block (see GetLatency).
+Since the larger partitions are processed at once when their input block is complete, the costs of single calls to "Process" vary.
+For offline processing of entire wave buffers without latency, use ConvolveWaveBuffer instead.
+\code
+auto impulseResponse = audioSystem->ReadWaveBuffer("Hall.wav");
+Ac::ConvolutionReverb reverb(impulseResponse, 2);
+reverb.SetDryGain(1.0f);
+reverb.SetWetGain(0.3f);
+reverb.Process(samples.data(), frames);
+\endcode
+\see EffectStream
+*/
+class AC_EXPORT ConvolutionReverb : public AudioEffect
+{
+
+    public:
+
+        /**
+        \brief Initializes the reverb and transforms the partitions of the impulse response.
+        \param[in] impulseResponse Specifies the impulse response. Its sample rate must be equal to the sample rate of the processed samples.
+        If it has fewer channels than the reverb, its channels are repeated (e.g. a mono IR is applied to all channels).
+        \param[in] channels Specifies the number of interleaved channels which are processed.
+        \param[in] blockSize Specifies the size (in sample frames) of the smallest partitions, which is also the latency. By default 256.
+        Powers of two are recommended.
+        \throws std::invalid_argument If the number of channels (of the reverb or of the IR) or the block size is zero.
+        */
+        ConvolutionReverb(const WaveBufferConstView& impulseResponse, std::uint16_t channels, std::size_t blockSize = 256);
+
+        //! Convolves the interleaved samples with the impulse response and mixes them with the delayed input samples.
+        void Process(float* samples, std::size_t frames) override;
+
+        //! Clears the input history and all pending output samples.
+        void Reset() override;
+
+        std::uint16_t GetChannels() const override;
+
+        //! Returns the block size, since the output lags behind the input by exactly one block.
+        std::size_t GetLatency() const override;
+
+        //! Returns the length of the impulse response (in sample frames).
+        std::size_t GetTailFrames() const override;
+
+        //! Sets the gain of the reverberated signal. By default 1.
+        inline void SetWetGain(float gain)
+        {
+            wetGain_ = gain;
+        }
+
+        //! Returns the gain of the reverberated signal.
+        inline float GetWetGain() const
+        {
+            return wetGain_;
+        }
+
+        //! Sets the gain of the (delayed) input signal. By default 0, i.e. the output only contains the reverberated signal.
+        inline void SetDryGain(float gain)
+        {
+            dryGain_ = gain;
+        }
+
+        //! Returns the gain of the (delayed) input signal.
+        inline float GetDryGain() const
+        {
+            return dryGain_;
+        }
+
+        //! Returns the size of the smallest partitions (in sample frames).
+        inline std::size_t GetBlockSize() const
+        {
+            return blockSize_;
+        }
+
+        //! Returns the sample rate (in Hz) of the impulse response.
+        inline std::uint32_t GetSampleRate() const
+        {
+            return sampleRate_;
+        }
+
+    private:
+
+        // Group of partitions of the same size, which is a uniformly partitioned convolution of a segment of the IR.
+        struct Level
+        {
+            std::size_t                                     blockSize       = 0;
+            std::size_t                                     numPartitions   = 0;
+            std::shared_ptr<const RealFFTPlan>              plan;
+            std::vector<std::vector<std::complex<float>>>   kernelSpectra;          // Spectra of all partitions for each IR channel
+            std::vector<std::vector<bool>>                  kernelNonZero;          // Specifies which partitions are non-zero for each IR channel
+            std::vector<std::vector<std::complex<float>>>   inputSpectra;           // Ring buffer of the input spectra for each channel
+            std::size_t                                     position        = 0;    // Ring buffer index of the latest input spectrum
+        };
+
+        void InitLevels(const WaveBufferConstView& impulseResponse);
+        void ProcessBlock();
+        void ProcessLevel(Level& level);
+
+    private:
+
+        std::uint16_t                       channels_       = 0;
+        std::size_t                         blockSize_      = 0;
+        std::uint16_t                       irChannels_     = 0;
+        std::size_t                         irFrames_       = 0;
+        std::uint32_t                       sampleRate_     = 0;
+
+        float                               wetGain_        = 1.0f;
+        float                               dryGain_        = 0.0f;
+
+        std::vector<Level>                  levels_;
+        std::size_t                         maxBlockSize_   = 0;    // Block size of the largest partitions
+
+        std::vector<std::vector<float>>     history_;               // Input samples for each channel, which ends with the current block
+        std::size_t                         historyEnd_     = 0;    // End of the current block within the input history
+        std::vector<std::vector<float>>     accum_;                 // Ring buffer of 'maxBlockSize_' pending output samples for each channel
+        std::size_t                         accumPosition_  = 0;    // Ring buffer index of the next output block
+        std::vector<std::vector<float>>     output_;                // Output samples of the current block for each channel
+        std::size_t                         blockPosition_  = 0;    // Number of sample frames in the current block
+        std::size_t                         blockCounter_   = 0;    // Number of completed blocks (modulo the number of blocks of the largest partitions)
+
+        std::vector<float>                  frame_;                 // Scratch memory for the FFT frames
+        std::vector<std::complex<float>>    spectrum_;
+
+};
+
+
+} // /namespace Ac
+
+
+#endif
+
+
+
+// ================================================================================
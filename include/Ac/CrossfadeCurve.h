@@ -0,0 +1,114 @@
+/*
+ * CrossfadeCurve.h
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef AC_CROSSFADE_CURVE_H
+#define AC_CROSSFADE_CURVE_H
+
+
+#include <Ac/Export.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+
+namespace Ac
+{
+
+
+//! Crossfade shape enumeration.
+enum class CrossfadeShape
+{
+    Linear,     //!< Linear crossfade, i.e. the gains sum up to one. Correlated signals keep their loudness, but uncorrelated signals drop by 3 dB in the middle.
+    EqualPower, //!< Equal-power crossfade with sine and cosine gains, i.e. the squared gains sum up to one. Uncorrelated signals (e.g. two songs) keep their loudness.
+    SCurve,     //!< Raised cosine crossfade, i.e. the gains sum up to one and start and end smoothly.
+};
+
+/**
+\brief Crossfade curve with precomputed gain tables for the fade-out and fade-in.
+\remarks The gains are looked up in tables with linear interpolation, so no trigonometric or user function is called per sample.
+The crossfade itself is computed for blocks of interleaved sample frames with a vector kernel (see Blend).
+\code
+// Equal-power crossfade over two seconds of two 44.1 kHz stereo blocks
+Ac::CrossfadeCurve curve(Ac::CrossfadeShape::EqualPower);
+curve.Blend(output, songA, songB, frames, 2, position, 1.0 / (2.0 * 44100.0));
+\endcode
+\see Synthesizer::FadeWaveBuffers
+\see CrossfadeStream
+*/
+class AC_EXPORT CrossfadeCurve
+{
+
+    public:
+
+        //! Number of table segments. Each table has one more entry, for both ends of the curve.
+        static const std::size_t tableSize = 1024;
+
+        //! Initializes the curve with the specified shape. By default CrossfadeShape::EqualPower.
+        CrossfadeCurve(const CrossfadeShape shape = CrossfadeShape::EqualPower);
+
+        /**
+        \brief Initializes the curve with a fading function, which modifies the interpolation value in the range [0, 1].
+        \remarks The fade-in gain is the modified interpolation value, and the fade-out gain is one minus that value (like a linear interpolation).
+        The function is only called to fill the table. If the function is null, the curve is linear.
+        \see Synthesizer::FadingFunction
+        */
+        explicit CrossfadeCurve(const std::function<void(double& t)>& fading);
+
+        /**
+        \brief Computes the fade-out and fade-in gains of consecutive sample frames.
+        \param[in] position Specifies the position of the first sample frame on the curve, where 0 is the start and 1 is the end of the crossfade.
+        Positions outside the range [0, 1] are clamped, i.e. the gains are constant before and after the crossfade.
+        \param[in] step Specifies the position difference between two sample frames, i.e. one divided by the number of crossfade frames.
+        \param[in] frames Specifies the number of sample frames.
+        \param[out] gainsFrom Pointer to the fade-out gains. This must have 'frames' elements.
+        \param[out] gainsTo Pointer to the fade-in gains. This must have 'frames' elements.
+        */
+        void ComputeGains(double position, double step, std::size_t frames, float* gainsFrom, float* gainsTo) const;
+
+        /**
+        \brief Crossfades between two blocks of interleaved sample frames, i.e. 'output = from * fadeOut + to * fadeIn'.
+        \param[out] output Pointer to the output samples. This can be equal to 'from' or 'to'.
+        \param[in] from Pointer to the samples which are faded out.
+        \param[in] to Pointer to the samples which are faded in.
+        \param[in] frames Specifies the number of sample frames, i.e. each pointer must have 'frames * channels' samples.
+        \param[in] channels Specifies the number of interleaved channels.
+        \param[in] position Specifies the position of the first sample frame on the curve (see ComputeGains).
+        \param[in] step Specifies the position difference between two sample frames (see ComputeGains).
+        */
+        void Blend(
+            float*          output,
+            const float*    from,
+            const float*    to,
+            std::size_t     frames,
+            std::uint16_t   channels,
+            double          position,
+            double          step
+        ) const;
+
+        //! Returns the fade-out gain at the specified position in the range [0, 1].
+        float GetFadeOutGain(double position) const;
+
+        //! Returns the fade-in gain at the specified position in the range [0, 1].
+        float GetFadeInGain(double position) const;
+
+    private:
+
+        std::vector<float> fadeOut_;    // Fade-out gains at the positions 'i / tableSize'
+        std::vector<float> fadeIn_;     // Fade-in gains at the positions 'i / tableSize'
+
+};
+
+
+} // /namespace Ac
+
+
+#endif
+
+
+
+// ================================================================================
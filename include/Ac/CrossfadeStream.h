@@ -0,0 +1,121 @@
+/*
+ * CrossfadeStream.h
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef AC_CROSSFADE_STREAM_H
+#define AC_CROSSFADE_STREAM_H
+
+
+#include <Ac/AudioStream.h>
+#include <Ac/CrossfadeCurve.h>
+#include <Ac/WaveBuffer.h>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+
+namespace Ac
+{
+
+
+/**
+\brief Audio stream adapter which plays one audio stream after another with seamless crossfades, e.g. for music transitions.
+\remarks During a crossfade, both streams are read block by block and blended with the crossfade curve (see CrossfadeCurve),
+after which the stream continues with the new source only. Here is an example to change the music of a game level:
+\code
+auto music = std::make_shared<Ac::CrossfadeStream>(audioSystem->OpenAudioStream("Level1.ogg"));
+sound->SetStreamSource(music);
+Ac::InitStreaming(*sound);
+
+// Later, e.g. when the player enters a new area
+music->CrossfadeTo(audioSystem->OpenAudioStream("Level2.ogg"), 3.0);
+\endcode
+\see CrossfadeCurve
+*/
+class AC_EXPORT CrossfadeStream : public AudioStream
+{
+
+    public:
+
+        /**
+        \brief Initializes the crossfade stream with the specified source stream.
+        \throws std::invalid_argument If the source stream is null.
+        */
+        CrossfadeStream(const std::shared_ptr<AudioStream>& source);
+
+        /**
+        \brief Starts a crossfade from the current source stream to the specified source stream with the next streamed sample frames.
+        \param[in] source Specifies the new source stream. It is read from its current position, so it should be seeked beforehand if necessary.
+        \param[in] duration Specifies the duration (in seconds) of the crossfade. If this is zero, the sources are switched immediately.
+        \param[in] curve Specifies the crossfade curve. By default an equal-power curve, which keeps the loudness of uncorrelated songs.
+        \remarks If another crossfade is in progress, it is completed immediately.
+        \throws std::invalid_argument If the source stream is null or its format does not match the format of this stream.
+        */
+        void CrossfadeTo(
+            const std::shared_ptr<AudioStream>& source,
+            double                              duration,
+            const CrossfadeCurve&               curve       = CrossfadeCurve(CrossfadeShape::EqualPower)
+        );
+
+        //! Completes a crossfade in progress immediately, i.e. the new source stream is played from its current position.
+        void CompleteCrossfade();
+
+        using AudioStream::StreamWaveBuffer;
+
+        std::size_t StreamWaveBuffer(const WaveBufferView& buffer) override;
+
+        //! Completes a crossfade in progress and seeks the (new) source stream.
+        void Seek(double timePoint) override;
+
+        //! Returns the total time of the source stream, or the new source stream during a crossfade.
+        double TotalTime() const override;
+
+        std::vector<std::string> InfoComments() const override;
+
+        WaveBufferFormat GetFormat() const override;
+
+        //! Returns the current source stream, which is faded out during a crossfade.
+        inline const std::shared_ptr<AudioStream>& GetSource() const
+        {
+            return source_;
+        }
+
+        //! Returns the new source stream, which is faded in during a crossfade, or null if no crossfade is in progress.
+        inline const std::shared_ptr<AudioStream>& GetNextSource() const
+        {
+            return nextSource_;
+        }
+
+        //! Returns true if a crossfade is in progress.
+        inline bool IsCrossfading() const
+        {
+            return (nextSource_ != nullptr);
+        }
+
+    private:
+
+        std::shared_ptr<AudioStream>    source_;
+        std::shared_ptr<AudioStream>    nextSource_;
+
+        CrossfadeCurve                  curve_;
+        std::size_t                     fadeFrames_     = 0;    // Total number of sample frames of the crossfade
+        std::size_t                     fadeFrame_      = 0;    // Number of sample frames which have been crossfaded
+
+        WaveBuffer                      nextBuffer_;            // Sample frames of the new source stream
+        std::vector<float>              samplesFrom_;           // Floating-point samples of the current source stream
+        std::vector<float>              samplesTo_;             // Floating-point samples of the new source stream
+
+};
+
+
+} // /namespace Ac
+
+
+#endif
+
+
+
+// ================================================================================
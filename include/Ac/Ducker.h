@@ -0,0 +1,150 @@
+/*
+ * Ducker.h
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef AC_DUCKER_H
+#define AC_DUCKER_H
+
+
+#include <Ac/Export.h>
+#include <Ac/AudioEffect.h>
+#include <Ac/AudioStream.h>
+#include <Ac/WaveBuffer.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+
+namespace Ac
+{
+
+
+//! Parameters of the sidechain ducker.
+struct AC_EXPORT DuckerParameters
+{
+    double threshold    = -30.0;    //!< Level (in dB) of the sidechain signal above which the signal is ducked.
+    double depth        = 12.0;     //!< Attenuation (in dB) of the signal while the sidechain signal is active.
+    double range        = 6.0;      //!< Range (in dB) above the threshold in which the attenuation fades in, i.e. the full depth is reached at 'threshold + range'.
+    double attackTime   = 0.02;     //!< Time (in seconds) in which the attenuation reaches about 63% of the depth.
+    double releaseTime  = 0.4;      //!< Time (in seconds) in which the attenuation recovers by about 63% after the sidechain signal has become silent.
+};
+
+/**
+\brief Ducker, which attenuates a signal while a sidechain signal is active, e.g. music during dialogue.
+\remarks The sidechain signal can either be passed directly (see ProcessSidechain), or be read from a sidechain stream (see SetSidechainSource),
+so the ducker can be used in an EffectStream. Like the Compressor, the levels of a block are detected, converted, and applied with vector kernels.
+\code
+// Duck the music by 10 dB while the narration is playing
+Ac::DuckerParameters params;
+params.depth = 10.0;
+
+Ac::Ducker ducker(44100, 2, 1, params);
+ducker.ProcessSidechain(musicSamples, narrationSamples, frames);
+\endcode
+*/
+class AC_EXPORT Ducker : public AudioEffect
+{
+
+    public:
+
+        /**
+        \brief Initializes the ducker with the specified parameters.
+        \param[in] sampleRate Specifies the sample rate (in Hz) of the processed and the sidechain samples.
+        \param[in] channels Specifies the number of interleaved channels of the processed samples.
+        \param[in] sidechainChannels Specifies the number of interleaved channels of the sidechain samples.
+        \param[in] parameters Specifies the ducker parameters.
+        \throws std::invalid_argument If the sample rate or any number of channels is zero.
+        */
+        Ducker(
+            std::uint32_t               sampleRate,
+            std::uint16_t               channels,
+            std::uint16_t               sidechainChannels,
+            const DuckerParameters&     parameters          = {}
+        );
+
+        /**
+        \brief Attenuates the interleaved samples in place by the level of the sidechain samples.
+        \param[in,out] samples Pointer to the interleaved samples. This must contain at least 'frames * GetChannels()' samples.
+        \param[in] sidechain Pointer to the interleaved sidechain samples. This must contain at least 'frames * GetSidechainChannels()' samples.
+        \param[in] frames Specifies the number of sample frames.
+        */
+        void ProcessSidechain(float* samples, const float* sidechain, std::size_t frames);
+
+        /**
+        \brief Attenuates the interleaved samples in place by the level of the next sample frames of the sidechain stream.
+        \remarks If no sidechain stream is set or the sidechain stream has ended, the sidechain is silent, i.e. the attenuation is released.
+        */
+        void Process(float* samples, std::size_t frames) override;
+
+        //! Resets the attenuation. The sidechain stream is not modified.
+        void Reset() override;
+
+        std::uint16_t GetChannels() const override;
+
+        /**
+        \brief Sets the stream from which the sidechain samples are read by the Process function. This can be null.
+        \remarks The sidechain stream is consumed by the ducker, i.e. it cannot be played by another sound at the same time.
+        \throws std::invalid_argument If the sample rate or the number of channels of the stream does not match the ducker.
+        */
+        void SetSidechainSource(const std::shared_ptr<AudioStream>& source);
+
+        //! Returns the sidechain stream.
+        inline const std::shared_ptr<AudioStream>& GetSidechainSource() const
+        {
+            return sidechainSource_;
+        }
+
+        //! Returns the number of sidechain channels.
+        inline std::uint16_t GetSidechainChannels() const
+        {
+            return sidechainChannels_;
+        }
+
+        //! Sets the new parameters. The parameters are clamped to their valid ranges.
+        void SetParameters(const DuckerParameters& parameters);
+
+        //! Returns the (clamped) ducker parameters.
+        inline const DuckerParameters& GetParameters() const
+        {
+            return parameters_;
+        }
+
+        //! Returns the current attenuation (in dB), e.g. for a level meter. This is zero or positive.
+        float GetGainReduction() const;
+
+    private:
+
+        void ReadSidechain(std::size_t frames);
+
+    private:
+
+        std::uint32_t                   sampleRate_         = 0;
+        std::uint16_t                   channels_           = 0;
+        std::uint16_t                   sidechainChannels_  = 0;
+        DuckerParameters                parameters_;
+
+        float                           attack_             = 0.0f;     // Smoothing coefficient for the attack
+        float                           release_            = 0.0f;     // Smoothing coefficient for the release
+        float                           envelope_           = 0.0f;     // Attenuation (in dB)
+        std::vector<float>              levels_;                        // Levels, attenuations, and gains of the current block
+
+        std::shared_ptr<AudioStream>    sidechainSource_;
+        bool                            sidechainEnded_     = false;
+        WaveBuffer                      sidechainBuffer_;               // Sample frames of the sidechain stream in its own format
+        std::vector<float>              sidechainSamples_;              // Floating-point sample frames of the sidechain stream
+
+};
+
+
+} // /namespace Ac
+
+
+#endif
+
+
+
+// ================================================================================
@@ -0,0 +1,116 @@
+/*
+ * EffectStream.h
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef AC_EFFECT_STREAM_H
+#define AC_EFFECT_STREAM_H
+
+
+#include <Ac/AudioStream.h>
+#include <Ac/AudioEffect.h>
+#include <memory>
+#include <vector>
+
+
+namespace Ac
+{
+
+
+/**
+\brief Audio stream adapter which applies a chain of audio effects to the samples of another audio stream.
+\remarks When the source stream has ended, the stream continues with the tails of the effects (e.g. the reverberation),
+which are produced by processing silence. Here is an example to stream a music file with a convolution reverb:
+\code
+auto effectStream = std::make_shared<Ac::EffectStream>(audioSystem->OpenAudioStream("Music.ogg"));
+effectStream->AddEffect(std::make_shared<Ac::ConvolutionReverb>(audioSystem->ReadWaveBuffer("Hall.wav"), effectStream->GetFormat().channels));
+
+sound->SetStreamSource(effectStream);
+Ac::InitStreaming(*sound);
+\endcode
+\see AudioEffect
+*/
+class AC_EXPORT EffectStream : public AudioStream
+{
+
+    public:
+
+        /**
+        \brief Initializes the effect stream with the specified source stream and no effects.
+        \throws std::invalid_argument If the source stream is null.
+        */
+        EffectStream(const std::shared_ptr<AudioStream>& source);
+
+        /**
+        \brief Appends the specified effect to the effect chain.
+        \throws std::invalid_argument If the effect is null or its number of channels does not match the format of the source stream.
+        */
+        void AddEffect(const std::shared_ptr<AudioEffect>& effect);
+
+        //! Removes all effects from the effect chain.
+        void ClearEffects();
+
+        using AudioStream::StreamWaveBuffer;
+
+        std::size_t StreamWaveBuffer(const WaveBufferView& buffer) override;
+
+        //! Seeks the source stream and resets all effects.
+        void Seek(double timePoint) override;
+
+        //! Returns the total time of the source stream plus the latencies and tails of all effects.
+        double TotalTime() const override;
+
+        std::vector<std::string> InfoComments() const override;
+
+        WaveBufferFormat GetFormat() const override;
+
+        //! Returns the source stream.
+        inline const std::shared_ptr<AudioStream>& GetSource() const
+        {
+            return source_;
+        }
+
+        //! Returns the effect chain.
+        inline const std::vector<std::shared_ptr<AudioEffect>>& GetEffects() const
+        {
+            return effects_;
+        }
+
+    private:
+
+        std::size_t GetTotalTailFrames() const;
+
+    private:
+
+        std::shared_ptr<AudioStream>                source_;
+        std::vector<std::shared_ptr<AudioEffect>>   effects_;
+
+        bool                                        sourceEnded_    = false;
+        std::size_t                                 tailFrames_     = 0;    // Remaining sample frames of the effect tails after the source has ended
+
+        std::vector<float>                          buffer_;                // Floating-point samples of the current block
+
+};
+
+
+/**
+\brief Streams the specified number of sample frames from the audio stream into the wave buffer.
+\param[in,out] stream Specifies the audio stream to read from.
+\param[out] buffer Specifies the wave buffer which is resized to the number of sample frames. Its format must match the format of the stream.
+\param[in] frames Specifies the number of sample frames to read.
+\return Number of sample frames which have been read. If this is less than 'frames', the stream has ended.
+\remarks In contrast to a single call of "AudioStream::StreamWaveBuffer", this function reads until the buffer is filled or the stream has ended.
+*/
+AC_EXPORT std::size_t ReadStreamFrames(AudioStream& stream, WaveBuffer& buffer, std::size_t frames);
+
+
+} // /namespace Ac
+
+
+#endif
+
+
+
+// ================================================================================
@@ -0,0 +1,154 @@
+/*
+ * FDNReverb.h
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef AC_FDN_REVERB_H
+#define AC_FDN_REVERB_H
+
+
+#include <Ac/Export.h>
+#include <Ac/AudioEffect.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace Ac
+{
+
+namespace Synthesizer
+{
+
+
+//! Parameters of the feedback delay network reverb.
+struct AC_EXPORT FDNReverbParameters
+{
+    double roomSize     = 0.5;  //!< Room size in the range [0, 1], which scales the mean delay length from 10 ms to 100 ms.
+    double decayTime    = 2.0;  //!< Reverberation time (in seconds) until the reverb has decayed by 60 dB. High frequencies decay faster due to the damping.
+    double damping      = 0.3;  //!< High-frequency damping in the range [0, 1), i.e. the coefficient of the low-pass filter in each delay line.
+    double diffusion    = 0.7;  //!< Diffusion in the range [0, 1], i.e. the strength of the allpass filters which smear the input before the delay lines.
+    double wetGain      = 0.3;  //!< Gain of the reverberated signal.
+    double dryGain      = 1.0;  //!< Gain of the input signal.
+};
+
+/**
+\brief Algorithmic reverb with a feedback delay network (FDN).
+\remarks The input is diffused by a chain of allpass filters and fed into 8 or 16 delay lines of mutually prime lengths,
+whose outputs are damped, mixed by an orthogonal Hadamard matrix and fed back. The samples are processed in blocks
+which are not longer than the shortest delay line, so that all delay lines are read and written block by block:
+the damping, mixing, and output taps are loops over the samples of a block, which the compiler vectorizes.
+The costs per sample are therefore constant, i.e. they do not depend on the decay time. In contrast to the convolution reverb, there is no latency.
+\code
+Ac::Synthesizer::FDNReverbParameters params;
+params.roomSize     = 0.8;
+params.decayTime    = 3.5;
+
+Ac::Synthesizer::FDNReverb reverb(44100, 2, params);
+reverb.ProcessWaveBuffer(waveBuffer);
+\endcode
+\see ConvolutionReverb
+\see ReverbWaveBuffer
+*/
+class AC_EXPORT FDNReverb : public AudioEffect
+{
+
+    public:
+
+        /**
+        \brief Initializes the reverb with the specified parameters and allocates the delay lines for the largest room size.
+        \param[in] sampleRate Specifies the sample rate (in Hz) of the processed samples.
+        \param[in] channels Specifies the number of interleaved channels. Each channel gets a different (decorrelated) combination of the delay lines.
+        \param[in] parameters Specifies the reverb parameters.
+        \param[in] numDelayLines Specifies the number of delay lines, which must be 8 or 16. By default 16.
+        \throws std::invalid_argument If the sample rate or the number of channels is zero, or if the number of delay lines is neither 8 nor 16.
+        */
+        FDNReverb(
+            std::uint32_t               sampleRate,
+            std::uint16_t               channels,
+            const FDNReverbParameters&  parameters      = {},
+            std::size_t                 numDelayLines   = 16
+        );
+
+        //! Processes the interleaved samples and mixes the reverberated signal with the input signal.
+        void Process(float* samples, std::size_t frames) override;
+
+        //! Clears all delay lines and filters.
+        void Reset() override;
+
+        std::uint16_t GetChannels() const override;
+
+        //! Returns the number of sample frames until the reverb has decayed by 60 dB.
+        std::size_t GetTailFrames() const override;
+
+        /**
+        \brief Sets the new parameters. The parameters are clamped to their valid ranges.
+        \remarks The delay lines are not cleared, i.e. the reverb can be changed while it is playing.
+        */
+        void SetParameters(const FDNReverbParameters& parameters);
+
+        //! Returns the (clamped) reverb parameters.
+        inline const FDNReverbParameters& GetParameters() const
+        {
+            return parameters_;
+        }
+
+        //! Returns the number of delay lines.
+        inline std::size_t GetNumDelayLines() const
+        {
+            return delayLines_.size();
+        }
+
+    private:
+
+        // Delay line with a ring buffer (which is allocated for the largest room size).
+        struct DelayLine
+        {
+            std::vector<float>  buffer;
+            std::size_t         delay       = 0;
+            float               gain        = 0.0f;     // Feedback gain for the decay time (including the normalization of the mixing matrix)
+            float               filterState = 0.0f;     // State of the low-pass filter (damping)
+        };
+
+        // Allpass filter of the input diffusion.
+        struct Diffuser
+        {
+            std::vector<float>  buffer;
+            std::size_t         delay       = 0;
+            float               gain        = 0.0f;
+        };
+
+        void ProcessBlock(float* samples, std::size_t frames);
+
+    private:
+
+        std::uint32_t                       sampleRate_     = 0;
+        std::uint16_t                       channels_       = 0;
+        FDNReverbParameters                 parameters_;
+
+        std::vector<DelayLine>              delayLines_;
+        std::vector<std::vector<Diffuser>>  diffusers_;             // Chain of allpass filters for each channel
+        std::size_t                         maxBlockSize_   = 0;    // Maximal block size, which is limited by the shortest delay
+        std::uint64_t                       time_           = 0;    // Index of the next sample frame (for the ring buffers)
+
+        std::vector<float>                  lineSamples_;           // Samples of all delay lines for the current block (one row per delay line)
+        std::vector<float>                  inputSamples_;          // Diffused input samples for the current block (one row per channel)
+        std::vector<float>                  outputSamples_;         // Reverberated output samples for the current block (one row per channel)
+        std::vector<float>                  outputSigns_;           // Signs of the delay lines for each output channel
+        std::vector<float>                  inputSigns_;            // Signs of the input channels for each delay line
+
+};
+
+
+} // /namespace Synthesizer
+
+} // /namespace Ac
+
+
+#endif
+
+
+
+// ================================================================================
@@ -0,0 +1,187 @@
+/*
+ * FFT.h
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef AC_FFT_H
+#define AC_FFT_H
+
+
+#include <Ac/Export.h>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+
+namespace Ac
+{
+
+
+/* ----- Window functions ----- */
+
+//! Window function enumeration for the spectral analysis.
+enum class WindowFunction
+{
+    Rectangular,    //!< Rectangular window, i.e. all weights are 1.
+    Hann,           //!< Hann window (raised cosine).
+    Blackman,       //!< Blackman window (with alpha = 0.16).
+};
+
+/**
+\brief Generates the weights of the specified window function.
+\param[in] windowFunction Specifies the window function.
+\param[in] size Specifies the number of weights.
+\param[in] periodic Specifies whether the periodic variant of the window is generated (i.e. the symmetric window of size 'size + 1' without its last weight).
+The periodic variant is used for the spectral analysis, since overlapping periodic windows add up to a constant. By default true.
+*/
+AC_EXPORT std::vector<float> GenerateWindow(const WindowFunction windowFunction, std::size_t size, bool periodic = true);
+
+/* ----- Complex FFT ----- */
+
+/**
+\brief Plan for the complex fast Fourier transform (FFT) of a fixed size.
+\remarks A plan stores the factorization of the size and the twiddle factors of all stages, so it is created once and reused for many transforms.
+Any size is supported: the size is factorized into radix-4, radix-2, radix-3, and radix-5 stages, and the remaining prime factors are transformed
+with generic butterflies (which is slow for large prime factors). Each stage is a Stockham auto-sort pass, whose inner loops run over contiguous samples
+with constant twiddle factors, so the compiler can vectorize the butterflies.
+A plan is immutable, i.e. it can be used by multiple threads at the same time. Use "Get" to share plans of the same size.
+\code
+auto plan = Ac::FFTPlan::Get(1024);
+std::vector<std::complex<float>> spectrum(1024);
+plan->Forward(signal.data(), spectrum.data());
+\endcode
+*/
+class AC_EXPORT FFTPlan
+{
+
+    public:
+
+        /**
+        \brief Creates the plan for the specified size.
+        \throws std::invalid_argument If the size is zero.
+        */
+        FFTPlan(std::size_t size);
+
+        /**
+        \brief Returns a shared plan for the specified size. Plans are created on demand and cached, i.e. this function is thread-safe.
+        \throws std::invalid_argument If the size is zero.
+        */
+        static std::shared_ptr<const FFTPlan> Get(std::size_t size);
+
+        /**
+        \brief Transforms the signal from the time domain into the frequency domain.
+        \param[in] input Pointer to the 'GetSize()' complex input samples.
+        \param[out] output Pointer to the 'GetSize()' complex output bins. This can also be the same as 'input'.
+        */
+        void Forward(const std::complex<float>* input, std::complex<float>* output) const;
+
+        /**
+        \brief Transforms the spectrum from the frequency domain back into the time domain.
+        \remarks The output is not normalized, i.e. transforming forward and inverse multiplies the signal by the size.
+        \see Forward
+        */
+        void Inverse(const std::complex<float>* input, std::complex<float>* output) const;
+
+        //! Returns the number of complex samples of each transform.
+        inline std::size_t GetSize() const
+        {
+            return size_;
+        }
+
+        /**
+        \brief Returns the smallest size which is greater than or equal to the specified size and only has the prime factors 2, 3, and 5.
+        \remarks Transforms of such sizes are nearly as fast as transforms of powers of two.
+        */
+        static std::size_t GetFastSize(std::size_t size);
+
+    private:
+
+        struct Stage
+        {
+            std::size_t                         radix;
+            std::size_t                         length;     // Sub-sequence length 'n' of this stage
+            std::size_t                         stride;     // Stride 's' of this stage, where 'n * s' is the size
+            std::vector<std::complex<float>>    twiddles;   // Twiddle factors exp(-2*pi*i*k*p/n) at index '(k - 1) * (n / radix) + p'
+            std::vector<std::complex<float>>    roots;      // Roots of unity exp(-2*pi*i*j/radix) for the generic butterflies
+        };
+
+        template <bool Inverse>
+        void Transform(const std::complex<float>* input, std::complex<float>* output) const;
+
+    private:
+
+        std::size_t         size_ = 0;
+        std::vector<Stage>  stages_;
+
+};
+
+/* ----- Real FFT ----- */
+
+/**
+\brief Plan for the fast Fourier transform of real signals.
+\remarks The spectrum of a real signal is conjugate symmetric, so only the first 'GetSize()/2 + 1' bins are stored.
+For even sizes, the signal is transformed as complex signal of half the size, whose spectrum is then split into the even and odd samples,
+which makes the transform about twice as fast as the complex transform. Odd sizes use the complex transform of the full size.
+*/
+class AC_EXPORT RealFFTPlan
+{
+
+    public:
+
+        /**
+        \brief Creates the plan for the specified size.
+        \throws std::invalid_argument If the size is zero.
+        */
+        RealFFTPlan(std::size_t size);
+
+        //! Returns a shared plan for the specified size. \see FFTPlan::Get
+        static std::shared_ptr<const RealFFTPlan> Get(std::size_t size);
+
+        /**
+        \brief Transforms the real signal into its spectrum.
+        \param[in] input Pointer to the 'GetSize()' input samples.
+        \param[out] output Pointer to the 'GetNumBins()' output bins, i.e. the bins from zero up to the Nyquist frequency.
+        */
+        void Forward(const float* input, std::complex<float>* output) const;
+
+        /**
+        \brief Transforms the spectrum back into the real signal.
+        \param[in] input Pointer to the 'GetNumBins()' input bins. The imaginary parts of the first bin (and of the last bin for even sizes) are ignored.
+        \param[out] output Pointer to the 'GetSize()' output samples.
+        \remarks The output is not normalized, i.e. transforming forward and inverse multiplies the signal by the size.
+        */
+        void Inverse(const std::complex<float>* input, float* output) const;
+
+        //! Returns the number of real samples of each transform.
+        inline std::size_t GetSize() const
+        {
+            return size_;
+        }
+
+        //! Returns the number of bins of the spectrum, i.e. 'GetSize()/2 + 1'.
+        inline std::size_t GetNumBins() const
+        {
+            return (size_/2 + 1);
+        }
+
+    private:
+
+        std::size_t                         size_ = 0;
+        std::shared_ptr<const FFTPlan>      complexPlan_;   // Plan of half the size for even sizes, or of the full size for odd sizes
+        std::vector<std::complex<float>>    twiddles_;      // Twiddle factors exp(-2*pi*i*k/size) to split the half-size spectrum (only for even sizes)
+
+};
+
+
+} // /namespace Ac
+
+
+#endif
+
+
+
+// ================================================================================
@@ -0,0 +1,130 @@
+/*
+ * Limiter.h
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef AC_LIMITER_H
+#define AC_LIMITER_H
+
+
+#include <Ac/Export.h>
+#include <Ac/AudioEffect.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace Ac
+{
+
+
+//! Parameters of the look-ahead limiter.
+struct AC_EXPORT LimiterParameters
+{
+    double ceiling      = -1.0;     //!< Maximal output level (in dB), which is never exceeded. At most 0.
+    double inputGain    = 0.0;      //!< Gain (in dB) which is applied before the limiting, e.g. to raise the loudness.
+    double releaseTime  = 0.1;      //!< Time (in seconds) in which the gain recovers by about 63% after a peak.
+};
+
+/**
+\brief Brick-wall limiter with look-ahead, i.e. the output never exceeds the ceiling.
+\remarks The output is delayed by the look-ahead time (see GetLatency), so the gain can be lowered smoothly before a peak arrives:
+the required gain of each sample frame is the minimum over the look-ahead window, which is then smoothed by a moving average
+of the same length. The average never exceeds the required gain of the delayed sample frame, so no overshoot is possible.
+The peaks, required gains, and the gain application are computed for whole blocks with vector kernels.
+\code
+// Raise the loudness by 6 dB without clipping
+Ac::LimiterParameters params;
+params.inputGain = 6.0;
+
+auto effectStream = std::make_shared<Ac::EffectStream>(audioSystem->OpenAudioStream("Music.ogg"));
+effectStream->AddEffect(std::make_shared<Ac::Limiter>(44100, 2, params));
+\endcode
+\see Compressor
+*/
+class AC_EXPORT Limiter : public AudioEffect
+{
+
+    public:
+
+        /**
+        \brief Initializes the limiter with the specified parameters.
+        \param[in] sampleRate Specifies the sample rate (in Hz) of the processed samples.
+        \param[in] channels Specifies the number of interleaved channels. All channels are limited by the same gain.
+        \param[in] parameters Specifies the limiter parameters.
+        \param[in] lookAheadTime Specifies the look-ahead time (in seconds), which is also the latency. At least one sample frame. By default 0.005.
+        \throws std::invalid_argument If the sample rate or the number of channels is zero.
+        */
+        Limiter(
+            std::uint32_t               sampleRate,
+            std::uint16_t               channels,
+            const LimiterParameters&    parameters      = {},
+            double                      lookAheadTime   = 0.005
+        );
+
+        //! Limits the interleaved samples in place. The output lags behind the input by 'GetLatency()' sample frames.
+        void Process(float* samples, std::size_t frames) override;
+
+        //! Clears the look-ahead delay and resets the gain.
+        void Reset() override;
+
+        std::uint16_t GetChannels() const override;
+
+        //! Returns the number of look-ahead sample frames.
+        std::size_t GetLatency() const override;
+
+        //! Sets the new parameters. The parameters are clamped to their valid ranges.
+        void SetParameters(const LimiterParameters& parameters);
+
+        //! Returns the (clamped) limiter parameters.
+        inline const LimiterParameters& GetParameters() const
+        {
+            return parameters_;
+        }
+
+        //! Returns the current gain reduction (in dB), e.g. for a level meter. This is zero or positive.
+        float GetGainReduction() const;
+
+    private:
+
+        void ComputeGains(float* gains, std::size_t frames);
+
+    private:
+
+        std::uint32_t               sampleRate_     = 0;
+        std::uint16_t               channels_       = 0;
+        LimiterParameters           parameters_;
+
+        float                       ceiling_        = 1.0f;     // Linear ceiling
+        float                       inputGain_      = 1.0f;     // Linear input gain
+        float                       release_        = 0.0f;     // Smoothing coefficient for the release
+
+        std::size_t                 lookAhead_      = 0;        // Number of look-ahead sample frames (the window length is one more)
+        std::vector<float>          delayBuffer_;               // Delayed interleaved samples of the last 'lookAhead_' sample frames, followed by the current block
+
+        std::vector<float>          minValues_;                 // Ring buffer of the ascending candidates for the minimum within the window
+        std::vector<std::uint64_t>  minIndices_;                // Ring buffer of the sample frame indices of the candidates
+        std::size_t                 minFront_       = 0;
+        std::size_t                 minCount_       = 0;
+
+        float                       envelope_       = 1.0f;     // Required gain after the release
+        std::vector<float>          averageWindow_;             // Ring buffer of the last gains for the moving average
+        double                      averageSum_     = 0.0;
+        float                       gain_           = 1.0f;     // Last applied gain
+        std::uint64_t               time_           = 0;        // Index of the next sample frame
+
+        std::vector<float>          gains_;                     // Gains of the current block
+
+};
+
+
+} // /namespace Ac
+
+
+#endif
+
+
+
+// ================================================================================
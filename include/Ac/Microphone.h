@@ -56,8 +56,9 @@ class AC_EXPORT Microphone
         // Start recording
         mic->Start();
 
-        // Process microphone input until there is no more to process
+        // Process microphone input until there is no more to process (the chunked storage avoids copying the entire recording on each append)
         WaveBuffer inputBuffer, outputBuffer;
+        outputBuffer.SetChunkSize(1u << 20);
         while (mic->ProcessInput(inputBuffer))
         {
             // Append input buffer to output buffer
@@ -68,8 +69,11 @@ class AC_EXPORT Microphone
                 mic->Stop();
         }
         \endcode
+        The samples of the received wave buffers are allocated on the recording thread with the default sample allocator at the time "Start" was called.
+        To keep the recording thread off the global heap, install a PoolSampleAllocator as default allocator before starting the recording.
         \see Start
         \see Stop
+        \see SetDefaultSampleAllocator
         */
         virtual std::unique_ptr<WaveBuffer> ReceivedInput() = 0;
 
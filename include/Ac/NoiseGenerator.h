@@ -0,0 +1,165 @@
+/*
+ * NoiseGenerator.h
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef AC_NOISE_GENERATOR_H
+#define AC_NOISE_GENERATOR_H
+
+
+#include <Ac/Export.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace Ac
+{
+
+
+//! Noise color enumeration.
+enum class NoiseColor
+{
+    White,  //!< White noise with a flat spectrum, uniformly distributed in the range [-1, 1).
+    Pink,   //!< Pink noise with a spectrum falling by 3 dB per octave.
+    Brown,  //!< Brown (or rather red) noise with a spectrum falling by 6 dB per octave.
+};
+
+/**
+\brief Seedable noise generator which generates blocks of samples.
+\remarks Each channel has its own random number streams, which are seeded deterministically from the seed and the channel index.
+Each channel consists of four interleaved xoshiro256+ streams, which are advanced in parallel (the state is stored as structure of arrays,
+so the compiler can vectorize the loop). The output only depends on the seed and the number of samples generated so far for the respective channel,
+i.e. it does not depend on the block sizes, and separate generators with the same seed produce identical output on any thread.
+The generator can be used as block iterator with the "WaveBuffer::ForEachBlock" template, in which case it adds noise to all channels:
+\code
+Ac::NoiseGenerator noise(Ac::NoiseColor::Pink, 0.25, 42);
+buffer.ForEachBlock(noise);
+\endcode
+\note A noise generator must not be used by multiple threads at the same time. Use a separate generator (e.g. with another seed) for each thread.
+*/
+class AC_EXPORT NoiseGenerator
+{
+
+    public:
+
+        /**
+        \brief Initializes the noise generator.
+        \param[in] color Specifies the noise color.
+        \param[in] amplitude Specifies the amplitude. By default 1.
+        \param[in] seed Specifies the random seed. By default 0.
+        */
+        NoiseGenerator(const NoiseColor color, double amplitude = 1.0, std::uint64_t seed = 0);
+
+        /**
+        \brief Generates the next noise samples of the specified channel.
+        \param[out] samples Pointer to the output samples. This must contain at least 'frames' elements. The samples are overwritten.
+        \param[in] frames Specifies the number of samples to generate.
+        \param[in] channel Specifies the channel whose random streams are used. By default 0.
+        */
+        void Generate(float* samples, std::size_t frames, std::uint16_t channel = 0);
+
+        //! \see Generate(float*, std::size_t, std::uint16_t)
+        void Generate(double* samples, std::size_t frames, std::uint16_t channel = 0);
+
+        /**
+        \brief Block iterator interface, which is compatible to the SampleBlockIterationFunction interface.
+        \remarks Independent noise is added to each channel.
+        */
+        template <typename T>
+        void operator () (T* samples, std::size_t frames, std::uint16_t channels, std::size_t /*indexBegin*/, std::uint32_t /*sampleRate*/)
+        {
+            T block[256];
+
+            for (std::size_t offset = 0; offset < frames;)
+            {
+                auto n = (std::min)(frames - offset, sizeof(block)/sizeof(block[0]));
+
+                for (std::uint16_t chn = 0; chn < channels; ++chn)
+                {
+                    Generate(block, n, chn);
+                    for (std::size_t i = 0; i < n; ++i)
+                        samples[(offset + i)*channels + chn] += block[i];
+                }
+
+                offset += n;
+            }
+        }
+
+        //! Re-seeds all channels, i.e. the generator starts over with the new seed.
+        void Seed(std::uint64_t seed);
+
+        //! Returns the random seed.
+        inline std::uint64_t GetSeed() const
+        {
+            return seed_;
+        }
+
+        //! Re-seeds all channels with the current seed, i.e. the generator starts over.
+        void Reset();
+
+        //! Sets the noise color. This resets the filter states of all channels, but not their random streams.
+        void SetColor(const NoiseColor color);
+
+        //! Returns the noise color.
+        inline NoiseColor GetColor() const
+        {
+            return color_;
+        }
+
+        //! Sets the amplitude.
+        inline void SetAmplitude(double amplitude)
+        {
+            amplitude_ = amplitude;
+        }
+
+        //! Returns the amplitude.
+        inline double GetAmplitude() const
+        {
+            return amplitude_;
+        }
+
+    private:
+
+        // Number of parallel random number streams per channel.
+        static const std::size_t numLanes = 4;
+
+        struct ChannelState
+        {
+            std::uint64_t   rng[4][numLanes];       // xoshiro256+ state words (structure of arrays for the parallel streams)
+            float           cache[numLanes];        // Pending white noise samples of the last group
+            std::size_t     cacheIndex  = numLanes;
+            double          filter[7];              // Pink noise filter states, or brown noise integrator state
+        };
+
+        ChannelState& GetChannelState(std::uint16_t channel);
+
+        void SeedChannel(ChannelState& state, std::uint16_t channel) const;
+
+        void GenerateWhite(ChannelState& state, float* samples, std::size_t frames);
+
+        template <typename T>
+        void GenerateSamples(T* samples, std::size_t frames, std::uint16_t channel);
+
+    private:
+
+        NoiseColor                  color_      = NoiseColor::White;
+        double                      amplitude_  = 1.0;
+        std::uint64_t               seed_       = 0;
+
+        std::vector<ChannelState>   channels_;
+
+};
+
+
+} // /namespace Ac
+
+
+#endif
+
+
+
+// ================================================================================
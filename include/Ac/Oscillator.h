@@ -0,0 +1,237 @@
+/*
+ * Oscillator.h
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef AC_OSCILLATOR_H
+#define AC_OSCILLATOR_H
+
+
+#include <Ac/Export.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+
+namespace Ac
+{
+
+
+//! Oscillator wave form enumeration.
+enum class OscillatorWaveForm
+{
+    Sine,       //!< Sine wave, generated by rotating quadrature phasors.
+    Square,     //!< Square wave, which is +1 for the first part of each cycle (see Oscillator::SetPulseWidth) and -1 for the remaining part. Band-limited with PolyBLEP.
+    Triangle,   //!< Triangle wave, which is in phase with the sine wave. Band-limited with PolyBLAMP.
+    Saw,        //!< Saw-tooth wave, which rises from -1 to +1 within each cycle. Band-limited with PolyBLEP.
+    HalfCircle, //!< Half-circle wave, which is read from a wavetable.
+    Wavetable,  //!< Custom single-cycle wavetable (see Oscillator::SetWavetable).
+};
+
+/**
+\brief Stateful oscillator which generates blocks of samples.
+\remarks The phase is stored in a 64-bit fixed-point accumulator (one cycle corresponds to 2^64), which wraps around exactly,
+so there is no phase drift even over hour-long renders. There are no transcendental function calls within the inner loops:
+sine waves are generated by rotating phasors, which are re-initialized from the phase accumulator for each block of at most 1024 frames;
+other wave forms are computed directly from the phase, or read from a wavetable with linear interpolation.
+The oscillator can be used as block iterator with the "WaveBuffer::ForEachBlock" template, in which case it adds its samples to all channels:
+\code
+Ac::Oscillator osc(Ac::OscillatorWaveForm::Sine, 44100, 440.0, 0.5);
+buffer.ForEachBlock(osc);
+
+// Continue phase-coherently with another frequency
+osc.SetFrequency(880.0);
+nextBuffer.ForEachBlock(osc);
+\endcode
+\note The square, triangle, and saw-tooth wave forms are band-limited by default (see SetBandLimited),
+so they can be generated at the original sample rate without audible aliasing.
+*/
+class AC_EXPORT Oscillator
+{
+
+    public:
+
+        /**
+        \brief Initializes the oscillator.
+        \param[in] waveForm Specifies the wave form. For OscillatorWaveForm::Wavetable, the wavetable must be set with "SetWavetable" (until then, the oscillator generates silence).
+        \param[in] sampleRate Specifies the sample rate (in Hz).
+        \param[in] frequency Specifies the frequency (in Hz).
+        \param[in] amplitude Specifies the amplitude. By default 1.
+        \param[in] phase Specifies the initial phase (in cycles, i.e. 1 corresponds to 2*PI). By default 0.
+        \throws std::invalid_argument If the sample rate is zero.
+        */
+        Oscillator(const OscillatorWaveForm waveForm, std::uint32_t sampleRate, double frequency, double amplitude = 1.0, double phase = 0.0);
+
+        /**
+        \brief Generates the next sample frames and advances the phase.
+        \param[out] samples Pointer to the output samples. This must contain at least 'frames' elements. The samples are overwritten.
+        */
+        void Generate(float* samples, std::size_t frames);
+
+        //! \see Generate(float*, std::size_t)
+        void Generate(double* samples, std::size_t frames);
+
+        /**
+        \brief Block iterator interface, which is compatible to the SampleBlockIterationFunction interface.
+        \remarks The generated samples are added to all channels of each sample frame. If the sample rate differs, it is changed first.
+        */
+        template <typename T>
+        void operator () (T* samples, std::size_t frames, std::uint16_t channels, std::size_t /*indexBegin*/, std::uint32_t sampleRate)
+        {
+            if (sampleRate != sampleRate_)
+                SetSampleRate(sampleRate);
+
+            T block[256];
+
+            while (frames > 0)
+            {
+                auto n = (std::min)(frames, sizeof(block)/sizeof(block[0]));
+                Generate(block, n);
+
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    for (std::uint16_t chn = 0; chn < channels; ++chn)
+                        *(samples++) += block[i];
+                }
+
+                frames -= n;
+            }
+        }
+
+        //! Sets the phase to the initial phase, which was passed to the constructor.
+        void Reset();
+
+        //! Sets the wave form. The phase is not changed.
+        void SetWaveForm(const OscillatorWaveForm waveForm);
+
+        //! Returns the wave form.
+        inline OscillatorWaveForm GetWaveForm() const
+        {
+            return waveForm_;
+        }
+
+        /**
+        \brief Sets the sample rate (in Hz). The phase and frequency are not changed.
+        \throws std::invalid_argument If the sample rate is zero.
+        */
+        void SetSampleRate(std::uint32_t sampleRate);
+
+        //! Returns the sample rate (in Hz).
+        inline std::uint32_t GetSampleRate() const
+        {
+            return sampleRate_;
+        }
+
+        /**
+        \brief Sets the frequency (in Hz). The phase is not changed, i.e. the wave form stays continuous.
+        \remarks Negative frequencies let the phase run backwards.
+        */
+        void SetFrequency(double frequency);
+
+        //! Returns the frequency (in Hz).
+        inline double GetFrequency() const
+        {
+            return frequency_;
+        }
+
+        //! Sets the amplitude.
+        inline void SetAmplitude(double amplitude)
+        {
+            amplitude_ = amplitude;
+        }
+
+        //! Returns the amplitude.
+        inline double GetAmplitude() const
+        {
+            return amplitude_;
+        }
+
+        //! Sets the current phase (in cycles). Only the fractional part is used.
+        void SetPhase(double phase);
+
+        //! Returns the current phase (in cycles) in the range [0, 1).
+        double GetPhase() const;
+
+        /**
+        \brief Sets the pulse width of the square wave form in the range [0, 1]. By default 0.5.
+        \remarks This is the fraction of each cycle where the square wave is +1.
+        */
+        void SetPulseWidth(double pulseWidth);
+
+        //! Returns the pulse width of the square wave form.
+        inline double GetPulseWidth() const
+        {
+            return pulseWidth_;
+        }
+
+        /**
+        \brief Specifies whether the square, triangle, and saw-tooth wave forms are band-limited. By default true.
+        \remarks The discontinuities of these wave forms are smoothed with polynomial residuals (see Synthesizer::PolyBLEP),
+        which removes most of the aliasing for frequencies below half of the sample rate.
+        Disable this to generate the naive wave forms, e.g. for low-frequency modulation.
+        */
+        inline void SetBandLimited(bool bandLimited)
+        {
+            bandLimited_ = bandLimited;
+        }
+
+        //! Returns true if the square, triangle, and saw-tooth wave forms are band-limited.
+        inline bool IsBandLimited() const
+        {
+            return bandLimited_;
+        }
+
+        /**
+        \brief Sets a custom single-cycle wavetable and changes the wave form to OscillatorWaveForm::Wavetable.
+        \param[in] wavetable Specifies the samples of a single cycle. The samples are interpolated linearly and wrap around at the end.
+        \remarks The wavetable is shared between copies of this oscillator. If the wavetable is empty, the oscillator generates silence.
+        */
+        void SetWavetable(const std::vector<float>& wavetable);
+
+    private:
+
+        template <typename T>
+        void GenerateSamples(T* samples, std::size_t frames);
+
+        template <typename T>
+        void GenerateSine(T* samples, std::size_t frames);
+
+        template <typename T>
+        void GenerateBandLimited(T* samples, std::size_t frames);
+
+        template <typename T>
+        void GenerateWavetable(T* samples, std::size_t frames, const std::vector<float>& wavetable);
+
+        void UpdateIncrement();
+
+    private:
+
+        OscillatorWaveForm                          waveForm_       = OscillatorWaveForm::Sine;
+        std::uint32_t                               sampleRate_     = 44100;
+        double                                      frequency_      = 0.0;
+        double                                      amplitude_      = 1.0;
+        double                                      pulseWidth_     = 0.5;
+        bool                                        bandLimited_    = true;
+
+        std::uint64_t                               initialPhase_   = 0;
+        std::uint64_t                               phase_          = 0;    // Fixed-point phase, where 2^64 corresponds to one cycle
+        std::uint64_t                               increment_      = 0;    // Phase increment per sample frame
+        std::uint64_t                               pulseEnd_       = 0;    // Phase where the square wave changes from +1 to -1
+
+        std::shared_ptr<const std::vector<float>>   wavetable_;             // Custom wavetable, or null
+
+};
+
+
+} // /namespace Ac
+
+
+#endif
+
+
+
+// ================================================================================
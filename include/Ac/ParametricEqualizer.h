@@ -0,0 +1,124 @@
+/*
+ * ParametricEqualizer.h
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef AC_PARAMETRIC_EQUALIZER_H
+#define AC_PARAMETRIC_EQUALIZER_H
+
+
+#include <Ac/Export.h>
+#include <Ac/AudioEffect.h>
+#include <Ac/BiquadFilter.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace Ac
+{
+
+
+//! Band of a parametric equalizer.
+struct AC_EXPORT EqualizerBand
+{
+    EqualizerBand() = default;
+
+    inline EqualizerBand(BiquadType type, double frequency, double q = 0.7071067811865476, double gain = 0.0) :
+        type        { type      },
+        frequency   { frequency },
+        q           { q         },
+        gain        { gain      }
+    {
+    }
+
+    BiquadType  type        = BiquadType::Peaking;  //!< Filter type of the band. By default BiquadType::Peaking.
+    double      frequency   = 1000.0;               //!< Cutoff, corner, or center frequency (in Hz). By default 1000.
+    double      q           = 0.7071067811865476;   //!< Q factor. By default 1/sqrt(2).
+    double      gain        = 0.0;                  //!< Gain (in dB) of shelf and peaking bands. By default 0.
+};
+
+/**
+\brief Parametric equalizer, i.e. a cascade of biquad filters which are applied to all channels.
+\remarks Each band is a BiquadFilterBank with one lane per channel, so the channels are filtered in parallel.
+Changes of the bands are smoothed, so the equalizer can be automated while it is playing (e.g. within an EffectStream).
+\code
+Ac::ParametricEqualizer eq(44100, 2);
+eq.AddBand({ Ac::BiquadType::HighPass, 80.0 });
+eq.AddBand({ Ac::BiquadType::Peaking, 2500.0, 1.5, -4.0 });
+eq.AddBand({ Ac::BiquadType::HighShelf, 8000.0, 0.7, 3.0 });
+eq.ProcessWaveBuffer(waveBuffer);
+\endcode
+\see BiquadFilterBank
+*/
+class AC_EXPORT ParametricEqualizer : public AudioEffect
+{
+
+    public:
+
+        /**
+        \brief Initializes the equalizer without any bands.
+        \param[in] sampleRate Specifies the sample rate (in Hz) of the processed samples.
+        \param[in] channels Specifies the number of interleaved channels.
+        \throws std::invalid_argument If the sample rate or the number of channels is zero.
+        */
+        ParametricEqualizer(std::uint32_t sampleRate, std::uint16_t channels);
+
+        /**
+        \brief Appends a new band to the equalizer and returns its index.
+        \throws std::invalid_argument If the Q factor of the band is not positive.
+        */
+        std::size_t AddBand(const EqualizerBand& band);
+
+        /**
+        \brief Changes the specified band. The filter moves smoothly to the new band parameters.
+        \throws std::out_of_range If the band index is out of range.
+        \throws std::invalid_argument If the Q factor of the band is not positive.
+        */
+        void SetBand(std::size_t index, const EqualizerBand& band);
+
+        //! Returns the specified band. \throws std::out_of_range If the band index is out of range.
+        const EqualizerBand& GetBand(std::size_t index) const;
+
+        //! Removes all bands.
+        void ClearBands();
+
+        //! Sets the time constant (in sample frames) of the smoothing for band changes. By default 256. \see BiquadFilterBank::SetSmoothingFrames
+        void SetSmoothingFrames(std::size_t frames);
+
+        //! Filters the interleaved samples in place with all bands.
+        void Process(float* samples, std::size_t frames) override;
+
+        //! Clears the states of all filters.
+        void Reset() override;
+
+        std::uint16_t GetChannels() const override;
+
+        //! Returns the number of bands.
+        inline std::size_t GetNumBands() const
+        {
+            return bands_.size();
+        }
+
+    private:
+
+        std::uint32_t                   sampleRate_         = 0;
+        std::uint16_t                   channels_           = 0;
+        std::size_t                     smoothingFrames_    = 256;
+
+        std::vector<EqualizerBand>      bands_;
+        std::vector<BiquadFilterBank>   filters_;   // Filter bank for each band (with one lane per channel)
+
+};
+
+
+} // /namespace Ac
+
+
+#endif
+
+
+
+// ================================================================================
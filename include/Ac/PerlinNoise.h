@@ -38,15 +38,58 @@ class AC_EXPORT PerlinNoise
         //! Returns a noise pattern in the range [-1, +1] with an accumulation of \c octaves samples.
         double Noise(double t, std::uint32_t frequency, std::uint32_t octaves, double persistence = 0.5) const;
 
+        /**
+        \brief Evaluates the noise pattern for an array of time points at once.
+        \param[in] timePoints Pointer to the time points. This must contain at least 'count' elements.
+        \param[out] noise Pointer to the output noise values. This must contain at least 'count' elements. This can also be the same as 'timePoints'.
+        \param[in] count Specifies the number of time points.
+        \param[in] frequency Specifies the frequency of the first octave.
+        \param[in] octaves Specifies the number of accumulated octaves. By default 1.
+        \param[in] persistence Specifies the amplitude factor between two successive octaves. By default 0.5.
+        \remarks This is equivalent to calling "Noise" for each time point, but the fade and gradient functions are evaluated
+        for a whole block of time points and octave by octave, so the compiler can vectorize the inner loops.
+        Only the gradient look-ups are done per sample.
+        */
+        void Noise(
+            const double*   timePoints,
+            double*         noise,
+            std::size_t     count,
+            std::uint32_t   frequency,
+            std::uint32_t   octaves     = 1,
+            double          persistence = 0.5
+        ) const;
+
+        /**
+        \brief Evaluates the noise pattern for evenly spaced time points, i.e. for the time points 'timeBegin + i*timeStep' with 'i' in [0, count).
+        \see Noise(const double*, double*, std::size_t, std::uint32_t, std::uint32_t, double) const
+        */
+        void Noise(
+            double          timeBegin,
+            double          timeStep,
+            double*         noise,
+            std::size_t     count,
+            std::uint32_t   frequency,
+            std::uint32_t   octaves     = 1,
+            double          persistence = 0.5
+        ) const;
+
     private:
 
-        void GeneratePermutations(std::uint32_t seed);
-        void GenerateGradients();
+        void GenerateGradients(std::uint32_t seed);
+
+        void AccumulateOctaves(
+            const double*   timePoints,
+            double*         noise,
+            std::size_t     count,
+            std::uint32_t   frequency,
+            std::uint32_t   octaves,
+            double          persistence
+        ) const;
 
     private:
 
-        std::array<std::uint32_t, 512>  perm_;
-        std::array<double, 256>         grads_;
+        // Gradients of the lattice points (indexed by the lattice point modulo the frequency), which are permuted by the seed.
+        std::array<double, 256> grads_;
 
 };
 
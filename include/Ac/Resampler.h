@@ -0,0 +1,151 @@
+/*
+ * Resampler.h
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef AC_RESAMPLER_H
+#define AC_RESAMPLER_H
+
+
+#include <Ac/Export.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace Ac
+{
+
+
+//! Sample rate conversion quality enumeration.
+enum class ResamplerQuality
+{
+    Linear, //!< Linear interpolation between two samples. Fastest, but without anti-aliasing filter.
+    Cubic,  //!< Cubic (Catmull-Rom) interpolation between four samples. Without anti-aliasing filter.
+    Sinc,   //!< Windowed-sinc low-pass filter (Blackman window). Highest quality with anti-aliasing when downsampling.
+};
+
+/**
+\brief Polyphase sample rate converter.
+\remarks The conversion ratio is reduced to a fraction L/M of the output and input sample rates.
+The filter coefficients for all L phases (or a fixed number of phases for large L, which are interpolated then)
+are precomputed on construction, so processing only requires a dot product per output sample and channel.
+The resampler keeps its state between calls to "Process", so it can be used for streaming:
+\code
+Ac::Resampler resampler(48000, 44100, 2);
+std::vector<float> output;
+
+while (ReadNextBlock(input))
+    resampler.Process(input.data(), input.size() / 2, output);
+
+resampler.Flush(output);
+\endcode
+\see WaveBuffer::SetFormat(const WaveBufferFormat&, const ResamplerQuality)
+*/
+class AC_EXPORT Resampler
+{
+
+    public:
+
+        /**
+        \brief Initializes the resampler and precomputes the filter tables.
+        \param[in] inputRate Specifies the sample rate (in Hz) of the input samples.
+        \param[in] outputRate Specifies the sample rate (in Hz) of the output samples.
+        \param[in] channels Specifies the number of interleaved channels.
+        \param[in] quality Specifies the resampler quality. By default ResamplerQuality::Sinc.
+        \throws std::invalid_argument If any of the sample rates or the number of channels is zero.
+        */
+        Resampler(std::uint32_t inputRate, std::uint32_t outputRate, std::uint16_t channels, const ResamplerQuality quality = ResamplerQuality::Sinc);
+
+        /**
+        \brief Resamples the specified input samples and appends the results to the output container.
+        \param[in] input Pointer to the interleaved input samples. This must contain at least 'inputFrames * channels' samples.
+        \param[in] inputFrames Specifies the number of input sample frames.
+        \param[out] output Specifies the container to which the interleaved output samples are appended.
+        \return Number of output sample frames which have been appended.
+        \remarks Due to the filter length, the output lags behind the input. Call "Flush" after the last input block to retrieve the remaining output.
+        */
+        std::size_t Process(const float* input, std::size_t inputFrames, std::vector<float>& output);
+
+        /**
+        \brief Appends the remaining output samples for all input samples passed so far, and resets the state afterwards.
+        \return Number of output sample frames which have been appended.
+        \remarks The total number of output sample frames is then 'ceil(inputFrames * outputRate / inputRate)'.
+        */
+        std::size_t Flush(std::vector<float>& output);
+
+        //! Resets the streaming state, i.e. all pending input samples are discarded.
+        void Reset();
+
+        //! Returns the number of output sample frames for the specified number of input sample frames.
+        std::size_t GetOutputFrames(std::size_t inputFrames) const;
+
+        //! Returns the sample rate (in Hz) of the input samples.
+        inline std::uint32_t GetInputRate() const
+        {
+            return inputRate_;
+        }
+
+        //! Returns the sample rate (in Hz) of the output samples.
+        inline std::uint32_t GetOutputRate() const
+        {
+            return outputRate_;
+        }
+
+        //! Returns the number of interleaved channels.
+        inline std::uint16_t GetChannels() const
+        {
+            return channels_;
+        }
+
+        //! Returns the resampler quality.
+        inline ResamplerQuality GetQuality() const
+        {
+            return quality_;
+        }
+
+    private:
+
+        void BuildFilterTable();
+
+        void AppendInput(const float* input, std::size_t inputFrames);
+        void AppendSilence(std::size_t frames);
+        std::size_t GenerateOutput(std::vector<float>& output, std::uint64_t maxOutputFrames);
+        void DiscardInput();
+
+    private:
+
+        std::uint32_t                   inputRate_          = 0;
+        std::uint32_t                   outputRate_         = 0;
+        std::uint16_t                   channels_           = 0;
+        ResamplerQuality                quality_            = ResamplerQuality::Sinc;
+
+        std::uint64_t                   upFactor_           = 1;    // L: output rate divided by GCD of both rates
+        std::uint64_t                   downFactor_         = 1;    // M: input rate divided by GCD of both rates
+
+        std::size_t                     halfTaps_           = 0;    // Number of taps on each side of the filter center
+        std::size_t                     taps_               = 0;    // Number of taps per phase (padded to a multiple of 4)
+        std::size_t                     phases_             = 0;    // Number of precomputed phases (the table has one more for interpolation)
+        bool                            interpolatePhases_  = false;
+        std::vector<float>              filterTable_;
+
+        std::vector<std::vector<float>> history_;                   // Pending input samples (one array per channel)
+        std::size_t                     inputIndex_         = 0;    // Index of the first tap (within the history) for the next output frame
+        std::uint64_t                   phase_              = 0;    // Phase numerator in the range [0, L)
+
+        std::uint64_t                   totalInputFrames_   = 0;
+        std::uint64_t                   totalOutputFrames_  = 0;
+
+};
+
+
+} // /namespace Ac
+
+
+#endif
+
+
+
+// ================================================================================
@@ -0,0 +1,134 @@
+/*
+ * STFT.h
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef AC_STFT_H
+#define AC_STFT_H
+
+
+#include <Ac/Export.h>
+#include <Ac/FFT.h>
+#include <Ac/WaveBufferView.h>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+
+namespace Ac
+{
+
+
+/**
+\brief Short-time Fourier transform (STFT) of the channels of wave buffers.
+\remarks The signal is split into overlapping frames, which are weighted by the window function and transformed with a real FFT.
+Frame 'i' is centered at the sample frame 'i * GetHopSize()', and the samples outside of the wave buffer are treated as silence,
+so the synthesis (weighted overlap-add) reconstructs the entire signal from unmodified spectra. Here is an example of a simple spectral filter:
+\code
+Ac::STFT stft(2048, 512);
+std::vector<std::complex<float>> spectra;
+stft.Analyze(waveBuffer, 0, spectra);
+
+// Remove all frequencies above 1 kHz
+auto firstBin = static_cast<std::size_t>(1000.0 / stft.GetBinFrequency(1, waveBuffer.GetFormat().sampleRate));
+for (std::size_t i = 0; i < stft.GetNumFrames(waveBuffer.GetSampleFrames()); ++i)
+{
+    for (std::size_t bin = firstBin; bin < stft.GetNumBins(); ++bin)
+        spectra[i * stft.GetNumBins() + bin] = 0.0f;
+}
+
+stft.Synthesize(spectra, waveBuffer, 0);
+\endcode
+*/
+class AC_EXPORT STFT
+{
+
+    public:
+
+        /**
+        \brief Initializes the STFT with the window which is precomputed once.
+        \param[in] frameSize Specifies the number of samples of each frame. This can be any size, but sizes with only the prime factors 2, 3, and 5 are the fastest.
+        \param[in] hopSize Specifies the number of samples between the beginnings of two successive frames, e.g. a quarter of the frame size.
+        \param[in] windowFunction Specifies the window function of the analysis and the synthesis. By default WindowFunction::Hann.
+        \throws std::invalid_argument If the frame size or the hop size is zero, or if the hop size is greater than the frame size.
+        */
+        STFT(std::size_t frameSize, std::size_t hopSize, const WindowFunction windowFunction = WindowFunction::Hann);
+
+        /**
+        \brief Transforms the specified channel into a sequence of spectra.
+        \param[in] view Specifies the samples which are to be analyzed.
+        \param[in] channel Specifies the channel which is to be analyzed.
+        \param[out] spectra Specifies the output spectra. This will be resized to 'GetNumFrames(view.GetSampleFrames()) * GetNumBins()' elements,
+        where the bins of frame 'i' begin at index 'i * GetNumBins()'.
+        \throws std::out_of_range If the channel index is out of range.
+        */
+        void Analyze(const WaveBufferConstView& view, std::uint16_t channel, std::vector<std::complex<float>>& spectra) const;
+
+        /**
+        \brief Transforms the sequence of spectra back into the specified channel (with weighted overlap-add).
+        \param[in] spectra Specifies the input spectra in the layout of the "Analyze" function.
+        \param[in] view Specifies the destination samples. Frames of the spectra beyond the end of the view are ignored.
+        \param[in] channel Specifies the channel which is to be overwritten. The other channels are not modified.
+        \remarks Each output sample is normalized by the sum of the squared window weights of all frames which overlap the sample.
+        \throws std::out_of_range If the channel index is out of range.
+        */
+        void Synthesize(const std::vector<std::complex<float>>& spectra, const WaveBufferView& view, std::uint16_t channel) const;
+
+        //! Returns the number of frames for the specified number of sample frames.
+        inline std::size_t GetNumFrames(std::size_t sampleFrames) const
+        {
+            return (sampleFrames / hopSize_ + 1);
+        }
+
+        //! Returns the number of bins of each spectrum, i.e. 'GetFrameSize()/2 + 1'.
+        inline std::size_t GetNumBins() const
+        {
+            return plan_->GetNumBins();
+        }
+
+        //! Returns the center frequency (in Hz) of the specified bin for the sample rate.
+        inline double GetBinFrequency(std::size_t bin, std::uint32_t sampleRate) const
+        {
+            return static_cast<double>(bin) * static_cast<double>(sampleRate) / static_cast<double>(frameSize_);
+        }
+
+        //! Returns the number of samples of each frame.
+        inline std::size_t GetFrameSize() const
+        {
+            return frameSize_;
+        }
+
+        //! Returns the number of samples between the beginnings of two successive frames.
+        inline std::size_t GetHopSize() const
+        {
+            return hopSize_;
+        }
+
+        //! Returns the weights of the (periodic) window.
+        inline const std::vector<float>& GetWindow() const
+        {
+            return window_;
+        }
+
+    private:
+
+        std::size_t                         frameSize_  = 0;
+        std::size_t                         hopSize_    = 0;
+        std::vector<float>                  window_;
+        std::shared_ptr<const RealFFTPlan>  plan_;
+
+};
+
+
+} // /namespace Ac
+
+
+#endif
+
+
+
+// ================================================================================
@@ -0,0 +1,327 @@
+/*
+ * SampleAllocator.h
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef AC_SAMPLE_ALLOCATOR_H
+#define AC_SAMPLE_ALLOCATOR_H
+
+
+#include "Export.h"
+
+#include <cstddef>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+
+namespace Ac
+{
+
+
+/**
+\brief Sample memory allocator interface.
+\remarks This is used for the sample storage of wave buffers (see WaveBuffer::SetAllocator).
+An allocator must stay alive until all memory which has been allocated from it has been deallocated,
+i.e. until all wave buffers (and their copies) which use this allocator have been destroyed.
+\see SetDefaultSampleAllocator
+\see PoolSampleAllocator
+\see ArenaSampleAllocator
+\see HugePageSampleAllocator
+*/
+class AC_EXPORT SampleAllocator
+{
+
+    public:
+
+        SampleAllocator() = default;
+
+        SampleAllocator(const SampleAllocator&) = delete;
+        SampleAllocator& operator = (const SampleAllocator&) = delete;
+
+        virtual ~SampleAllocator();
+
+        /**
+        \brief Allocates a memory block of the specified size (in bytes).
+        \remarks The memory must be aligned to at least 'SampleAllocator::alignment' bytes.
+        \throws std::bad_alloc If the memory could not be allocated.
+        */
+        virtual void* Allocate(std::size_t size) = 0;
+
+        //! Deallocates the specified memory block. The size must be the same as for the allocation.
+        virtual void Deallocate(void* ptr, std::size_t size) = 0;
+
+        //! Minimal alignment (in bytes) of all memory blocks returned by an allocator.
+        static const std::size_t alignment = 16;
+
+};
+
+//! Returns the allocator which forwards all allocations to the global heap (i.e. 'operator new'). This is the initial default allocator.
+AC_EXPORT SampleAllocator& GetHeapSampleAllocator();
+
+/**
+\brief Returns the process-wide default sample allocator.
+\remarks New wave buffers use this allocator unless another allocator is specified.
+\see SetDefaultSampleAllocator
+*/
+AC_EXPORT SampleAllocator& GetDefaultSampleAllocator();
+
+/**
+\brief Sets the process-wide default sample allocator.
+\param[in] allocator Pointer to the new default allocator. If this is null, the heap allocator is restored.
+\remarks This only affects wave buffers which are created afterwards; existing buffers keep their allocator.
+The allocator must be thread-safe if wave buffers are created on different threads (e.g. PoolSampleAllocator).
+Here is a usage example to keep the streaming and capture threads off the global heap:
+\code
+static Ac::PoolSampleAllocator samplePool;
+Ac::SetDefaultSampleAllocator(&samplePool);
+// ...
+Ac::SetDefaultSampleAllocator(nullptr);
+\endcode
+*/
+AC_EXPORT void SetDefaultSampleAllocator(SampleAllocator* allocator);
+
+/**
+\brief Thread-safe pool allocator with size classes.
+\remarks Each allocation is rounded up to its size class (four classes per power of two),
+and deallocated blocks are kept in a free list per size class to be reused by later allocations of the same class.
+This avoids the global heap for recurring buffer sizes, e.g. the fixed-size buffers of streaming sounds and microphones.
+Allocations which exceed the maximal block size are forwarded to the upstream allocator.
+*/
+class AC_EXPORT PoolSampleAllocator : public SampleAllocator
+{
+
+    public:
+
+        /**
+        \brief Initializes the pool allocator.
+        \param[in] maxBlockSize Specifies the size (in bytes) of the largest size class. By default 16 MiB.
+        \param[in] maxCachedSize Specifies the maximal size (in bytes) of all cached free blocks. Blocks beyond this limit are returned to the upstream allocator. By default 64 MiB.
+        \param[in] upstream Specifies the allocator from which the blocks are allocated. This must outlive the pool.
+        */
+        PoolSampleAllocator(
+            std::size_t         maxBlockSize    = (16u << 20),
+            std::size_t         maxCachedSize   = (64u << 20),
+            SampleAllocator&    upstream        = GetHeapSampleAllocator()
+        );
+
+        //! Returns all cached blocks to the upstream allocator.
+        ~PoolSampleAllocator();
+
+        void* Allocate(std::size_t size) override;
+        void Deallocate(void* ptr, std::size_t size) override;
+
+        /**
+        \brief Pre-allocates free blocks for the specified allocation size.
+        \remarks Use this before starting a stream or a recording, so that the audio thread never needs to allocate from the upstream allocator.
+        */
+        void Reserve(std::size_t size, std::size_t count);
+
+        //! Returns all cached blocks to the upstream allocator.
+        void Release();
+
+        //! Returns the size (in bytes) of all cached free blocks.
+        inline std::size_t GetCachedSize() const
+        {
+            return cachedSize_.load();
+        }
+
+    private:
+
+        struct FreeBlock
+        {
+            FreeBlock* next;
+        };
+
+        struct SizeClass
+        {
+            std::size_t size    = 0;
+            FreeBlock*  blocks  = nullptr;
+            std::mutex  mutex;
+        };
+
+        // Returns the size class for the specified allocation size, or null if the size exceeds the largest size class.
+        SizeClass* FindSizeClass(std::size_t size);
+
+        // Pushes the specified block into the free list, or returns false if the cache limit has been reached.
+        bool PushBlock(SizeClass& sizeClass, void* ptr);
+
+        SampleAllocator&                            upstream_;
+        std::size_t                                 maxCachedSize_  = 0;
+        std::atomic<std::size_t>                    cachedSize_;
+        std::vector<std::unique_ptr<SizeClass>>     sizeClasses_;
+
+};
+
+/**
+\brief Monotonic arena allocator for short-lived scratch buffers.
+\remarks Allocations are taken from large chunks by incrementing an offset. Deallocations are ignored,
+except for the most recent allocation, whose memory is given back (this supports growing a single scratch buffer).
+All memory is reused after a call to "Reset". This allocator is not thread-safe.
+\code
+// Process a temporary buffer without touching the global heap once the arena has grown large enough
+Ac::ArenaSampleAllocator arena;
+{
+    Ac::WaveBuffer scratch(format, Ac::WaveBufferStorage::PlanarFloat, arena);
+    scratch.SetSampleFrames(frames);
+    // ...
+}
+arena.Reset();
+\endcode
+*/
+class AC_EXPORT ArenaSampleAllocator : public SampleAllocator
+{
+
+    public:
+
+        /**
+        \brief Initializes the arena allocator.
+        \param[in] chunkSize Specifies the minimal size (in bytes) of each chunk which is allocated from the upstream allocator. By default 1 MiB.
+        \param[in] upstream Specifies the allocator from which the chunks are allocated. This must outlive the arena.
+        */
+        ArenaSampleAllocator(std::size_t chunkSize = (1u << 20), SampleAllocator& upstream = GetHeapSampleAllocator());
+
+        //! Returns all chunks to the upstream allocator.
+        ~ArenaSampleAllocator();
+
+        void* Allocate(std::size_t size) override;
+        void Deallocate(void* ptr, std::size_t size) override;
+
+        /**
+        \brief Makes all chunks available for new allocations again.
+        \remarks All memory which has been allocated from this arena must no longer be used.
+        */
+        void Reset();
+
+        //! Returns all chunks to the upstream allocator.
+        void Release();
+
+        //! Returns the size (in bytes) of all chunks.
+        std::size_t GetCapacity() const;
+
+    private:
+
+        struct Chunk
+        {
+            char*       data;
+            std::size_t size;
+        };
+
+        SampleAllocator&    upstream_;
+        std::size_t         chunkSize_  = 0;
+        std::vector<Chunk>  chunks_;
+        std::size_t         chunkIndex_ = 0;
+        std::size_t         offset_     = 0;
+
+};
+
+/**
+\brief Allocator which backs large buffers with huge pages (also called large pages) directly from the operating system.
+\remarks This reduces TLB misses for large resident buffers, e.g. long sounds which are processed or mixed frequently.
+If huge pages are not available (e.g. missing privileges or no reserved pages), the memory is backed by regular pages.
+Allocations smaller than the minimal size are forwarded to the upstream allocator. This allocator is thread-safe.
+*/
+class AC_EXPORT HugePageSampleAllocator : public SampleAllocator
+{
+
+    public:
+
+        /**
+        \brief Initializes the huge page allocator.
+        \param[in] minSize Specifies the minimal size (in bytes) for allocations from the operating system. If this is zero, the huge page size is used.
+        \param[in] upstream Specifies the allocator for smaller allocations. This must outlive this allocator.
+        */
+        HugePageSampleAllocator(std::size_t minSize = 0, SampleAllocator& upstream = GetHeapSampleAllocator());
+
+        void* Allocate(std::size_t size) override;
+        void Deallocate(void* ptr, std::size_t size) override;
+
+        //! Returns the huge page size (in bytes) of the operating system, e.g. 2 MiB on x86-64.
+        static std::size_t GetHugePageSize();
+
+    private:
+
+        SampleAllocator&    upstream_;
+        std::size_t         minSize_    = 0;
+
+};
+
+/**
+\brief Standard library allocator adapter for a sample allocator.
+\remarks This allows to use a sample allocator for standard containers, e.g. the PCMBuffer type.
+The adapter refers to its sample allocator, which must outlive all containers using it.
+*/
+template <typename T>
+class SampleAllocatorAdapter
+{
+
+    public:
+
+        using value_type                                = T;
+        using propagate_on_container_copy_assignment    = std::true_type;
+        using propagate_on_container_move_assignment    = std::true_type;
+        using propagate_on_container_swap               = std::true_type;
+
+        //! Initializes the adapter with the current default sample allocator.
+        SampleAllocatorAdapter() :
+            allocator_ { &GetDefaultSampleAllocator() }
+        {
+        }
+
+        SampleAllocatorAdapter(SampleAllocator& allocator) :
+            allocator_ { &allocator }
+        {
+        }
+
+        template <typename U>
+        SampleAllocatorAdapter(const SampleAllocatorAdapter<U>& rhs) :
+            allocator_ { &rhs.GetAllocator() }
+        {
+        }
+
+        T* allocate(std::size_t n)
+        {
+            return static_cast<T*>(allocator_->Allocate(n * sizeof(T)));
+        }
+
+        void deallocate(T* ptr, std::size_t n)
+        {
+            allocator_->Deallocate(ptr, n * sizeof(T));
+        }
+
+        //! Returns the sample allocator this adapter refers to.
+        inline SampleAllocator& GetAllocator() const
+        {
+            return *allocator_;
+        }
+
+    private:
+
+        SampleAllocator* allocator_;
+
+};
+
+template <typename T, typename U>
+bool operator == (const SampleAllocatorAdapter<T>& lhs, const SampleAllocatorAdapter<U>& rhs)
+{
+    return (&lhs.GetAllocator() == &rhs.GetAllocator());
+}
+
+template <typename T, typename U>
+bool operator != (const SampleAllocatorAdapter<T>& lhs, const SampleAllocatorAdapter<U>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+
+} // /namespace Ac
+
+
+#endif
+
+
+
+// ================================================================================
@@ -11,6 +11,7 @@
 
 #include "Export.h"
 #include "WaveBuffer.h"
+#include "WaveBufferView.h"
 #include "AudioStream.h"
 
 #include <Gauss/Vector3.h>
@@ -91,10 +92,21 @@ class AC_EXPORT Sound
 
         /**
         \brief Appends the specified buffer at the end of the buffer queue of this sound.
+        \param[in] waveBuffer Specifies the wave buffer or a view onto a range of sample frames.
+        The samples are copied into the audio device, so the referenced memory can be reused after this call.
         \remarks If this function is used, the sound will be managed for audio streaming.
         \see AttachBuffer
+        \see WaveBufferConstView
         */
-        virtual void QueueBuffer(const WaveBuffer& waveBuffer) = 0;
+        virtual void QueueBuffer(const WaveBufferConstView& waveBuffer) = 0;
+
+        /**
+        \brief Appends each chunk of the specified wave buffer at the end of the buffer queue of this sound.
+        \remarks This queues a long recording with the chunked storage without flattening it into a contiguous buffer first.
+        \see QueueBuffer
+        \see WaveBuffer::SetChunkSize
+        */
+        void QueueBufferChunks(const WaveBuffer& waveBuffer);
 
         /**
         \brief Returns the current size of the buffer queue.
@@ -13,6 +13,7 @@
 #include "WaveBuffer.h"
 #include "MusicalNotes.h"
 #include "PerlinNoise.h"
+#include "WaveFormExpression.h"
 #include <functional>
 #include <vector>
 
@@ -20,10 +21,19 @@
 namespace Ac
 {
 
+
+enum class BiquadType;
+struct CompressorParameters;
+struct LimiterParameters;
+struct DuckerParameters;
+class CrossfadeCurve;
+
 namespace Synthesizer
 {
 
 
+struct FDNReverbParameters;
+
 /**
 \brief Fading function interface.
 \param[in,out] t Specifies the interpolation value.
@@ -32,26 +42,11 @@ Either the input and output value must always be in the range [0, 1].
 */
 using FadingFunction = std::function<void(double& t)>;
 
-//! Helper structure to easily specify standard wave form parameters.
-struct AC_EXPORT WaveForm
-{
-    WaveForm() = default;
-    WaveForm(const WaveForm&) = default;
-    WaveForm& operator = (const WaveForm&) = default;
-
-    inline WaveForm(double frequency, double amplitude = 1.0, double phase = 0.0) :
-        frequency { frequency },
-        amplitude { amplitude },
-        phase     { phase     }
-    {
-    }
-
-    double frequency    = 0.0;
-    double amplitude    = 1.0;
-    double phase        = 0.0;
-};
-
-//! Helper class to easily combine wave form generator functions.
+/**
+\brief Helper class to easily combine wave form generator functions.
+\remarks The generator functions are type erased, i.e. each one is called indirectly for each sample.
+To combine stateless wave forms, use wave form expressions instead (see WaveFormExpression), which can be converted to this class.
+*/
 class AC_EXPORT WaveFormGenerator
 {
 
@@ -63,6 +58,13 @@ class AC_EXPORT WaveFormGenerator
 
         WaveFormGenerator(const SampleIterationFunction& initialFunction);
 
+        //! Initializes the generator with the specified wave form expression.
+        template <typename Expr, typename = typename std::enable_if<IsWaveFormExpression<Expr>::value>::type>
+        WaveFormGenerator(const Expr& expr) :
+            WaveFormGenerator { SampleIterationFunction(expr) }
+        {
+        }
+
         WaveFormGenerator& operator = (const WaveFormGenerator&) = default;
         WaveFormGenerator& operator = (WaveFormGenerator&&) = default;
 
@@ -104,40 +106,132 @@ AC_EXPORT WaveFormGenerator operator - (const WaveFormGenerator& lhs, const Wave
 
 /* ----- Wave generators ----- */
 
+/*
+All wave generators are stateless (see SampleIteratorState::Stateless), i.e. they can be used with "WaveBuffer::ParallelForEachSample",
+except for the noise generators "WhiteNoiseGenerator", "PinkNoiseGenerator", and "BrownNoiseGenerator", which are stateful.
+A combined WaveFormGenerator is stateless only if all of its generator functions are stateless.
+The standard wave generators return wave form expressions (see WaveFormExpression), i.e. they can be combined at compile time
+and converted to a WaveFormGenerator, e.g. "SineGenerator(a) + SawGenerator(b)" results in a concrete type.
+*/
+
 /**
-\brief Returns a sine wave generator function of the form: sin((timePoint + phase)*2*PI*frequency)*amplitude.
-\param[in] amplitude Specifies the sine wave amplitude (maximal sine value).
-\param[in] phase Specifies the phase value within the sine function.
-\param[in] frequency Specifies the sine wave frequency. This frequency should be in the human hearable frequency range, which is 20 to 20,000 Hz.
-\see WaveGeneratorFunction
-\see GenerateWave
+\brief Returns a sine wave generator of the form: sin((timePoint + phase)*2*PI*frequency)*amplitude.
+\param[in] wave Specifies the wave form parameters. The frequency should be in the human hearable frequency range, which is 20 to 20,000 Hz.
+\see SineWave
+\see Oscillator
 */
-AC_EXPORT WaveFormGenerator SineGenerator(const WaveForm& wave);
+inline SineWave SineGenerator(const WaveForm& wave)
+{
+    return SineWave(wave);
+}
 
 /**
-\brief Returns a square wave generator function.
+\brief Returns a square wave generator.
 \param[in] bias Specifies the phase value in the half-open range (0, 1).
+\see SquareWave
 */
-AC_EXPORT WaveFormGenerator SquareGenerator(const WaveForm& wave, double bias = 0.0);
+inline SquareWave SquareGenerator(const WaveForm& wave, double bias = 0.0)
+{
+    return SquareWave(wave, bias);
+}
+
+//! Returns a triangle wave generator, which is in phase with the sine wave.
+inline TriangleWave TriangleGenerator(const WaveForm& wave)
+{
+    return TriangleWave(wave);
+}
+
+//! Returns a saw-tooth wave generator.
+inline SawWave SawGenerator(const WaveForm& wave)
+{
+    return SawWave(wave);
+}
+
+//! Returns a half-circle wave generator.
+inline HalfCircleWave HalfCircleGenerator(const WaveForm& wave)
+{
+    return HalfCircleWave(wave);
+}
 
-AC_EXPORT WaveFormGenerator TriangleGenerator(const WaveForm& wave);
+/**
+\brief Returns a band-limited square wave generator, which avoids most of the aliasing of "SquareGenerator" at high frequencies.
+\param[in] sampleRate Specifies the sample rate (in Hz) of the wave buffer the wave form is generated for.
+\param[in] bias Specifies the phase value in the half-open range (0, 1).
+\see BandLimitedSquareWave
+\see PolyBLEP
+*/
+inline BandLimitedSquareWave BandLimitedSquareGenerator(const WaveForm& wave, std::uint32_t sampleRate, double bias = 0.0)
+{
+    return BandLimitedSquareWave(wave, sampleRate, bias);
+}
 
-AC_EXPORT WaveFormGenerator SawGenerator(const WaveForm& wave);
+/**
+\brief Returns a band-limited triangle wave generator.
+\see BandLimitedSquareGenerator
+\see PolyBLAMP
+*/
+inline BandLimitedTriangleWave BandLimitedTriangleGenerator(const WaveForm& wave, std::uint32_t sampleRate)
+{
+    return BandLimitedTriangleWave(wave, sampleRate);
+}
 
-AC_EXPORT WaveFormGenerator HalfCircleGenerator(const WaveForm& wave);
+/**
+\brief Returns a band-limited saw-tooth wave generator.
+\see BandLimitedSquareGenerator
+*/
+inline BandLimitedSawWave BandLimitedSawGenerator(const WaveForm& wave, std::uint32_t sampleRate)
+{
+    return BandLimitedSawWave(wave, sampleRate);
+}
 
+/**
+\brief Returns a function object which multiplies each sample by the specified multiplicator.
+\see AmplifyWaveBuffer
+*/
 AC_EXPORT SampleIterationFunction Amplifier(double multiplicator);
 
+/**
+\brief Returns a function object of a "white-noise" wave generator.
+\remarks This generator is stateful, since it has its own random number generator (see NoiseGenerator) with a separate stream for each channel.
+Each generator without an explicit seed gets a new seed from a process-wide counter.
+To generate entire blocks of noise, use the NoiseGenerator class with "WaveBuffer::ForEachBlock" instead.
+*/
 AC_EXPORT WaveFormGenerator WhiteNoiseGenerator(double amplitude);
 
+/**
+\brief Returns a function object of a "white-noise" wave generator with the specified random seed.
+\remarks The noise only depends on the seed, i.e. the output is reproducible.
+\see WhiteNoiseGenerator(double)
+*/
+AC_EXPORT WaveFormGenerator WhiteNoiseGenerator(double amplitude, std::uint64_t seed);
+
+/**
+\brief Returns a function object of a "pink-noise" wave generator, whose spectrum falls by 3 dB per octave.
+\see WhiteNoiseGenerator(double)
+*/
+AC_EXPORT WaveFormGenerator PinkNoiseGenerator(double amplitude);
+
+/**
+\brief Returns a function object of a "pink-noise" wave generator with the specified random seed.
+\see WhiteNoiseGenerator(double, std::uint64_t)
+*/
+AC_EXPORT WaveFormGenerator PinkNoiseGenerator(double amplitude, std::uint64_t seed);
+
 /**
 \brief Returns a function object of a "brown-noise" wave generator.
 \param[in] amplitude Specifies the wave amplitude (maximal value in the range [-amplitude, amplitude]).
 \param[out] state Specifies the noise generation state and is only used as temporary storage.
 This can also be uninitialized since it will be set to 0.0 at start up time.
+\remarks This generator is stateful (see SampleIteratorState::Stateful), since each sample depends on the previous one.
+To render multiple brown-noise buffers in parallel, use a separate state variable for each buffer.
 */
 AC_EXPORT WaveFormGenerator BrownNoiseGenerator(double amplitude, double& state);
 
+/**
+\brief Returns a function object of a Perlin noise wave generator.
+\remarks The noise function is evaluated for each sample. To generate longer noise signals,
+evaluate the noise for entire blocks of time points with "PerlinNoise::Noise(const double*, double*, std::size_t, std::uint32_t, std::uint32_t, double) const".
+*/
 AC_EXPORT WaveFormGenerator PerlinNoiseGenerator(double amplitude, PerlinNoise& noiseFunction, std::uint32_t frequency = 4, std::uint32_t octaves = 5, double persitence = 0.5);
 
 /* ----- Misc ----- */
@@ -149,14 +243,156 @@ AC_EXPORT WaveFormGenerator PerlinNoiseGenerator(double amplitude, PerlinNoise&
 */
 AC_EXPORT double GetNoteFrequency(const MusicalNotes note, int interval);
 
+/* ----- Bulk transforms ----- */
+
+/*
+The following transforms work in place on the sample storage of a wave buffer (all PCM formats and the planar storage).
+They process the samples block by block with vectorized kernels, which is much faster than per-sample iteration functions.
+Modified samples are clamped to the range [-1, 1]. The analysis functions (e.g. "GetPeakLevel") do not flatten chunked wave buffers.
+*/
+
 /**
-\brief Reverses the specified wave buffer.
+\brief Reverses the order of the sample frames of the specified wave buffer in place. This is lossless for all formats.
 \see ReverseWaveGenerator
 */
 AC_EXPORT void ReverseWaveBuffer(WaveBuffer& buffer);
 
+/**
+\brief Multiplies all samples of the specified wave buffer by the gain.
+\remarks This is the bulk operation for "ForEachSample" with an "Amplifier" function.
+\see Amplifier
+*/
+AC_EXPORT void AmplifyWaveBuffer(WaveBuffer& buffer, double gain);
+
+/**
+\brief Multiplies the samples within the specified time range by a linear gain ramp, e.g. to fade in or out.
+\param[in,out] buffer Specifies the buffer which is to be modified.
+\param[in] gainFrom Specifies the gain at the time point 'timePointFrom'.
+\param[in] gainTo Specifies the gain at the time point 'timePointTo'.
+\param[in] timePointFrom Specifies the time point where the ramp starts. This will be clamped to [0, buffer.GetTotalTime()].
+\param[in] timePointTo Specifies the time point where the ramp ends. This will be clamped to [timePointFrom, buffer.GetTotalTime()].
+\remarks The samples outside of the range are not modified.
+*/
+AC_EXPORT void AmplifyWaveBuffer(WaveBuffer& buffer, double gainFrom, double gainTo, double timePointFrom, double timePointTo);
+
+//! Returns the peak level of the specified wave buffer, i.e. the maximal absolute sample value in the range [0, 1].
+AC_EXPORT double GetPeakLevel(const WaveBuffer& buffer);
+
+//! Returns the RMS (root mean square) level of all samples of the specified wave buffer in the range [0, 1].
+AC_EXPORT double GetRMSLevel(const WaveBuffer& buffer);
+
+/**
+\brief Amplifies the specified wave buffer, so that its peak level matches the specified level.
+\param[in] peakLevel Specifies the new peak level. By default 1.
+\return Gain that has been applied, or 1 if the wave buffer is silent.
+\see GetPeakLevel
+*/
+AC_EXPORT double NormalizeWaveBuffer(WaveBuffer& buffer, double peakLevel = 1.0);
+
+/**
+\brief Amplifies the specified wave buffer, so that its RMS level matches the specified level.
+\return Gain that has been applied, or 1 if the wave buffer is silent.
+\remarks Samples which exceed the range [-1, 1] after the amplification are clamped.
+\see GetRMSLevel
+*/
+AC_EXPORT double NormalizeWaveBufferRMS(WaveBuffer& buffer, double rmsLevel);
+
+//! Removes the DC offset of the specified wave buffer, i.e. subtracts the mean value of each channel from its samples.
+AC_EXPORT void RemoveDCOffset(WaveBuffer& buffer);
+
+/**
+\brief Removes the silent sample frames from the beginning and the end of the specified wave buffer.
+\param[in] threshold Specifies the level a sample must exceed to not be treated as silence. By default 0.001 (i.e. -60 dB).
+\return Number of sample frames which have been removed.
+*/
+AC_EXPORT std::size_t TrimWaveBuffer(WaveBuffer& buffer, double threshold = 0.001);
+
+/* ----- Filters ----- */
+
+/**
+\brief Convolves each channel of the specified wave buffer with the impulse response (i.e. applies an FIR filter) in place.
+\param[in,out] buffer Specifies the buffer which is to be filtered.
+\param[in] impulseResponse Specifies the filter coefficients. If this is empty, the buffer is silenced.
+\param[in] delay Specifies the number of sample frames by which the output is moved back in time, e.g. 'impulseResponse.size()/2'
+for symmetric (linear phase) filters, so that they do not delay the signal. By default 0.
+\remarks The samples before the beginning and after the end of the buffer are treated as silence.
+The number of sample frames is not changed, i.e. the tail of the convolution is cut off. To keep the tail, extend the buffer first (e.g. with "WaveBuffer::SetTotalTime").
+Impulse responses with few non-zero coefficients are applied directly with vectorized kernels,
+all other impulse responses with the FFT block convolution, whose costs per sample only grow logarithmically with the length of the impulse response.
+*/
+AC_EXPORT void ConvolveWaveBuffer(WaveBuffer& buffer, const std::vector<float>& impulseResponse, std::size_t delay = 0);
+
+/**
+\brief Convolves each channel of the specified wave buffer with the respective channel of the impulse response, e.g. a recorded room response.
+\remarks If the impulse response has fewer channels than the buffer, its channels are repeated, e.g. a mono impulse response is applied to all channels.
+\throws std::invalid_argument If the sample rates of the buffer and the impulse response differ.
+\see ConvolveWaveBuffer(WaveBuffer&, const std::vector<float>&, std::size_t)
+*/
+AC_EXPORT void ConvolveWaveBuffer(WaveBuffer& buffer, const WaveBuffer& impulseResponse, std::size_t delay = 0);
+
+/**
+\brief Blurs the specified wave buffer with a normal distribution, i.e. applies a low-pass filter.
+\param[in] timeSpread Specifies the time range (in seconds) around each sample, from which the blurred sample is accumulated. By default 0.1.
+\param[in] variance Specifies the variance of the normal distribution. By default 1.
+\param[in] sampleCount Specifies the number of sample intervals within the time range, i.e. 'sampleCount + 1' samples are accumulated. By default 6.
+\remarks The samples at the beginning and the end of the buffer are repeated beyond the buffer boundaries.
+\see ConvolveWaveBuffer
+*/
 AC_EXPORT void BlurWaveBuffer(WaveBuffer& buffer, double timeSpread = 0.1, double variance = 1.0, std::size_t sampleCount = 6);
 
+/**
+\brief Filters each channel of the specified wave buffer in place with a biquad filter.
+\param[in] type Specifies the filter type.
+\param[in] frequency Specifies the cutoff, corner, or center frequency (in Hz).
+\param[in] q Specifies the Q factor. By default 1/sqrt(2).
+\param[in] gain Specifies the gain (in dB) of shelf and peaking filters. By default 0.
+\throws std::invalid_argument If the Q factor is not positive.
+\see BiquadFilterBank
+\see ParametricEqualizer
+*/
+AC_EXPORT void FilterWaveBuffer(WaveBuffer& buffer, const BiquadType type, double frequency, double q = 0.7071067811865476, double gain = 0.0);
+
+/**
+\brief Applies an algorithmic reverb (see FDNReverb) to the specified wave buffer in place.
+\remarks The number of sample frames is not changed, i.e. the reverb tail is cut off at the end of the buffer.
+To keep the tail, extend the buffer first (e.g. by 'FDNReverb::GetTailFrames' sample frames).
+\see FDNReverb
+*/
+AC_EXPORT void ReverbWaveBuffer(WaveBuffer& buffer, const FDNReverbParameters& parameters);
+
+//! Applies an algorithmic reverb with the default parameters (see FDNReverbParameters) to the specified wave buffer in place.
+AC_EXPORT void ReverbWaveBuffer(WaveBuffer& buffer);
+
+/**
+\brief Compresses the dynamic range of the specified wave buffer in place.
+\see Compressor
+*/
+AC_EXPORT void CompressWaveBuffer(WaveBuffer& buffer, const CompressorParameters& parameters);
+
+//! Compresses the dynamic range of the specified wave buffer in place with the default parameters (see CompressorParameters).
+AC_EXPORT void CompressWaveBuffer(WaveBuffer& buffer);
+
+/**
+\brief Limits the peaks of the specified wave buffer in place, i.e. no sample exceeds the ceiling afterwards.
+\remarks The latency of the look-ahead is compensated, i.e. the samples are not shifted in time.
+\see Limiter
+*/
+AC_EXPORT void LimitWaveBuffer(WaveBuffer& buffer, const LimiterParameters& parameters, double lookAheadTime = 0.005);
+
+//! Limits the peaks of the specified wave buffer in place with the default parameters (see LimiterParameters) and a look-ahead of 5 ms.
+AC_EXPORT void LimitWaveBuffer(WaveBuffer& buffer);
+
+/**
+\brief Attenuates the specified wave buffer in place while the sidechain wave buffer is active, e.g. music during dialogue.
+\remarks If the sidechain is shorter than the buffer, it is continued with silence.
+\throws std::invalid_argument If the sample rates of the buffer and the sidechain differ.
+\see Ducker
+*/
+AC_EXPORT void DuckWaveBuffer(WaveBuffer& buffer, const WaveBuffer& sidechain, const DuckerParameters& parameters);
+
+//! Attenuates the specified wave buffer in place with the default parameters (see DuckerParameters) while the sidechain wave buffer is active.
+AC_EXPORT void DuckWaveBuffer(WaveBuffer& buffer, const WaveBuffer& sidechain);
+
 /**
 \brief Fades (or rather interpolates) between the two constant wave buffers.
 \param[in,out] buffer Specifies the buffer which is to be modified.
@@ -164,8 +400,26 @@ AC_EXPORT void BlurWaveBuffer(WaveBuffer& buffer, double timeSpread = 0.1, doubl
 \param[in] bufferFadeTo Specifies the buffer to which the fading is ending. This can also be the output buffer.
 \param[in] timePointFrom Specifies the time point from which the fading is starting. This will be clamped to [0, buffer.GetTotalTime()].
 \param[in] timePointTo Specifies the time point to which the fading is ending. This will be clamped to [timePointFrom, buffer.GetTotalTime()].
-\param[in] fading Specifies the fading modification function. If this is null, no fading modification is applied. By default null.
+\param[in] curve Specifies the crossfade curve, e.g. CrossfadeShape::EqualPower to crossfade two songs.
 \param[in] writeOutlines Specifies wether the outline samples (i.e. outside the range [timePointForm, timePointEnd]) will also be written or not. By default true.
+\remarks The buffers are crossfaded block by block with the precomputed gains of the curve (see CrossfadeCurve::Blend).
+If the sample rate or number of channels of a fading buffer differs from the output buffer, its samples are looked up at the same time points.
+*/
+AC_EXPORT void FadeWaveBuffers(
+    WaveBuffer&             buffer,
+    const WaveBuffer&       bufferFadeFrom,
+    const WaveBuffer&       bufferFadeTo,
+    double                  timePointFrom,
+    double                  timePointTo,
+    const CrossfadeCurve&   curve,
+    bool                    writeOutlines = true
+);
+
+/**
+\brief Fades (or rather interpolates) between the two constant wave buffers.
+\param[in] fading Specifies the fading modification function. If this is null, no fading modification is applied. By default null.
+\remarks The fading function is only evaluated for the table of a crossfade curve (see CrossfadeCurve::CrossfadeCurve(const std::function<void(double&)>&)), not for each sample.
+\see FadeWaveBuffers(WaveBuffer&, const WaveBuffer&, const WaveBuffer&, double, double, const CrossfadeCurve&, bool)
 */
 AC_EXPORT void FadeWaveBuffers(
     WaveBuffer&             buffer,
@@ -0,0 +1,147 @@
+/*
+ * ThreadPool.h
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef AC_THREAD_POOL_H
+#define AC_THREAD_POOL_H
+
+
+#include "Export.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace Ac
+{
+
+
+/**
+\brief Interface of a parallel range task.
+\param[in] begin Specifies the first index of the partition.
+\param[in] end Specifies the index after the last index of the partition, i.e. the partition is [begin, end).
+\see ThreadPool::ParallelFor
+*/
+using ParallelRangeFunction = std::function<void(std::size_t begin, std::size_t end)>;
+
+/**
+\brief Thread pool to partition index ranges across multiple cores.
+\remarks The calling thread always takes part in the work, so a pool with N threads has N - 1 worker threads.
+Only one parallel range is processed at a time: if "ParallelFor" is called while the pool is busy
+(e.g. from within a task of the same pool, or from another thread), the range is processed on the calling thread instead.
+This makes nested parallel calls safe. Here is a usage example to batch-render procedural sounds:
+\code
+// Render many variations in parallel (the nested "ParallelForEachSample" calls run on the respective worker thread)
+std::vector<Ac::WaveBuffer> variations(count, Ac::WaveBuffer(format));
+Ac::GetDefaultThreadPool().ParallelFor(
+    0, variations.size(), 1,
+    [&](std::size_t begin, std::size_t end)
+    {
+        for (auto i = begin; i < end; ++i)
+        {
+            double state = 0.0;
+            variations[i].SetTotalTime(2.0);
+            variations[i].ForEachSample(Ac::Synthesizer::BrownNoiseGenerator(0.5, state));
+        }
+    }
+);
+\endcode
+\see WaveBuffer::ParallelForEachSample
+*/
+class AC_EXPORT ThreadPool
+{
+
+    public:
+
+        /**
+        \brief Initializes the thread pool.
+        \param[in] numThreads Specifies the number of threads, including the calling thread.
+        If this is zero, the number of hardware threads is used. If this is one, all ranges are processed on the calling thread.
+        */
+        explicit ThreadPool(std::size_t numThreads = 0);
+
+        //! Waits for all worker threads to finish.
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator = (const ThreadPool&) = delete;
+
+        /**
+        \brief Partitions the range [begin, end) and processes the partitions in parallel. This function returns when all partitions have been processed.
+        \param[in] begin Specifies the first index.
+        \param[in] end Specifies the index after the last index.
+        \param[in] grainSize Specifies the minimal number of indices per partition. Ranges which are not larger than this are processed on the calling thread.
+        \param[in] task Specifies the task function, which is called once for each partition.
+        \remarks If a task throws an exception, the remaining partitions are skipped and the first exception is re-thrown on the calling thread.
+        */
+        void ParallelFor(std::size_t begin, std::size_t end, std::size_t grainSize, const ParallelRangeFunction& task);
+
+        //! Returns the number of threads which process the partitions, including the calling thread.
+        inline std::size_t GetNumThreads() const
+        {
+            return (workers_.size() + 1);
+        }
+
+    private:
+
+        void WorkerThread();
+
+        // Processes partitions of the current range until all have been claimed.
+        void RunPartitions();
+
+    private:
+
+        std::vector<std::thread>    workers_;
+
+        std::mutex                  rangeMutex_;            // Only one range is processed at a time
+        std::mutex                  mutex_;
+        std::condition_variable     workSignal_;
+        std::condition_variable     doneSignal_;
+        bool                        quit_               = false;
+        std::uint64_t               generation_         = 0;
+        std::size_t                 activeWorkers_      = 0;
+
+        const ParallelRangeFunction* task_              = nullptr;
+        std::size_t                 begin_              = 0;
+        std::size_t                 end_                = 0;
+        std::size_t                 partitionSize_      = 0;
+        std::size_t                 numPartitions_      = 0;
+        std::size_t                 finishedPartitions_ = 0;
+        std::atomic<std::size_t>    nextPartition_;
+        std::atomic<bool>           failed_;
+        std::exception_ptr          exception_;
+
+};
+
+/**
+\brief Returns the process-wide default thread pool.
+\remarks If no thread pool has been set, a pool with the number of hardware threads is created on the first call.
+\see SetDefaultThreadPool
+*/
+AC_EXPORT ThreadPool& GetDefaultThreadPool();
+
+/**
+\brief Sets the process-wide default thread pool.
+\param[in] threadPool Pointer to the new default thread pool. This must outlive all functions which use it. If this is null, the initial default pool is restored.
+*/
+AC_EXPORT void SetDefaultThreadPool(ThreadPool* threadPool);
+
+
+} // /namespace Ac
+
+
+#endif
+
+
+
+// ================================================================================
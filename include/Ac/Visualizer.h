@@ -10,7 +10,7 @@
 
 
 #include "Export.h"
-#include "WaveBuffer.h"
+#include "WaveBufferView.h"
 #include "Renderer.h"
 
 
@@ -25,6 +25,7 @@ namespace Visualizer
 \brief Draws the specified wave buffer for within a given time window.
 \param[in,out] renderer Specifies the renderer which is used to draw the audio signal.
 This must be an instance of a class which implements the "Renderer" interface.
+\param[in] buffer Specifies the wave buffer or a view onto a range of sample frames. Time points are relative to the first referenced sample frame.
 \param[in] channel Specifies which audio channel to draw.
 \param[in] position Specifies the position where to start with drawing.
 \param[in] size Specifies the size of the wave buffer on the render context.
@@ -33,25 +34,25 @@ This must be an instance of a class which implements the "Renderer" interface.
 \see Renderer
 */
 AC_EXPORT void DrawWaveBuffer(
-    Renderer&           renderer,
-    const WaveBuffer&   buffer,
-    std::uint16_t       channel,
-    const Gs::Vector2i& position,
-    const Gs::Vector2i& size,
-    double              timeBegin,
-    double              timeEnd
+    Renderer&                   renderer,
+    const WaveBufferConstView&  buffer,
+    std::uint16_t               channel,
+    const Gs::Vector2i&         position,
+    const Gs::Vector2i&         size,
+    double                      timeBegin,
+    double                      timeEnd
 );
 
 /**
 \brief Draws the specified wave buffer entirely.
-\see DrawWaveBuffer(Renderer&, const WaveBuffer&, std::uint16_t, const Gs::Vector2i&, const Gs::Vector2i&, double, double)
+\see DrawWaveBuffer(Renderer&, const WaveBufferConstView&, std::uint16_t, const Gs::Vector2i&, const Gs::Vector2i&, double, double)
 */
 AC_EXPORT void DrawWaveBuffer(
-    Renderer&           renderer,
-    const WaveBuffer&   buffer,
-    std::uint16_t       channel,
-    const Gs::Vector2i& position,
-    const Gs::Vector2i& size
+    Renderer&                   renderer,
+    const WaveBufferConstView&  buffer,
+    std::uint16_t               channel,
+    const Gs::Vector2i&         position,
+    const Gs::Vector2i&         size
 );
 
 
@@ -11,19 +11,50 @@
 
 #include "Export.h"
 #include "WaveBufferFormat.h"
+#include "Resampler.h"
+#include "ChannelMixer.h"
+#include "SampleAllocator.h"
 
 #include <vector>
 #include <queue>
 #include <memory>
 #include <functional>
+#include <algorithm>
 
 
 namespace Ac
 {
 
 
-//! Raw audio PCM (Pulse Modulation Code) buffer type.
-using PCMBuffer = std::vector<char>;
+class ThreadPool;
+class WaveBufferConstView;
+
+/**
+\brief Raw audio PCM (Pulse Modulation Code) buffer type.
+\remarks The memory is allocated with a sample allocator (see WaveBuffer::SetAllocator).
+*/
+using PCMBuffer = std::vector<char, SampleAllocatorAdapter<char>>;
+
+/**
+\brief Wave buffer sample storage enumeration.
+\see WaveBuffer::SetStorage
+*/
+enum class WaveBufferStorage
+{
+    /**
+    \brief Interleaved integer PCM samples as described by the wave buffer format. This is the default storage.
+    \remarks This is the only storage which can be passed to audio devices and file writers directly.
+    */
+    Interleaved,
+
+    /**
+    \brief Planar 32-bit floating-point samples in the range [-1, 1], i.e. one contiguous array per channel.
+    \remarks The 'bitsPerSample' field of the wave buffer format only specifies the PCM format which is used at the boundaries,
+    i.e. when the buffer is passed to an audio device or a file writer. This avoids the conversion between PCM data and floating-points for each sample operation.
+    \see WaveBuffer::ChannelData
+    */
+    PlanarFloat,
+};
 
 /**
 \brief Interface of the iteration callback function to iterate over wave buffer samples.
@@ -47,11 +78,60 @@ using SampleIterationFunction = std::function<void(double& sample, std::uint16_t
 */
 using SampleConstIterationFunction = std::function<void(double sample, std::uint16_t channel, std::size_t index, double timePoint)>;
 
+/**
+\brief Sample iterator state enumeration. This is the contract between a sample iteration callback and the parallel sample iteration.
+\see WaveBuffer::ParallelForEachSample
+*/
+enum class SampleIteratorState
+{
+    /**
+    \brief The callback only depends on its arguments (and on constant data), e.g. SineGenerator or PerlinNoiseGenerator.
+    It may be called concurrently from multiple threads and in any order of sample indices.
+    */
+    Stateless,
+
+    /**
+    \brief The callback carries state from one sample to the next, e.g. BrownNoiseGenerator.
+    It is called on the calling thread only, in ascending order of sample indices.
+    */
+    Stateful,
+};
+
+/**
+\brief Interface of the block iteration callback function to iterate over wave buffer sample frames.
+\param[in,out] samples Specifies the interleaved samples of the current block (i.e. 'frames * channels' samples) in the range [-1, 1].
+Each sample will be clamped to the range [-1, 1] when it is written back to the wave buffer.
+\param[in] frames Specifies the number of sample frames within the current block.
+\param[in] channels Specifies the number of channels per sample frame.
+\param[in] indexBegin Specifies the sample index of the first sample frame within the current block.
+\param[in] sampleRate Specifies the sample rate (in Hz) of the wave buffer. The time point of a sample frame is '(indexBegin + frame) / sampleRate'.
+\remarks This function interface is used for the 'ForEachBlock' function.
+\see WaveBuffer::ForEachBlock
+*/
+using SampleBlockIterationFunction = std::function<void(double* samples, std::size_t frames, std::uint16_t channels, std::size_t indexBegin, std::uint32_t sampleRate)>;
+
+/**
+\brief Interface of the constant block iteration callback function to iterate over wave buffer sample frames.
+\param[in] samples Specifies the interleaved samples of the current block (i.e. 'frames * channels' samples) in the range [-1, 1].
+\param[in] frames Specifies the number of sample frames within the current block.
+\param[in] channels Specifies the number of channels per sample frame.
+\param[in] indexBegin Specifies the sample index of the first sample frame within the current block.
+\param[in] sampleRate Specifies the sample rate (in Hz) of the wave buffer.
+\remarks This function interface is used for the 'ForEachBlock' function.
+\see WaveBuffer::ForEachBlock
+*/
+using SampleBlockConstIterationFunction = std::function<void(const double* samples, std::size_t frames, std::uint16_t channels, std::size_t indexBegin, std::uint32_t sampleRate)>;
+
 
 /**
 \brief Data model for an audio wave buffer.
 \remarks This class manages the PCM (Pulse Code Modulation) buffer by abstracting the underlying audio samples
-(8 or 16 bit, signed or unsigned) to double precision floating-points in the normalized range [-1, 1].
+(8, 16, 24, or 32 bit integers, or 32 bit IEEE floating-points) to double precision floating-points in the normalized range [-1, 1].
+Optionally, the samples can be stored as planar 32-bit floating-points (see WaveBufferStorage).
+The samples are reference counted and copy-on-write, i.e. copying a wave buffer is cheap and the samples are only duplicated
+when one of the copies is modified. Raw pointers returned by the non-constant 'Data' and 'ChannelData' functions must therefore not be used to
+write samples after the wave buffer has been copied. Call these functions again after copying instead.
+The sample memory is allocated with the default sample allocator at the time the wave buffer is constructed, or with the allocator which is passed to the constructor.
 Here is a usage example:
 \code
 // Create wave buffer with 44.1 kHz sample rate, 16-bit samples, and two channels.
@@ -72,6 +152,15 @@ buffer.ForEachSample(
     2.5, 5.0
 );
 
+// Amplify the entire wave buffer block-wise (the callback can be inlined here).
+buffer.ForEachBlock(
+    [](double* samples, std::size_t frames, std::uint16_t channels, std::size_t indexBegin, std::uint32_t sampleRate)
+    {
+        for (std::size_t i = 0, n = frames*channels; i < n; ++i)
+            samples[i] *= 0.5;
+    }
+);
+
 // Now create sound with our buffer
 auto sound = audioSystem->CreateSound(buffer);
 sound->Play();
@@ -84,11 +173,23 @@ class AC_EXPORT WaveBuffer
 
         /* ----- Common ----- */
 
+        //! Maximal number of samples (i.e. sample frames times channels) that are passed to a block iteration callback at once.
+        static const std::size_t maxBlockSamples = 1024;
+
         WaveBuffer() = default;
         WaveBuffer(const WaveBuffer&) = default;
         WaveBuffer& operator = (const WaveBuffer&) = default;
 
         WaveBuffer(const WaveBufferFormat& format);
+        WaveBuffer(const WaveBufferFormat& format, const WaveBufferStorage storage);
+
+        /**
+        \brief Initializes the wave buffer with the specified sample allocator.
+        \param[in] allocator Specifies the allocator for the sample memory. This must outlive this wave buffer and all of its copies.
+        \see SetAllocator
+        */
+        WaveBuffer(const WaveBufferFormat& format, const WaveBufferStorage storage, SampleAllocator& allocator);
+
         WaveBuffer(WaveBuffer&& other);
         WaveBuffer& operator = (WaveBuffer&& other);
 
@@ -140,9 +241,17 @@ class AC_EXPORT WaveBuffer
         \brief Sets the new wave buffer format.
         \param[in] format Specifies the new wave buffer format. If this is equal to the previous buffer, this function has no effect.
         \remarks This function may take some computational overhead, since the entire PCM buffer needs to be resampled.
+        Different sample rates are converted with the windowed-sinc resampler, and different channel counts are remixed with the standard matrix of the ChannelMixer.
+        \see SetFormat(const WaveBufferFormat&, const ResamplerQuality)
         */
         void SetFormat(const WaveBufferFormat& format);
 
+        /**
+        \brief Sets the new wave buffer format and converts different sample rates with the specified resampler quality.
+        \see Resampler
+        */
+        void SetFormat(const WaveBufferFormat& format, const ResamplerQuality quality);
+
         /**
         \brief Sets the new number of channels. By default 2.
         \remarks This is a shortcut for the following behavior:
@@ -152,9 +261,20 @@ class AC_EXPORT WaveBuffer
         this->SetFormat(format);
         \endcode
         \see SetFormat
+        \see ChannelMixer::StandardMatrix
         */
         void SetChannels(std::uint16_t channels);
 
+        /**
+        \brief Remixes all channels with the specified channel mixer.
+        \param[in] mixer Specifies the channel mixer. Its number of input channels must be equal to the number of channels of this wave buffer.
+        The new number of channels is the number of output channels of the mixer.
+        \remarks Use this to apply a user-supplied gain matrix. SetChannels and SetFormat always use the standard matrix.
+        \throws std::invalid_argument If the number of input channels of the mixer does not match the wave buffer format.
+        \see ChannelMixer
+        */
+        void RemixChannels(const ChannelMixer& mixer);
+
         /**
         \brief Swaps the endianness (byte order) of each sample between little-endian and big-endian.
         \remarks Per default, all data is read in little endian format on an x86 (IA-32) and x64 (AMD64) processor.
@@ -163,6 +283,27 @@ class AC_EXPORT WaveBuffer
         */
         void SwapEndianness();
 
+        /**
+        \brief Sets the new sample storage. By default WaveBufferStorage::Interleaved.
+        \param[in] storage Specifies the new sample storage. If this is equal to the previous storage, this function has no effect.
+        \remarks All samples are converted into the new storage, but the wave buffer format remains unchanged.
+        \see WaveBufferStorage
+        */
+        void SetStorage(const WaveBufferStorage storage);
+
+        //! Returns the sample storage of this wave buffer.
+        inline WaveBufferStorage GetStorage() const
+        {
+            return storage_;
+        }
+
+        /**
+        \brief Returns a copy of this wave buffer with interleaved PCM storage.
+        \remarks This is used to convert a buffer with planar storage at the boundaries, i.e. before it is passed to an audio device or a file writer.
+        \see WaveBufferStorage::Interleaved
+        */
+        WaveBuffer Interleaved() const;
+
         /* ----- Sample iteration ----- */
 
         /**
@@ -217,6 +358,127 @@ class AC_EXPORT WaveBuffer
         */
         void ForEachSample(const SampleConstIterationFunction& iterator) const;
 
+        /**
+        \brief Iterates over all samples of this wave buffer within the specified range on multiple threads.
+        \param[in] iterator Specifies the sample iteration callback function. This function will be used to modify each sample.
+        \param[in] indexBegin Specifies the first sample index.
+        \param[in] indexEnd Specifies the last sample index. The ending is inclusive, i.e. the iteration range is [indexBegin, indexEnd].
+        \param[in] state Specifies whether the iterator is stateless or stateful.
+        Only stateless iterators are distributed across threads; stateful iterators are processed like with "ForEachSample".
+        \param[in] threadPool Optional pointer to the thread pool which partitions the range. If this is null, the default thread pool is used. By default null.
+        \remarks The results of stateless iterators are identical to "ForEachSample". If the samples are shared with another wave buffer, they are duplicated first (copy-on-write).
+        \see SampleIteratorState
+        \see GetDefaultThreadPool
+        */
+        void ParallelForEachSample(
+            const SampleIterationFunction&  iterator,
+            std::size_t                     indexBegin,
+            std::size_t                     indexEnd,
+            const SampleIteratorState       state,
+            ThreadPool*                     threadPool  = nullptr
+        );
+
+        /**
+        \brief Iterates over all samples of this wave buffer within the specified time range on multiple threads.
+        \see ParallelForEachSample(const SampleIterationFunction&, std::size_t, std::size_t, const SampleIteratorState, ThreadPool*)
+        */
+        void ParallelForEachSample(
+            const SampleIterationFunction&  iterator,
+            double                          timeBegin,
+            double                          timeEnd,
+            const SampleIteratorState       state,
+            ThreadPool*                     threadPool  = nullptr
+        );
+
+        /**
+        \brief Iterates over all samples of this wave buffer on multiple threads.
+        \see ParallelForEachSample(const SampleIterationFunction&, std::size_t, std::size_t, const SampleIteratorState, ThreadPool*)
+        */
+        void ParallelForEachSample(const SampleIterationFunction& iterator, const SampleIteratorState state, ThreadPool* threadPool = nullptr);
+
+        /* ----- Block iteration ----- */
+
+        /**
+        \brief Iterates over all sample frames of this wave buffer within the specified range, block by block.
+        \param[in] iterator Specifies the block iteration callback function. This function will be used to modify the samples of each block.
+        \param[in] indexBegin Specifies the first sample index.
+        \param[in] indexEnd Specifies the last sample index. The ending is inclusive, i.e. the iteration range is [indexBegin, indexEnd].
+        \remarks Each block contains at most 'maxBlockSamples' interleaved samples.
+        The samples are converted from and to the PCM buffer only once per block, which is much faster than the per-sample "ForEachSample" function.
+        \see SampleBlockIterationFunction
+        \see ForEachBlock(BlockIterator&&, std::size_t, std::size_t)
+        */
+        void ForEachBlock(const SampleBlockIterationFunction& iterator, std::size_t indexBegin, std::size_t indexEnd);
+
+        /**
+        \brief Iterates over all sample frames of this wave buffer, block by block.
+        \see ForEachBlock(const SampleBlockIterationFunction&, std::size_t, std::size_t)
+        */
+        void ForEachBlock(const SampleBlockIterationFunction& iterator);
+
+        /**
+        \brief Iterates over all sample frames of this wave buffer within the specified range, block by block, with a constant iterator.
+        \see ForEachBlock(const SampleBlockIterationFunction&, std::size_t, std::size_t)
+        */
+        void ForEachBlock(const SampleBlockConstIterationFunction& iterator, std::size_t indexBegin, std::size_t indexEnd) const;
+
+        /**
+        \brief Iterates over all sample frames of this wave buffer, block by block, with a constant iterator.
+        \see ForEachBlock(const SampleBlockIterationFunction&, std::size_t, std::size_t)
+        */
+        void ForEachBlock(const SampleBlockConstIterationFunction& iterator) const;
+
+        /**
+        \brief Iterates over all sample frames of this wave buffer within the specified range, block by block.
+        \tparam T Specifies the sample type of the blocks. This must be either float or double. By default double.
+        \tparam BlockIterator Specifies the type of the callable object. Its signature must be compatible to the "SampleBlockIterationFunction" interface
+        (with 'T*' instead of 'double*'). In contrast to the std::function overload, this callable can be inlined by the compiler.
+        \see ForEachBlock(const SampleBlockIterationFunction&, std::size_t, std::size_t)
+        */
+        template <typename T = double, typename BlockIterator>
+        void ForEachBlock(BlockIterator&& iterator, std::size_t indexBegin, std::size_t indexEnd);
+
+        //! \see ForEachBlock(BlockIterator&&, std::size_t, std::size_t)
+        template <typename T = double, typename BlockIterator>
+        void ForEachBlock(BlockIterator&& iterator);
+
+        /**
+        \brief Iterates over all sample frames of this wave buffer within the specified range, block by block, with a constant iterator.
+        \see ForEachBlock(BlockIterator&&, std::size_t, std::size_t)
+        */
+        template <typename T = double, typename BlockIterator>
+        void ForEachBlock(BlockIterator&& iterator, std::size_t indexBegin, std::size_t indexEnd) const;
+
+        //! \see ForEachBlock(BlockIterator&&, std::size_t, std::size_t) const
+        template <typename T = double, typename BlockIterator>
+        void ForEachBlock(BlockIterator&& iterator) const;
+
+        /* ----- Frame access ----- */
+
+        /**
+        \brief Reads the specified range of sample frames as normalized samples.
+        \param[in] indexBegin Specifies the first sample index.
+        \param[in] frames Specifies the number of sample frames to read.
+        \param[out] samples Specifies the output array of interleaved samples. This must have at least 'frames * GetFormat().channels' elements.
+        \return Number of sample frames that have actually been read. This is less than 'frames' if the range exceeds the wave buffer.
+        */
+        std::size_t ReadFrames(std::size_t indexBegin, std::size_t frames, double* samples) const;
+
+        //! \see ReadFrames(std::size_t, std::size_t, double*) const
+        std::size_t ReadFrames(std::size_t indexBegin, std::size_t frames, float* samples) const;
+
+        /**
+        \brief Writes the specified range of sample frames from normalized samples. Each sample will be clamped to the range [-1, 1].
+        \param[in] indexBegin Specifies the first sample index.
+        \param[in] frames Specifies the number of sample frames to write.
+        \param[in] samples Specifies the input array of interleaved samples. This must have at least 'frames * GetFormat().channels' elements.
+        \return Number of sample frames that have actually been written. This is less than 'frames' if the range exceeds the wave buffer.
+        */
+        std::size_t WriteFrames(std::size_t indexBegin, std::size_t frames, const double* samples);
+
+        //! \see WriteFrames(std::size_t, std::size_t, const double*)
+        std::size_t WriteFrames(std::size_t indexBegin, std::size_t frames, const float* samples);
+
         /* ----- Appending ----- */
 
         /**
@@ -268,26 +530,35 @@ class AC_EXPORT WaveBuffer
 
         /* ----- Raw buffer access ----- */
 
-        //! Returns the actual PCM buffer size (in bytes).
+        /**
+        \brief Returns the actual PCM buffer size (in bytes).
+        \remarks For the planar storage, this is the size of all channel arrays (in bytes).
+        */
         inline std::size_t BufferSize() const
         {
-            return buffer_.size();
+            return (chunksSize_ + TailSize());
         }
 
-        //! Returns a raw pointer to the PCM buffer data.
-        inline char* Data()
-        {
-            return buffer_.data();
-        }
+        /**
+        \brief Returns a raw pointer to the PCM buffer data.
+        \remarks If the samples are shared with another wave buffer, they are duplicated first (copy-on-write).
+        */
+        char* Data();
 
-        //! Returns a constant raw pointer to the PCM buffer data.
+        /**
+        \brief Returns a constant raw pointer to the PCM buffer data.
+        \remarks If the samples are split into multiple chunks, they are flattened first (see SetChunkSize).
+        */
         inline const char* Data() const
         {
-            return buffer_.data();
+            if (!chunks_.empty())
+                FlattenChunks();
+            return (buffer_ ? buffer_->data() : externalData_.get());
         }
 
         /**
         \brief Returns the byte offset for the specified sample index and channel.
+        \remarks This takes the sample storage into account.
         \see Data(std::size_t)
         */
         std::size_t GetDataOffset(std::size_t index, std::uint16_t channel) const;
@@ -304,21 +575,271 @@ class AC_EXPORT WaveBuffer
         */
         const char* Data(std::size_t offset) const;
 
+        /**
+        \brief Returns a raw pointer to the samples of the specified channel, or null if this wave buffer does not have the planar storage.
+        \see WaveBufferStorage::PlanarFloat
+        */
+        float* ChannelData(std::uint16_t channel);
+
+        //! Returns a constant raw pointer to the samples of the specified channel, or null if this wave buffer does not have the planar storage.
+        const float* ChannelData(std::uint16_t channel) const;
+
         //! Returns the format description of this wave buffer.
         inline const WaveBufferFormat& GetFormat() const
         {
             return format_;
         }
 
+        //! Returns true if the samples of this wave buffer are shared with another wave buffer or are external data, i.e. they will be duplicated on the next write access.
+        inline bool IsShared() const
+        {
+            return (buffer_.use_count() > 1 || externalData_ != nullptr);
+        }
+
+        /**
+        \brief Replaces the samples of this wave buffer by read-only external PCM data with the interleaved storage.
+        \param[in] format Specifies the format of the PCM data.
+        \param[in] data Specifies the shared pointer to the first byte of PCM data. The owner of the shared pointer keeps the memory alive,
+        e.g. a memory-mapped file (use an aliasing shared pointer to refer into a larger memory block).
+        \param[in] bufferSize Specifies the size (in bytes) of the PCM data. This is rounded down to a multiple of the frame size.
+        \remarks The external data is never modified. It is shared by all copies of this wave buffer, and it is duplicated into memory
+        of the sample allocator on the first write access (copy-on-write), i.e. any non-constant access to the samples such as
+        'Data()', 'WriteSample', or 'SetSampleFrames'.
+        \see AudioSystem::MapWaveBuffer
+        \see HasExternalData
+        */
+        void AttachExternalData(const WaveBufferFormat& format, const std::shared_ptr<const char>& data, std::size_t bufferSize);
+
+        //! Returns true if the samples of this wave buffer are read-only external data, e.g. a memory-mapped file.
+        inline bool HasExternalData() const
+        {
+            return (externalData_ != nullptr);
+        }
+
+        /**
+        \brief Sets the allocator for the sample memory of this wave buffer.
+        \param[in] allocator Specifies the new allocator. This must outlive this wave buffer and all of its copies.
+        \remarks If the current samples were allocated with another allocator, they are moved into memory of the new allocator.
+        Temporary buffers of the format and storage conversions are allocated with this allocator, too.
+        \see SetDefaultSampleAllocator
+        */
+        void SetAllocator(SampleAllocator& allocator);
+
+        //! Returns the allocator for the sample memory of this wave buffer.
+        inline SampleAllocator& GetAllocator() const
+        {
+            return *allocator_;
+        }
+
+        /* ----- Chunked storage ----- */
+
+        /**
+        \brief Enables the chunked storage for appending interleaved samples, or disables it if the chunk size is zero (default).
+        \param[in] chunkSize Specifies the size (in bytes) of each chunk. This is rounded up to a multiple of the frame size.
+        \remarks With the chunked storage, the interleaved samples are kept in a list of chunks, so that "Append" only copies the appended samples
+        instead of reallocating and copying the entire buffer whenever it grows. Appended buffers which are at least as large as a chunk are shared without copying.
+        The chunks are flattened into a contiguous buffer lazily, on the first access which requires contiguous samples (e.g. "Data", "WriteFrames", or a WaveBufferConstView).
+        "ReadFrames", the constant "ForEachBlock" and "ForEachSample" functions, "AudioSystem::WriteAudioBuffer", and "Sound::QueueBufferChunks" consume the chunks directly.
+        This has no effect for the planar storage. Here is a usage example for a long recording:
+        \code
+        Ac::WaveBuffer inputBuffer, outputBuffer;
+        outputBuffer.SetChunkSize(1u << 20);
+        while (mic->ProcessInput(inputBuffer))
+            outputBuffer.Append(inputBuffer);
+        audioSystem->WriteAudioBuffer(Ac::AudioFormats::WAVE, stream, outputBuffer);
+        \endcode
+        \note Flattening modifies the internal state even on constant access, so a wave buffer with multiple chunks must not be accessed from multiple threads concurrently
+        before it has been flattened (see Flatten).
+        \see GetChunk
+        */
+        void SetChunkSize(std::size_t chunkSize);
+
+        //! Returns the size (in bytes) of each chunk for the chunked storage, or zero if the chunked storage is disabled.
+        inline std::size_t GetChunkSize() const
+        {
+            return chunkSize_;
+        }
+
+        /**
+        \brief Returns the number of chunks the samples are currently split into.
+        \remarks This is zero for an empty wave buffer, and one after the samples have been flattened or if the chunked storage is not used.
+        \see GetChunk
+        */
+        std::size_t GetNumChunks() const;
+
+        /**
+        \brief Returns a view onto the specified chunk, or an empty view if the index is out of range.
+        \remarks The chunks are in order and the view is invalidated when this wave buffer is modified. Here is a usage example:
+        \code
+        for (std::size_t i = 0; i < waveBuffer.GetNumChunks(); ++i)
+        {
+            auto chunk = waveBuffer.GetChunk(i);
+            stream.write(chunk.Data(), chunk.BufferSize());
+        }
+        \endcode
+        \see GetNumChunks
+        */
+        WaveBufferConstView GetChunk(std::size_t index) const;
+
+        //! Merges all chunks into a contiguous buffer. This is done automatically on the first access which requires contiguous samples.
+        void Flatten();
+
     private:
 
-        WaveBufferFormat    format_;
+        // Interleaved PCM data of a sealed chunk, which is never modified.
+        struct PCMChunk
+        {
+            std::shared_ptr<const char> data;
+            std::size_t                 offset; // Byte offset of the chunk within the entire buffer
+            std::size_t                 size;
+        };
+
+        bool ClampIndexRange(std::size_t& indexBegin, std::size_t& indexEnd) const;
 
-        PCMBuffer           buffer_;
+        std::size_t StorageBytesPerFrame() const;
+
+        void AppendPrimary(const WaveBuffer& other);
+
+        // Returns the PCM buffer for write access and duplicates it first if it's shared with another wave buffer or if it's external data.
+        PCMBuffer& GetMutableBuffer();
+
+        // Replaces all samples (i.e. the chunks and the PCM buffer or the external data) by the specified buffer.
+        void SetBuffer(PCMBuffer&& buffer);
+
+        // Replaces the tail, i.e. the PCM buffer (or the external data) after the sealed chunks, by the specified buffer.
+        void SetTailBuffer(PCMBuffer&& buffer) const;
+
+        // Returns the size (in bytes) of the tail.
+        inline std::size_t TailSize() const
+        {
+            return (buffer_ ? buffer_->size() : externalSize_);
+        }
+
+        // Appends the other buffer to the chunks (both buffers must have the same format and the interleaved storage).
+        void AppendChunks(const WaveBuffer& other);
+
+        // Appends the specified PCM data to the tail, and seals the tail first if it has not enough capacity left.
+        void AppendToTail(const char* data, std::size_t size);
+
+        // Moves the tail into the list of sealed chunks.
+        void SealTail();
+
+        // Returns all chunks including the tail.
+        std::vector<PCMChunk> GetAllChunks() const;
+
+        // Merges all chunks into the PCM buffer.
+        void FlattenChunks() const;
+
+        template <typename T>
+        std::size_t ReadChunkedFrames(std::size_t indexBegin, std::size_t frames, T* samples) const;
+
+    private:
+
+        WaveBufferFormat                format_;
+        WaveBufferStorage               storage_        = WaveBufferStorage::Interleaved;
+
+        // The sample members are mutable, since the chunks are flattened lazily on constant access
+        mutable std::shared_ptr<PCMBuffer>      buffer_;        // Shared between copies until one of them writes (copy-on-write)
+        SampleAllocator*                        allocator_      = &GetDefaultSampleAllocator();
+
+        mutable std::shared_ptr<const char>     externalData_;  // Read-only external PCM data (only used while 'buffer_' is null)
+        mutable std::size_t                     externalSize_   = 0;
+
+        mutable std::vector<PCMChunk>           chunks_;        // Sealed chunks before the PCM buffer (only for the chunked storage)
+        mutable std::size_t                     chunksSize_     = 0;
+        std::size_t                             chunkSize_      = 0;
 
 };
 
 
+/* ----- Template implementation ----- */
+
+template <typename T, typename BlockIterator>
+void WaveBuffer::ForEachBlock(BlockIterator&& iterator, std::size_t indexBegin, std::size_t indexEnd)
+{
+    /* Validate parameters and clamp range to [0, sampleFrames) */
+    if (!ClampIndexRange(indexBegin, indexEnd))
+        return;
+
+    const auto channels = format_.channels;
+
+    /* Use stack storage for the block, unless a single frame does not fit into it */
+    T                   localBlock[maxBlockSamples];
+    std::vector<T>      dynamicBlock;
+    T*                  block           = localBlock;
+    std::size_t         framesPerBlock  = maxBlockSamples / channels;
+
+    if (framesPerBlock == 0)
+    {
+        dynamicBlock.resize(channels);
+        block           = dynamicBlock.data();
+        framesPerBlock  = 1;
+    }
+
+    for (auto i = indexBegin; i <= indexEnd;)
+    {
+        /* Read block, modify samples with iterator callback, and write block back to buffer */
+        auto frames = std::min(framesPerBlock, indexEnd - i + 1u);
+
+        ReadFrames(i, frames, block);
+        iterator(block, frames, channels, i, format_.sampleRate);
+        WriteFrames(i, frames, block);
+
+        i += frames;
+    }
+}
+
+template <typename T, typename BlockIterator>
+void WaveBuffer::ForEachBlock(BlockIterator&& iterator)
+{
+    auto sampleFrames = GetSampleFrames();
+    if (sampleFrames > 0)
+        ForEachBlock<T>(std::forward<BlockIterator>(iterator), 0, sampleFrames - 1);
+}
+
+template <typename T, typename BlockIterator>
+void WaveBuffer::ForEachBlock(BlockIterator&& iterator, std::size_t indexBegin, std::size_t indexEnd) const
+{
+    /* Validate parameters and clamp range to [0, sampleFrames) */
+    if (!ClampIndexRange(indexBegin, indexEnd))
+        return;
+
+    const auto channels = format_.channels;
+
+    /* Use stack storage for the block, unless a single frame does not fit into it */
+    T                   localBlock[maxBlockSamples];
+    std::vector<T>      dynamicBlock;
+    T*                  block           = localBlock;
+    std::size_t         framesPerBlock  = maxBlockSamples / channels;
+
+    if (framesPerBlock == 0)
+    {
+        dynamicBlock.resize(channels);
+        block           = dynamicBlock.data();
+        framesPerBlock  = 1;
+    }
+
+    for (auto i = indexBegin; i <= indexEnd;)
+    {
+        /* Read block and pass it to constant iterator */
+        auto frames = std::min(framesPerBlock, indexEnd - i + 1u);
+
+        ReadFrames(i, frames, block);
+        iterator(static_cast<const T*>(block), frames, channels, i, format_.sampleRate);
+
+        i += frames;
+    }
+}
+
+template <typename T, typename BlockIterator>
+void WaveBuffer::ForEachBlock(BlockIterator&& iterator) const
+{
+    auto sampleFrames = GetSampleFrames();
+    if (sampleFrames > 0)
+        ForEachBlock<T>(std::forward<BlockIterator>(iterator), 0, sampleFrames - 1);
+}
+
+
 } // /namespace Ac
 
 
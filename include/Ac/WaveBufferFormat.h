@@ -51,7 +51,7 @@ struct AC_EXPORT WaveBufferFormat
     WaveBufferFormat(const WaveBufferFormat&) = default;
     WaveBufferFormat& operator = (const WaveBufferFormat&) = default;
 
-    WaveBufferFormat(std::uint32_t sampleRate, std::uint16_t bitsPerSample, std::uint16_t channels);
+    WaveBufferFormat(std::uint32_t sampleRate, std::uint16_t bitsPerSample, std::uint16_t channels, bool floatingPoint = false);
 
     //! Returns the size (in bytes) for each sample frame (or rather sample block alignment) which is computed as follows: (channels * bitsPerSample) / 8.
     std::size_t BytesPerFrame() const;
@@ -62,9 +62,12 @@ struct AC_EXPORT WaveBufferFormat
     //! Returns the total time (in seconds) a PCM buffer with the specified size (in bytes) requires to play with this wave buffer format.
     double TotalTime(std::size_t bufferSize) const;
 
-    //! Returns true if this is a signed format. This is true if (bitsPerSample > 8) holds true.
+    //! Returns true if this is a signed format. This is true if (bitsPerSample > 8) or 'floatingPoint' holds true.
     bool IsSigned() const;
 
+    //! Returns true if this format is supported by the wave buffer, i.e. 8-, 16-, 24-, or 32-bit integers, or 32-bit floating-points.
+    bool IsSupported() const;
+
     /**
     \brief Number of samples per second (in Hz). Default value is 44100.
     \remarks The commonly used sample rates are: 8 kHz, 11.025 kHz, 22.05 kHz, and 44.1 kHz.
@@ -76,6 +79,12 @@ struct AC_EXPORT WaveBufferFormat
 
     //! Number of channels. 1 for mono and 2 for stereo. Default value is 1.
     std::uint16_t channels      = 1;
+
+    /**
+    \brief Specifies whether the samples are IEEE 754 floating-points instead of integers. By default false.
+    \remarks Floating-point samples are only supported with 32 bits per sample.
+    */
+    bool          floatingPoint = false;
 };
 
 
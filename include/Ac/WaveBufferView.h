@@ -0,0 +1,207 @@
+/*
+ * WaveBufferView.h
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef AC_WAVE_BUFFER_VIEW_H
+#define AC_WAVE_BUFFER_VIEW_H
+
+
+#include "Export.h"
+#include "WaveBuffer.h"
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace Ac
+{
+
+
+/**
+\brief Non-owning constant view onto a range of sample frames.
+\remarks A view consists of a wave buffer format, a sample storage, a pointer to the first sample frame and a number of sample frames.
+It does not own or copy the samples, so the referenced memory must outlive the view.
+Since the wave buffer samples are copy-on-write, a view into a wave buffer is invalidated when that buffer is modified, resized, or copied and then written.
+Here is a usage example to write only a region of a large wave buffer:
+\code
+// Write the samples from 1.0 to 3.0 seconds to a file, without copying them into another wave buffer
+auto indexBegin = waveBuffer.GetIndexFromTimePoint(1.0);
+auto indexEnd   = waveBuffer.GetIndexFromTimePoint(3.0);
+audioSystem->WriteAudioBuffer(Ac::AudioFormats::WAVE, stream, Ac::WaveBufferConstView(waveBuffer, indexBegin, indexEnd - indexBegin));
+\endcode
+\see WaveBufferView
+*/
+class AC_EXPORT WaveBufferConstView
+{
+
+    public:
+
+        WaveBufferConstView() = default;
+
+        //! Initializes the view with all sample frames of the specified wave buffer.
+        WaveBufferConstView(const WaveBuffer& buffer);
+
+        /**
+        \brief Initializes the view with a range of sample frames of the specified wave buffer.
+        \param[in] buffer Specifies the wave buffer which is to be referenced.
+        \param[in] indexBegin Specifies the first sample frame. This will be clamped to the number of sample frames of the buffer.
+        \param[in] frames Specifies the number of sample frames. This will be clamped to the end of the buffer.
+        */
+        WaveBufferConstView(const WaveBuffer& buffer, std::size_t indexBegin, std::size_t frames);
+
+        /**
+        \brief Initializes the view with external interleaved PCM data.
+        \param[in] format Specifies the format of the PCM data.
+        \param[in] data Pointer to the PCM data. This must contain at least 'frames * format.BytesPerFrame()' bytes.
+        \param[in] frames Specifies the number of sample frames.
+        */
+        WaveBufferConstView(const WaveBufferFormat& format, const void* data, std::size_t frames);
+
+        //! Returns the number of samples per channel.
+        inline std::size_t GetSampleFrames() const
+        {
+            return frames_;
+        }
+
+        //! Returns the total time (in seconds) which is required to play the referenced sample frames.
+        double GetTotalTime() const;
+
+        /**
+        \brief Determines the sample index (relative to the view) for the specified time point (in seconds).
+        \see WaveBuffer::GetIndexFromTimePoint
+        */
+        std::size_t GetIndexFromTimePoint(double timePoint) const;
+
+        //! Returns the sample at the specified index (relative to the view) of the specified channel, or zero if the index is out of range.
+        double ReadSample(std::size_t index, std::uint16_t channel) const;
+
+        /**
+        \brief Reads the specified range of sample frames (relative to the view) into interleaved floating-points in the range [-1, 1].
+        \return Number of sample frames which have been read. This is less than 'frames' if the range exceeds the view.
+        \see WaveBuffer::ReadFrames
+        */
+        std::size_t ReadFrames(std::size_t indexBegin, std::size_t frames, double* samples) const;
+
+        //! \see ReadFrames(std::size_t, std::size_t, double*) const
+        std::size_t ReadFrames(std::size_t indexBegin, std::size_t frames, float* samples) const;
+
+        //! Returns a view onto a sub range of this view. The range is clamped to this view.
+        WaveBufferConstView Subview(std::size_t indexBegin, std::size_t frames) const;
+
+        //! Returns a new wave buffer with a copy of the referenced sample frames and the same storage.
+        WaveBuffer ToWaveBuffer() const;
+
+        /**
+        \brief Returns the size (in bytes) of the referenced samples.
+        \remarks For the interleaved storage, this is the size of the contiguous PCM data returned by "Data".
+        For the planar storage, the channel arrays are not contiguous (see ChannelData).
+        */
+        std::size_t BufferSize() const;
+
+        //! Returns a constant raw pointer to the first referenced sample frame.
+        inline const char* Data() const
+        {
+            return data_;
+        }
+
+        //! Returns a constant raw pointer to the samples of the specified channel, or null if this view does not have the planar storage.
+        const float* ChannelData(std::uint16_t channel) const;
+
+        //! Returns the format description of the referenced samples.
+        inline const WaveBufferFormat& GetFormat() const
+        {
+            return format_;
+        }
+
+        //! Returns the sample storage of the referenced samples.
+        inline WaveBufferStorage GetStorage() const
+        {
+            return storage_;
+        }
+
+    protected:
+
+        // Returns the byte offset of the specified sample frame and channel relative to the data pointer.
+        std::size_t GetDataOffset(std::size_t index, std::uint16_t channel) const;
+
+        // Clamps the number of frames to the end of the view and returns false if the index is out of range.
+        bool ClampFrameRange(std::size_t indexBegin, std::size_t& frames) const;
+
+        // Moves the data pointer to the specified sub range.
+        void Narrow(std::size_t indexBegin, std::size_t frames);
+
+    protected:
+
+        WaveBufferFormat    format_;
+        WaveBufferStorage   storage_        = WaveBufferStorage::Interleaved;
+        const char*         data_           = nullptr;
+        std::size_t         frames_         = 0;
+        std::size_t         planeStride_    = 0;    // Number of samples between the channel arrays (only for the planar storage)
+
+};
+
+/**
+\brief Non-owning mutable view onto a range of sample frames.
+\remarks Like a pointer, a constant view object still refers to mutable samples.
+A mutable view converts implicitly into a constant view.
+\see WaveBufferConstView
+\see AudioStream::StreamWaveBuffer(const WaveBufferView&)
+*/
+class AC_EXPORT WaveBufferView : public WaveBufferConstView
+{
+
+    public:
+
+        WaveBufferView() = default;
+
+        /**
+        \brief Initializes the view with all sample frames of the specified wave buffer.
+        \remarks If the samples are shared with another wave buffer, they are duplicated first (copy-on-write).
+        */
+        WaveBufferView(WaveBuffer& buffer);
+
+        //! \see WaveBufferConstView(const WaveBuffer&, std::size_t, std::size_t)
+        WaveBufferView(WaveBuffer& buffer, std::size_t indexBegin, std::size_t frames);
+
+        //! \see WaveBufferConstView(const WaveBufferFormat&, const void*, std::size_t)
+        WaveBufferView(const WaveBufferFormat& format, void* data, std::size_t frames);
+
+        //! Writes the sample at the specified index (relative to the view) of the specified channel. The sample is clamped to [-1, 1].
+        void WriteSample(std::size_t index, std::uint16_t channel, double sample) const;
+
+        /**
+        \brief Writes the specified range of sample frames (relative to the view) from interleaved floating-points in the range [-1, 1].
+        \return Number of sample frames which have been written. This is less than 'frames' if the range exceeds the view.
+        \see WaveBuffer::WriteFrames
+        */
+        std::size_t WriteFrames(std::size_t indexBegin, std::size_t frames, const double* samples) const;
+
+        //! \see WriteFrames(std::size_t, std::size_t, const double*) const
+        std::size_t WriteFrames(std::size_t indexBegin, std::size_t frames, const float* samples) const;
+
+        //! Returns a view onto a sub range of this view. The range is clamped to this view.
+        WaveBufferView Subview(std::size_t indexBegin, std::size_t frames) const;
+
+        //! Returns a raw pointer to the first referenced sample frame.
+        inline char* Data() const
+        {
+            return const_cast<char*>(data_);
+        }
+
+        //! Returns a raw pointer to the samples of the specified channel, or null if this view does not have the planar storage.
+        float* ChannelData(std::uint16_t channel) const;
+
+};
+
+
+} // /namespace Ac
+
+
+#endif
+
+
+
+// ================================================================================
@@ -0,0 +1,684 @@
+/*
+ * WaveFormExpression.h
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef AC_WAVE_FORM_EXPRESSION_H
+#define AC_WAVE_FORM_EXPRESSION_H
+
+
+#include "Export.h"
+#include "WaveBuffer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+
+namespace Ac
+{
+
+namespace Synthesizer
+{
+
+
+//! Helper structure to easily specify standard wave form parameters.
+struct AC_EXPORT WaveForm
+{
+    WaveForm() = default;
+    WaveForm(const WaveForm&) = default;
+    WaveForm& operator = (const WaveForm&) = default;
+
+    inline WaveForm(double frequency, double amplitude = 1.0, double phase = 0.0) :
+        frequency { frequency },
+        amplitude { amplitude },
+        phase     { phase     }
+    {
+    }
+
+    double frequency    = 0.0;
+    double amplitude    = 1.0;
+    double phase        = 0.0;
+};
+
+
+/* ----- Wave form expressions ----- */
+
+/**
+\brief Base class of all wave form expressions (using the CRTP idiom).
+\remarks Wave form expressions are combined at compile time, i.e. the expression "SineGenerator(a) + SawGenerator(b) - SquareGenerator(c)"
+results in a concrete type which contains all terms by value. In contrast to the WaveFormGenerator class, there is no type erasure,
+so the compiler can inline the entire expression. A wave form expression can be used in three ways:
+- As block iterator with the "WaveBuffer::ForEachBlock" template. This is the fastest way, since each term is accumulated in a separate loop over the entire block.
+- As sample iterator (see SampleIterationFunction) with the "WaveBuffer::ForEachSample" function.
+- Converted to a WaveFormGenerator, e.g. to combine it with stateful generators like "WhiteNoiseGenerator".
+Like the generator functions, a wave form expression adds its value to the samples. Here is a usage example:
+\code
+using namespace Ac::Synthesizer;
+
+// Generate a square wave with its 3rd and 5th harmonics
+auto expr = SineGenerator({ 110.0, 0.4 }) + SineGenerator({ 330.0, 0.4/3.0 }) + SineGenerator({ 550.0, 0.4/5.0 });
+buffer.ForEachBlock(expr);
+\endcode
+\tparam Derived Specifies the derived expression type. This type must provide the following functions:
+\code
+// Returns the value of the wave form at the specified time point (in seconds).
+double Evaluate(double timePoint) const;
+
+// Adds the values of the wave form, multiplied by 'scale', for the time points '(indexBegin + i) * timeStep' to 'samples[i]' with i in [0, frames).
+void Accumulate(double* samples, std::size_t frames, std::size_t indexBegin, double timeStep, double scale) const;
+\endcode
+The default implementation of "Accumulate" evaluates the expression for each time point.
+*/
+template <typename Derived>
+class WaveFormExpression
+{
+
+    public:
+
+        //! Returns this expression as reference to the derived type.
+        inline const Derived& Self() const
+        {
+            return static_cast<const Derived&>(*this);
+        }
+
+        //! Sample iterator interface, which is compatible to the SampleIterationFunction interface.
+        inline void operator () (double& sample, std::uint16_t /*channel*/, std::size_t /*index*/, double timePoint) const
+        {
+            sample += Self().Evaluate(timePoint);
+        }
+
+        /**
+        \brief Block iterator interface, which is compatible to the SampleBlockIterationFunction interface.
+        \tparam T Specifies the sample type. This must be either float or double.
+        \remarks The expression is accumulated once for each sample frame, and then added to all channels.
+        The time points are computed in the same way as in the "WaveBuffer::ForEachSample" function.
+        */
+        template <typename T>
+        void operator () (T* samples, std::size_t frames, std::uint16_t channels, std::size_t indexBegin, std::uint32_t sampleRate) const
+        {
+            const auto timeStep = (1.0 / static_cast<double>(sampleRate));
+
+            double wave[WaveBuffer::maxBlockSamples];
+
+            for (std::size_t offset = 0; offset < frames;)
+            {
+                /* Accumulate all terms of the expression */
+                const auto n = (std::min)(frames - offset, WaveBuffer::maxBlockSamples);
+
+                std::fill(wave, wave + n, 0.0);
+                Self().Accumulate(wave, n, indexBegin + offset, timeStep, 1.0);
+
+                /* Add wave form to all channels */
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    for (std::uint16_t chn = 0; chn < channels; ++chn)
+                        *(samples++) += static_cast<T>(wave[i]);
+                }
+
+                offset += n;
+            }
+        }
+
+        //! Default implementation, which evaluates the expression for each time point.
+        inline void Accumulate(double* samples, std::size_t frames, std::size_t indexBegin, double timeStep, double scale) const
+        {
+            for (std::size_t i = 0; i < frames; ++i)
+                samples[i] += Self().Evaluate(static_cast<double>(indexBegin + i) * timeStep) * scale;
+        }
+
+    protected:
+
+        WaveFormExpression() = default;
+
+};
+
+//! Type trait to determine whether the specified type is a wave form expression.
+template <typename T>
+struct IsWaveFormExpression : std::is_base_of<WaveFormExpression<T>, T> {};
+
+//! Sum of two wave form expressions.
+template <typename Lhs, typename Rhs>
+class WaveFormSum : public WaveFormExpression<WaveFormSum<Lhs, Rhs>>
+{
+
+    public:
+
+        inline WaveFormSum(const Lhs& lhs, const Rhs& rhs) :
+            lhs_ { lhs },
+            rhs_ { rhs }
+        {
+        }
+
+        inline double Evaluate(double timePoint) const
+        {
+            return (lhs_.Evaluate(timePoint) + rhs_.Evaluate(timePoint));
+        }
+
+        inline void Accumulate(double* samples, std::size_t frames, std::size_t indexBegin, double timeStep, double scale) const
+        {
+            lhs_.Accumulate(samples, frames, indexBegin, timeStep, scale);
+            rhs_.Accumulate(samples, frames, indexBegin, timeStep, scale);
+        }
+
+    private:
+
+        Lhs lhs_;
+        Rhs rhs_;
+
+};
+
+//! Difference of two wave form expressions.
+template <typename Lhs, typename Rhs>
+class WaveFormDifference : public WaveFormExpression<WaveFormDifference<Lhs, Rhs>>
+{
+
+    public:
+
+        inline WaveFormDifference(const Lhs& lhs, const Rhs& rhs) :
+            lhs_ { lhs },
+            rhs_ { rhs }
+        {
+        }
+
+        inline double Evaluate(double timePoint) const
+        {
+            return (lhs_.Evaluate(timePoint) - rhs_.Evaluate(timePoint));
+        }
+
+        inline void Accumulate(double* samples, std::size_t frames, std::size_t indexBegin, double timeStep, double scale) const
+        {
+            lhs_.Accumulate(samples, frames, indexBegin, timeStep, scale);
+            rhs_.Accumulate(samples, frames, indexBegin, timeStep, -scale);
+        }
+
+    private:
+
+        Lhs lhs_;
+        Rhs rhs_;
+
+};
+
+//! Wave form expression multiplied by a constant factor.
+template <typename Expr>
+class WaveFormScaled : public WaveFormExpression<WaveFormScaled<Expr>>
+{
+
+    public:
+
+        inline WaveFormScaled(const Expr& expr, double factor) :
+            expr_   { expr   },
+            factor_ { factor }
+        {
+        }
+
+        inline double Evaluate(double timePoint) const
+        {
+            return (expr_.Evaluate(timePoint) * factor_);
+        }
+
+        inline void Accumulate(double* samples, std::size_t frames, std::size_t indexBegin, double timeStep, double scale) const
+        {
+            expr_.Accumulate(samples, frames, indexBegin, timeStep, scale * factor_);
+        }
+
+    private:
+
+        Expr    expr_;
+        double  factor_ = 1.0;
+
+};
+
+/**
+\brief Sum of a dynamic number of wave form expressions of the same type, e.g. for the partials of additive synthesis.
+\remarks Here is a usage example:
+\code
+// Generate a saw-tooth wave with 32 partials
+Ac::Synthesizer::WaveFormSeries<Ac::Synthesizer::SineWave> partials;
+for (int i = 1; i <= 32; ++i)
+    partials.Append(Ac::Synthesizer::SineGenerator({ 110.0*i, 0.5/i }));
+buffer.ForEachBlock(partials);
+\endcode
+*/
+template <typename Term>
+class WaveFormSeries : public WaveFormExpression<WaveFormSeries<Term>>
+{
+
+    public:
+
+        WaveFormSeries() = default;
+
+        inline WaveFormSeries(const std::vector<Term>& terms) :
+            terms_ { terms }
+        {
+        }
+
+        //! Appends the specified term to this series.
+        inline void Append(const Term& term)
+        {
+            terms_.push_back(term);
+        }
+
+        //! Returns the terms of this series.
+        inline const std::vector<Term>& GetTerms() const
+        {
+            return terms_;
+        }
+
+        inline double Evaluate(double timePoint) const
+        {
+            double value = 0.0;
+            for (const auto& term : terms_)
+                value += term.Evaluate(timePoint);
+            return value;
+        }
+
+        inline void Accumulate(double* samples, std::size_t frames, std::size_t indexBegin, double timeStep, double scale) const
+        {
+            for (const auto& term : terms_)
+                term.Accumulate(samples, frames, indexBegin, timeStep, scale);
+        }
+
+    private:
+
+        std::vector<Term> terms_;
+
+};
+
+//! Returns the sum of the two wave form expressions.
+template <typename Lhs, typename Rhs>
+WaveFormSum<Lhs, Rhs> operator + (const WaveFormExpression<Lhs>& lhs, const WaveFormExpression<Rhs>& rhs)
+{
+    return WaveFormSum<Lhs, Rhs>(lhs.Self(), rhs.Self());
+}
+
+//! Returns the difference of the two wave form expressions.
+template <typename Lhs, typename Rhs>
+WaveFormDifference<Lhs, Rhs> operator - (const WaveFormExpression<Lhs>& lhs, const WaveFormExpression<Rhs>& rhs)
+{
+    return WaveFormDifference<Lhs, Rhs>(lhs.Self(), rhs.Self());
+}
+
+//! Returns the wave form expression multiplied by the specified factor.
+template <typename Expr>
+WaveFormScaled<Expr> operator * (const WaveFormExpression<Expr>& expr, double factor)
+{
+    return WaveFormScaled<Expr>(expr.Self(), factor);
+}
+
+//! Returns the wave form expression multiplied by the specified factor.
+template <typename Expr>
+WaveFormScaled<Expr> operator * (double factor, const WaveFormExpression<Expr>& expr)
+{
+    return WaveFormScaled<Expr>(expr.Self(), factor);
+}
+
+//! Returns the negated wave form expression.
+template <typename Expr>
+WaveFormScaled<Expr> operator - (const WaveFormExpression<Expr>& expr)
+{
+    return WaveFormScaled<Expr>(expr.Self(), -1.0);
+}
+
+
+/* ----- Band-limiting ----- */
+
+/**
+\brief Returns the polynomial band-limited step (PolyBLEP) residual for a step of height 2 (e.g. from -1 to +1) at phase 0.
+\param[in] t Specifies the phase (in cycles) in the range [0, 1).
+\param[in] dt Specifies the phase increment per sample (i.e. frequency / sampleRate) in the range (0, 0.5].
+\remarks The residual is non-zero only within one sample before and after the step, so adding it to a naive wave form
+removes most of the aliasing of the discontinuity at the original sample rate.
+*/
+inline double PolyBLEP(double t, double dt)
+{
+    if (t < dt)
+    {
+        t /= dt;
+        return (t + t - t*t - 1.0);
+    }
+    if (t > 1.0 - dt)
+    {
+        t = (t - 1.0) / dt;
+        return (t*t + t + t + 1.0);
+    }
+    return 0.0;
+}
+
+/**
+\brief Returns the polynomial band-limited ramp (PolyBLAMP) residual for a slope change of one per sample at phase 0.
+\param[in] t Specifies the phase (in cycles) in the range [0, 1).
+\param[in] dt Specifies the phase increment per sample (i.e. frequency / sampleRate) in the range (0, 0.5].
+\remarks This is used for the corners of the triangle wave form, where the slope changes but the wave form is continuous.
+\see PolyBLEP
+*/
+inline double PolyBLAMP(double t, double dt)
+{
+    if (t < dt)
+    {
+        t = t / dt - 1.0;
+        return (-t*t*t / 3.0);
+    }
+    if (t > 1.0 - dt)
+    {
+        t = (t - 1.0) / dt + 1.0;
+        return (t*t*t / 3.0);
+    }
+    return 0.0;
+}
+
+
+/* ----- Wave form terms ----- */
+
+//! Sine wave term of the form: sin((timePoint + phase)*2*PI*frequency)*amplitude.
+class SineWave : public WaveFormExpression<SineWave>
+{
+
+    public:
+
+        inline SineWave(const WaveForm& wave) :
+            wave_ { wave }
+        {
+        }
+
+        inline double Evaluate(double timePoint) const
+        {
+            return std::sin((timePoint + wave_.phase)*2.0*3.14159265358979323846*wave_.frequency)*wave_.amplitude;
+        }
+
+        /**
+        \brief Accumulates the sine wave by rotating phasors instead of evaluating the sine function for each time point.
+        \remarks Four phasors (for four successive time points) are rotated independently, so the loop can be vectorized.
+        The phasors are initialized for each call, so the rounding errors do not accumulate across blocks.
+        */
+        inline void Accumulate(double* samples, std::size_t frames, std::size_t indexBegin, double timeStep, double scale) const
+        {
+            const auto omega        = 2.0*3.14159265358979323846*wave_.frequency;
+            const auto amplitude    = wave_.amplitude * scale;
+
+            /* Initialize phasors for the first four time points */
+            double sine[4], cosine[4];
+
+            for (std::size_t j = 0; j < 4; ++j)
+            {
+                auto angle = (static_cast<double>(indexBegin + j) * timeStep + wave_.phase)*omega;
+                sine[j]     = std::sin(angle)*amplitude;
+                cosine[j]   = std::cos(angle)*amplitude;
+            }
+
+            /* Rotate phasors by four time steps per iteration */
+            const auto rotationSin = std::sin(4.0*timeStep*omega);
+            const auto rotationCos = std::cos(4.0*timeStep*omega);
+
+            std::size_t i = 0;
+
+            for (; i + 4 <= frames; i += 4)
+            {
+                for (std::size_t j = 0; j < 4; ++j)
+                {
+                    samples[i + j] += sine[j];
+                    auto s = sine[j]*rotationCos + cosine[j]*rotationSin;
+                    cosine[j] = cosine[j]*rotationCos - sine[j]*rotationSin;
+                    sine[j] = s;
+                }
+            }
+
+            for (std::size_t j = 0; i < frames; ++i, ++j)
+                samples[i] += sine[j];
+        }
+
+    private:
+
+        WaveForm wave_;
+
+};
+
+//! Square wave term with a bias (or rather duty cycle) in the range [0, 1].
+class SquareWave : public WaveFormExpression<SquareWave>
+{
+
+    public:
+
+        /**
+        \brief Initializes the square wave term.
+        \param[in] bias Specifies the phase value in the half-open range (0, 1).
+        */
+        inline SquareWave(const WaveForm& wave, double bias = 0.0) :
+            wave_ { wave                                            },
+            bias_ { (std::max)(0.0, (std::min)(bias + 0.5, 1.0))   }
+        {
+        }
+
+        inline double Evaluate(double timePoint) const
+        {
+            double i = 0.0;
+            double t = std::modf((timePoint + wave_.phase) * wave_.frequency, &i);
+            return (std::ceil(t - bias_)*2.0 - 1.0) * wave_.amplitude;
+        }
+
+    private:
+
+        WaveForm    wave_;
+        double      bias_ = 0.5;
+
+};
+
+//! Triangle wave term, which is in phase with the sine wave, i.e. it rises from 0 to +1 within the first quarter of each cycle.
+class TriangleWave : public WaveFormExpression<TriangleWave>
+{
+
+    public:
+
+        inline TriangleWave(const WaveForm& wave) :
+            wave_ { wave }
+        {
+        }
+
+        inline double Evaluate(double timePoint) const
+        {
+            /* Shift phase by a quarter cycle, so that the peak is at 1/4 and the trough at 3/4 of each cycle */
+            auto x = (timePoint + wave_.phase) * wave_.frequency + 0.25;
+            auto t = x - std::floor(x);
+            return (1.0 - 4.0*std::abs(t - 0.5))*wave_.amplitude;
+        }
+
+    private:
+
+        WaveForm wave_;
+
+};
+
+//! Saw-tooth wave term.
+class SawWave : public WaveFormExpression<SawWave>
+{
+
+    public:
+
+        inline SawWave(const WaveForm& wave) :
+            wave_ { wave }
+        {
+        }
+
+        inline double Evaluate(double timePoint) const
+        {
+            double i = 0.0;
+            double t = std::modf((timePoint + wave_.phase) * wave_.frequency, &i);
+            return (t*2.0 - 1.0)*wave_.amplitude;
+        }
+
+    private:
+
+        WaveForm wave_;
+
+};
+
+//! Half-circle wave term.
+class HalfCircleWave : public WaveFormExpression<HalfCircleWave>
+{
+
+    public:
+
+        inline HalfCircleWave(const WaveForm& wave) :
+            wave_ { wave }
+        {
+        }
+
+        inline double Evaluate(double timePoint) const
+        {
+            double xInt = 0.0;
+            double x    = std::modf((timePoint + wave_.phase)*2.0*wave_.frequency, &xInt)*2.0 - 1.0;
+            double y    = std::sqrt(1.0 - x*x);
+
+            if (static_cast<int>(xInt) % 2 == 1)
+                y = -y;
+
+            return y*wave_.amplitude;
+        }
+
+    private:
+
+        WaveForm wave_;
+
+};
+
+
+/**
+\brief Band-limited square wave term (using PolyBLEP), with the same wave form parameters as SquareWave.
+\remarks The band-limiting depends on the sample rate, which must be specified for this term.
+For frequencies above half of the sample rate, this is equal to SquareWave.
+*/
+class BandLimitedSquareWave : public WaveFormExpression<BandLimitedSquareWave>
+{
+
+    public:
+
+        /**
+        \brief Initializes the band-limited square wave term.
+        \param[in] sampleRate Specifies the sample rate (in Hz) the wave form is generated for.
+        \param[in] bias Specifies the phase value in the half-open range (0, 1).
+        */
+        inline BandLimitedSquareWave(const WaveForm& wave, std::uint32_t sampleRate, double bias = 0.0) :
+            wave_       { wave                                                      },
+            bias_       { (std::max)(0.0, (std::min)(bias + 0.5, 1.0))             },
+            increment_  { std::abs(wave.frequency) / static_cast<double>(sampleRate)   }
+        {
+        }
+
+        inline double Evaluate(double timePoint) const
+        {
+            auto x = (timePoint + wave_.phase) * wave_.frequency;
+            auto t = x - std::floor(x);
+            auto y = (t > bias_ ? 1.0 : -1.0);
+
+            if (increment_ > 0.0 && increment_ <= 0.5)
+            {
+                /* A sample exactly at the rising edge belongs to the upper level, as the residual assumes */
+                if (t == bias_)
+                    y = 1.0;
+
+                /* Smooth rising edge at the bias and falling edge at the cycle start */
+                auto u = t - bias_;
+                y += PolyBLEP(u < 0.0 ? u + 1.0 : u, increment_);
+                y -= PolyBLEP(t, increment_);
+            }
+
+            return y * wave_.amplitude;
+        }
+
+    private:
+
+        WaveForm    wave_;
+        double      bias_       = 0.5;
+        double      increment_  = 0.0;
+
+};
+
+/**
+\brief Band-limited triangle wave term (using PolyBLAMP), with the same wave form parameters as TriangleWave.
+\see BandLimitedSquareWave
+*/
+class BandLimitedTriangleWave : public WaveFormExpression<BandLimitedTriangleWave>
+{
+
+    public:
+
+        inline BandLimitedTriangleWave(const WaveForm& wave, std::uint32_t sampleRate) :
+            wave_       { wave                                                      },
+            increment_  { std::abs(wave.frequency) / static_cast<double>(sampleRate)   }
+        {
+        }
+
+        inline double Evaluate(double timePoint) const
+        {
+            auto x = (timePoint + wave_.phase) * wave_.frequency + 0.25;
+            auto t = x - std::floor(x);
+            auto y = 1.0 - 4.0*std::abs(t - 0.5);
+
+            if (increment_ > 0.0 && increment_ <= 0.5)
+            {
+                /* Smooth trough at phase 0 (slope changes by +8 per cycle) and peak at phase 1/2 (slope changes by -8 per cycle) */
+                auto u = t - 0.5;
+                y += 8.0 * increment_ * PolyBLAMP(t, increment_);
+                y -= 8.0 * increment_ * PolyBLAMP(u < 0.0 ? u + 1.0 : u, increment_);
+            }
+
+            return y * wave_.amplitude;
+        }
+
+    private:
+
+        WaveForm    wave_;
+        double      increment_  = 0.0;
+
+};
+
+/**
+\brief Band-limited saw-tooth wave term (using PolyBLEP), with the same wave form parameters as SawWave.
+\see BandLimitedSquareWave
+*/
+class BandLimitedSawWave : public WaveFormExpression<BandLimitedSawWave>
+{
+
+    public:
+
+        inline BandLimitedSawWave(const WaveForm& wave, std::uint32_t sampleRate) :
+            wave_       { wave                                                      },
+            increment_  { std::abs(wave.frequency) / static_cast<double>(sampleRate)   }
+        {
+        }
+
+        inline double Evaluate(double timePoint) const
+        {
+            auto x = (timePoint + wave_.phase) * wave_.frequency;
+            auto t = x - std::floor(x);
+            auto y = t*2.0 - 1.0;
+
+            /* Smooth discontinuity at the cycle start (the residual only depends on the phase, also for negative frequencies) */
+            if (increment_ > 0.0 && increment_ <= 0.5)
+                y -= PolyBLEP(t, increment_);
+
+            return y * wave_.amplitude;
+        }
+
+    private:
+
+        WaveForm    wave_;
+        double      increment_  = 0.0;
+
+};
+
+
+} // /namespace Synthesizer
+
+} // /namespace Ac
+
+
+#endif
+
+
+
+// ================================================================================
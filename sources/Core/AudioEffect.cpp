@@ -0,0 +1,43 @@
+/*
+ * AudioEffect.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include <Ac/AudioEffect.h>
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+
+namespace Ac
+{
+
+
+// Number of sample frames which are converted into floating-point samples at once.
+static const std::size_t effectBlockSize = WaveBuffer::maxBlockSamples;
+
+void AudioEffect::ProcessWaveBuffer(const WaveBufferView& view)
+{
+    if (view.GetFormat().channels != GetChannels())
+        throw std::invalid_argument("number of channels of wave buffer view does not match the audio effect");
+
+    const auto frames = view.GetSampleFrames();
+
+    std::vector<float> block(std::min(effectBlockSize, frames) * GetChannels());
+
+    for (std::size_t offset = 0; offset < frames; offset += effectBlockSize)
+    {
+        auto n = view.ReadFrames(offset, std::min(effectBlockSize, frames - offset), block.data());
+        Process(block.data(), n);
+        view.WriteFrames(offset, n, block.data());
+    }
+}
+
+
+} // /namespace Ac
+
+
+
+// ================================================================================
@@ -0,0 +1,513 @@
+/*
+ * BiquadFilter.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include <Ac/BiquadFilter.h>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+
+namespace Ac
+{
+
+
+// Number of sample frames between two smoothing steps of the coefficients.
+static const std::size_t smoothingStep = 32;
+
+// Number of sample frames which are filtered at once for all lanes.
+static const std::size_t chunkSize = 64;
+
+// Coefficient difference below which the smoothing snaps to the target coefficients.
+static const float smoothingThreshold = 1.0e-7f;
+
+// Magnitude below which filter states are flushed to zero (avoids denormals when the input becomes silent).
+static const float denormalThreshold = 1.0e-20f;
+
+static const double pi = 3.14159265358979323846;
+
+
+/*
+ * BiquadCoefficients struct
+ */
+
+BiquadCoefficients BiquadCoefficients::Compute(
+    const BiquadType    type,
+    std::uint32_t       sampleRate,
+    double              frequency,
+    double              q,
+    double              gain)
+{
+    if (sampleRate == 0)
+        throw std::invalid_argument("sample rate of biquad filter must not be zero");
+    if (!(q > 0.0))
+        throw std::invalid_argument("Q factor of biquad filter must be positive");
+
+    /* Clamp frequency into the open range (0, sampleRate/2) */
+    const auto fs = static_cast<double>(sampleRate);
+    frequency = std::max(1.0e-4 * fs, std::min(frequency, 0.4999 * fs));
+
+    const auto w0       = 2.0 * pi * frequency / fs;
+    const auto cosW0    = std::cos(w0);
+    const auto alpha    = std::sin(w0) / (2.0 * q);
+    const auto A        = std::pow(10.0, gain / 40.0);
+    const auto sqrtA2   = 2.0 * std::sqrt(A) * alpha;
+
+    double b0 = 1.0, b1 = 0.0, b2 = 0.0, a0 = 1.0, a1 = 0.0, a2 = 0.0;
+
+    switch (type)
+    {
+        case BiquadType::LowPass:
+            b0 = (1.0 - cosW0) * 0.5;
+            b1 = 1.0 - cosW0;
+            b2 = b0;
+            a0 = 1.0 + alpha;
+            a1 = -2.0 * cosW0;
+            a2 = 1.0 - alpha;
+            break;
+
+        case BiquadType::HighPass:
+            b0 = (1.0 + cosW0) * 0.5;
+            b1 = -(1.0 + cosW0);
+            b2 = b0;
+            a0 = 1.0 + alpha;
+            a1 = -2.0 * cosW0;
+            a2 = 1.0 - alpha;
+            break;
+
+        case BiquadType::BandPass:
+            b0 = alpha;
+            b1 = 0.0;
+            b2 = -alpha;
+            a0 = 1.0 + alpha;
+            a1 = -2.0 * cosW0;
+            a2 = 1.0 - alpha;
+            break;
+
+        case BiquadType::Notch:
+            b0 = 1.0;
+            b1 = -2.0 * cosW0;
+            b2 = 1.0;
+            a0 = 1.0 + alpha;
+            a1 = -2.0 * cosW0;
+            a2 = 1.0 - alpha;
+            break;
+
+        case BiquadType::LowShelf:
+            b0 = A * ((A + 1.0) - (A - 1.0) * cosW0 + sqrtA2);
+            b1 = 2.0 * A * ((A - 1.0) - (A + 1.0) * cosW0);
+            b2 = A * ((A + 1.0) - (A - 1.0) * cosW0 - sqrtA2);
+            a0 = (A + 1.0) + (A - 1.0) * cosW0 + sqrtA2;
+            a1 = -2.0 * ((A - 1.0) + (A + 1.0) * cosW0);
+            a2 = (A + 1.0) + (A - 1.0) * cosW0 - sqrtA2;
+            break;
+
+        case BiquadType::HighShelf:
+            b0 = A * ((A + 1.0) + (A - 1.0) * cosW0 + sqrtA2);
+            b1 = -2.0 * A * ((A - 1.0) + (A + 1.0) * cosW0);
+            b2 = A * ((A + 1.0) + (A - 1.0) * cosW0 - sqrtA2);
+            a0 = (A + 1.0) - (A - 1.0) * cosW0 + sqrtA2;
+            a1 = 2.0 * ((A - 1.0) - (A + 1.0) * cosW0);
+            a2 = (A + 1.0) - (A - 1.0) * cosW0 - sqrtA2;
+            break;
+
+        case BiquadType::Peaking:
+            b0 = 1.0 + alpha * A;
+            b1 = -2.0 * cosW0;
+            b2 = 1.0 - alpha * A;
+            a0 = 1.0 + alpha / A;
+            a1 = -2.0 * cosW0;
+            a2 = 1.0 - alpha / A;
+            break;
+    }
+
+    /* Normalize coefficients by a0 */
+    BiquadCoefficients coefficients;
+    {
+        coefficients.b0 = static_cast<float>(b0 / a0);
+        coefficients.b1 = static_cast<float>(b1 / a0);
+        coefficients.b2 = static_cast<float>(b2 / a0);
+        coefficients.a1 = static_cast<float>(a1 / a0);
+        coefficients.a2 = static_cast<float>(a2 / a0);
+    }
+    return coefficients;
+}
+
+
+/*
+ * BiquadFilterBank class
+ */
+
+BiquadFilterBank::BiquadFilterBank(std::size_t lanes)
+{
+    if (lanes == 0)
+        throw std::invalid_argument("number of lanes of biquad filter bank must not be zero");
+    if (lanes > 0xFFFF)
+        throw std::invalid_argument("number of lanes of biquad filter bank must not be greater than 65535");
+
+    /* Initialize all lanes with pass-through filters */
+    b0_.resize(lanes, 1.0f);
+    b1_.resize(lanes, 0.0f);
+    b2_.resize(lanes, 0.0f);
+    a1_.resize(lanes, 0.0f);
+    a2_.resize(lanes, 0.0f);
+
+    targetB0_ = b0_;
+    targetB1_ = b1_;
+    targetB2_ = b2_;
+    targetA1_ = a1_;
+    targetA2_ = a2_;
+
+    z1_.resize(lanes, 0.0f);
+    z2_.resize(lanes, 0.0f);
+
+    SetSmoothingFrames(256);
+}
+
+void BiquadFilterBank::SetFilter(std::size_t lane, const BiquadCoefficients& coefficients, bool immediate)
+{
+    if (lane >= GetNumLanes())
+        throw std::out_of_range("lane index of biquad filter bank out of range");
+
+    targetB0_[lane] = coefficients.b0;
+    targetB1_[lane] = coefficients.b1;
+    targetB2_[lane] = coefficients.b2;
+    targetA1_[lane] = coefficients.a1;
+    targetA2_[lane] = coefficients.a2;
+
+    if (immediate || smoothingFactor_ >= 1.0f)
+    {
+        b0_[lane] = coefficients.b0;
+        b1_[lane] = coefficients.b1;
+        b2_[lane] = coefficients.b2;
+        a1_[lane] = coefficients.a1;
+        a2_[lane] = coefficients.a2;
+    }
+    else
+        smoothing_ = true;
+}
+
+void BiquadFilterBank::SetFilter(const BiquadCoefficients& coefficients, bool immediate)
+{
+    for (std::size_t lane = 0, n = GetNumLanes(); lane < n; ++lane)
+        SetFilter(lane, coefficients, immediate);
+}
+
+BiquadCoefficients BiquadFilterBank::GetFilter(std::size_t lane) const
+{
+    if (lane >= GetNumLanes())
+        throw std::out_of_range("lane index of biquad filter bank out of range");
+
+    BiquadCoefficients coefficients;
+    {
+        coefficients.b0 = targetB0_[lane];
+        coefficients.b1 = targetB1_[lane];
+        coefficients.b2 = targetB2_[lane];
+        coefficients.a1 = targetA1_[lane];
+        coefficients.a2 = targetA2_[lane];
+    }
+    return coefficients;
+}
+
+void BiquadFilterBank::SetSmoothingFrames(std::size_t frames)
+{
+    if (frames > 0)
+        smoothingFactor_ = static_cast<float>(1.0 - std::exp(-static_cast<double>(smoothingStep) / static_cast<double>(frames)));
+    else
+        smoothingFactor_ = 1.0f;
+}
+
+void BiquadFilterBank::Process(float* samples, std::size_t frames)
+{
+    ProcessSteps(samples, nullptr, frames);
+}
+
+void BiquadFilterBank::ProcessPlanar(float* const* lanes, std::size_t frames)
+{
+    ProcessSteps(nullptr, lanes, frames);
+}
+
+void BiquadFilterBank::Reset()
+{
+    std::fill(z1_.begin(), z1_.end(), 0.0f);
+    std::fill(z2_.begin(), z2_.end(), 0.0f);
+
+    b0_ = targetB0_;
+    b1_ = targetB1_;
+    b2_ = targetB2_;
+    a1_ = targetA1_;
+    a2_ = targetA2_;
+
+    smoothing_      = false;
+    smoothingPhase_ = 0;
+}
+
+std::uint16_t BiquadFilterBank::GetChannels() const
+{
+    return static_cast<std::uint16_t>(GetNumLanes());
+}
+
+
+/*
+ * ======= Private: =======
+ */
+
+// Moves the coefficients towards the targets and returns the largest remaining difference.
+static float SmoothCoefficients(float* current, const float* target, std::size_t n, float factor)
+{
+    float maxDiff = 0.0f;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        auto diff = target[i] - current[i];
+        current[i] += diff * factor;
+        maxDiff = std::max(maxDiff, std::abs(diff));
+    }
+    return maxDiff;
+}
+
+void BiquadFilterBank::UpdateCoefficients()
+{
+    const auto n = GetNumLanes();
+
+    auto maxDiff = SmoothCoefficients(b0_.data(), targetB0_.data(), n, smoothingFactor_);
+    maxDiff = std::max(maxDiff, SmoothCoefficients(b1_.data(), targetB1_.data(), n, smoothingFactor_));
+    maxDiff = std::max(maxDiff, SmoothCoefficients(b2_.data(), targetB2_.data(), n, smoothingFactor_));
+    maxDiff = std::max(maxDiff, SmoothCoefficients(a1_.data(), targetA1_.data(), n, smoothingFactor_));
+    maxDiff = std::max(maxDiff, SmoothCoefficients(a2_.data(), targetA2_.data(), n, smoothingFactor_));
+
+    /* Snap to the targets when all coefficients have (almost) arrived */
+    if (maxDiff < smoothingThreshold)
+    {
+        b0_ = targetB0_;
+        b1_ = targetB1_;
+        b2_ = targetB2_;
+        a1_ = targetA1_;
+        a2_ = targetA2_;
+        smoothing_ = false;
+    }
+}
+
+/*
+Filters a group of 'Width' adjacent lanes of the interleaved sample frames in transposed direct form II.
+The coefficients and states are kept in local arrays during all frames, so the loop over the lanes of a group is vectorized.
+*/
+template <std::size_t Width>
+static void ProcessLaneGroup(
+    float*          samples,
+    std::size_t     stride,
+    std::size_t     frames,
+    const float*    b0In,
+    const float*    b1In,
+    const float*    b2In,
+    const float*    a1In,
+    const float*    a2In,
+    float*          z1InOut,
+    float*          z2InOut)
+{
+    float b0[Width], b1[Width], b2[Width], a1[Width], a2[Width], z1[Width], z2[Width];
+
+    for (std::size_t i = 0; i < Width; ++i)
+    {
+        b0[i] = b0In[i];
+        b1[i] = b1In[i];
+        b2[i] = b2In[i];
+        a1[i] = a1In[i];
+        a2[i] = a2In[i];
+        z1[i] = z1InOut[i];
+        z2[i] = z2InOut[i];
+    }
+
+    for (std::size_t frame = 0; frame < frames; ++frame, samples += stride)
+    {
+        for (std::size_t i = 0; i < Width; ++i)
+        {
+            auto x = samples[i];
+            auto y = b0[i] * x + z1[i];
+            z1[i] = b1[i] * x - a1[i] * y + z2[i];
+            z2[i] = b2[i] * x - a2[i] * y;
+            samples[i] = y;
+        }
+    }
+
+    for (std::size_t i = 0; i < Width; ++i)
+    {
+        z1InOut[i] = z1[i];
+        z2InOut[i] = z2[i];
+    }
+}
+
+template <std::size_t Width>
+static void ProcessLaneGroups(
+    float*          samples,
+    std::size_t     stride,
+    std::size_t     frames,
+    std::size_t&    lane,
+    std::size_t     numLanes,
+    const float*    b0,
+    const float*    b1,
+    const float*    b2,
+    const float*    a1,
+    const float*    a2,
+    float*          z1,
+    float*          z2)
+{
+    for (; lane + Width <= numLanes; lane += Width)
+    {
+        ProcessLaneGroup<Width>(
+            samples + lane, stride, frames,
+            b0 + lane, b1 + lane, b2 + lane, a1 + lane, a2 + lane, z1 + lane, z2 + lane
+        );
+    }
+}
+
+/*
+Filters a group of 'Width' lanes with separate sample arrays. The samples of each chunk are interleaved
+into a small local buffer, which stays in the cache, and are filtered like interleaved lanes.
+*/
+template <std::size_t Width>
+static void ProcessPlanarLaneGroups(
+    float* const*   lanes,
+    std::size_t     offset,
+    std::size_t     frames,
+    std::size_t&    lane,
+    std::size_t     numLanes,
+    const float*    b0,
+    const float*    b1,
+    const float*    b2,
+    const float*    a1,
+    const float*    a2,
+    float*          z1,
+    float*          z2)
+{
+    float buffer[chunkSize * Width];
+
+    for (; lane + Width <= numLanes; lane += Width)
+    {
+        for (std::size_t chunkOffset = 0; chunkOffset < frames; chunkOffset += chunkSize)
+        {
+            auto n = std::min(chunkSize, frames - chunkOffset);
+
+            for (std::size_t i = 0; i < Width; ++i)
+            {
+                auto src = lanes[lane + i] + offset + chunkOffset;
+                for (std::size_t frame = 0; frame < n; ++frame)
+                    buffer[frame * Width + i] = src[frame];
+            }
+
+            ProcessLaneGroup<Width>(
+                buffer, Width, n,
+                b0 + lane, b1 + lane, b2 + lane, a1 + lane, a2 + lane, z1 + lane, z2 + lane
+            );
+
+            for (std::size_t i = 0; i < Width; ++i)
+            {
+                auto dst = lanes[lane + i] + offset + chunkOffset;
+                for (std::size_t frame = 0; frame < n; ++frame)
+                    dst[frame] = buffer[frame * Width + i];
+            }
+        }
+    }
+}
+
+/*
+Processes either the interleaved samples or the separate sample arrays of all lanes in steps,
+and moves the coefficients towards the targets after each step while they are smoothed.
+*/
+void BiquadFilterBank::ProcessSteps(float* samples, float* const* lanes, std::size_t frames)
+{
+    std::size_t offset = 0;
+
+    while (offset < frames)
+    {
+        auto n = frames - offset;
+        if (smoothing_)
+            n = std::min(n, smoothingStep - smoothingPhase_);
+
+        if (samples != nullptr)
+            ProcessFrames(samples + offset * GetNumLanes(), n);
+        else
+            ProcessFramesPlanar(lanes, offset, n);
+
+        offset += n;
+
+        if (smoothing_)
+        {
+            smoothingPhase_ += n;
+            if (smoothingPhase_ == smoothingStep)
+            {
+                smoothingPhase_ = 0;
+                UpdateCoefficients();
+            }
+        }
+    }
+
+    FlushDenormals();
+}
+
+/*
+Filters the interleaved sample frames. The recursion of each lane only depends on its own previous samples,
+so the lanes are filtered in groups of up to 8 lanes, which fit into the SIMD registers.
+The frames are processed in chunks, so all groups of many lanes work on the same cached samples.
+*/
+void BiquadFilterBank::ProcessFrames(float* samples, std::size_t frames)
+{
+    const auto numLanes = GetNumLanes();
+
+    const auto b0 = b0_.data();
+    const auto b1 = b1_.data();
+    const auto b2 = b2_.data();
+    const auto a1 = a1_.data();
+    const auto a2 = a2_.data();
+    auto z1 = z1_.data();
+    auto z2 = z2_.data();
+
+    for (std::size_t offset = 0; offset < frames; offset += chunkSize)
+    {
+        auto n      = std::min(chunkSize, frames - offset);
+        auto chunk  = samples + offset * numLanes;
+        auto lane   = std::size_t(0);
+
+        ProcessLaneGroups<8>(chunk, numLanes, n, lane, numLanes, b0, b1, b2, a1, a2, z1, z2);
+        ProcessLaneGroups<4>(chunk, numLanes, n, lane, numLanes, b0, b1, b2, a1, a2, z1, z2);
+        ProcessLaneGroups<2>(chunk, numLanes, n, lane, numLanes, b0, b1, b2, a1, a2, z1, z2);
+        ProcessLaneGroups<1>(chunk, numLanes, n, lane, numLanes, b0, b1, b2, a1, a2, z1, z2);
+    }
+}
+
+void BiquadFilterBank::ProcessFramesPlanar(float* const* lanes, std::size_t offset, std::size_t frames)
+{
+    const auto numLanes = GetNumLanes();
+
+    const auto b0 = b0_.data();
+    const auto b1 = b1_.data();
+    const auto b2 = b2_.data();
+    const auto a1 = a1_.data();
+    const auto a2 = a2_.data();
+    auto z1 = z1_.data();
+    auto z2 = z2_.data();
+
+    auto lane = std::size_t(0);
+
+    ProcessPlanarLaneGroups<8>(lanes, offset, frames, lane, numLanes, b0, b1, b2, a1, a2, z1, z2);
+    ProcessPlanarLaneGroups<4>(lanes, offset, frames, lane, numLanes, b0, b1, b2, a1, a2, z1, z2);
+    ProcessPlanarLaneGroups<2>(lanes, offset, frames, lane, numLanes, b0, b1, b2, a1, a2, z1, z2);
+    ProcessPlanarLaneGroups<1>(lanes, offset, frames, lane, numLanes, b0, b1, b2, a1, a2, z1, z2);
+}
+
+void BiquadFilterBank::FlushDenormals()
+{
+    for (auto& z : z1_)
+        z = (std::abs(z) < denormalThreshold ? 0.0f : z);
+    for (auto& z : z2_)
+        z = (std::abs(z) < denormalThreshold ? 0.0f : z);
+}
+
+
+} // /namespace Ac
+
+
+
+// ================================================================================
@@ -0,0 +1,103 @@
+/*
+ * CPUFeatures.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "CPUFeatures.h"
+
+#if defined(AC_SIMD_SSE2)
+#   if defined(_MSC_VER)
+#       include <intrin.h>
+#   else
+#       include <cpuid.h>
+#   endif
+#endif
+
+
+namespace Ac
+{
+
+
+#if defined(AC_SIMD_SSE2)
+
+static void QueryCPUID(unsigned int leaf, unsigned int subleaf, unsigned int (&regs)[4])
+{
+    #if defined(_MSC_VER)
+    int info[4] = { 0 };
+    __cpuidex(info, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (int i = 0; i < 4; ++i)
+        regs[i] = static_cast<unsigned int>(info[i]);
+    #else
+    regs[0] = regs[1] = regs[2] = regs[3] = 0;
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+    #endif
+}
+
+static unsigned long long QueryXCR0()
+{
+    #if defined(_MSC_VER)
+    return _xgetbv(0);
+    #else
+    unsigned int eax = 0, edx = 0;
+    __asm__ __volatile__ ("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return ((static_cast<unsigned long long>(edx) << 32) | eax);
+    #endif
+}
+
+static CPUFeatures DetermineCPUFeatures()
+{
+    CPUFeatures features;
+
+    unsigned int regs[4];
+    QueryCPUID(0, 0, regs);
+    auto maxLeaf = regs[0];
+
+    if (maxLeaf >= 1)
+    {
+        QueryCPUID(1, 0, regs);
+        features.sse2 = ((regs[3] & (1u << 26)) != 0);
+
+        /* AVX2 requires OS support to save the YMM registers (OSXSAVE bit and XCR0 bits 1 and 2) */
+        bool osxsave = ((regs[2] & (1u << 27)) != 0);
+        bool avx     = ((regs[2] & (1u << 28)) != 0);
+
+        if (maxLeaf >= 7 && osxsave && avx && (QueryXCR0() & 0x6) == 0x6)
+        {
+            QueryCPUID(7, 0, regs);
+            features.avx2 = ((regs[1] & (1u << 5)) != 0);
+        }
+    }
+
+    return features;
+}
+
+#else
+
+static CPUFeatures DetermineCPUFeatures()
+{
+    CPUFeatures features;
+
+    #if defined(AC_SIMD_NEON)
+    /* NEON is mandatory on AArch64 */
+    features.neon = true;
+    #endif
+
+    return features;
+}
+
+#endif
+
+const CPUFeatures& GetCPUFeatures()
+{
+    static const CPUFeatures features = DetermineCPUFeatures();
+    return features;
+}
+
+
+} // /namespace Ac
+
+
+
+// ================================================================================
@@ -0,0 +1,69 @@
+/*
+ * CPUFeatures.h
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef AC_CPU_FEATURES_H
+#define AC_CPU_FEATURES_H
+
+
+/* --- SIMD instruction sets that can be compiled on the current platform --- */
+
+#ifndef AC_DISABLE_SIMD
+#   if defined(_M_X64) || defined(__x86_64__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#       define AC_SIMD_SSE2
+#       if defined(_MSC_VER) || defined(__GNUC__) || defined(__clang__)
+#           define AC_SIMD_AVX2
+#       endif
+#   elif defined(__aarch64__) || defined(_M_ARM64)
+#       define AC_SIMD_NEON
+#   endif
+#endif
+
+/* --- Function attribute to compile a single function for the AVX2 instruction set --- */
+
+#if defined(AC_SIMD_AVX2) && (defined(__GNUC__) || defined(__clang__))
+#   define AC_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#   define AC_TARGET_AVX2
+#endif
+
+#if defined(AC_SIMD_SSE2)
+#   include <emmintrin.h>
+#endif
+
+#if defined(AC_SIMD_AVX2)
+#   include <immintrin.h>
+#endif
+
+#if defined(AC_SIMD_NEON)
+#   include <arm_neon.h>
+#endif
+
+
+namespace Ac
+{
+
+
+//! CPU features structure, which is used to select the SIMD kernels at runtime.
+struct CPUFeatures
+{
+    bool sse2 = false;  //!< Specifies whether the SSE2 instruction set is available.
+    bool avx2 = false;  //!< Specifies whether the AVX2 instruction set is available (including OS support for the YMM registers).
+    bool neon = false;  //!< Specifies whether the ARM NEON instruction set is available.
+};
+
+//! Returns the features of the host CPU. They are only determined once.
+const CPUFeatures& GetCPUFeatures();
+
+
+} // /namespace Ac
+
+
+#endif
+
+
+
+// ================================================================================
@@ -0,0 +1,373 @@
+/*
+ * ChannelMixer.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include <Ac/ChannelMixer.h>
+#include <Ac/ChannelTypes.h>
+#include "VectorKernels.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+
+namespace Ac
+{
+
+
+// Number of sample frames which are remixed at once (to keep the planar scratch memory in the cache)
+static const std::size_t framesPerBlock = 256;
+
+// Gain of -3 dB to fold a speaker into two neighbouring speakers with constant power
+static const float minus3dB             = 0.70710678f;
+
+
+/* ----- Speaker layouts ----- */
+
+enum class Speaker
+{
+    FrontLeft,
+    FrontRight,
+    FrontCenter,
+    LFE,
+    SideLeft,
+    SideRight,
+    RearLeft,
+    RearRight,
+    RearCenter,
+};
+
+// Returns the speaker layout for the specified number of channels, or an empty layout if there is no standard layout.
+static std::vector<Speaker> GetSpeakerLayout(std::uint16_t channels)
+{
+    std::vector<Speaker> layout(channels);
+
+    switch (channels)
+    {
+        case 1:
+            layout[0] = Speaker::FrontCenter;
+            break;
+
+        case 2:
+            layout[ChannelTypes2::Left          ] = Speaker::FrontLeft;
+            layout[ChannelTypes2::Right         ] = Speaker::FrontRight;
+            break;
+
+        case 3:
+            layout[ChannelTypes3::Left          ] = Speaker::FrontLeft;
+            layout[ChannelTypes3::Center        ] = Speaker::FrontCenter;
+            layout[ChannelTypes3::Right         ] = Speaker::FrontRight;
+            break;
+
+        case 4:
+            layout[ChannelTypes4::FrontLeft     ] = Speaker::FrontLeft;
+            layout[ChannelTypes4::FrontRight    ] = Speaker::FrontRight;
+            layout[ChannelTypes4::RearLeft      ] = Speaker::RearLeft;
+            layout[ChannelTypes4::RearRight     ] = Speaker::RearRight;
+            break;
+
+        case 5:
+            layout[ChannelTypes5::FrontLeft     ] = Speaker::FrontLeft;
+            layout[ChannelTypes5::FrontCenter   ] = Speaker::FrontCenter;
+            layout[ChannelTypes5::FrontRight    ] = Speaker::FrontRight;
+            layout[ChannelTypes5::RearLeft      ] = Speaker::RearLeft;
+            layout[ChannelTypes5::RearRight     ] = Speaker::RearRight;
+            break;
+
+        case 6:
+            layout[ChannelTypes5_1::FrontLeft   ] = Speaker::FrontLeft;
+            layout[ChannelTypes5_1::FrontCenter ] = Speaker::FrontCenter;
+            layout[ChannelTypes5_1::FrontRight  ] = Speaker::FrontRight;
+            layout[ChannelTypes5_1::RearLeft    ] = Speaker::RearLeft;
+            layout[ChannelTypes5_1::RearRight   ] = Speaker::RearRight;
+            layout[ChannelTypes5_1::LFE         ] = Speaker::LFE;
+            break;
+
+        case 7:
+            layout[ChannelTypes6_1::FrontLeft   ] = Speaker::FrontLeft;
+            layout[ChannelTypes6_1::FrontCenter ] = Speaker::FrontCenter;
+            layout[ChannelTypes6_1::FrontRight  ] = Speaker::FrontRight;
+            layout[ChannelTypes6_1::SideLeft    ] = Speaker::SideLeft;
+            layout[ChannelTypes6_1::SideRight   ] = Speaker::SideRight;
+            layout[ChannelTypes6_1::RearCenter  ] = Speaker::RearCenter;
+            layout[ChannelTypes6_1::LFE         ] = Speaker::LFE;
+            break;
+
+        case 8:
+            layout[ChannelTypes7_1::FrontLeft   ] = Speaker::FrontLeft;
+            layout[ChannelTypes7_1::FrontCenter ] = Speaker::FrontCenter;
+            layout[ChannelTypes7_1::FrontRight  ] = Speaker::FrontRight;
+            layout[ChannelTypes7_1::SideLeft    ] = Speaker::SideLeft;
+            layout[ChannelTypes7_1::SideRight   ] = Speaker::SideRight;
+            layout[ChannelTypes7_1::RearLeft    ] = Speaker::RearLeft;
+            layout[ChannelTypes7_1::RearRight   ] = Speaker::RearRight;
+            layout[ChannelTypes7_1::LFE         ] = Speaker::LFE;
+            break;
+
+        default:
+            layout.clear();
+            break;
+    }
+
+    return layout;
+}
+
+class SpeakerRouter
+{
+
+    public:
+
+        SpeakerRouter(const std::vector<Speaker>& outputLayout, std::uint16_t inputChannels, std::vector<float>& matrix) :
+            outputLayout_  { outputLayout  },
+            inputChannels_ { inputChannels },
+            matrix_        { matrix        }
+        {
+        }
+
+        // Routes the specified input channel (with the specified speaker) into the output layout.
+        void Route(std::uint16_t inputChannel, Speaker speaker, float gain)
+        {
+            auto it = std::find(outputLayout_.begin(), outputLayout_.end(), speaker);
+            if (it != outputLayout_.end())
+            {
+                auto outputChannel = static_cast<std::size_t>(it - outputLayout_.begin());
+                matrix_[outputChannel * inputChannels_ + inputChannel] += gain;
+                return;
+            }
+
+            /* Fold missing speaker into the nearest speakers of the output layout */
+            switch (speaker)
+            {
+                case Speaker::FrontLeft:
+                case Speaker::FrontRight:
+                    Route(inputChannel, Speaker::FrontCenter, gain * minus3dB);
+                    break;
+
+                case Speaker::FrontCenter:
+                    Route(inputChannel, Speaker::FrontLeft, gain * minus3dB);
+                    Route(inputChannel, Speaker::FrontRight, gain * minus3dB);
+                    break;
+
+                case Speaker::LFE:
+                    /* Drop LFE channel on downmix */
+                    break;
+
+                case Speaker::SideLeft:
+                    RouteSurround(inputChannel, Speaker::RearLeft, Speaker::FrontLeft, gain);
+                    break;
+
+                case Speaker::SideRight:
+                    RouteSurround(inputChannel, Speaker::RearRight, Speaker::FrontRight, gain);
+                    break;
+
+                case Speaker::RearLeft:
+                    RouteSurround(inputChannel, Speaker::SideLeft, Speaker::FrontLeft, gain);
+                    break;
+
+                case Speaker::RearRight:
+                    RouteSurround(inputChannel, Speaker::SideRight, Speaker::FrontRight, gain);
+                    break;
+
+                case Speaker::RearCenter:
+                    if (Contains(Speaker::RearLeft) && Contains(Speaker::RearRight))
+                    {
+                        Route(inputChannel, Speaker::RearLeft, gain * minus3dB);
+                        Route(inputChannel, Speaker::RearRight, gain * minus3dB);
+                    }
+                    else if (Contains(Speaker::SideLeft) && Contains(Speaker::SideRight))
+                    {
+                        Route(inputChannel, Speaker::SideLeft, gain * minus3dB);
+                        Route(inputChannel, Speaker::SideRight, gain * minus3dB);
+                    }
+                    else
+                    {
+                        Route(inputChannel, Speaker::FrontLeft, gain * 0.5f);
+                        Route(inputChannel, Speaker::FrontRight, gain * 0.5f);
+                    }
+                    break;
+            }
+        }
+
+    private:
+
+        bool Contains(Speaker speaker) const
+        {
+            return (std::find(outputLayout_.begin(), outputLayout_.end(), speaker) != outputLayout_.end());
+        }
+
+        // Routes a surround speaker to the other surround speaker on the same side, or to the front speaker with -3 dB.
+        void RouteSurround(std::uint16_t inputChannel, Speaker surround, Speaker front, float gain)
+        {
+            if (Contains(surround))
+                Route(inputChannel, surround, gain);
+            else
+                Route(inputChannel, front, gain * minus3dB);
+        }
+
+    private:
+
+        const std::vector<Speaker>& outputLayout_;
+        std::uint16_t               inputChannels_;
+        std::vector<float>&         matrix_;
+
+};
+
+
+/* ----- ChannelMixer class ----- */
+
+static void ValidateChannels(std::uint16_t inputChannels, std::uint16_t outputChannels)
+{
+    if (inputChannels == 0 || outputChannels == 0)
+        throw std::invalid_argument("number of channels of channel mixer must not be zero");
+}
+
+ChannelMixer::ChannelMixer(std::uint16_t inputChannels, std::uint16_t outputChannels) :
+    inputChannels_  { inputChannels  },
+    outputChannels_ { outputChannels }
+{
+    ValidateChannels(inputChannels, outputChannels);
+    matrix_ = StandardMatrix(inputChannels, outputChannels);
+}
+
+ChannelMixer::ChannelMixer(std::uint16_t inputChannels, std::uint16_t outputChannels, const std::vector<float>& matrix) :
+    inputChannels_  { inputChannels  },
+    outputChannels_ { outputChannels },
+    matrix_         { matrix         }
+{
+    ValidateChannels(inputChannels, outputChannels);
+    if (matrix.size() != static_cast<std::size_t>(inputChannels) * outputChannels)
+        throw std::invalid_argument("gain matrix of channel mixer must have (outputChannels * inputChannels) elements");
+}
+
+void ChannelMixer::Process(const float* input, std::size_t frames, float* output)
+{
+    /* Allocate scratch memory for one block of planar input and output samples */
+    planes_.resize((inputChannels_ + outputChannels_) * framesPerBlock);
+    inputPlanes_.resize(inputChannels_);
+    outputPlanes_.resize(outputChannels_);
+
+    for (std::uint16_t chn = 0; chn < inputChannels_; ++chn)
+        inputPlanes_[chn] = planes_.data() + chn * framesPerBlock;
+    for (std::uint16_t chn = 0; chn < outputChannels_; ++chn)
+        outputPlanes_[chn] = planes_.data() + (inputChannels_ + chn) * framesPerBlock;
+
+    for (std::size_t i = 0; i < frames; i += framesPerBlock)
+    {
+        auto blockFrames = std::min(framesPerBlock, frames - i);
+
+        /* Deinterleave input block */
+        auto src = input + i * inputChannels_;
+        for (std::uint16_t chn = 0; chn < inputChannels_; ++chn)
+        {
+            auto plane = planes_.data() + chn * framesPerBlock;
+            for (std::size_t j = 0; j < blockFrames; ++j)
+                plane[j] = src[j*inputChannels_ + chn];
+        }
+
+        /* Apply gain matrix on contiguous planes */
+        ProcessPlanar(inputPlanes_.data(), blockFrames, outputPlanes_.data());
+
+        /* Interleave output block */
+        auto dst = output + i * outputChannels_;
+        for (std::uint16_t chn = 0; chn < outputChannels_; ++chn)
+        {
+            auto plane = outputPlanes_[chn];
+            for (std::size_t j = 0; j < blockFrames; ++j)
+                dst[j*outputChannels_ + chn] = plane[j];
+        }
+    }
+}
+
+void ChannelMixer::ProcessPlanar(const float* const* inputs, std::size_t frames, float* const* outputs) const
+{
+    auto scaleCopy  = GetScaleCopyKernel();
+    auto scaleAdd   = GetScaleAddKernel();
+
+    for (std::uint16_t outChn = 0; outChn < outputChannels_; ++outChn)
+    {
+        auto row    = matrix_.data() + static_cast<std::size_t>(outChn) * inputChannels_;
+        auto dst    = outputs[outChn];
+        bool empty  = true;
+
+        /* Accumulate all input channels with a non-zero gain, so sparse matrices (e.g. the identity) are cheap */
+        for (std::uint16_t inChn = 0; inChn < inputChannels_; ++inChn)
+        {
+            if (row[inChn] != 0.0f)
+            {
+                if (empty)
+                {
+                    scaleCopy(dst, inputs[inChn], row[inChn], frames);
+                    empty = false;
+                }
+                else
+                    scaleAdd(dst, inputs[inChn], row[inChn], frames);
+            }
+        }
+
+        if (empty)
+            std::fill(dst, dst + frames, 0.0f);
+    }
+}
+
+void ChannelMixer::SetGain(std::uint16_t outputChannel, std::uint16_t inputChannel, float gain)
+{
+    if (outputChannel < outputChannels_ && inputChannel < inputChannels_)
+        matrix_[static_cast<std::size_t>(outputChannel) * inputChannels_ + inputChannel] = gain;
+}
+
+float ChannelMixer::GetGain(std::uint16_t outputChannel, std::uint16_t inputChannel) const
+{
+    if (outputChannel < outputChannels_ && inputChannel < inputChannels_)
+        return matrix_[static_cast<std::size_t>(outputChannel) * inputChannels_ + inputChannel];
+    return 0.0f;
+}
+
+std::vector<float> ChannelMixer::StandardMatrix(std::uint16_t inputChannels, std::uint16_t outputChannels)
+{
+    std::vector<float> matrix(static_cast<std::size_t>(inputChannels) * outputChannels, 0.0f);
+
+    auto inputLayout    = GetSpeakerLayout(inputChannels);
+    auto outputLayout   = GetSpeakerLayout(outputChannels);
+
+    if (inputChannels == outputChannels || inputLayout.empty() || outputLayout.empty())
+    {
+        /* Map channels one-to-one */
+        for (std::uint16_t chn = 0, n = std::min(inputChannels, outputChannels); chn < n; ++chn)
+            matrix[static_cast<std::size_t>(chn) * inputChannels + chn] = 1.0f;
+    }
+    else
+    {
+        /* Route each input speaker into the output layout */
+        SpeakerRouter router(outputLayout, inputChannels, matrix);
+
+        for (std::uint16_t chn = 0; chn < inputChannels; ++chn)
+            router.Route(chn, inputLayout[chn], 1.0f);
+
+        /* Normalize rows whose gains sum up above 1, so a full-scale input can not clip */
+        for (std::uint16_t outChn = 0; outChn < outputChannels; ++outChn)
+        {
+            auto row = matrix.data() + static_cast<std::size_t>(outChn) * inputChannels;
+
+            float sum = 0.0f;
+            for (std::uint16_t inChn = 0; inChn < inputChannels; ++inChn)
+                sum += row[inChn];
+
+            if (sum > 1.0f)
+            {
+                for (std::uint16_t inChn = 0; inChn < inputChannels; ++inChn)
+                    row[inChn] /= sum;
+            }
+        }
+    }
+
+    return matrix;
+}
+
+
+} // /namespace Ac
+
+
+
+// ================================================================================
@@ -0,0 +1,134 @@
+/*
+ * Compressor.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include <Ac/Compressor.h>
+#include "Dynamics.h"
+#include "VectorKernels.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+
+namespace Ac
+{
+
+
+/*
+Replaces the levels (in dB) by the gain reductions (in dB, zero or positive) of the static compression curve.
+Within the soft knee, the reduction grows quadratically: 'slope * (over + knee/2)^2 / (2 * knee)'.
+*/
+static void ComputeGainReductions(float* values, std::size_t n, float threshold, float slope, float knee)
+{
+    const auto halfKnee     = knee * 0.5f;
+    const auto kneeFactor   = (knee > 0.0f ? 0.5f / knee : 0.0f);
+
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        auto over   = values[i] - threshold;
+        auto inKnee = ClampValue(over + halfKnee, 0.0f, knee);
+        values[i] = slope * (inKnee * inKnee * kneeFactor + MaxValue(over - halfKnee, 0.0f));
+    }
+}
+
+Compressor::Compressor(std::uint32_t sampleRate, std::uint16_t channels, const CompressorParameters& parameters) :
+    sampleRate_ { sampleRate },
+    channels_   { channels   }
+{
+    if (sampleRate == 0)
+        throw std::invalid_argument("sample rate of compressor must not be zero");
+    if (channels == 0)
+        throw std::invalid_argument("number of channels of compressor must not be zero");
+
+    SetParameters(parameters);
+}
+
+void Compressor::Process(float* samples, std::size_t frames)
+{
+    const auto lanes        = envelopes_.size();
+    const auto threshold    = static_cast<float>(parameters_.threshold);
+    const auto slope        = static_cast<float>(1.0 - 1.0 / parameters_.ratio);
+    const auto knee         = static_cast<float>(parameters_.knee);
+    const auto makeupGain   = static_cast<float>(parameters_.makeupGain);
+
+    levels_.resize(dynamicsBlockSize * lanes);
+    auto levels = levels_.data();
+
+    for (std::size_t offset = 0; offset < frames; offset += dynamicsBlockSize)
+    {
+        const auto n        = std::min(dynamicsBlockSize, frames - offset);
+        const auto count    = n * lanes;
+        const auto block    = samples + offset * channels_;
+
+        /* Detect peak levels (of the loudest channel if the channels are linked) */
+        if (parameters_.linked)
+            FramePeaks(block, n, channels_, levels);
+        else
+        {
+            for (std::size_t i = 0; i < count; ++i)
+                levels[i] = std::abs(block[i]);
+        }
+
+        /* Compute gain reductions, apply attack and release, and convert them back to linear gains */
+        AmplitudesToDecibels(levels, count);
+        ComputeGainReductions(levels, count, threshold, slope, knee);
+        FollowEnvelopes(levels, n, envelopes_.data(), lanes, attack_, release_);
+
+        for (std::size_t i = 0; i < count; ++i)
+            levels[i] = makeupGain - levels[i];
+
+        DecibelsToAmplitudes(levels, count);
+
+        /* Apply gains to the samples */
+        if (parameters_.linked)
+            ScaleFrames(block, n, channels_, levels);
+        else
+        {
+            for (std::size_t i = 0; i < count; ++i)
+                block[i] *= levels[i];
+        }
+    }
+}
+
+void Compressor::Reset()
+{
+    std::fill(envelopes_.begin(), envelopes_.end(), 0.0f);
+}
+
+std::uint16_t Compressor::GetChannels() const
+{
+    return channels_;
+}
+
+void Compressor::SetParameters(const CompressorParameters& parameters)
+{
+    parameters_ = parameters;
+
+    parameters_.ratio       = std::max(1.0, parameters_.ratio);
+    parameters_.knee        = std::max(0.0, parameters_.knee);
+    parameters_.attackTime  = std::max(0.0, parameters_.attackTime);
+    parameters_.releaseTime = std::max(0.0, parameters_.releaseTime);
+
+    attack_     = SmoothingCoefficient(parameters_.attackTime, sampleRate_);
+    release_    = SmoothingCoefficient(parameters_.releaseTime, sampleRate_);
+
+    /* Keep the gain reduction when the number of detector lanes does not change */
+    const auto lanes = (parameters_.linked ? std::size_t(1u) : static_cast<std::size_t>(channels_));
+    if (envelopes_.size() != lanes)
+        envelopes_.assign(lanes, 0.0f);
+}
+
+float Compressor::GetGainReduction() const
+{
+    return *std::max_element(envelopes_.begin(), envelopes_.end());
+}
+
+
+} // /namespace Ac
+
+
+
+// ================================================================================
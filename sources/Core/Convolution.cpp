@@ -0,0 +1,127 @@
+/*
+ * Convolution.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "Convolution.h"
+#include "VectorKernels.h"
+
+#include <Ac/FFT.h>
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <vector>
+
+
+namespace Ac
+{
+
+
+// Number of output samples which are accumulated at once by the direct convolution (small enough to stay in the L1 cache).
+static const std::size_t directBlockSize = 2048;
+
+// Estimated costs of the FFT block convolution per output sample and per 'log2(FFT size)', relative to the costs of one coefficient of the direct convolution.
+static const double fftCostFactor = 16.0;
+
+// Returns the FFT size for the block convolution, which is about four times the kernel size (but not larger than required for the entire output).
+static std::size_t GetBlockFFTSize(std::size_t outputSize, std::size_t kernelSize)
+{
+    auto fftSize = FFTPlan::GetFastSize(std::max(std::size_t(64u), kernelSize * 4));
+    return std::min(fftSize, FFTPlan::GetFastSize(outputSize + kernelSize - 1));
+}
+
+void ConvolveValid(const float* input, std::size_t outputSize, const float* kernel, std::size_t kernelSize, float* output)
+{
+    if (outputSize == 0)
+        return;
+
+    /* Compare the number of non-zero coefficients with the estimated costs of the FFT block convolution */
+    auto numCoefficients = static_cast<std::size_t>(std::count_if(kernel, kernel + kernelSize, [](float c) { return c != 0.0f; }));
+
+    auto fftSize    = GetBlockFFTSize(outputSize, kernelSize);
+    auto blockSize  = fftSize - kernelSize + 1;
+    auto fftCosts   = fftCostFactor * std::log2(static_cast<double>(fftSize)) * static_cast<double>(fftSize) / static_cast<double>(blockSize);
+
+    if (static_cast<double>(numCoefficients) <= fftCosts)
+        ConvolveValidDirect(input, outputSize, kernel, kernelSize, output);
+    else
+        ConvolveValidFFT(input, outputSize, kernel, kernelSize, output);
+}
+
+void ConvolveValidDirect(const float* input, std::size_t outputSize, const float* kernel, std::size_t kernelSize, float* output)
+{
+    const auto scaleAdd = GetScaleAddKernel();
+
+    for (std::size_t offset = 0; offset < outputSize; offset += directBlockSize)
+    {
+        auto n = std::min(directBlockSize, outputSize - offset);
+
+        /* Accumulate the shifted input signal for each non-zero coefficient */
+        std::fill(output + offset, output + offset + n, 0.0f);
+
+        for (std::size_t k = 0; k < kernelSize; ++k)
+        {
+            if (kernel[k] != 0.0f)
+                scaleAdd(output + offset, input + offset + kernelSize - 1 - k, kernel[k], n);
+        }
+    }
+}
+
+void ConvolveValidFFT(const float* input, std::size_t outputSize, const float* kernel, std::size_t kernelSize, float* output)
+{
+    if (outputSize == 0 || kernelSize == 0)
+        return;
+
+    const auto inputSize    = outputSize + kernelSize - 1;
+    const auto fftSize      = GetBlockFFTSize(outputSize, kernelSize);
+    const auto blockSize    = fftSize - kernelSize + 1;
+
+    const auto plan         = RealFFTPlan::Get(fftSize);
+    const auto numBins      = plan->GetNumBins();
+
+    /* Transform the kernel once (and include the normalization of the inverse transform) */
+    std::vector<float> block(fftSize, 0.0f);
+
+    const auto scale = 1.0f / static_cast<float>(fftSize);
+    for (std::size_t i = 0; i < kernelSize; ++i)
+        block[i] = kernel[i] * scale;
+
+    std::vector<std::complex<float>> kernelSpectrum(numBins), spectrum(numBins);
+    plan->Forward(block.data(), kernelSpectrum.data());
+
+    /*
+    Overlap-save: transform segments of 'fftSize' input samples, which overlap by 'kernelSize - 1' samples,
+    and keep the last 'blockSize' samples of each circular convolution
+    */
+    for (std::size_t offset = 0; offset < outputSize; offset += blockSize)
+    {
+        auto n = std::min(fftSize, inputSize - offset);
+        std::copy(input + offset, input + offset + n, block.begin());
+        std::fill(block.begin() + n, block.end(), 0.0f);
+
+        plan->Forward(block.data(), spectrum.data());
+
+        for (std::size_t i = 0; i < numBins; ++i)
+        {
+            const auto& a = spectrum[i];
+            const auto& b = kernelSpectrum[i];
+            spectrum[i] = std::complex<float>(a.real()*b.real() - a.imag()*b.imag(), a.real()*b.imag() + a.imag()*b.real());
+        }
+
+        plan->Inverse(spectrum.data(), block.data());
+
+        /* Write valid outputs of this segment */
+        n = std::min(blockSize, outputSize - offset);
+        std::copy(block.begin() + (kernelSize - 1), block.begin() + (kernelSize - 1 + n), output + offset);
+    }
+}
+
+
+} // /namespace Ac
+
+
+
+// ================================================================================
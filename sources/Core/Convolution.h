@@ -0,0 +1,45 @@
+/*
+ * Convolution.h
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef AC_CONVOLUTION_H
+#define AC_CONVOLUTION_H
+
+
+#include <cstddef>
+
+
+namespace Ac
+{
+
+
+/**
+\brief Convolves the input signal with the kernel (FIR filter) and writes only the outputs for which the kernel fully overlaps the input.
+\param[in] input Pointer to the input signal. This must contain 'outputSize + kernelSize - 1' elements, i.e. the caller provides the padding.
+\param[in] outputSize Specifies the number of output samples.
+\param[in] kernel Pointer to the filter coefficients. This must contain 'kernelSize' elements.
+\param[in] kernelSize Specifies the number of filter coefficients.
+\param[out] output Pointer to the output samples, where 'output[n] = sum(kernel[k] * input[n + kernelSize - 1 - k])'. This must not overlap the input.
+\remarks Kernels with few non-zero coefficients are applied directly with the vector kernels (one scaled accumulation per coefficient),
+all other kernels with the FFT block convolution (overlap-save), whose costs grow only logarithmically with the kernel size.
+*/
+void ConvolveValid(const float* input, std::size_t outputSize, const float* kernel, std::size_t kernelSize, float* output);
+
+//! Convolves the input signal directly with the kernel, regardless of its size. \see ConvolveValid
+void ConvolveValidDirect(const float* input, std::size_t outputSize, const float* kernel, std::size_t kernelSize, float* output);
+
+//! Convolves the input signal with the FFT block convolution, regardless of the kernel size. \see ConvolveValid
+void ConvolveValidFFT(const float* input, std::size_t outputSize, const float* kernel, std::size_t kernelSize, float* output);
+
+
+} // /namespace Ac
+
+
+#endif
+
+
+
+// ================================================================================
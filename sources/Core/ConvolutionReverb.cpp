@@ -0,0 +1,304 @@
+/*
+ * ConvolutionReverb.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include <Ac/ConvolutionReverb.h>
+#include <algorithm>
+#include <stdexcept>
+
+
+namespace Ac
+{
+
+
+// Number of partitions of each level (except the last level, which covers the rest of the IR).
+static const std::size_t partitionsPerLevel = 4;
+
+// Factor by which the partition size grows from one level to the next.
+static const std::size_t levelGrowth = 4;
+
+// Maximal partition size, to bound the memory of the FFT frames and the costs of single blocks.
+static const std::size_t maxPartitionSize = 16384;
+
+// Number of sample frames which are read from the IR at once.
+static const std::size_t irBlockSize = 4096;
+
+// Accumulates the products of the complex spectra (accessed as arrays of pairs of floats, so the compiler can vectorize the loop).
+static void MultiplyAccumulate(const std::complex<float>* a, const std::complex<float>* b, std::complex<float>* accum, std::size_t count)
+{
+    const auto af = reinterpret_cast<const float*>(a);
+    const auto bf = reinterpret_cast<const float*>(b);
+    const auto cf = reinterpret_cast<float*>(accum);
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const auto ar = af[2*i], ai = af[2*i + 1];
+        const auto br = bf[2*i], bi = bf[2*i + 1];
+        cf[2*i    ] += ar*br - ai*bi;
+        cf[2*i + 1] += ar*bi + ai*br;
+    }
+}
+
+ConvolutionReverb::ConvolutionReverb(const WaveBufferConstView& impulseResponse, std::uint16_t channels, std::size_t blockSize) :
+    channels_   { channels                                  },
+    blockSize_  { blockSize                                 },
+    irChannels_ { impulseResponse.GetFormat().channels      },
+    irFrames_   { impulseResponse.GetSampleFrames()         },
+    sampleRate_ { impulseResponse.GetFormat().sampleRate    }
+{
+    if (channels == 0)
+        throw std::invalid_argument("number of channels of convolution reverb must not be zero");
+    if (blockSize == 0)
+        throw std::invalid_argument("block size of convolution reverb must not be zero");
+    if (irChannels_ == 0)
+        throw std::invalid_argument("number of channels of impulse response for convolution reverb must not be zero");
+
+    InitLevels(impulseResponse);
+
+    /* Allocate the input history, which holds the last two blocks of the largest partitions, and is shifted only every other block of them */
+    history_.resize(channels, std::vector<float>(maxBlockSize_ * 4, 0.0f));
+    accum_.resize(channels, std::vector<float>(maxBlockSize_, 0.0f));
+    output_.resize(channels, std::vector<float>(blockSize_, 0.0f));
+    frame_.resize(maxBlockSize_ * 2);
+    spectrum_.resize(maxBlockSize_ + 1);
+
+    Reset();
+}
+
+void ConvolutionReverb::Process(float* samples, std::size_t frames)
+{
+    for (std::size_t offset = 0; offset < frames;)
+    {
+        /* Exchange the input samples with the output samples of the previous block */
+        const auto n = std::min(blockSize_ - blockPosition_, frames - offset);
+
+        for (std::uint16_t c = 0; c < channels_; ++c)
+        {
+            auto input  = history_[c].data() + historyEnd_ - blockSize_ + blockPosition_;
+            auto output = output_[c].data() + blockPosition_;
+            auto sample = samples + offset * channels_ + c;
+
+            for (std::size_t i = 0; i < n; ++i, sample += channels_)
+            {
+                input[i] = *sample;
+                *sample = output[i];
+            }
+        }
+
+        blockPosition_  += n;
+        offset          += n;
+
+        if (blockPosition_ == blockSize_)
+        {
+            ProcessBlock();
+            blockPosition_ = 0;
+        }
+    }
+}
+
+void ConvolutionReverb::Reset()
+{
+    for (auto& level : levels_)
+    {
+        for (auto& spectra : level.inputSpectra)
+            std::fill(spectra.begin(), spectra.end(), std::complex<float>(0.0f));
+        level.position = 0;
+    }
+
+    for (std::uint16_t c = 0; c < channels_; ++c)
+    {
+        std::fill(history_[c].begin(), history_[c].end(), 0.0f);
+        std::fill(accum_[c].begin(), accum_[c].end(), 0.0f);
+        std::fill(output_[c].begin(), output_[c].end(), 0.0f);
+    }
+
+    historyEnd_     = maxBlockSize_ * 2;
+    accumPosition_  = 0;
+    blockPosition_  = 0;
+    blockCounter_   = 0;
+}
+
+std::uint16_t ConvolutionReverb::GetChannels() const
+{
+    return channels_;
+}
+
+std::size_t ConvolutionReverb::GetLatency() const
+{
+    return blockSize_;
+}
+
+std::size_t ConvolutionReverb::GetTailFrames() const
+{
+    return irFrames_;
+}
+
+
+/*
+ * ======= Private: =======
+ */
+
+/*
+Each level convolves the input with a segment of the IR, which is preceded by 'delay' zeros.
+Since a level with the partition size 'size' outputs its samples 'size' frames after the input,
+the delay is 'offset + blockSize - size', so that all levels share the latency of a single block.
+The delay is never negative, because the previous levels cover at least three partitions of the next size.
+*/
+void ConvolutionReverb::InitLevels(const WaveBufferConstView& impulseResponse)
+{
+    /* Read the IR into one array per channel */
+    std::vector<std::vector<float>> ir(irChannels_, std::vector<float>(irFrames_));
+    std::vector<float> block(irBlockSize * irChannels_);
+
+    for (std::size_t offset = 0; offset < irFrames_; offset += irBlockSize)
+    {
+        auto n = impulseResponse.ReadFrames(offset, std::min(irBlockSize, irFrames_ - offset), block.data());
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            for (std::uint16_t c = 0; c < irChannels_; ++c)
+                ir[c][offset + i] = block[i * irChannels_ + c];
+        }
+    }
+
+    /* Split the IR into levels of growing partition sizes */
+    maxBlockSize_ = blockSize_;
+
+    for (std::size_t offset = 0, size = blockSize_; offset < irFrames_; size *= levelGrowth)
+    {
+        const auto isLast   = (size * levelGrowth > maxPartitionSize);
+        const auto delay    = offset + blockSize_ - size;
+        const auto length   = (isLast ? irFrames_ - offset : std::min(irFrames_ - offset, partitionsPerLevel * size - delay));
+
+        Level level;
+        {
+            level.blockSize     = size;
+            level.numPartitions = (delay + length + size - 1) / size;
+            level.plan          = RealFFTPlan::Get(size * 2);
+        }
+
+        const auto numBins  = level.plan->GetNumBins();
+        const auto scale    = 1.0f / static_cast<float>(size * 2);
+
+        /* Transform the zero-padded partitions (and include the normalization of the inverse transform) */
+        level.kernelSpectra.resize(irChannels_, std::vector<std::complex<float>>(level.numPartitions * numBins));
+        level.kernelNonZero.resize(irChannels_, std::vector<bool>(level.numPartitions, false));
+
+        std::vector<float> frame(size * 2);
+
+        for (std::uint16_t c = 0; c < irChannels_; ++c)
+        {
+            for (std::size_t p = 0; p < level.numPartitions; ++p)
+            {
+                std::fill(frame.begin(), frame.end(), 0.0f);
+
+                for (std::size_t i = 0; i < size; ++i)
+                {
+                    auto index = p * size + i;
+                    if (index >= delay && index - delay < length)
+                        frame[i] = ir[c][offset + index - delay] * scale;
+                }
+
+                level.kernelNonZero[c][p] = std::any_of(frame.begin(), frame.end(), [](float x) { return x != 0.0f; });
+                level.plan->Forward(frame.data(), level.kernelSpectra[c].data() + p * numBins);
+            }
+        }
+
+        level.inputSpectra.resize(channels_, std::vector<std::complex<float>>(level.numPartitions * numBins));
+
+        levels_.push_back(std::move(level));
+
+        maxBlockSize_   = size;
+        offset          += length;
+    }
+}
+
+void ConvolutionReverb::ProcessBlock()
+{
+    /* Process all levels whose input block is complete (each level adds its output to the pending output samples) */
+    blockCounter_   = (blockCounter_ + 1) % (maxBlockSize_ / blockSize_);
+    accumPosition_  = blockCounter_ * blockSize_;
+
+    for (auto& level : levels_)
+    {
+        if (accumPosition_ % level.blockSize == 0)
+            ProcessLevel(level);
+    }
+
+    for (std::uint16_t c = 0; c < channels_; ++c)
+    {
+        /* Take the next output block and mix it with the delayed input block */
+        auto accum  = accum_[c].data() + accumPosition_;
+        auto input  = history_[c].data() + historyEnd_ - blockSize_;
+        auto output = output_[c].data();
+
+        for (std::size_t i = 0; i < blockSize_; ++i)
+        {
+            output[i] = accum[i] + dryGain_ * input[i];
+            accum[i] = 0.0f;
+        }
+
+        /* Move the latest samples to the front when the history is full */
+        if (historyEnd_ + blockSize_ > history_[c].size())
+        {
+            auto& history = history_[c];
+            std::copy(history.begin() + (historyEnd_ - maxBlockSize_ * 2 + blockSize_), history.begin() + historyEnd_, history.begin());
+        }
+    }
+
+    if (historyEnd_ + blockSize_ > maxBlockSize_ * 4)
+        historyEnd_ = maxBlockSize_ * 2;
+    else
+        historyEnd_ += blockSize_;
+}
+
+void ConvolutionReverb::ProcessLevel(Level& level)
+{
+    const auto size     = level.blockSize;
+    const auto numBins  = level.plan->GetNumBins();
+
+    level.position = (level.position + 1) % level.numPartitions;
+
+    for (std::uint16_t c = 0; c < channels_; ++c)
+    {
+        /* Transform the last two input blocks of this level (overlap-save) */
+        auto& inputSpectra = level.inputSpectra[c];
+        level.plan->Forward(history_[c].data() + historyEnd_ - size * 2, inputSpectra.data() + level.position * numBins);
+
+        /* Accumulate the products of the input spectra with the partitions, where the latest input belongs to the first partition */
+        const auto irc = c % irChannels_;
+        std::fill(spectrum_.begin(), spectrum_.begin() + numBins, std::complex<float>(0.0f));
+
+        for (std::size_t p = 0; p < level.numPartitions; ++p)
+        {
+            if (level.kernelNonZero[irc][p])
+            {
+                auto index = (level.position + level.numPartitions - p) % level.numPartitions;
+                MultiplyAccumulate(
+                    inputSpectra.data() + index * numBins,
+                    level.kernelSpectra[irc].data() + p * numBins,
+                    spectrum_.data(),
+                    numBins
+                );
+            }
+        }
+
+        /* Transform back and add the last block (the valid part of the circular convolution) to the pending output samples */
+        level.plan->Inverse(spectrum_.data(), frame_.data());
+
+        auto accum = accum_[c].data() + accumPosition_;
+        auto frame = frame_.data() + size;
+
+        for (std::size_t i = 0; i < size; ++i)
+            accum[i] += wetGain_ * frame[i];
+    }
+}
+
+
+} // /namespace Ac
+
+
+
+// ================================================================================
@@ -0,0 +1,128 @@
+/*
+ * CrossfadeCurve.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include <Ac/CrossfadeCurve.h>
+#include "VectorKernels.h"
+#include <algorithm>
+#include <cmath>
+
+
+namespace Ac
+{
+
+
+static const double pi = 3.14159265358979323846;
+
+// Number of sample frames whose gains are computed at once.
+static const std::size_t blendBlockSize = 256;
+
+CrossfadeCurve::CrossfadeCurve(const CrossfadeShape shape) :
+    fadeOut_ ( tableSize + 1 ),
+    fadeIn_  ( tableSize + 1 )
+{
+    for (std::size_t i = 0; i <= tableSize; ++i)
+    {
+        auto t = static_cast<double>(i) / static_cast<double>(tableSize);
+
+        switch (shape)
+        {
+            case CrossfadeShape::Linear:
+                fadeOut_[i] = static_cast<float>(1.0 - t);
+                fadeIn_[i]  = static_cast<float>(t);
+                break;
+
+            case CrossfadeShape::EqualPower:
+                fadeOut_[i] = static_cast<float>(std::cos(t * pi * 0.5));
+                fadeIn_[i]  = static_cast<float>(std::sin(t * pi * 0.5));
+                break;
+
+            case CrossfadeShape::SCurve:
+                fadeIn_[i]  = static_cast<float>(0.5 - 0.5 * std::cos(t * pi));
+                fadeOut_[i] = 1.0f - fadeIn_[i];
+                break;
+        }
+    }
+
+    /* Make both ends exact, so the signals are not mixed before and after the crossfade */
+    fadeOut_.front()    = 1.0f;
+    fadeOut_.back()     = 0.0f;
+    fadeIn_.front()     = 0.0f;
+    fadeIn_.back()      = 1.0f;
+}
+
+CrossfadeCurve::CrossfadeCurve(const std::function<void(double& t)>& fading) :
+    fadeOut_ ( tableSize + 1 ),
+    fadeIn_  ( tableSize + 1 )
+{
+    for (std::size_t i = 0; i <= tableSize; ++i)
+    {
+        auto t = static_cast<double>(i) / static_cast<double>(tableSize);
+        if (fading)
+            fading(t);
+
+        fadeOut_[i] = static_cast<float>(1.0 - t);
+        fadeIn_[i]  = static_cast<float>(t);
+    }
+}
+
+void CrossfadeCurve::ComputeGains(double position, double step, std::size_t frames, float* gainsFrom, float* gainsTo) const
+{
+    const auto scale = static_cast<double>(tableSize);
+
+    for (std::size_t i = 0; i < frames; ++i)
+    {
+        /* Clamp position to the table and interpolate between the two nearest entries */
+        auto x      = std::max(0.0, std::min((position + step * static_cast<double>(i)) * scale, scale));
+        auto index  = std::min(static_cast<std::size_t>(x), tableSize - 1);
+        auto f      = static_cast<float>(x - static_cast<double>(index));
+
+        gainsFrom[i]    = fadeOut_[index] + f * (fadeOut_[index + 1] - fadeOut_[index]);
+        gainsTo[i]      = fadeIn_[index] + f * (fadeIn_[index + 1] - fadeIn_[index]);
+    }
+}
+
+void CrossfadeCurve::Blend(
+    float*          output,
+    const float*    from,
+    const float*    to,
+    std::size_t     frames,
+    std::uint16_t   channels,
+    double          position,
+    double          step) const
+{
+    float gainsFrom[blendBlockSize], gainsTo[blendBlockSize];
+
+    for (std::size_t offset = 0; offset < frames; offset += blendBlockSize)
+    {
+        const auto n        = std::min(blendBlockSize, frames - offset);
+        const auto samples  = offset * channels;
+
+        ComputeGains(position + step * static_cast<double>(offset), step, n, gainsFrom, gainsTo);
+        CrossfadeFrames(output + samples, from + samples, to + samples, n, channels, gainsFrom, gainsTo);
+    }
+}
+
+float CrossfadeCurve::GetFadeOutGain(double position) const
+{
+    float gainFrom, gainTo;
+    ComputeGains(position, 0.0, 1, &gainFrom, &gainTo);
+    return gainFrom;
+}
+
+float CrossfadeCurve::GetFadeInGain(double position) const
+{
+    float gainFrom, gainTo;
+    ComputeGains(position, 0.0, 1, &gainFrom, &gainTo);
+    return gainTo;
+}
+
+
+} // /namespace Ac
+
+
+
+// ================================================================================
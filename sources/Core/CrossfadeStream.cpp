@@ -0,0 +1,128 @@
+/*
+ * CrossfadeStream.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include <Ac/CrossfadeStream.h>
+#include <Ac/EffectStream.h>
+#include <algorithm>
+#include <stdexcept>
+
+
+namespace Ac
+{
+
+
+CrossfadeStream::CrossfadeStream(const std::shared_ptr<AudioStream>& source) :
+    source_ { source }
+{
+    if (!source)
+        throw std::invalid_argument("source of crossfade stream must not be null");
+}
+
+void CrossfadeStream::CrossfadeTo(const std::shared_ptr<AudioStream>& source, double duration, const CrossfadeCurve& curve)
+{
+    if (!source)
+        throw std::invalid_argument("source of crossfade stream must not be null");
+
+    const auto format = GetFormat();
+    if (source->GetFormat() != format)
+        throw std::invalid_argument("format of new source stream does not match the crossfade stream");
+
+    CompleteCrossfade();
+
+    /* Switch immediately if the crossfade is shorter than one sample frame */
+    auto frames = static_cast<std::size_t>(std::max(0.0, duration) * static_cast<double>(format.sampleRate) + 0.5);
+    if (frames == 0)
+    {
+        source_ = source;
+        return;
+    }
+
+    nextSource_ = source;
+    curve_      = curve;
+    fadeFrames_ = frames;
+    fadeFrame_  = 0;
+
+    if (nextBuffer_.GetFormat() != format)
+        nextBuffer_ = WaveBuffer(format);
+}
+
+void CrossfadeStream::CompleteCrossfade()
+{
+    if (nextSource_)
+    {
+        source_ = nextSource_;
+        nextSource_.reset();
+    }
+}
+
+std::size_t CrossfadeStream::StreamWaveBuffer(const WaveBufferView& buffer)
+{
+    /* Pass the current source through if no crossfade is in progress */
+    if (!nextSource_)
+        return source_->StreamWaveBuffer(buffer);
+
+    /* Validate buffer storage and format */
+    const auto format = GetFormat();
+    if (buffer.GetStorage() != WaveBufferStorage::Interleaved || buffer.GetFormat() != format)
+        throw std::invalid_argument("storage or format of wave buffer view does not match the crossfade stream");
+
+    const auto bytesPerFrame = std::max(std::size_t(1u), format.BytesPerFrame());
+
+    /* Read the current source into the output, and the same number of sample frames from the new source (the whole view if the current source has ended) */
+    auto framesFrom = source_->StreamWaveBuffer(buffer) / bytesPerFrame;
+    auto framesTo   = ReadStreamFrames(*nextSource_, nextBuffer_, framesFrom > 0 ? framesFrom : buffer.GetSampleFrames());
+    auto frames     = std::max(framesFrom, framesTo);
+
+    /* Crossfade both sources, where the missing sample frames of an ended source are silent */
+    const auto samples = frames * format.channels;
+
+    samplesFrom_.resize(samples);
+    samplesTo_.resize(samples);
+
+    std::fill(samplesFrom_.begin() + buffer.ReadFrames(0, framesFrom, samplesFrom_.data()) * format.channels, samplesFrom_.begin() + samples, 0.0f);
+    std::fill(samplesTo_.begin() + WaveBufferConstView(nextBuffer_).ReadFrames(0, framesTo, samplesTo_.data()) * format.channels, samplesTo_.begin() + samples, 0.0f);
+
+    const auto step = 1.0 / static_cast<double>(fadeFrames_);
+    curve_.Blend(samplesFrom_.data(), samplesFrom_.data(), samplesTo_.data(), frames, format.channels, static_cast<double>(fadeFrame_) * step, step);
+
+    buffer.WriteFrames(0, frames, samplesFrom_.data());
+
+    /* Continue with the new source only, once the crossfade is complete or both sources have ended */
+    fadeFrame_ += frames;
+    if (fadeFrame_ >= fadeFrames_ || frames == 0)
+        CompleteCrossfade();
+
+    return (frames * bytesPerFrame);
+}
+
+void CrossfadeStream::Seek(double timePoint)
+{
+    CompleteCrossfade();
+    source_->Seek(timePoint);
+}
+
+double CrossfadeStream::TotalTime() const
+{
+    return (nextSource_ ? nextSource_->TotalTime() : source_->TotalTime());
+}
+
+std::vector<std::string> CrossfadeStream::InfoComments() const
+{
+    return (nextSource_ ? nextSource_->InfoComments() : source_->InfoComments());
+}
+
+WaveBufferFormat CrossfadeStream::GetFormat() const
+{
+    return source_->GetFormat();
+}
+
+
+} // /namespace Ac
+
+
+
+// ================================================================================
@@ -0,0 +1,151 @@
+/*
+ * Ducker.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include <Ac/Ducker.h>
+#include <Ac/EffectStream.h>
+#include <Ac/WaveBufferView.h>
+#include "Dynamics.h"
+#include "VectorKernels.h"
+#include <algorithm>
+#include <stdexcept>
+
+
+namespace Ac
+{
+
+
+Ducker::Ducker(
+    std::uint32_t               sampleRate,
+    std::uint16_t               channels,
+    std::uint16_t               sidechainChannels,
+    const DuckerParameters&     parameters) :
+        sampleRate_         { sampleRate        },
+        channels_           { channels          },
+        sidechainChannels_  { sidechainChannels }
+{
+    if (sampleRate == 0)
+        throw std::invalid_argument("sample rate of ducker must not be zero");
+    if (channels == 0 || sidechainChannels == 0)
+        throw std::invalid_argument("number of channels of ducker must not be zero");
+
+    levels_.resize(dynamicsBlockSize);
+
+    SetParameters(parameters);
+}
+
+void Ducker::ProcessSidechain(float* samples, const float* sidechain, std::size_t frames)
+{
+    const auto threshold    = static_cast<float>(parameters_.threshold);
+    const auto depth        = static_cast<float>(parameters_.depth);
+    const auto rangeFactor  = static_cast<float>(parameters_.range > 0.0 ? 1.0 / parameters_.range : 1.0e+6);
+
+    auto levels = levels_.data();
+
+    for (std::size_t offset = 0; offset < frames; offset += dynamicsBlockSize)
+    {
+        const auto n = std::min(dynamicsBlockSize, frames - offset);
+
+        /* Detect peak levels of the sidechain and map them to the attenuation (in dB) */
+        FramePeaks(sidechain + offset * sidechainChannels_, n, sidechainChannels_, levels);
+        AmplitudesToDecibels(levels, n);
+
+        for (std::size_t i = 0; i < n; ++i)
+            levels[i] = depth * ClampValue((levels[i] - threshold) * rangeFactor, 0.0f, 1.0f);
+
+        /* Apply attack and release, and convert attenuation to linear gains */
+        FollowEnvelopes(levels, n, &envelope_, 1, attack_, release_);
+
+        for (std::size_t i = 0; i < n; ++i)
+            levels[i] = -levels[i];
+
+        DecibelsToAmplitudes(levels, n);
+
+        ScaleFrames(samples + offset * channels_, n, channels_, levels);
+    }
+}
+
+void Ducker::Process(float* samples, std::size_t frames)
+{
+    for (std::size_t offset = 0; offset < frames; offset += dynamicsBlockSize)
+    {
+        const auto n = std::min(dynamicsBlockSize, frames - offset);
+        ReadSidechain(n);
+        ProcessSidechain(samples + offset * channels_, sidechainSamples_.data(), n);
+    }
+}
+
+void Ducker::Reset()
+{
+    envelope_       = 0.0f;
+    sidechainEnded_ = false;
+}
+
+std::uint16_t Ducker::GetChannels() const
+{
+    return channels_;
+}
+
+void Ducker::SetSidechainSource(const std::shared_ptr<AudioStream>& source)
+{
+    if (source)
+    {
+        const auto format = source->GetFormat();
+        if (format.sampleRate != sampleRate_ || format.channels != sidechainChannels_)
+            throw std::invalid_argument("sample rate or number of channels of sidechain stream does not match the ducker");
+        sidechainBuffer_ = WaveBuffer(format);
+    }
+    else
+        sidechainBuffer_ = WaveBuffer();
+
+    sidechainSource_    = source;
+    sidechainEnded_     = false;
+}
+
+void Ducker::SetParameters(const DuckerParameters& parameters)
+{
+    parameters_ = parameters;
+
+    parameters_.depth       = std::max(0.0, parameters_.depth);
+    parameters_.range       = std::max(0.0, parameters_.range);
+    parameters_.attackTime  = std::max(0.0, parameters_.attackTime);
+    parameters_.releaseTime = std::max(0.0, parameters_.releaseTime);
+
+    attack_     = SmoothingCoefficient(parameters_.attackTime, sampleRate_);
+    release_    = SmoothingCoefficient(parameters_.releaseTime, sampleRate_);
+}
+
+float Ducker::GetGainReduction() const
+{
+    return envelope_;
+}
+
+
+/*
+ * ======= Private: =======
+ */
+
+// Reads the next sample frames of the sidechain stream, or silence if there is no sidechain stream or it has ended.
+void Ducker::ReadSidechain(std::size_t frames)
+{
+    sidechainSamples_.assign(frames * sidechainChannels_, 0.0f);
+
+    if (!sidechainSource_ || sidechainEnded_)
+        return;
+
+    auto framesRead = ReadStreamFrames(*sidechainSource_, sidechainBuffer_, frames);
+    if (framesRead < frames)
+        sidechainEnded_ = true;
+
+    WaveBufferConstView(sidechainBuffer_).ReadFrames(0, framesRead, sidechainSamples_.data());
+}
+
+
+} // /namespace Ac
+
+
+
+// ================================================================================
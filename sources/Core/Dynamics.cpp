@@ -0,0 +1,105 @@
+/*
+ * Dynamics.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "Dynamics.h"
+#include <cmath>
+#include <cstring>
+
+
+namespace Ac
+{
+
+
+// Decibels per octave of amplitude, i.e. '20 * log10(2)'.
+static const float decibelsPerOctave = 6.0205999f;
+
+// Smallest amplitude which is converted to decibels (-200 dB).
+static const float minAmplitude = 1.0e-10f;
+
+/*
+The logarithm and the exponential function are approximated with the exponent bits of the floating-points and a polynomial for the remainder.
+In contrast to std::log10 and std::pow, these loops have no function calls, so the compiler vectorizes them.
+*/
+
+void AmplitudesToDecibels(float* values, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        /* Split amplitude into exponent and mantissa in [1, 2) */
+        auto x = MaxValue(values[i], minAmplitude);
+
+        std::int32_t bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+
+        /* Move mantissa into [sqrt(1/2), sqrt(2)), so the series below converges quickly (0x3504F3 are the fraction bits of sqrt(2)) */
+        auto fraction   = (bits & 0x007FFFFF);
+        auto upper      = static_cast<std::int32_t>(fraction > 0x003504F3);
+        auto exponent   = ((bits >> 23) & 0xFF) - 127 + upper;
+
+        bits = fraction | (0x3F800000 - (upper << 23));
+
+        float mantissa;
+        std::memcpy(&mantissa, &bits, sizeof(mantissa));
+
+        /* log2(m) = 2/ln(2) * atanh((m - 1)/(m + 1)) */
+        auto t  = (mantissa - 1.0f) / (mantissa + 1.0f);
+        auto t2 = t * t;
+        auto l  = t * (2.8853901f + t2 * (0.9617967f + t2 * (0.5770780f + t2 * 0.4121986f)));
+
+        values[i] = (static_cast<float>(exponent) + l) * decibelsPerOctave;
+    }
+}
+
+void DecibelsToAmplitudes(float* values, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        /* Split octaves into an integral part and a remainder in [-0.5, 0.5] */
+        auto x = ClampValue(values[i] / decibelsPerOctave, -126.0f, 126.0f);
+        auto e = static_cast<std::int32_t>(x + 128.5f) - 128;
+        auto f = x - static_cast<float>(e);
+
+        /* 2^f with the Taylor series, 2^e with the exponent bits */
+        auto p = 1.0f + f * (0.69314718f + f * (0.24022651f + f * (0.05550411f + f * (0.00961813f + f * 0.00133336f))));
+
+        auto bits = static_cast<std::int32_t>((e + 127) << 23);
+        float scale;
+        std::memcpy(&scale, &bits, sizeof(scale));
+
+        values[i] = p * scale;
+    }
+}
+
+float SmoothingCoefficient(double time, std::uint32_t sampleRate)
+{
+    if (time > 0.0 && sampleRate > 0)
+        return static_cast<float>(std::exp(-1.0 / (time * static_cast<double>(sampleRate))));
+    return 0.0f;
+}
+
+void FollowEnvelopes(float* values, std::size_t frames, float* envelopes, std::size_t lanes, float attack, float release)
+{
+    for (std::size_t i = 0; i < frames; ++i, values += lanes)
+    {
+        for (std::size_t lane = 0; lane < lanes; ++lane)
+        {
+            auto x = values[lane];
+            auto e = envelopes[lane];
+            auto c = (x > e ? attack : release);
+            e = x + c * (e - x);
+            envelopes[lane] = e;
+            values[lane] = e;
+        }
+    }
+}
+
+
+} // /namespace Ac
+
+
+
+// ================================================================================
@@ -0,0 +1,109 @@
+/*
+ * Dynamics.h
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef AC_DYNAMICS_H
+#define AC_DYNAMICS_H
+
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+
+namespace Ac
+{
+
+
+/*
+Building blocks of the dynamics processors (Compressor, Limiter, Ducker).
+The processors work on blocks of sample frames: the levels of a block are detected, converted, and applied
+with loops over the whole block, so only the envelope follower remains a recursion from sample to sample.
+*/
+
+// Number of sample frames which the dynamics processors process at once.
+static const std::size_t dynamicsBlockSize = 256;
+
+/*
+Floating-point comparisons within loops are not vectorized by the compiler unless trapping math is disabled.
+Hence, the following functions clamp the values as integers: the floating-point bits are mapped to integers in the
+same order (the negative values are reflected), which are compared and then mapped back (the mapping is its own inverse).
+*/
+
+// Maps the bits of the floating-point value to an integer with the same order, and vice versa.
+inline std::int32_t OrderedFloatBits(std::int32_t bits)
+{
+    return (bits ^ ((bits >> 31) & 0x7FFFFFFF));
+}
+
+//! Returns the specified value clamped to the range [lo, hi]. The values must not be NaN.
+inline float ClampValue(float x, float lo, float hi)
+{
+    std::int32_t bits[3];
+    std::memcpy(&bits[0], &x, sizeof(float));
+    std::memcpy(&bits[1], &lo, sizeof(float));
+    std::memcpy(&bits[2], &hi, sizeof(float));
+
+    auto k = OrderedFloatBits(bits[0]);
+    auto l = OrderedFloatBits(bits[1]);
+    auto h = OrderedFloatBits(bits[2]);
+
+    k = (k < l ? l : k);
+    k = (k > h ? h : k);
+    k = OrderedFloatBits(k);
+
+    float y;
+    std::memcpy(&y, &k, sizeof(float));
+    return y;
+}
+
+//! Returns the maximum of the specified values. The values must not be NaN.
+inline float MaxValue(float x, float lo)
+{
+    std::int32_t bits[2];
+    std::memcpy(&bits[0], &x, sizeof(float));
+    std::memcpy(&bits[1], &lo, sizeof(float));
+
+    auto k = OrderedFloatBits(bits[0]);
+    auto l = OrderedFloatBits(bits[1]);
+
+    k = OrderedFloatBits(k < l ? l : k);
+
+    float y;
+    std::memcpy(&y, &k, sizeof(float));
+    return y;
+}
+
+//! Converts the linear amplitudes to decibels in place. Amplitudes below -200 dB are clamped. The error is below 0.0001 dB.
+void AmplitudesToDecibels(float* values, std::size_t n);
+
+//! Converts the decibels to linear amplitudes in place. The relative error is below 0.00001.
+void DecibelsToAmplitudes(float* values, std::size_t n);
+
+//! Returns the coefficient of a one-pole smoothing filter, which reaches about 63% of a step after the specified time (in seconds).
+float SmoothingCoefficient(double time, std::uint32_t sampleRate);
+
+/**
+\brief Replaces the interleaved values of several lanes (e.g. unlinked channels) by their envelopes.
+\param[in,out] values Interleaved values, i.e. 'frames * lanes' values.
+\param[in] frames Specifies the number of values of each lane.
+\param[in,out] envelopes Envelopes of all lanes, which are kept between the blocks. This must have 'lanes' elements.
+\param[in] lanes Specifies the number of lanes.
+\param[in] attack Specifies the coefficient (see SmoothingCoefficient) with which the envelopes approach rising values.
+\param[in] release Specifies the coefficient with which the envelopes approach falling values.
+\remarks The loop over the lanes of a sample frame has no dependencies, so it is vectorized when several lanes are followed.
+*/
+void FollowEnvelopes(float* values, std::size_t frames, float* envelopes, std::size_t lanes, float attack, float release);
+
+
+} // /namespace Ac
+
+
+#endif
+
+
+
+// ================================================================================
@@ -0,0 +1,165 @@
+/*
+ * EffectStream.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include <Ac/EffectStream.h>
+#include <algorithm>
+#include <stdexcept>
+
+
+namespace Ac
+{
+
+
+// Number of sample frames which are processed by the effect chain at once.
+static const std::size_t effectBlockSize = WaveBuffer::maxBlockSamples;
+
+EffectStream::EffectStream(const std::shared_ptr<AudioStream>& source) :
+    source_ { source }
+{
+    if (!source)
+        throw std::invalid_argument("source of effect stream must not be null");
+}
+
+void EffectStream::AddEffect(const std::shared_ptr<AudioEffect>& effect)
+{
+    if (!effect)
+        throw std::invalid_argument("effect of effect stream must not be null");
+    if (effect->GetChannels() != GetFormat().channels)
+        throw std::invalid_argument("number of channels of audio effect does not match the effect stream");
+
+    effects_.push_back(effect);
+}
+
+void EffectStream::ClearEffects()
+{
+    effects_.clear();
+}
+
+std::size_t EffectStream::StreamWaveBuffer(const WaveBufferView& buffer)
+{
+    /* Validate buffer storage and format */
+    if (buffer.GetStorage() != WaveBufferStorage::Interleaved || buffer.GetFormat() != GetFormat())
+        throw std::invalid_argument("storage or format of wave buffer view does not match the effect stream");
+
+    const auto bytesPerFrame = std::max(std::size_t(1u), GetFormat().BytesPerFrame());
+
+    /* Read next data chunk from the source stream */
+    std::size_t frames = 0;
+
+    if (!sourceEnded_)
+    {
+        frames = source_->StreamWaveBuffer(buffer) / bytesPerFrame;
+        if (frames == 0)
+        {
+            /* Continue with the effect tails */
+            sourceEnded_    = true;
+            tailFrames_     = GetTotalTailFrames();
+        }
+    }
+
+    if (sourceEnded_)
+    {
+        frames = std::min(buffer.GetSampleFrames(), tailFrames_);
+        tailFrames_ -= frames;
+    }
+
+    /* Process sample frames by all effects (the tails are produced from silence) */
+    const auto channels = static_cast<std::size_t>(GetFormat().channels);
+
+    buffer_.resize(effectBlockSize * channels);
+
+    for (std::size_t offset = 0; offset < frames; offset += effectBlockSize)
+    {
+        auto n = std::min(effectBlockSize, frames - offset);
+
+        if (sourceEnded_)
+            std::fill(buffer_.begin(), buffer_.begin() + n * channels, 0.0f);
+        else
+            buffer.ReadFrames(offset, n, buffer_.data());
+
+        for (const auto& effect : effects_)
+            effect->Process(buffer_.data(), n);
+
+        buffer.WriteFrames(offset, n, buffer_.data());
+    }
+
+    return (frames * bytesPerFrame);
+}
+
+void EffectStream::Seek(double timePoint)
+{
+    source_->Seek(timePoint);
+
+    for (const auto& effect : effects_)
+        effect->Reset();
+
+    sourceEnded_    = false;
+    tailFrames_     = 0;
+}
+
+double EffectStream::TotalTime() const
+{
+    auto sampleRate = GetFormat().sampleRate;
+    if (sampleRate > 0)
+        return source_->TotalTime() + static_cast<double>(GetTotalTailFrames()) / static_cast<double>(sampleRate);
+    return source_->TotalTime();
+}
+
+std::vector<std::string> EffectStream::InfoComments() const
+{
+    return source_->InfoComments();
+}
+
+WaveBufferFormat EffectStream::GetFormat() const
+{
+    return source_->GetFormat();
+}
+
+
+/*
+ * ======= Private: =======
+ */
+
+std::size_t EffectStream::GetTotalTailFrames() const
+{
+    std::size_t frames = 0;
+
+    for (const auto& effect : effects_)
+        frames += effect->GetLatency() + effect->GetTailFrames();
+
+    return frames;
+}
+
+
+/* ----- Stream reading ----- */
+
+AC_EXPORT std::size_t ReadStreamFrames(AudioStream& stream, WaveBuffer& buffer, std::size_t frames)
+{
+    const auto bytesPerFrame = std::max(std::size_t(1u), buffer.GetFormat().BytesPerFrame());
+
+    buffer.SetSampleFrames(frames);
+
+    /* Streams may return fewer sample frames than requested, so read until the block is filled or the stream has ended */
+    std::size_t framesRead = 0;
+
+    while (framesRead < frames)
+    {
+        auto n = stream.StreamWaveBuffer(WaveBufferView(buffer, framesRead, frames - framesRead)) / bytesPerFrame;
+        if (n == 0)
+            break;
+        framesRead += n;
+    }
+
+    return framesRead;
+}
+
+
+} // /namespace Ac
+
+
+
+// ================================================================================
@@ -11,12 +11,20 @@
 
 #include <algorithm>
 #include <cstdlib>
+#include <cstdint>
 
 
 namespace Ac
 {
 
 
+//! Returns true if the host system uses the little-endian byte order.
+inline bool IsHostLittleEndian()
+{
+    const std::uint16_t value = 1;
+    return (*reinterpret_cast<const unsigned char*>(&value) == 1);
+}
+
 //! Swap endianness of common type (both integral and floating-points).
 template <typename T>
 T SwapEndian(T value)
@@ -0,0 +1,372 @@
+/*
+ * FDNReverb.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include <Ac/FDNReverb.h>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+
+namespace Ac
+{
+
+namespace Synthesizer
+{
+
+
+// Maximal number of sample frames which are processed at once (the block size is also limited by the shortest delay).
+static const std::size_t maxProcessBlockSize = 64;
+
+// Delay times (in seconds) and gains of the allpass filters of the input diffusion (at full diffusion).
+static const double diffuserDelays[] = { 0.00477, 0.00360, 0.01273, 0.00931 };
+static const double diffuserGains[]  = { 0.75,    0.75,    0.625,   0.625   };
+
+// Bit masks of the signs with which the input channels are fed into the delay lines (deliberately not rows of the Hadamard matrix).
+static const std::uint32_t inputSignMasks[] = { 0x6A5C, 0x3B91, 0x4D27, 0x5E83 };
+
+static bool IsPrime(std::size_t n)
+{
+    if (n < 2)
+        return false;
+    for (std::size_t i = 2; i * i <= n; ++i)
+    {
+        if (n % i == 0)
+            return false;
+    }
+    return true;
+}
+
+static std::size_t NextPrime(std::size_t n)
+{
+    while (!IsPrime(n))
+        ++n;
+    return n;
+}
+
+// Returns the sign of the entry in the specified row and column of the Hadamard matrix (of Sylvester's construction).
+static float HadamardSign(std::size_t row, std::size_t column)
+{
+    auto bits = row & column;
+    auto parity = 0;
+    for (; bits != 0; bits &= bits - 1)
+        parity ^= 1;
+    return (parity != 0 ? -1.0f : 1.0f);
+}
+
+/*
+Returns the delay lengths (in sample frames) of the delay lines for the specified room size.
+The lengths are spread exponentially from half to one and a half of the mean delay, and are distinct primes, so the echoes rarely coincide.
+*/
+static std::vector<std::size_t> ComputeDelayLengths(std::uint32_t sampleRate, std::size_t numDelayLines, double roomSize)
+{
+    std::vector<std::size_t> delays(numDelayLines);
+
+    const auto meanDelay = (0.010 + 0.090 * roomSize) * static_cast<double>(sampleRate);
+
+    for (std::size_t i = 0; i < numDelayLines; ++i)
+    {
+        auto factor = 0.5 * std::pow(3.0, static_cast<double>(i) / static_cast<double>(numDelayLines - 1));
+        auto delay  = NextPrime(static_cast<std::size_t>(std::max(2.0, meanDelay * factor)));
+
+        if (i > 0 && delay <= delays[i - 1])
+            delay = NextPrime(delays[i - 1] + 1);
+
+        delays[i] = delay;
+    }
+
+    return delays;
+}
+
+static void ReadRingBuffer(const std::vector<float>& buffer, std::uint64_t position, float* samples, std::size_t count)
+{
+    auto start  = static_cast<std::size_t>(position % buffer.size());
+    auto n      = std::min(count, buffer.size() - start);
+    std::copy(buffer.begin() + start, buffer.begin() + start + n, samples);
+    std::copy(buffer.begin(), buffer.begin() + (count - n), samples + n);
+}
+
+static void WriteRingBuffer(std::vector<float>& buffer, std::uint64_t position, const float* samples, std::size_t count)
+{
+    auto start  = static_cast<std::size_t>(position % buffer.size());
+    auto n      = std::min(count, buffer.size() - start);
+    std::copy(samples, samples + n, buffer.begin() + start);
+    std::copy(samples + n, samples + count, buffer.begin());
+}
+
+FDNReverb::FDNReverb(
+    std::uint32_t               sampleRate,
+    std::uint16_t               channels,
+    const FDNReverbParameters&  parameters,
+    std::size_t                 numDelayLines) :
+        sampleRate_ { sampleRate },
+        channels_   { channels   }
+{
+    if (sampleRate == 0)
+        throw std::invalid_argument("sample rate of FDN reverb must not be zero");
+    if (channels == 0)
+        throw std::invalid_argument("number of channels of FDN reverb must not be zero");
+    if (numDelayLines != 8 && numDelayLines != 16)
+        throw std::invalid_argument("number of delay lines of FDN reverb must be 8 or 16");
+
+    /* Allocate delay lines for the largest room size (the delay lengths grow with the room size) */
+    delayLines_.resize(numDelayLines);
+
+    auto maxDelays = ComputeDelayLengths(sampleRate, numDelayLines, 1.0);
+    for (std::size_t i = 0; i < numDelayLines; ++i)
+        delayLines_[i].buffer.resize(maxDelays[i] + 1, 0.0f);
+
+    /* Allocate the allpass filters for each channel */
+    diffusers_.resize(channels, std::vector<Diffuser>(sizeof(diffuserDelays)/sizeof(diffuserDelays[0])));
+
+    for (auto& diffusers : diffusers_)
+    {
+        for (std::size_t i = 0; i < diffusers.size(); ++i)
+        {
+            auto& diffuser = diffusers[i];
+            diffuser.delay = std::max(std::size_t(1u), static_cast<std::size_t>(diffuserDelays[i] * sampleRate + 0.5));
+            diffuser.buffer.resize(diffuser.delay + 1, 0.0f);
+        }
+    }
+
+    /*
+    Each output channel taps the delay lines with the signs of another row of the Hadamard matrix, so the channels are decorrelated.
+    The taps and the inputs are normalized by the number of delay lines.
+    */
+    const auto scale = 1.0f / std::sqrt(static_cast<float>(numDelayLines));
+
+    outputSigns_.resize(channels * numDelayLines);
+    inputSigns_.resize(numDelayLines * channels);
+
+    for (std::size_t c = 0; c < channels; ++c)
+    {
+        auto row = 1 + c % (numDelayLines - 1);
+        auto mask = inputSignMasks[c % (sizeof(inputSignMasks)/sizeof(inputSignMasks[0]))];
+
+        for (std::size_t i = 0; i < numDelayLines; ++i)
+        {
+            outputSigns_[c * numDelayLines + i] = HadamardSign(row, i) * scale;
+            inputSigns_[i * channels + c] = (((mask >> i) & 1u) != 0 ? -scale : scale);
+        }
+    }
+
+    lineSamples_.resize(numDelayLines * maxProcessBlockSize);
+    inputSamples_.resize(channels * maxProcessBlockSize);
+    outputSamples_.resize(channels * maxProcessBlockSize);
+
+    SetParameters(parameters);
+}
+
+void FDNReverb::Process(float* samples, std::size_t frames)
+{
+    for (std::size_t offset = 0; offset < frames; offset += maxBlockSize_)
+    {
+        auto n = std::min(maxBlockSize_, frames - offset);
+        ProcessBlock(samples + offset * channels_, n);
+    }
+}
+
+void FDNReverb::Reset()
+{
+    for (auto& line : delayLines_)
+    {
+        std::fill(line.buffer.begin(), line.buffer.end(), 0.0f);
+        line.filterState = 0.0f;
+    }
+
+    for (auto& diffusers : diffusers_)
+    {
+        for (auto& diffuser : diffusers)
+            std::fill(diffuser.buffer.begin(), diffuser.buffer.end(), 0.0f);
+    }
+
+    time_ = 0;
+}
+
+std::uint16_t FDNReverb::GetChannels() const
+{
+    return channels_;
+}
+
+std::size_t FDNReverb::GetTailFrames() const
+{
+    return static_cast<std::size_t>(parameters_.decayTime * sampleRate_) + delayLines_.back().delay;
+}
+
+void FDNReverb::SetParameters(const FDNReverbParameters& parameters)
+{
+    /* Clamp parameters to their valid ranges */
+    parameters_ = parameters;
+    parameters_.roomSize    = std::max(0.0, std::min(parameters.roomSize, 1.0));
+    parameters_.decayTime   = std::max(0.01, parameters.decayTime);
+    parameters_.damping     = std::max(0.0, std::min(parameters.damping, 0.99));
+    parameters_.diffusion   = std::max(0.0, std::min(parameters.diffusion, 1.0));
+
+    /* Update delay lengths and the feedback gains, which attenuate each delay line by 60 dB after the decay time */
+    auto delays = ComputeDelayLengths(sampleRate_, delayLines_.size(), parameters_.roomSize);
+
+    maxBlockSize_ = maxProcessBlockSize;
+
+    for (std::size_t i = 0; i < delayLines_.size(); ++i)
+    {
+        auto& line = delayLines_[i];
+        line.delay  = delays[i];
+        line.gain   = static_cast<float>(std::pow(10.0, -3.0 * static_cast<double>(line.delay) / (parameters_.decayTime * sampleRate_)));
+        maxBlockSize_ = std::min(maxBlockSize_, line.delay);
+    }
+
+    for (auto& diffusers : diffusers_)
+    {
+        for (std::size_t i = 0; i < diffusers.size(); ++i)
+        {
+            auto& diffuser = diffusers[i];
+            diffuser.gain = static_cast<float>(diffuserGains[i] * parameters_.diffusion);
+            maxBlockSize_ = std::min(maxBlockSize_, diffuser.delay);
+        }
+    }
+}
+
+
+/*
+ * ======= Private: =======
+ */
+
+/*
+The block size is not larger than any delay, so the outputs of all delay lines and allpass filters for the entire block
+have been written by previous blocks, i.e. each step is a loop over the samples of the block.
+*/
+void FDNReverb::ProcessBlock(float* samples, std::size_t frames)
+{
+    const auto numLines     = delayLines_.size();
+    const auto stride       = maxProcessBlockSize;
+    const auto damping      = static_cast<float>(parameters_.damping);
+    const auto wetGain      = static_cast<float>(parameters_.wetGain);
+    const auto dryGain      = static_cast<float>(parameters_.dryGain);
+    const auto mixScale     = 1.0f / std::sqrt(static_cast<float>(numLines));
+
+    float delayed[maxProcessBlockSize];
+
+    /* Diffuse the input of each channel with a chain of allpass filters: v[n] = x[n] + g*v[n-d], y[n] = v[n-d] - g*v[n] */
+    for (std::uint16_t c = 0; c < channels_; ++c)
+    {
+        auto input = inputSamples_.data() + c * stride;
+
+        for (std::size_t i = 0; i < frames; ++i)
+            input[i] = samples[i * channels_ + c];
+
+        for (auto& diffuser : diffusers_[c])
+        {
+            const auto g = diffuser.gain;
+
+            ReadRingBuffer(diffuser.buffer, time_ + diffuser.buffer.size() - diffuser.delay, delayed, frames);
+
+            for (std::size_t i = 0; i < frames; ++i)
+            {
+                auto v = input[i] + g * delayed[i];
+                input[i] = delayed[i] - g * v;
+                delayed[i] = v;
+            }
+
+            WriteRingBuffer(diffuser.buffer, time_, delayed, frames);
+        }
+    }
+
+    /* Read the delay lines, and apply the damping (one-pole low-pass filter) and the feedback gain */
+    for (std::size_t j = 0; j < numLines; ++j)
+    {
+        auto& line = delayLines_[j];
+        auto lineSamples = lineSamples_.data() + j * stride;
+
+        ReadRingBuffer(line.buffer, time_ + line.buffer.size() - line.delay, lineSamples, frames);
+
+        auto state = line.filterState;
+        for (std::size_t i = 0; i < frames; ++i)
+        {
+            state = lineSamples[i] + damping * (state - lineSamples[i]);
+            lineSamples[i] = state * line.gain;
+        }
+        line.filterState = state;
+    }
+
+    /* Tap the delay lines for each output channel */
+    for (std::uint16_t c = 0; c < channels_; ++c)
+    {
+        auto output = outputSamples_.data() + c * stride;
+        std::fill(output, output + frames, 0.0f);
+
+        for (std::size_t j = 0; j < numLines; ++j)
+        {
+            const auto sign = outputSigns_[c * numLines + j];
+            const auto lineSamples = lineSamples_.data() + j * stride;
+
+            for (std::size_t i = 0; i < frames; ++i)
+                output[i] += sign * lineSamples[i];
+        }
+    }
+
+    /* Mix the delay lines with the fast Walsh-Hadamard transform (the butterflies operate on entire rows) */
+    for (std::size_t h = 1; h < numLines; h *= 2)
+    {
+        for (std::size_t j0 = 0; j0 < numLines; j0 += h * 2)
+        {
+            for (std::size_t j = j0; j < j0 + h; ++j)
+            {
+                auto a = lineSamples_.data() + j * stride;
+                auto b = lineSamples_.data() + (j + h) * stride;
+
+                for (std::size_t i = 0; i < frames; ++i)
+                {
+                    auto x = a[i], y = b[i];
+                    a[i] = x + y;
+                    b[i] = x - y;
+                }
+            }
+        }
+    }
+
+    /* Feed the diffused input into the delay lines and write them back */
+    for (std::size_t j = 0; j < numLines; ++j)
+    {
+        auto lineSamples = lineSamples_.data() + j * stride;
+
+        for (std::size_t i = 0; i < frames; ++i)
+            lineSamples[i] *= mixScale;
+
+        for (std::uint16_t c = 0; c < channels_; ++c)
+        {
+            const auto sign = inputSigns_[j * channels_ + c];
+            const auto input = inputSamples_.data() + c * stride;
+
+            for (std::size_t i = 0; i < frames; ++i)
+                lineSamples[i] += sign * input[i];
+        }
+
+        WriteRingBuffer(delayLines_[j].buffer, time_, lineSamples, frames);
+    }
+
+    /* Mix the reverberated signal with the input signal */
+    for (std::uint16_t c = 0; c < channels_; ++c)
+    {
+        const auto output = outputSamples_.data() + c * stride;
+
+        for (std::size_t i = 0; i < frames; ++i)
+        {
+            auto& sample = samples[i * channels_ + c];
+            sample = dryGain * sample + wetGain * output[i];
+        }
+    }
+
+    time_ += frames;
+}
+
+
+} // /namespace Synthesizer
+
+} // /namespace Ac
+
+
+
+// ================================================================================
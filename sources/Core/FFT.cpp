@@ -0,0 +1,630 @@
+/*
+ * FFT.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef _USE_MATH_DEFINES
+#define _USE_MATH_DEFINES
+#endif
+
+#include <Ac/FFT.h>
+#include "WindowFunctions.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+
+
+namespace Ac
+{
+
+
+typedef std::complex<float> Complex;
+
+// Minimal stride of a Stockham pass for which the inner loop runs over the stride (otherwise it runs over the twiddle factors).
+static const std::size_t minInnerStride = 4;
+
+static const double pi = 3.14159265358979323846;
+
+/* ----- Window functions ----- */
+
+AC_EXPORT std::vector<float> GenerateWindow(const WindowFunction windowFunction, std::size_t size, bool periodic)
+{
+    std::vector<float> window(size, 1.0f);
+
+    /* The periodic window is the symmetric window with one more weight */
+    const auto windowSize = (periodic ? size + 1 : size);
+
+    switch (windowFunction)
+    {
+        case WindowFunction::Rectangular:
+            break;
+
+        case WindowFunction::Hann:
+            for (std::size_t i = 0; i < size; ++i)
+                window[i] = static_cast<float>(WindowFunctions::HannWindow<double>(i, windowSize));
+            break;
+
+        case WindowFunction::Blackman:
+            for (std::size_t i = 0; i < size; ++i)
+                window[i] = static_cast<float>(WindowFunctions::BlackmanWindow<double>(i, windowSize));
+            break;
+    }
+
+    /* A window of a single weight is always 1 */
+    if (size == 1)
+        window[0] = 1.0f;
+
+    return window;
+}
+
+/* ----- Butterflies ----- */
+
+// Returns the product of the complex numbers (the operator of std::complex handles NaN and is slow).
+static inline Complex Mul(const Complex& a, const Complex& b)
+{
+    return Complex(a.real()*b.real() - a.imag()*b.imag(), a.real()*b.imag() + a.imag()*b.real());
+}
+
+// Returns the complex number rotated by -90 degrees for the forward transform, or by +90 degrees for the inverse transform.
+template <bool Inverse>
+static inline Complex RotateQuarter(const Complex& a)
+{
+    return (Inverse ? Complex(-a.imag(), a.real()) : Complex(a.imag(), -a.real()));
+}
+
+// Returns the twiddle factor for the transform direction.
+template <bool Inverse>
+static inline Complex Twiddle(const Complex& w)
+{
+    return (Inverse ? std::conj(w) : w);
+}
+
+// Rotates the complex number (given by its real and imaginary parts) like the other "RotateQuarter" function.
+template <bool Inverse>
+static inline void RotateQuarter(float& re, float& im)
+{
+    auto t = re;
+    if (Inverse)
+    {
+        re = -im;
+        im = t;
+    }
+    else
+    {
+        re = im;
+        im = -t;
+    }
+}
+
+/*
+The butterflies work on separate arrays of real and imaginary parts (rather than std::complex),
+so the compiler can vectorize the Stockham passes over consecutive butterflies.
+*/
+template <std::size_t Radix, bool Inverse>
+struct Butterfly;
+
+template <bool Inverse>
+struct Butterfly<2, Inverse>
+{
+    static inline void Apply(float* re, float* im)
+    {
+        auto tr = re[1], ti = im[1];
+        re[1] = re[0] - tr;
+        im[1] = im[0] - ti;
+        re[0] = re[0] + tr;
+        im[0] = im[0] + ti;
+    }
+};
+
+template <bool Inverse>
+struct Butterfly<3, Inverse>
+{
+    static inline void Apply(float* re, float* im)
+    {
+        const float sin60 = 0.866025403784438647f;
+
+        auto t1r = re[1] + re[2], t1i = im[1] + im[2];
+        auto t2r = re[0] - t1r*0.5f, t2i = im[0] - t1i*0.5f;
+        auto t3r = (re[1] - re[2])*sin60, t3i = (im[1] - im[2])*sin60;
+        RotateQuarter<Inverse>(t3r, t3i);
+
+        re[0] = re[0] + t1r;
+        im[0] = im[0] + t1i;
+        re[1] = t2r + t3r;
+        im[1] = t2i + t3i;
+        re[2] = t2r - t3r;
+        im[2] = t2i - t3i;
+    }
+};
+
+template <bool Inverse>
+struct Butterfly<4, Inverse>
+{
+    static inline void Apply(float* re, float* im)
+    {
+        auto t0r = re[0] + re[2], t0i = im[0] + im[2];
+        auto t1r = re[0] - re[2], t1i = im[0] - im[2];
+        auto t2r = re[1] + re[3], t2i = im[1] + im[3];
+        auto t3r = re[1] - re[3], t3i = im[1] - im[3];
+        RotateQuarter<Inverse>(t3r, t3i);
+
+        re[0] = t0r + t2r;
+        im[0] = t0i + t2i;
+        re[1] = t1r + t3r;
+        im[1] = t1i + t3i;
+        re[2] = t0r - t2r;
+        im[2] = t0i - t2i;
+        re[3] = t1r - t3r;
+        im[3] = t1i - t3i;
+    }
+};
+
+template <bool Inverse>
+struct Butterfly<5, Inverse>
+{
+    static inline void Apply(float* re, float* im)
+    {
+        const float cos72  = 0.309016994374947424f;
+        const float cos144 = -0.809016994374947424f;
+        const float sin72  = 0.951056516295153572f;
+        const float sin144 = 0.587785252292473129f;
+
+        auto b1r = re[1] + re[4], b1i = im[1] + im[4];
+        auto b2r = re[2] + re[3], b2i = im[2] + im[3];
+        auto d1r = re[1] - re[4], d1i = im[1] - im[4];
+        auto d2r = re[2] - re[3], d2i = im[2] - im[3];
+
+        auto e1r = re[0] + b1r*cos72 + b2r*cos144, e1i = im[0] + b1i*cos72 + b2i*cos144;
+        auto e2r = re[0] + b1r*cos144 + b2r*cos72, e2i = im[0] + b1i*cos144 + b2i*cos72;
+        auto f1r = d1r*sin72 + d2r*sin144, f1i = d1i*sin72 + d2i*sin144;
+        auto f2r = d1r*sin144 - d2r*sin72, f2i = d1i*sin144 - d2i*sin72;
+        RotateQuarter<Inverse>(f1r, f1i);
+        RotateQuarter<Inverse>(f2r, f2i);
+
+        re[0] = re[0] + b1r + b2r;
+        im[0] = im[0] + b1i + b2i;
+        re[1] = e1r + f1r;
+        im[1] = e1i + f1i;
+        re[2] = e2r + f2r;
+        im[2] = e2i + f2i;
+        re[3] = e2r - f2r;
+        im[3] = e2i - f2i;
+        re[4] = e1r - f1r;
+        im[4] = e1i - f1i;
+    }
+};
+
+/*
+Stockham auto-sort pass of the fixed radix 'r' for the sub-sequence length 'n' and the stride 's':
+y[q + s*(r*p + k)] = twiddle(k, p) * sum_j(x[q + s*(p + j*n/r)] * exp(-2*pi*i*j*k/r)).
+The complex arrays are accessed as arrays of pairs of floats.
+*/
+template <std::size_t Radix, bool Inverse>
+static void RadixPass(std::size_t length, std::size_t stride, const Complex* twiddles, const Complex* x, Complex* y)
+{
+    const auto m    = length / Radix;
+    const auto s    = stride;
+    const auto xf   = reinterpret_cast<const float*>(x);
+    const auto yf   = reinterpret_cast<float*>(y);
+
+    if (s >= minInnerStride)
+    {
+        /* Inner loop over the stride with constant twiddle factors */
+        for (std::size_t p = 0; p < m; ++p)
+        {
+            float wr[Radix], wi[Radix];
+            for (std::size_t k = 1; k < Radix; ++k)
+            {
+                const auto w = Twiddle<Inverse>(twiddles[(k - 1)*m + p]);
+                wr[k] = w.real();
+                wi[k] = w.imag();
+            }
+
+            const auto src = xf + 2*s*p;
+            const auto dst = yf + 2*s*Radix*p;
+
+            for (std::size_t q = 0; q < s; ++q)
+            {
+                float re[Radix], im[Radix];
+                for (std::size_t j = 0; j < Radix; ++j)
+                {
+                    re[j] = src[2*(q + s*j*m)    ];
+                    im[j] = src[2*(q + s*j*m) + 1];
+                }
+
+                Butterfly<Radix, Inverse>::Apply(re, im);
+
+                dst[2*q    ] = re[0];
+                dst[2*q + 1] = im[0];
+
+                for (std::size_t k = 1; k < Radix; ++k)
+                {
+                    dst[2*(q + s*k)    ] = re[k]*wr[k] - im[k]*wi[k];
+                    dst[2*(q + s*k) + 1] = re[k]*wi[k] + im[k]*wr[k];
+                }
+            }
+        }
+    }
+    else
+    {
+        /* Inner loop over the twiddle factors (for the first passes with a small stride) */
+        for (std::size_t q = 0; q < s; ++q)
+        {
+            for (std::size_t p = 0; p < m; ++p)
+            {
+                float re[Radix], im[Radix];
+                for (std::size_t j = 0; j < Radix; ++j)
+                {
+                    re[j] = xf[2*(q + s*(p + j*m))    ];
+                    im[j] = xf[2*(q + s*(p + j*m)) + 1];
+                }
+
+                Butterfly<Radix, Inverse>::Apply(re, im);
+
+                const auto dst = yf + 2*(q + s*Radix*p);
+
+                dst[0] = re[0];
+                dst[1] = im[0];
+
+                for (std::size_t k = 1; k < Radix; ++k)
+                {
+                    const auto w = Twiddle<Inverse>(twiddles[(k - 1)*m + p]);
+                    dst[2*s*k    ] = re[k]*w.real() - im[k]*w.imag();
+                    dst[2*s*k + 1] = re[k]*w.imag() + im[k]*w.real();
+                }
+            }
+        }
+    }
+}
+
+// Stockham pass of an arbitrary radix, which evaluates the DFT of each butterfly directly.
+template <bool Inverse>
+static void GenericPass(
+    std::size_t radix, std::size_t length, std::size_t stride, const Complex* twiddles, const Complex* roots, const Complex* x, Complex* y)
+{
+    const auto m = length / radix;
+    const auto s = stride;
+
+    std::vector<Complex> a(radix);
+
+    for (std::size_t p = 0; p < m; ++p)
+    {
+        for (std::size_t q = 0; q < s; ++q)
+        {
+            for (std::size_t j = 0; j < radix; ++j)
+                a[j] = x[q + s*(p + j*m)];
+
+            for (std::size_t k = 0; k < radix; ++k)
+            {
+                /* Accumulate with the roots of unity */
+                auto c = a[0];
+                for (std::size_t j = 1, jk = k; j < radix; ++j, jk = (jk + k) % radix)
+                    c += Mul(a[j], Twiddle<Inverse>(roots[jk]));
+
+                if (k > 0)
+                    c = Mul(c, Twiddle<Inverse>(twiddles[(k - 1)*m + p]));
+
+                y[q + s*(radix*p + k)] = c;
+            }
+        }
+    }
+}
+
+/* ----- Scratch buffers ----- */
+
+enum class ScratchBuffer
+{
+    Work = 0,   // Work buffer of the Stockham passes
+    Input,      // Copy of the input for in-place transforms
+    Real,       // Buffer of the real transforms
+};
+
+// Returns a scratch buffer of the current thread with at least the specified size, so that the plans can be shared between threads.
+static Complex* GetScratchBuffer(const ScratchBuffer buffer, std::size_t size)
+{
+    thread_local std::vector<Complex> scratchBuffers[3];
+    auto& scratch = scratchBuffers[static_cast<int>(buffer)];
+    if (scratch.size() < size)
+        scratch.resize(size);
+    return scratch.data();
+}
+
+/* ----- Plan cache ----- */
+
+template <typename Plan>
+static std::shared_ptr<const Plan> GetCachedPlan(std::size_t size)
+{
+    static std::mutex                                           cacheMutex;
+    static std::map<std::size_t, std::shared_ptr<const Plan>>   cache;
+
+    std::lock_guard<std::mutex> guard { cacheMutex };
+
+    auto& plan = cache[size];
+    if (!plan)
+        plan = std::make_shared<Plan>(size);
+
+    return plan;
+}
+
+/* ----- FFTPlan class ----- */
+
+FFTPlan::FFTPlan(std::size_t size) :
+    size_ { size }
+{
+    if (size == 0)
+        throw std::invalid_argument("size of FFT must not be zero");
+
+    /* Factorize size into radices (prefer radix-4 passes) */
+    std::vector<std::size_t> radices;
+
+    auto n = size;
+
+    while (n % 4 == 0)
+    {
+        radices.push_back(4);
+        n /= 4;
+    }
+
+    for (std::size_t factor = 2; n > 1; factor += (factor == 2 ? 1 : 2))
+    {
+        if (factor * factor > n)
+            factor = n;
+        while (n % factor == 0)
+        {
+            radices.push_back(factor);
+            n /= factor;
+        }
+    }
+
+    /* Compute twiddle factors with double precision for each Stockham pass */
+    std::size_t length = size, stride = 1;
+
+    for (auto radix : radices)
+    {
+        Stage stage;
+        {
+            stage.radix     = radix;
+            stage.length    = length;
+            stage.stride    = stride;
+        }
+
+        const auto m = length / radix;
+
+        stage.twiddles.resize((radix - 1) * m);
+
+        for (std::size_t k = 1; k < radix; ++k)
+        {
+            for (std::size_t p = 0; p < m; ++p)
+            {
+                auto angle = -2.0 * pi * static_cast<double>(k * p) / static_cast<double>(length);
+                stage.twiddles[(k - 1)*m + p] = Complex(static_cast<float>(std::cos(angle)), static_cast<float>(std::sin(angle)));
+            }
+        }
+
+        if (radix != 2 && radix != 3 && radix != 4 && radix != 5)
+        {
+            stage.roots.resize(radix);
+            for (std::size_t j = 0; j < radix; ++j)
+            {
+                auto angle = -2.0 * pi * static_cast<double>(j) / static_cast<double>(radix);
+                stage.roots[j] = Complex(static_cast<float>(std::cos(angle)), static_cast<float>(std::sin(angle)));
+            }
+        }
+
+        stages_.push_back(std::move(stage));
+
+        length  /= radix;
+        stride  *= radix;
+    }
+}
+
+std::shared_ptr<const FFTPlan> FFTPlan::Get(std::size_t size)
+{
+    return GetCachedPlan<FFTPlan>(size);
+}
+
+void FFTPlan::Forward(const std::complex<float>* input, std::complex<float>* output) const
+{
+    Transform<false>(input, output);
+}
+
+void FFTPlan::Inverse(const std::complex<float>* input, std::complex<float>* output) const
+{
+    Transform<true>(input, output);
+}
+
+std::size_t FFTPlan::GetFastSize(std::size_t size)
+{
+    for (size = std::max(std::size_t(1u), size);; ++size)
+    {
+        auto n = size;
+        for (std::size_t factor : { 2u, 3u, 5u })
+        {
+            while (n % factor == 0)
+                n /= factor;
+        }
+        if (n == 1)
+            return size;
+    }
+}
+
+
+/*
+ * ======= Private: =======
+ */
+
+template <bool Inverse>
+void FFTPlan::Transform(const std::complex<float>* input, std::complex<float>* output) const
+{
+    const auto numStages = stages_.size();
+
+    if (numStages == 0)
+    {
+        output[0] = input[0];
+        return;
+    }
+
+    /* The first pass cannot write into its own input */
+    if (input == output)
+    {
+        auto inputCopy = GetScratchBuffer(ScratchBuffer::Input, size_);
+        std::copy(input, input + size_, inputCopy);
+        input = inputCopy;
+    }
+
+    /* Alternate between the output and the work buffer, so that the last pass writes into the output */
+    auto work = GetScratchBuffer(ScratchBuffer::Work, size_);
+
+    auto src = input;
+
+    for (std::size_t i = 0; i < numStages; ++i)
+    {
+        const auto& stage = stages_[i];
+
+        auto dst = ((numStages - i) % 2 == 1 ? output : work);
+
+        switch (stage.radix)
+        {
+            case 2:
+                RadixPass<2, Inverse>(stage.length, stage.stride, stage.twiddles.data(), src, dst);
+                break;
+            case 3:
+                RadixPass<3, Inverse>(stage.length, stage.stride, stage.twiddles.data(), src, dst);
+                break;
+            case 4:
+                RadixPass<4, Inverse>(stage.length, stage.stride, stage.twiddles.data(), src, dst);
+                break;
+            case 5:
+                RadixPass<5, Inverse>(stage.length, stage.stride, stage.twiddles.data(), src, dst);
+                break;
+            default:
+                GenericPass<Inverse>(stage.radix, stage.length, stage.stride, stage.twiddles.data(), stage.roots.data(), src, dst);
+                break;
+        }
+
+        src = dst;
+    }
+}
+
+/* ----- RealFFTPlan class ----- */
+
+RealFFTPlan::RealFFTPlan(std::size_t size) :
+    size_ { size }
+{
+    if (size == 0)
+        throw std::invalid_argument("size of FFT must not be zero");
+
+    if (size % 2 == 0)
+    {
+        /* Transform the even and odd samples as a complex signal of half the size */
+        const auto halfSize = size / 2;
+
+        complexPlan_ = FFTPlan::Get(halfSize);
+        twiddles_.resize(halfSize);
+
+        for (std::size_t k = 0; k < halfSize; ++k)
+        {
+            auto angle = -2.0 * pi * static_cast<double>(k) / static_cast<double>(size);
+            twiddles_[k] = Complex(static_cast<float>(std::cos(angle)), static_cast<float>(std::sin(angle)));
+        }
+    }
+    else
+        complexPlan_ = FFTPlan::Get(size);
+}
+
+std::shared_ptr<const RealFFTPlan> RealFFTPlan::Get(std::size_t size)
+{
+    return GetCachedPlan<RealFFTPlan>(size);
+}
+
+void RealFFTPlan::Forward(const float* input, std::complex<float>* output) const
+{
+    if (size_ % 2 == 0)
+    {
+        const auto halfSize = size_ / 2;
+
+        /* Transform even samples as real parts and odd samples as imaginary parts (an array of complex numbers has the layout of an array of pairs) */
+        complexPlan_->Forward(reinterpret_cast<const Complex*>(input), output);
+
+        /* Split spectrum into the spectra of the even and odd samples, and combine them for the bins 'k' and 'halfSize - k' at once */
+        auto z0 = output[0];
+        output[0]           = Complex(z0.real() + z0.imag(), 0.0f);
+        output[halfSize]    = Complex(z0.real() - z0.imag(), 0.0f);
+
+        for (std::size_t k = 1, j = halfSize - 1; k <= j; ++k, --j)
+        {
+            auto a = output[k];
+            auto b = std::conj(output[j]);
+
+            auto evenK  = (a + b) * 0.5f;
+            auto oddK   = RotateQuarter<false>(a - b) * 0.5f;
+            auto evenJ  = std::conj(evenK);
+            auto oddJ   = std::conj(oddK);
+
+            output[k] = evenK + Mul(twiddles_[k], oddK);
+            output[j] = evenJ + Mul(twiddles_[j], oddJ);
+        }
+    }
+    else
+    {
+        /* Transform real signal as complex signal */
+        auto buffer = GetScratchBuffer(ScratchBuffer::Real, size_);
+
+        for (std::size_t i = 0; i < size_; ++i)
+            buffer[i] = Complex(input[i], 0.0f);
+
+        complexPlan_->Forward(buffer, buffer);
+        std::copy(buffer, buffer + GetNumBins(), output);
+    }
+}
+
+void RealFFTPlan::Inverse(const std::complex<float>* input, float* output) const
+{
+    if (size_ % 2 == 0)
+    {
+        const auto halfSize = size_ / 2;
+
+        /* Merge the spectra of the even and odd samples into the spectrum of the complex signal of half the size */
+        auto buffer = GetScratchBuffer(ScratchBuffer::Real, halfSize);
+
+        buffer[0] = Complex(input[0].real() + input[halfSize].real(), input[0].real() - input[halfSize].real());
+
+        for (std::size_t k = 1; k < halfSize; ++k)
+        {
+            auto a = input[k];
+            auto b = std::conj(input[halfSize - k]);
+            buffer[k] = (a + b) + RotateQuarter<true>(Mul(a - b, std::conj(twiddles_[k])));
+        }
+
+        complexPlan_->Inverse(buffer, reinterpret_cast<Complex*>(output));
+    }
+    else
+    {
+        /* Restore the conjugate symmetric spectrum and transform it as complex spectrum */
+        auto buffer = GetScratchBuffer(ScratchBuffer::Real, size_);
+
+        buffer[0] = Complex(input[0].real(), 0.0f);
+        for (std::size_t k = 1; k < GetNumBins(); ++k)
+        {
+            buffer[k]           = input[k];
+            buffer[size_ - k]   = std::conj(input[k]);
+        }
+
+        complexPlan_->Inverse(buffer, buffer);
+
+        for (std::size_t i = 0; i < size_; ++i)
+            output[i] = buffer[i].real();
+    }
+}
+
+
+} // /namespace Ac
+
+
+
+// ================================================================================
@@ -0,0 +1,176 @@
+/*
+ * Limiter.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include <Ac/Limiter.h>
+#include "Dynamics.h"
+#include "VectorKernels.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+
+namespace Ac
+{
+
+
+Limiter::Limiter(
+    std::uint32_t               sampleRate,
+    std::uint16_t               channels,
+    const LimiterParameters&    parameters,
+    double                      lookAheadTime) :
+        sampleRate_ { sampleRate },
+        channels_   { channels   }
+{
+    if (sampleRate == 0)
+        throw std::invalid_argument("sample rate of limiter must not be zero");
+    if (channels == 0)
+        throw std::invalid_argument("number of channels of limiter must not be zero");
+
+    lookAhead_ = std::max(std::size_t(1u), static_cast<std::size_t>(std::max(0.0, lookAheadTime) * static_cast<double>(sampleRate) + 0.5));
+
+    const auto window = lookAhead_ + 1;
+
+    delayBuffer_.resize((lookAhead_ + dynamicsBlockSize) * channels);
+    minValues_.resize(window);
+    minIndices_.resize(window);
+    averageWindow_.resize(window);
+    gains_.resize(dynamicsBlockSize);
+
+    SetParameters(parameters);
+    Reset();
+}
+
+void Limiter::Process(float* samples, std::size_t frames)
+{
+    const auto delaySize    = lookAhead_ * channels_;
+    const auto gains        = gains_.data();
+
+    for (std::size_t offset = 0; offset < frames; offset += dynamicsBlockSize)
+    {
+        const auto n        = std::min(dynamicsBlockSize, frames - offset);
+        const auto count    = n * channels_;
+        const auto block    = samples + offset * channels_;
+
+        if (inputGain_ != 1.0f)
+            ScaleCopy(block, block, inputGain_, count);
+
+        /* Compute required gains from the peaks of the sample frames */
+        FramePeaks(block, n, channels_, gains);
+
+        for (std::size_t i = 0; i < n; ++i)
+            gains[i] = ceiling_ / MaxValue(gains[i], ceiling_);
+
+        ComputeGains(gains, n);
+
+        /* Delay samples by the look-ahead, i.e. output the oldest sample frames and keep the newest ones */
+        std::copy(block, block + count, delayBuffer_.begin() + delaySize);
+        std::copy(delayBuffer_.begin(), delayBuffer_.begin() + count, block);
+        std::copy(delayBuffer_.begin() + count, delayBuffer_.begin() + count + delaySize, delayBuffer_.begin());
+
+        /* Apply gains, and clamp the samples to the ceiling against rounding errors of the moving average */
+        ScaleFrames(block, n, channels_, gains);
+
+        for (std::size_t i = 0; i < count; ++i)
+            block[i] = ClampValue(block[i], -ceiling_, ceiling_);
+    }
+}
+
+void Limiter::Reset()
+{
+    std::fill(delayBuffer_.begin(), delayBuffer_.end(), 0.0f);
+    std::fill(averageWindow_.begin(), averageWindow_.end(), 1.0f);
+
+    minFront_       = 0;
+    minCount_       = 0;
+    envelope_       = 1.0f;
+    averageSum_     = static_cast<double>(averageWindow_.size());
+    gain_           = 1.0f;
+    time_           = 0;
+}
+
+std::uint16_t Limiter::GetChannels() const
+{
+    return channels_;
+}
+
+std::size_t Limiter::GetLatency() const
+{
+    return lookAhead_;
+}
+
+void Limiter::SetParameters(const LimiterParameters& parameters)
+{
+    parameters_ = parameters;
+
+    parameters_.ceiling     = std::min(0.0, parameters_.ceiling);
+    parameters_.releaseTime = std::max(0.0, parameters_.releaseTime);
+
+    ceiling_    = static_cast<float>(std::pow(10.0, parameters_.ceiling / 20.0));
+    inputGain_  = static_cast<float>(std::pow(10.0, parameters_.inputGain / 20.0));
+    release_    = SmoothingCoefficient(parameters_.releaseTime, sampleRate_);
+}
+
+float Limiter::GetGainReduction() const
+{
+    return static_cast<float>(-20.0 * std::log10(std::max(1.0e-10, static_cast<double>(gain_))));
+}
+
+
+/*
+ * ======= Private: =======
+ */
+
+/*
+Replaces the required gains by the smoothed gains: the minimum within the window of 'lookAhead_ + 1' sample frames
+(with a monotonic queue of candidates), followed by the release, and the moving average over the same window.
+Each averaged gain only contains gains which are not greater than the required gain of the delayed sample frame.
+*/
+void Limiter::ComputeGains(float* gains, std::size_t frames)
+{
+    const auto window = minValues_.size();
+
+    for (std::size_t i = 0; i < frames; ++i, ++time_)
+    {
+        auto value = gains[i];
+
+        /* Remove the expired candidate, and all candidates which are not smaller than the new value */
+        if (minCount_ > 0 && minIndices_[minFront_] + window <= time_)
+        {
+            minFront_ = (minFront_ + 1) % window;
+            --minCount_;
+        }
+
+        while (minCount_ > 0 && minValues_[(minFront_ + minCount_ - 1) % window] >= value)
+            --minCount_;
+
+        auto back = (minFront_ + minCount_) % window;
+        minValues_[back]    = value;
+        minIndices_[back]   = time_;
+        ++minCount_;
+
+        /* Apply release to the minimum (lower gains are followed immediately) */
+        auto minimum = minValues_[minFront_];
+        envelope_ = (minimum < envelope_ ? minimum : minimum + release_ * (envelope_ - minimum));
+
+        /* Moving average */
+        auto pos = static_cast<std::size_t>(time_ % window);
+        averageSum_ += static_cast<double>(envelope_) - static_cast<double>(averageWindow_[pos]);
+        averageWindow_[pos] = envelope_;
+
+        gains[i] = static_cast<float>(averageSum_ / static_cast<double>(window));
+    }
+
+    if (frames > 0)
+        gain_ = gains[frames - 1];
+}
+
+
+} // /namespace Ac
+
+
+
+// ================================================================================
@@ -0,0 +1,232 @@
+/*
+ * NoiseGenerator.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include <Ac/NoiseGenerator.h>
+
+#include <iterator>
+
+
+namespace Ac
+{
+
+
+// Number of white noise samples which are generated at once for the pink and brown noise filters
+static const std::size_t maxFilterBlockSize = 256;
+
+static std::uint64_t SplitMix64(std::uint64_t& state)
+{
+    auto z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return (z ^ (z >> 31));
+}
+
+static std::uint64_t RotateLeft(std::uint64_t x, int k)
+{
+    return ((x << k) | (x >> (64 - k)));
+}
+
+const std::size_t NoiseGenerator::numLanes;
+
+NoiseGenerator::NoiseGenerator(const NoiseColor color, double amplitude, std::uint64_t seed) :
+    color_      { color     },
+    amplitude_  { amplitude },
+    seed_       { seed      }
+{
+}
+
+void NoiseGenerator::Generate(float* samples, std::size_t frames, std::uint16_t channel)
+{
+    GenerateSamples(samples, frames, channel);
+}
+
+void NoiseGenerator::Generate(double* samples, std::size_t frames, std::uint16_t channel)
+{
+    GenerateSamples(samples, frames, channel);
+}
+
+void NoiseGenerator::Seed(std::uint64_t seed)
+{
+    seed_ = seed;
+    Reset();
+}
+
+void NoiseGenerator::Reset()
+{
+    for (std::size_t chn = 0; chn < channels_.size(); ++chn)
+        SeedChannel(channels_[chn], static_cast<std::uint16_t>(chn));
+}
+
+void NoiseGenerator::SetColor(const NoiseColor color)
+{
+    color_ = color;
+    for (auto& state : channels_)
+        std::fill(std::begin(state.filter), std::end(state.filter), 0.0);
+}
+
+
+/*
+ * ======= Private: =======
+ */
+
+NoiseGenerator::ChannelState& NoiseGenerator::GetChannelState(std::uint16_t channel)
+{
+    /* Seed new channels on demand */
+    while (channels_.size() <= channel)
+    {
+        channels_.push_back(ChannelState());
+        SeedChannel(channels_.back(), static_cast<std::uint16_t>(channels_.size() - 1));
+    }
+    return channels_[channel];
+}
+
+void NoiseGenerator::SeedChannel(ChannelState& state, std::uint16_t channel) const
+{
+    /* Derive independent stream states from the seed and the channel index */
+    std::uint64_t seedState = seed_ ^ (0xD1B54A32D192ED03ull * (static_cast<std::uint64_t>(channel) + 1));
+
+    for (std::size_t lane = 0; lane < numLanes; ++lane)
+    {
+        for (std::size_t i = 0; i < 4; ++i)
+            state.rng[i][lane] = SplitMix64(seedState);
+    }
+
+    state.cacheIndex = numLanes;
+    std::fill(std::begin(state.filter), std::end(state.filter), 0.0);
+}
+
+void NoiseGenerator::GenerateWhite(ChannelState& state, float* samples, std::size_t frames)
+{
+    /* Take pending samples of the last group first */
+    while (frames > 0 && state.cacheIndex < numLanes)
+    {
+        *(samples++) = state.cache[state.cacheIndex++];
+        --frames;
+    }
+
+    std::uint64_t s0[numLanes], s1[numLanes], s2[numLanes], s3[numLanes];
+
+    for (std::size_t lane = 0; lane < numLanes; ++lane)
+    {
+        s0[lane] = state.rng[0][lane];
+        s1[lane] = state.rng[1][lane];
+        s2[lane] = state.rng[2][lane];
+        s3[lane] = state.rng[3][lane];
+    }
+
+    /* Advance all streams in parallel, and generate one sample per stream (the last group is cached if it doesn't fit) */
+    while (frames > 0)
+    {
+        float group[numLanes];
+
+        for (std::size_t lane = 0; lane < numLanes; ++lane)
+        {
+            /* xoshiro256+ step: use upper 24 bits (the lower bits of this variant are weak) to get a float in [-1, 1) */
+            auto result = s0[lane] + s3[lane];
+            auto t      = s1[lane] << 17;
+
+            s2[lane] ^= s0[lane];
+            s3[lane] ^= s1[lane];
+            s1[lane] ^= s2[lane];
+            s0[lane] ^= s3[lane];
+            s2[lane] ^= t;
+            s3[lane] = RotateLeft(s3[lane], 45);
+
+            group[lane] = static_cast<float>(static_cast<std::int32_t>(result >> 40) - 0x800000) * (1.0f / 8388608.0f);
+        }
+
+        if (frames >= numLanes)
+        {
+            std::copy(group, group + numLanes, samples);
+            samples += numLanes;
+            frames  -= numLanes;
+        }
+        else
+        {
+            std::copy(group, group + numLanes, state.cache);
+            for (state.cacheIndex = 0; frames > 0; --frames)
+                *(samples++) = state.cache[state.cacheIndex++];
+        }
+    }
+
+    for (std::size_t lane = 0; lane < numLanes; ++lane)
+    {
+        state.rng[0][lane] = s0[lane];
+        state.rng[1][lane] = s1[lane];
+        state.rng[2][lane] = s2[lane];
+        state.rng[3][lane] = s3[lane];
+    }
+}
+
+template <typename T>
+void NoiseGenerator::GenerateSamples(T* samples, std::size_t frames, std::uint16_t channel)
+{
+    auto& state = GetChannelState(channel);
+
+    const auto amplitude = amplitude_;
+
+    float white[maxFilterBlockSize];
+
+    while (frames > 0)
+    {
+        auto n = std::min(frames, maxFilterBlockSize);
+        GenerateWhite(state, white, n);
+
+        switch (color_)
+        {
+            case NoiseColor::White:
+            {
+                for (std::size_t i = 0; i < n; ++i)
+                    samples[i] = static_cast<T>(white[i] * amplitude);
+            }
+            break;
+
+            case NoiseColor::Pink:
+            {
+                /* Filter white noise with Paul Kellet's refined pink noise filter (accurate to +/- 0.05 dB above 9.2 Hz at 44.1 kHz) */
+                auto b = state.filter;
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    auto w = static_cast<double>(white[i]);
+                    b[0] = 0.99886 * b[0] + w * 0.0555179;
+                    b[1] = 0.99332 * b[1] + w * 0.0750759;
+                    b[2] = 0.96900 * b[2] + w * 0.1538520;
+                    b[3] = 0.86650 * b[3] + w * 0.3104856;
+                    b[4] = 0.55000 * b[4] + w * 0.5329522;
+                    b[5] = -0.7616 * b[5] - w * 0.0168980;
+                    auto pink = b[0] + b[1] + b[2] + b[3] + b[4] + b[5] + b[6] + w * 0.5362;
+                    b[6] = w * 0.115926;
+                    samples[i] = static_cast<T>(pink * 0.11 * amplitude);
+                }
+            }
+            break;
+
+            case NoiseColor::Brown:
+            {
+                /* Integrate white noise with a leaky integrator, so that the noise does not drift away */
+                auto b = state.filter[0];
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    b = (b + 0.02 * static_cast<double>(white[i])) / 1.02;
+                    samples[i] = static_cast<T>(b * 3.5 * amplitude);
+                }
+                state.filter[0] = b;
+            }
+            break;
+        }
+
+        samples += n;
+        frames  -= n;
+    }
+}
+
+
+} // /namespace Ac
+
+
+
+// ================================================================================
@@ -0,0 +1,365 @@
+/*
+ * Oscillator.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include <Ac/Oscillator.h>
+#include <Ac/WaveFormExpression.h>
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+
+namespace Ac
+{
+
+
+// Maximal number of sample frames for which the sine phasors are rotated before they are re-initialized from the phase accumulator
+static const std::size_t maxPhasorFrames    = 1024;
+
+// Number of samples of the half-circle wavetable (without the guard sample)
+static const std::size_t halfCircleSamples  = 4096;
+
+static const double pi                      = 3.14159265358979323846;
+
+// Factor to convert a fixed-point phase (where 2^64 corresponds to one cycle) into cycles
+static const double phaseToCycles           = 1.0 / 18446744073709551616.0;
+
+// Converts the fractional part of the specified cycles into a fixed-point phase.
+static std::uint64_t CyclesToPhase(double cycles)
+{
+    auto fraction = cycles - std::floor(cycles);
+    if (fraction >= 1.0)
+        return 0;
+    return static_cast<std::uint64_t>(fraction * 18446744073709551616.0);
+}
+
+// Converts the specified fixed-point phase into an angle (in radians) in the range [-PI, PI).
+static double PhaseToRadians(std::uint64_t phase)
+{
+    return static_cast<double>(static_cast<std::int64_t>(phase)) * (2.0 * pi * phaseToCycles);
+}
+
+// Converts the specified fixed-point phase into cycles in the range [0, 1).
+static double PhaseToCycles(std::uint64_t phase)
+{
+    return static_cast<double>(phase >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Converts the specified fixed-point phase into a signed value in the range [-1, 1), which rises linearly from -1 at phase 0.
+static double PhaseToSaw(std::uint64_t phase)
+{
+    return static_cast<double>(static_cast<std::int64_t>(phase ^ 0x8000000000000000ull)) * (2.0 * phaseToCycles);
+}
+
+// Appends a copy of the first sample to the wavetable, so that the interpolation never needs to wrap around.
+static std::vector<float> MakeGuardedWavetable(const std::vector<float>& wavetable)
+{
+    auto guardedWavetable = wavetable;
+    if (!guardedWavetable.empty())
+        guardedWavetable.push_back(guardedWavetable.front());
+    return guardedWavetable;
+}
+
+static const std::vector<float>& GetHalfCircleWavetable()
+{
+    static const std::vector<float> wavetable = []()
+    {
+        std::vector<float> samples(halfCircleSamples);
+
+        for (std::size_t i = 0; i < halfCircleSamples; ++i)
+        {
+            /* Upper half circle within the first half cycle, and lower half circle within the second half cycle */
+            auto t = static_cast<double>(i) / static_cast<double>(halfCircleSamples) * 2.0;
+            auto x = (t - std::floor(t))*2.0 - 1.0;
+            auto y = std::sqrt(1.0 - x*x);
+            samples[i] = static_cast<float>(t < 1.0 ? y : -y);
+        }
+
+        return MakeGuardedWavetable(samples);
+    }();
+    return wavetable;
+}
+
+Oscillator::Oscillator(const OscillatorWaveForm waveForm, std::uint32_t sampleRate, double frequency, double amplitude, double phase) :
+    waveForm_       { waveForm              },
+    sampleRate_     { sampleRate            },
+    frequency_      { frequency             },
+    amplitude_      { amplitude             },
+    initialPhase_   { CyclesToPhase(phase)  }
+{
+    if (sampleRate == 0)
+        throw std::invalid_argument("sample rate of oscillator must not be zero");
+
+    SetPulseWidth(0.5);
+    UpdateIncrement();
+    Reset();
+}
+
+void Oscillator::Generate(float* samples, std::size_t frames)
+{
+    GenerateSamples(samples, frames);
+}
+
+void Oscillator::Generate(double* samples, std::size_t frames)
+{
+    GenerateSamples(samples, frames);
+}
+
+void Oscillator::Reset()
+{
+    phase_ = initialPhase_;
+}
+
+void Oscillator::SetWaveForm(const OscillatorWaveForm waveForm)
+{
+    waveForm_ = waveForm;
+}
+
+void Oscillator::SetSampleRate(std::uint32_t sampleRate)
+{
+    if (sampleRate == 0)
+        throw std::invalid_argument("sample rate of oscillator must not be zero");
+    sampleRate_ = sampleRate;
+    UpdateIncrement();
+}
+
+void Oscillator::SetFrequency(double frequency)
+{
+    frequency_ = frequency;
+    UpdateIncrement();
+}
+
+void Oscillator::SetPhase(double phase)
+{
+    phase_ = CyclesToPhase(phase);
+}
+
+double Oscillator::GetPhase() const
+{
+    return PhaseToCycles(phase_);
+}
+
+void Oscillator::SetPulseWidth(double pulseWidth)
+{
+    pulseWidth_ = std::max(0.0, std::min(pulseWidth, 1.0));
+    pulseEnd_   = (pulseWidth_ < 1.0 ? CyclesToPhase(pulseWidth_) : std::numeric_limits<std::uint64_t>::max());
+}
+
+void Oscillator::SetWavetable(const std::vector<float>& wavetable)
+{
+    if (!wavetable.empty())
+        wavetable_ = std::make_shared<const std::vector<float>>(MakeGuardedWavetable(wavetable));
+    else
+        wavetable_.reset();
+    waveForm_ = OscillatorWaveForm::Wavetable;
+}
+
+
+/*
+ * ======= Private: =======
+ */
+
+template <typename T>
+void Oscillator::GenerateSamples(T* samples, std::size_t frames)
+{
+    const auto amplitude = amplitude_;
+
+    /* Band-limiting requires a phase increment (in either direction) below half a cycle per sample */
+    if (bandLimited_ && increment_ != 0 && increment_ != 0x8000000000000000ull)
+    {
+        switch (waveForm_)
+        {
+            case OscillatorWaveForm::Square:
+            case OscillatorWaveForm::Triangle:
+            case OscillatorWaveForm::Saw:
+                GenerateBandLimited(samples, frames);
+                return;
+            default:
+                break;
+        }
+    }
+
+    switch (waveForm_)
+    {
+        case OscillatorWaveForm::Sine:
+        {
+            GenerateSine(samples, frames);
+        }
+        break;
+
+        case OscillatorWaveForm::Square:
+        {
+            for (std::size_t i = 0; i < frames; ++i, phase_ += increment_)
+                samples[i] = static_cast<T>(phase_ < pulseEnd_ ? amplitude : -amplitude);
+        }
+        break;
+
+        case OscillatorWaveForm::Triangle:
+        {
+            /* Shift phase by a quarter cycle, so that the triangle wave is in phase with the sine wave */
+            for (std::size_t i = 0; i < frames; ++i, phase_ += increment_)
+                samples[i] = static_cast<T>((1.0 - 2.0*std::abs(PhaseToSaw(phase_ + 0x4000000000000000ull))) * amplitude);
+        }
+        break;
+
+        case OscillatorWaveForm::Saw:
+        {
+            for (std::size_t i = 0; i < frames; ++i, phase_ += increment_)
+                samples[i] = static_cast<T>(PhaseToSaw(phase_) * amplitude);
+        }
+        break;
+
+        case OscillatorWaveForm::HalfCircle:
+        {
+            GenerateWavetable(samples, frames, GetHalfCircleWavetable());
+        }
+        break;
+
+        case OscillatorWaveForm::Wavetable:
+        {
+            if (wavetable_)
+                GenerateWavetable(samples, frames, *wavetable_);
+            else
+            {
+                std::fill(samples, samples + frames, T(0));
+                phase_ += increment_ * frames;
+            }
+        }
+        break;
+    }
+}
+
+template <typename T>
+void Oscillator::GenerateSine(T* samples, std::size_t frames)
+{
+    /* Rotate four phasors (for four successive sample frames) by four phase increments, so that the loop can be vectorized */
+    const auto rotation     = PhaseToRadians(increment_ * 4);
+    const auto rotationSin  = std::sin(rotation);
+    const auto rotationCos  = std::cos(rotation);
+
+    while (frames > 0)
+    {
+        /* Re-initialize phasors from the phase accumulator for each block, so that the rounding errors do not accumulate */
+        auto n = std::min(frames, maxPhasorFrames);
+
+        double sine[4], cosine[4];
+
+        for (std::size_t j = 0; j < 4; ++j)
+        {
+            auto angle = PhaseToRadians(phase_ + increment_ * j);
+            sine[j]     = std::sin(angle) * amplitude_;
+            cosine[j]   = std::cos(angle) * amplitude_;
+        }
+
+        std::size_t i = 0;
+
+        for (; i + 4 <= n; i += 4)
+        {
+            for (std::size_t j = 0; j < 4; ++j)
+            {
+                samples[i + j] = static_cast<T>(sine[j]);
+                auto s = sine[j]*rotationCos + cosine[j]*rotationSin;
+                cosine[j] = cosine[j]*rotationCos - sine[j]*rotationSin;
+                sine[j] = s;
+            }
+        }
+
+        for (std::size_t j = 0; i < n; ++i, ++j)
+            samples[i] = static_cast<T>(sine[j]);
+
+        phase_ += increment_ * n;
+        samples += n;
+        frames -= n;
+    }
+}
+
+template <typename T>
+void Oscillator::GenerateBandLimited(T* samples, std::size_t frames)
+{
+    const auto amplitude    = amplitude_;
+    const auto step         = (increment_ < 0x8000000000000000ull ? increment_ : 0 - increment_);
+    const auto dt           = static_cast<double>(step) * phaseToCycles;
+
+    switch (waveForm_)
+    {
+        case OscillatorWaveForm::Square:
+        {
+            /* Smooth rising edge at phase 0 and falling edge at the end of the pulse */
+            for (std::size_t i = 0; i < frames; ++i, phase_ += increment_)
+            {
+                auto y = (phase_ < pulseEnd_ ? 1.0 : -1.0);
+                y += Synthesizer::PolyBLEP(PhaseToCycles(phase_), dt);
+                y -= Synthesizer::PolyBLEP(PhaseToCycles(phase_ - pulseEnd_), dt);
+                samples[i] = static_cast<T>(y * amplitude);
+            }
+        }
+        break;
+
+        case OscillatorWaveForm::Triangle:
+        {
+            /* Smooth trough and peak, where the slope changes by +8 and -8 per cycle */
+            const auto slopeChange = 8.0 * dt;
+            for (std::size_t i = 0; i < frames; ++i, phase_ += increment_)
+            {
+                auto t = phase_ + 0x4000000000000000ull;
+                auto y = 1.0 - 2.0*std::abs(PhaseToSaw(t));
+                y += slopeChange * Synthesizer::PolyBLAMP(PhaseToCycles(t), dt);
+                y -= slopeChange * Synthesizer::PolyBLAMP(PhaseToCycles(t + 0x8000000000000000ull), dt);
+                samples[i] = static_cast<T>(y * amplitude);
+            }
+        }
+        break;
+
+        case OscillatorWaveForm::Saw:
+        {
+            /* Smooth falling edge at phase 0 */
+            for (std::size_t i = 0; i < frames; ++i, phase_ += increment_)
+            {
+                auto y = PhaseToSaw(phase_) - Synthesizer::PolyBLEP(PhaseToCycles(phase_), dt);
+                samples[i] = static_cast<T>(y * amplitude);
+            }
+        }
+        break;
+
+        default:
+        break;
+    }
+}
+
+template <typename T>
+void Oscillator::GenerateWavetable(T* samples, std::size_t frames, const std::vector<float>& wavetable)
+{
+    /* Determine number of samples without the guard sample */
+    const auto size         = static_cast<std::uint64_t>(wavetable.size() - 1);
+    const auto amplitude    = amplitude_;
+    const auto table        = wavetable.data();
+
+    for (std::size_t i = 0; i < frames; ++i, phase_ += increment_)
+    {
+        /* Scale upper 32 bits of the phase by the table size to get a 32.32 fixed-point table position */
+        auto position   = (phase_ >> 32) * size;
+        auto index      = static_cast<std::size_t>(position >> 32);
+        auto fraction   = static_cast<double>(position & 0xFFFFFFFFull) * (1.0 / 4294967296.0);
+
+        auto a = static_cast<double>(table[index]);
+        auto b = static_cast<double>(table[index + 1]);
+
+        samples[i] = static_cast<T>((a + (b - a)*fraction) * amplitude);
+    }
+}
+
+void Oscillator::UpdateIncrement()
+{
+    increment_ = CyclesToPhase(frequency_ / static_cast<double>(sampleRate_));
+}
+
+
+} // /namespace Ac
+
+
+
+// ================================================================================
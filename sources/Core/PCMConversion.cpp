@@ -0,0 +1,1088 @@
+/*
+ * PCMConversion.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "PCMConversion.h"
+#include "PCMData.h"
+#include "CPUFeatures.h"
+
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+
+
+namespace Ac
+{
+
+
+/*
+Affine mapping between integer samples 'x' and normalized samples 's' (see "GetPCMLimits"):
+  s = (x - nullPoint) / halfRange
+  x = s * halfRange + nullPoint
+*/
+
+static const float uint8HalfRange   = 127.5f;
+static const float uint8NullPoint   = 127.5f;
+
+static const float int16HalfRange   = 32767.5f;
+static const float int24HalfRange   = 8388607.5f;
+static const float int32HalfRange   = 2147483647.5f;
+static const float intNullPoint     = -0.5f;
+
+// Largest 32-bit float below 2^31, to avoid the overflow of the float-to-int conversion
+static const float int32UpperEnd    = 2147483520.0f;
+
+
+/* ----- Scalar kernels ----- */
+
+/*
+The scalar kernels use the same floating-point operations as the SIMD kernels,
+so that all code paths produce the same results
+*/
+
+static float ClampSample(float s)
+{
+    return std::max(-1.0f, std::min(s, 1.0f));
+}
+
+static void ScalarUInt8ToFloat(const std::uint8_t* src, float* dst, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i)
+        dst[i] = static_cast<float>(src[i]) * (1.0f / uint8HalfRange) + (-uint8NullPoint / uint8HalfRange);
+}
+
+static void ScalarInt16ToFloat(const std::int16_t* src, float* dst, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i)
+        dst[i] = static_cast<float>(src[i]) * (1.0f / int16HalfRange) + (-intNullPoint / int16HalfRange);
+}
+
+static void ScalarInt24ToFloat(const std::uint8_t* src, float* dst, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i, src += 3)
+        dst[i] = static_cast<float>(UnpackPCMInt24(src)) * (1.0f / int24HalfRange) + (-intNullPoint / int24HalfRange);
+}
+
+static void ScalarInt32ToFloat(const std::int32_t* src, float* dst, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i)
+        dst[i] = static_cast<float>(src[i]) * (1.0f / int32HalfRange) + (-intNullPoint / int32HalfRange);
+}
+
+static void ScalarFloatToUInt8(const float* src, std::uint8_t* dst, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i)
+        dst[i] = static_cast<std::uint8_t>(std::lrint(ClampSample(src[i]) * uint8HalfRange + uint8NullPoint));
+}
+
+static void ScalarFloatToInt16(const float* src, std::int16_t* dst, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i)
+        dst[i] = static_cast<std::int16_t>(std::lrint(ClampSample(src[i]) * int16HalfRange + intNullPoint));
+}
+
+static void ScalarFloatToInt24(const float* src, std::uint8_t* dst, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i, dst += 3)
+        PackPCMInt24(dst, static_cast<std::int32_t>(std::lrint(ClampSample(src[i]) * int24HalfRange + intNullPoint)));
+}
+
+static void ScalarFloatToInt32(const float* src, std::int32_t* dst, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i)
+        dst[i] = static_cast<std::int32_t>(std::lrint(std::min(ClampSample(src[i]) * int32HalfRange + intNullPoint, int32UpperEnd)));
+}
+
+static void ScalarFloatToFloat32(const float* src, float* dst, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i)
+        dst[i] = ClampSample(src[i]);
+}
+
+static void ScalarInterleave2(const float* left, const float* right, std::size_t frames, float* dst)
+{
+    for (std::size_t i = 0; i < frames; ++i)
+    {
+        dst[i*2    ] = left[i];
+        dst[i*2 + 1] = right[i];
+    }
+}
+
+static void ScalarDeinterleave2(const float* src, std::size_t frames, float* left, float* right)
+{
+    for (std::size_t i = 0; i < frames; ++i)
+    {
+        left[i]  = ClampSample(src[i*2    ]);
+        right[i] = ClampSample(src[i*2 + 1]);
+    }
+}
+
+static void ScalarSwapEndian16(std::uint8_t* data, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i, data += 2)
+        std::swap(data[0], data[1]);
+}
+
+static void ScalarSwapEndian24(std::uint8_t* data, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i, data += 3)
+        std::swap(data[0], data[2]);
+}
+
+static void ScalarSwapEndian32(std::uint8_t* data, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i, data += 4)
+    {
+        std::swap(data[0], data[3]);
+        std::swap(data[1], data[2]);
+    }
+}
+
+
+/* ----- SSE2 kernels ----- */
+
+#if defined(AC_SIMD_SSE2)
+
+static void SSE2UInt8ToFloat(const std::uint8_t* src, float* dst, std::size_t n)
+{
+    const auto zero     = _mm_setzero_si128();
+    const auto scale    = _mm_set1_ps(1.0f / uint8HalfRange);
+    const auto offset   = _mm_set1_ps(-uint8NullPoint / uint8HalfRange);
+
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        auto v      = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        auto lo16   = _mm_unpacklo_epi8(v, zero);
+        auto hi16   = _mm_unpackhi_epi8(v, zero);
+
+        _mm_storeu_ps(dst + i     , _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo16, zero)), scale), offset));
+        _mm_storeu_ps(dst + i +  4, _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo16, zero)), scale), offset));
+        _mm_storeu_ps(dst + i +  8, _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi16, zero)), scale), offset));
+        _mm_storeu_ps(dst + i + 12, _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi16, zero)), scale), offset));
+    }
+
+    ScalarUInt8ToFloat(src + i, dst + i, n - i);
+}
+
+static void SSE2Int16ToFloat(const std::int16_t* src, float* dst, std::size_t n)
+{
+    const auto scale    = _mm_set1_ps(1.0f / int16HalfRange);
+    const auto offset   = _mm_set1_ps(-intNullPoint / int16HalfRange);
+
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        auto v  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        auto lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+        auto hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+
+        _mm_storeu_ps(dst + i    , _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(lo), scale), offset));
+        _mm_storeu_ps(dst + i + 4, _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(hi), scale), offset));
+    }
+
+    ScalarInt16ToFloat(src + i, dst + i, n - i);
+}
+
+static void SSE2Int32ToFloat(const std::int32_t* src, float* dst, std::size_t n)
+{
+    const auto scale    = _mm_set1_ps(1.0f / int32HalfRange);
+    const auto offset   = _mm_set1_ps(-intNullPoint / int32HalfRange);
+
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_ps(dst + i, _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(v), scale), offset));
+    }
+
+    ScalarInt32ToFloat(src + i, dst + i, n - i);
+}
+
+static __m128i SSE2FloatToInt(__m128 s, __m128 halfRange, __m128 nullPoint)
+{
+    /* Clamp to [-1, 1], scale, and round to nearest (default rounding mode of MXCSR) */
+    s = _mm_max_ps(_mm_set1_ps(-1.0f), _mm_min_ps(s, _mm_set1_ps(1.0f)));
+    return _mm_cvtps_epi32(_mm_add_ps(_mm_mul_ps(s, halfRange), nullPoint));
+}
+
+static void SSE2FloatToUInt8(const float* src, std::uint8_t* dst, std::size_t n)
+{
+    const auto halfRange = _mm_set1_ps(uint8HalfRange);
+    const auto nullPoint = _mm_set1_ps(uint8NullPoint);
+
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        auto a = SSE2FloatToInt(_mm_loadu_ps(src + i     ), halfRange, nullPoint);
+        auto b = SSE2FloatToInt(_mm_loadu_ps(src + i +  4), halfRange, nullPoint);
+        auto c = SSE2FloatToInt(_mm_loadu_ps(src + i +  8), halfRange, nullPoint);
+        auto d = SSE2FloatToInt(_mm_loadu_ps(src + i + 12), halfRange, nullPoint);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d)));
+    }
+
+    ScalarFloatToUInt8(src + i, dst + i, n - i);
+}
+
+static void SSE2FloatToInt16(const float* src, std::int16_t* dst, std::size_t n)
+{
+    const auto halfRange = _mm_set1_ps(int16HalfRange);
+    const auto nullPoint = _mm_set1_ps(intNullPoint);
+
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        auto a = SSE2FloatToInt(_mm_loadu_ps(src + i    ), halfRange, nullPoint);
+        auto b = SSE2FloatToInt(_mm_loadu_ps(src + i + 4), halfRange, nullPoint);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packs_epi32(a, b));
+    }
+
+    ScalarFloatToInt16(src + i, dst + i, n - i);
+}
+
+static void SSE2FloatToInt32(const float* src, std::int32_t* dst, std::size_t n)
+{
+    const auto halfRange = _mm_set1_ps(int32HalfRange);
+    const auto nullPoint = _mm_set1_ps(intNullPoint);
+    const auto upperEnd  = _mm_set1_ps(int32UpperEnd);
+
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        auto s = _mm_max_ps(_mm_set1_ps(-1.0f), _mm_min_ps(_mm_loadu_ps(src + i), _mm_set1_ps(1.0f)));
+        s = _mm_min_ps(_mm_add_ps(_mm_mul_ps(s, halfRange), nullPoint), upperEnd);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_cvtps_epi32(s));
+    }
+
+    ScalarFloatToInt32(src + i, dst + i, n - i);
+}
+
+static void SSE2FloatToFloat32(const float* src, float* dst, std::size_t n)
+{
+    const auto lower = _mm_set1_ps(-1.0f);
+    const auto upper = _mm_set1_ps(1.0f);
+
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm_storeu_ps(dst + i, _mm_max_ps(lower, _mm_min_ps(_mm_loadu_ps(src + i), upper)));
+
+    ScalarFloatToFloat32(src + i, dst + i, n - i);
+}
+
+static void SSE2Interleave2(const float* left, const float* right, std::size_t frames, float* dst)
+{
+    std::size_t i = 0;
+    for (; i + 4 <= frames; i += 4)
+    {
+        auto l = _mm_loadu_ps(left + i);
+        auto r = _mm_loadu_ps(right + i);
+        _mm_storeu_ps(dst + i*2    , _mm_unpacklo_ps(l, r));
+        _mm_storeu_ps(dst + i*2 + 4, _mm_unpackhi_ps(l, r));
+    }
+
+    ScalarInterleave2(left + i, right + i, frames - i, dst + i*2);
+}
+
+static void SSE2Deinterleave2(const float* src, std::size_t frames, float* left, float* right)
+{
+    const auto lower = _mm_set1_ps(-1.0f);
+    const auto upper = _mm_set1_ps(1.0f);
+
+    std::size_t i = 0;
+    for (; i + 4 <= frames; i += 4)
+    {
+        auto a = _mm_max_ps(lower, _mm_min_ps(_mm_loadu_ps(src + i*2    ), upper));
+        auto b = _mm_max_ps(lower, _mm_min_ps(_mm_loadu_ps(src + i*2 + 4), upper));
+        _mm_storeu_ps(left  + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+        _mm_storeu_ps(right + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+
+    ScalarDeinterleave2(src + i*2, frames - i, left + i, right + i);
+}
+
+static void SSE2SwapEndian16(std::uint8_t* data, std::size_t n)
+{
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        auto p = reinterpret_cast<__m128i*>(data + i*2);
+        auto v = _mm_loadu_si128(p);
+        _mm_storeu_si128(p, _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8)));
+    }
+
+    ScalarSwapEndian16(data + i*2, n - i);
+}
+
+static void SSE2SwapEndian32(std::uint8_t* data, std::size_t n)
+{
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        /* Swap bytes within each 16-bit word, then swap both words of each 32-bit lane */
+        auto p = reinterpret_cast<__m128i*>(data + i*4);
+        auto v = _mm_loadu_si128(p);
+        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+        _mm_storeu_si128(p, v);
+    }
+
+    ScalarSwapEndian32(data + i*4, n - i);
+}
+
+#endif // /AC_SIMD_SSE2
+
+
+/* ----- AVX2 kernels ----- */
+
+#if defined(AC_SIMD_AVX2)
+
+AC_TARGET_AVX2
+static void AVX2UInt8ToFloat(const std::uint8_t* src, float* dst, std::size_t n)
+{
+    const auto scale    = _mm256_set1_ps(1.0f / uint8HalfRange);
+    const auto offset   = _mm256_set1_ps(-uint8NullPoint / uint8HalfRange);
+
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        auto v = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i)));
+        _mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(v), scale), offset));
+    }
+
+    ScalarUInt8ToFloat(src + i, dst + i, n - i);
+}
+
+AC_TARGET_AVX2
+static void AVX2Int16ToFloat(const std::int16_t* src, float* dst, std::size_t n)
+{
+    const auto scale    = _mm256_set1_ps(1.0f / int16HalfRange);
+    const auto offset   = _mm256_set1_ps(-intNullPoint / int16HalfRange);
+
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        auto v = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+        _mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(v), scale), offset));
+    }
+
+    ScalarInt16ToFloat(src + i, dst + i, n - i);
+}
+
+AC_TARGET_AVX2
+static void AVX2Int24ToFloat(const std::uint8_t* src, float* dst, std::size_t n)
+{
+    const auto scale    = _mm256_set1_ps(1.0f / int24HalfRange);
+    const auto offset   = _mm256_set1_ps(-intNullPoint / int24HalfRange);
+
+    /* Move the 3 bytes of each sample into the upper 3 bytes of a 32-bit lane (0x80 clears the lowest byte) */
+    const auto shuffle  = _mm_setr_epi8(
+        -128, 0, 1, 2, -128, 3, 4, 5, -128, 6, 7, 8, -128, 9, 10, 11
+    );
+
+    /* Each iteration reads 16 bytes per 4 samples, so stop early enough to not read beyond the input */
+    std::size_t i = 0;
+    for (; i + 10 <= n; i += 8)
+    {
+        auto lo = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i*3     )), shuffle);
+        auto hi = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i*3 + 12)), shuffle);
+        auto v  = _mm256_srai_epi32(_mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1), 8);
+        _mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(v), scale), offset));
+    }
+
+    ScalarInt24ToFloat(src + i*3, dst + i, n - i);
+}
+
+AC_TARGET_AVX2
+static void AVX2Int32ToFloat(const std::int32_t* src, float* dst, std::size_t n)
+{
+    const auto scale    = _mm256_set1_ps(1.0f / int32HalfRange);
+    const auto offset   = _mm256_set1_ps(-intNullPoint / int32HalfRange);
+
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        _mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(v), scale), offset));
+    }
+
+    ScalarInt32ToFloat(src + i, dst + i, n - i);
+}
+
+AC_TARGET_AVX2
+static __m256i AVX2FloatToInt(__m256 s, __m256 halfRange, __m256 nullPoint)
+{
+    /* Clamp to [-1, 1], scale, and round to nearest (default rounding mode of MXCSR) */
+    s = _mm256_max_ps(_mm256_set1_ps(-1.0f), _mm256_min_ps(s, _mm256_set1_ps(1.0f)));
+    return _mm256_cvtps_epi32(_mm256_add_ps(_mm256_mul_ps(s, halfRange), nullPoint));
+}
+
+AC_TARGET_AVX2
+static void AVX2FloatToUInt8(const float* src, std::uint8_t* dst, std::size_t n)
+{
+    const auto halfRange = _mm256_set1_ps(uint8HalfRange);
+    const auto nullPoint = _mm256_set1_ps(uint8NullPoint);
+
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        auto a = AVX2FloatToInt(_mm256_loadu_ps(src + i    ), halfRange, nullPoint);
+        auto b = AVX2FloatToInt(_mm256_loadu_ps(src + i + 8), halfRange, nullPoint);
+
+        /* Pack to 16-bit (packing works per 128-bit lane, so restore the order afterwards) and then to 8-bit */
+        auto v = _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), 0xD8);
+        auto u = _mm_packus_epi16(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), u);
+    }
+
+    ScalarFloatToUInt8(src + i, dst + i, n - i);
+}
+
+AC_TARGET_AVX2
+static void AVX2FloatToInt16(const float* src, std::int16_t* dst, std::size_t n)
+{
+    const auto halfRange = _mm256_set1_ps(int16HalfRange);
+    const auto nullPoint = _mm256_set1_ps(intNullPoint);
+
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        auto a = AVX2FloatToInt(_mm256_loadu_ps(src + i    ), halfRange, nullPoint);
+        auto b = AVX2FloatToInt(_mm256_loadu_ps(src + i + 8), halfRange, nullPoint);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), 0xD8));
+    }
+
+    ScalarFloatToInt16(src + i, dst + i, n - i);
+}
+
+AC_TARGET_AVX2
+static void AVX2FloatToInt24(const float* src, std::uint8_t* dst, std::size_t n)
+{
+    const auto halfRange = _mm_set1_ps(int24HalfRange);
+    const auto nullPoint = _mm_set1_ps(intNullPoint);
+
+    /* Move the lower 3 bytes of each 32-bit lane into 12 consecutive bytes */
+    const auto shuffle = _mm_setr_epi8(
+        0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -128, -128, -128, -128
+    );
+
+    /* Each iteration writes 16 bytes per 4 samples, so stop early enough to not write beyond the output */
+    std::size_t i = 0;
+    for (; i + 6 <= n; i += 4)
+    {
+        auto s = _mm_max_ps(_mm_set1_ps(-1.0f), _mm_min_ps(_mm_loadu_ps(src + i), _mm_set1_ps(1.0f)));
+        auto v = _mm_cvtps_epi32(_mm_add_ps(_mm_mul_ps(s, halfRange), nullPoint));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i*3), _mm_shuffle_epi8(v, shuffle));
+    }
+
+    ScalarFloatToInt24(src + i, dst + i*3, n - i);
+}
+
+AC_TARGET_AVX2
+static void AVX2FloatToInt32(const float* src, std::int32_t* dst, std::size_t n)
+{
+    const auto halfRange = _mm256_set1_ps(int32HalfRange);
+    const auto nullPoint = _mm256_set1_ps(intNullPoint);
+    const auto upperEnd  = _mm256_set1_ps(int32UpperEnd);
+
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        auto s = _mm256_max_ps(_mm256_set1_ps(-1.0f), _mm256_min_ps(_mm256_loadu_ps(src + i), _mm256_set1_ps(1.0f)));
+        s = _mm256_min_ps(_mm256_add_ps(_mm256_mul_ps(s, halfRange), nullPoint), upperEnd);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_cvtps_epi32(s));
+    }
+
+    ScalarFloatToInt32(src + i, dst + i, n - i);
+}
+
+AC_TARGET_AVX2
+static void AVX2FloatToFloat32(const float* src, float* dst, std::size_t n)
+{
+    const auto lower = _mm256_set1_ps(-1.0f);
+    const auto upper = _mm256_set1_ps(1.0f);
+
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm256_storeu_ps(dst + i, _mm256_max_ps(lower, _mm256_min_ps(_mm256_loadu_ps(src + i), upper)));
+
+    ScalarFloatToFloat32(src + i, dst + i, n - i);
+}
+
+AC_TARGET_AVX2
+static void AVX2SwapEndian16(std::uint8_t* data, std::size_t n)
+{
+    const auto shuffle = _mm256_setr_epi8(
+        1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+        1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14
+    );
+
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        auto p = reinterpret_cast<__m256i*>(data + i*2);
+        _mm256_storeu_si256(p, _mm256_shuffle_epi8(_mm256_loadu_si256(p), shuffle));
+    }
+
+    ScalarSwapEndian16(data + i*2, n - i);
+}
+
+AC_TARGET_AVX2
+static void AVX2SwapEndian24(std::uint8_t* data, std::size_t n)
+{
+    /* Reverse 5 samples (15 bytes) at once, the last byte is left unchanged */
+    const auto shuffle = _mm_setr_epi8(
+        2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 14, 13, 12, 15
+    );
+
+    /* Each iteration reads and writes 16 bytes per 5 samples, so stop early enough to not go beyond the buffer */
+    std::size_t i = 0;
+    for (; i + 6 <= n; i += 5)
+    {
+        auto p = reinterpret_cast<__m128i*>(data + i*3);
+        _mm_storeu_si128(p, _mm_shuffle_epi8(_mm_loadu_si128(p), shuffle));
+    }
+
+    ScalarSwapEndian24(data + i*3, n - i);
+}
+
+AC_TARGET_AVX2
+static void AVX2SwapEndian32(std::uint8_t* data, std::size_t n)
+{
+    const auto shuffle = _mm256_setr_epi8(
+        3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+        3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12
+    );
+
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        auto p = reinterpret_cast<__m256i*>(data + i*4);
+        _mm256_storeu_si256(p, _mm256_shuffle_epi8(_mm256_loadu_si256(p), shuffle));
+    }
+
+    ScalarSwapEndian32(data + i*4, n - i);
+}
+
+#endif // /AC_SIMD_AVX2
+
+
+/* ----- NEON kernels ----- */
+
+#if defined(AC_SIMD_NEON)
+
+static void NEONUInt8ToFloat(const std::uint8_t* src, float* dst, std::size_t n)
+{
+    const auto scale    = vdupq_n_f32(1.0f / uint8HalfRange);
+    const auto offset   = vdupq_n_f32(-uint8NullPoint / uint8HalfRange);
+
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        auto v = vmovl_u8(vld1_u8(src + i));
+        vst1q_f32(dst + i    , vmlaq_f32(offset, vcvtq_f32_u32(vmovl_u16(vget_low_u16(v))), scale));
+        vst1q_f32(dst + i + 4, vmlaq_f32(offset, vcvtq_f32_u32(vmovl_u16(vget_high_u16(v))), scale));
+    }
+
+    ScalarUInt8ToFloat(src + i, dst + i, n - i);
+}
+
+static void NEONInt16ToFloat(const std::int16_t* src, float* dst, std::size_t n)
+{
+    const auto scale    = vdupq_n_f32(1.0f / int16HalfRange);
+    const auto offset   = vdupq_n_f32(-intNullPoint / int16HalfRange);
+
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        auto v = vld1q_s16(src + i);
+        vst1q_f32(dst + i    , vmlaq_f32(offset, vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), scale));
+        vst1q_f32(dst + i + 4, vmlaq_f32(offset, vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), scale));
+    }
+
+    ScalarInt16ToFloat(src + i, dst + i, n - i);
+}
+
+static void NEONInt32ToFloat(const std::int32_t* src, float* dst, std::size_t n)
+{
+    const auto scale    = vdupq_n_f32(1.0f / int32HalfRange);
+    const auto offset   = vdupq_n_f32(-intNullPoint / int32HalfRange);
+
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        vst1q_f32(dst + i, vmlaq_f32(offset, vcvtq_f32_s32(vld1q_s32(src + i)), scale));
+
+    ScalarInt32ToFloat(src + i, dst + i, n - i);
+}
+
+static int32x4_t NEONFloatToInt(float32x4_t s, float32x4_t halfRange, float32x4_t nullPoint)
+{
+    /* Clamp to [-1, 1], scale, and round to nearest */
+    s = vmaxq_f32(vdupq_n_f32(-1.0f), vminq_f32(s, vdupq_n_f32(1.0f)));
+    return vcvtnq_s32_f32(vmlaq_f32(nullPoint, s, halfRange));
+}
+
+static void NEONFloatToUInt8(const float* src, std::uint8_t* dst, std::size_t n)
+{
+    const auto halfRange = vdupq_n_f32(uint8HalfRange);
+    const auto nullPoint = vdupq_n_f32(uint8NullPoint);
+
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        auto a = vqmovn_s32(NEONFloatToInt(vld1q_f32(src + i    ), halfRange, nullPoint));
+        auto b = vqmovn_s32(NEONFloatToInt(vld1q_f32(src + i + 4), halfRange, nullPoint));
+        vst1_u8(dst + i, vqmovun_s16(vcombine_s16(a, b)));
+    }
+
+    ScalarFloatToUInt8(src + i, dst + i, n - i);
+}
+
+static void NEONFloatToInt16(const float* src, std::int16_t* dst, std::size_t n)
+{
+    const auto halfRange = vdupq_n_f32(int16HalfRange);
+    const auto nullPoint = vdupq_n_f32(intNullPoint);
+
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        auto a = vqmovn_s32(NEONFloatToInt(vld1q_f32(src + i    ), halfRange, nullPoint));
+        auto b = vqmovn_s32(NEONFloatToInt(vld1q_f32(src + i + 4), halfRange, nullPoint));
+        vst1q_s16(dst + i, vcombine_s16(a, b));
+    }
+
+    ScalarFloatToInt16(src + i, dst + i, n - i);
+}
+
+static void NEONFloatToInt32(const float* src, std::int32_t* dst, std::size_t n)
+{
+    const auto halfRange = vdupq_n_f32(int32HalfRange);
+    const auto nullPoint = vdupq_n_f32(intNullPoint);
+    const auto upperEnd  = vdupq_n_f32(int32UpperEnd);
+
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        auto s = vmaxq_f32(vdupq_n_f32(-1.0f), vminq_f32(vld1q_f32(src + i), vdupq_n_f32(1.0f)));
+        vst1q_s32(dst + i, vcvtnq_s32_f32(vminq_f32(vmlaq_f32(nullPoint, s, halfRange), upperEnd)));
+    }
+
+    ScalarFloatToInt32(src + i, dst + i, n - i);
+}
+
+static void NEONFloatToFloat32(const float* src, float* dst, std::size_t n)
+{
+    const auto lower = vdupq_n_f32(-1.0f);
+    const auto upper = vdupq_n_f32(1.0f);
+
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        vst1q_f32(dst + i, vmaxq_f32(lower, vminq_f32(vld1q_f32(src + i), upper)));
+
+    ScalarFloatToFloat32(src + i, dst + i, n - i);
+}
+
+static void NEONInterleave2(const float* left, const float* right, std::size_t frames, float* dst)
+{
+    std::size_t i = 0;
+    for (; i + 4 <= frames; i += 4)
+    {
+        float32x4x2_t v;
+        v.val[0] = vld1q_f32(left + i);
+        v.val[1] = vld1q_f32(right + i);
+        vst2q_f32(dst + i*2, v);
+    }
+
+    ScalarInterleave2(left + i, right + i, frames - i, dst + i*2);
+}
+
+static void NEONDeinterleave2(const float* src, std::size_t frames, float* left, float* right)
+{
+    const auto lower = vdupq_n_f32(-1.0f);
+    const auto upper = vdupq_n_f32(1.0f);
+
+    std::size_t i = 0;
+    for (; i + 4 <= frames; i += 4)
+    {
+        auto v = vld2q_f32(src + i*2);
+        vst1q_f32(left  + i, vmaxq_f32(lower, vminq_f32(v.val[0], upper)));
+        vst1q_f32(right + i, vmaxq_f32(lower, vminq_f32(v.val[1], upper)));
+    }
+
+    ScalarDeinterleave2(src + i*2, frames - i, left + i, right + i);
+}
+
+static void NEONSwapEndian16(std::uint8_t* data, std::size_t n)
+{
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        vst1q_u8(data + i*2, vrev16q_u8(vld1q_u8(data + i*2)));
+
+    ScalarSwapEndian16(data + i*2, n - i);
+}
+
+static void NEONSwapEndian24(std::uint8_t* data, std::size_t n)
+{
+    /* Load 16 samples deinterleaved into their 3 bytes and swap the first and last byte */
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        auto v = vld3q_u8(data + i*3);
+        std::swap(v.val[0], v.val[2]);
+        vst3q_u8(data + i*3, v);
+    }
+
+    ScalarSwapEndian24(data + i*3, n - i);
+}
+
+static void NEONSwapEndian32(std::uint8_t* data, std::size_t n)
+{
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        vst1q_u8(data + i*4, vrev32q_u8(vld1q_u8(data + i*4)));
+
+    ScalarSwapEndian32(data + i*4, n - i);
+}
+
+#endif // /AC_SIMD_NEON
+
+
+/* ----- Kernel selection ----- */
+
+struct PCMKernels
+{
+    void (*uint8ToFloat     )(const std::uint8_t*, float*, std::size_t)         = ScalarUInt8ToFloat;
+    void (*int16ToFloat     )(const std::int16_t*, float*, std::size_t)         = ScalarInt16ToFloat;
+    void (*int24ToFloat     )(const std::uint8_t*, float*, std::size_t)         = ScalarInt24ToFloat;
+    void (*int32ToFloat     )(const std::int32_t*, float*, std::size_t)         = ScalarInt32ToFloat;
+    void (*floatToUInt8     )(const float*, std::uint8_t*, std::size_t)         = ScalarFloatToUInt8;
+    void (*floatToInt16     )(const float*, std::int16_t*, std::size_t)         = ScalarFloatToInt16;
+    void (*floatToInt24     )(const float*, std::uint8_t*, std::size_t)         = ScalarFloatToInt24;
+    void (*floatToInt32     )(const float*, std::int32_t*, std::size_t)         = ScalarFloatToInt32;
+    void (*floatToFloat32   )(const float*, float*, std::size_t)                = ScalarFloatToFloat32;
+    void (*interleave2      )(const float*, const float*, std::size_t, float*)  = ScalarInterleave2;
+    void (*deinterleave2    )(const float*, std::size_t, float*, float*)        = ScalarDeinterleave2;
+    void (*swapEndian16     )(std::uint8_t*, std::size_t)                       = ScalarSwapEndian16;
+    void (*swapEndian24     )(std::uint8_t*, std::size_t)                       = ScalarSwapEndian24;
+    void (*swapEndian32     )(std::uint8_t*, std::size_t)                       = ScalarSwapEndian32;
+};
+
+static PCMKernels SelectPCMKernels()
+{
+    PCMKernels kernels;
+
+    const auto& features = GetCPUFeatures();
+    (void)features;
+
+    #if defined(AC_SIMD_SSE2)
+    if (features.sse2)
+    {
+        kernels.uint8ToFloat    = SSE2UInt8ToFloat;
+        kernels.int16ToFloat    = SSE2Int16ToFloat;
+        kernels.int32ToFloat    = SSE2Int32ToFloat;
+        kernels.floatToUInt8    = SSE2FloatToUInt8;
+        kernels.floatToInt16    = SSE2FloatToInt16;
+        kernels.floatToInt32    = SSE2FloatToInt32;
+        kernels.floatToFloat32  = SSE2FloatToFloat32;
+        kernels.interleave2     = SSE2Interleave2;
+        kernels.deinterleave2   = SSE2Deinterleave2;
+        kernels.swapEndian16    = SSE2SwapEndian16;
+        kernels.swapEndian32    = SSE2SwapEndian32;
+    }
+    #endif
+
+    #if defined(AC_SIMD_AVX2)
+    if (features.avx2)
+    {
+        kernels.uint8ToFloat    = AVX2UInt8ToFloat;
+        kernels.int16ToFloat    = AVX2Int16ToFloat;
+        kernels.int24ToFloat    = AVX2Int24ToFloat;
+        kernels.int32ToFloat    = AVX2Int32ToFloat;
+        kernels.floatToUInt8    = AVX2FloatToUInt8;
+        kernels.floatToInt16    = AVX2FloatToInt16;
+        kernels.floatToInt24    = AVX2FloatToInt24;
+        kernels.floatToInt32    = AVX2FloatToInt32;
+        kernels.floatToFloat32  = AVX2FloatToFloat32;
+        kernels.swapEndian16    = AVX2SwapEndian16;
+        kernels.swapEndian24    = AVX2SwapEndian24;
+        kernels.swapEndian32    = AVX2SwapEndian32;
+    }
+    #endif
+
+    #if defined(AC_SIMD_NEON)
+    if (features.neon)
+    {
+        kernels.uint8ToFloat    = NEONUInt8ToFloat;
+        kernels.int16ToFloat    = NEONInt16ToFloat;
+        kernels.int32ToFloat    = NEONInt32ToFloat;
+        kernels.floatToUInt8    = NEONFloatToUInt8;
+        kernels.floatToInt16    = NEONFloatToInt16;
+        kernels.floatToInt32    = NEONFloatToInt32;
+        kernels.floatToFloat32  = NEONFloatToFloat32;
+        kernels.interleave2     = NEONInterleave2;
+        kernels.deinterleave2   = NEONDeinterleave2;
+        kernels.swapEndian16    = NEONSwapEndian16;
+        kernels.swapEndian24    = NEONSwapEndian24;
+        kernels.swapEndian32    = NEONSwapEndian32;
+    }
+    #endif
+
+    return kernels;
+}
+
+static const PCMKernels& GetPCMKernels()
+{
+    static const PCMKernels kernels = SelectPCMKernels();
+    return kernels;
+}
+
+
+/* ----- Global functions ----- */
+
+PCMType GetPCMType(const WaveBufferFormat& format)
+{
+    if (format.floatingPoint)
+        return (format.bitsPerSample == 32 ? PCMType::Float32 : PCMType::Unsupported);
+
+    switch (format.bitsPerSample)
+    {
+        case 8:
+            return PCMType::UInt8;
+        case 16:
+            return PCMType::Int16;
+        case 24:
+            return PCMType::Int24;
+        case 32:
+            return PCMType::Int32;
+        default:
+            return PCMType::Unsupported;
+    }
+}
+
+std::size_t GetPCMTypeSize(const PCMType type)
+{
+    switch (type)
+    {
+        case PCMType::UInt8:
+            return 1;
+        case PCMType::Int16:
+            return 2;
+        case PCMType::Int24:
+            return 3;
+        case PCMType::Int32:
+        case PCMType::Float32:
+            return 4;
+        default:
+            return 0;
+    }
+}
+
+void ConvertPCMToFloat(const PCMType type, const void* src, float* dst, std::size_t n)
+{
+    const auto& kernels = GetPCMKernels();
+    switch (type)
+    {
+        case PCMType::UInt8:
+            kernels.uint8ToFloat(reinterpret_cast<const std::uint8_t*>(src), dst, n);
+            break;
+        case PCMType::Int16:
+            kernels.int16ToFloat(reinterpret_cast<const std::int16_t*>(src), dst, n);
+            break;
+        case PCMType::Int24:
+            kernels.int24ToFloat(reinterpret_cast<const std::uint8_t*>(src), dst, n);
+            break;
+        case PCMType::Int32:
+            kernels.int32ToFloat(reinterpret_cast<const std::int32_t*>(src), dst, n);
+            break;
+        case PCMType::Float32:
+            std::memcpy(dst, src, n * sizeof(float));
+            break;
+        default:
+            std::fill(dst, dst + n, 0.0f);
+            break;
+    }
+}
+
+void ConvertFloatToPCM(const PCMType type, const float* src, void* dst, std::size_t n)
+{
+    const auto& kernels = GetPCMKernels();
+    switch (type)
+    {
+        case PCMType::UInt8:
+            kernels.floatToUInt8(src, reinterpret_cast<std::uint8_t*>(dst), n);
+            break;
+        case PCMType::Int16:
+            kernels.floatToInt16(src, reinterpret_cast<std::int16_t*>(dst), n);
+            break;
+        case PCMType::Int24:
+            kernels.floatToInt24(src, reinterpret_cast<std::uint8_t*>(dst), n);
+            break;
+        case PCMType::Int32:
+            kernels.floatToInt32(src, reinterpret_cast<std::int32_t*>(dst), n);
+            break;
+        case PCMType::Float32:
+            kernels.floatToFloat32(src, reinterpret_cast<float*>(dst), n);
+            break;
+        default:
+            break;
+    }
+}
+
+// Number of samples which are converted at once with an intermediate floating-point buffer
+static const std::size_t doubleConversionBlockSize = 256;
+
+void ConvertPCMToDouble(const PCMType type, const void* src, double* dst, std::size_t n)
+{
+    switch (type)
+    {
+        case PCMType::Int24:
+        {
+            /* 24-bit integers exceed the precision of 32-bit floating-points, so convert them directly */
+            auto data = reinterpret_cast<const std::uint8_t*>(src);
+            for (std::size_t i = 0; i < n; ++i, data += 3)
+                PCMInt24ToSample(dst[i], data);
+        }
+        break;
+
+        case PCMType::Int32:
+        {
+            /* 32-bit integers exceed the precision of 32-bit floating-points, so convert them directly */
+            auto data = reinterpret_cast<const std::int32_t*>(src);
+            for (std::size_t i = 0; i < n; ++i)
+                PCMDataToSample(dst[i], data[i]);
+        }
+        break;
+
+        default:
+        {
+            /* Convert block-wise with the floating-point kernels, then widen to double precision */
+            float block[doubleConversionBlockSize];
+
+            auto data = reinterpret_cast<const char*>(src);
+            auto size = GetPCMTypeSize(type);
+
+            for (std::size_t i = 0; i < n; i += doubleConversionBlockSize)
+            {
+                auto len = std::min(doubleConversionBlockSize, n - i);
+                ConvertPCMToFloat(type, data + i*size, block, len);
+                std::copy(block, block + len, dst + i);
+            }
+        }
+        break;
+    }
+}
+
+void ConvertDoubleToPCM(const PCMType type, const double* src, void* dst, std::size_t n)
+{
+    switch (type)
+    {
+        case PCMType::Int24:
+        {
+            /* 24-bit integers exceed the precision of 32-bit floating-points, so convert them directly */
+            auto data = reinterpret_cast<std::uint8_t*>(dst);
+            for (std::size_t i = 0; i < n; ++i, data += 3)
+                SampleToPCMInt24(data, src[i]);
+        }
+        break;
+
+        case PCMType::Int32:
+        {
+            /* 32-bit integers exceed the precision of 32-bit floating-points, so convert them directly */
+            auto data = reinterpret_cast<std::int32_t*>(dst);
+            for (std::size_t i = 0; i < n; ++i)
+                SampleToPCMData(data[i], src[i]);
+        }
+        break;
+
+        default:
+        {
+            /* Narrow to single precision, then convert block-wise with the floating-point kernels */
+            float block[doubleConversionBlockSize];
+
+            auto data = reinterpret_cast<char*>(dst);
+            auto size = GetPCMTypeSize(type);
+
+            for (std::size_t i = 0; i < n; i += doubleConversionBlockSize)
+            {
+                auto len = std::min(doubleConversionBlockSize, n - i);
+                std::copy(src + i, src + i + len, block);
+                ConvertFloatToPCM(type, block, data + i*size, len);
+            }
+        }
+        break;
+    }
+}
+
+void InterleaveSamples(const float* planes, std::size_t planeStride, std::size_t frames, std::uint16_t channels, float* dst)
+{
+    switch (channels)
+    {
+        case 1:
+            std::copy(planes, planes + frames, dst);
+            break;
+        case 2:
+            GetPCMKernels().interleave2(planes, planes + planeStride, frames, dst);
+            break;
+        default:
+            for (std::uint16_t chn = 0; chn < channels; ++chn)
+            {
+                auto plane = planes + chn*planeStride;
+                for (std::size_t i = 0; i < frames; ++i)
+                    dst[i*channels + chn] = plane[i];
+            }
+            break;
+    }
+}
+
+void DeinterleaveSamples(const float* src, std::size_t frames, std::uint16_t channels, float* planes, std::size_t planeStride)
+{
+    const auto& kernels = GetPCMKernels();
+    switch (channels)
+    {
+        case 1:
+            kernels.floatToFloat32(src, planes, frames);
+            break;
+        case 2:
+            kernels.deinterleave2(src, frames, planes, planes + planeStride);
+            break;
+        default:
+            for (std::uint16_t chn = 0; chn < channels; ++chn)
+            {
+                auto plane = planes + chn*planeStride;
+                for (std::size_t i = 0; i < frames; ++i)
+                    plane[i] = ClampSample(src[i*channels + chn]);
+            }
+            break;
+    }
+}
+
+void SwapPCMEndianness(const PCMType type, void* data, std::size_t n)
+{
+    const auto& kernels = GetPCMKernels();
+    auto bytes = reinterpret_cast<std::uint8_t*>(data);
+
+    switch (type)
+    {
+        case PCMType::Int16:
+            kernels.swapEndian16(bytes, n);
+            break;
+        case PCMType::Int24:
+            kernels.swapEndian24(bytes, n);
+            break;
+        case PCMType::Int32:
+        case PCMType::Float32:
+            kernels.swapEndian32(bytes, n);
+            break;
+        default:
+            break;
+    }
+}
+
+
+} // /namespace Ac
+
+
+
+// ================================================================================
@@ -0,0 +1,85 @@
+/*
+ * PCMConversion.h
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef AC_PCM_CONVERSION_H
+#define AC_PCM_CONVERSION_H
+
+
+#include <Ac/WaveBufferFormat.h>
+#include <cstddef>
+#include <cstdint>
+
+
+namespace Ac
+{
+
+
+//! PCM sample types which are supported by the bulk conversion kernels.
+enum class PCMType
+{
+    Unsupported,
+    UInt8,      //!< Unsigned 8-bit integer.
+    Int16,      //!< Signed 16-bit integer.
+    Int24,      //!< Signed 24-bit integer (packed into 3 bytes, little-endian).
+    Int32,      //!< Signed 32-bit integer.
+    Float32,    //!< 32-bit IEEE 754 floating-point.
+};
+
+//! Returns the PCM sample type for the specified wave buffer format.
+PCMType GetPCMType(const WaveBufferFormat& format);
+
+//! Returns the size (in bytes) of a single sample of the specified PCM type.
+std::size_t GetPCMTypeSize(const PCMType type);
+
+/* ----- Conversion kernels ----- */
+
+/*
+All kernels below are selected once at runtime for the SIMD instruction set of the host CPU (AVX2, SSE2, NEON, or scalar fallback).
+Integer samples are mapped to the range [-1, 1] by the same affine mapping as in "PCMDataToSample".
+Floating-points are mapped back to integer samples with saturation and rounding to the nearest integer,
+so that converting 8- and 16-bit samples to floating-points and back reproduces the original samples.
+24- and 32-bit samples exceed the precision of single precision floating-points; the double precision functions are lossless for them.
+*/
+
+//! Converts 'n' PCM samples of the specified type into normalized floating-points.
+void ConvertPCMToFloat(const PCMType type, const void* src, float* dst, std::size_t n);
+
+//! Converts 'n' normalized floating-points into PCM samples of the specified type. Each sample is clamped to [-1, 1].
+void ConvertFloatToPCM(const PCMType type, const float* src, void* dst, std::size_t n);
+
+//! Converts 'n' PCM samples of the specified type into normalized double precision floating-points.
+void ConvertPCMToDouble(const PCMType type, const void* src, double* dst, std::size_t n);
+
+//! Converts 'n' normalized double precision floating-points into PCM samples of the specified type. Each sample is clamped to [-1, 1].
+void ConvertDoubleToPCM(const PCMType type, const double* src, void* dst, std::size_t n);
+
+/**
+\brief Interleaves the samples of all channel arrays.
+\param[in] planes Pointer to the first channel array. The channel arrays must be 'planeStride' samples apart from each other.
+\param[out] dst Output array of 'frames * channels' interleaved samples.
+*/
+void InterleaveSamples(const float* planes, std::size_t planeStride, std::size_t frames, std::uint16_t channels, float* dst);
+
+/**
+\brief Deinterleaves the samples into all channel arrays. Each sample is clamped to [-1, 1].
+\param[in] src Input array of 'frames * channels' interleaved samples.
+\param[out] planes Pointer to the first channel array. The channel arrays must be 'planeStride' samples apart from each other.
+*/
+void DeinterleaveSamples(const float* src, std::size_t frames, std::uint16_t channels, float* planes, std::size_t planeStride);
+
+//! Swaps the byte order of 'n' PCM samples of the specified type. This has no effect on 8-bit samples.
+void SwapPCMEndianness(const PCMType type, void* data, std::size_t n);
+
+
+} // /namespace Ac
+
+
+#endif
+
+
+
+// ================================================================================
@@ -12,6 +12,7 @@
 #include <cstdint>
 #include <limits>
 #include <algorithm>
+#include <cmath>
 
 
 namespace Ac
@@ -21,6 +22,9 @@ namespace Ac
 union PCMSample
 {
     void*           raw;
+    float*          float32;
+    std::int32_t*   bits32;
+    std::uint8_t*   bits24;
     std::int16_t*   bits16;
     std::uint8_t*   bits8;
 };
@@ -28,6 +32,9 @@ union PCMSample
 union PCMSampleConst
 {
     const void*         raw;
+    const float*        float32;
+    const std::int32_t* bits32;
+    const std::uint8_t* bits24;
     const std::int16_t* bits16;
     const std::uint8_t* bits8;
 };
@@ -67,13 +74,75 @@ void PCMDataToSample(double& sample, const T data)
 template <typename T>
 void SampleToPCMData(T& data, double sample)
 {
-    /* Scale sample and clamp into range [min, max] */
+    /* Scale sample, clamp into range [min, max], and round to the nearest integer */
     const auto limits = GetPCMLimits<T>();
 
     sample = sample * (limits.range*0.5) + limits.nullPoint;
     sample = std::max(limits.lowerEnd, std::min(sample, limits.upperEnd));
 
-    data = static_cast<T>(sample);
+    data = static_cast<T>(std::lrint(sample));
+}
+
+//! Floating-point samples are stored without scaling.
+inline void PCMDataToSample(double& sample, const float data)
+{
+    sample = static_cast<double>(data);
+}
+
+//! Floating-point samples are stored without scaling, but clamped into range [-1, 1].
+inline void SampleToPCMData(float& data, double sample)
+{
+    data = static_cast<float>(std::max(-1.0, std::min(sample, 1.0)));
+}
+
+//! Returns the signed 24-bit integer, which is packed into 3 bytes in little-endian byte order.
+inline std::int32_t UnpackPCMInt24(const std::uint8_t* data)
+{
+    auto bits = (static_cast<std::uint32_t>(data[0]) << 8) | (static_cast<std::uint32_t>(data[1]) << 16) | (static_cast<std::uint32_t>(data[2]) << 24);
+    return (static_cast<std::int32_t>(bits) >> 8);
+}
+
+//! Packs the signed 24-bit integer into 3 bytes in little-endian byte order.
+inline void PackPCMInt24(std::uint8_t* data, std::int32_t value)
+{
+    auto bits = static_cast<std::uint32_t>(value);
+    data[0] = static_cast<std::uint8_t>(bits      );
+    data[1] = static_cast<std::uint8_t>(bits >>  8);
+    data[2] = static_cast<std::uint8_t>(bits >> 16);
+}
+
+//! Limits of signed 24-bit integers (see GetPCMLimits).
+inline PCMLimits GetPCMInt24Limits()
+{
+    PCMLimits limits;
+
+    limits.lowerEnd     = -8388608.0;
+    limits.upperEnd     = 8388607.0;
+
+    limits.range        = limits.upperEnd - limits.lowerEnd;
+    limits.nullPoint    = 0.5*(limits.lowerEnd + limits.upperEnd);
+
+    return limits;
+}
+
+//! Converts the signed 24-bit integer (packed into 3 bytes) into a sample.
+inline void PCMInt24ToSample(double& sample, const std::uint8_t* data)
+{
+    const auto limits = GetPCMInt24Limits();
+
+    sample = static_cast<double>(UnpackPCMInt24(data));
+    sample = (sample - limits.nullPoint) / (limits.range*0.5);
+}
+
+//! Converts the sample into a signed 24-bit integer (packed into 3 bytes).
+inline void SampleToPCMInt24(std::uint8_t* data, double sample)
+{
+    const auto limits = GetPCMInt24Limits();
+
+    sample = sample * (limits.range*0.5) + limits.nullPoint;
+    sample = std::max(limits.lowerEnd, std::min(sample, limits.upperEnd));
+
+    PackPCMInt24(data, static_cast<std::int32_t>(std::lrint(sample)));
 }
 
 
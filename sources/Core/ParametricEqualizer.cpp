@@ -0,0 +1,93 @@
+/*
+ * ParametricEqualizer.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include <Ac/ParametricEqualizer.h>
+#include <stdexcept>
+
+
+namespace Ac
+{
+
+
+ParametricEqualizer::ParametricEqualizer(std::uint32_t sampleRate, std::uint16_t channels) :
+    sampleRate_ { sampleRate },
+    channels_   { channels   }
+{
+    if (sampleRate == 0)
+        throw std::invalid_argument("sample rate of parametric equalizer must not be zero");
+    if (channels == 0)
+        throw std::invalid_argument("number of channels of parametric equalizer must not be zero");
+}
+
+std::size_t ParametricEqualizer::AddBand(const EqualizerBand& band)
+{
+    /* Compute coefficients first, which validates the band */
+    auto coefficients = BiquadCoefficients::Compute(band.type, sampleRate_, band.frequency, band.q, band.gain);
+
+    BiquadFilterBank filter(channels_);
+    {
+        filter.SetSmoothingFrames(smoothingFrames_);
+        filter.SetFilter(coefficients, true);
+    }
+    filters_.push_back(std::move(filter));
+    bands_.push_back(band);
+
+    return (bands_.size() - 1);
+}
+
+void ParametricEqualizer::SetBand(std::size_t index, const EqualizerBand& band)
+{
+    if (index >= bands_.size())
+        throw std::out_of_range("band index of parametric equalizer out of range");
+
+    filters_[index].SetFilter(BiquadCoefficients::Compute(band.type, sampleRate_, band.frequency, band.q, band.gain));
+    bands_[index] = band;
+}
+
+const EqualizerBand& ParametricEqualizer::GetBand(std::size_t index) const
+{
+    if (index >= bands_.size())
+        throw std::out_of_range("band index of parametric equalizer out of range");
+    return bands_[index];
+}
+
+void ParametricEqualizer::ClearBands()
+{
+    bands_.clear();
+    filters_.clear();
+}
+
+void ParametricEqualizer::SetSmoothingFrames(std::size_t frames)
+{
+    smoothingFrames_ = frames;
+    for (auto& filter : filters_)
+        filter.SetSmoothingFrames(frames);
+}
+
+void ParametricEqualizer::Process(float* samples, std::size_t frames)
+{
+    for (auto& filter : filters_)
+        filter.Process(samples, frames);
+}
+
+void ParametricEqualizer::Reset()
+{
+    for (auto& filter : filters_)
+        filter.Reset();
+}
+
+std::uint16_t ParametricEqualizer::GetChannels() const
+{
+    return channels_;
+}
+
+
+} // /namespace Ac
+
+
+
+// ================================================================================
@@ -21,21 +21,22 @@ namespace Ac
 {
 
 
+// Maximal number of time points which are evaluated at once, octave by octave.
+static const std::size_t maxNoiseBlockSize = 256;
+
 PerlinNoise::PerlinNoise()
 {
-    GenerateGradients();
     Seed(0);
 }
 
 PerlinNoise::PerlinNoise(unsigned int seed)
 {
-    GenerateGradients();
     Seed(seed);
 }
 
 void PerlinNoise::Seed(unsigned int seed)
 {
-    GeneratePermutations(seed);
+    GenerateGradients(seed);
 }
 
 static int ModuloSignInt(int a, int b)
@@ -43,19 +44,19 @@ static int ModuloSignInt(int a, int b)
     return (((a % b + b)) % b);
 }
 
+// Returns the quintic fade curve 6t^5 - 15t^4 + 10t^3.
+static double Fade(double t)
+{
+    return t*t*t*(t*(t*6.0 - 15.0) + 10.0);
+}
+
 double PerlinNoise::Noise(double t, std::uint32_t frequency) const
 {
     frequency = std::max(1u, frequency);
 
-    auto Fade = [](double t) -> double
-    {
-        return t*t*t*(t*(t*6.0 - 15.0) + 10.0);
-    };
-
     auto Surflet = [&](std::uint32_t i)
     {
-        const auto& p = perm_;
-        auto hash = p[ ModuloSignInt(i, frequency) ];
+        auto hash = (ModuloSignInt(i, frequency) & 0xFF);
 
         auto dist = t - static_cast<double>(i);
         auto grad = dist * grads_[hash];
@@ -87,32 +88,120 @@ double PerlinNoise::Noise(double t, std::uint32_t frequency, std::uint32_t octav
     return noise;
 }
 
+void PerlinNoise::Noise(
+    const double* timePoints, double* noise, std::size_t count, std::uint32_t frequency, std::uint32_t octaves, double persistence) const
+{
+    double t[maxNoiseBlockSize];
+
+    for (std::size_t offset = 0; offset < count; offset += maxNoiseBlockSize)
+    {
+        /* Copy time points first, since the output may alias the input */
+        auto n = std::min(count - offset, maxNoiseBlockSize);
+        std::copy(timePoints + offset, timePoints + offset + n, t);
+        AccumulateOctaves(t, noise + offset, n, frequency, octaves, persistence);
+    }
+}
+
+void PerlinNoise::Noise(
+    double timeBegin, double timeStep, double* noise, std::size_t count, std::uint32_t frequency, std::uint32_t octaves, double persistence) const
+{
+    double t[maxNoiseBlockSize];
+
+    for (std::size_t offset = 0; offset < count; offset += maxNoiseBlockSize)
+    {
+        auto n = std::min(count - offset, maxNoiseBlockSize);
+        for (std::size_t i = 0; i < n; ++i)
+            t[i] = timeBegin + static_cast<double>(offset + i) * timeStep;
+        AccumulateOctaves(t, noise + offset, n, frequency, octaves, persistence);
+    }
+}
+
 
 /*
  * ======= Private: =======
  */
 
-void PerlinNoise::GeneratePermutations(std::uint32_t seed)
+void PerlinNoise::GenerateGradients(std::uint32_t seed)
 {
-    static const int n = 256;
+    static const std::size_t n = 256;
+
+    /* Generate random permutation */
+    std::array<std::uint32_t, n> perm;
+
+    for (std::size_t i = 0; i < n; ++i)
+        perm[i] = static_cast<std::uint32_t>(i);
 
-    for (int i = 0; i < n; ++i)
-        perm_[i] = i;
+    std::shuffle(std::begin(perm), std::end(perm), std::default_random_engine(seed));
 
-    std::shuffle(std::begin(perm_), std::begin(perm_) + n, std::default_random_engine(seed));
+    /* Store the permuted gradients directly, so that each lattice point only requires a single table look-up */
+    double angleStep = M_PI * 2.0 / static_cast<double>(n);
 
-    for (int i = 0; i < n; ++i)
-        perm_[n + i] = perm_[i];
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        auto a = static_cast<double>(perm[i]) * angleStep;
+        grads_[i] = std::cos(a);
+    }
 }
 
-void PerlinNoise::GenerateGradients()
+void PerlinNoise::AccumulateOctaves(
+    const double* timePoints, double* noise, std::size_t count, std::uint32_t frequency, std::uint32_t octaves, double persistence) const
 {
-    double angleStep = M_PI * 2.0 / static_cast<double>(grads_.size());
+    double          phase[maxNoiseBlockSize], dist[maxNoiseBlockSize], grad0[maxNoiseBlockSize], grad1[maxNoiseBlockSize];
+    std::int32_t    lattice[maxNoiseBlockSize];
+
+    frequency = std::max(1u, frequency);
+
+    /*
+    Reduce the time points modulo the frequency once, since the pattern repeats after 'frequency' lattice points.
+    The time points of each octave are then in the range [0, period), so the lattice points can be determined by truncation.
+    */
+    const auto period0 = static_cast<double>(frequency);
 
-    for (std::size_t i = 0; i < grads_.size(); ++i)
+    for (std::size_t i = 0; i < count; ++i)
     {
-        auto a = static_cast<double>(i) * angleStep;
-        grads_[i] = std::cos(a);
+        auto t = timePoints[i] - period0 * std::floor(timePoints[i] / period0);
+        phase[i] = (t < period0 ? t : 0.0);
+    }
+
+    std::fill(noise, noise + count, 0.0);
+
+    double scale        = 1.0;
+    double amplitude    = 1.0;
+    double period       = period0;
+
+    /* Octaves whose period exceeds the 32-bit lattice points are negligible */
+    for (std::uint32_t octave = 0; octave < octaves && period < 2147483648.0; ++octave)
+    {
+        /* Determine the lattice points and the distances to the left lattice points */
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            auto x = phase[i] * scale;
+            lattice[i]  = static_cast<std::int32_t>(x);
+            dist[i]     = x - static_cast<double>(lattice[i]);
+        }
+
+        /* Look up the gradients of the left and right lattice points (the right one wraps around at the end of the period) */
+        const auto lastLattice = static_cast<std::int32_t>(period) - 1;
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            auto left   = lattice[i];
+            auto right  = (left < lastLattice ? left + 1 : 0);
+            grad0[i] = grads_[left & 0xFF];
+            grad1[i] = grads_[right & 0xFF];
+        }
+
+        /* Blend the surflets of both lattice points, where the fade curve is symmetric: 1 - Fade(1 - d) = Fade(d) */
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            auto d = dist[i];
+            auto f = Fade(d);
+            noise[i] += ((1.0 - f) * d * grad0[i] + f * (d - 1.0) * grad1[i]) * amplitude;
+        }
+
+        scale       *= 2.0;
+        amplitude   *= persistence;
+        period      *= 2.0;
     }
 }
 
@@ -0,0 +1,307 @@
+/*
+ * Resampler.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include <Ac/Resampler.h>
+#include "VectorKernels.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#ifndef _USE_MATH_DEFINES
+#define _USE_MATH_DEFINES
+#endif
+
+#include <math.h>
+
+
+namespace Ac
+{
+
+
+// Maximal number of phases which are precomputed exactly. Larger conversion ratios interpolate between the phases.
+static const std::uint64_t maxExactPhases       = 1024;
+
+// Number of taps on each side of the windowed-sinc filter (for upsampling; downsampling widens the filter by the ratio)
+static const std::size_t sincHalfTaps           = 32;
+
+// Upper limit for the number of taps on each side of the windowed-sinc filter (for extreme downsampling ratios)
+static const std::size_t maxSincHalfTaps        = 512;
+
+// Cutoff frequency of the windowed-sinc filter relative to the Nyquist frequency of the lower sample rate
+static const double sincCutoff                  = 0.97;
+
+
+static std::uint64_t GreatestCommonDivisor(std::uint64_t a, std::uint64_t b)
+{
+    while (b != 0)
+    {
+        auto t = b;
+        b = a % b;
+        a = t;
+    }
+    return a;
+}
+
+Resampler::Resampler(std::uint32_t inputRate, std::uint32_t outputRate, std::uint16_t channels, const ResamplerQuality quality) :
+    inputRate_  { inputRate  },
+    outputRate_ { outputRate },
+    channels_   { channels   },
+    quality_    { quality    }
+{
+    if (inputRate == 0 || outputRate == 0)
+        throw std::invalid_argument("sample rates of resampler must not be zero");
+    if (channels == 0)
+        throw std::invalid_argument("number of channels of resampler must not be zero");
+
+    /* Reduce conversion ratio to L/M */
+    auto gcd    = GreatestCommonDivisor(inputRate, outputRate);
+    upFactor_   = outputRate / gcd;
+    downFactor_ = inputRate / gcd;
+
+    BuildFilterTable();
+    Reset();
+}
+
+std::size_t Resampler::Process(const float* input, std::size_t inputFrames, std::vector<float>& output)
+{
+    if (!input || inputFrames == 0)
+        return 0;
+
+    AppendInput(input, inputFrames);
+    totalInputFrames_ += inputFrames;
+
+    auto frames = GenerateOutput(output, GetOutputFrames(static_cast<std::size_t>(totalInputFrames_)));
+    DiscardInput();
+
+    return frames;
+}
+
+std::size_t Resampler::Flush(std::vector<float>& output)
+{
+    /* Append silence to produce the output frames for the remaining input frames */
+    AppendSilence(taps_);
+
+    auto frames = GenerateOutput(output, GetOutputFrames(static_cast<std::size_t>(totalInputFrames_)));
+    Reset();
+
+    return frames;
+}
+
+void Resampler::Reset()
+{
+    /* Initialize history with silence, so that the first output frame is centered on the first input frame */
+    history_.resize(channels_);
+    for (auto& samples : history_)
+        samples.assign(halfTaps_ - 1, 0.0f);
+
+    inputIndex_         = 0;
+    phase_              = 0;
+    totalInputFrames_   = 0;
+    totalOutputFrames_  = 0;
+}
+
+std::size_t Resampler::GetOutputFrames(std::size_t inputFrames) const
+{
+    return static_cast<std::size_t>((static_cast<std::uint64_t>(inputFrames) * upFactor_ + downFactor_ - 1) / downFactor_);
+}
+
+
+/*
+ * ======= Private: =======
+ */
+
+static double LinearKernel(double x)
+{
+    x = std::abs(x);
+    return (x < 1.0 ? 1.0 - x : 0.0);
+}
+
+// Catmull-Rom spline kernel
+static double CubicKernel(double x)
+{
+    x = std::abs(x);
+    if (x < 1.0)
+        return (1.5*x - 2.5)*x*x + 1.0;
+    if (x < 2.0)
+        return ((-0.5*x + 2.5)*x - 4.0)*x + 2.0;
+    return 0.0;
+}
+
+// Low-pass filter kernel with a Blackman window of the specified half width and cutoff frequency (in cycles per input sample)
+static double SincKernel(double x, double halfWidth, double cutoff)
+{
+    if (std::abs(x) >= halfWidth)
+        return 0.0;
+
+    auto u = M_PI * x / halfWidth;
+    auto w = 0.42 + 0.5*std::cos(u) + 0.08*std::cos(2.0*u);
+
+    auto t = 2.0 * M_PI * cutoff * x;
+    auto s = (std::abs(t) < 1.0e-9 ? 1.0 : std::sin(t) / t);
+
+    return 2.0 * cutoff * s * w;
+}
+
+void Resampler::BuildFilterTable()
+{
+    auto ratio = static_cast<double>(outputRate_) / static_cast<double>(inputRate_);
+
+    /* Determine filter length */
+    switch (quality_)
+    {
+        case ResamplerQuality::Linear:
+            halfTaps_ = 1;
+            break;
+        case ResamplerQuality::Cubic:
+            halfTaps_ = 2;
+            break;
+        case ResamplerQuality::Sinc:
+            halfTaps_ = sincHalfTaps;
+            if (ratio < 1.0)
+                halfTaps_ = std::min(maxSincHalfTaps, static_cast<std::size_t>(std::ceil(sincHalfTaps / ratio)));
+            break;
+    }
+
+    /* Pad number of taps to a multiple of 4 for the SIMD kernels (padded coefficients are zero) */
+    auto filterTaps = halfTaps_ * 2;
+    taps_ = (filterTaps + 3) & ~std::size_t(3);
+
+    /* Determine number of phases */
+    interpolatePhases_  = (upFactor_ > maxExactPhases);
+    phases_             = static_cast<std::size_t>(interpolatePhases_ ? maxExactPhases : upFactor_);
+
+    /* Generate filter coefficients for each phase (plus one more phase for interpolation) */
+    auto cutoff     = 0.5 * std::min(1.0, ratio) * sincCutoff;
+    auto halfWidth  = static_cast<double>(halfTaps_);
+
+    filterTable_.assign((phases_ + 1) * taps_, 0.0f);
+
+    std::vector<double> coeffs(filterTaps);
+
+    for (std::size_t phase = 0; phase <= phases_; ++phase)
+    {
+        auto frac = static_cast<double>(phase) / static_cast<double>(phases_);
+
+        /* Tap 'k' refers to the input frame (index - halfTaps + 1 + k) for an output frame at (index + frac) */
+        double sum = 0.0;
+
+        for (std::size_t k = 0; k < filterTaps; ++k)
+        {
+            auto x = static_cast<double>(k) - (halfWidth - 1.0) - frac;
+
+            switch (quality_)
+            {
+                case ResamplerQuality::Linear:
+                    coeffs[k] = LinearKernel(x);
+                    break;
+                case ResamplerQuality::Cubic:
+                    coeffs[k] = CubicKernel(x);
+                    break;
+                case ResamplerQuality::Sinc:
+                    coeffs[k] = SincKernel(x, halfWidth, cutoff);
+                    break;
+            }
+
+            sum += coeffs[k];
+        }
+
+        /* Normalize coefficients for unity gain at DC */
+        auto table = filterTable_.data() + phase * taps_;
+        for (std::size_t k = 0; k < filterTaps; ++k)
+            table[k] = static_cast<float>(sum != 0.0 ? coeffs[k] / sum : coeffs[k]);
+    }
+}
+
+void Resampler::AppendInput(const float* input, std::size_t inputFrames)
+{
+    for (std::uint16_t chn = 0; chn < channels_; ++chn)
+    {
+        auto& samples = history_[chn];
+        auto offset = samples.size();
+
+        samples.resize(offset + inputFrames);
+        for (std::size_t i = 0; i < inputFrames; ++i)
+            samples[offset + i] = input[i*channels_ + chn];
+    }
+}
+
+void Resampler::AppendSilence(std::size_t frames)
+{
+    for (auto& samples : history_)
+        samples.resize(samples.size() + frames, 0.0f);
+}
+
+std::size_t Resampler::GenerateOutput(std::vector<float>& output, std::uint64_t maxOutputFrames)
+{
+    auto dotProduct     = GetDotProductKernel();
+    auto historyFrames  = history_[0].size();
+    auto frames         = std::size_t(0);
+
+    /* Reserve memory for the approximate number of output frames */
+    if (historyFrames > inputIndex_)
+        output.reserve(output.size() + (((historyFrames - inputIndex_) * upFactor_) / downFactor_ + 1) * channels_);
+
+    while (totalOutputFrames_ < maxOutputFrames && inputIndex_ + taps_ <= historyFrames)
+    {
+        if (interpolatePhases_)
+        {
+            /* Interpolate between the two nearest precomputed phases */
+            auto pos    = static_cast<double>(phase_) * static_cast<double>(phases_) / static_cast<double>(upFactor_);
+            auto index  = std::min(static_cast<std::size_t>(pos), phases_ - 1);
+            auto t      = static_cast<float>(pos - static_cast<double>(index));
+
+            auto coeffs0 = filterTable_.data() + index * taps_;
+            auto coeffs1 = coeffs0 + taps_;
+
+            for (std::uint16_t chn = 0; chn < channels_; ++chn)
+            {
+                auto samples = history_[chn].data() + inputIndex_;
+                auto a = dotProduct(samples, coeffs0, taps_);
+                auto b = dotProduct(samples, coeffs1, taps_);
+                output.push_back(a + (b - a) * t);
+            }
+        }
+        else
+        {
+            auto coeffs = filterTable_.data() + static_cast<std::size_t>(phase_) * taps_;
+
+            for (std::uint16_t chn = 0; chn < channels_; ++chn)
+                output.push_back(dotProduct(history_[chn].data() + inputIndex_, coeffs, taps_));
+        }
+
+        /* Advance input position by M/L input frames */
+        phase_ += downFactor_;
+        inputIndex_ += static_cast<std::size_t>(phase_ / upFactor_);
+        phase_ %= upFactor_;
+
+        ++totalOutputFrames_;
+        ++frames;
+    }
+
+    return frames;
+}
+
+void Resampler::DiscardInput()
+{
+    /* Remove all input frames which are no longer required for the next output frame */
+    auto historyFrames = history_[0].size();
+    auto n = std::min(inputIndex_, historyFrames);
+
+    if (n > 0)
+    {
+        for (auto& samples : history_)
+            samples.erase(samples.begin(), samples.begin() + n);
+        inputIndex_ -= n;
+    }
+}
+
+
+} // /namespace Ac
+
+
+
+// ================================================================================
@@ -0,0 +1,131 @@
+/*
+ * STFT.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include <Ac/STFT.h>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+
+namespace Ac
+{
+
+
+// Number of sample frames which are read or written at once to extract a single channel.
+static const std::size_t channelBlockSize = 4096;
+
+// Minimal sum of squared window weights to normalize the overlap-add (smaller sums are treated as silence).
+static const float minWindowSum = 1.0e-6f;
+
+static void ValidateChannel(const WaveBufferConstView& view, std::uint16_t channel)
+{
+    if (channel >= view.GetFormat().channels)
+        throw std::out_of_range("channel index out of range for STFT (" + std::to_string(channel) + " of " + std::to_string(view.GetFormat().channels) + ")");
+}
+
+STFT::STFT(std::size_t frameSize, std::size_t hopSize, const WindowFunction windowFunction) :
+    frameSize_ { frameSize },
+    hopSize_   { hopSize   }
+{
+    if (frameSize == 0 || hopSize == 0)
+        throw std::invalid_argument("frame size and hop size of STFT must not be zero");
+    if (hopSize > frameSize)
+        throw std::invalid_argument("hop size of STFT must not be greater than the frame size");
+
+    window_ = GenerateWindow(windowFunction, frameSize);
+    plan_   = RealFFTPlan::Get(frameSize);
+}
+
+void STFT::Analyze(const WaveBufferConstView& view, std::uint16_t channel, std::vector<std::complex<float>>& spectra) const
+{
+    ValidateChannel(view, channel);
+
+    const auto frames       = view.GetSampleFrames();
+    const auto channels     = static_cast<std::size_t>(view.GetFormat().channels);
+    const auto numFrames    = GetNumFrames(frames);
+    const auto numBins      = GetNumBins();
+    const auto padding      = frameSize_ / 2;
+
+    /* Extract the channel with silence before and after the samples, so that each frame is fully covered */
+    std::vector<float> signal(padding + frames + frameSize_, 0.0f);
+    std::vector<float> block(channelBlockSize * channels);
+
+    for (std::size_t offset = 0; offset < frames; offset += channelBlockSize)
+    {
+        auto n = view.ReadFrames(offset, std::min(channelBlockSize, frames - offset), block.data());
+        for (std::size_t i = 0; i < n; ++i)
+            signal[padding + offset + i] = block[i * channels + channel];
+    }
+
+    /* Transform the weighted frames */
+    spectra.resize(numFrames * numBins);
+
+    std::vector<float> frame(frameSize_);
+
+    for (std::size_t i = 0; i < numFrames; ++i)
+    {
+        const auto samples = signal.data() + i * hopSize_;
+        for (std::size_t j = 0; j < frameSize_; ++j)
+            frame[j] = samples[j] * window_[j];
+
+        plan_->Forward(frame.data(), spectra.data() + i * numBins);
+    }
+}
+
+void STFT::Synthesize(const std::vector<std::complex<float>>& spectra, const WaveBufferView& view, std::uint16_t channel) const
+{
+    ValidateChannel(view, channel);
+
+    const auto frames       = view.GetSampleFrames();
+    const auto channels     = static_cast<std::size_t>(view.GetFormat().channels);
+    const auto numBins      = GetNumBins();
+    const auto numFrames    = std::min(spectra.size() / numBins, GetNumFrames(frames));
+    const auto padding      = frameSize_ / 2;
+    const auto scale        = 1.0f / static_cast<float>(frameSize_);
+
+    /* Accumulate the inverse transforms, weighted by the window, and the sum of the squared window weights */
+    std::vector<float> signal(padding + frames + frameSize_, 0.0f);
+    std::vector<float> windowSum(signal.size(), 0.0f);
+    std::vector<float> frame(frameSize_);
+
+    for (std::size_t i = 0; i < numFrames; ++i)
+    {
+        plan_->Inverse(spectra.data() + i * numBins, frame.data());
+
+        auto samples = signal.data() + i * hopSize_;
+        auto weights = windowSum.data() + i * hopSize_;
+
+        for (std::size_t j = 0; j < frameSize_; ++j)
+        {
+            samples[j] += frame[j] * window_[j] * scale;
+            weights[j] += window_[j] * window_[j];
+        }
+    }
+
+    /* Normalize the samples and write them into the channel */
+    std::vector<float> block(channelBlockSize * channels);
+
+    for (std::size_t offset = 0; offset < frames; offset += channelBlockSize)
+    {
+        auto n = view.ReadFrames(offset, std::min(channelBlockSize, frames - offset), block.data());
+
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            auto idx = padding + offset + i;
+            block[i * channels + channel] = (windowSum[idx] > minWindowSum ? signal[idx] / windowSum[idx] : 0.0f);
+        }
+
+        view.WriteFrames(offset, n, block.data());
+    }
+}
+
+
+} // /namespace Ac
+
+
+
+// ================================================================================
@@ -0,0 +1,198 @@
+/*
+ * SampleAccess.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "SampleAccess.h"
+#include "PCMData.h"
+#include "PCMConversion.h"
+
+#include <algorithm>
+
+
+namespace Ac
+{
+
+
+/* ----- Single samples ----- */
+
+double ReadSampleData(const WaveBufferFormat& format, const WaveBufferStorage storage, const char* data)
+{
+    double sample = 0.0;
+
+    PCMSampleConst pcmSample;
+    pcmSample.raw = data;
+
+    if (pcmSample.raw)
+    {
+        if (storage == WaveBufferStorage::PlanarFloat)
+            return static_cast<double>(*reinterpret_cast<const float*>(pcmSample.raw));
+
+        switch (GetPCMType(format))
+        {
+            case PCMType::Float32:
+                PCMDataToSample(sample, *pcmSample.float32);
+                break;
+            case PCMType::Int32:
+                PCMDataToSample(sample, *pcmSample.bits32);
+                break;
+            case PCMType::Int24:
+                PCMInt24ToSample(sample, pcmSample.bits24);
+                break;
+            case PCMType::Int16:
+                PCMDataToSample(sample, *pcmSample.bits16);
+                break;
+            case PCMType::UInt8:
+                PCMDataToSample(sample, *pcmSample.bits8);
+                break;
+            default:
+                break;
+        }
+    }
+
+    return sample;
+}
+
+void WriteSampleData(const WaveBufferFormat& format, const WaveBufferStorage storage, char* data, double sample)
+{
+    PCMSample pcmSample;
+    pcmSample.raw = data;
+
+    if (pcmSample.raw)
+    {
+        if (storage == WaveBufferStorage::PlanarFloat)
+        {
+            *reinterpret_cast<float*>(pcmSample.raw) = static_cast<float>(std::max(-1.0, std::min(sample, 1.0)));
+            return;
+        }
+
+        switch (GetPCMType(format))
+        {
+            case PCMType::Float32:
+                SampleToPCMData(*pcmSample.float32, sample);
+                break;
+            case PCMType::Int32:
+                SampleToPCMData(*pcmSample.bits32, sample);
+                break;
+            case PCMType::Int24:
+                SampleToPCMInt24(pcmSample.bits24, sample);
+                break;
+            case PCMType::Int16:
+                SampleToPCMData(*pcmSample.bits16, sample);
+                break;
+            case PCMType::UInt8:
+                SampleToPCMData(*pcmSample.bits8, sample);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+
+/* ----- Sample frames ----- */
+
+//! Interleaves the samples of all channel arrays, which are 'planeStride' samples apart from each other.
+template <typename TSrc, typename TDst>
+static void GatherPlanarFrames(const TSrc* planes, std::size_t planeStride, std::size_t frames, std::uint16_t channels, TDst* samples)
+{
+    for (std::uint16_t chn = 0; chn < channels; ++chn)
+    {
+        auto plane = planes + chn*planeStride;
+        for (std::size_t i = 0; i < frames; ++i)
+            samples[i*channels + chn] = static_cast<TDst>(plane[i]);
+    }
+}
+
+//! Deinterleaves the samples into all channel arrays, which are 'planeStride' samples apart from each other. Each sample is clamped to [-1, 1].
+template <typename TSrc, typename TDst>
+static void ScatterPlanarFrames(const TSrc* samples, std::size_t frames, std::uint16_t channels, TDst* planes, std::size_t planeStride)
+{
+    for (std::uint16_t chn = 0; chn < channels; ++chn)
+    {
+        auto plane = planes + chn*planeStride;
+        for (std::size_t i = 0; i < frames; ++i)
+            plane[i] = static_cast<TDst>(std::max(TSrc(-1), std::min(samples[i*channels + chn], TSrc(1))));
+    }
+}
+
+static void GatherPlanarFrames(const float* planes, std::size_t planeStride, std::size_t frames, std::uint16_t channels, float* samples)
+{
+    InterleaveSamples(planes, planeStride, frames, channels, samples);
+}
+
+static void ScatterPlanarFrames(const float* samples, std::size_t frames, std::uint16_t channels, float* planes, std::size_t planeStride)
+{
+    DeinterleaveSamples(samples, frames, channels, planes, planeStride);
+}
+
+static void ReadPCMFrames(const PCMType type, const char* data, std::size_t n, float* samples)
+{
+    ConvertPCMToFloat(type, data, samples, n);
+}
+
+static void ReadPCMFrames(const PCMType type, const char* data, std::size_t n, double* samples)
+{
+    ConvertPCMToDouble(type, data, samples, n);
+}
+
+static void WritePCMFrames(const PCMType type, char* data, std::size_t n, const float* samples)
+{
+    ConvertFloatToPCM(type, samples, data, n);
+}
+
+static void WritePCMFrames(const PCMType type, char* data, std::size_t n, const double* samples)
+{
+    ConvertDoubleToPCM(type, samples, data, n);
+}
+
+template <typename TSample>
+static void ReadSampleFramesPrimary(
+    const WaveBufferFormat& format, const WaveBufferStorage storage, const char* data, std::size_t planeStride, std::size_t frames, TSample* samples)
+{
+    /* Read planar samples directly */
+    if (storage == WaveBufferStorage::PlanarFloat)
+        GatherPlanarFrames(reinterpret_cast<const float*>(data), planeStride, frames, format.channels, samples);
+    else
+        ReadPCMFrames(GetPCMType(format), data, frames * format.channels, samples);
+}
+
+template <typename TSample>
+static void WriteSampleFramesPrimary(
+    const WaveBufferFormat& format, const WaveBufferStorage storage, char* data, std::size_t planeStride, std::size_t frames, const TSample* samples)
+{
+    /* Write planar samples directly */
+    if (storage == WaveBufferStorage::PlanarFloat)
+        ScatterPlanarFrames(samples, frames, format.channels, reinterpret_cast<float*>(data), planeStride);
+    else
+        WritePCMFrames(GetPCMType(format), data, frames * format.channels, samples);
+}
+
+void ReadSampleFrames(const WaveBufferFormat& format, const WaveBufferStorage storage, const char* data, std::size_t planeStride, std::size_t frames, float* samples)
+{
+    ReadSampleFramesPrimary(format, storage, data, planeStride, frames, samples);
+}
+
+void ReadSampleFrames(const WaveBufferFormat& format, const WaveBufferStorage storage, const char* data, std::size_t planeStride, std::size_t frames, double* samples)
+{
+    ReadSampleFramesPrimary(format, storage, data, planeStride, frames, samples);
+}
+
+void WriteSampleFrames(const WaveBufferFormat& format, const WaveBufferStorage storage, char* data, std::size_t planeStride, std::size_t frames, const float* samples)
+{
+    WriteSampleFramesPrimary(format, storage, data, planeStride, frames, samples);
+}
+
+void WriteSampleFrames(const WaveBufferFormat& format, const WaveBufferStorage storage, char* data, std::size_t planeStride, std::size_t frames, const double* samples)
+{
+    WriteSampleFramesPrimary(format, storage, data, planeStride, frames, samples);
+}
+
+
+} // /namespace Ac
+
+
+
+// ================================================================================
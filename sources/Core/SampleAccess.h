@@ -0,0 +1,53 @@
+/*
+ * SampleAccess.h
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef AC_SAMPLE_ACCESS_H
+#define AC_SAMPLE_ACCESS_H
+
+
+#include <Ac/WaveBuffer.h>
+#include <cstddef>
+#include <cstdint>
+
+
+namespace Ac
+{
+
+
+/*
+Sample access functions which are shared between WaveBuffer and the wave buffer views.
+The 'data' pointer refers to the first sample frame: for the interleaved storage this is the first byte of PCM data,
+and for the planar storage this is the first sample of channel 0, where the channel arrays are 'planeStride' samples apart from each other.
+*/
+
+//! Returns the sample at the specified data pointer in the range [-1, 1].
+double ReadSampleData(const WaveBufferFormat& format, const WaveBufferStorage storage, const char* data);
+
+//! Writes the sample to the specified data pointer. The sample is clamped to [-1, 1].
+void WriteSampleData(const WaveBufferFormat& format, const WaveBufferStorage storage, char* data, double sample);
+
+//! Reads the specified number of sample frames into the interleaved samples.
+void ReadSampleFrames(const WaveBufferFormat& format, const WaveBufferStorage storage, const char* data, std::size_t planeStride, std::size_t frames, float* samples);
+
+//! \see ReadSampleFrames(const WaveBufferFormat&, const WaveBufferStorage, const char*, std::size_t, std::size_t, float*)
+void ReadSampleFrames(const WaveBufferFormat& format, const WaveBufferStorage storage, const char* data, std::size_t planeStride, std::size_t frames, double* samples);
+
+//! Writes the specified number of interleaved sample frames. Each sample is clamped to [-1, 1].
+void WriteSampleFrames(const WaveBufferFormat& format, const WaveBufferStorage storage, char* data, std::size_t planeStride, std::size_t frames, const float* samples);
+
+//! \see WriteSampleFrames(const WaveBufferFormat&, const WaveBufferStorage, char*, std::size_t, std::size_t, const float*)
+void WriteSampleFrames(const WaveBufferFormat& format, const WaveBufferStorage storage, char* data, std::size_t planeStride, std::size_t frames, const double* samples);
+
+
+} // /namespace Ac
+
+
+#endif
+
+
+
+// ================================================================================
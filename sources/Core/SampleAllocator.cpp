@@ -0,0 +1,332 @@
+/*
+ * SampleAllocator.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include <Ac/SampleAllocator.h>
+#include "../Platform/VirtualMemory.h"
+
+#include <algorithm>
+#include <new>
+
+
+namespace Ac
+{
+
+
+/* ----- SampleAllocator class ----- */
+
+const std::size_t SampleAllocator::alignment;
+
+SampleAllocator::~SampleAllocator()
+{
+}
+
+
+/* ----- Default allocator ----- */
+
+class HeapSampleAllocator : public SampleAllocator
+{
+
+    public:
+
+        void* Allocate(std::size_t size) override
+        {
+            return ::operator new(size);
+        }
+
+        void Deallocate(void* ptr, std::size_t /*size*/) override
+        {
+            ::operator delete(ptr);
+        }
+
+};
+
+static std::atomic<SampleAllocator*> g_defaultAllocator { nullptr };
+
+AC_EXPORT SampleAllocator& GetHeapSampleAllocator()
+{
+    static HeapSampleAllocator allocator;
+    return allocator;
+}
+
+AC_EXPORT SampleAllocator& GetDefaultSampleAllocator()
+{
+    auto allocator = g_defaultAllocator.load();
+    return (allocator != nullptr ? *allocator : GetHeapSampleAllocator());
+}
+
+AC_EXPORT void SetDefaultSampleAllocator(SampleAllocator* allocator)
+{
+    g_defaultAllocator.store(allocator);
+}
+
+
+/* ----- PoolSampleAllocator class ----- */
+
+static const std::size_t g_minPoolBlockSize     = 64;
+static const std::size_t g_sizeClassesPerOctave = 4;
+
+PoolSampleAllocator::PoolSampleAllocator(std::size_t maxBlockSize, std::size_t maxCachedSize, SampleAllocator& upstream) :
+    upstream_       { upstream      },
+    maxCachedSize_  { maxCachedSize },
+    cachedSize_     { 0             }
+{
+    /* Generate size classes with four steps per power of two, e.g. 64, 80, 96, 112, 128, 160, ... */
+    for (auto octave = g_minPoolBlockSize; octave <= maxBlockSize; octave *= 2)
+    {
+        for (std::size_t i = 0; i < g_sizeClassesPerOctave; ++i)
+        {
+            auto size = octave + octave / g_sizeClassesPerOctave * i;
+            if (size > maxBlockSize)
+                break;
+
+            std::unique_ptr<SizeClass> sizeClass { new SizeClass() };
+            sizeClass->size = size;
+            sizeClasses_.push_back(std::move(sizeClass));
+        }
+    }
+}
+
+PoolSampleAllocator::~PoolSampleAllocator()
+{
+    Release();
+}
+
+void* PoolSampleAllocator::Allocate(std::size_t size)
+{
+    auto sizeClass = FindSizeClass(size);
+    if (!sizeClass)
+        return upstream_.Allocate(size);
+
+    {
+        /* Take first block from the free list */
+        std::lock_guard<std::mutex> guard { sizeClass->mutex };
+        if (auto block = sizeClass->blocks)
+        {
+            sizeClass->blocks = block->next;
+            cachedSize_ -= sizeClass->size;
+            return block;
+        }
+    }
+
+    return upstream_.Allocate(sizeClass->size);
+}
+
+void PoolSampleAllocator::Deallocate(void* ptr, std::size_t size)
+{
+    if (!ptr)
+        return;
+
+    auto sizeClass = FindSizeClass(size);
+    if (!sizeClass)
+        upstream_.Deallocate(ptr, size);
+    else if (!PushBlock(*sizeClass, ptr))
+        upstream_.Deallocate(ptr, sizeClass->size);
+}
+
+void PoolSampleAllocator::Reserve(std::size_t size, std::size_t count)
+{
+    if (auto sizeClass = FindSizeClass(size))
+    {
+        for (; count > 0; --count)
+        {
+            auto ptr = upstream_.Allocate(sizeClass->size);
+            if (!PushBlock(*sizeClass, ptr))
+            {
+                upstream_.Deallocate(ptr, sizeClass->size);
+                break;
+            }
+        }
+    }
+}
+
+void PoolSampleAllocator::Release()
+{
+    for (auto& sizeClass : sizeClasses_)
+    {
+        /* Detach free list and return all blocks to the upstream allocator outside the lock */
+        FreeBlock* blocks = nullptr;
+        {
+            std::lock_guard<std::mutex> guard { sizeClass->mutex };
+            std::swap(blocks, sizeClass->blocks);
+        }
+
+        while (blocks)
+        {
+            auto next = blocks->next;
+            upstream_.Deallocate(blocks, sizeClass->size);
+            cachedSize_ -= sizeClass->size;
+            blocks = next;
+        }
+    }
+}
+
+
+/*
+ * ======= Private: =======
+ */
+
+PoolSampleAllocator::SizeClass* PoolSampleAllocator::FindSizeClass(std::size_t size)
+{
+    /* Find smallest size class which fits the allocation size */
+    auto it = std::lower_bound(
+        sizeClasses_.begin(), sizeClasses_.end(), size,
+        [](const std::unique_ptr<SizeClass>& sizeClass, std::size_t size)
+        {
+            return (sizeClass->size < size);
+        }
+    );
+    return (it != sizeClasses_.end() ? it->get() : nullptr);
+}
+
+bool PoolSampleAllocator::PushBlock(SizeClass& sizeClass, void* ptr)
+{
+    if (cachedSize_.fetch_add(sizeClass.size) + sizeClass.size > maxCachedSize_)
+    {
+        cachedSize_ -= sizeClass.size;
+        return false;
+    }
+
+    /* Insert block at the front of the free list */
+    auto block = reinterpret_cast<FreeBlock*>(ptr);
+    std::lock_guard<std::mutex> guard { sizeClass.mutex };
+    block->next = sizeClass.blocks;
+    sizeClass.blocks = block;
+
+    return true;
+}
+
+
+/* ----- ArenaSampleAllocator class ----- */
+
+static std::size_t AlignSize(std::size_t size)
+{
+    return ((size + SampleAllocator::alignment - 1) / SampleAllocator::alignment * SampleAllocator::alignment);
+}
+
+ArenaSampleAllocator::ArenaSampleAllocator(std::size_t chunkSize, SampleAllocator& upstream) :
+    upstream_   { upstream                                      },
+    chunkSize_  { AlignSize(std::max(chunkSize, std::size_t(1u))) }
+{
+}
+
+ArenaSampleAllocator::~ArenaSampleAllocator()
+{
+    Release();
+}
+
+void* ArenaSampleAllocator::Allocate(std::size_t size)
+{
+    size = AlignSize(std::max(size, std::size_t(1u)));
+
+    /* Allocate from current chunk */
+    if (chunkIndex_ < chunks_.size() && offset_ + size <= chunks_[chunkIndex_].size)
+    {
+        auto ptr = chunks_[chunkIndex_].data + offset_;
+        offset_ += size;
+        return ptr;
+    }
+
+    /* Find a subsequent chunk which fits the allocation, or allocate a new one */
+    auto nextIndex = (chunkIndex_ < chunks_.size() ? chunkIndex_ + 1 : 0);
+
+    auto it = std::find_if(
+        chunks_.begin() + nextIndex, chunks_.end(),
+        [size](const Chunk& chunk)
+        {
+            return (chunk.size >= size);
+        }
+    );
+
+    if (it != chunks_.end())
+        std::swap(*it, chunks_[nextIndex]);
+    else
+    {
+        auto chunkSize = std::max(chunkSize_, size);
+        Chunk chunk { reinterpret_cast<char*>(upstream_.Allocate(chunkSize)), chunkSize };
+        chunks_.insert(chunks_.begin() + nextIndex, chunk);
+    }
+
+    chunkIndex_ = nextIndex;
+    offset_     = size;
+
+    return chunks_[chunkIndex_].data;
+}
+
+void ArenaSampleAllocator::Deallocate(void* ptr, std::size_t size)
+{
+    /* Give back the most recent allocation only */
+    if (ptr && chunkIndex_ < chunks_.size())
+    {
+        size = AlignSize(std::max(size, std::size_t(1u)));
+        auto top = chunks_[chunkIndex_].data + offset_;
+        if (reinterpret_cast<char*>(ptr) + size == top)
+            offset_ -= size;
+    }
+}
+
+void ArenaSampleAllocator::Reset()
+{
+    chunkIndex_ = 0;
+    offset_     = 0;
+}
+
+void ArenaSampleAllocator::Release()
+{
+    for (const auto& chunk : chunks_)
+        upstream_.Deallocate(chunk.data, chunk.size);
+    chunks_.clear();
+    Reset();
+}
+
+std::size_t ArenaSampleAllocator::GetCapacity() const
+{
+    std::size_t size = 0;
+    for (const auto& chunk : chunks_)
+        size += chunk.size;
+    return size;
+}
+
+
+/* ----- HugePageSampleAllocator class ----- */
+
+HugePageSampleAllocator::HugePageSampleAllocator(std::size_t minSize, SampleAllocator& upstream) :
+    upstream_   { upstream                                  },
+    minSize_    { (minSize > 0 ? minSize : GetHugePageSize()) }
+{
+}
+
+void* HugePageSampleAllocator::Allocate(std::size_t size)
+{
+    if (size < minSize_)
+        return upstream_.Allocate(size);
+
+    auto ptr = AllocLargePageMemory(size);
+    if (!ptr)
+        throw std::bad_alloc();
+
+    return ptr;
+}
+
+void HugePageSampleAllocator::Deallocate(void* ptr, std::size_t size)
+{
+    if (size < minSize_)
+        upstream_.Deallocate(ptr, size);
+    else
+        FreeLargePageMemory(ptr, size);
+}
+
+std::size_t HugePageSampleAllocator::GetHugePageSize()
+{
+    return GetLargePageSize();
+}
+
+
+} // /namespace Ac
+
+
+
+// ================================================================================
@@ -0,0 +1,315 @@
+/*
+ * SampleTransforms.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "SampleTransforms.h"
+#include "PCMConversion.h"
+#include "VectorKernels.h"
+
+#include <algorithm>
+#include <vector>
+
+
+namespace Ac
+{
+
+
+/* ----- Block processing ----- */
+
+static float* GetFloatPointer(char* data)
+{
+    return reinterpret_cast<float*>(data);
+}
+
+static const float* GetFloatPointer(const char* data)
+{
+    return reinterpret_cast<const float*>(data);
+}
+
+// Writes a block of floating-points back into the PCM data of a mutable view.
+static void StoreBlock(const PCMType type, const float* block, char* data, std::size_t n)
+{
+    ConvertFloatToPCM(type, block, data, n);
+}
+
+// Blocks of constant views are never written back.
+static void StoreBlock(const PCMType /*type*/, const float* /*block*/, const char* /*data*/, std::size_t /*n*/)
+{
+}
+
+// Clamps the floating-points of a mutable view to [-1, 1] after they have been modified in place.
+static void ClampBlock(float* samples, std::size_t n)
+{
+    ConvertFloatToPCM(PCMType::Float32, samples, samples, n);
+}
+
+static void ClampBlock(const float* /*samples*/, std::size_t /*n*/)
+{
+}
+
+// Calls the function with the first frame and the number of frames of each block, until the function returns false.
+template <typename RangeFunction>
+static void ForEachBlockRange(std::size_t frames, std::size_t framesPerBlock, bool reverse, RangeFunction rangeFunction)
+{
+    const auto numBlocks = (frames + framesPerBlock - 1) / framesPerBlock;
+
+    for (std::size_t i = 0; i < numBlocks; ++i)
+    {
+        auto indexBegin = (reverse ? numBlocks - i - 1 : i) * framesPerBlock;
+        if (!rangeFunction(indexBegin, std::min(framesPerBlock, frames - indexBegin)))
+            break;
+    }
+}
+
+/*
+Calls the block function for each block of samples as floating-points:
+bool blockFunction(float* samples, std::size_t frames, std::uint16_t channels, std::uint16_t channel, std::size_t indexBegin).
+Blocks of interleaved storage contain all channels (and 'channel' is zero), blocks of planar storage contain one channel.
+Floating-point samples are passed directly, all other samples are converted into a temporary block and written back for mutable views.
+If the block function returns false, the remaining blocks of the interleaved samples or the current channel array are skipped.
+*/
+template <typename View, typename BlockFunction>
+static void ProcessBlocks(const View& view, bool reverse, BlockFunction blockFunction)
+{
+    const auto& format = view.GetFormat();
+    const auto  frames = view.GetSampleFrames();
+
+    if (frames == 0 || format.channels == 0)
+        return;
+
+    /* Determine the block size and the order of the blocks */
+    const auto channels         = (view.GetStorage() == WaveBufferStorage::PlanarFloat ? std::uint16_t(1u) : format.channels);
+    const auto framesPerBlock   = std::max(std::size_t(1u), WaveBuffer::maxBlockSamples / channels);
+
+    if (view.GetStorage() == WaveBufferStorage::PlanarFloat)
+    {
+        /* Process each channel array directly */
+        for (std::uint16_t chn = 0; chn < format.channels; ++chn)
+        {
+            auto samples = view.ChannelData(chn);
+            ForEachBlockRange(
+                frames, framesPerBlock, reverse,
+                [&](std::size_t indexBegin, std::size_t blockFrames)
+                {
+                    auto result = blockFunction(samples + indexBegin, blockFrames, channels, chn, indexBegin);
+                    ClampBlock(samples + indexBegin, blockFrames);
+                    return result;
+                }
+            );
+        }
+    }
+    else
+    {
+        const auto type         = GetPCMType(format);
+        const auto frameSize    = format.BytesPerFrame();
+        const auto data         = view.Data();
+
+        if (type == PCMType::Float32)
+        {
+            /* Process floating-point samples directly */
+            ForEachBlockRange(
+                frames, framesPerBlock, reverse,
+                [&](std::size_t indexBegin, std::size_t blockFrames)
+                {
+                    auto samples = GetFloatPointer(data + indexBegin * frameSize);
+                    auto result = blockFunction(samples, blockFrames, channels, std::uint16_t(0u), indexBegin);
+                    ClampBlock(samples, blockFrames * channels);
+                    return result;
+                }
+            );
+        }
+        else if (type != PCMType::Unsupported)
+        {
+            /* Use stack storage for the block, unless a single frame does not fit into it */
+            float               localBlock[WaveBuffer::maxBlockSamples];
+            std::vector<float>  dynamicBlock;
+            float*              block = localBlock;
+
+            if (framesPerBlock * channels > WaveBuffer::maxBlockSamples)
+            {
+                dynamicBlock.resize(framesPerBlock * channels);
+                block = dynamicBlock.data();
+            }
+
+            /* Convert PCM samples block by block */
+            ForEachBlockRange(
+                frames, framesPerBlock, reverse,
+                [&](std::size_t indexBegin, std::size_t blockFrames)
+                {
+                    auto pcm = data + indexBegin * frameSize;
+                    ConvertPCMToFloat(type, pcm, block, blockFrames * channels);
+                    auto result = blockFunction(block, blockFrames, channels, std::uint16_t(0u), indexBegin);
+                    StoreBlock(type, block, pcm, blockFrames * channels);
+                    return result;
+                }
+            );
+        }
+    }
+}
+
+
+/* ----- Transforms ----- */
+
+void ReverseFrames(const WaveBufferView& view)
+{
+    const auto& format = view.GetFormat();
+    const auto  frames = view.GetSampleFrames();
+
+    if (view.GetStorage() == WaveBufferStorage::PlanarFloat)
+    {
+        for (std::uint16_t chn = 0; chn < format.channels; ++chn)
+            ReverseElements(view.ChannelData(chn), frames, sizeof(float));
+    }
+    else if (frames > 0)
+        ReverseElements(view.Data(), frames, format.BytesPerFrame());
+}
+
+void ApplyGain(const WaveBufferView& view, float gain)
+{
+    if (gain == 1.0f)
+        return;
+
+    ProcessBlocks(
+        view, false,
+        [gain](float* samples, std::size_t frames, std::uint16_t channels, std::uint16_t /*channel*/, std::size_t /*indexBegin*/)
+        {
+            ScaleCopy(samples, samples, gain, frames * channels);
+            return true;
+        }
+    );
+}
+
+void ApplyGainRamp(const WaveBufferView& view, double gainBegin, double gainEnd)
+{
+    const auto frames = view.GetSampleFrames();
+    if (frames == 0)
+        return;
+
+    /* Compute the start gain of each block with double precision, so that the ramp does not drift over long ranges */
+    const auto gainStep = (gainEnd - gainBegin) / static_cast<double>(frames);
+
+    ProcessBlocks(
+        view, false,
+        [gainBegin, gainStep](float* samples, std::size_t frames, std::uint16_t channels, std::uint16_t /*channel*/, std::size_t indexBegin)
+        {
+            auto gain = gainBegin + gainStep * static_cast<double>(indexBegin);
+            ScaleRamp(samples, frames, channels, static_cast<float>(gain), static_cast<float>(gainStep));
+            return true;
+        }
+    );
+}
+
+void ApplyChannelOffsets(const WaveBufferView& view, const float* offsets)
+{
+    ProcessBlocks(
+        view, false,
+        [offsets](float* samples, std::size_t frames, std::uint16_t channels, std::uint16_t channel, std::size_t /*indexBegin*/)
+        {
+            OffsetChannels(samples, frames, channels, offsets + channel);
+            return true;
+        }
+    );
+}
+
+
+/* ----- Analysis ----- */
+
+float GetPeakLevel(const WaveBufferConstView& view)
+{
+    float peak = 0.0f;
+
+    ProcessBlocks(
+        view, false,
+        [&peak](const float* samples, std::size_t frames, std::uint16_t channels, std::uint16_t /*channel*/, std::size_t /*indexBegin*/)
+        {
+            peak = std::max(peak, AbsMax(samples, frames * channels));
+            return true;
+        }
+    );
+
+    return peak;
+}
+
+double GetSquareSum(const WaveBufferConstView& view)
+{
+    double sum = 0.0;
+
+    ProcessBlocks(
+        view, false,
+        [&sum](const float* samples, std::size_t frames, std::uint16_t channels, std::uint16_t /*channel*/, std::size_t /*indexBegin*/)
+        {
+            sum += DotProduct(samples, samples, frames * channels);
+            return true;
+        }
+    );
+
+    return sum;
+}
+
+void GetChannelSums(const WaveBufferConstView& view, double* sums)
+{
+    ProcessBlocks(
+        view, false,
+        [sums](const float* samples, std::size_t frames, std::uint16_t channels, std::uint16_t channel, std::size_t /*indexBegin*/)
+        {
+            SumChannels(samples, frames, channels, sums + channel);
+            return true;
+        }
+    );
+}
+
+std::size_t FindFirstAudibleFrame(const WaveBufferConstView& view, float threshold)
+{
+    auto first = view.GetSampleFrames();
+
+    ProcessBlocks(
+        view, false,
+        [&](const float* samples, std::size_t frames, std::uint16_t channels, std::uint16_t /*channel*/, std::size_t indexBegin)
+        {
+            auto n = frames * channels;
+            auto i = FindFirstAbove(samples, n, threshold);
+            if (i < n)
+            {
+                first = std::min(first, indexBegin + i / channels);
+                return false;
+            }
+            return true;
+        }
+    );
+
+    return first;
+}
+
+std::size_t FindLastAudibleFrame(const WaveBufferConstView& view, float threshold)
+{
+    bool        found   = false;
+    std::size_t last    = 0;
+
+    ProcessBlocks(
+        view, true,
+        [&](const float* samples, std::size_t frames, std::uint16_t channels, std::uint16_t /*channel*/, std::size_t indexBegin)
+        {
+            auto n = frames * channels;
+            auto i = FindLastAbove(samples, n, threshold);
+            if (i < n)
+            {
+                last    = std::max(last, indexBegin + i / channels);
+                found   = true;
+                return false;
+            }
+            return true;
+        }
+    );
+
+    return (found ? last : view.GetSampleFrames());
+}
+
+
+} // /namespace Ac
+
+
+
+// ================================================================================
@@ -0,0 +1,61 @@
+/*
+ * SampleTransforms.h
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef AC_SAMPLE_TRANSFORMS_H
+#define AC_SAMPLE_TRANSFORMS_H
+
+
+#include <Ac/WaveBufferView.h>
+#include <cstddef>
+
+
+namespace Ac
+{
+
+
+/*
+In-place bulk transforms on the sample storage of a view (interleaved PCM data in all supported formats, or planar floating-points).
+The PCM samples are converted block by block with the bulk conversion kernels and processed with the vector kernels,
+so each sample is only loaded from and stored to memory once. Modified samples are clamped to [-1, 1].
+*/
+
+//! Reverses the order of all sample frames. This is lossless for all formats.
+void ReverseFrames(const WaveBufferView& view);
+
+//! Multiplies all samples by the specified gain.
+void ApplyGain(const WaveBufferView& view, float gain);
+
+//! Multiplies all samples by a linear gain ramp, which starts at the first frame with 'gainBegin' and ends after the last frame with 'gainEnd'.
+void ApplyGainRamp(const WaveBufferView& view, double gainBegin, double gainEnd);
+
+//! Adds the respective offset to all samples of each channel, i.e. 'offsets' must have one element per channel.
+void ApplyChannelOffsets(const WaveBufferView& view, const float* offsets);
+
+//! Returns the maximal absolute sample value.
+float GetPeakLevel(const WaveBufferConstView& view);
+
+//! Returns the sum of all squared sample values.
+double GetSquareSum(const WaveBufferConstView& view);
+
+//! Adds the samples of each channel to the respective sum, i.e. 'sums' must have one element per channel.
+void GetChannelSums(const WaveBufferConstView& view, double* sums);
+
+//! Returns the index of the first sample frame with a sample whose absolute value is greater than the threshold, or the number of frames if there is none.
+std::size_t FindFirstAudibleFrame(const WaveBufferConstView& view, float threshold);
+
+//! Returns the index of the last sample frame with a sample whose absolute value is greater than the threshold, or the number of frames if there is none.
+std::size_t FindLastAudibleFrame(const WaveBufferConstView& view, float threshold);
+
+
+} // /namespace Ac
+
+
+#endif
+
+
+
+// ================================================================================
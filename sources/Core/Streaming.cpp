@@ -6,6 +6,7 @@
  */
 
 #include "Streaming.h"
+#include <algorithm>
 
 
 namespace Ac
@@ -24,6 +25,13 @@ static void EnsureNonEmptyBuffer(WaveBuffer& waveBuffer, const WaveBufferFormat&
     }
 }
 
+// Queues only the sample frames which have been streamed into the wave buffer (the last chunk of a stream is usually shorter).
+static void QueueStreamedFrames(Sound& sound, const WaveBuffer& waveBuffer, std::size_t bytes)
+{
+    auto frames = bytes / std::max(std::size_t(1u), waveBuffer.GetFormat().BytesPerFrame());
+    sound.QueueBuffer(WaveBufferConstView(waveBuffer, 0, frames));
+}
+
 AC_EXPORT void InitStreaming(Sound& sound, double startTime, std::size_t queueAdvanceSize)
 {
     const auto& stream = sound.GetStreamSource();
@@ -38,7 +46,7 @@ AC_EXPORT void InitStreaming(Sound& sound, double startTime, std::size_t queueAd
         {
             auto bytes = stream->StreamWaveBuffer(g_commonStreamingBuffer);
             if (bytes > 0)
-                sound.QueueBuffer(g_commonStreamingBuffer);
+                QueueStreamedFrames(sound, g_commonStreamingBuffer, bytes);
             else
                 break;
         }
@@ -57,7 +65,7 @@ AC_EXPORT void Streaming(Sound& sound, WaveBuffer& waveBuffer)
         {
             auto bytes = stream->StreamWaveBuffer(waveBuffer);
             if (bytes > 0)
-                sound.QueueBuffer(waveBuffer);
+                QueueStreamedFrames(sound, waveBuffer, bytes);
             else
                 break;
         }
@@ -0,0 +1,194 @@
+/*
+ * ThreadPool.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include <Ac/ThreadPool.h>
+
+#include <algorithm>
+
+
+namespace Ac
+{
+
+
+// Number of partitions per thread, so that faster threads can take over partitions of slower threads
+static const std::size_t g_partitionsPerThread = 4;
+
+ThreadPool::ThreadPool(std::size_t numThreads) :
+    nextPartition_  { 0     },
+    failed_         { false }
+{
+    if (numThreads == 0)
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    /* Launch worker threads (the calling thread is the remaining one) */
+    for (std::size_t i = 1; i < numThreads; ++i)
+        workers_.emplace_back(&ThreadPool::WorkerThread, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock { mutex_ };
+        quit_ = true;
+    }
+    workSignal_.notify_all();
+
+    for (auto& worker : workers_)
+        worker.join();
+}
+
+void ThreadPool::ParallelFor(std::size_t begin, std::size_t end, std::size_t grainSize, const ParallelRangeFunction& task)
+{
+    if (begin >= end || !task)
+        return;
+
+    const auto count = end - begin;
+    grainSize = std::max(grainSize, std::size_t(1u));
+
+    /* Process range on the calling thread if it's too small, or the pool is already busy (e.g. for nested calls) */
+    std::unique_lock<std::mutex> rangeLock { rangeMutex_, std::try_to_lock };
+
+    if (workers_.empty() || count <= grainSize || !rangeLock.owns_lock())
+    {
+        task(begin, end);
+        return;
+    }
+
+    /* Setup partitions and wake up worker threads */
+    {
+        std::unique_lock<std::mutex> lock { mutex_ };
+
+        /* Wait until late workers of the previous range have left */
+        doneSignal_.wait(lock, [this]() { return (activeWorkers_ == 0); });
+
+        task_               = &task;
+        begin_              = begin;
+        end_                = end;
+        partitionSize_      = std::max(grainSize, (count + GetNumThreads() * g_partitionsPerThread - 1) / (GetNumThreads() * g_partitionsPerThread));
+        numPartitions_      = (count + partitionSize_ - 1) / partitionSize_;
+        finishedPartitions_ = 0;
+        exception_          = nullptr;
+
+        nextPartition_.store(0);
+        failed_.store(false);
+
+        ++generation_;
+    }
+    workSignal_.notify_all();
+
+    /* Take part in the work and wait for the remaining partitions */
+    RunPartitions();
+
+    std::exception_ptr exception;
+    {
+        std::unique_lock<std::mutex> lock { mutex_ };
+        doneSignal_.wait(lock, [this]() { return (finishedPartitions_ == numPartitions_ && activeWorkers_ == 0); });
+        task_ = nullptr;
+        std::swap(exception, exception_);
+    }
+
+    if (exception)
+        std::rethrow_exception(exception);
+}
+
+
+/*
+ * ======= Private: =======
+ */
+
+void ThreadPool::WorkerThread()
+{
+    std::uint64_t generation = 0;
+
+    while (true)
+    {
+        /* Wait for a new range */
+        {
+            std::unique_lock<std::mutex> lock { mutex_ };
+            workSignal_.wait(lock, [&]() { return (quit_ || generation_ != generation); });
+
+            if (quit_)
+                return;
+
+            generation = generation_;
+            ++activeWorkers_;
+        }
+
+        RunPartitions();
+
+        {
+            std::lock_guard<std::mutex> lock { mutex_ };
+            --activeWorkers_;
+        }
+        doneSignal_.notify_all();
+    }
+}
+
+void ThreadPool::RunPartitions()
+{
+    while (true)
+    {
+        /* Claim next partition */
+        auto partition = nextPartition_.fetch_add(1);
+        if (partition >= numPartitions_)
+            break;
+
+        auto first  = begin_ + partition * partitionSize_;
+        auto last   = std::min(end_, first + partitionSize_);
+
+        /* Skip remaining partitions after a task has failed */
+        if (!failed_.load())
+        {
+            try
+            {
+                (*task_)(first, last);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock { mutex_ };
+                if (!exception_)
+                    exception_ = std::current_exception();
+                failed_.store(true);
+            }
+        }
+
+        bool finished = false;
+        {
+            std::lock_guard<std::mutex> lock { mutex_ };
+            finished = (++finishedPartitions_ == numPartitions_);
+        }
+
+        if (finished)
+            doneSignal_.notify_all();
+    }
+}
+
+
+/* ----- Default thread pool ----- */
+
+static std::atomic<ThreadPool*> g_defaultThreadPool { nullptr };
+
+AC_EXPORT ThreadPool& GetDefaultThreadPool()
+{
+    if (auto threadPool = g_defaultThreadPool.load())
+        return *threadPool;
+
+    static ThreadPool threadPool;
+    return threadPool;
+}
+
+AC_EXPORT void SetDefaultThreadPool(ThreadPool* threadPool)
+{
+    g_defaultThreadPool.store(threadPool);
+}
+
+
+} // /namespace Ac
+
+
+
+// ================================================================================
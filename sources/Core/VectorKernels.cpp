@@ -0,0 +1,1428 @@
+/*
+ * VectorKernels.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "VectorKernels.h"
+#include "CPUFeatures.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+
+namespace Ac
+{
+
+
+/* ----- Scalar kernels ----- */
+
+static float ScalarDotProduct(const float* a, const float* b, std::size_t n)
+{
+    /* Use four accumulators to allow the compiler to pipeline the additions */
+    float sum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        sum[0] += a[i    ] * b[i    ];
+        sum[1] += a[i + 1] * b[i + 1];
+        sum[2] += a[i + 2] * b[i + 2];
+        sum[3] += a[i + 3] * b[i + 3];
+    }
+
+    for (; i < n; ++i)
+        sum[0] += a[i] * b[i];
+
+    return (sum[0] + sum[1]) + (sum[2] + sum[3]);
+}
+
+static void ScalarScaleCopy(float* dst, const float* src, float gain, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i)
+        dst[i] = src[i] * gain;
+}
+
+static void ScalarScaleAdd(float* dst, const float* src, float gain, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i)
+        dst[i] += src[i] * gain;
+}
+
+static float ScalarAbsMax(const float* src, std::size_t n)
+{
+    float peak = 0.0f;
+
+    for (std::size_t i = 0; i < n; ++i)
+        peak = std::max(peak, std::abs(src[i]));
+
+    return peak;
+}
+
+static std::size_t ScalarFindFirstAbove(const float* src, std::size_t n, float threshold)
+{
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        if (std::abs(src[i]) > threshold)
+            return i;
+    }
+    return n;
+}
+
+static std::size_t ScalarFindLastAbove(const float* src, std::size_t n, float threshold)
+{
+    for (std::size_t i = n; i > 0; --i)
+    {
+        if (std::abs(src[i - 1]) > threshold)
+            return (i - 1);
+    }
+    return n;
+}
+
+// Multiplies the interleaved samples starting at sample 'i' by the gain ramp (all kernels compute the gain of a frame in the same way).
+static void ScalarScaleRampTail(float* data, std::size_t i, std::size_t n, std::uint16_t channels, float gain, float gainStep)
+{
+    for (; i < n; ++i)
+        data[i] *= gain + gainStep * static_cast<float>(i / channels);
+}
+
+static void ScalarScaleRamp(float* data, std::size_t frames, std::uint16_t channels, float gain, float gainStep)
+{
+    ScalarScaleRampTail(data, 0, frames * channels, channels, gain, gainStep);
+}
+
+static void ScalarFramePeaks(const float* src, std::size_t frames, std::uint16_t channels, float* peaks)
+{
+    for (std::size_t i = 0; i < frames; ++i)
+    {
+        float peak = 0.0f;
+        for (std::uint16_t chn = 0; chn < channels; ++chn)
+            peak = std::max(peak, std::abs(*(src++)));
+        peaks[i] = peak;
+    }
+}
+
+static void ScalarScaleFrames(float* data, std::size_t frames, std::uint16_t channels, const float* gains)
+{
+    for (std::size_t i = 0; i < frames; ++i)
+    {
+        for (std::uint16_t chn = 0; chn < channels; ++chn)
+            *(data++) *= gains[i];
+    }
+}
+
+static void ScalarCrossfadeFrames(float* dst, const float* from, const float* to, std::size_t frames, std::uint16_t channels, const float* gainsFrom, const float* gainsTo)
+{
+    for (std::size_t i = 0; i < frames; ++i)
+    {
+        for (std::uint16_t chn = 0; chn < channels; ++chn)
+            *(dst++) = *(from++) * gainsFrom[i] + *(to++) * gainsTo[i];
+    }
+}
+
+static void ScalarSumChannels(const float* src, std::size_t frames, std::uint16_t channels, double* sums)
+{
+    for (std::size_t i = 0; i < frames; ++i)
+    {
+        for (std::uint16_t chn = 0; chn < channels; ++chn)
+            sums[chn] += *(src++);
+    }
+}
+
+static void ScalarOffsetChannels(float* data, std::size_t frames, std::uint16_t channels, const float* offsets)
+{
+    for (std::size_t i = 0; i < frames; ++i)
+    {
+        for (std::uint16_t chn = 0; chn < channels; ++chn)
+            *(data++) += offsets[chn];
+    }
+}
+
+template <typename T>
+static void ScalarReverse(void* data, std::size_t n)
+{
+    auto elements = reinterpret_cast<T*>(data);
+    std::reverse(elements, elements + n);
+}
+
+#if defined(AC_SIMD_SSE2) || defined(AC_SIMD_NEON)
+
+// Returns true if the sample frames with the specified number of channels can be processed with a periodic pattern of 'lanes' floating-points.
+static bool IsPeriodicLayout(std::uint16_t channels, std::size_t lanes)
+{
+    return (channels > 0 && lanes % channels == 0);
+}
+
+#endif
+
+
+/* ----- SSE2 kernels ----- */
+
+#if defined(AC_SIMD_SSE2)
+
+static float SSE2HorizontalSum(__m128 v)
+{
+    v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+    v = _mm_add_ss(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)));
+    return _mm_cvtss_f32(v);
+}
+
+static float SSE2DotProduct(const float* a, const float* b, std::size_t n)
+{
+    auto sum0 = _mm_setzero_ps();
+    auto sum1 = _mm_setzero_ps();
+
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_loadu_ps(a + i    ), _mm_loadu_ps(b + i    )));
+        sum1 = _mm_add_ps(sum1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+
+    if (i + 4 <= n)
+    {
+        sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        i += 4;
+    }
+
+    auto sum = SSE2HorizontalSum(_mm_add_ps(sum0, sum1));
+
+    for (; i < n; ++i)
+        sum += a[i] * b[i];
+
+    return sum;
+}
+
+static void SSE2ScaleCopy(float* dst, const float* src, float gain, std::size_t n)
+{
+    auto g = _mm_set1_ps(gain);
+
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_loadu_ps(src + i), g));
+
+    for (; i < n; ++i)
+        dst[i] = src[i] * gain;
+}
+
+static void SSE2ScaleAdd(float* dst, const float* src, float gain, std::size_t n)
+{
+    auto g = _mm_set1_ps(gain);
+
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(_mm_loadu_ps(src + i), g)));
+
+    for (; i < n; ++i)
+        dst[i] += src[i] * gain;
+}
+
+static float SSE2AbsMax(const float* src, std::size_t n)
+{
+    const auto absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+
+    auto peak0 = _mm_setzero_ps();
+    auto peak1 = _mm_setzero_ps();
+
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        peak0 = _mm_max_ps(peak0, _mm_and_ps(_mm_loadu_ps(src + i    ), absMask));
+        peak1 = _mm_max_ps(peak1, _mm_and_ps(_mm_loadu_ps(src + i + 4), absMask));
+    }
+
+    if (i + 4 <= n)
+    {
+        peak0 = _mm_max_ps(peak0, _mm_and_ps(_mm_loadu_ps(src + i), absMask));
+        i += 4;
+    }
+
+    peak0 = _mm_max_ps(peak0, peak1);
+    peak0 = _mm_max_ps(peak0, _mm_movehl_ps(peak0, peak0));
+    peak0 = _mm_max_ss(peak0, _mm_shuffle_ps(peak0, peak0, _MM_SHUFFLE(1, 1, 1, 1)));
+
+    return std::max(_mm_cvtss_f32(peak0), ScalarAbsMax(src + i, n - i));
+}
+
+static std::size_t SSE2FindFirstAbove(const float* src, std::size_t n, float threshold)
+{
+    const auto absMask  = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    const auto t        = _mm_set1_ps(threshold);
+
+    /* Find first vector with a sample above the threshold, then find the sample itself */
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        if (_mm_movemask_ps(_mm_cmpgt_ps(_mm_and_ps(_mm_loadu_ps(src + i), absMask), t)) != 0)
+            break;
+    }
+
+    return (i + ScalarFindFirstAbove(src + i, n - i, threshold));
+}
+
+static std::size_t SSE2FindLastAbove(const float* src, std::size_t n, float threshold)
+{
+    const auto absMask  = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    const auto t        = _mm_set1_ps(threshold);
+
+    /* Find last vector with a sample above the threshold, then find the sample itself */
+    std::size_t i = n;
+    for (; i >= 4; i -= 4)
+    {
+        if (_mm_movemask_ps(_mm_cmpgt_ps(_mm_and_ps(_mm_loadu_ps(src + i - 4), absMask), t)) != 0)
+            break;
+    }
+
+    auto last = ScalarFindLastAbove(src, i, threshold);
+    return (last < i ? last : n);
+}
+
+static void SSE2ScaleRamp(float* data, std::size_t frames, std::uint16_t channels, float gain, float gainStep)
+{
+    if (!IsPeriodicLayout(channels, 4))
+    {
+        ScalarScaleRamp(data, frames, channels, gain, gainStep);
+        return;
+    }
+
+    /* Keep the frame index of each lane, e.g. (0, 0, 1, 1) for two channels */
+    auto frame = _mm_setr_ps(
+        static_cast<float>(0 / channels),
+        static_cast<float>(1 / channels),
+        static_cast<float>(2 / channels),
+        static_cast<float>(3 / channels)
+    );
+
+    const auto frameStep    = _mm_set1_ps(static_cast<float>(4 / channels));
+    const auto g            = _mm_set1_ps(gain);
+    const auto s            = _mm_set1_ps(gainStep);
+    const auto n            = frames * channels;
+
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), _mm_add_ps(g, _mm_mul_ps(s, frame))));
+        frame = _mm_add_ps(frame, frameStep);
+    }
+
+    ScalarScaleRampTail(data, i, n, channels, gain, gainStep);
+}
+static void SSE2FramePeaks(const float* src, std::size_t frames, std::uint16_t channels, float* peaks)
+{
+    const auto absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+
+    std::size_t i = 0;
+
+    if (channels == 1)
+    {
+        for (; i + 4 <= frames; i += 4)
+            _mm_storeu_ps(peaks + i, _mm_and_ps(_mm_loadu_ps(src + i), absMask));
+    }
+    else if (channels == 2)
+    {
+        /* Separate left and right samples of four sample frames */
+        for (; i + 4 <= frames; i += 4)
+        {
+            auto a = _mm_and_ps(_mm_loadu_ps(src + i*2    ), absMask);
+            auto b = _mm_and_ps(_mm_loadu_ps(src + i*2 + 4), absMask);
+            auto l = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+            auto r = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+            _mm_storeu_ps(peaks + i, _mm_max_ps(l, r));
+        }
+    }
+
+    ScalarFramePeaks(src + i*channels, frames - i, channels, peaks + i);
+}
+
+static void SSE2ScaleFrames(float* data, std::size_t frames, std::uint16_t channels, const float* gains)
+{
+    std::size_t i = 0;
+
+    if (channels == 1)
+    {
+        for (; i + 4 <= frames; i += 4)
+            _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), _mm_loadu_ps(gains + i)));
+    }
+    else if (channels == 2)
+    {
+        /* Duplicate the gains of four sample frames for the left and right samples */
+        for (; i + 4 <= frames; i += 4)
+        {
+            auto g = _mm_loadu_ps(gains + i);
+            _mm_storeu_ps(data + i*2,     _mm_mul_ps(_mm_loadu_ps(data + i*2    ), _mm_unpacklo_ps(g, g)));
+            _mm_storeu_ps(data + i*2 + 4, _mm_mul_ps(_mm_loadu_ps(data + i*2 + 4), _mm_unpackhi_ps(g, g)));
+        }
+    }
+
+    ScalarScaleFrames(data + i*channels, frames - i, channels, gains + i);
+}
+
+static void SSE2CrossfadeFrames(float* dst, const float* from, const float* to, std::size_t frames, std::uint16_t channels, const float* gainsFrom, const float* gainsTo)
+{
+    std::size_t i = 0;
+
+    if (channels == 1)
+    {
+        for (; i + 4 <= frames; i += 4)
+        {
+            auto a = _mm_mul_ps(_mm_loadu_ps(from + i), _mm_loadu_ps(gainsFrom + i));
+            auto b = _mm_mul_ps(_mm_loadu_ps(to   + i), _mm_loadu_ps(gainsTo   + i));
+            _mm_storeu_ps(dst + i, _mm_add_ps(a, b));
+        }
+    }
+    else if (channels == 2)
+    {
+        /* Duplicate the gains of four sample frames for the left and right samples */
+        for (; i + 4 <= frames; i += 4)
+        {
+            auto ga = _mm_loadu_ps(gainsFrom + i);
+            auto gb = _mm_loadu_ps(gainsTo   + i);
+            auto lo = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(from + i*2    ), _mm_unpacklo_ps(ga, ga)), _mm_mul_ps(_mm_loadu_ps(to + i*2    ), _mm_unpacklo_ps(gb, gb)));
+            auto hi = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(from + i*2 + 4), _mm_unpackhi_ps(ga, ga)), _mm_mul_ps(_mm_loadu_ps(to + i*2 + 4), _mm_unpackhi_ps(gb, gb)));
+            _mm_storeu_ps(dst + i*2,     lo);
+            _mm_storeu_ps(dst + i*2 + 4, hi);
+        }
+    }
+
+    ScalarCrossfadeFrames(dst + i*channels, from + i*channels, to + i*channels, frames - i, channels, gainsFrom + i, gainsTo + i);
+}
+
+static void SSE2SumChannels(const float* src, std::size_t frames, std::uint16_t channels, double* sums)
+{
+    if (!IsPeriodicLayout(channels, 4))
+    {
+        ScalarSumChannels(src, frames, channels, sums);
+        return;
+    }
+
+    /* Accumulate each lane with double precision */
+    auto sumLo = _mm_setzero_pd();
+    auto sumHi = _mm_setzero_pd();
+
+    const auto n = frames * channels;
+
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        auto v = _mm_loadu_ps(src + i);
+        sumLo = _mm_add_pd(sumLo, _mm_cvtps_pd(v));
+        sumHi = _mm_add_pd(sumHi, _mm_cvtps_pd(_mm_movehl_ps(v, v)));
+    }
+
+    double lanes[4];
+    _mm_storeu_pd(lanes, sumLo);
+    _mm_storeu_pd(lanes + 2, sumHi);
+
+    for (std::size_t lane = 0; lane < 4; ++lane)
+        sums[lane % channels] += lanes[lane];
+
+    for (; i < n; ++i)
+        sums[i % channels] += src[i];
+}
+
+static void SSE2OffsetChannels(float* data, std::size_t frames, std::uint16_t channels, const float* offsets)
+{
+    if (!IsPeriodicLayout(channels, 4))
+    {
+        ScalarOffsetChannels(data, frames, channels, offsets);
+        return;
+    }
+
+    const auto offset = _mm_setr_ps(offsets[0 % channels], offsets[1 % channels], offsets[2 % channels], offsets[3 % channels]);
+    const auto n = frames * channels;
+
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm_storeu_ps(data + i, _mm_add_ps(_mm_loadu_ps(data + i), offset));
+
+    for (; i < n; ++i)
+        data[i] += offsets[i % channels];
+}
+
+// Reverses the array by swapping reversed vectors from both ends, and the remaining middle part element by element.
+template <typename T, typename ReverseVector>
+static void SSE2ReverseArray(void* data, std::size_t n, ReverseVector reverseVector)
+{
+    const std::size_t step = sizeof(__m128i) / sizeof(T);
+
+    auto elements = reinterpret_cast<T*>(data);
+
+    std::size_t i = 0, j = n;
+    for (; i + 2*step <= j; i += step, j -= step)
+    {
+        auto front  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(elements + i));
+        auto back   = _mm_loadu_si128(reinterpret_cast<const __m128i*>(elements + j - step));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(elements + i), reverseVector(back));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(elements + j - step), reverseVector(front));
+    }
+
+    std::reverse(elements + i, elements + j);
+}
+
+static __m128i SSE2ReverseVector16(__m128i v)
+{
+    v = _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+    v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+    return _mm_shufflehi_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+}
+
+static __m128i SSE2ReverseVector32(__m128i v)
+{
+    return _mm_shuffle_epi32(v, _MM_SHUFFLE(0, 1, 2, 3));
+}
+
+static __m128i SSE2ReverseVector64(__m128i v)
+{
+    return _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+}
+
+static void SSE2Reverse16(void* data, std::size_t n)
+{
+    SSE2ReverseArray<std::uint16_t>(data, n, SSE2ReverseVector16);
+}
+
+static void SSE2Reverse32(void* data, std::size_t n)
+{
+    SSE2ReverseArray<std::uint32_t>(data, n, SSE2ReverseVector32);
+}
+
+static void SSE2Reverse64(void* data, std::size_t n)
+{
+    SSE2ReverseArray<std::uint64_t>(data, n, SSE2ReverseVector64);
+}
+
+#endif // /AC_SIMD_SSE2
+
+
+/* ----- AVX2 kernels ----- */
+
+#if defined(AC_SIMD_AVX2)
+
+AC_TARGET_AVX2
+static float AVX2DotProduct(const float* a, const float* b, std::size_t n)
+{
+    auto sum0 = _mm256_setzero_ps();
+    auto sum1 = _mm256_setzero_ps();
+
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        sum0 = _mm256_add_ps(sum0, _mm256_mul_ps(_mm256_loadu_ps(a + i    ), _mm256_loadu_ps(b + i    )));
+        sum1 = _mm256_add_ps(sum1, _mm256_mul_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8)));
+    }
+
+    if (i + 8 <= n)
+    {
+        sum0 = _mm256_add_ps(sum0, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+        i += 8;
+    }
+
+    sum0 = _mm256_add_ps(sum0, sum1);
+
+    auto v = _mm_add_ps(_mm256_castps256_ps128(sum0), _mm256_extractf128_ps(sum0, 1));
+
+    if (i + 4 <= n)
+    {
+        v = _mm_add_ps(v, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        i += 4;
+    }
+
+    v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+    v = _mm_add_ss(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)));
+
+    auto sum = _mm_cvtss_f32(v);
+
+    for (; i < n; ++i)
+        sum += a[i] * b[i];
+
+    return sum;
+}
+
+AC_TARGET_AVX2
+static void AVX2ScaleCopy(float* dst, const float* src, float gain, std::size_t n)
+{
+    auto g = _mm256_set1_ps(gain);
+
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_loadu_ps(src + i), g));
+
+    for (; i < n; ++i)
+        dst[i] = src[i] * gain;
+}
+
+AC_TARGET_AVX2
+static void AVX2ScaleAdd(float* dst, const float* src, float gain, std::size_t n)
+{
+    auto g = _mm256_set1_ps(gain);
+
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_loadu_ps(dst + i), _mm256_mul_ps(_mm256_loadu_ps(src + i), g)));
+
+    for (; i < n; ++i)
+        dst[i] += src[i] * gain;
+}
+
+AC_TARGET_AVX2
+static float AVX2AbsMax(const float* src, std::size_t n)
+{
+    const auto absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+
+    auto peak0 = _mm256_setzero_ps();
+    auto peak1 = _mm256_setzero_ps();
+
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        peak0 = _mm256_max_ps(peak0, _mm256_and_ps(_mm256_loadu_ps(src + i    ), absMask));
+        peak1 = _mm256_max_ps(peak1, _mm256_and_ps(_mm256_loadu_ps(src + i + 8), absMask));
+    }
+
+    if (i + 8 <= n)
+    {
+        peak0 = _mm256_max_ps(peak0, _mm256_and_ps(_mm256_loadu_ps(src + i), absMask));
+        i += 8;
+    }
+
+    peak0 = _mm256_max_ps(peak0, peak1);
+
+    auto v = _mm_max_ps(_mm256_castps256_ps128(peak0), _mm256_extractf128_ps(peak0, 1));
+    v = _mm_max_ps(v, _mm_movehl_ps(v, v));
+    v = _mm_max_ss(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)));
+
+    return std::max(_mm_cvtss_f32(v), ScalarAbsMax(src + i, n - i));
+}
+
+AC_TARGET_AVX2
+static std::size_t AVX2FindFirstAbove(const float* src, std::size_t n, float threshold)
+{
+    const auto absMask  = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+    const auto t        = _mm256_set1_ps(threshold);
+
+    /* Find first vector with a sample above the threshold, then find the sample itself */
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        if (_mm256_movemask_ps(_mm256_cmp_ps(_mm256_and_ps(_mm256_loadu_ps(src + i), absMask), t, _CMP_GT_OQ)) != 0)
+            break;
+    }
+
+    return (i + ScalarFindFirstAbove(src + i, n - i, threshold));
+}
+
+AC_TARGET_AVX2
+static std::size_t AVX2FindLastAbove(const float* src, std::size_t n, float threshold)
+{
+    const auto absMask  = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+    const auto t        = _mm256_set1_ps(threshold);
+
+    /* Find last vector with a sample above the threshold, then find the sample itself */
+    std::size_t i = n;
+    for (; i >= 8; i -= 8)
+    {
+        if (_mm256_movemask_ps(_mm256_cmp_ps(_mm256_and_ps(_mm256_loadu_ps(src + i - 8), absMask), t, _CMP_GT_OQ)) != 0)
+            break;
+    }
+
+    auto last = ScalarFindLastAbove(src, i, threshold);
+    return (last < i ? last : n);
+}
+
+AC_TARGET_AVX2
+static void AVX2ScaleRamp(float* data, std::size_t frames, std::uint16_t channels, float gain, float gainStep)
+{
+    if (!IsPeriodicLayout(channels, 8))
+    {
+        ScalarScaleRamp(data, frames, channels, gain, gainStep);
+        return;
+    }
+
+    /* Keep the frame index of each lane, e.g. (0, 0, 1, 1, 2, 2, 3, 3) for two channels */
+    auto frame = _mm256_setr_ps(
+        static_cast<float>(0 / channels),
+        static_cast<float>(1 / channels),
+        static_cast<float>(2 / channels),
+        static_cast<float>(3 / channels),
+        static_cast<float>(4 / channels),
+        static_cast<float>(5 / channels),
+        static_cast<float>(6 / channels),
+        static_cast<float>(7 / channels)
+    );
+
+    const auto frameStep    = _mm256_set1_ps(static_cast<float>(8 / channels));
+    const auto g            = _mm256_set1_ps(gain);
+    const auto s            = _mm256_set1_ps(gainStep);
+    const auto n            = frames * channels;
+
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        _mm256_storeu_ps(data + i, _mm256_mul_ps(_mm256_loadu_ps(data + i), _mm256_add_ps(g, _mm256_mul_ps(s, frame))));
+        frame = _mm256_add_ps(frame, frameStep);
+    }
+
+    ScalarScaleRampTail(data, i, n, channels, gain, gainStep);
+}
+
+AC_TARGET_AVX2
+static void AVX2FramePeaks(const float* src, std::size_t frames, std::uint16_t channels, float* peaks)
+{
+    const auto absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+
+    std::size_t i = 0;
+
+    if (channels == 1)
+    {
+        for (; i + 8 <= frames; i += 8)
+            _mm256_storeu_ps(peaks + i, _mm256_and_ps(_mm256_loadu_ps(src + i), absMask));
+    }
+    else if (channels == 2)
+    {
+        /* Separate left and right samples of eight sample frames (the shuffle works within the 128-bit lanes, so reorder the pairs of frames afterwards) */
+        for (; i + 8 <= frames; i += 8)
+        {
+            auto a = _mm256_and_ps(_mm256_loadu_ps(src + i*2    ), absMask);
+            auto b = _mm256_and_ps(_mm256_loadu_ps(src + i*2 + 8), absMask);
+            auto l = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+            auto r = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+            auto p = _mm256_castps_pd(_mm256_max_ps(l, r));
+            _mm256_storeu_ps(peaks + i, _mm256_castpd_ps(_mm256_permute4x64_pd(p, _MM_SHUFFLE(3, 1, 2, 0))));
+        }
+    }
+
+    ScalarFramePeaks(src + i*channels, frames - i, channels, peaks + i);
+}
+
+AC_TARGET_AVX2
+static void AVX2ScaleFrames(float* data, std::size_t frames, std::uint16_t channels, const float* gains)
+{
+    std::size_t i = 0;
+
+    if (channels == 1)
+    {
+        for (; i + 8 <= frames; i += 8)
+            _mm256_storeu_ps(data + i, _mm256_mul_ps(_mm256_loadu_ps(data + i), _mm256_loadu_ps(gains + i)));
+    }
+    else if (channels == 2)
+    {
+        /* Duplicate the gains of eight sample frames for the left and right samples */
+        const auto lo = _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+        const auto hi = _mm256_setr_epi32(4, 4, 5, 5, 6, 6, 7, 7);
+
+        for (; i + 8 <= frames; i += 8)
+        {
+            auto g = _mm256_loadu_ps(gains + i);
+            _mm256_storeu_ps(data + i*2,     _mm256_mul_ps(_mm256_loadu_ps(data + i*2    ), _mm256_permutevar8x32_ps(g, lo)));
+            _mm256_storeu_ps(data + i*2 + 8, _mm256_mul_ps(_mm256_loadu_ps(data + i*2 + 8), _mm256_permutevar8x32_ps(g, hi)));
+        }
+    }
+
+    ScalarScaleFrames(data + i*channels, frames - i, channels, gains + i);
+}
+
+AC_TARGET_AVX2
+static void AVX2CrossfadeFrames(float* dst, const float* from, const float* to, std::size_t frames, std::uint16_t channels, const float* gainsFrom, const float* gainsTo)
+{
+    std::size_t i = 0;
+
+    if (channels == 1)
+    {
+        for (; i + 8 <= frames; i += 8)
+        {
+            auto a = _mm256_mul_ps(_mm256_loadu_ps(from + i), _mm256_loadu_ps(gainsFrom + i));
+            auto b = _mm256_mul_ps(_mm256_loadu_ps(to   + i), _mm256_loadu_ps(gainsTo   + i));
+            _mm256_storeu_ps(dst + i, _mm256_add_ps(a, b));
+        }
+    }
+    else if (channels == 2)
+    {
+        /* Duplicate the gains of eight sample frames for the left and right samples */
+        const auto lo = _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+        const auto hi = _mm256_setr_epi32(4, 4, 5, 5, 6, 6, 7, 7);
+
+        for (; i + 8 <= frames; i += 8)
+        {
+            auto ga = _mm256_loadu_ps(gainsFrom + i);
+            auto gb = _mm256_loadu_ps(gainsTo   + i);
+            auto a0 = _mm256_mul_ps(_mm256_loadu_ps(from + i*2    ), _mm256_permutevar8x32_ps(ga, lo));
+            auto a1 = _mm256_mul_ps(_mm256_loadu_ps(from + i*2 + 8), _mm256_permutevar8x32_ps(ga, hi));
+            auto b0 = _mm256_mul_ps(_mm256_loadu_ps(to   + i*2    ), _mm256_permutevar8x32_ps(gb, lo));
+            auto b1 = _mm256_mul_ps(_mm256_loadu_ps(to   + i*2 + 8), _mm256_permutevar8x32_ps(gb, hi));
+            _mm256_storeu_ps(dst + i*2,     _mm256_add_ps(a0, b0));
+            _mm256_storeu_ps(dst + i*2 + 8, _mm256_add_ps(a1, b1));
+        }
+    }
+
+    ScalarCrossfadeFrames(dst + i*channels, from + i*channels, to + i*channels, frames - i, channels, gainsFrom + i, gainsTo + i);
+}
+
+AC_TARGET_AVX2
+static void AVX2SumChannels(const float* src, std::size_t frames, std::uint16_t channels, double* sums)
+{
+    if (!IsPeriodicLayout(channels, 8))
+    {
+        ScalarSumChannels(src, frames, channels, sums);
+        return;
+    }
+
+    /* Accumulate each lane with double precision */
+    auto sumLo = _mm256_setzero_pd();
+    auto sumHi = _mm256_setzero_pd();
+
+    const auto n = frames * channels;
+
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        auto v = _mm256_loadu_ps(src + i);
+        sumLo = _mm256_add_pd(sumLo, _mm256_cvtps_pd(_mm256_castps256_ps128(v)));
+        sumHi = _mm256_add_pd(sumHi, _mm256_cvtps_pd(_mm256_extractf128_ps(v, 1)));
+    }
+
+    double lanes[8];
+    _mm256_storeu_pd(lanes, sumLo);
+    _mm256_storeu_pd(lanes + 4, sumHi);
+
+    for (std::size_t lane = 0; lane < 8; ++lane)
+        sums[lane % channels] += lanes[lane];
+
+    for (; i < n; ++i)
+        sums[i % channels] += src[i];
+}
+
+AC_TARGET_AVX2
+static void AVX2OffsetChannels(float* data, std::size_t frames, std::uint16_t channels, const float* offsets)
+{
+    if (!IsPeriodicLayout(channels, 8))
+    {
+        ScalarOffsetChannels(data, frames, channels, offsets);
+        return;
+    }
+
+    const auto offset = _mm256_setr_ps(
+        offsets[0 % channels], offsets[1 % channels], offsets[2 % channels], offsets[3 % channels],
+        offsets[4 % channels], offsets[5 % channels], offsets[6 % channels], offsets[7 % channels]
+    );
+
+    const auto n = frames * channels;
+
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm256_storeu_ps(data + i, _mm256_add_ps(_mm256_loadu_ps(data + i), offset));
+
+    for (; i < n; ++i)
+        data[i] += offsets[i % channels];
+}
+
+// Reverses the array by swapping reversed vectors from both ends, and the remaining middle part element by element.
+template <typename T, typename ReverseVector>
+AC_TARGET_AVX2
+static void AVX2ReverseArray(void* data, std::size_t n, ReverseVector reverseVector)
+{
+    const std::size_t step = sizeof(__m256i) / sizeof(T);
+
+    auto elements = reinterpret_cast<T*>(data);
+
+    std::size_t i = 0, j = n;
+    for (; i + 2*step <= j; i += step, j -= step)
+    {
+        auto front  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(elements + i));
+        auto back   = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(elements + j - step));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(elements + i), reverseVector(back));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(elements + j - step), reverseVector(front));
+    }
+
+    std::reverse(elements + i, elements + j);
+}
+
+AC_TARGET_AVX2
+static __m256i AVX2ReverseVector16(__m256i v)
+{
+    /* Reverse 16-bit elements within each 128-bit lane, then swap the lanes */
+    const auto mask = _mm256_setr_epi8(
+        14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1,
+        14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1
+    );
+    return _mm256_permute4x64_epi64(_mm256_shuffle_epi8(v, mask), _MM_SHUFFLE(1, 0, 3, 2));
+}
+
+AC_TARGET_AVX2
+static __m256i AVX2ReverseVector32(__m256i v)
+{
+    return _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+}
+
+AC_TARGET_AVX2
+static __m256i AVX2ReverseVector64(__m256i v)
+{
+    return _mm256_permute4x64_epi64(v, _MM_SHUFFLE(0, 1, 2, 3));
+}
+
+AC_TARGET_AVX2
+static void AVX2Reverse16(void* data, std::size_t n)
+{
+    AVX2ReverseArray<std::uint16_t>(data, n, AVX2ReverseVector16);
+}
+
+AC_TARGET_AVX2
+static void AVX2Reverse32(void* data, std::size_t n)
+{
+    AVX2ReverseArray<std::uint32_t>(data, n, AVX2ReverseVector32);
+}
+
+AC_TARGET_AVX2
+static void AVX2Reverse64(void* data, std::size_t n)
+{
+    AVX2ReverseArray<std::uint64_t>(data, n, AVX2ReverseVector64);
+}
+
+#endif // /AC_SIMD_AVX2
+
+
+/* ----- NEON kernels ----- */
+
+#if defined(AC_SIMD_NEON)
+
+static float NEONDotProduct(const float* a, const float* b, std::size_t n)
+{
+    auto sum0 = vdupq_n_f32(0.0f);
+    auto sum1 = vdupq_n_f32(0.0f);
+
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        sum0 = vmlaq_f32(sum0, vld1q_f32(a + i    ), vld1q_f32(b + i    ));
+        sum1 = vmlaq_f32(sum1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+    }
+
+    if (i + 4 <= n)
+    {
+        sum0 = vmlaq_f32(sum0, vld1q_f32(a + i), vld1q_f32(b + i));
+        i += 4;
+    }
+
+    auto sum = vaddvq_f32(vaddq_f32(sum0, sum1));
+
+    for (; i < n; ++i)
+        sum += a[i] * b[i];
+
+    return sum;
+}
+
+static void NEONScaleCopy(float* dst, const float* src, float gain, std::size_t n)
+{
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        vst1q_f32(dst + i, vmulq_n_f32(vld1q_f32(src + i), gain));
+
+    for (; i < n; ++i)
+        dst[i] = src[i] * gain;
+}
+
+static void NEONScaleAdd(float* dst, const float* src, float gain, std::size_t n)
+{
+    /* Multiply and add separately (instead of vmlaq) to match the rounding of the scalar kernel */
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        vst1q_f32(dst + i, vaddq_f32(vld1q_f32(dst + i), vmulq_n_f32(vld1q_f32(src + i), gain)));
+
+    for (; i < n; ++i)
+        dst[i] += src[i] * gain;
+}
+
+static float NEONAbsMax(const float* src, std::size_t n)
+{
+    auto peak0 = vdupq_n_f32(0.0f);
+    auto peak1 = vdupq_n_f32(0.0f);
+
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        peak0 = vmaxq_f32(peak0, vabsq_f32(vld1q_f32(src + i    )));
+        peak1 = vmaxq_f32(peak1, vabsq_f32(vld1q_f32(src + i + 4)));
+    }
+
+    if (i + 4 <= n)
+    {
+        peak0 = vmaxq_f32(peak0, vabsq_f32(vld1q_f32(src + i)));
+        i += 4;
+    }
+
+    return std::max(vmaxvq_f32(vmaxq_f32(peak0, peak1)), ScalarAbsMax(src + i, n - i));
+}
+
+static std::size_t NEONFindFirstAbove(const float* src, std::size_t n, float threshold)
+{
+    const auto t = vdupq_n_f32(threshold);
+
+    /* Find first vector with a sample above the threshold, then find the sample itself */
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        if (vmaxvq_u32(vcgtq_f32(vabsq_f32(vld1q_f32(src + i)), t)) != 0)
+            break;
+    }
+
+    return (i + ScalarFindFirstAbove(src + i, n - i, threshold));
+}
+
+static std::size_t NEONFindLastAbove(const float* src, std::size_t n, float threshold)
+{
+    const auto t = vdupq_n_f32(threshold);
+
+    /* Find last vector with a sample above the threshold, then find the sample itself */
+    std::size_t i = n;
+    for (; i >= 4; i -= 4)
+    {
+        if (vmaxvq_u32(vcgtq_f32(vabsq_f32(vld1q_f32(src + i - 4)), t)) != 0)
+            break;
+    }
+
+    auto last = ScalarFindLastAbove(src, i, threshold);
+    return (last < i ? last : n);
+}
+
+static void NEONScaleRamp(float* data, std::size_t frames, std::uint16_t channels, float gain, float gainStep)
+{
+    if (!IsPeriodicLayout(channels, 4))
+    {
+        ScalarScaleRamp(data, frames, channels, gain, gainStep);
+        return;
+    }
+
+    /* Keep the frame index of each lane, e.g. (0, 0, 1, 1) for two channels */
+    const float laneFrames[4] =
+    {
+        static_cast<float>(0 / channels),
+        static_cast<float>(1 / channels),
+        static_cast<float>(2 / channels),
+        static_cast<float>(3 / channels),
+    };
+
+    auto frame = vld1q_f32(laneFrames);
+
+    const auto frameStep    = vdupq_n_f32(static_cast<float>(4 / channels));
+    const auto g            = vdupq_n_f32(gain);
+    const auto n            = frames * channels;
+
+    /* Multiply and add separately (instead of vmlaq) to match the rounding of the scalar kernel */
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        vst1q_f32(data + i, vmulq_f32(vld1q_f32(data + i), vaddq_f32(g, vmulq_n_f32(frame, gainStep))));
+        frame = vaddq_f32(frame, frameStep);
+    }
+
+    ScalarScaleRampTail(data, i, n, channels, gain, gainStep);
+}
+
+static void NEONFramePeaks(const float* src, std::size_t frames, std::uint16_t channels, float* peaks)
+{
+    std::size_t i = 0;
+
+    if (channels == 1)
+    {
+        for (; i + 4 <= frames; i += 4)
+            vst1q_f32(peaks + i, vabsq_f32(vld1q_f32(src + i)));
+    }
+    else if (channels == 2)
+    {
+        /* Load left and right samples of four sample frames into separate vectors */
+        for (; i + 4 <= frames; i += 4)
+        {
+            auto v = vld2q_f32(src + i*2);
+            vst1q_f32(peaks + i, vmaxq_f32(vabsq_f32(v.val[0]), vabsq_f32(v.val[1])));
+        }
+    }
+
+    ScalarFramePeaks(src + i*channels, frames - i, channels, peaks + i);
+}
+
+static void NEONScaleFrames(float* data, std::size_t frames, std::uint16_t channels, const float* gains)
+{
+    std::size_t i = 0;
+
+    if (channels == 1)
+    {
+        for (; i + 4 <= frames; i += 4)
+            vst1q_f32(data + i, vmulq_f32(vld1q_f32(data + i), vld1q_f32(gains + i)));
+    }
+    else if (channels == 2)
+    {
+        /* Duplicate the gains of four sample frames for the left and right samples */
+        for (; i + 4 <= frames; i += 4)
+        {
+            auto g = vld1q_f32(gains + i);
+            auto z = vzipq_f32(g, g);
+            vst1q_f32(data + i*2,     vmulq_f32(vld1q_f32(data + i*2    ), z.val[0]));
+            vst1q_f32(data + i*2 + 4, vmulq_f32(vld1q_f32(data + i*2 + 4), z.val[1]));
+        }
+    }
+
+    ScalarScaleFrames(data + i*channels, frames - i, channels, gains + i);
+}
+
+static void NEONCrossfadeFrames(float* dst, const float* from, const float* to, std::size_t frames, std::uint16_t channels, const float* gainsFrom, const float* gainsTo)
+{
+    std::size_t i = 0;
+
+    if (channels == 1)
+    {
+        for (; i + 4 <= frames; i += 4)
+        {
+            auto b = vmulq_f32(vld1q_f32(to + i), vld1q_f32(gainsTo + i));
+            vst1q_f32(dst + i, vmlaq_f32(b, vld1q_f32(from + i), vld1q_f32(gainsFrom + i)));
+        }
+    }
+    else if (channels == 2)
+    {
+        /* Load left and right samples of four sample frames into separate vectors */
+        for (; i + 4 <= frames; i += 4)
+        {
+            auto ga = vld1q_f32(gainsFrom + i);
+            auto gb = vld1q_f32(gainsTo   + i);
+            auto a  = vld2q_f32(from + i*2);
+            auto b  = vld2q_f32(to   + i*2);
+            a.val[0] = vmlaq_f32(vmulq_f32(b.val[0], gb), a.val[0], ga);
+            a.val[1] = vmlaq_f32(vmulq_f32(b.val[1], gb), a.val[1], ga);
+            vst2q_f32(dst + i*2, a);
+        }
+    }
+
+    ScalarCrossfadeFrames(dst + i*channels, from + i*channels, to + i*channels, frames - i, channels, gainsFrom + i, gainsTo + i);
+}
+
+static void NEONSumChannels(const float* src, std::size_t frames, std::uint16_t channels, double* sums)
+{
+    if (!IsPeriodicLayout(channels, 4))
+    {
+        ScalarSumChannels(src, frames, channels, sums);
+        return;
+    }
+
+    /* Accumulate each lane with double precision */
+    auto sumLo = vdupq_n_f64(0.0);
+    auto sumHi = vdupq_n_f64(0.0);
+
+    const auto n = frames * channels;
+
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        auto v = vld1q_f32(src + i);
+        sumLo = vaddq_f64(sumLo, vcvt_f64_f32(vget_low_f32(v)));
+        sumHi = vaddq_f64(sumHi, vcvt_high_f64_f32(v));
+    }
+
+    double lanes[4];
+    vst1q_f64(lanes, sumLo);
+    vst1q_f64(lanes + 2, sumHi);
+
+    for (std::size_t lane = 0; lane < 4; ++lane)
+        sums[lane % channels] += lanes[lane];
+
+    for (; i < n; ++i)
+        sums[i % channels] += src[i];
+}
+
+static void NEONOffsetChannels(float* data, std::size_t frames, std::uint16_t channels, const float* offsets)
+{
+    if (!IsPeriodicLayout(channels, 4))
+    {
+        ScalarOffsetChannels(data, frames, channels, offsets);
+        return;
+    }
+
+    const float laneOffsets[4] = { offsets[0 % channels], offsets[1 % channels], offsets[2 % channels], offsets[3 % channels] };
+    const auto offset = vld1q_f32(laneOffsets);
+    const auto n = frames * channels;
+
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        vst1q_f32(data + i, vaddq_f32(vld1q_f32(data + i), offset));
+
+    for (; i < n; ++i)
+        data[i] += offsets[i % channels];
+}
+
+// Reverses the array by swapping reversed vectors from both ends, and the remaining middle part element by element.
+template <typename T, typename ReverseVector>
+static void NEONReverseArray(void* data, std::size_t n, ReverseVector reverseVector)
+{
+    const std::size_t step = 16 / sizeof(T);
+
+    auto elements = reinterpret_cast<T*>(data);
+
+    std::size_t i = 0, j = n;
+    for (; i + 2*step <= j; i += step, j -= step)
+    {
+        auto front  = vld1q_u8(reinterpret_cast<const std::uint8_t*>(elements + i));
+        auto back   = vld1q_u8(reinterpret_cast<const std::uint8_t*>(elements + j - step));
+        vst1q_u8(reinterpret_cast<std::uint8_t*>(elements + i), reverseVector(back));
+        vst1q_u8(reinterpret_cast<std::uint8_t*>(elements + j - step), reverseVector(front));
+    }
+
+    std::reverse(elements + i, elements + j);
+}
+
+static uint8x16_t NEONReverseVector16(uint8x16_t v)
+{
+    auto r = vrev64q_u16(vreinterpretq_u16_u8(v));
+    return vreinterpretq_u8_u16(vcombine_u16(vget_high_u16(r), vget_low_u16(r)));
+}
+
+static uint8x16_t NEONReverseVector32(uint8x16_t v)
+{
+    auto r = vrev64q_u32(vreinterpretq_u32_u8(v));
+    return vreinterpretq_u8_u32(vcombine_u32(vget_high_u32(r), vget_low_u32(r)));
+}
+
+static uint8x16_t NEONReverseVector64(uint8x16_t v)
+{
+    return vextq_u8(v, v, 8);
+}
+
+static void NEONReverse16(void* data, std::size_t n)
+{
+    NEONReverseArray<std::uint16_t>(data, n, NEONReverseVector16);
+}
+
+static void NEONReverse32(void* data, std::size_t n)
+{
+    NEONReverseArray<std::uint32_t>(data, n, NEONReverseVector32);
+}
+
+static void NEONReverse64(void* data, std::size_t n)
+{
+    NEONReverseArray<std::uint64_t>(data, n, NEONReverseVector64);
+}
+
+#endif // /AC_SIMD_NEON
+
+
+/* ----- Kernel selection ----- */
+
+typedef float (*AbsMaxKernel)(const float* src, std::size_t n);
+typedef std::size_t (*FindAboveKernel)(const float* src, std::size_t n, float threshold);
+typedef void (*ScaleRampKernel)(float* data, std::size_t frames, std::uint16_t channels, float gain, float gainStep);
+typedef void (*FramePeaksKernel)(const float* src, std::size_t frames, std::uint16_t channels, float* peaks);
+typedef void (*ScaleFramesKernel)(float* data, std::size_t frames, std::uint16_t channels, const float* gains);
+typedef void (*CrossfadeFramesKernel)(float* dst, const float* from, const float* to, std::size_t frames, std::uint16_t channels, const float* gainsFrom, const float* gainsTo);
+typedef void (*SumChannelsKernel)(const float* src, std::size_t frames, std::uint16_t channels, double* sums);
+typedef void (*OffsetChannelsKernel)(float* data, std::size_t frames, std::uint16_t channels, const float* offsets);
+typedef void (*ReverseKernel)(void* data, std::size_t n);
+
+struct VectorKernels
+{
+    DotProductKernel        dotProduct      = ScalarDotProduct;
+    ScaleKernel             scaleCopy       = ScalarScaleCopy;
+    ScaleKernel             scaleAdd        = ScalarScaleAdd;
+    AbsMaxKernel            absMax          = ScalarAbsMax;
+    FindAboveKernel         findFirstAbove  = ScalarFindFirstAbove;
+    FindAboveKernel         findLastAbove   = ScalarFindLastAbove;
+    ScaleRampKernel         scaleRamp       = ScalarScaleRamp;
+    FramePeaksKernel        framePeaks      = ScalarFramePeaks;
+    ScaleFramesKernel       scaleFrames     = ScalarScaleFrames;
+    CrossfadeFramesKernel   crossfadeFrames = ScalarCrossfadeFrames;
+    SumChannelsKernel       sumChannels     = ScalarSumChannels;
+    OffsetChannelsKernel    offsetChannels  = ScalarOffsetChannels;
+    ReverseKernel           reverse16       = ScalarReverse<std::uint16_t>;
+    ReverseKernel           reverse32       = ScalarReverse<std::uint32_t>;
+    ReverseKernel           reverse64       = ScalarReverse<std::uint64_t>;
+};
+
+static VectorKernels SelectVectorKernels()
+{
+    VectorKernels kernels;
+
+    const auto& features = GetCPUFeatures();
+    (void)features;
+
+    #if defined(AC_SIMD_SSE2)
+    if (features.sse2)
+    {
+        kernels.dotProduct      = SSE2DotProduct;
+        kernels.scaleCopy       = SSE2ScaleCopy;
+        kernels.scaleAdd        = SSE2ScaleAdd;
+        kernels.absMax          = SSE2AbsMax;
+        kernels.findFirstAbove  = SSE2FindFirstAbove;
+        kernels.findLastAbove   = SSE2FindLastAbove;
+        kernels.scaleRamp       = SSE2ScaleRamp;
+        kernels.framePeaks      = SSE2FramePeaks;
+        kernels.scaleFrames     = SSE2ScaleFrames;
+        kernels.crossfadeFrames = SSE2CrossfadeFrames;
+        kernels.sumChannels     = SSE2SumChannels;
+        kernels.offsetChannels  = SSE2OffsetChannels;
+        kernels.reverse16       = SSE2Reverse16;
+        kernels.reverse32       = SSE2Reverse32;
+        kernels.reverse64       = SSE2Reverse64;
+    }
+    #endif
+
+    #if defined(AC_SIMD_AVX2)
+    if (features.avx2)
+    {
+        kernels.dotProduct      = AVX2DotProduct;
+        kernels.scaleCopy       = AVX2ScaleCopy;
+        kernels.scaleAdd        = AVX2ScaleAdd;
+        kernels.absMax          = AVX2AbsMax;
+        kernels.findFirstAbove  = AVX2FindFirstAbove;
+        kernels.findLastAbove   = AVX2FindLastAbove;
+        kernels.scaleRamp       = AVX2ScaleRamp;
+        kernels.framePeaks      = AVX2FramePeaks;
+        kernels.scaleFrames     = AVX2ScaleFrames;
+        kernels.crossfadeFrames = AVX2CrossfadeFrames;
+        kernels.sumChannels     = AVX2SumChannels;
+        kernels.offsetChannels  = AVX2OffsetChannels;
+        kernels.reverse16       = AVX2Reverse16;
+        kernels.reverse32       = AVX2Reverse32;
+        kernels.reverse64       = AVX2Reverse64;
+    }
+    #endif
+
+    #if defined(AC_SIMD_NEON)
+    if (features.neon)
+    {
+        kernels.dotProduct      = NEONDotProduct;
+        kernels.scaleCopy       = NEONScaleCopy;
+        kernels.scaleAdd        = NEONScaleAdd;
+        kernels.absMax          = NEONAbsMax;
+        kernels.findFirstAbove  = NEONFindFirstAbove;
+        kernels.findLastAbove   = NEONFindLastAbove;
+        kernels.scaleRamp       = NEONScaleRamp;
+        kernels.framePeaks      = NEONFramePeaks;
+        kernels.scaleFrames     = NEONScaleFrames;
+        kernels.crossfadeFrames = NEONCrossfadeFrames;
+        kernels.sumChannels     = NEONSumChannels;
+        kernels.offsetChannels  = NEONOffsetChannels;
+        kernels.reverse16       = NEONReverse16;
+        kernels.reverse32       = NEONReverse32;
+        kernels.reverse64       = NEONReverse64;
+    }
+    #endif
+
+    return kernels;
+}
+
+static const VectorKernels& GetVectorKernels()
+{
+    static const VectorKernels kernels = SelectVectorKernels();
+    return kernels;
+}
+
+
+/* ----- Global functions ----- */
+
+DotProductKernel GetDotProductKernel()
+{
+    return GetVectorKernels().dotProduct;
+}
+
+float DotProduct(const float* a, const float* b, std::size_t n)
+{
+    return GetVectorKernels().dotProduct(a, b, n);
+}
+
+ScaleKernel GetScaleCopyKernel()
+{
+    return GetVectorKernels().scaleCopy;
+}
+
+ScaleKernel GetScaleAddKernel()
+{
+    return GetVectorKernels().scaleAdd;
+}
+
+void ScaleCopy(float* dst, const float* src, float gain, std::size_t n)
+{
+    GetVectorKernels().scaleCopy(dst, src, gain, n);
+}
+
+void ScaleAdd(float* dst, const float* src, float gain, std::size_t n)
+{
+    GetVectorKernels().scaleAdd(dst, src, gain, n);
+}
+
+float AbsMax(const float* src, std::size_t n)
+{
+    return GetVectorKernels().absMax(src, n);
+}
+
+std::size_t FindFirstAbove(const float* src, std::size_t n, float threshold)
+{
+    return GetVectorKernels().findFirstAbove(src, n, threshold);
+}
+
+std::size_t FindLastAbove(const float* src, std::size_t n, float threshold)
+{
+    return GetVectorKernels().findLastAbove(src, n, threshold);
+}
+
+void ScaleRamp(float* data, std::size_t frames, std::uint16_t channels, float gain, float gainStep)
+{
+    GetVectorKernels().scaleRamp(data, frames, channels, gain, gainStep);
+}
+
+void FramePeaks(const float* src, std::size_t frames, std::uint16_t channels, float* peaks)
+{
+    GetVectorKernels().framePeaks(src, frames, channels, peaks);
+}
+
+void ScaleFrames(float* data, std::size_t frames, std::uint16_t channels, const float* gains)
+{
+    GetVectorKernels().scaleFrames(data, frames, channels, gains);
+}
+
+void CrossfadeFrames(float* dst, const float* from, const float* to, std::size_t frames, std::uint16_t channels, const float* gainsFrom, const float* gainsTo)
+{
+    GetVectorKernels().crossfadeFrames(dst, from, to, frames, channels, gainsFrom, gainsTo);
+}
+
+void SumChannels(const float* src, std::size_t frames, std::uint16_t channels, double* sums)
+{
+    GetVectorKernels().sumChannels(src, frames, channels, sums);
+}
+
+void OffsetChannels(float* data, std::size_t frames, std::uint16_t channels, const float* offsets)
+{
+    GetVectorKernels().offsetChannels(data, frames, channels, offsets);
+}
+
+void ReverseElements(void* data, std::size_t n, std::size_t size)
+{
+    const auto& kernels = GetVectorKernels();
+
+    switch (size)
+    {
+        case 1:
+            ScalarReverse<std::uint8_t>(data, n);
+            break;
+        case 2:
+            kernels.reverse16(data, n);
+            break;
+        case 4:
+            kernels.reverse32(data, n);
+            break;
+        case 8:
+            kernels.reverse64(data, n);
+            break;
+        default:
+        {
+            /* Swap elements of any other size (e.g. 24-bit sample frames) byte by byte */
+            auto bytes = reinterpret_cast<char*>(data);
+            for (std::size_t i = 0, j = n; i + 1 < j; ++i, --j)
+                std::swap_ranges(bytes + i*size, bytes + (i + 1)*size, bytes + (j - 1)*size);
+        }
+        break;
+    }
+}
+
+
+} // /namespace Ac
+
+
+
+// ================================================================================
@@ -0,0 +1,89 @@
+/*
+ * VectorKernels.h
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef AC_VECTOR_KERNELS_H
+#define AC_VECTOR_KERNELS_H
+
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace Ac
+{
+
+
+/*
+Floating-point vector kernels for the DSP inner loops.
+Like the PCM conversion kernels, they are selected once at runtime for the SIMD instruction set of the host CPU.
+*/
+
+//! Function pointer type for the dot product kernel.
+typedef float (*DotProductKernel)(const float* a, const float* b, std::size_t n);
+
+//! Returns the dot product kernel for the host CPU. Use this to avoid the selection overhead in tight loops.
+DotProductKernel GetDotProductKernel();
+
+//! Returns the dot product of the two arrays of 'n' floating-points.
+float DotProduct(const float* a, const float* b, std::size_t n);
+
+//! Function pointer type for the scaled copy ('dst = src * gain') and scaled accumulation ('dst += src * gain') kernels.
+typedef void (*ScaleKernel)(float* dst, const float* src, float gain, std::size_t n);
+
+//! Returns the scaled copy kernel for the host CPU.
+ScaleKernel GetScaleCopyKernel();
+
+//! Returns the scaled accumulation kernel for the host CPU.
+ScaleKernel GetScaleAddKernel();
+
+//! Writes the 'n' source floating-points multiplied by the gain into the destination array.
+void ScaleCopy(float* dst, const float* src, float gain, std::size_t n);
+
+//! Adds the 'n' source floating-points multiplied by the gain to the destination array.
+void ScaleAdd(float* dst, const float* src, float gain, std::size_t n);
+
+//! Returns the maximal absolute value of the 'n' floating-points, or zero if 'n' is zero.
+float AbsMax(const float* src, std::size_t n);
+
+//! Returns the index of the first of the 'n' floating-points whose absolute value is greater than the threshold, or 'n' if there is none.
+std::size_t FindFirstAbove(const float* src, std::size_t n, float threshold);
+
+//! Returns the index of the last of the 'n' floating-points whose absolute value is greater than the threshold, or 'n' if there is none.
+std::size_t FindLastAbove(const float* src, std::size_t n, float threshold);
+
+/* --- Kernels for interleaved sample frames --- */
+
+//! Multiplies the interleaved samples by a linear gain ramp. The gain of frame 'i' is 'gain + gainStep * i'.
+void ScaleRamp(float* data, std::size_t frames, std::uint16_t channels, float gain, float gainStep);
+
+//! Writes the maximal absolute sample of each interleaved sample frame into the peaks array, i.e. 'peaks' must have 'frames' elements.
+void FramePeaks(const float* src, std::size_t frames, std::uint16_t channels, float* peaks);
+
+//! Multiplies all samples of each interleaved sample frame by the respective gain, i.e. 'gains' must have 'frames' elements.
+void ScaleFrames(float* data, std::size_t frames, std::uint16_t channels, const float* gains);
+
+//! Blends two interleaved sample buffers with the gains of each sample frame, i.e. 'dst = from * gainsFrom + to * gainsTo'. 'dst' may be equal to 'from' or 'to'.
+void CrossfadeFrames(float* dst, const float* from, const float* to, std::size_t frames, std::uint16_t channels, const float* gainsFrom, const float* gainsTo);
+
+//! Adds the interleaved samples of each channel to the respective sum, i.e. 'sums' must have 'channels' elements.
+void SumChannels(const float* src, std::size_t frames, std::uint16_t channels, double* sums);
+
+//! Adds the respective offset to the interleaved samples of each channel, i.e. 'offsets' must have 'channels' elements.
+void OffsetChannels(float* data, std::size_t frames, std::uint16_t channels, const float* offsets);
+
+//! Reverses the order of 'n' elements of 'size' bytes each, e.g. sample frames.
+void ReverseElements(void* data, std::size_t n, std::size_t size);
+
+
+} // /namespace Ac
+
+
+#endif
+
+
+
+// ================================================================================
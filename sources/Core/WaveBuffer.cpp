@@ -5,56 +5,127 @@
  * See "LICENSE.txt" for license information.
  */
 
-#include "PCMData.h"
-#include "Endianness.h"
+#include "PCMConversion.h"
+#include "SampleAccess.h"
 
 #include <Ac/WaveBuffer.h>
+#include <Ac/WaveBufferView.h>
+#include <Ac/ThreadPool.h>
 #include <algorithm>
+#include <stdexcept>
 
 
 namespace Ac
 {
 
 
+// Scratch memory for sample blocks, which is allocated with the sample allocator of the wave buffer.
+using SampleBlock = std::vector<float, SampleAllocatorAdapter<float>>;
+
+
 /* ----- Common ----- */
 
+const std::size_t WaveBuffer::maxBlockSamples;
+
 WaveBuffer::WaveBuffer(const WaveBufferFormat& format) :
     format_ { format }
 {
 }
 
-WaveBuffer::WaveBuffer(WaveBuffer&& other) :
-    format_ { other.format_            },
-    buffer_ { std::move(other.buffer_) }
+WaveBuffer::WaveBuffer(const WaveBufferFormat& format, const WaveBufferStorage storage) :
+    format_  { format  },
+    storage_ { storage }
 {
 }
 
+WaveBuffer::WaveBuffer(const WaveBufferFormat& format, const WaveBufferStorage storage, SampleAllocator& allocator) :
+    format_     { format     },
+    storage_    { storage    },
+    allocator_  { &allocator }
+{
+}
+
+WaveBuffer::WaveBuffer(WaveBuffer&& other) :
+    format_         { other.format_                  },
+    storage_        { other.storage_                 },
+    buffer_         { std::move(other.buffer_)       },
+    allocator_      { other.allocator_               },
+    externalData_   { std::move(other.externalData_) },
+    externalSize_   { other.externalSize_            },
+    chunks_         { std::move(other.chunks_)       },
+    chunksSize_     { other.chunksSize_              },
+    chunkSize_      { other.chunkSize_               }
+{
+    other.externalSize_ = 0;
+    other.chunks_.clear();
+    other.chunksSize_   = 0;
+}
+
 WaveBuffer& WaveBuffer::operator = (WaveBuffer&& other)
 {
-    format_ = other.format_;
-    buffer_ = std::move(other.buffer_);
+    format_         = other.format_;
+    storage_        = other.storage_;
+    buffer_         = std::move(other.buffer_);
+    allocator_      = other.allocator_;
+    externalData_   = std::move(other.externalData_);
+    externalSize_   = other.externalSize_;
+    chunks_         = std::move(other.chunks_);
+    chunksSize_     = other.chunksSize_;
+    chunkSize_      = other.chunkSize_;
+    other.externalSize_ = 0;
+    other.chunks_.clear();
+    other.chunksSize_   = 0;
     return *this;
 }
 
 std::size_t WaveBuffer::GetSampleFrames() const
 {
-    auto blockAlign = format_.BytesPerFrame();
+    auto blockAlign = StorageBytesPerFrame();
     return (blockAlign > 0 ? BufferSize() / blockAlign : 0);
 }
 
 void WaveBuffer::SetSampleFrames(std::size_t sampleFrames)
 {
-    /* Resize buffer and initialize with 0 for signed formats and with 127 for 8-bit unsigned format */
-    auto bufferSize = sampleFrames * format_.BytesPerFrame();
-    if (format_.IsSigned())
-        buffer_.resize(bufferSize, 0);
+    if (storage_ == WaveBufferStorage::PlanarFloat)
+    {
+        /* Move each channel array to its new location (channel arrays are stored consecutively) */
+        auto prevFrames = GetSampleFrames();
+        if (prevFrames == sampleFrames)
+            return;
+
+        PCMBuffer newBuffer(sampleFrames * StorageBytesPerFrame(), 0, *allocator_);
+
+        auto src = reinterpret_cast<const float*>(static_cast<const WaveBuffer&>(*this).Data());
+        auto dst = reinterpret_cast<float*>(newBuffer.data());
+        auto len = std::min(prevFrames, sampleFrames);
+
+        for (std::uint16_t chn = 0; chn < format_.channels; ++chn)
+            std::copy(src + chn*prevFrames, src + chn*prevFrames + len, dst + chn*sampleFrames);
+
+        SetBuffer(std::move(newBuffer));
+    }
     else
-        buffer_.resize(bufferSize, 127);
+    {
+        /* Resize buffer and initialize with 0 for signed formats and with 127 for 8-bit unsigned format */
+        auto bufferSize = sampleFrames * format_.BytesPerFrame();
+        auto fillValue  = static_cast<char>(format_.IsSigned() ? 0 : 127);
+
+        if (IsShared())
+        {
+            /* Only copy the remaining part of the shared buffer */
+            PCMBuffer newBuffer(bufferSize, fillValue, *allocator_);
+            auto src = static_cast<const WaveBuffer&>(*this).Data();
+            std::copy(src, src + std::min(bufferSize, BufferSize()), newBuffer.begin());
+            SetBuffer(std::move(newBuffer));
+        }
+        else
+            GetMutableBuffer().resize(bufferSize, fillValue);
+    }
 }
 
 double WaveBuffer::GetTotalTime() const
 {
-    return format_.TotalTime(BufferSize());
+    return (format_.sampleRate > 0 ? static_cast<double>(GetSampleFrames()) / format_.sampleRate : 0.0);
 }
 
 void WaveBuffer::SetTotalTime(double duration)
@@ -65,44 +136,12 @@ void WaveBuffer::SetTotalTime(double duration)
 
 double WaveBuffer::ReadSample(std::size_t index, std::uint16_t channel) const
 {
-    double sample = 0.0;
-
-    PCMSampleConst pcmSample;
-    pcmSample.raw = Data(GetDataOffset(index, channel));
-
-    if (pcmSample.raw)
-    {
-        switch (format_.bitsPerSample)
-        {
-            case 16:
-                PCMDataToSample(sample, *pcmSample.bits16);
-                break;
-            case 8:
-                PCMDataToSample(sample, *pcmSample.bits8);
-                break;
-        }
-    }
-
-    return sample;
+    return ReadSampleData(format_, storage_, Data(GetDataOffset(index, channel)));
 }
 
 void WaveBuffer::WriteSample(std::size_t index, std::uint16_t channel, double sample)
 {
-    PCMSample pcmSample;
-    pcmSample.raw = Data(GetDataOffset(index, channel));
-
-    if (pcmSample.raw)
-    {
-        switch (format_.bitsPerSample)
-        {
-            case 16:
-                SampleToPCMData(*pcmSample.bits16, sample);
-                break;
-            case 8:
-                SampleToPCMData(*pcmSample.bits8, sample);
-                break;
-        }
-    }
+    WriteSampleData(format_, storage_, Data(GetDataOffset(index, channel)), sample);
 }
 
 double WaveBuffer::ReadSample(double timePoint, std::uint16_t channel) const
@@ -140,31 +179,81 @@ double WaveBuffer::GetTimePointFromIndex(std::size_t index) const
 }
 
 void WaveBuffer::SetFormat(const WaveBufferFormat& format)
+{
+    SetFormat(format, ResamplerQuality::Sinc);
+}
+
+void WaveBuffer::SetFormat(const WaveBufferFormat& format, const ResamplerQuality quality)
 {
     if (format_ != format)
     {
-        if (!buffer_.empty())
+        if (storage_ == WaveBufferStorage::PlanarFloat && format_.sampleRate == format.sampleRate && format_.channels == format.channels)
+        {
+            /* Planar samples are independent of the PCM format, so only the format description changes */
+            format_ = format;
+        }
+        else if (BufferSize() > 0)
         {
             /* Configure temporary buffer with new format */
-            WaveBuffer tempBuffer(format);
-            if (format_.sampleRate == format.sampleRate)
-                tempBuffer.SetSampleFrames(GetSampleFrames());
+            WaveBuffer tempBuffer(format, storage_, *allocator_);
+            tempBuffer.chunkSize_ = chunkSize_;
+
+            /* Remix channels with the standard matrix for the source and destination channel layouts */
+            std::unique_ptr<ChannelMixer> mixer;
+            if (format_.channels != format.channels && format.channels > 0)
+                mixer = std::unique_ptr<ChannelMixer>(new ChannelMixer(format_.channels, format.channels));
+
+            /* Write samples into the temporary buffer */
+            std::size_t writeIndex = 0;
+            SampleBlock dstBlock { *allocator_ };
+
+            auto WriteBlock = [&](const float* samples, std::size_t frames)
+            {
+                if (mixer)
+                {
+                    dstBlock.resize(frames * format.channels);
+                    mixer->Process(samples, frames, dstBlock.data());
+                    samples = dstBlock.data();
+                }
+                writeIndex += tempBuffer.WriteFrames(writeIndex, frames, samples);
+            };
+
+            /* Convert samples block by block with the bulk conversion kernels */
+            auto sampleFrames   = GetSampleFrames();
+            auto framesPerBlock = std::max(std::size_t(1u), WaveBuffer::maxBlockSamples / format_.channels);
+
+            SampleBlock srcBlock(framesPerBlock * format_.channels, 0.0f, *allocator_);
+
+            if (format_.sampleRate == format.sampleRate || format_.sampleRate == 0 || format.sampleRate == 0)
+            {
+                tempBuffer.SetSampleFrames(format_.sampleRate == format.sampleRate ? sampleFrames : 0);
+
+                for (std::size_t i = 0; i < sampleFrames; i += framesPerBlock)
+                {
+                    auto frames = ReadFrames(i, framesPerBlock, srcBlock.data());
+                    WriteBlock(srcBlock.data(), frames);
+                }
+            }
             else
-                tempBuffer.SetTotalTime(GetTotalTime());
+            {
+                /* Resample with the polyphase resampler */
+                Resampler resampler(format_.sampleRate, format.sampleRate, format_.channels, quality);
+                tempBuffer.SetSampleFrames(resampler.GetOutputFrames(sampleFrames));
 
-            std::uint16_t maxChannels = (format_.channels - 1);
+                std::vector<float> resampled;
 
-            /* Copy samples from current buffer to temporary buffer */
-            tempBuffer.ForEachSample(
-                [&](double& sample, std::uint16_t channel, std::size_t index, double timePoint)
+                for (std::size_t i = 0; i < sampleFrames; i += framesPerBlock)
                 {
-                    channel = std::min(channel, maxChannels);
-                    if (format_.sampleRate == format.sampleRate)
-                        sample = ReadSample(index, channel);
-                    else
-                        sample = ReadSample(timePoint, channel);
+                    auto frames = ReadFrames(i, framesPerBlock, srcBlock.data());
+                    resampled.clear();
+                    auto resampledFrames = resampler.Process(srcBlock.data(), frames, resampled);
+                    WriteBlock(resampled.data(), resampledFrames);
                 }
-            );
+
+                resampled.clear();
+                auto resampledFrames = resampler.Flush(resampled);
+                WriteBlock(resampled.data(), resampledFrames);
+            }
 
             /* Take temporary buffer as new buffer */
             *this = std::move(tempBuffer);
@@ -181,51 +270,140 @@ void WaveBuffer::SetChannels(std::uint16_t channels)
     SetFormat(format);
 }
 
-template <typename T>
-void SwapBufferEndianness(T* buffer, std::size_t n)
+void WaveBuffer::RemixChannels(const ChannelMixer& mixer)
 {
-    while (n-- > 0)
-        buffer[n] = SwapEndian(buffer[n]);
+    if (mixer.GetInputChannels() != format_.channels)
+        throw std::invalid_argument("number of input channels of channel mixer does not match the wave buffer format");
+
+    auto format = format_;
+    format.channels = mixer.GetOutputChannels();
+
+    auto sampleFrames = GetSampleFrames();
+
+    WaveBuffer tempBuffer(format, storage_, *allocator_);
+    tempBuffer.chunkSize_ = chunkSize_;
+    tempBuffer.SetSampleFrames(sampleFrames);
+
+    if (storage_ == WaveBufferStorage::PlanarFloat)
+    {
+        /* Remix channel arrays directly */
+        std::vector<const float*> inputs(format_.channels);
+        std::vector<float*> outputs(format.channels);
+
+        for (std::uint16_t chn = 0; chn < format_.channels; ++chn)
+            inputs[chn] = ChannelData(chn);
+        for (std::uint16_t chn = 0; chn < format.channels; ++chn)
+            outputs[chn] = tempBuffer.ChannelData(chn);
+
+        mixer.ProcessPlanar(inputs.data(), sampleFrames, outputs.data());
+    }
+    else
+    {
+        /* Remix PCM data block by block */
+        ChannelMixer blockMixer = mixer;
+
+        auto framesPerBlock = std::max(std::size_t(1u), WaveBuffer::maxBlockSamples / std::max(format_.channels, format.channels));
+
+        SampleBlock srcBlock(framesPerBlock * format_.channels, 0.0f, *allocator_);
+        SampleBlock dstBlock(framesPerBlock * format.channels, 0.0f, *allocator_);
+
+        for (std::size_t i = 0; i < sampleFrames; i += framesPerBlock)
+        {
+            auto frames = ReadFrames(i, framesPerBlock, srcBlock.data());
+            blockMixer.Process(srcBlock.data(), frames, dstBlock.data());
+            tempBuffer.WriteFrames(i, frames, dstBlock.data());
+        }
+    }
+
+    *this = std::move(tempBuffer);
 }
 
 void WaveBuffer::SwapEndianness()
 {
-    switch (format_.bitsPerSample)
+    /* Planar samples are always stored in native byte order */
+    if (storage_ == WaveBufferStorage::PlanarFloat)
+        return;
+
+    auto type = GetPCMType(format_);
+    SwapPCMEndianness(type, Data(), BufferSize() / std::max(std::size_t(1u), GetPCMTypeSize(type)));
+}
+
+void WaveBuffer::SetStorage(const WaveBufferStorage storage)
+{
+    if (storage_ != storage)
+    {
+        if (storage == WaveBufferStorage::PlanarFloat)
+        {
+            /* Convert PCM data into planar floating-points block by block */
+            auto sampleFrames = GetSampleFrames();
+
+            PCMBuffer newBuffer(sampleFrames * format_.channels * sizeof(float), 0, *allocator_);
+            auto planes = reinterpret_cast<float*>(newBuffer.data());
+
+            auto framesPerBlock = std::max(std::size_t(1u), WaveBuffer::maxBlockSamples / format_.channels);
+            SampleBlock block(framesPerBlock * format_.channels, 0.0f, *allocator_);
+
+            for (std::size_t i = 0; i < sampleFrames; i += framesPerBlock)
+            {
+                auto frames = ReadFrames(i, framesPerBlock, block.data());
+                WriteSampleFrames(format_, storage, reinterpret_cast<char*>(planes + i), sampleFrames, frames, block.data());
+            }
+
+            SetBuffer(std::move(newBuffer));
+            storage_ = storage;
+        }
+        else
+            *this = Interleaved();
+    }
+}
+
+WaveBuffer WaveBuffer::Interleaved() const
+{
+    if (storage_ == WaveBufferStorage::Interleaved)
+        return *this;
+
+    /* Convert planar floating-points into interleaved PCM data block by block */
+    WaveBuffer buffer(format_, WaveBufferStorage::Interleaved, *allocator_);
+    buffer.chunkSize_ = chunkSize_;
+
+    auto sampleFrames = GetSampleFrames();
+    buffer.SetSampleFrames(sampleFrames);
+
+    auto framesPerBlock = std::max(std::size_t(1u), WaveBuffer::maxBlockSamples / format_.channels);
+    SampleBlock block(framesPerBlock * format_.channels, 0.0f, *allocator_);
+
+    for (std::size_t i = 0; i < sampleFrames; i += framesPerBlock)
     {
-        case 16:
-            SwapBufferEndianness(reinterpret_cast<std::int16_t*>(buffer_.data()), buffer_.size()/2);
-            break;
+        auto frames = ReadFrames(i, framesPerBlock, block.data());
+        buffer.WriteFrames(i, frames, block.data());
     }
+
+    return buffer;
 }
 
 /* ----- Sample iteration ----- */
 
 void WaveBuffer::ForEachSample(const SampleIterationFunction& iterator, std::size_t indexBegin, std::size_t indexEnd)
 {
-    /* Validate parameters and clamp range to [0, bufferSize) */
-    auto sampleFrames = GetSampleFrames();
-    if (sampleFrames == 0 || !iterator)
+    if (!iterator)
         return;
 
-    indexBegin  = std::max(std::size_t(0u), std::min(indexBegin, sampleFrames - 1u));
-    indexEnd    = std::max(indexBegin, std::min(indexEnd, sampleFrames - 1u));
-
-    auto timePoint  = GetTimePointFromIndex(indexBegin);
-    auto timeStep   = (1.0 / static_cast<double>(format_.sampleRate));
+    const auto timeStep = (1.0 / static_cast<double>(format_.sampleRate));
 
-    for (auto i = indexBegin; i <= indexEnd; ++i)
-    {
-        for (std::uint16_t chn = 0; chn < format_.channels; ++chn)
+    ForEachBlock(
+        [&](double* samples, std::size_t frames, std::uint16_t channels, std::size_t index, std::uint32_t /*sampleRate*/)
         {
-            /* Read sample, modify sample with generator callback, and write sample back to buffer */
-            auto sample = ReadSample(i, chn);
-            iterator(sample, chn, i, timePoint);
-            WriteSample(i, chn, sample);
-        }
-
-        /* Increase time point */
-        timePoint += timeStep;
-    }
+            for (auto indexEnd = index + frames; index < indexEnd; ++index)
+            {
+                /* Modify sample with generator callback */
+                auto timePoint = static_cast<double>(index) * timeStep;
+                for (std::uint16_t chn = 0; chn < channels; ++chn)
+                    iterator(*(samples++), chn, index, timePoint);
+            }
+        },
+        indexBegin,
+        indexEnd
+    );
 }
 
 void WaveBuffer::ForEachSample(const SampleIterationFunction& iterator, double timeBegin, double timeEnd)
@@ -242,64 +420,172 @@ void WaveBuffer::ForEachSample(const SampleIterationFunction& iterator)
 
 void WaveBuffer::ForEachSample(const SampleConstIterationFunction& iterator, std::size_t indexBegin, std::size_t indexEnd) const
 {
-    /* Validate parameters and clamp range to [0, bufferSize) */
+    if (!iterator)
+        return;
+
+    const auto timeStep = (1.0 / static_cast<double>(format_.sampleRate));
+
+    ForEachBlock(
+        [&](const double* samples, std::size_t frames, std::uint16_t channels, std::size_t index, std::uint32_t /*sampleRate*/)
+        {
+            for (auto indexEnd = index + frames; index < indexEnd; ++index)
+            {
+                /* Pass sample to constant iterator */
+                auto timePoint = static_cast<double>(index) * timeStep;
+                for (std::uint16_t chn = 0; chn < channels; ++chn)
+                    iterator(*(samples++), chn, index, timePoint);
+            }
+        },
+        indexBegin,
+        indexEnd
+    );
+}
+
+void WaveBuffer::ForEachSample(const SampleConstIterationFunction& iterator, double timeBegin, double timeEnd) const
+{
+    ForEachSample(iterator, GetIndexFromTimePoint(timeBegin), GetIndexFromTimePoint(timeEnd));
+}
+
+void WaveBuffer::ForEachSample(const SampleConstIterationFunction& iterator) const
+{
     auto sampleFrames = GetSampleFrames();
-    if (sampleFrames == 0 || !iterator)
+    if (sampleFrames > 0)
+        ForEachSample(iterator, 0, sampleFrames - 1);
+}
+
+// Minimal number of sample frames per partition of the parallel sample iteration
+static const std::size_t g_parallelGrainFrames = 4096;
+
+void WaveBuffer::ParallelForEachSample(
+    const SampleIterationFunction&  iterator,
+    std::size_t                     indexBegin,
+    std::size_t                     indexEnd,
+    const SampleIteratorState       state,
+    ThreadPool*                     threadPool)
+{
+    /* Stateful iterators must see the samples in order on a single thread */
+    if (state == SampleIteratorState::Stateful)
+    {
+        ForEachSample(iterator, indexBegin, indexEnd);
         return;
+    }
 
-    indexBegin  = std::max(std::size_t(0u), std::min(indexBegin, sampleFrames - 1u));
-    indexEnd    = std::max(indexBegin, std::min(indexEnd, sampleFrames - 1u));
+    if (!iterator || !ClampIndexRange(indexBegin, indexEnd))
+        return;
 
-    auto timePoint  = GetTimePointFromIndex(indexBegin);
-    auto timeStep   = (1.0 / static_cast<double>(format_.sampleRate));
+    /* Duplicate shared samples once on this thread, so that the partitions only write into disjoint ranges of the same memory */
+    Data();
 
-    for (auto i = indexBegin; i <= indexEnd; ++i)
+    const auto timeStep = (1.0 / static_cast<double>(format_.sampleRate));
+
+    auto sampleIterator = [&](double* samples, std::size_t frames, std::uint16_t channels, std::size_t index, std::uint32_t /*sampleRate*/)
     {
-        for (std::uint16_t chn = 0; chn < format_.channels; ++chn)
+        for (auto indexEnd = index + frames; index < indexEnd; ++index)
         {
-            /* Read sample and pass to constant iterator */
-            iterator(ReadSample(i, chn), chn, i, timePoint);
+            /* Modify sample with generator callback */
+            auto timePoint = static_cast<double>(index) * timeStep;
+            for (std::uint16_t chn = 0; chn < channels; ++chn)
+                iterator(*(samples++), chn, index, timePoint);
         }
+    };
 
-        /* Increase time point */
-        timePoint += timeStep;
-    }
+    /* Iterate over each partition [begin, end) block by block */
+    auto& pool = (threadPool != nullptr ? *threadPool : GetDefaultThreadPool());
+
+    pool.ParallelFor(
+        indexBegin,
+        indexEnd + 1,
+        g_parallelGrainFrames,
+        [&](std::size_t begin, std::size_t end)
+        {
+            ForEachBlock<double>(sampleIterator, begin, end - 1);
+        }
+    );
 }
 
-void WaveBuffer::ForEachSample(const SampleConstIterationFunction& iterator, double timeBegin, double timeEnd) const
+void WaveBuffer::ParallelForEachSample(
+    const SampleIterationFunction&  iterator,
+    double                          timeBegin,
+    double                          timeEnd,
+    const SampleIteratorState       state,
+    ThreadPool*                     threadPool)
 {
-    ForEachSample(iterator, GetIndexFromTimePoint(timeBegin), GetIndexFromTimePoint(timeEnd));
+    ParallelForEachSample(iterator, GetIndexFromTimePoint(timeBegin), GetIndexFromTimePoint(timeEnd), state, threadPool);
 }
 
-void WaveBuffer::ForEachSample(const SampleConstIterationFunction& iterator) const
+void WaveBuffer::ParallelForEachSample(const SampleIterationFunction& iterator, const SampleIteratorState state, ThreadPool* threadPool)
 {
     auto sampleFrames = GetSampleFrames();
     if (sampleFrames > 0)
-        ForEachSample(iterator, 0, sampleFrames - 1);
+        ParallelForEachSample(iterator, 0, sampleFrames - 1, state, threadPool);
+}
+
+/* ----- Block iteration ----- */
+
+void WaveBuffer::ForEachBlock(const SampleBlockIterationFunction& iterator, std::size_t indexBegin, std::size_t indexEnd)
+{
+    if (iterator)
+        ForEachBlock<double>(iterator, indexBegin, indexEnd);
+}
+
+void WaveBuffer::ForEachBlock(const SampleBlockIterationFunction& iterator)
+{
+    if (iterator)
+        ForEachBlock<double>(iterator);
+}
+
+void WaveBuffer::ForEachBlock(const SampleBlockConstIterationFunction& iterator, std::size_t indexBegin, std::size_t indexEnd) const
+{
+    if (iterator)
+        ForEachBlock<double>(iterator, indexBegin, indexEnd);
+}
+
+void WaveBuffer::ForEachBlock(const SampleBlockConstIterationFunction& iterator) const
+{
+    if (iterator)
+        ForEachBlock<double>(iterator);
+}
+
+/* ----- Frame access ----- */
+
+std::size_t WaveBuffer::ReadFrames(std::size_t indexBegin, std::size_t frames, double* samples) const
+{
+    if (!chunks_.empty())
+        return ReadChunkedFrames(indexBegin, frames, samples);
+    return WaveBufferConstView(*this).ReadFrames(indexBegin, frames, samples);
+}
+
+std::size_t WaveBuffer::ReadFrames(std::size_t indexBegin, std::size_t frames, float* samples) const
+{
+    if (!chunks_.empty())
+        return ReadChunkedFrames(indexBegin, frames, samples);
+    return WaveBufferConstView(*this).ReadFrames(indexBegin, frames, samples);
+}
+
+std::size_t WaveBuffer::WriteFrames(std::size_t indexBegin, std::size_t frames, const double* samples)
+{
+    return WaveBufferView(*this).WriteFrames(indexBegin, frames, samples);
+}
+
+std::size_t WaveBuffer::WriteFrames(std::size_t indexBegin, std::size_t frames, const float* samples)
+{
+    return WaveBufferView(*this).WriteFrames(indexBegin, frames, samples);
 }
 
 /* ----- Appending ----- */
 
 void WaveBuffer::Append(const WaveBuffer& other)
 {
-    if (other.GetFormat() != GetFormat())
+    if (other.GetFormat() != GetFormat() || other.GetStorage() != GetStorage())
     {
-        /* Adapt format of new buffer (create copy) */
+        /* Adapt storage and format of new buffer (create copy) */
         auto otherCopy = other;
+        otherCopy.SetStorage(GetStorage());
         otherCopy.SetFormat(GetFormat());
-
-        /* Resize this buffer and copy new buffer into this buffer */
-        auto prevSize = buffer_.size();
-        buffer_.resize(buffer_.size() + otherCopy.buffer_.size());
-        std::copy(otherCopy.buffer_.begin(), otherCopy.buffer_.end(), &buffer_[prevSize]);
+        AppendPrimary(otherCopy);
     }
     else
-    {
-        /* Resize this buffer and copy new buffer into this buffer */
-        auto prevSize = buffer_.size();
-        buffer_.resize(buffer_.size() + other.buffer_.size());
-        std::copy(other.buffer_.begin(), other.buffer_.end(), &buffer_[prevSize]);
-    }
+        AppendPrimary(other);
 }
 
 /* ----- Copying ----- */
@@ -335,17 +621,44 @@ void WaveBuffer::CopyFrom(const WaveBuffer& source, std::size_t indexBegin, std:
     }
     else
     {
-        /* Clamp ending index again */
-        indexEnd = std::min(indexEnd, indexBegin + (srcFrames - destIndexOffset));
+        /* Clamp ending index again (the portion must fit into this buffer) */
+        indexEnd = std::min(indexEnd, indexBegin + (dstFrames - destIndexOffset));
         if (indexBegin == indexEnd)
             return;
 
-        /* Copy source buffer portion into this buffer */
-        std::copy(
-            source.Data(source.GetDataOffset(indexBegin, 0)),
-            source.Data(source.GetDataOffset(indexEnd, 0)),
-            Data(GetDataOffset(destIndexOffset, 0))
-        );
+        if (source.GetStorage() != GetStorage())
+        {
+            /* Convert source buffer portion into the storage of this buffer */
+            SampleBlock block(std::max(WaveBuffer::maxBlockSamples, std::size_t(format_.channels)), 0.0f, *allocator_);
+            auto framesPerBlock = block.size() / format_.channels;
+
+            for (auto i = indexBegin; i < indexEnd; i += framesPerBlock)
+            {
+                auto frames = source.ReadFrames(i, std::min(framesPerBlock, indexEnd - i), block.data());
+                WriteFrames(destIndexOffset + (i - indexBegin), frames, block.data());
+            }
+        }
+        else if (storage_ == WaveBufferStorage::PlanarFloat)
+        {
+            /* Copy source buffer portion into this buffer for each channel */
+            for (std::uint16_t chn = 0; chn < format_.channels; ++chn)
+            {
+                std::copy(
+                    source.ChannelData(chn) + indexBegin,
+                    source.ChannelData(chn) + indexEnd,
+                    ChannelData(chn) + destIndexOffset
+                );
+            }
+        }
+        else
+        {
+            /* Copy source buffer portion into this buffer */
+            std::copy(
+                source.Data(source.GetDataOffset(indexBegin, 0)),
+                source.Data(source.GetDataOffset(indexEnd, 0)),
+                Data(GetDataOffset(destIndexOffset, 0))
+            );
+        }
     }
 }
 
@@ -373,19 +686,320 @@ void WaveBuffer::CopyFrom(const WaveBuffer& source, double destTimeOffset)
 
 std::size_t WaveBuffer::GetDataOffset(std::size_t index, std::uint16_t channel) const
 {
+    if (channel >= format_.channels)
+        channel = 0;
+
+    /* Offset index by the respective channel array */
+    if (storage_ == WaveBufferStorage::PlanarFloat)
+        return ((channel * GetSampleFrames() + index) * sizeof(float));
+
     /* Scale index by sample block alignment and append channel offset */
-    auto channelOffset = (channel < format_.channels ? channel * format_.bitsPerSample / 8 : 0);
+    auto channelOffset = channel * format_.bitsPerSample / 8;
     return (index * format_.BytesPerFrame() + channelOffset);
 }
 
+char* WaveBuffer::Data()
+{
+    return (buffer_ || externalData_ || !chunks_.empty() ? GetMutableBuffer().data() : nullptr);
+}
+
 char* WaveBuffer::Data(std::size_t offset)
 {
-    return (offset < BufferSize() ? (&buffer_[offset]) : nullptr);
+    return (offset < BufferSize() ? Data() + offset : nullptr);
 }
 
 const char* WaveBuffer::Data(std::size_t offset) const
 {
-    return (offset < BufferSize() ? (&buffer_[offset]) : nullptr);
+    return (offset < BufferSize() ? Data() + offset : nullptr);
+}
+
+
+float* WaveBuffer::ChannelData(std::uint16_t channel)
+{
+    if (storage_ == WaveBufferStorage::PlanarFloat && channel < format_.channels)
+        return reinterpret_cast<float*>(Data()) + channel * GetSampleFrames();
+    return nullptr;
+}
+
+const float* WaveBuffer::ChannelData(std::uint16_t channel) const
+{
+    if (storage_ == WaveBufferStorage::PlanarFloat && channel < format_.channels)
+        return reinterpret_cast<const float*>(Data()) + channel * GetSampleFrames();
+    return nullptr;
+}
+
+void WaveBuffer::AttachExternalData(const WaveBufferFormat& format, const std::shared_ptr<const char>& data, std::size_t bufferSize)
+{
+    format_         = format;
+    storage_        = WaveBufferStorage::Interleaved;
+    buffer_         = nullptr;
+    chunksSize_     = 0;
+    chunks_.clear();
+    externalData_   = (bufferSize > 0 ? data : nullptr);
+    externalSize_   = (externalData_ ? bufferSize - bufferSize % std::max(std::size_t(1u), format.BytesPerFrame()) : 0);
+}
+
+void WaveBuffer::SetAllocator(SampleAllocator& allocator)
+{
+    if (allocator_ != &allocator)
+    {
+        allocator_ = &allocator;
+
+        /* Move samples into memory of the new allocator */
+        if (!chunks_.empty())
+            FlattenChunks();
+        else if (buffer_)
+            SetBuffer(PCMBuffer(*buffer_, allocator));
+    }
+}
+
+/* ----- Chunked storage ----- */
+
+void WaveBuffer::SetChunkSize(std::size_t chunkSize)
+{
+    /* Round chunk size up to a multiple of the frame size, so that each chunk contains whole sample frames */
+    auto frameSize = std::max(std::size_t(1u), format_.BytesPerFrame());
+    chunkSize_ = (chunkSize + frameSize - 1) / frameSize * frameSize;
+}
+
+std::size_t WaveBuffer::GetNumChunks() const
+{
+    return (chunks_.size() + (TailSize() > 0 ? 1 : 0));
+}
+
+WaveBufferConstView WaveBuffer::GetChunk(std::size_t index) const
+{
+    if (chunks_.empty())
+        return (index == 0 && BufferSize() > 0 ? WaveBufferConstView(*this) : WaveBufferConstView());
+
+    const auto frameSize = format_.BytesPerFrame();
+
+    if (index < chunks_.size())
+        return WaveBufferConstView(format_, chunks_[index].data.get(), chunks_[index].size / frameSize);
+
+    /* Return view onto the tail without flattening the chunks */
+    if (index == chunks_.size() && TailSize() > 0)
+        return WaveBufferConstView(format_, (buffer_ ? buffer_->data() : externalData_.get()), TailSize() / frameSize);
+
+    return WaveBufferConstView();
+}
+
+void WaveBuffer::Flatten()
+{
+    if (!chunks_.empty())
+        FlattenChunks();
+}
+
+
+/*
+ * ======= Private: =======
+ */
+
+bool WaveBuffer::ClampIndexRange(std::size_t& indexBegin, std::size_t& indexEnd) const
+{
+    /* Clamp range to [0, sampleFrames) */
+    auto sampleFrames = GetSampleFrames();
+    if (sampleFrames == 0)
+        return false;
+
+    indexBegin  = std::min(indexBegin, sampleFrames - 1u);
+    indexEnd    = std::max(indexBegin, std::min(indexEnd, sampleFrames - 1u));
+
+    return true;
+}
+
+std::size_t WaveBuffer::StorageBytesPerFrame() const
+{
+    if (storage_ == WaveBufferStorage::PlanarFloat)
+        return (format_.channels * sizeof(float));
+    else
+        return format_.BytesPerFrame();
+}
+
+void WaveBuffer::AppendPrimary(const WaveBuffer& other)
+{
+    if (chunkSize_ > 0 && storage_ == WaveBufferStorage::Interleaved)
+    {
+        /* Append new buffer to the chunks without touching the previous samples */
+        AppendChunks(other);
+    }
+    else if (storage_ == WaveBufferStorage::PlanarFloat)
+    {
+        /* Resize this buffer and copy each channel array of the new buffer into this buffer */
+        auto prevFrames = GetSampleFrames();
+        auto addFrames  = other.GetSampleFrames();
+
+        SetSampleFrames(prevFrames + addFrames);
+
+        for (std::uint16_t chn = 0; chn < format_.channels; ++chn)
+            std::copy(other.ChannelData(chn), other.ChannelData(chn) + addFrames, ChannelData(chn) + prevFrames);
+    }
+    else
+    {
+        /* Resize this buffer and copy new buffer into this buffer (hold a reference in case 'other' is this buffer) */
+        auto source         = other.buffer_;
+        auto sourceExternal = other.externalData_;
+        auto sourceData     = other.Data();
+        auto sourceSize     = other.BufferSize();
+
+        if (sourceSize == 0)
+            return;
+
+        auto& buffer = GetMutableBuffer();
+        auto prevSize = buffer.size();
+
+        buffer.resize(prevSize + sourceSize);
+        std::copy(sourceData, sourceData + sourceSize, buffer.begin() + prevSize);
+    }
+}
+
+PCMBuffer& WaveBuffer::GetMutableBuffer()
+{
+    if (!chunks_.empty())
+        FlattenChunks();
+
+    if (externalData_)
+        SetBuffer(PCMBuffer(externalData_.get(), externalData_.get() + externalSize_, *allocator_));
+    else if (!buffer_)
+        SetBuffer(PCMBuffer(*allocator_));
+    else if (buffer_.use_count() > 1)
+        SetBuffer(PCMBuffer(*buffer_, *allocator_));
+    return *buffer_;
+}
+
+void WaveBuffer::SetBuffer(PCMBuffer&& buffer)
+{
+    chunks_.clear();
+    chunksSize_ = 0;
+    SetTailBuffer(std::move(buffer));
+}
+
+void WaveBuffer::SetTailBuffer(PCMBuffer&& buffer) const
+{
+    /* Allocate the shared state together with the buffer object from the sample allocator */
+    buffer_ = std::allocate_shared<PCMBuffer>(SampleAllocatorAdapter<PCMBuffer>(*allocator_), std::move(buffer));
+    externalData_.reset();
+    externalSize_ = 0;
+}
+
+void WaveBuffer::AppendChunks(const WaveBuffer& other)
+{
+    /* Hold references to all chunks of the new buffer (in case 'other' is this buffer) */
+    for (const auto& chunk : other.GetAllChunks())
+    {
+        if (chunk.size >= chunkSize_)
+        {
+            /* Share large chunks without copying */
+            SealTail();
+            chunks_.push_back({ chunk.data, chunksSize_, chunk.size });
+            chunksSize_ += chunk.size;
+        }
+        else
+            AppendToTail(chunk.data.get(), chunk.size);
+    }
+}
+
+void WaveBuffer::AppendToTail(const char* data, std::size_t size)
+{
+    /* Seal tail if it's read-only or shared, or if it has not enough capacity left */
+    if (externalData_ || (buffer_ && (buffer_.use_count() > 1 || buffer_->size() + size > std::max(chunkSize_, buffer_->capacity()))))
+        SealTail();
+
+    if (!buffer_)
+    {
+        /* Start new tail with the capacity of an entire chunk */
+        PCMBuffer tail(*allocator_);
+        tail.reserve(std::max(chunkSize_, size));
+        SetTailBuffer(std::move(tail));
+    }
+
+    buffer_->insert(buffer_->end(), data, data + size);
+}
+
+void WaveBuffer::SealTail()
+{
+    auto size = TailSize();
+    if (size > 0)
+    {
+        /* Refer to the tail with an aliasing pointer, which keeps the entire PCM buffer (or the external data) alive */
+        std::shared_ptr<const char> data;
+        if (buffer_)
+            data = std::shared_ptr<const char>(buffer_, buffer_->data());
+        else
+            data = externalData_;
+
+        chunks_.push_back({ std::move(data), chunksSize_, size });
+        chunksSize_ += size;
+    }
+
+    buffer_.reset();
+    externalData_.reset();
+    externalSize_ = 0;
+}
+
+std::vector<WaveBuffer::PCMChunk> WaveBuffer::GetAllChunks() const
+{
+    auto chunks = chunks_;
+
+    if (buffer_ && !buffer_->empty())
+        chunks.push_back({ std::shared_ptr<const char>(buffer_, buffer_->data()), chunksSize_, buffer_->size() });
+    else if (externalData_ && externalSize_ > 0)
+        chunks.push_back({ externalData_, chunksSize_, externalSize_ });
+
+    return chunks;
+}
+
+void WaveBuffer::FlattenChunks() const
+{
+    /* Copy all chunks into a single PCM buffer */
+    PCMBuffer buffer(*allocator_);
+    buffer.reserve(BufferSize());
+
+    for (const auto& chunk : GetAllChunks())
+        buffer.insert(buffer.end(), chunk.data.get(), chunk.data.get() + chunk.size);
+
+    chunks_.clear();
+    chunksSize_ = 0;
+    SetTailBuffer(std::move(buffer));
+}
+
+template <typename T>
+std::size_t WaveBuffer::ReadChunkedFrames(std::size_t indexBegin, std::size_t frames, T* samples) const
+{
+    const auto frameSize    = format_.BytesPerFrame();
+    const auto sampleFrames = GetSampleFrames();
+
+    if (indexBegin >= sampleFrames)
+        return 0;
+
+    frames = std::min(frames, sampleFrames - indexBegin);
+
+    /* Find first chunk which contains the beginning of the range (the tail has the index 'chunks_.size()') */
+    auto offset = indexBegin * frameSize;
+
+    auto it = std::upper_bound(
+        chunks_.begin(), chunks_.end(), offset,
+        [](std::size_t offset, const PCMChunk& chunk)
+        {
+            return (offset < chunk.offset);
+        }
+    );
+
+    /* Read sample frames from each chunk the range spans */
+    std::size_t framesRead = 0;
+
+    auto first = (offset < chunksSize_ ? static_cast<std::size_t>(it - chunks_.begin()) - 1 : chunks_.size());
+
+    for (auto i = first; framesRead < frames && i <= chunks_.size(); ++i)
+    {
+        auto chunk = GetChunk(i);
+        auto chunkOffset = (i < chunks_.size() ? chunks_[i].offset : chunksSize_);
+        auto n = chunk.ReadFrames((offset - chunkOffset) / frameSize, frames - framesRead, samples + framesRead * format_.channels);
+        framesRead  += n;
+        offset      += n * frameSize;
+    }
+
+    return framesRead;
 }
 
 
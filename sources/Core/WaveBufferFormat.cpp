@@ -12,10 +12,11 @@ namespace Ac
 {
 
 
-WaveBufferFormat::WaveBufferFormat(std::uint32_t sampleRate, std::uint16_t bitsPerSample, std::uint16_t channels) :
+WaveBufferFormat::WaveBufferFormat(std::uint32_t sampleRate, std::uint16_t bitsPerSample, std::uint16_t channels, bool floatingPoint) :
     sampleRate    { sampleRate    },
     bitsPerSample { bitsPerSample },
-    channels      { channels      }
+    channels      { channels      },
+    floatingPoint { floatingPoint }
 {
 }
 
@@ -37,7 +38,15 @@ double WaveBufferFormat::TotalTime(std::size_t bufferSize) const
 
 bool WaveBufferFormat::IsSigned() const
 {
-    return (bitsPerSample > 8);
+    return (bitsPerSample > 8 || floatingPoint);
+}
+
+bool WaveBufferFormat::IsSupported() const
+{
+    if (floatingPoint)
+        return (bitsPerSample == 32);
+    else
+        return (bitsPerSample == 8 || bitsPerSample == 16 || bitsPerSample == 24 || bitsPerSample == 32);
 }
 
 
@@ -46,7 +55,8 @@ AC_EXPORT bool operator == (const WaveBufferFormat& lhs, const WaveBufferFormat&
     return
         ( lhs.sampleRate    == rhs.sampleRate    ) &&
         ( lhs.bitsPerSample == rhs.bitsPerSample ) &&
-        ( lhs.channels      == rhs.channels      );
+        ( lhs.channels      == rhs.channels      ) &&
+        ( lhs.floatingPoint == rhs.floatingPoint );
 }
 
 AC_EXPORT bool operator != (const WaveBufferFormat& lhs, const WaveBufferFormat& rhs)
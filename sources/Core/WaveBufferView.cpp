@@ -0,0 +1,224 @@
+/*
+ * WaveBufferView.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include <Ac/WaveBufferView.h>
+#include "SampleAccess.h"
+
+#include <algorithm>
+
+
+namespace Ac
+{
+
+
+/* ----- WaveBufferConstView class ----- */
+
+WaveBufferConstView::WaveBufferConstView(const WaveBuffer& buffer) :
+    format_         { buffer.GetFormat()        },
+    storage_        { buffer.GetStorage()       },
+    data_           { buffer.Data()             },
+    frames_         { buffer.GetSampleFrames()  },
+    planeStride_    { frames_                   }
+{
+}
+
+WaveBufferConstView::WaveBufferConstView(const WaveBuffer& buffer, std::size_t indexBegin, std::size_t frames) :
+    WaveBufferConstView { buffer }
+{
+    Narrow(indexBegin, frames);
+}
+
+WaveBufferConstView::WaveBufferConstView(const WaveBufferFormat& format, const void* data, std::size_t frames) :
+    format_ { format                                },
+    data_   { reinterpret_cast<const char*>(data)   },
+    frames_ { (data != nullptr ? frames : 0)        }
+{
+}
+
+double WaveBufferConstView::GetTotalTime() const
+{
+    return (format_.sampleRate > 0 ? static_cast<double>(frames_) / format_.sampleRate : 0.0);
+}
+
+std::size_t WaveBufferConstView::GetIndexFromTimePoint(double timePoint) const
+{
+    /* Clamp time point to range [0, GetTotalTime()) */
+    if (frames_ > 0)
+    {
+        timePoint   = std::max(0.0, std::min(timePoint, GetTotalTime()));
+        auto index  = (static_cast<std::size_t>(timePoint * static_cast<double>(format_.sampleRate)));
+        return std::min(index, frames_ - 1);
+    }
+    return 0;
+}
+
+double WaveBufferConstView::ReadSample(std::size_t index, std::uint16_t channel) const
+{
+    if (index < frames_ && channel < format_.channels)
+        return ReadSampleData(format_, storage_, data_ + GetDataOffset(index, channel));
+    return 0.0;
+}
+
+std::size_t WaveBufferConstView::ReadFrames(std::size_t indexBegin, std::size_t frames, double* samples) const
+{
+    if (!ClampFrameRange(indexBegin, frames))
+        return 0;
+    ReadSampleFrames(format_, storage_, data_ + GetDataOffset(indexBegin, 0), planeStride_, frames, samples);
+    return frames;
+}
+
+std::size_t WaveBufferConstView::ReadFrames(std::size_t indexBegin, std::size_t frames, float* samples) const
+{
+    if (!ClampFrameRange(indexBegin, frames))
+        return 0;
+    ReadSampleFrames(format_, storage_, data_ + GetDataOffset(indexBegin, 0), planeStride_, frames, samples);
+    return frames;
+}
+
+WaveBufferConstView WaveBufferConstView::Subview(std::size_t indexBegin, std::size_t frames) const
+{
+    auto view = *this;
+    view.Narrow(indexBegin, frames);
+    return view;
+}
+
+WaveBuffer WaveBufferConstView::ToWaveBuffer() const
+{
+    WaveBuffer buffer(format_, storage_);
+    buffer.SetSampleFrames(frames_);
+
+    if (frames_ > 0)
+    {
+        if (storage_ == WaveBufferStorage::PlanarFloat)
+        {
+            /* Copy each channel array */
+            for (std::uint16_t chn = 0; chn < format_.channels; ++chn)
+                std::copy(ChannelData(chn), ChannelData(chn) + frames_, buffer.ChannelData(chn));
+        }
+        else
+        {
+            /* Copy contiguous PCM data */
+            std::copy(data_, data_ + BufferSize(), buffer.Data());
+        }
+    }
+
+    return buffer;
+}
+
+std::size_t WaveBufferConstView::BufferSize() const
+{
+    if (storage_ == WaveBufferStorage::PlanarFloat)
+        return (frames_ * format_.channels * sizeof(float));
+    else
+        return (frames_ * format_.BytesPerFrame());
+}
+
+const float* WaveBufferConstView::ChannelData(std::uint16_t channel) const
+{
+    if (storage_ == WaveBufferStorage::PlanarFloat && channel < format_.channels && data_ != nullptr)
+        return reinterpret_cast<const float*>(data_) + channel * planeStride_;
+    return nullptr;
+}
+
+
+/*
+ * ======= Protected: =======
+ */
+
+std::size_t WaveBufferConstView::GetDataOffset(std::size_t index, std::uint16_t channel) const
+{
+    /* Offset index by the respective channel array */
+    if (storage_ == WaveBufferStorage::PlanarFloat)
+        return ((channel * planeStride_ + index) * sizeof(float));
+
+    /* Scale index by sample block alignment and append channel offset */
+    auto channelOffset = channel * format_.bitsPerSample / 8;
+    return (index * format_.BytesPerFrame() + channelOffset);
+}
+
+bool WaveBufferConstView::ClampFrameRange(std::size_t indexBegin, std::size_t& frames) const
+{
+    if (indexBegin >= frames_ || data_ == nullptr)
+        return false;
+    frames = std::min(frames, frames_ - indexBegin);
+    return true;
+}
+
+void WaveBufferConstView::Narrow(std::size_t indexBegin, std::size_t frames)
+{
+    indexBegin = std::min(indexBegin, frames_);
+    frames = std::min(frames, frames_ - indexBegin);
+
+    if (data_ != nullptr)
+        data_ += GetDataOffset(indexBegin, 0);
+
+    frames_ = frames;
+}
+
+
+/* ----- WaveBufferView class ----- */
+
+WaveBufferView::WaveBufferView(WaveBuffer& buffer)
+{
+    format_         = buffer.GetFormat();
+    storage_        = buffer.GetStorage();
+    data_           = buffer.Data();
+    frames_         = buffer.GetSampleFrames();
+    planeStride_    = frames_;
+}
+
+WaveBufferView::WaveBufferView(WaveBuffer& buffer, std::size_t indexBegin, std::size_t frames) :
+    WaveBufferView { buffer }
+{
+    Narrow(indexBegin, frames);
+}
+
+WaveBufferView::WaveBufferView(const WaveBufferFormat& format, void* data, std::size_t frames) :
+    WaveBufferConstView { format, data, frames }
+{
+}
+
+void WaveBufferView::WriteSample(std::size_t index, std::uint16_t channel, double sample) const
+{
+    if (index < frames_ && channel < format_.channels)
+        WriteSampleData(format_, storage_, Data() + GetDataOffset(index, channel), sample);
+}
+
+std::size_t WaveBufferView::WriteFrames(std::size_t indexBegin, std::size_t frames, const double* samples) const
+{
+    if (!ClampFrameRange(indexBegin, frames))
+        return 0;
+    WriteSampleFrames(format_, storage_, Data() + GetDataOffset(indexBegin, 0), planeStride_, frames, samples);
+    return frames;
+}
+
+std::size_t WaveBufferView::WriteFrames(std::size_t indexBegin, std::size_t frames, const float* samples) const
+{
+    if (!ClampFrameRange(indexBegin, frames))
+        return 0;
+    WriteSampleFrames(format_, storage_, Data() + GetDataOffset(indexBegin, 0), planeStride_, frames, samples);
+    return frames;
+}
+
+WaveBufferView WaveBufferView::Subview(std::size_t indexBegin, std::size_t frames) const
+{
+    auto view = *this;
+    view.Narrow(indexBegin, frames);
+    return view;
+}
+
+float* WaveBufferView::ChannelData(std::uint16_t channel) const
+{
+    return const_cast<float*>(WaveBufferConstView::ChannelData(channel));
+}
+
+
+} // /namespace Ac
+
+
+
+// ================================================================================
@@ -81,13 +81,16 @@ static std::string AIFCReadPString(std::istream& stream)
     return s;
 }
 
-static void AIFCReadCommonChunk(std::istream& stream, AIFCCommonChunk& chunk)
+static void AIFCReadCommonChunk(std::istream& stream, AIFCCommonChunk& chunk, bool& floatingPoint)
 {
     Read(stream, chunk);
 
     auto compressionName = AIFCReadPString(stream);
 
-    if (chunk.compressionType != UINT32_FROM_STRING("NONE"))
+    /* Uncompressed 32-bit floating-points are specified with compression type 'fl32' (or 'FL32') */
+    if (chunk.compressionType == UINT32_FROM_STRING("fl32") || chunk.compressionType == UINT32_FROM_STRING("FL32"))
+        floatingPoint = true;
+    else if (chunk.compressionType != UINT32_FROM_STRING("NONE"))
     {
         throw std::runtime_error(
             "unsupported compression type '" + GetStrinFromUINT32(chunk.compressionType) +
@@ -121,8 +124,9 @@ void AIFFReader::ReadWaveBuffer(std::istream& stream, WaveBuffer& buffer)
     AIFFReadCommonChunk(stream, commChunk);
 
     AIFCCommonChunk commChunkEx;
+    bool floatingPoint = false;
     if (header.formType == UINT32_FROM_STRING("AIFC"))
-        AIFCReadCommonChunk(stream, commChunkEx);
+        AIFCReadCommonChunk(stream, commChunkEx, floatingPoint);
 
     /* Read SSND chunk */
     AIFFChunk ssndChunkHdr;
@@ -131,6 +135,9 @@ void AIFFReader::ReadWaveBuffer(std::istream& stream, WaveBuffer& buffer)
     AIFFSoundChunk ssndChunk;
     AIFFReadSoundChunk(stream, ssndChunk);
 
+    if (ssndChunk.offset > 0)
+        stream.seekg(ssndChunk.offset, std::ios_base::cur);
+
     /* Read sound data */
     auto sampleRate = static_cast<std::uint32_t>(ReadFloat80(commChunk.sampleRate));
     auto soundDataSize = commChunk.sampleFrames * commChunk.channels * commChunk.bitsPerSample / 8;
@@ -139,9 +146,14 @@ void AIFFReader::ReadWaveBuffer(std::istream& stream, WaveBuffer& buffer)
     {
         sampleRate,
         static_cast<std::uint16_t>(commChunk.bitsPerSample),
-        static_cast<std::uint16_t>(commChunk.channels)
+        static_cast<std::uint16_t>(commChunk.channels),
+        floatingPoint
     };
 
+    if (!format.IsSupported())
+        throw std::runtime_error("unsupported sample format (" + std::to_string(commChunk.bitsPerSample) + " bits per sample) in AIFF/AIFF-C stream");
+
+    buffer.SetStorage(WaveBufferStorage::Interleaved);
     buffer.SetFormat(format);
     buffer.SetSampleFrames(commChunk.sampleFrames);
 
@@ -150,7 +162,15 @@ void AIFFReader::ReadWaveBuffer(std::istream& stream, WaveBuffer& buffer)
 
     stream.read(buffer.Data(), buffer.BufferSize());
 
-    buffer.SwapEndianness();
+    /* Convert big-endian samples, and signed 8-bit samples into unsigned 8-bit samples */
+    if (format.bitsPerSample == 8)
+    {
+        auto data = reinterpret_cast<std::uint8_t*>(buffer.Data());
+        for (std::size_t i = 0, n = buffer.BufferSize(); i < n; ++i)
+            data[i] ^= 0x80;
+    }
+    else
+        buffer.SwapEndianness();
 }
 
 
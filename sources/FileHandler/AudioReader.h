@@ -12,12 +12,21 @@
 #include <Ac/WaveBuffer.h>
 #include <Ac/Export.h>
 #include <istream>
+#include <cstdint>
 
 
 namespace Ac
 {
 
 
+//! Location of the PCM payload within an audio file.
+struct AudioPCMPayload
+{
+    WaveBufferFormat    format;
+    std::uint64_t       offset  = 0;    //!< Byte offset of the first sample frame from the beginning of the file.
+    std::uint64_t       size    = 0;    //!< Size (in bytes) of the PCM payload.
+};
+
 //! Audio reader interface.
 class AC_EXPORT AudioReader
 {
@@ -36,6 +45,19 @@ class AC_EXPORT AudioReader
         */
         virtual void ReadWaveBuffer(std::istream& stream, WaveBuffer& waveBuffer) = 0;
 
+        /**
+        \brief Reads the header from the specified stream and determines the location of the PCM payload.
+        \param[in,out] stream Specifies the input stream to read from.
+        \param[out] payload Specifies the output location of the PCM payload.
+        \return True if the PCM payload is stored exactly like the interleaved wave buffer storage (e.g. in native byte order),
+        i.e. the file can be mapped into memory without any conversion. By default false.
+        \throws std::runtime_exception If something went wrong while reading.
+        */
+        virtual bool ReadPCMPayload(std::istream& /*stream*/, AudioPCMPayload& /*payload*/)
+        {
+            return false;
+        }
+
 };
 
 
@@ -9,7 +9,7 @@
 #define AC_AUDIO_WRITER_H
 
 
-#include <Ac/WaveBuffer.h>
+#include <Ac/WaveBufferView.h>
 #include <Ac/Export.h>
 #include <ostream>
 
@@ -31,10 +31,20 @@ class AC_EXPORT AudioWriter
         /**
         \brief Writes the audio data to the specified stream.
         \param[in,out] stream Specifies the output stream to write to.
-        \param[in] buffer Specifies the input wave buffer.
+        \param[in] waveBuffer Specifies the input wave buffer or a view onto a range of sample frames.
         \throws std::runtime_exception If something went wrong while writing.
         */
-        virtual void WriteWaveBuffer(std::ostream& stream, const WaveBuffer& waveBuffer) = 0;
+        virtual void WriteWaveBuffer(std::ostream& stream, const WaveBufferConstView& waveBuffer) = 0;
+
+        /**
+        \brief Writes the audio data of the specified wave buffer to the stream.
+        \remarks The default implementation writes a view onto the entire wave buffer, i.e. the chunks of the wave buffer are flattened first.
+        \see WaveBuffer::SetChunkSize
+        */
+        virtual void WriteWaveBuffer(std::ostream& stream, const WaveBuffer& waveBuffer)
+        {
+            WriteWaveBuffer(stream, WaveBufferConstView(waveBuffer));
+        }
 
 };
 
@@ -10,6 +10,7 @@
 #include "FormatAuxiliary.h"
 #include "../Core/Endianness.h"
 #include <algorithm>
+#include <stdexcept>
 
 #include <iostream>//FOR DEBUGGING!!!
 
@@ -73,10 +74,11 @@ MODStream::~MODStream()
 {
 }
 
-std::size_t MODStream::StreamWaveBuffer(WaveBuffer& buffer)
+std::size_t MODStream::StreamWaveBuffer(const WaveBufferView& buffer)
 {
-    /* Setup buffer format */
-    buffer.SetFormat(GetFormat());
+    /* Validate buffer storage and format */
+    if (buffer.GetStorage() != WaveBufferStorage::Interleaved || buffer.GetFormat() != GetFormat())
+        throw std::invalid_argument("storage or format of wave buffer view does not match the MOD stream");
 
     /* Read next data chunk */
     std::size_t bytes = 0;
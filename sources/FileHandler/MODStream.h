@@ -25,7 +25,9 @@ class AC_EXPORT MODStream : public AudioStream
         MODStream(std::unique_ptr<std::istream>&& stream);
         ~MODStream();
 
-        std::size_t StreamWaveBuffer(WaveBuffer& buffer) override;
+        using AudioStream::StreamWaveBuffer;
+
+        std::size_t StreamWaveBuffer(const WaveBufferView& buffer) override;
 
         void Seek(double timePoint) override;
 
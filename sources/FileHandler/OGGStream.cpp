@@ -8,6 +8,7 @@
 #ifdef AC_PLUGIN_OGGVORBIS
 
 #include "OGGStream.h"
+#include <stdexcept>
 
 
 namespace Ac
@@ -134,10 +135,11 @@ OGGStream::~OGGStream()
     ov_clear(&file_);
 }
 
-std::size_t OGGStream::StreamWaveBuffer(WaveBuffer& buffer)
+std::size_t OGGStream::StreamWaveBuffer(const WaveBufferView& buffer)
 {
-    /* Setup buffer format */
-    buffer.SetFormat(GetFormat());
+    /* Validate buffer storage and format (samples are decoded directly into the referenced memory) */
+    if (buffer.GetStorage() != WaveBufferStorage::Interleaved || buffer.GetFormat() != GetFormat())
+        throw std::invalid_argument("storage or format of wave buffer view does not match the OGG stream");
 
     /* Read next data chunk */
     std::size_t bytes = 0;
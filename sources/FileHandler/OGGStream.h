@@ -28,7 +28,9 @@ class AC_EXPORT OGGStream : public AudioStream
         OGGStream(std::unique_ptr<std::istream>&& stream);
         ~OGGStream();
 
-        std::size_t StreamWaveBuffer(WaveBuffer& buffer) override;
+        using AudioStream::StreamWaveBuffer;
+
+        std::size_t StreamWaveBuffer(const WaveBufferView& buffer) override;
 
         void Seek(double timePoint) override;
 
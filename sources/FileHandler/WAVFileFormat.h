@@ -29,6 +29,17 @@ struct RIFFWAVEFormat
 }
 AC_PACK_STRUCT;
 
+//! Extension of the RIFF WAVE format for the format tag RIFFWAVEFormatTags::Extensible.
+struct RIFFWAVEFormatExtension
+{
+    std::uint16_t extensionSize;        //!< Size of the extension (in bytes). Must be at least 22.
+    std::uint16_t validBitsPerSample;   //!< Number of valid bits per sample (at most 'bitsPerSample').
+    std::uint32_t channelMask;          //!< Bit mask of the speaker positions of the channels.
+    std::uint16_t subFormatTag;         //!< Actual encoding format tag (first two bytes of the sub format GUID).
+    std::uint8_t  subFormatGUID[14];    //!< Remaining bytes of the sub format GUID.
+}
+AC_PACK_STRUCT;
+
 struct RIFFWAVEChunk
 {
     std::uint32_t id;   //!< Chunk ID (either 'fmt ' or 'data').
@@ -8,6 +8,7 @@
 #include "WAVReader.h"
 #include "WAVFileFormat.h"
 #include "WAVFormatTags.h"
+#include "../Core/Endianness.h"
 #include <sstream>
 
 
@@ -15,9 +16,9 @@ namespace Ac
 {
 
 
-static WaveBufferFormat GetBufferFormat(const RIFFWAVEFormat& fmt)
+static WaveBufferFormat GetBufferFormat(const RIFFWAVEFormat& fmt, std::uint16_t formatTag)
 {
-    return WaveBufferFormat(fmt.sampleRate, fmt.bitsPerSample, fmt.channels);
+    return WaveBufferFormat(fmt.sampleRate, fmt.bitsPerSample, fmt.channels, (formatTag == RIFFWAVEFormatTags::IEEE_FLOAT));
 }
 
 static void WAVReadHeader(std::istream& stream, std::uint32_t& fileSize)
@@ -86,7 +87,7 @@ RIFF WAVE format chunk (for RIFF tags see details).
 \see http://de.wikipedia.org/wiki/RIFF_WAVE
 \see http://www.sno.phy.queensu.ca/~phil/exiftool/TagNames/RIFF.html
 */
-static void WAVReadChunks(std::istream& stream, std::streamoff streamSize, WaveBuffer& waveBuffer)
+static WaveBufferFormat WAVReadFormatChunk(std::istream& stream, std::streamoff streamSize)
 {
     /* Read "fmt " chunk */
     auto chunkFMT = WAVFindChunk(stream, streamSize, "fmt ");
@@ -98,18 +99,45 @@ static void WAVReadChunks(std::istream& stream, std::streamoff streamSize, WaveB
     if (chunkFMT.size < 16)
         throw std::runtime_error("invalid length in RIFF WAVE format chunk");
 
-    if (format.formatTag != RIFFWAVEFormatTags::PCM)
+    /* Take actual format tag from the extension of extensible formats */
+    std::uint16_t formatTag = format.formatTag;
+
+    if (formatTag == RIFFWAVEFormatTags::Extensible)
+    {
+        if (chunkFMT.size < sizeof(RIFFWAVEFormat) + sizeof(RIFFWAVEFormatExtension))
+            throw std::runtime_error("invalid length in extensible RIFF WAVE format chunk");
+
+        RIFFWAVEFormatExtension formatExt;
+        Read(stream, formatExt);
+
+        formatTag = formatExt.subFormatTag;
+    }
+
+    if (formatTag != RIFFWAVEFormatTags::PCM && formatTag != RIFFWAVEFormatTags::IEEE_FLOAT)
     {
         std::stringstream s;
-        s << "unsupported RIFF WAVE format tag (0x" << std::hex << format.formatTag << ")";
+        s << "unsupported RIFF WAVE format tag (0x" << std::hex << formatTag << ")";
         throw std::runtime_error(s.str());
     }
 
+    auto bufferFormat = GetBufferFormat(format, formatTag);
+    if (!bufferFormat.IsSupported())
+        throw std::runtime_error("unsupported sample format in RIFF WAVE stream (" + std::to_string(format.bitsPerSample) + " bits per sample)");
+
+    return bufferFormat;
+}
+
+static void WAVReadChunks(std::istream& stream, std::streamoff streamSize, WaveBuffer& waveBuffer)
+{
+    /* Read "fmt " chunk */
+    auto bufferFormat = WAVReadFormatChunk(stream, streamSize);
+
     /* Read "data" chunk */
     auto chunkDATA = WAVFindChunk(stream, streamSize, "data");
 
     /* Read PCM data */
-    waveBuffer.SetFormat(GetBufferFormat(format));
+    waveBuffer.SetStorage(WaveBufferStorage::Interleaved);
+    waveBuffer.SetFormat(bufferFormat);
     waveBuffer.SetSampleFrames(chunkDATA.size / waveBuffer.GetFormat().BytesPerFrame());
     stream.read(waveBuffer.Data(), chunkDATA.size);
 }
@@ -127,6 +155,27 @@ void WAVReader::ReadWaveBuffer(std::istream& stream, WaveBuffer& buffer)
     WAVReadChunks(stream, streamSize, buffer);
 }
 
+bool WAVReader::ReadPCMPayload(std::istream& stream, AudioPCMPayload& payload)
+{
+    if (!stream.good())
+        throw std::runtime_error("invalid input stream for WAV file");
+
+    /* Read RIFF WAVE header and "fmt " chunk */
+    std::uint32_t streamSize = 0;
+    WAVReadHeader(stream, streamSize);
+
+    payload.format = WAVReadFormatChunk(stream, streamSize);
+
+    /* Find "data" chunk, the PCM payload begins directly after the chunk header */
+    auto chunkDATA = WAVFindChunk(stream, streamSize, "data");
+
+    payload.offset  = static_cast<std::uint64_t>(stream.tellg());
+    payload.size    = chunkDATA.size;
+
+    /* RIFF WAVE samples are stored in little-endian byte order */
+    return IsHostLittleEndian();
+}
+
 
 } // /namespace Ac
 
@@ -23,6 +23,8 @@ class AC_EXPORT WAVReader : public AudioReader
 
         void ReadWaveBuffer(std::istream& stream, WaveBuffer& buffer) override;
 
+        bool ReadPCMPayload(std::istream& stream, AudioPCMPayload& payload) override;
+
 };
 
 
@@ -8,21 +8,95 @@
 #include "WAVWriter.h"
 #include "WAVFileFormat.h"
 #include "WAVFormatTags.h"
+#include "../Core/PCMConversion.h"
 #include <sstream>
+#include <vector>
+#include <algorithm>
+#include <iterator>
 
 
 namespace Ac
 {
 
 
+// Returns true if the format requires the extensible RIFF WAVE format, i.e. for integer samples with more than 16 bits or more than 2 channels.
+static bool IsExtensibleFormat(const WaveBufferFormat& fmt)
+{
+    return ((!fmt.floatingPoint && fmt.bitsPerSample > 16) || fmt.channels > 2);
+}
+
+// Returns the speaker position bit mask for the channel types (see ChannelTypes.h), or zero if their order does not match the order of the speaker bits.
+static std::uint32_t GetChannelMask(std::uint16_t channels)
+{
+    static const std::uint32_t FL = 0x001, FR = 0x002, FC = 0x004, LFE = 0x008, BL = 0x010, BR = 0x020, BC = 0x100, SL = 0x200, SR = 0x400;
+
+    std::vector<std::uint32_t> speakers;
+
+    switch (channels)
+    {
+        case 1: speakers = { FC };                              break;
+        case 2: speakers = { FL, FR };                          break;
+        case 3: speakers = { FL, FC, FR };                      break;
+        case 4: speakers = { FL, FR, BL, BR };                  break;
+        case 5: speakers = { FL, FC, FR, BL, BR };              break;
+        case 6: speakers = { FL, FC, FR, BL, BR, LFE };         break;
+        case 7: speakers = { FL, FC, FR, SL, SR, BC, LFE };     break;
+        case 8: speakers = { FL, FC, FR, SL, SR, BL, BR, LFE }; break;
+        default:                                                break;
+    }
+
+    /* The channels of a RIFF WAVE stream are ordered by their speaker bits, so leave the speakers unassigned for any other order */
+    std::uint32_t mask = 0;
+
+    for (auto bit : speakers)
+    {
+        if (bit <= mask)
+            return 0;
+        mask |= bit;
+    }
+
+    return mask;
+}
+
 static void GetRIFFWAVEFormat(RIFFWAVEFormat& format, const WaveBufferFormat& fmt)
 {
-    format.formatTag        = RIFFWAVEFormatTags::PCM;
+    format.formatTag        = (fmt.floatingPoint ? RIFFWAVEFormatTags::IEEE_FLOAT : RIFFWAVEFormatTags::PCM);
     format.channels         = fmt.channels;
     format.sampleRate       = fmt.sampleRate;
     format.bytesPerSecond   = static_cast<std::uint32_t>(fmt.BytesPerSecond());
     format.blockAlign       = static_cast<std::uint16_t>(fmt.BytesPerFrame());
     format.bitsPerSample    = fmt.bitsPerSample;
+
+    if (IsExtensibleFormat(fmt))
+        format.formatTag = RIFFWAVEFormatTags::Extensible;
+}
+
+static void GetRIFFWAVEFormatExtension(RIFFWAVEFormatExtension& formatExt, const WaveBufferFormat& fmt)
+{
+    /* Sub format GUID is "xxxxxxxx-0000-0010-8000-00aa00389b71", where the first bytes are the format tag */
+    static const std::uint8_t subFormatGUID[14] = { 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0xaa, 0x00, 0x38, 0x9b, 0x71 };
+
+    formatExt.extensionSize         = static_cast<std::uint16_t>(sizeof(RIFFWAVEFormatExtension) - sizeof(std::uint16_t));
+    formatExt.validBitsPerSample    = fmt.bitsPerSample;
+    formatExt.channelMask           = GetChannelMask(fmt.channels);
+    formatExt.subFormatTag          = (fmt.floatingPoint ? RIFFWAVEFormatTags::IEEE_FLOAT : RIFFWAVEFormatTags::PCM);
+    std::copy(std::begin(subFormatGUID), std::end(subFormatGUID), formatExt.subFormatGUID);
+}
+
+// Returns the size of the "fmt " chunk: the basic format for integer PCM, plus the extension size field for floating-point samples, plus the extension for extensible formats.
+static std::uint32_t GetFormatChunkSize(const WaveBufferFormat& fmt)
+{
+    if (IsExtensibleFormat(fmt))
+        return sizeof(RIFFWAVEFormat) + sizeof(RIFFWAVEFormatExtension);
+    if (fmt.floatingPoint)
+        return sizeof(RIFFWAVEFormat) + sizeof(std::uint16_t);
+    return sizeof(RIFFWAVEFormat);
+}
+
+// Returns the size of the "fact" chunk (including its header), which is required for all formats other than integer PCM.
+static std::uint32_t GetFactChunkSize(const WaveBufferFormat& fmt)
+{
+    return (fmt.floatingPoint ? sizeof(RIFFWAVEChunk) + sizeof(std::uint32_t) : 0);
 }
 
 template <typename T>
@@ -55,41 +129,105 @@ static void WAVWriteChunk(std::ostream& stream, const char* chunkID, std::uint32
     Write(stream, chunkSize);
 }
 
+static void WAVWriteSampleData(std::ostream& stream, const WaveBufferConstView& waveBuffer)
+{
+    if (waveBuffer.GetStorage() == WaveBufferStorage::Interleaved)
+    {
+        /* Write PCM data directly */
+        stream.write(waveBuffer.Data(), waveBuffer.BufferSize());
+    }
+    else
+    {
+        /* Convert planar samples into PCM data block by block */
+        const auto& fmt             = waveBuffer.GetFormat();
+        auto        type            = GetPCMType(fmt);
+        auto        sampleFrames    = waveBuffer.GetSampleFrames();
+
+        auto framesPerBlock = std::max(std::size_t(1u), WaveBuffer::maxBlockSamples / fmt.channels);
+
+        std::vector<float>  samples(framesPerBlock * fmt.channels);
+        std::vector<char>   data(framesPerBlock * fmt.BytesPerFrame());
+
+        for (std::size_t i = 0; i < sampleFrames; i += framesPerBlock)
+        {
+            auto frames = waveBuffer.ReadFrames(i, framesPerBlock, samples.data());
+            ConvertFloatToPCM(type, samples.data(), data.data(), frames * fmt.channels);
+            stream.write(data.data(), frames * fmt.BytesPerFrame());
+        }
+    }
+}
+
 /*
 RIFF WAVE format chunk (for RIFF tags see details).
 \see http://de.wikipedia.org/wiki/RIFF_WAVE
 \see http://www.sno.phy.queensu.ca/~phil/exiftool/TagNames/RIFF.html
 */
-static void WAVWriteChunks(std::ostream& stream, const WaveBuffer& waveBuffer)
+static void WAVWriteChunks(std::ostream& stream, const WaveBufferFormat& fmt, std::size_t sampleFrames)
 {
     /* Get RIFF WAVE format from buffer format object */
     RIFFWAVEFormat format;
-    GetRIFFWAVEFormat(format, waveBuffer.GetFormat());
+    GetRIFFWAVEFormat(format, fmt);
 
     /* Write "fmt " chunk */
-    std::uint32_t chunkSizeFMT = sizeof(format);
+    std::uint32_t chunkSizeFMT = GetFormatChunkSize(fmt);
     WAVWriteChunk(stream, "fmt ", chunkSizeFMT);
 
     Write(stream, format);
 
-    /* Write "data" chunk and PCM data */
-    std::uint32_t chunkSizeDATA = static_cast<std::uint32_t>(waveBuffer.BufferSize());
+    if (format.formatTag == RIFFWAVEFormatTags::Extensible)
+    {
+        /* Write format extension with the actual format tag and the channel mask */
+        RIFFWAVEFormatExtension formatExt;
+        GetRIFFWAVEFormatExtension(formatExt, fmt);
+        Write(stream, formatExt);
+    }
+    else if (format.formatTag != RIFFWAVEFormatTags::PCM)
+    {
+        /* Write empty extension size field */
+        std::uint16_t extensionSize = 0;
+        Write(stream, extensionSize);
+    }
+
+    /* Write "fact" chunk with the number of sample frames (only for non-PCM formats) */
+    if (GetFactChunkSize(fmt) > 0)
+    {
+        WAVWriteChunk(stream, "fact", sizeof(std::uint32_t));
+        std::uint32_t sampleLength = static_cast<std::uint32_t>(sampleFrames);
+        Write(stream, sampleLength);
+    }
+
+    /* Write "data" chunk (the PCM data follows) */
+    std::uint32_t chunkSizeDATA = static_cast<std::uint32_t>(sampleFrames * fmt.BytesPerFrame());
     WAVWriteChunk(stream, "data", chunkSizeDATA);
-
-    stream.write(waveBuffer.Data(), waveBuffer.BufferSize());
 }
 
-void WAVWriter::WriteWaveBuffer(std::ostream& stream, const WaveBuffer& buffer)
+static void WAVWriteHeader(std::ostream& stream, const WaveBufferFormat& format, std::size_t sampleFrames)
 {
     if (!stream.good())
         throw std::runtime_error("invalid output stream for WAV file");
 
     /* Write RIFF WAVE header */
-    std::uint32_t streamSize = static_cast<std::uint32_t>(4u + 2u*sizeof(RIFFWAVEChunk) + sizeof(RIFFWAVEFormat) + buffer.BufferSize());
+    auto dataSize = sampleFrames * format.BytesPerFrame();
+    std::uint32_t streamSize = static_cast<std::uint32_t>(4u + 2u*sizeof(RIFFWAVEChunk) + GetFormatChunkSize(format) + GetFactChunkSize(format) + dataSize);
     WAVWriteRIFFWAVEHeader(stream, streamSize);
 
-    /* Fill wave buffer by reading chunks "fmt " and "data" */
-    WAVWriteChunks(stream, buffer);
+    /* Write chunks "fmt ", "fact", and "data" */
+    WAVWriteChunks(stream, format, sampleFrames);
+}
+
+void WAVWriter::WriteWaveBuffer(std::ostream& stream, const WaveBufferConstView& buffer)
+{
+    WAVWriteHeader(stream, buffer.GetFormat(), buffer.GetSampleFrames());
+    WAVWriteSampleData(stream, buffer);
+}
+
+void WAVWriter::WriteWaveBuffer(std::ostream& stream, const WaveBuffer& buffer)
+{
+    WAVWriteHeader(stream, buffer.GetFormat(), buffer.GetSampleFrames());
+
+    /* Write PCM data chunk by chunk, without flattening the wave buffer */
+    for (std::size_t i = 0, n = buffer.GetNumChunks(); i < n; ++i)
+        WAVWriteSampleData(stream, buffer.GetChunk(i));
 }
 
 
@@ -21,6 +21,7 @@ class AC_EXPORT WAVWriter : public AudioWriter
 
     public:
 
+        void WriteWaveBuffer(std::ostream& stream, const WaveBufferConstView& buffer) override;
         void WriteWaveBuffer(std::ostream& stream, const WaveBuffer& buffer) override;
 
 };
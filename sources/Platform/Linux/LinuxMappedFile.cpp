@@ -0,0 +1,72 @@
+/*
+ * LinuxMappedFile.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "LinuxMappedFile.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+
+namespace Ac
+{
+
+
+std::unique_ptr<MappedFile> MappedFile::Open(const std::string& filename)
+{
+    /* Open file and determine its size */
+    auto fd = open(filename.c_str(), O_RDONLY);
+    if (fd == -1)
+        return nullptr;
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0 || fileStat.st_size <= 0)
+    {
+        close(fd);
+        return nullptr;
+    }
+
+    /* Map entire file as read-only shared memory (the mapping stays valid after the file descriptor has been closed) */
+    auto size = static_cast<std::size_t>(fileStat.st_size);
+    auto data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+
+    close(fd);
+
+    if (data == MAP_FAILED)
+        return nullptr;
+
+    return std::unique_ptr<MappedFile>(new LinuxMappedFile(data, size));
+}
+
+LinuxMappedFile::LinuxMappedFile(void* data, std::size_t size) :
+    data_ { data },
+    size_ { size }
+{
+}
+
+LinuxMappedFile::~LinuxMappedFile()
+{
+    munmap(data_, size_);
+}
+
+const char* LinuxMappedFile::GetData() const
+{
+    return reinterpret_cast<const char*>(data_);
+}
+
+std::size_t LinuxMappedFile::GetSize() const
+{
+    return size_;
+}
+
+
+} // /namespace Ac
+
+
+
+// ================================================================================
@@ -0,0 +1,48 @@
+/*
+ * LinuxMappedFile.h
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef AC_LINUX_MAPPED_FILE_H
+#define AC_LINUX_MAPPED_FILE_H
+
+
+#include "../MappedFile.h"
+
+
+namespace Ac
+{
+
+
+class LinuxMappedFile : public MappedFile
+{
+
+    public:
+
+        LinuxMappedFile(void* data, std::size_t size);
+        ~LinuxMappedFile();
+
+        LinuxMappedFile(const LinuxMappedFile&) = delete;
+        LinuxMappedFile& operator = (const LinuxMappedFile&) = delete;
+
+        const char* GetData() const override;
+        std::size_t GetSize() const override;
+
+    private:
+
+        void*       data_ = nullptr;
+        std::size_t size_ = 0;
+
+};
+
+
+} // /namespace Ac
+
+
+#endif
+
+
+
+// ================================================================================
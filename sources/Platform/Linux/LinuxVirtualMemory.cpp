@@ -0,0 +1,88 @@
+/*
+ * LinuxVirtualMemory.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "../VirtualMemory.h"
+
+#include <sys/mman.h>
+#include <fstream>
+#include <string>
+
+
+namespace Ac
+{
+
+
+static std::size_t QueryLargePageSize()
+{
+    /* Read default huge page size from "Hugepagesize: 2048 kB" entry */
+    std::ifstream file("/proc/meminfo");
+    std::string name;
+
+    while (file >> name)
+    {
+        if (name == "Hugepagesize:")
+        {
+            std::size_t size = 0;
+            if (file >> size && size > 0)
+                return size * 1024;
+            break;
+        }
+        file.ignore(256, '\n');
+    }
+
+    return (2u << 20);
+}
+
+static std::size_t RoundUpToLargePages(std::size_t size)
+{
+    const auto pageSize = GetLargePageSize();
+    return ((size + pageSize - 1) / pageSize * pageSize);
+}
+
+std::size_t GetLargePageSize()
+{
+    static const std::size_t pageSize = QueryLargePageSize();
+    return pageSize;
+}
+
+void* AllocLargePageMemory(std::size_t size)
+{
+    size = RoundUpToLargePages(size);
+
+    void* ptr = MAP_FAILED;
+
+    #ifdef MAP_HUGETLB
+    /* Try to map explicitly reserved huge pages first */
+    ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (ptr != MAP_FAILED)
+        return ptr;
+    #endif
+
+    /* Map regular pages and let the kernel back them with transparent huge pages */
+    ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ptr == MAP_FAILED)
+        return nullptr;
+
+    #ifdef MADV_HUGEPAGE
+    madvise(ptr, size, MADV_HUGEPAGE);
+    #endif
+
+    return ptr;
+}
+
+void FreeLargePageMemory(void* ptr, std::size_t size)
+{
+    if (ptr)
+        munmap(ptr, RoundUpToLargePages(size));
+}
+
+
+} // /namespace Ac
+
+
+
+// ================================================================================
@@ -0,0 +1,48 @@
+/*
+ * MacOSMappedFile.h
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef AC_MACOS_MAPPED_FILE_H
+#define AC_MACOS_MAPPED_FILE_H
+
+
+#include "../MappedFile.h"
+
+
+namespace Ac
+{
+
+
+class MacOSMappedFile : public MappedFile
+{
+
+    public:
+
+        MacOSMappedFile(void* data, std::size_t size);
+        ~MacOSMappedFile();
+
+        MacOSMappedFile(const MacOSMappedFile&) = delete;
+        MacOSMappedFile& operator = (const MacOSMappedFile&) = delete;
+
+        const char* GetData() const override;
+        std::size_t GetSize() const override;
+
+    private:
+
+        void*       data_ = nullptr;
+        std::size_t size_ = 0;
+
+};
+
+
+} // /namespace Ac
+
+
+#endif
+
+
+
+// ================================================================================
@@ -0,0 +1,58 @@
+/*
+ * MacOSVirtualMemory.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "../VirtualMemory.h"
+
+#include <sys/mman.h>
+#include <mach/vm_statistics.h>
+
+
+namespace Ac
+{
+
+
+static std::size_t RoundUpToLargePages(std::size_t size)
+{
+    const auto pageSize = GetLargePageSize();
+    return ((size + pageSize - 1) / pageSize * pageSize);
+}
+
+std::size_t GetLargePageSize()
+{
+    return (2u << 20);
+}
+
+void* AllocLargePageMemory(std::size_t size)
+{
+    size = RoundUpToLargePages(size);
+
+    void* ptr = MAP_FAILED;
+
+    #ifdef VM_FLAGS_SUPERPAGE_SIZE_2MB
+    /* Try to map 2 MiB superpages first (the file descriptor argument specifies the VM flags for anonymous mappings) */
+    ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, VM_FLAGS_SUPERPAGE_SIZE_2MB, 0);
+    if (ptr != MAP_FAILED)
+        return ptr;
+    #endif
+
+    /* Map regular pages */
+    ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+    return (ptr != MAP_FAILED ? ptr : nullptr);
+}
+
+void FreeLargePageMemory(void* ptr, std::size_t size)
+{
+    if (ptr)
+        munmap(ptr, RoundUpToLargePages(size));
+}
+
+
+} // /namespace Ac
+
+
+
+// ================================================================================
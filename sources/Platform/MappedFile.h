@@ -0,0 +1,55 @@
+/*
+ * MappedFile.h
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef AC_MAPPED_FILE_H
+#define AC_MAPPED_FILE_H
+
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+
+namespace Ac
+{
+
+
+//! Read-only memory-mapped file class (the file contents are served and shared by the page cache of the operating system).
+class MappedFile
+{
+
+    public:
+
+        MappedFile() = default;
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator = (const MappedFile&) = delete;
+
+        virtual ~MappedFile()
+        {
+        }
+
+        //! Maps the entire specified file into memory, or returns null if the file could not be mapped.
+        static std::unique_ptr<MappedFile> Open(const std::string& filename);
+
+        //! Returns a constant raw pointer to the file contents.
+        virtual const char* GetData() const = 0;
+
+        //! Returns the size (in bytes) of the file.
+        virtual std::size_t GetSize() const = 0;
+
+};
+
+
+} // /namespace Ac
+
+
+#endif
+
+
+
+// ================================================================================
@@ -0,0 +1,40 @@
+/*
+ * VirtualMemory.h
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef AC_VIRTUAL_MEMORY_H
+#define AC_VIRTUAL_MEMORY_H
+
+
+#include <cstddef>
+
+
+namespace Ac
+{
+
+
+//! Returns the size (in bytes) of a large memory page (e.g. 2 MiB on x86-64).
+std::size_t GetLargePageSize();
+
+/**
+Allocates page-aligned virtual memory directly from the operating system, preferably backed by large pages.
+If large pages are not available, the memory is backed by regular pages. Returns null on failure.
+The size is rounded up to a multiple of the large page size.
+*/
+void* AllocLargePageMemory(std::size_t size);
+
+//! Releases the memory which has been allocated with "AllocLargePageMemory". The size must be the same as for the allocation.
+void FreeLargePageMemory(void* ptr, std::size_t size);
+
+
+} // /namespace Ac
+
+
+#endif
+
+
+
+// ================================================================================
@@ -0,0 +1,71 @@
+/*
+ * Win32MappedFile.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "Win32MappedFile.h"
+
+
+namespace Ac
+{
+
+
+std::unique_ptr<MappedFile> MappedFile::Open(const std::string& filename)
+{
+    /* Open file and determine its size */
+    auto file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return nullptr;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0)
+    {
+        CloseHandle(file);
+        return nullptr;
+    }
+
+    /* Map entire file as read-only view (the view stays valid after the file and mapping handles have been closed) */
+    auto mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+
+    if (!mapping)
+        return nullptr;
+
+    auto data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+
+    if (!data)
+        return nullptr;
+
+    return std::unique_ptr<MappedFile>(new Win32MappedFile(data, static_cast<std::size_t>(fileSize.QuadPart)));
+}
+
+Win32MappedFile::Win32MappedFile(const void* data, std::size_t size) :
+    data_ { data },
+    size_ { size }
+{
+}
+
+Win32MappedFile::~Win32MappedFile()
+{
+    UnmapViewOfFile(data_);
+}
+
+const char* Win32MappedFile::GetData() const
+{
+    return reinterpret_cast<const char*>(data_);
+}
+
+std::size_t Win32MappedFile::GetSize() const
+{
+    return size_;
+}
+
+
+} // /namespace Ac
+
+
+
+// ================================================================================
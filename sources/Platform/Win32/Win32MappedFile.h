@@ -0,0 +1,50 @@
+/*
+ * Win32MappedFile.h
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef AC_WIN32_MAPPED_FILE_H
+#define AC_WIN32_MAPPED_FILE_H
+
+
+#include "../MappedFile.h"
+
+#include <Windows.h>
+
+
+namespace Ac
+{
+
+
+class Win32MappedFile : public MappedFile
+{
+
+    public:
+
+        Win32MappedFile(const void* data, std::size_t size);
+        ~Win32MappedFile();
+
+        Win32MappedFile(const Win32MappedFile&) = delete;
+        Win32MappedFile& operator = (const Win32MappedFile&) = delete;
+
+        const char* GetData() const override;
+        std::size_t GetSize() const override;
+
+    private:
+
+        const void* data_ = nullptr;
+        std::size_t size_ = 0;
+
+};
+
+
+} // /namespace Ac
+
+
+#endif
+
+
+
+// ================================================================================
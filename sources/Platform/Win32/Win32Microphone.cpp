@@ -89,8 +89,9 @@ void Win32Microphone::Start(const WaveBufferFormat& waveFormat, std::size_t samp
 {
     if (!recording_)
     {
-        /* Store recording wave format */
-        recvBufferFormat_ = waveFormat;
+        /* Store recording wave format and the allocator for the receiver buffers */
+        recvBufferFormat_       = waveFormat;
+        recvBufferAllocator_    = &GetDefaultSampleAllocator();
 
         /* Start recording process */
         OpenWaveInput(sampleFrames, GetDeviceID(deviceIndex));
@@ -134,7 +135,7 @@ void Win32Microphone::OnSync(DWORD bytesRecorded)
 
     /* Create new receiver buffer (if previous buffer was moved to user) */
     if (!recvBuffer_)
-        recvBuffer_ = std::unique_ptr<WaveBuffer>(new WaveBuffer { recvBufferFormat_ });
+        recvBuffer_ = std::unique_ptr<WaveBuffer>(new WaveBuffer { recvBufferFormat_, WaveBufferStorage::Interleaved, *recvBufferAllocator_ });
 
     /* Copy input buffer to receiver buffer */
     recvBuffer_->SetSampleFrames(buffer_.size() / recvBufferFormat_.BytesPerFrame());
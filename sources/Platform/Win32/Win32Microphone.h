@@ -59,6 +59,7 @@ class Win32Microphone : public Microphone
 
         std::unique_ptr<WaveBuffer> recvBuffer_;
         WaveBufferFormat            recvBufferFormat_;
+        SampleAllocator*            recvBufferAllocator_ = nullptr;
         std::mutex                  recvBufferMutex_;
 
 };
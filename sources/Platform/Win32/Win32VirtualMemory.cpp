@@ -0,0 +1,56 @@
+/*
+ * Win32VirtualMemory.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "../VirtualMemory.h"
+
+#include <Windows.h>
+
+
+namespace Ac
+{
+
+
+static std::size_t RoundUpToLargePages(std::size_t size)
+{
+    const auto pageSize = GetLargePageSize();
+    return ((size + pageSize - 1) / pageSize * pageSize);
+}
+
+std::size_t GetLargePageSize()
+{
+    static const std::size_t pageSize = GetLargePageMinimum();
+    return (pageSize > 0 ? pageSize : (2u << 20));
+}
+
+void* AllocLargePageMemory(std::size_t size)
+{
+    size = RoundUpToLargePages(size);
+
+    /* Try to allocate large pages first (requires the "SeLockMemoryPrivilege" privilege) */
+    if (GetLargePageMinimum() > 0)
+    {
+        auto ptr = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+        if (ptr)
+            return ptr;
+    }
+
+    /* Allocate regular pages */
+    return VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+}
+
+void FreeLargePageMemory(void* ptr, std::size_t /*size*/)
+{
+    if (ptr)
+        VirtualFree(ptr, 0, MEM_RELEASE);
+}
+
+
+} // /namespace Ac
+
+
+
+// ================================================================================
@@ -6,6 +6,7 @@
  */
 
 #include "../Platform/Module.h"
+#include "../Platform/MappedFile.h"
 #include "../FileHandler/WAVReader.h"
 #include "../FileHandler/WAVWriter.h"
 #include "../FileHandler/AIFFReader.h"
@@ -15,6 +16,7 @@
 #include "../Core/Streaming.h"
 
 #include <Ac/AudioSystem.h>
+#include <algorithm>
 #include <array>
 #include <fstream>
 #include <cstdint>
@@ -186,6 +188,7 @@ std::unique_ptr<Sound> AudioSystem::LoadSound(const std::string& filename, const
             /* Load sound as wave buffer */
             auto waveBuffer = ReadWaveBuffer(*file);
 
+            /* Downmix to mono for 3D sounds (surround layouts are folded down with the standard remix matrix) */
             if ((flags & SoundFlags::Enable3D) != 0)
                 waveBuffer.SetChannels(1);
 
@@ -274,6 +277,49 @@ WaveBuffer AudioSystem::ReadWaveBuffer(std::istream& stream)
     return waveBuffer;
 }
 
+WaveBuffer AudioSystem::MapWaveBuffer(const std::string& filename)
+{
+    /* Open file stream in binary mode */
+    std::ifstream file(filename, std::ios_base::binary);
+    if (!file.good())
+        return WaveBuffer();
+
+    auto reader = QueryReader(Ac::DetermineAudioFormat(file));
+    if (!reader)
+        return WaveBuffer();
+
+    /* Map PCM payload directly if it's stored like the interleaved wave buffer storage */
+    auto streamPos = file.tellg();
+
+    AudioPCMPayload payload;
+    if (reader->ReadPCMPayload(file, payload))
+    {
+        std::shared_ptr<MappedFile> mappedFile = MappedFile::Open(filename);
+        if (mappedFile && payload.offset < mappedFile->GetSize())
+        {
+            auto bufferSize = std::min(static_cast<std::size_t>(payload.size), mappedFile->GetSize() - static_cast<std::size_t>(payload.offset));
+
+            /* Refer into the mapped file with an aliasing shared pointer, which keeps the file mapped */
+            WaveBuffer waveBuffer;
+            waveBuffer.AttachExternalData(
+                payload.format,
+                std::shared_ptr<const char>(mappedFile, mappedFile->GetData() + payload.offset),
+                bufferSize
+            );
+            return waveBuffer;
+        }
+    }
+
+    /* Read entire wave buffer otherwise */
+    file.clear();
+    file.seekg(streamPos);
+
+    WaveBuffer waveBuffer;
+    reader->ReadWaveBuffer(file, waveBuffer);
+
+    return waveBuffer;
+}
+
 std::unique_ptr<AudioStream> AudioSystem::OpenAudioStream(const std::string& filename)
 {
     /* Open file stream in binary mode */
@@ -313,6 +359,17 @@ static std::unique_ptr<AudioWriter> QueryWriter(const AudioFormats format)
     }
 }
 
+bool AudioSystem::WriteAudioBuffer(const AudioFormats format, std::ostream& stream, const WaveBufferConstView& waveBuffer)
+{
+    auto writer = QueryWriter(format);
+    if (writer)
+    {
+        writer->WriteWaveBuffer(stream, waveBuffer);
+        return true;
+    }
+    return false;
+}
+
 bool AudioSystem::WriteAudioBuffer(const AudioFormats format, std::ostream& stream, const WaveBuffer& waveBuffer)
 {
     auto writer = QueryWriter(format);
@@ -141,7 +141,7 @@ void NullSound::AttachSharedBuffer(const Sound& sourceBufferSound)
     UnsynchStop();
 }
 
-void NullSound::QueueBuffer(const WaveBuffer& waveBuffer)
+void NullSound::QueueBuffer(const WaveBufferConstView& waveBuffer)
 {
     // dummy
 }
@@ -48,6 +48,13 @@ void ALBufferObj::BufferData(ALenum format, const ALvoid* buffer, ALsizei size,
 
 void ALBufferObj::BufferData(const WaveBuffer& waveBuffer)
 {
+    /* Convert planar samples and sample formats which are not supported by OpenAL into 16-bit PCM data first */
+    if (ALWaveBufferRequiresConversion(waveBuffer))
+    {
+        BufferData(ALConvertWaveBuffer(waveBuffer));
+        return;
+    }
+
     ALenum fmt = 0;
     if (ALFormatFromWaveFormat(fmt, waveBuffer.GetFormat()))
     {
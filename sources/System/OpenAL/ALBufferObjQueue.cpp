@@ -35,8 +35,15 @@ void ALBufferObjQueue::Reset()
     alSourceUnqueueBuffers(sourceHandle_, queued, nullptr);*/
 }
 
-void ALBufferObjQueue::QueueBufferData(const WaveBuffer& waveBuffer)
+void ALBufferObjQueue::QueueBufferData(const WaveBufferConstView& waveBuffer)
 {
+    /* Convert planar samples and sample formats which are not supported by OpenAL into 16-bit PCM data first */
+    if (ALWaveBufferRequiresConversion(waveBuffer))
+    {
+        QueueBufferData(ALConvertWaveBuffer(waveBuffer));
+        return;
+    }
+
     /* Get wave buffer attributes */
     auto size = static_cast<ALsizei>(waveBuffer.BufferSize());
     auto sampleRate = static_cast<ALsizei>(waveBuffer.GetFormat().sampleRate);
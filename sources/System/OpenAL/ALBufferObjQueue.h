@@ -11,7 +11,7 @@
 
 #include "OpenAL.h"
 
-#include <Ac/WaveBuffer.h>
+#include <Ac/WaveBufferView.h>
 #include <vector>
 #include <queue>
 
@@ -30,7 +30,7 @@ class ALBufferObjQueue
 
         void Reset();
 
-        void QueueBufferData(const WaveBuffer& waveBuffer);
+        void QueueBufferData(const WaveBufferConstView& waveBuffer);
 
         inline std::size_t QueueSize() const
         {
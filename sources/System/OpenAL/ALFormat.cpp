@@ -6,6 +6,8 @@
  */
 
 #include "ALFormat.h"
+#include <algorithm>
+#include <vector>
 
 
 namespace Ac
@@ -37,6 +39,40 @@ bool ALFormatFromWaveFormat(ALenum& outFormat, const WaveBufferFormat& inFormat)
     return true;
 }
 
+bool ALWaveBufferRequiresConversion(const WaveBufferConstView& waveBuffer)
+{
+    const auto& format = waveBuffer.GetFormat();
+    return (waveBuffer.GetStorage() != WaveBufferStorage::Interleaved || format.bitsPerSample > 16 || format.floatingPoint);
+}
+
+WaveBuffer ALConvertWaveBuffer(const WaveBufferConstView& waveBuffer)
+{
+    auto format = waveBuffer.GetFormat();
+
+    if (format.bitsPerSample > 16 || format.floatingPoint)
+    {
+        format.bitsPerSample    = 16;
+        format.floatingPoint    = false;
+    }
+
+    /* Convert samples block by block */
+    auto sampleFrames = waveBuffer.GetSampleFrames();
+
+    WaveBuffer buffer(format);
+    buffer.SetSampleFrames(sampleFrames);
+
+    auto framesPerBlock = std::max(std::size_t(1u), WaveBuffer::maxBlockSamples / format.channels);
+    std::vector<float> block(framesPerBlock * format.channels);
+
+    for (std::size_t i = 0; i < sampleFrames; i += framesPerBlock)
+    {
+        auto frames = waveBuffer.ReadFrames(i, framesPerBlock, block.data());
+        buffer.WriteFrames(i, frames, block.data());
+    }
+
+    return buffer;
+}
+
 void WaveFormatFromALFormat(ALenum format, std::uint16_t& channels, std::uint16_t& bitsPerSample)
 {
     switch (format)
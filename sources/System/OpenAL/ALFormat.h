@@ -11,7 +11,7 @@
 
 #include "OpenAL.h"
 
-#include <Ac/WaveBuffer.h>
+#include <Ac/WaveBufferView.h>
 #include <string>
 
 
@@ -21,6 +21,12 @@ namespace Ac
 
 bool ALFormatFromWaveFormat(ALenum& outFormat, const WaveBufferFormat& inFormat);
 
+//! Returns true if the wave buffer must be converted into a format which is supported by OpenAL (interleaved 8- or 16-bit PCM data).
+bool ALWaveBufferRequiresConversion(const WaveBufferConstView& waveBuffer);
+
+//! Returns a copy of the referenced samples, which is converted into interleaved 16-bit PCM data.
+WaveBuffer ALConvertWaveBuffer(const WaveBufferConstView& waveBuffer);
+
 void WaveFormatFromALFormat(ALenum format, std::uint16_t& channels, std::uint16_t& bitsPerSample);
 
 std::string ALErrorToString(ALenum error);
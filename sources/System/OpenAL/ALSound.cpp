@@ -183,7 +183,7 @@ void ALSound::AttachSharedBuffer(const Sound& sourceBufferSound)
         sourceObj_->AttachBuffer(*bufferObj_);
 }
 
-void ALSound::QueueBuffer(const WaveBuffer& waveBuffer)
+void ALSound::QueueBuffer(const WaveBufferConstView& waveBuffer)
 {
     if (AcquireSourceObj())
     {
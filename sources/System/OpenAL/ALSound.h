@@ -55,7 +55,7 @@ class ALSound : public Sound
 
         void AttachBuffer(const WaveBuffer& waveBuffer) override;
         void AttachSharedBuffer(const Sound& sourceBufferSound) override;
-        void QueueBuffer(const WaveBuffer& waveBuffer) override;
+        void QueueBuffer(const WaveBufferConstView& waveBuffer) override;
 
         std::size_t GetQueueSize() const override;
         std::size_t GetProcessedQueueSize() const override;
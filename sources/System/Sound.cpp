@@ -31,6 +31,12 @@ void Sound::DropStoredBuffer()
     waveBuffer_.reset();
 }
 
+void Sound::QueueBufferChunks(const WaveBuffer& waveBuffer)
+{
+    for (std::size_t i = 0, n = waveBuffer.GetNumChunks(); i < n; ++i)
+        QueueBuffer(waveBuffer.GetChunk(i));
+}
+
 
 } // /namespace Ac
 
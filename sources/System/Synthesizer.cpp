@@ -6,9 +6,22 @@
  */
 
 #include "../Core/PCMData.h"
+#include "../Core/SampleTransforms.h"
+#include "../Core/Convolution.h"
 #include <Ac/Synthesizer.h>
+#include <Ac/WaveBufferView.h>
+#include <Ac/NoiseGenerator.h>
+#include <Ac/FDNReverb.h>
+#include <Ac/BiquadFilter.h>
+#include <Ac/Compressor.h>
+#include <Ac/Limiter.h>
+#include <Ac/Ducker.h>
+#include <Ac/CrossfadeCurve.h>
 #include <Gauss/Algebra.h>
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <memory>
 
 
 using namespace std::placeholders;
@@ -83,224 +96,395 @@ AC_EXPORT WaveFormGenerator operator - (const WaveFormGenerator& lhs, const Wave
 
 /* ----- Wave generators ----- */
 
-static void SineGeneratorCallback(
-    double&         sample,
-    std::uint16_t   /*channel*/,
-    std::size_t     /*index*/,
-    double          timePoint,
-    double          frequency,
-    double          amplitude,
-    double          phase)
+AC_EXPORT SampleIterationFunction Amplifier(double multiplicator)
 {
-    sample += std::sin((timePoint + phase)*2.0*M_PI*frequency)*amplitude;
+    return [multiplicator](double& sample, std::uint16_t channel, std::size_t index, double timePoint)
+    {
+        sample *= multiplicator;
+    };
 }
 
-AC_EXPORT WaveFormGenerator SineGenerator(const WaveForm& wave)
+// Returns a new seed for the noise generators without an explicit seed.
+static std::uint64_t NextNoiseSeed()
 {
+    static std::atomic<std::uint64_t> seedCounter { 0 };
+    return seedCounter.fetch_add(1);
+}
+
+// Returns a generator function which adds the noise of a shared noise generator (with separate random streams for each channel).
+static WaveFormGenerator MakeNoiseGenerator(const NoiseColor color, double amplitude, std::uint64_t seed)
+{
+    auto noise = std::make_shared<NoiseGenerator>(color, amplitude, seed);
     return SampleIterationFunction(
-        std::bind(
-            SineGeneratorCallback, _1, _2, _3, _4,
-            wave.frequency, wave.amplitude, wave.phase
-        )
+        [noise](double& sample, std::uint16_t channel, std::size_t /*index*/, double /*timePoint*/)
+        {
+            double value = 0.0;
+            noise->Generate(&value, 1, channel);
+            sample += value;
+        }
     );
 }
 
-static void SquareGeneratorCallback(
-    double&         sample,
-    std::uint16_t   /*channel*/,
-    std::size_t     /*index*/,
-    double          timePoint,
-    double          frequency,
-    double          amplitude,
-    double          phase,
-    double          bias)
+AC_EXPORT WaveFormGenerator WhiteNoiseGenerator(double amplitude)
 {
-    double i = 0.0;
-    double t = std::modf((timePoint + phase) * frequency, &i);
-    sample += (std::ceil(t - bias)*2.0 - 1.0) * amplitude;
+    return MakeNoiseGenerator(NoiseColor::White, amplitude, NextNoiseSeed());
 }
 
-AC_EXPORT WaveFormGenerator SquareGenerator(const WaveForm& wave, double bias)
+AC_EXPORT WaveFormGenerator WhiteNoiseGenerator(double amplitude, std::uint64_t seed)
 {
-    return SampleIterationFunction(
-        std::bind(
-            SquareGeneratorCallback, _1, _2, _3, _4,
-            wave.frequency, wave.amplitude, wave.phase, (std::max)(0.0, (std::min)(bias + 0.5, 1.0))
-        )
-    );
+    return MakeNoiseGenerator(NoiseColor::White, amplitude, seed);
 }
 
-static void TriangleGeneratorCallback(
-    double&         sample,
-    std::uint16_t   /*channel*/,
-    std::size_t     /*index*/,
-    double          timePoint,
-    double          frequency,
-    double          amplitude,
-    double          phase)
+AC_EXPORT WaveFormGenerator PinkNoiseGenerator(double amplitude)
 {
-    //TODO
-    double i = 0.0;
-    double t = std::modf((timePoint + phase) * frequency, &i);
-    sample += (t*2.0 - 1.0)*amplitude;
+    return MakeNoiseGenerator(NoiseColor::Pink, amplitude, NextNoiseSeed());
 }
 
-AC_EXPORT WaveFormGenerator TriangleGenerator(const WaveForm& wave)
+AC_EXPORT WaveFormGenerator PinkNoiseGenerator(double amplitude, std::uint64_t seed)
 {
-    return SampleIterationFunction(
-        std::bind(
-            TriangleGeneratorCallback, _1, _2, _3, _4,
-            wave.frequency, wave.amplitude, wave.phase
-        )
-    );
+    return MakeNoiseGenerator(NoiseColor::Pink, amplitude, seed);
 }
 
-static void SawGeneratorCallback(
-    double&         sample,
-    std::uint16_t   /*channel*/,
-    std::size_t     /*index*/,
-    double          timePoint,
-    double          frequency,
-    double          amplitude,
-    double          phase)
+AC_EXPORT WaveFormGenerator BrownNoiseGenerator(double amplitude, double& state)
 {
-    double i = 0.0;
-    double t = std::modf((timePoint + phase) * frequency, &i);
-    sample += (t*2.0 - 1.0)*amplitude;
+    state = 0.0;
+
+    auto noise = std::make_shared<NoiseGenerator>(NoiseColor::White, 1.0, NextNoiseSeed());
+
+    return SampleIterationFunction(
+        [amplitude, &state, noise](double& sample, std::uint16_t /*channel*/, std::size_t /*index*/, double /*timePoint*/)
+        {
+            /* Get random value in the range [0, 1) */
+            double random = 0.0;
+            noise->Generate(&random, 1);
+            random = (random + 1.0)*0.5;
+
+            /* Random walk, which tends back to the center */
+            auto noiseLerp = (state + 1.0)*0.5;
+            auto a = Gs::Lerp(0.0, -amplitude, noiseLerp);
+            auto b = Gs::Lerp(amplitude, 0.0, noiseLerp);
+            state += a + (b - a) * random;
+            sample = state;
+        }
+    );
 }
 
-AC_EXPORT WaveFormGenerator SawGenerator(const WaveForm& wave)
+AC_EXPORT WaveFormGenerator PerlinNoiseGenerator(double amplitude, PerlinNoise& noiseFunction, std::uint32_t frequency, std::uint32_t octaves, double persitence)
 {
     return SampleIterationFunction(
-        std::bind(
-            SawGeneratorCallback, _1, _2, _3, _4,
-            wave.frequency, wave.amplitude, wave.phase
-        )
+        [&noiseFunction, frequency, octaves, persitence](double& sample, std::uint16_t /*channel*/, std::size_t /*index*/, double timePoint)
+        {
+            sample = noiseFunction.Noise(timePoint*300.0, frequency, octaves, persitence);
+        }
     );
 }
 
-static void HalfCircleGeneratorCallback(
-    double&         sample,
-    std::uint16_t   channel,
-    std::size_t     index,
-    double          timePoint,
-    double          frequency,
-    double          amplitude,
-    double          phase)
+/* ----- Misc ----- */
+
+// see https://en.wikipedia.org/wiki/Piano_key_frequencies
+AC_EXPORT double GetNoteFrequency(const MusicalNotes note, int interval)
 {
-    double xInt = 0.0;
-    double x    = std::modf((timePoint + phase)*2.0*frequency, &xInt)*2.0 - 1.0;
-    double y    = std::sqrt(1.0 - x*x);
+    /* Determine key number */
+    int noteValue = static_cast<int>(note);
 
-    if (static_cast<int>(xInt) % 2 == 1)
-        y = -y;
+    int keyNo = (interval * 12 + noteValue - 8);
+    keyNo = std::max(1, std::min(keyNo, 88));
 
-    sample += y*amplitude;
+    /* Compute frequency by key number */
+    double baseFreq = 440.0;
+    double root_12_of_2 = std::pow(2.0, 1.0/12.0);
+    double freq = std::pow(root_12_of_2, keyNo - 49) * baseFreq;
+
+    return freq;
 }
 
-AC_EXPORT WaveFormGenerator HalfCircleGenerator(const WaveForm& wave)
+/* ----- Bulk transforms ----- */
+
+// Calls the function for each chunk of the wave buffer, so that chunked wave buffers are not flattened for read-only access.
+template <typename ChunkFunction>
+static void ForEachChunk(const WaveBuffer& buffer, ChunkFunction chunkFunction)
 {
-    return SampleIterationFunction(
-        std::bind(
-            HalfCircleGeneratorCallback, _1, _2, _3, _4,
-            wave.frequency, wave.amplitude, wave.phase
-        )
-    );
+    for (std::size_t i = 0, n = buffer.GetNumChunks(); i < n; ++i)
+        chunkFunction(buffer.GetChunk(i));
 }
 
-AC_EXPORT SampleIterationFunction Amplifier(double multiplicator)
+AC_EXPORT void ReverseWaveBuffer(WaveBuffer& buffer)
 {
-    return [multiplicator](double& sample, std::uint16_t channel, std::size_t index, double timePoint)
-    {
-        sample *= multiplicator;
-    };
+    ReverseFrames(WaveBufferView(buffer));
 }
 
-static double Random()
+AC_EXPORT void AmplifyWaveBuffer(WaveBuffer& buffer, double gain)
 {
-    return (static_cast<double>(rand()) / RAND_MAX);
+    if (gain != 1.0)
+        ApplyGain(WaveBufferView(buffer), static_cast<float>(gain));
 }
 
-static double Random(double a, double b)
+AC_EXPORT void AmplifyWaveBuffer(WaveBuffer& buffer, double gainFrom, double gainTo, double timePointFrom, double timePointTo)
 {
-    return (a + (b - a) * Random());
+    /* Clamp input parameters and determine the range of sample frames */
+    const auto sampleFrames = static_cast<double>(buffer.GetSampleFrames());
+    const auto sampleRate   = static_cast<double>(buffer.GetFormat().sampleRate);
+
+    auto indexFrom  = static_cast<std::size_t>(Gs::Clamp(timePointFrom * sampleRate, 0.0, sampleFrames));
+    auto indexTo    = static_cast<std::size_t>(Gs::Clamp(timePointTo * sampleRate, static_cast<double>(indexFrom), sampleFrames));
+
+    if (indexFrom < indexTo)
+        ApplyGainRamp(WaveBufferView(buffer, indexFrom, indexTo - indexFrom), gainFrom, gainTo);
 }
 
-AC_EXPORT WaveFormGenerator WhiteNoiseGenerator(double amplitude)
+AC_EXPORT double GetPeakLevel(const WaveBuffer& buffer)
 {
-    return SampleIterationFunction(
-        [amplitude](double& sample, std::uint16_t channel, std::size_t index, double timePoint)
+    float peak = 0.0f;
+
+    ForEachChunk(
+        buffer,
+        [&peak](const WaveBufferConstView& chunk)
         {
-            sample += Random(-1.0, 1.0) * amplitude;
+            peak = std::max(peak, GetPeakLevel(chunk));
         }
     );
+
+    return static_cast<double>(peak);
 }
 
-AC_EXPORT WaveFormGenerator BrownNoiseGenerator(double amplitude, double& state)
+AC_EXPORT double GetRMSLevel(const WaveBuffer& buffer)
 {
-    state = 0.0;
-    return SampleIterationFunction(
-        [amplitude, &state](double& sample, std::uint16_t channel, std::size_t index, double timePoint)
+    const auto numSamples = buffer.GetSampleFrames() * buffer.GetFormat().channels;
+    if (numSamples == 0)
+        return 0.0;
+
+    double sum = 0.0;
+
+    ForEachChunk(
+        buffer,
+        [&sum](const WaveBufferConstView& chunk)
         {
-            auto noiseLerp = (state + 1.0)*0.5;
-            auto noise = Random(
-                Gs::Lerp(0.0, -amplitude, noiseLerp),
-                Gs::Lerp(amplitude, 0.0, noiseLerp)
-            );
-            state += noise;
-            sample = state;
+            sum += GetSquareSum(chunk);
         }
     );
+
+    return std::sqrt(sum / static_cast<double>(numSamples));
 }
 
-AC_EXPORT WaveFormGenerator PerlinNoiseGenerator(double amplitude, PerlinNoise& noiseFunction, std::uint32_t frequency, std::uint32_t octaves, double persitence)
+AC_EXPORT double NormalizeWaveBuffer(WaveBuffer& buffer, double peakLevel)
 {
-    return SampleIterationFunction(
-        [&noiseFunction, frequency, octaves, persitence](double& sample, std::uint16_t /*channel*/, std::size_t /*index*/, double timePoint)
-        {
-            sample = noiseFunction.Noise(timePoint*300.0, frequency, octaves, persitence);
-        }
-    );
+    auto peak = GetPeakLevel(buffer);
+    if (peak > 0.0)
+    {
+        auto gain = peakLevel / peak;
+        AmplifyWaveBuffer(buffer, gain);
+        return gain;
+    }
+    return 1.0;
 }
 
-/* ----- Misc ----- */
+AC_EXPORT double NormalizeWaveBufferRMS(WaveBuffer& buffer, double rmsLevel)
+{
+    auto rms = GetRMSLevel(buffer);
+    if (rms > 0.0)
+    {
+        auto gain = rmsLevel / rms;
+        AmplifyWaveBuffer(buffer, gain);
+        return gain;
+    }
+    return 1.0;
+}
 
-// see https://en.wikipedia.org/wiki/Piano_key_frequencies
-AC_EXPORT double GetNoteFrequency(const MusicalNotes note, int interval)
+AC_EXPORT void RemoveDCOffset(WaveBuffer& buffer)
 {
-    /* Determine key number */
-    int noteValue = static_cast<int>(note);
+    const auto channels     = buffer.GetFormat().channels;
+    const auto sampleFrames = buffer.GetSampleFrames();
 
-    int keyNo = (interval * 12 + noteValue - 8);
-    keyNo = std::max(1, std::min(keyNo, 88));
+    if (sampleFrames == 0 || channels == 0)
+        return;
 
-    /* Compute frequency by key number */
-    double baseFreq = 440.0;
-    double root_12_of_2 = std::pow(2.0, 1.0/12.0);
-    double freq = std::pow(root_12_of_2, keyNo - 49) * baseFreq;
+    /* Determine mean value of each channel */
+    std::vector<double> sums(channels, 0.0);
 
-    return freq;
+    ForEachChunk(
+        buffer,
+        [&sums](const WaveBufferConstView& chunk)
+        {
+            GetChannelSums(chunk, sums.data());
+        }
+    );
+
+    /* Subtract mean values from each channel */
+    std::vector<float> offsets(channels);
+
+    for (std::uint16_t chn = 0; chn < channels; ++chn)
+        offsets[chn] = static_cast<float>(-sums[chn] / static_cast<double>(sampleFrames));
+
+    ApplyChannelOffsets(WaveBufferView(buffer), offsets.data());
 }
 
-AC_EXPORT void ReverseWaveBuffer(WaveBuffer& buffer)
+AC_EXPORT std::size_t TrimWaveBuffer(WaveBuffer& buffer, double threshold)
 {
-    /* Read from the copy of the buffer to prevent reading and writing on the same buffer */
-    auto bufferCopy = buffer;
-    buffer.ForEachSample(
-        [&bufferCopy](double& sample, std::uint16_t channel, std::size_t index, double timePoint)
+    const auto sampleFrames = buffer.GetSampleFrames();
+    const auto t            = static_cast<float>(threshold);
+
+    /* Find first audible sample frame (chunk by chunk from the beginning) */
+    auto first = sampleFrames;
+
+    for (std::size_t i = 0, n = buffer.GetNumChunks(), offset = 0; i < n && first == sampleFrames; ++i)
+    {
+        auto chunk = buffer.GetChunk(i);
+        auto index = FindFirstAudibleFrame(chunk, t);
+        if (index < chunk.GetSampleFrames())
+            first = offset + index;
+        offset += chunk.GetSampleFrames();
+    }
+
+    if (first == sampleFrames)
+    {
+        /* Remove all sample frames of a silent wave buffer */
+        buffer.SetSampleFrames(0);
+        return sampleFrames;
+    }
+
+    /* Find last audible sample frame (chunk by chunk from the end) */
+    auto last = first;
+
+    for (std::size_t i = buffer.GetNumChunks(), offset = sampleFrames; i > 0; --i)
+    {
+        auto chunk = buffer.GetChunk(i - 1);
+        offset -= chunk.GetSampleFrames();
+        auto index = FindLastAudibleFrame(chunk, t);
+        if (index < chunk.GetSampleFrames())
         {
-            sample = bufferCopy.ReadSample(bufferCopy.GetSampleFrames() - index - 1u, channel);
+            last = offset + index;
+            break;
         }
-    );
+    }
+
+    /* Move audible sample frames to the front and shrink the buffer */
+    auto count = last - first + 1;
+
+    if (first > 0)
+    {
+        if (buffer.GetStorage() == WaveBufferStorage::PlanarFloat)
+        {
+            /* Keep the channel arrays at their location, since "SetSampleFrames" moves them afterwards */
+            for (std::uint16_t chn = 0; chn < buffer.GetFormat().channels; ++chn)
+            {
+                auto samples = buffer.ChannelData(chn);
+                std::copy(samples + first, samples + first + count, samples);
+            }
+        }
+        else
+        {
+            auto frameSize = buffer.GetFormat().BytesPerFrame();
+            auto data = buffer.Data();
+            std::copy(data + first * frameSize, data + (first + count) * frameSize, data);
+        }
+    }
+
+    buffer.SetSampleFrames(count);
+
+    return (sampleFrames - count);
 }
 
+/* ----- Filters ----- */
+
 static double NormalDistribution(double x, double mean, double variance)
 {
     return std::exp(-(x - mean)*(x - mean) / (2.0 * variance)) / std::sqrt(2.0 * M_PI * variance);
 }
 
+/*
+Convolves each channel of the buffer with the kernel of the respective channel (the kernels are repeated for the remaining channels).
+Samples outside of the buffer are zero, or the first and last samples of the buffer if 'clampEdges' is true.
+*/
+static void ConvolveChannels(WaveBuffer& buffer, const std::vector<std::vector<float>>& kernels, std::ptrdiff_t delay, bool clampEdges)
+{
+    const auto frames   = buffer.GetSampleFrames();
+    const auto channels = buffer.GetFormat().channels;
+
+    if (frames == 0 || channels == 0 || kernels.empty())
+        return;
+
+    /* Read all samples as floating-points */
+    WaveBufferView view(buffer);
+
+    std::vector<float> samples(frames * channels);
+    view.ReadFrames(0, frames, samples.data());
+
+    std::vector<float> input, output(frames);
+
+    for (std::uint16_t chn = 0; chn < channels; ++chn)
+    {
+        const auto& kernel = kernels[chn % kernels.size()];
+
+        if (kernel.empty())
+        {
+            std::fill(output.begin(), output.end(), 0.0f);
+        }
+        else
+        {
+            /* Gather the padded input of this channel, where 'input[i]' is the sample at index 'i + delay - (kernel.size() - 1)' */
+            input.resize(frames + kernel.size() - 1);
+
+            const auto first = delay - static_cast<std::ptrdiff_t>(kernel.size() - 1);
+            const auto last  = static_cast<std::ptrdiff_t>(frames - 1);
+
+            for (std::size_t i = 0; i < input.size(); ++i)
+            {
+                auto index = first + static_cast<std::ptrdiff_t>(i);
+                if (index >= 0 && index <= last)
+                    input[i] = samples[static_cast<std::size_t>(index) * channels + chn];
+                else if (clampEdges)
+                    input[i] = samples[static_cast<std::size_t>(index < 0 ? 0 : last) * channels + chn];
+                else
+                    input[i] = 0.0f;
+            }
+
+            ConvolveValid(input.data(), frames, kernel.data(), kernel.size(), output.data());
+        }
+
+        for (std::size_t i = 0; i < frames; ++i)
+            samples[i * channels + chn] = output[i];
+    }
+
+    view.WriteFrames(0, frames, samples.data());
+}
+
+AC_EXPORT void ConvolveWaveBuffer(WaveBuffer& buffer, const std::vector<float>& impulseResponse, std::size_t delay)
+{
+    ConvolveChannels(buffer, { impulseResponse }, static_cast<std::ptrdiff_t>(delay), false);
+}
+
+AC_EXPORT void ConvolveWaveBuffer(WaveBuffer& buffer, const WaveBuffer& impulseResponse, std::size_t delay)
+{
+    if (buffer.GetFormat().sampleRate != impulseResponse.GetFormat().sampleRate)
+        throw std::invalid_argument("sample rates of wave buffer and impulse response must be equal for convolution");
+
+    /* Split impulse response into its channels */
+    const auto frames   = impulseResponse.GetSampleFrames();
+    const auto channels = std::max(std::uint16_t(1u), impulseResponse.GetFormat().channels);
+
+    std::vector<std::vector<float>> kernels(channels);
+
+    if (frames > 0 && impulseResponse.GetFormat().channels > 0)
+    {
+        std::vector<float> samples(frames * channels);
+        WaveBufferConstView(impulseResponse).ReadFrames(0, frames, samples.data());
+
+        for (std::uint16_t chn = 0; chn < channels; ++chn)
+        {
+            kernels[chn].resize(frames);
+            for (std::size_t i = 0; i < frames; ++i)
+                kernels[chn][i] = samples[i * channels + chn];
+        }
+    }
+
+    ConvolveChannels(buffer, kernels, static_cast<std::ptrdiff_t>(delay), false);
+}
+
 AC_EXPORT void BlurWaveBuffer(WaveBuffer& buffer, double timeSpread, double variance, std::size_t sampleCount)
 {
+    if (sampleCount == 0)
+        return;
+
     /* Compute weights for the normal distribution */
     static const double maxDistributionSpread = 7.0;
 
@@ -314,25 +498,207 @@ AC_EXPORT void BlurWaveBuffer(WaveBuffer& buffer, double timeSpread, double vari
         weightSum += weights[i];
     }
 
-    /* Normalize weights */
-    weightSum = 1.0 / weightSum;
-    for (auto& weight : weights)
-        weight *= weightSum;
+    /* Determine the sample offset of each weight within the time spread (rounded down, but tolerate rounding errors of the time offsets) */
+    const auto sampleRate = static_cast<double>(buffer.GetFormat().sampleRate);
+
+    std::vector<std::ptrdiff_t> offsets(sampleCount + 1u);
+
+    for (std::size_t i = 0; i <= sampleCount; ++i)
+    {
+        auto timeOffset = timeSpread * (static_cast<double>(i) / sampleCount - 0.5);
+        offsets[i] = static_cast<std::ptrdiff_t>(std::floor(timeOffset * sampleRate + 1.0e-6));
+    }
+
+    const auto offsetMin = *std::min_element(offsets.begin(), offsets.end());
+    const auto offsetMax = *std::max_element(offsets.begin(), offsets.end());
 
-    /* Read from the copy of the buffer to prevent reading and writing on the same buffer */
-    auto bufferCopy = buffer;
-    buffer.ForEachSample(
-        [&](double& sample, std::uint16_t channel, std::size_t index, double timePoint)
+    /* Build the (sparse) kernel with the normalized weights, which reads the sample at 'index + offset' for each weight */
+    std::vector<float> kernel(static_cast<std::size_t>(offsetMax - offsetMin) + 1u, 0.0f);
+
+    for (std::size_t i = 0; i <= sampleCount; ++i)
+        kernel[static_cast<std::size_t>(offsetMax - offsets[i])] += static_cast<float>(weights[i] / weightSum);
+
+    ConvolveChannels(buffer, { kernel }, offsetMax, true);
+}
+
+AC_EXPORT void FilterWaveBuffer(WaveBuffer& buffer, const BiquadType type, double frequency, double q, double gain)
+{
+    const auto& format = buffer.GetFormat();
+    if (buffer.GetSampleFrames() == 0 || format.sampleRate == 0 || format.channels == 0)
+        return;
+
+    BiquadFilterBank filter(format.channels);
+    filter.SetFilter(BiquadCoefficients::Compute(type, format.sampleRate, frequency, q, gain), true);
+    filter.ProcessWaveBuffer(buffer);
+}
+
+AC_EXPORT void ReverbWaveBuffer(WaveBuffer& buffer, const FDNReverbParameters& parameters)
+{
+    const auto& format = buffer.GetFormat();
+    if (buffer.GetSampleFrames() == 0 || format.sampleRate == 0 || format.channels == 0)
+        return;
+
+    FDNReverb reverb(format.sampleRate, format.channels, parameters);
+    reverb.ProcessWaveBuffer(buffer);
+}
+
+AC_EXPORT void ReverbWaveBuffer(WaveBuffer& buffer)
+{
+    ReverbWaveBuffer(buffer, FDNReverbParameters());
+}
+
+AC_EXPORT void CompressWaveBuffer(WaveBuffer& buffer, const CompressorParameters& parameters)
+{
+    const auto& format = buffer.GetFormat();
+    if (buffer.GetSampleFrames() == 0 || format.sampleRate == 0 || format.channels == 0)
+        return;
+
+    Compressor compressor(format.sampleRate, format.channels, parameters);
+    compressor.ProcessWaveBuffer(buffer);
+}
+
+AC_EXPORT void CompressWaveBuffer(WaveBuffer& buffer)
+{
+    CompressWaveBuffer(buffer, CompressorParameters());
+}
+
+/*
+Processes the wave buffer in place with an effect which has a latency, and writes the output back to the positions of the input:
+the read position runs ahead of the write position by the latency, and the input beyond the end of the buffer is silence.
+*/
+static void ProcessWaveBufferWithoutLatency(AudioEffect& effect, WaveBuffer& buffer)
+{
+    static const std::size_t blockSize = WaveBuffer::maxBlockSamples;
+
+    const auto latency  = effect.GetLatency();
+    const auto frames   = buffer.GetSampleFrames();
+    const auto channels = static_cast<std::size_t>(buffer.GetFormat().channels);
+
+    WaveBufferView view(buffer);
+
+    std::vector<float> block(blockSize * channels);
+
+    for (std::size_t readPos = 0; readPos < frames + latency; readPos += blockSize)
+    {
+        const auto n = std::min(blockSize, frames + latency - readPos);
+
+        /* Read input frames and pad them with silence */
+        auto numRead = (readPos < frames ? view.ReadFrames(readPos, std::min(n, frames - readPos), block.data()) : 0);
+        std::fill(block.begin() + numRead * channels, block.begin() + n * channels, 0.0f);
+
+        effect.Process(block.data(), n);
+
+        /* Write output frames, except for the first 'latency' frames which precede the input */
+        auto skip = (readPos < latency ? std::min(n, latency - readPos) : 0);
+        if (skip < n)
         {
-            sample = 0.0;
+            auto writePos = readPos + skip - latency;
+            view.WriteFrames(writePos, std::min(n - skip, frames - writePos), block.data() + skip * channels);
+        }
+    }
+}
 
-            for (std::size_t i = 0; i <= sampleCount; ++i)
-            {
-                auto timeOffset = timeSpread * (static_cast<double>(i) / sampleCount - 0.5);
-                sample += bufferCopy.ReadSample(timePoint + timeOffset, channel) * weights[i];
-            }
+AC_EXPORT void LimitWaveBuffer(WaveBuffer& buffer, const LimiterParameters& parameters, double lookAheadTime)
+{
+    const auto& format = buffer.GetFormat();
+    if (buffer.GetSampleFrames() == 0 || format.sampleRate == 0 || format.channels == 0)
+        return;
+
+    Limiter limiter(format.sampleRate, format.channels, parameters, lookAheadTime);
+    ProcessWaveBufferWithoutLatency(limiter, buffer);
+}
+
+AC_EXPORT void LimitWaveBuffer(WaveBuffer& buffer)
+{
+    LimitWaveBuffer(buffer, LimiterParameters());
+}
+
+AC_EXPORT void DuckWaveBuffer(WaveBuffer& buffer, const WaveBuffer& sidechain, const DuckerParameters& parameters)
+{
+    static const std::size_t blockSize = WaveBuffer::maxBlockSamples;
+
+    const auto& format = buffer.GetFormat();
+    if (buffer.GetSampleFrames() == 0 || format.sampleRate == 0 || format.channels == 0)
+        return;
+
+    const auto& sidechainFormat = sidechain.GetFormat();
+    if (sidechainFormat.sampleRate != format.sampleRate)
+        throw std::invalid_argument("sample rates of wave buffer and sidechain must be equal for ducking");
+
+    if (sidechainFormat.channels == 0)
+        return;
+
+    Ducker ducker(format.sampleRate, format.channels, sidechainFormat.channels, parameters);
+
+    const auto frames = buffer.GetSampleFrames();
+
+    WaveBufferView view(buffer);
+    WaveBufferConstView sidechainView(sidechain);
+
+    std::vector<float> block(blockSize * format.channels);
+    std::vector<float> sidechainBlock(blockSize * sidechainFormat.channels);
+
+    for (std::size_t offset = 0; offset < frames; offset += blockSize)
+    {
+        const auto n = std::min(blockSize, frames - offset);
+
+        /* Read sidechain frames and pad them with silence */
+        auto numSidechain = (offset < sidechainView.GetSampleFrames() ? sidechainView.ReadFrames(offset, n, sidechainBlock.data()) : 0);
+        std::fill(sidechainBlock.begin() + numSidechain * sidechainFormat.channels, sidechainBlock.begin() + n * sidechainFormat.channels, 0.0f);
+
+        view.ReadFrames(offset, n, block.data());
+        ducker.ProcessSidechain(block.data(), sidechainBlock.data(), n);
+        view.WriteFrames(offset, n, block.data());
+    }
+}
+
+AC_EXPORT void DuckWaveBuffer(WaveBuffer& buffer, const WaveBuffer& sidechain)
+{
+    DuckWaveBuffer(buffer, sidechain, DuckerParameters());
+}
+
+/*
+Reads the sample frames of a fading buffer at the sample frames of the output buffer with the specified format,
+like 'ReadSample(timePoint, channel)', i.e. with the nearest index and clamped to the last sample frame.
+*/
+static void ReadFadingFrames(const WaveBuffer& source, const WaveBufferFormat& format, std::size_t indexBegin, std::size_t frames, float* samples)
+{
+    const auto& sourceFormat    = source.GetFormat();
+    const auto  sourceFrames    = source.GetSampleFrames();
+    const auto  channels        = static_cast<std::size_t>(format.channels);
+
+    if (sourceFrames == 0 || sourceFormat.channels == 0)
+    {
+        std::fill(samples, samples + frames * channels, 0.0f);
+        return;
+    }
+
+    if (sourceFormat.sampleRate == format.sampleRate && sourceFormat.channels == format.channels)
+    {
+        /* Read sample frames directly, and repeat the last sample frame beyond the end of the source */
+        WaveBufferConstView view(source);
+
+        auto n = (indexBegin < sourceFrames ? view.ReadFrames(indexBegin, frames, samples) : 0);
+        if (n < frames)
+        {
+            if (n == 0)
+                n = view.ReadFrames(sourceFrames - 1, 1, samples);
+            for (auto i = n; i < frames; ++i)
+                std::copy(samples + (n - 1) * channels, samples + n * channels, samples + i * channels);
         }
-    );
+    }
+    else
+    {
+        /* Look up the samples at the same time points */
+        const auto timeStep = 1.0 / static_cast<double>(format.sampleRate);
+
+        for (std::size_t i = 0; i < frames; ++i)
+        {
+            auto timePoint = static_cast<double>(indexBegin + i) * timeStep;
+            for (std::uint16_t chn = 0; chn < format.channels; ++chn)
+                *(samples++) = static_cast<float>(source.ReadSample(timePoint, std::min(chn, static_cast<std::uint16_t>(sourceFormat.channels - 1))));
+        }
+    }
 }
 
 AC_EXPORT void FadeWaveBuffers(
@@ -341,9 +707,11 @@ AC_EXPORT void FadeWaveBuffers(
     const WaveBuffer&       bufferFadeTo,
     double                  timePointFrom,
     double                  timePointTo,
-    const FadingFunction&   fading,
+    const CrossfadeCurve&   curve,
     bool                    writeOutlines)
 {
+    static const std::size_t blockSize = WaveBuffer::maxBlockSamples;
+
     /* Quit if operation has no effect */
     if ((&buffer) == (&bufferFadeFrom) && (&buffer) == (&bufferFadeTo))
         return;
@@ -352,27 +720,34 @@ AC_EXPORT void FadeWaveBuffers(
     timePointFrom = Gs::Clamp(timePointFrom, 0.0, buffer.GetTotalTime());
     timePointTo = Gs::Clamp(timePointTo, timePointFrom, buffer.GetTotalTime());
 
-    /* Interpolate between the two fading buffers */
-    if (timePointFrom < timePointTo)
+    /* Crossfade between the two fading buffers block by block */
+    const auto& format = buffer.GetFormat();
+
+    if (timePointFrom < timePointTo && format.channels > 0)
     {
-        buffer.ForEachSample(
-            [&](double& sample, std::uint16_t channel, std::size_t index, double timePoint)
-            {
-                /* Compute fading interpolator */
-                double t = (timePoint - timePointFrom) / (timePointTo - timePointFrom);
-                if (fading)
-                    fading(t);
-
-                /* Fade between two buffer samples */
-                sample = Gs::Lerp(
-                    bufferFadeFrom.ReadSample(timePoint, channel),
-                    bufferFadeTo.ReadSample(timePoint, channel),
-                    t
-                );
-            },
-            timePointFrom,
-            timePointTo
-        );
+        /* Fade the sample frames in the range [indexBegin, indexEnd), where the curve position of each sample frame is taken from its time point */
+        const auto indexBegin   = buffer.GetIndexFromTimePoint(timePointFrom);
+        const auto indexEnd     = buffer.GetIndexFromTimePoint(timePointTo) + 1;
+        const auto sampleRate   = static_cast<double>(format.sampleRate);
+        const auto step         = 1.0 / ((timePointTo - timePointFrom) * sampleRate);
+        const auto position     = (static_cast<double>(indexBegin) / sampleRate - timePointFrom) / (timePointTo - timePointFrom);
+
+        WaveBufferView view(buffer);
+
+        std::vector<float> samplesFrom(blockSize * format.channels);
+        std::vector<float> samplesTo(blockSize * format.channels);
+
+        for (auto i = indexBegin; i < indexEnd; i += blockSize)
+        {
+            const auto n = std::min(blockSize, indexEnd - i);
+
+            ReadFadingFrames(bufferFadeFrom, format, i, n, samplesFrom.data());
+            ReadFadingFrames(bufferFadeTo, format, i, n, samplesTo.data());
+
+            curve.Blend(samplesFrom.data(), samplesFrom.data(), samplesTo.data(), n, format.channels, position + step * static_cast<double>(i - indexBegin), step);
+
+            view.WriteFrames(i, n, samplesFrom.data());
+        }
     }
 
     /* Write outlines (if enabled) */
@@ -388,6 +763,18 @@ AC_EXPORT void FadeWaveBuffers(
     }
 }
 
+AC_EXPORT void FadeWaveBuffers(
+    WaveBuffer&             buffer,
+    const WaveBuffer&       bufferFadeFrom,
+    const WaveBuffer&       bufferFadeTo,
+    double                  timePointFrom,
+    double                  timePointTo,
+    const FadingFunction&   fading,
+    bool                    writeOutlines)
+{
+    FadeWaveBuffers(buffer, bufferFadeFrom, bufferFadeTo, timePointFrom, timePointTo, CrossfadeCurve(fading), writeOutlines);
+}
+
 
 } // /namesapce Synthesizer
 
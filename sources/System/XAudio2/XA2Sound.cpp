@@ -142,8 +142,11 @@ double XA2Sound::TotalTime() const
 
 void XA2Sound::AttachBuffer(const WaveBuffer& waveBuffer)
 {
-    /* Create shared copy of wave buffer */
-    CreateSourceVoiceForBuffer(std::make_shared<WaveBuffer>(waveBuffer));
+    /* Create shared copy of wave buffer (convert planar samples into PCM data) */
+    if (waveBuffer.GetStorage() != WaveBufferStorage::Interleaved)
+        CreateSourceVoiceForBuffer(std::make_shared<WaveBuffer>(waveBuffer.Interleaved()));
+    else
+        CreateSourceVoiceForBuffer(std::make_shared<WaveBuffer>(waveBuffer));
 }
 
 void XA2Sound::AttachSharedBuffer(const Sound& sourceBufferSound)
@@ -153,7 +156,7 @@ void XA2Sound::AttachSharedBuffer(const Sound& sourceBufferSound)
     CreateSourceVoiceForBuffer(sourceBufferSoundXA2.waveBuffer_);
 }
 
-void XA2Sound::QueueBuffer(const WaveBuffer& waveBuffer)
+void XA2Sound::QueueBuffer(const WaveBufferConstView& waveBuffer)
 {
 }
 
@@ -215,7 +218,7 @@ void XA2Sound::CreateSourceVoice(const WaveBufferFormat& format, UINT32 flags)
     /* Convert wave buffer format into WAVEFORMATEX structure */
     WAVEFORMATEX sourceFormat;
     {
-        sourceFormat.wFormatTag         = WAVE_FORMAT_PCM;
+        sourceFormat.wFormatTag         = (format.floatingPoint ? WAVE_FORMAT_IEEE_FLOAT : WAVE_FORMAT_PCM);
         sourceFormat.nChannels          = static_cast<WORD>(format.channels);
         sourceFormat.nSamplesPerSec     = static_cast<DWORD>(format.sampleRate);
         sourceFormat.nAvgBytesPerSec    = static_cast<DWORD>(format.BytesPerSecond());
@@ -0,0 +1,263 @@
+/*
+ * Test10_PCMFormats.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "TestUtil.h"
+#include <random>
+#include <sstream>
+#include <cstring>
+
+
+static std::string FormatDesc(const Ac::WaveBufferFormat& format)
+{
+    return std::to_string(format.bitsPerSample) + (format.floatingPoint ? "-bit float, " : "-bit, ") + std::to_string(format.channels) + " channel(s): ";
+}
+
+// Returns one quantization step of the specified format (with a small margin for rounding errors).
+static double Quantization(const Ac::WaveBufferFormat& format)
+{
+    return (format.floatingPoint ? 1.0e-7 : 1.001 * 2.0 / (std::pow(2.0, format.bitsPerSample) - 1.0));
+}
+
+// Returns a wave buffer with random samples.
+static Ac::WaveBuffer GenerateBuffer(const Ac::WaveBufferFormat& format, std::size_t frames)
+{
+    std::mt19937 rng(format.bitsPerSample + format.channels);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+
+    Ac::WaveBuffer buffer(format);
+    buffer.SetSampleFrames(frames);
+
+    for (std::size_t i = 0; i < frames; ++i)
+    {
+        for (std::uint16_t chn = 0; chn < format.channels; ++chn)
+            buffer.WriteSample(i, chn, dist(rng));
+    }
+
+    /* Include the extreme values */
+    buffer.WriteSample(std::size_t(0u), 0, 1.0);
+    buffer.WriteSample(std::size_t(1u), 0, -1.0);
+
+    return buffer;
+}
+
+// Returns true if both wave buffers have the same PCM data.
+static bool EqualData(const Ac::WaveBuffer& lhs, const Ac::WaveBuffer& rhs)
+{
+    return (lhs.BufferSize() == rhs.BufferSize() && std::memcmp(lhs.Data(), rhs.Data(), lhs.BufferSize()) == 0);
+}
+
+static void TestSampleAccess(const Ac::WaveBufferFormat& format)
+{
+    const auto desc = FormatDesc(format);
+
+    Check(format.IsSupported(), desc + "format is supported");
+    Check(format.IsSigned() == (format.bitsPerSample > 8), desc + "signed format");
+
+    auto buffer = GenerateBuffer(format, 300);
+
+    /* Samples keep the precision of the format and are clamped */
+    buffer.WriteSample(std::size_t(10u), 0, 0.123456789);
+    buffer.WriteSample(std::size_t(11u), 0, 1.5);
+    buffer.WriteSample(std::size_t(12u), 0, -1.5);
+
+    CheckNear(buffer.ReadSample(std::size_t(10u), 0), 0.123456789, Quantization(format), desc + "sample precision");
+    CheckNear(buffer.ReadSample(std::size_t(11u), 0), 1.0, Quantization(format), desc + "sample is clamped to 1");
+    CheckNear(buffer.ReadSample(std::size_t(12u), 0), -1.0, Quantization(format), desc + "sample is clamped to -1");
+
+    /* Bulk conversion must equal the scalar conversion, including the tails of the vector kernels */
+    double maxReadError = 0.0, maxWriteError = 0.0;
+
+    for (std::size_t len = 1; len <= 70; ++len)
+    {
+        std::vector<double> samples(len * format.channels);
+        buffer.ReadFrames(3, len, samples.data());
+
+        for (std::size_t i = 0; i < len; ++i)
+        {
+            for (std::uint16_t chn = 0; chn < format.channels; ++chn)
+                maxReadError = std::max(maxReadError, std::abs(samples[i*format.channels + chn] - buffer.ReadSample(3 + i, chn)));
+        }
+
+        for (auto& s : samples)
+            s = s * 0.75 + 0.1;
+
+        auto bufferFrames = buffer;
+        auto bufferScalar = buffer;
+        bufferFrames.WriteFrames(3, len, samples.data());
+
+        for (std::size_t i = 0; i < len; ++i)
+        {
+            for (std::uint16_t chn = 0; chn < format.channels; ++chn)
+                bufferScalar.WriteSample(3 + i, chn, samples[i*format.channels + chn]);
+        }
+
+        for (std::size_t i = 0; i < len + 6; ++i)
+        {
+            for (std::uint16_t chn = 0; chn < format.channels; ++chn)
+                maxWriteError = std::max(maxWriteError, std::abs(bufferFrames.ReadSample(i, chn) - bufferScalar.ReadSample(i, chn)));
+        }
+    }
+
+    CheckNear(maxReadError, 0.0, 1.0e-6, desc + "ReadFrames equals ReadSample");
+    CheckNear(maxWriteError, 0.0, Quantization(format), desc + "WriteFrames equals WriteSample");
+
+    /* Swapping the byte order twice must reproduce the PCM data */
+    auto swapped = buffer;
+    swapped.SwapEndianness();
+    if (format.bitsPerSample > 8)
+        Check(!EqualData(swapped, buffer), desc + "SwapEndianness changes the PCM data");
+    swapped.SwapEndianness();
+    Check(EqualData(swapped, buffer), desc + "SwapEndianness twice reproduces the PCM data");
+}
+
+// Returns the little-endian integer at the specified byte offset of the data.
+static std::uint32_t ReadLE(const std::string& data, std::size_t offset, std::size_t size)
+{
+    std::uint32_t value = 0;
+    for (std::size_t i = 0; i < size && offset + i < data.size(); ++i)
+        value |= static_cast<std::uint32_t>(static_cast<std::uint8_t>(data[offset + i])) << (i * 8);
+    return value;
+}
+
+// Returns the byte offset of the content of the specified RIFF chunk, or zero if there is no such chunk.
+static std::size_t FindChunk(const std::string& data, const std::string& chunkID)
+{
+    for (std::size_t offset = 12; offset + 8 <= data.size(); offset += 8 + ((ReadLE(data, offset + 4, 4) + 1) & ~1u))
+    {
+        if (data.compare(offset, 4, chunkID) == 0)
+            return offset + 8;
+    }
+    return 0;
+}
+
+static void TestWAVHeader(const Ac::WaveBufferFormat& format, const std::string& data, std::size_t frames)
+{
+    const auto desc = "WAV header " + FormatDesc(format);
+
+    /* Integer samples with more than 16 bits and more than 2 channels require the extensible format */
+    const bool extensible = ((!format.floatingPoint && format.bitsPerSample > 16) || format.channels > 2);
+    const std::uint16_t subFormatTag = (format.floatingPoint ? 0x0003 : 0x0001);
+
+    Check(data.compare(0, 4, "RIFF") == 0 && data.compare(8, 4, "WAVE") == 0, desc + "RIFF WAVE header");
+    Check(ReadLE(data, 4, 4) == data.size() - 8, desc + "RIFF size");
+
+    auto fmt = FindChunk(data, "fmt ");
+    Check(fmt > 0, desc + "format chunk");
+
+    const auto fmtSize = ReadLE(data, fmt - 4, 4);
+    const auto formatTag = ReadLE(data, fmt, 2);
+
+    Check(ReadLE(data, fmt + 2, 2) == format.channels, desc + "number of channels");
+    Check(ReadLE(data, fmt + 14, 2) == format.bitsPerSample, desc + "bits per sample");
+
+    if (extensible)
+    {
+        /* Extension with the actual format tag in the sub format GUID "xxxxxxxx-0000-0010-8000-00aa00389b71" */
+        static const unsigned char guid[] = { 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0xaa, 0x00, 0x38, 0x9b, 0x71 };
+
+        std::uint32_t channelMask = 0;
+        switch (format.channels)
+        {
+            case 1: channelMask = 0x04; break;
+            case 2: channelMask = 0x03; break;
+            case 4: channelMask = 0x33; break;
+        }
+
+        Check(formatTag == 0xfffe && fmtSize == 40, desc + "extensible format");
+        Check(ReadLE(data, fmt + 16, 2) == 22, desc + "extension size");
+        Check(ReadLE(data, fmt + 18, 2) == format.bitsPerSample, desc + "valid bits per sample");
+        Check(ReadLE(data, fmt + 20, 4) == channelMask, desc + "channel mask");
+        Check(ReadLE(data, fmt + 24, 2) == subFormatTag && data.compare(fmt + 26, 14, std::string(guid, guid + 14)) == 0, desc + "sub format GUID");
+    }
+    else if (format.floatingPoint)
+    {
+        Check(formatTag == 0x0003 && fmtSize == 18, desc + "IEEE float format");
+        Check(ReadLE(data, fmt + 16, 2) == 0, desc + "empty extension size");
+    }
+    else
+        Check(formatTag == 0x0001 && fmtSize == 16, desc + "PCM format");
+
+    /* Formats other than integer PCM require the "fact" chunk with the number of sample frames */
+    auto fact = FindChunk(data, "fact");
+    if (format.floatingPoint)
+        Check(fact > 0 && ReadLE(data, fact - 4, 4) == 4 && ReadLE(data, fact, 4) == frames, desc + "fact chunk");
+    else
+        Check(fact == 0, desc + "no fact chunk");
+
+    auto dataChunk = FindChunk(data, "data");
+    Check(dataChunk > 0 && ReadLE(data, dataChunk - 4, 4) == frames * format.BytesPerFrame(), desc + "data chunk");
+}
+
+static void TestWAVRoundTrip(const Ac::WaveBufferFormat& format)
+{
+    const auto desc = "WAV " + FormatDesc(format);
+
+    FileAudioSystem audioSystem;
+
+    const auto buffer = GenerateBuffer(format, 1234);
+
+    /* Write to and read from a RIFF WAVE stream */
+    std::stringstream stream(std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+    Check(audioSystem.WriteAudioBuffer(Ac::AudioFormats::WAVE, stream, buffer), desc + "buffer has been written");
+
+    TestWAVHeader(format, stream.str(), buffer.GetSampleFrames());
+
+    stream.seekg(0);
+    Check(Ac::AudioSystem::DetermineAudioFormat(stream) == Ac::AudioFormats::WAVE, desc + "stream is a RIFF WAVE stream");
+
+    stream.seekg(0);
+    auto result = audioSystem.ReadWaveBuffer(stream);
+
+    const auto& resultFormat = result.GetFormat();
+
+    Check(
+        resultFormat.sampleRate     == format.sampleRate    &&
+        resultFormat.bitsPerSample  == format.bitsPerSample &&
+        resultFormat.channels       == format.channels      &&
+        resultFormat.floatingPoint  == format.floatingPoint,
+        desc + "format is reproduced"
+    );
+    Check(result.GetSampleFrames() == buffer.GetSampleFrames(), desc + "number of sample frames is reproduced");
+    Check(EqualData(result, buffer), desc + "PCM data is reproduced");
+}
+
+int main()
+{
+    try
+    {
+        const Ac::WaveBufferFormat formats[] =
+        {
+            Ac::WaveBufferFormat(44100,  8, 1),
+            Ac::WaveBufferFormat(44100, 16, 2),
+            Ac::WaveBufferFormat(48000, 24, 1),
+            Ac::WaveBufferFormat(48000, 24, 2),
+            Ac::WaveBufferFormat(96000, 32, 1),
+            Ac::WaveBufferFormat(96000, 32, 2),
+            Ac::WaveBufferFormat(44100, 32, 1, true),
+            Ac::WaveBufferFormat(44100, 32, 2, true),
+            Ac::WaveBufferFormat(44100, 16, 4),
+            Ac::WaveBufferFormat(22050, 24, 6),
+            Ac::WaveBufferFormat(48000, 32, 6, true),
+        };
+
+        for (const auto& format : formats)
+        {
+            TestSampleAccess(format);
+            TestWAVRoundTrip(format);
+        }
+
+        Check(!Ac::WaveBufferFormat(44100, 12, 1).IsSupported(), "12-bit format is not supported");
+        Check(!Ac::WaveBufferFormat(44100, 16, 1, true).IsSupported(), "16-bit float format is not supported");
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return CheckResult();
+}
@@ -0,0 +1,126 @@
+/*
+ * Test11_Resampler.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "TestUtil.h"
+
+
+// Returns the amplitude of the specified frequency within the channel of the interleaved samples (without the first and last 'skip' sample frames).
+static double MeasureAmplitude(const std::vector<float>& samples, std::uint16_t channel, std::uint16_t channels, double frequency, double sampleRate, std::size_t skip)
+{
+    double re = 0.0, im = 0.0;
+    std::size_t n = 0;
+
+    for (std::size_t i = skip; i + skip < samples.size() / channels; ++i, ++n)
+    {
+        auto angle = 2.0 * M_PI * frequency * static_cast<double>(i) / sampleRate;
+        re += samples[i*channels + channel] * std::cos(angle);
+        im += samples[i*channels + channel] * std::sin(angle);
+    }
+
+    return 2.0 * std::sqrt(re*re + im*im) / static_cast<double>(n);
+}
+
+static std::vector<float> GenerateStereoSines(std::uint32_t sampleRate, std::size_t frames, double frequencyLeft, double frequencyRight)
+{
+    std::vector<float> samples(frames * 2);
+
+    for (std::size_t i = 0; i < frames; ++i)
+    {
+        auto t = static_cast<double>(i) / sampleRate;
+        samples[i*2    ] = static_cast<float>(0.5 * std::sin(2.0 * M_PI * frequencyLeft * t));
+        samples[i*2 + 1] = static_cast<float>(0.5 * std::sin(2.0 * M_PI * frequencyRight * t));
+    }
+
+    return samples;
+}
+
+static void TestResampler(std::uint32_t inputRate, std::uint32_t outputRate)
+{
+    const std::size_t frames = inputRate;
+
+    /* Left: 1 kHz tone, right: tone at 45% of the input rate (above the output Nyquist frequency when downsampling) */
+    const double frequencyLeft  = 1000.0;
+    const double frequencyRight = 0.45 * inputRate;
+
+    auto input = GenerateStereoSines(inputRate, frames, frequencyLeft, frequencyRight);
+
+    /* Resample in odd-sized blocks and at once */
+    Ac::Resampler resampler(inputRate, outputRate, 2);
+    std::vector<float> streamed, whole;
+
+    for (std::size_t i = 0; i < frames; i += 777)
+        resampler.Process(input.data() + i*2, std::min(std::size_t(777u), frames - i), streamed);
+    resampler.Flush(streamed);
+
+    Ac::Resampler resamplerWhole(inputRate, outputRate, 2);
+    resamplerWhole.Process(input.data(), frames, whole);
+    resamplerWhole.Flush(whole);
+
+    const auto desc = std::to_string(inputRate) + " Hz -> " + std::to_string(outputRate) + " Hz: ";
+
+    Check(streamed.size() / 2 == resampler.GetOutputFrames(frames), desc + "number of output frames");
+    Check(streamed == whole, desc + "block-wise output equals output at once");
+
+    /* The pass-band tone must keep its amplitude and match the analytic sine */
+    CheckNear(MeasureAmplitude(streamed, 0, 2, frequencyLeft, outputRate, 100), 0.5, 0.001, desc + "amplitude of 1 kHz tone");
+
+    double maxError = 0.0;
+    for (std::size_t i = 100; i + 100 < streamed.size() / 2; ++i)
+    {
+        auto expected = 0.5 * std::sin(2.0 * M_PI * frequencyLeft * static_cast<double>(i) / outputRate);
+        maxError = std::max(maxError, std::abs(streamed[i*2] - expected));
+    }
+    CheckNear(maxError, 0.0, 0.0001, desc + "max. error of 1 kHz tone");
+
+    /* The tone above the output Nyquist frequency must be filtered instead of aliased */
+    if (frequencyRight > outputRate / 2)
+        CheckNear(MeasureAmplitude(streamed, 1, 2, outputRate - frequencyRight, outputRate, 100), 0.0, 0.001, desc + "amplitude of aliased tone");
+}
+
+static void TestWaveBufferSetFormat()
+{
+    /* Convert 48 kHz stereo into 44.1 kHz mono */
+    Ac::WaveBuffer buffer(Ac::WaveBufferFormat(48000, 16, 2));
+    buffer.SetSampleFrames(48000);
+    buffer.ForEachSample(
+        [](double& sample, std::uint16_t /*channel*/, std::size_t /*index*/, double timePoint)
+        {
+            sample = 0.5 * std::sin(2.0 * M_PI * 440.0 * timePoint);
+        }
+    );
+
+    buffer.SetFormat(Ac::WaveBufferFormat(44100, 16, 1));
+
+    Check(buffer.GetSampleFrames() == 44100, "SetFormat: number of sample frames");
+    Check(buffer.GetFormat().channels == 1, "SetFormat: number of channels");
+
+    double maxError = 0.0;
+    for (std::size_t i = 100; i + 100 < buffer.GetSampleFrames(); ++i)
+    {
+        auto expected = 0.5 * std::sin(2.0 * M_PI * 440.0 * static_cast<double>(i) / 44100.0);
+        maxError = std::max(maxError, std::abs(buffer.ReadSample(i, 0) - expected));
+    }
+    CheckNear(maxError, 0.0, 0.0001, "SetFormat: max. error of 440 Hz tone");
+}
+
+int main()
+{
+    try
+    {
+        TestResampler(48000, 44100);
+        TestResampler(44100, 48000);
+        TestResampler(48000, 16000);
+        TestWaveBufferSetFormat();
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return CheckResult();
+}
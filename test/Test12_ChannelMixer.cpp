@@ -0,0 +1,245 @@
+/*
+ * Test12_ChannelMixer.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "TestUtil.h"
+#include <random>
+
+
+static const double minus3dB = 0.70710678;
+
+// Returns random interleaved samples.
+static std::vector<float> GenerateSamples(std::uint16_t channels, std::size_t frames)
+{
+    std::mt19937 rng(channels);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+
+    std::vector<float> samples(frames * channels);
+    for (auto& s : samples)
+        s = dist(rng);
+
+    return samples;
+}
+
+// Checks the gains of the mixer against the expected row-major matrix.
+static void CheckMatrix(const Ac::ChannelMixer& mixer, const std::vector<double>& expected, const std::string& desc)
+{
+    double maxError = 0.0;
+
+    for (std::uint16_t outChn = 0; outChn < mixer.GetOutputChannels(); ++outChn)
+    {
+        for (std::uint16_t inChn = 0; inChn < mixer.GetInputChannels(); ++inChn)
+        {
+            auto gain = static_cast<double>(mixer.GetGain(outChn, inChn));
+            maxError = std::max(maxError, std::abs(gain - expected[outChn * mixer.GetInputChannels() + inChn]));
+        }
+    }
+
+    CheckNear(maxError, 0.0, 1.0e-6, desc + ": gain matrix");
+}
+
+// Checks the interleaved and planar output of the mixer against the matrix multiplication.
+static void CheckProcess(Ac::ChannelMixer& mixer, const std::string& desc)
+{
+    const auto inChannels   = mixer.GetInputChannels();
+    const auto outChannels  = mixer.GetOutputChannels();
+    const std::size_t frames = 1000;
+
+    const auto input = GenerateSamples(inChannels, frames);
+
+    /* Interleaved samples */
+    std::vector<float> output(frames * outChannels);
+    mixer.Process(input.data(), frames, output.data());
+
+    double maxError = 0.0;
+    for (std::size_t i = 0; i < frames; ++i)
+    {
+        for (std::uint16_t outChn = 0; outChn < outChannels; ++outChn)
+        {
+            double expected = 0.0;
+            for (std::uint16_t inChn = 0; inChn < inChannels; ++inChn)
+                expected += static_cast<double>(mixer.GetGain(outChn, inChn)) * input[i*inChannels + inChn];
+            maxError = std::max(maxError, std::abs(output[i*outChannels + outChn] - expected));
+        }
+    }
+    CheckNear(maxError, 0.0, 1.0e-5, desc + ": interleaved output");
+
+    /* Planar samples */
+    std::vector<std::vector<float>> inputPlanes(inChannels, std::vector<float>(frames));
+    std::vector<std::vector<float>> outputPlanes(outChannels, std::vector<float>(frames));
+    std::vector<const float*> inputs;
+    std::vector<float*> outputs;
+
+    for (std::uint16_t chn = 0; chn < inChannels; ++chn)
+    {
+        for (std::size_t i = 0; i < frames; ++i)
+            inputPlanes[chn][i] = input[i*inChannels + chn];
+        inputs.push_back(inputPlanes[chn].data());
+    }
+    for (auto& plane : outputPlanes)
+        outputs.push_back(plane.data());
+
+    mixer.ProcessPlanar(inputs.data(), frames, outputs.data());
+
+    bool planarEqual = true;
+    for (std::size_t i = 0; i < frames; ++i)
+    {
+        for (std::uint16_t chn = 0; chn < outChannels; ++chn)
+        {
+            if (outputPlanes[chn][i] != output[i*outChannels + chn])
+                planarEqual = false;
+        }
+    }
+    Check(planarEqual, desc + ": planar output equals interleaved output");
+}
+
+static void TestStandardMatrices()
+{
+    /* Mono to stereo: the center speaker is folded into left and right with -3 dB */
+    Ac::ChannelMixer monoToStereo(1, 2);
+    CheckMatrix(monoToStereo, { minus3dB, minus3dB }, "mono to stereo");
+    CheckProcess(monoToStereo, "mono to stereo");
+
+    /* Stereo to mono: left and right are folded into the center with -3 dB, then the row is normalized */
+    Ac::ChannelMixer stereoToMono(2, 1);
+    CheckMatrix(stereoToMono, { 0.5, 0.5 }, "stereo to mono");
+    CheckProcess(stereoToMono, "stereo to mono");
+
+    /* 5.1 to stereo: center and rear speakers are folded with -3 dB, LFE is dropped, rows are normalized */
+    const double sum = 1.0 + 2.0 * minus3dB;
+    const double f = 1.0 / sum, c = minus3dB / sum;
+
+    Ac::ChannelMixer surroundToStereo(6, 2);
+    CheckMatrix(
+        surroundToStereo,
+        {
+            // FL  FC  FR   RL   RR   LFE
+               f,  c,  0.0, c,   0.0, 0.0,  // Left
+               0.0, c, f,   0.0, c,   0.0,  // Right
+        },
+        "5.1 to stereo"
+    );
+    CheckProcess(surroundToStereo, "5.1 to stereo");
+
+    /* Full-scale input must not clip */
+    const std::vector<float> fullScale(6, 1.0f);
+    float stereo[2] = { 0.0f, 0.0f };
+    surroundToStereo.Process(fullScale.data(), 1, stereo);
+    CheckNear(stereo[0], 1.0, 1.0e-6, "5.1 to stereo: full-scale input in left channel");
+    CheckNear(stereo[1], 1.0, 1.0e-6, "5.1 to stereo: full-scale input in right channel");
+
+    /* Equal channel counts and unknown layouts are mapped one-to-one */
+    Ac::ChannelMixer identity(6, 6);
+    CheckMatrix(identity, std::vector<double>{ 1,0,0,0,0,0, 0,1,0,0,0,0, 0,0,1,0,0,0, 0,0,0,1,0,0, 0,0,0,0,1,0, 0,0,0,0,0,1 }, "identity");
+    CheckProcess(identity, "identity");
+
+    Ac::ChannelMixer unknownLayout(10, 9);
+    CheckNear(unknownLayout.GetGain(8, 8), 1.0, 0.0, "unknown layout: channels are mapped one-to-one");
+    CheckNear(unknownLayout.GetGain(8, 9), 0.0, 0.0, "unknown layout: extra channel is dropped");
+
+    /* 7.1 to 5.1 must keep the LFE channel */
+    Ac::ChannelMixer surround71To51(8, 6);
+    CheckNear(surround71To51.GetGain(Ac::ChannelTypes5_1::LFE, Ac::ChannelTypes7_1::LFE), 1.0, 1.0e-6, "7.1 to 5.1: LFE channel is kept");
+    CheckProcess(surround71To51, "7.1 to 5.1");
+}
+
+static void TestCustomMatrix()
+{
+    /* Swap left and right */
+    Ac::ChannelMixer swap(2, 2, { 0.0f, 1.0f, 1.0f, 0.0f });
+    CheckProcess(swap, "custom matrix");
+
+    swap.SetGain(0, 0, 0.25f);
+    CheckNear(swap.GetGain(0, 0), 0.25, 0.0, "SetGain");
+    CheckNear(swap.GetGain(5, 0), 0.0, 0.0, "GetGain out of range");
+
+    bool thrown = false;
+    try
+    {
+        Ac::ChannelMixer invalid(2, 2, { 1.0f, 0.0f, 0.0f });
+    }
+    catch (const std::invalid_argument&)
+    {
+        thrown = true;
+    }
+    Check(thrown, "invalid matrix size throws std::invalid_argument");
+
+    thrown = false;
+    try
+    {
+        Ac::ChannelMixer invalid(0, 2);
+    }
+    catch (const std::invalid_argument&)
+    {
+        thrown = true;
+    }
+    Check(thrown, "zero channels throw std::invalid_argument");
+}
+
+static void TestWaveBufferRemix()
+{
+    Ac::WaveBuffer buffer(Ac::WaveBufferFormat(44100, 16, 1));
+    buffer.SetSampleFrames(3000);
+    buffer.ForEachSample(
+        [](double& sample, std::uint16_t /*channel*/, std::size_t index, double /*timePoint*/)
+        {
+            sample = 0.8 * std::sin(0.01 * static_cast<double>(index));
+        }
+    );
+
+    const auto mono = buffer;
+
+    /* Mono to stereo with the standard matrix */
+    buffer.SetChannels(2);
+    Check(buffer.GetFormat().channels == 2, "SetChannels: number of channels");
+    Check(buffer.GetSampleFrames() == mono.GetSampleFrames(), "SetChannels: number of sample frames");
+
+    double maxError = 0.0;
+    for (std::size_t i = 0; i < buffer.GetSampleFrames(); ++i)
+    {
+        auto expected = minus3dB * mono.ReadSample(i, 0);
+        maxError = std::max(maxError, std::abs(buffer.ReadSample(i, 0) - expected));
+        maxError = std::max(maxError, std::abs(buffer.ReadSample(i, 1) - expected));
+    }
+    CheckNear(maxError, 0.0, 1.0e-4, "SetChannels: mono to stereo");
+
+    /* Custom matrix: left channel only */
+    Ac::ChannelMixer leftOnly(2, 2, { 1.0f, 0.0f, 0.0f, 0.0f });
+    buffer.RemixChannels(leftOnly);
+
+    double rightPeak = 0.0;
+    for (std::size_t i = 0; i < buffer.GetSampleFrames(); ++i)
+        rightPeak = std::max(rightPeak, std::abs(buffer.ReadSample(i, 1)));
+    CheckNear(rightPeak, 0.0, 1.0e-4, "RemixChannels: custom matrix");
+
+    bool thrown = false;
+    try
+    {
+        buffer.RemixChannels(Ac::ChannelMixer(6, 2));
+    }
+    catch (const std::invalid_argument&)
+    {
+        thrown = true;
+    }
+    Check(thrown, "RemixChannels: mismatching mixer throws std::invalid_argument");
+}
+
+int main()
+{
+    try
+    {
+        TestStandardMatrices();
+        TestCustomMatrix();
+        TestWaveBufferRemix();
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return CheckResult();
+}
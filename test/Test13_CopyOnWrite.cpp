@@ -0,0 +1,100 @@
+/*
+ * Test13_CopyOnWrite.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "TestUtil.h"
+
+
+static Ac::WaveBuffer GenerateRamp(std::size_t frames)
+{
+    Ac::WaveBuffer buffer(Ac::WaveBufferFormat(44100, 16, 2));
+    buffer.SetSampleFrames(frames);
+
+    for (std::size_t i = 0; i < frames; ++i)
+    {
+        buffer.WriteSample(i, 0, static_cast<double>(i) / frames - 0.5);
+        buffer.WriteSample(i, 1, 0.5 - static_cast<double>(i) / frames);
+    }
+
+    return buffer;
+}
+
+// Returns true if both wave buffers have the same format and PCM data.
+static bool EqualSamples(const Ac::WaveBuffer& lhs, const Ac::WaveBuffer& rhs)
+{
+    return
+    (
+        lhs.GetFormat() == rhs.GetFormat() &&
+        lhs.BufferSize() == rhs.BufferSize() &&
+        std::equal(lhs.Data(), lhs.Data() + lhs.BufferSize(), rhs.Data())
+    );
+}
+
+static void TestCopy()
+{
+    auto original = GenerateRamp(1000);
+    const auto reference = GenerateRamp(1000);
+
+    Check(!original.IsShared(), "new wave buffer is not shared");
+
+    /* Copies share the samples until one of them is written */
+    auto copy = original;
+    Check(original.IsShared() && copy.IsShared(), "copy shares the samples");
+    Check(static_cast<const Ac::WaveBuffer&>(copy).Data() == static_cast<const Ac::WaveBuffer&>(original).Data(), "copy refers to the same PCM data");
+    Check(EqualSamples(copy, original), "copy has equal samples");
+
+    copy.WriteSample(std::size_t(500u), 0, 0.25);
+    Check(!original.IsShared() && !copy.IsShared(), "write access unshares the samples");
+    Check(static_cast<const Ac::WaveBuffer&>(copy).Data() != static_cast<const Ac::WaveBuffer&>(original).Data(), "copy refers to its own PCM data after write access");
+    CheckNear(copy.ReadSample(std::size_t(500u), 0), 0.25, 1.0 / 32767, "written sample of copy");
+    Check(EqualSamples(original, reference), "original is unchanged after write access to copy");
+
+    /* Writing the original must leave the copy unchanged as well */
+    auto copy2 = original;
+    original.SetSampleFrames(10);
+    Check(copy2.GetSampleFrames() == 1000 && EqualSamples(copy2, reference), "copy is unchanged after resizing the original");
+}
+
+static void TestAssignment()
+{
+    auto a = GenerateRamp(100);
+    auto b = GenerateRamp(200);
+    const auto reference = GenerateRamp(100);
+
+    /* Assignment shares the samples and releases the previous ones */
+    b = a;
+    Check(a.IsShared() && b.IsShared(), "assignment shares the samples");
+    Check(b.GetSampleFrames() == 100, "assignment copies the number of sample frames");
+
+    /* Moving transfers the shared samples */
+    auto c = std::move(b);
+    Check(a.IsShared() && c.IsShared(), "move keeps the samples shared");
+
+    c.SetFormat(Ac::WaveBufferFormat(44100, 8, 2));
+    Check(!a.IsShared() && !c.IsShared(), "format change unshares the samples");
+    Check(EqualSamples(a, reference), "original is unchanged after format change of copy");
+
+    /* Non-constant Data() unshares the samples as well */
+    auto d = a;
+    d.Data()[0] = 0x7f;
+    Check(!a.IsShared() && EqualSamples(a, reference), "non-constant Data() unshares the samples");
+}
+
+int main()
+{
+    try
+    {
+        TestCopy();
+        TestAssignment();
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return CheckResult();
+}
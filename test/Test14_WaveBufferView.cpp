@@ -0,0 +1,151 @@
+/*
+ * Test14_WaveBufferView.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "TestUtil.h"
+
+
+// Returns a stereo wave buffer with a deterministic test signal.
+static Ac::WaveBuffer GenerateBuffer(const Ac::WaveBufferStorage storage)
+{
+    Ac::WaveBuffer buffer(Ac::WaveBufferFormat(44100, 16, 2), storage);
+    buffer.SetSampleFrames(1000);
+
+    for (std::size_t i = 0; i < 1000; ++i)
+    {
+        buffer.WriteSample(i, 0, 0.9 * std::sin(0.02 * static_cast<double>(i)));
+        buffer.WriteSample(i, 1, 0.5 * std::cos(0.03 * static_cast<double>(i)));
+    }
+
+    return buffer;
+}
+
+// Returns the maximal difference between the samples of the view and the samples of the buffer at the specified offset.
+static double MaxDifference(const Ac::WaveBufferConstView& view, const Ac::WaveBuffer& buffer, std::size_t offset)
+{
+    double maxError = 0.0;
+
+    for (std::size_t i = 0; i < view.GetSampleFrames(); ++i)
+    {
+        for (std::uint16_t chn = 0; chn < view.GetFormat().channels; ++chn)
+            maxError = std::max(maxError, std::abs(view.ReadSample(i, chn) - buffer.ReadSample(offset + i, chn)));
+    }
+
+    return maxError;
+}
+
+static void TestSliceBounds(const Ac::WaveBufferStorage storage, const std::string& desc)
+{
+    const auto buffer = GenerateBuffer(storage);
+
+    /* View onto a range within the buffer */
+    Ac::WaveBufferConstView view(buffer, 100, 300);
+
+    Check(view.GetSampleFrames() == 300, desc + "number of sample frames");
+    Check(view.GetStorage() == storage, desc + "storage of the view");
+    CheckNear(view.GetTotalTime(), 300.0 / 44100.0, 1.0e-12, desc + "total time");
+    CheckNear(MaxDifference(view, buffer, 100), 0.0, 0.0, desc + "samples equal the buffer samples at the offset");
+    CheckNear(view.ReadSample(std::size_t(300u), 0), 0.0, 0.0, desc + "sample behind the view is zero");
+    CheckNear(view.ReadSample(std::size_t(0u), 2), 0.0, 0.0, desc + "sample of an invalid channel is zero");
+
+    /* Ranges are clamped to the buffer */
+    Check(Ac::WaveBufferConstView(buffer, 900, 500).GetSampleFrames() == 100, desc + "range is clamped to the end of the buffer");
+    Check(Ac::WaveBufferConstView(buffer, 2000, 10).GetSampleFrames() == 0, desc + "range behind the buffer is empty");
+    Check(Ac::WaveBufferConstView(buffer).GetSampleFrames() == 1000, desc + "view onto the entire buffer");
+
+    /* Subviews are relative to the view and clamped to it */
+    auto subview = view.Subview(50, 1000);
+    Check(subview.GetSampleFrames() == 250, desc + "subview is clamped to the view");
+    CheckNear(MaxDifference(subview, buffer, 150), 0.0, 0.0, desc + "subview samples");
+    Check(view.Subview(300, 1).GetSampleFrames() == 0, desc + "subview behind the view is empty");
+
+    /* Frame access is clamped to the view */
+    std::vector<double> samples(40);
+    Check(view.ReadFrames(290, 20, samples.data()) == 10, desc + "ReadFrames is clamped to the view");
+    Check(view.ReadFrames(300, 1, samples.data()) == 0, desc + "ReadFrames behind the view");
+    CheckNear(samples[0], buffer.ReadSample(std::size_t(390u), 0), 1.0e-6, desc + "ReadFrames samples");
+
+    /* Channel data */
+    if (storage == Ac::WaveBufferStorage::PlanarFloat)
+        Check(view.ChannelData(1) == buffer.ChannelData(1) + 100, desc + "channel data points into the buffer");
+    else
+        Check(view.ChannelData(1) == nullptr && view.Data() == buffer.Data() + 100 * 4, desc + "data points into the buffer");
+
+    /* Copy of the referenced samples */
+    auto copy = subview.ToWaveBuffer();
+    Check(copy.GetSampleFrames() == 250 && copy.GetStorage() == storage, desc + "ToWaveBuffer: number of sample frames and storage");
+    CheckNear(MaxDifference(Ac::WaveBufferConstView(copy), buffer, 150), 0.0, 0.0, desc + "ToWaveBuffer: samples");
+}
+
+static void TestWriteThroughView(const Ac::WaveBufferStorage storage, const std::string& desc)
+{
+    auto buffer = GenerateBuffer(storage);
+    const auto original = buffer;
+
+    /* Write single samples and frames through a view and a subview */
+    Ac::WaveBufferView view(buffer, 100, 300);
+    view.WriteSample(std::size_t(5u), 1, 0.5);
+    view.WriteSample(std::size_t(300u), 0, 0.5);
+
+    const double frames[] = { 0.25, -0.25, 0.75, -0.75, 0.1, -0.1 };
+    auto subview = view.Subview(200, 100);
+    Check(subview.WriteFrames(98, 3, frames) == 2, desc + "WriteFrames is clamped to the subview");
+
+    CheckNear(buffer.ReadSample(std::size_t(105u), 1), 0.5, 1.0e-4, desc + "WriteSample reaches the parent buffer");
+    CheckNear(buffer.ReadSample(std::size_t(398u), 0), 0.25, 1.0e-4, desc + "WriteFrames reaches the parent buffer (1)");
+    CheckNear(buffer.ReadSample(std::size_t(399u), 1), -0.75, 1.0e-4, desc + "WriteFrames reaches the parent buffer (2)");
+
+    /* All other samples must be unchanged, in particular the one behind the view and behind the subview */
+    double maxError = 0.0;
+    for (std::size_t i = 0; i < 1000; ++i)
+    {
+        if (i == 105 || i == 398 || i == 399)
+            continue;
+        for (std::uint16_t chn = 0; chn < 2; ++chn)
+            maxError = std::max(maxError, std::abs(buffer.ReadSample(i, chn) - original.ReadSample(i, chn)));
+    }
+    CheckNear(maxError, 0.0, 0.0, desc + "samples outside of the written range are unchanged");
+
+    /* Views onto a shared buffer must not modify the other copies */
+    auto shared = buffer;
+    Ac::WaveBufferView sharedView(shared, 0, 10);
+    sharedView.WriteSample(std::size_t(0u), 0, -0.5);
+    CheckNear(shared.ReadSample(std::size_t(0u), 0), -0.5, 1.0e-4, desc + "write through view onto a shared buffer");
+    CheckNear(buffer.ReadSample(std::size_t(0u), 0), original.ReadSample(std::size_t(0u), 0), 0.0, desc + "copy of the shared buffer is unchanged");
+}
+
+static void TestExternalMemory()
+{
+    std::vector<std::int16_t> data(200, 0);
+
+    Ac::WaveBufferView view(Ac::WaveBufferFormat(22050, 16, 2), data.data(), 100);
+    Check(view.GetSampleFrames() == 100, "external memory: number of sample frames");
+
+    view.WriteSample(std::size_t(10u), 1, 1.0);
+    Check(data[21] == 32767, "external memory: write reaches the memory");
+    CheckNear(view.ReadSample(std::size_t(10u), 1), 1.0, 0.0, "external memory: read");
+
+    Check(Ac::WaveBufferConstView(Ac::WaveBufferFormat(), nullptr, 100).GetSampleFrames() == 0, "null memory is empty");
+}
+
+int main()
+{
+    try
+    {
+        TestSliceBounds(Ac::WaveBufferStorage::Interleaved, "interleaved: ");
+        TestSliceBounds(Ac::WaveBufferStorage::PlanarFloat, "planar: ");
+        TestWriteThroughView(Ac::WaveBufferStorage::Interleaved, "interleaved: ");
+        TestWriteThroughView(Ac::WaveBufferStorage::PlanarFloat, "planar: ");
+        TestExternalMemory();
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return CheckResult();
+}
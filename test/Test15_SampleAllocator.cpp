@@ -0,0 +1,254 @@
+/*
+ * Test15_SampleAllocator.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "TestUtil.h"
+#include <cstring>
+
+
+// Allocator which forwards to the heap allocator and counts the allocations.
+class CountingSampleAllocator : public Ac::SampleAllocator
+{
+
+    public:
+
+        void* Allocate(std::size_t size) override
+        {
+            ++allocations;
+            allocatedSize += size;
+            return Ac::GetHeapSampleAllocator().Allocate(size);
+        }
+
+        void Deallocate(void* ptr, std::size_t size) override
+        {
+            ++deallocations;
+            allocatedSize -= size;
+            Ac::GetHeapSampleAllocator().Deallocate(ptr, size);
+        }
+
+        std::size_t allocations     = 0;
+        std::size_t deallocations   = 0;
+        std::size_t allocatedSize   = 0;
+
+};
+
+static bool IsAligned(const void* ptr)
+{
+    return (reinterpret_cast<std::uintptr_t>(ptr) % Ac::SampleAllocator::alignment == 0);
+}
+
+static void TestWaveBufferAllocator()
+{
+    CountingSampleAllocator allocator;
+
+    {
+        Ac::WaveBuffer buffer(Ac::WaveBufferFormat(44100, 16, 2), Ac::WaveBufferStorage::Interleaved, allocator);
+        buffer.SetSampleFrames(10000);
+
+        Check(&buffer.GetAllocator() == &allocator, "WaveBuffer: allocator from the constructor");
+        Check(allocator.allocations > 0 && allocator.allocatedSize >= buffer.BufferSize(), "WaveBuffer: samples are allocated with the allocator");
+        Check(IsAligned(buffer.Data()), "WaveBuffer: samples are aligned");
+
+        /* Copies share the allocator */
+        auto copy = buffer;
+        copy.WriteSample(std::size_t(0u), 0, 0.5);
+        Check(&copy.GetAllocator() == &allocator, "WaveBuffer: copies share the allocator");
+
+        /* Storage conversion uses the allocator as well */
+        copy.SetStorage(Ac::WaveBufferStorage::PlanarFloat);
+        CheckNear(copy.ReadSample(std::size_t(0u), 0), 0.5, 1.0e-4, "WaveBuffer: planar copy");
+    }
+
+    Check(allocator.allocatedSize == 0 && allocator.allocations == allocator.deallocations, "WaveBuffer: all samples are deallocated");
+
+    /* Move the samples into memory of another allocator */
+    CountingSampleAllocator allocator2;
+    {
+        Ac::WaveBuffer buffer(Ac::WaveBufferFormat(44100, 16, 1), Ac::WaveBufferStorage::Interleaved, allocator);
+        buffer.SetSampleFrames(100);
+        buffer.WriteSample(std::size_t(50u), 0, -0.25);
+
+        buffer.SetAllocator(allocator2);
+        Check(&buffer.GetAllocator() == &allocator2, "SetAllocator: new allocator");
+        Check(allocator2.allocatedSize >= buffer.BufferSize(), "SetAllocator: samples are moved into the new allocator");
+        CheckNear(buffer.ReadSample(std::size_t(50u), 0), -0.25, 1.0e-4, "SetAllocator: samples are kept");
+    }
+
+    Check(allocator.allocatedSize == 0 && allocator2.allocatedSize == 0, "SetAllocator: all samples are deallocated");
+}
+
+static void TestDefaultAllocator()
+{
+    CountingSampleAllocator allocator;
+
+    Check(&Ac::GetDefaultSampleAllocator() == &Ac::GetHeapSampleAllocator(), "heap allocator is the initial default allocator");
+
+    Ac::SetDefaultSampleAllocator(&allocator);
+    {
+        Ac::WaveBuffer buffer(Ac::WaveBufferFormat(44100, 16, 1));
+        buffer.SetSampleFrames(1000);
+        Check(&buffer.GetAllocator() == &allocator, "new wave buffers use the default allocator");
+        Check(allocator.allocatedSize >= buffer.BufferSize(), "default allocator allocates the samples");
+    }
+    Ac::SetDefaultSampleAllocator(nullptr);
+
+    Check(&Ac::GetDefaultSampleAllocator() == &Ac::GetHeapSampleAllocator(), "null restores the heap allocator");
+    Check(allocator.allocatedSize == 0, "default allocator: all samples are deallocated");
+}
+
+static void TestPoolAllocator()
+{
+    CountingSampleAllocator upstream;
+
+    {
+        Ac::PoolSampleAllocator pool(1u << 20, 1u << 20, upstream);
+
+        /* Freed blocks are reused for allocations of the same size class */
+        auto a = pool.Allocate(1000);
+        Check(IsAligned(a), "pool: block is aligned");
+        pool.Deallocate(a, 1000);
+        Check(pool.GetCachedSize() >= 1000, "pool: freed block is cached");
+
+        auto allocations = upstream.allocations;
+        auto b = pool.Allocate(990);
+        Check(a == b, "pool: cached block is reused");
+        Check(upstream.allocations == allocations, "pool: no upstream allocation for a cached block");
+        Check(pool.GetCachedSize() == 0, "pool: reused block is removed from the cache");
+        pool.Deallocate(b, 990);
+
+        /* Reserved blocks serve later allocations without the upstream allocator */
+        pool.Reserve(4096, 8);
+        allocations = upstream.allocations;
+
+        std::vector<void*> blocks;
+        for (int i = 0; i < 8; ++i)
+            blocks.push_back(pool.Allocate(4096));
+        Check(upstream.allocations == allocations, "pool: reserved blocks serve the allocations");
+
+        bool distinct = true;
+        for (std::size_t i = 0; i < blocks.size(); ++i)
+        {
+            std::memset(blocks[i], static_cast<int>(i), 4096);
+            for (std::size_t j = 0; j < i; ++j)
+                distinct = distinct && (blocks[i] != blocks[j]);
+        }
+        Check(distinct, "pool: reserved blocks are distinct");
+
+        for (auto block : blocks)
+            pool.Deallocate(block, 4096);
+
+        /* Blocks beyond the cache limit and the maximal block size are returned to the upstream allocator */
+        Check(pool.GetCachedSize() <= (1u << 20), "pool: cache limit");
+
+        auto large = pool.Allocate(4u << 20);
+        pool.Deallocate(large, 4u << 20);
+        Check(pool.GetCachedSize() <= (1u << 20), "pool: large blocks are not cached");
+
+        pool.Release();
+        Check(pool.GetCachedSize() == 0, "pool: Release empties the cache");
+        Check(upstream.allocatedSize == 0, "pool: Release returns all blocks to the upstream allocator");
+
+        /* Cached blocks are returned on destruction */
+        pool.Deallocate(pool.Allocate(100), 100);
+    }
+
+    Check(upstream.allocatedSize == 0 && upstream.allocations == upstream.deallocations, "pool: destructor returns all blocks");
+}
+
+static void TestArenaAllocator()
+{
+    CountingSampleAllocator upstream;
+
+    {
+        Ac::ArenaSampleAllocator arena(4096, upstream);
+
+        /* Allocations are aligned and do not overlap */
+        auto a = static_cast<char*>(arena.Allocate(100));
+        auto b = static_cast<char*>(arena.Allocate(300));
+        Check(IsAligned(a) && IsAligned(b), "arena: blocks are aligned");
+        Check(b >= a + 100 || a >= b + 300, "arena: blocks do not overlap");
+
+        /* The most recent allocation is given back */
+        arena.Deallocate(b, 300);
+        auto c = arena.Allocate(200);
+        Check(c == b, "arena: most recent block is given back");
+
+        /* Large allocations get their own chunk */
+        arena.Allocate(10000);
+        Check(arena.GetCapacity() >= 4096 + 10000, "arena: capacity grows");
+
+        /* Reset makes all memory available again without upstream allocations */
+        auto allocations = upstream.allocations;
+        arena.Reset();
+        auto d = arena.Allocate(100);
+        Check(d == a, "arena: memory is reused after Reset");
+        Check(upstream.allocations == allocations, "arena: no upstream allocation after Reset");
+
+        /* Scratch wave buffer */
+        arena.Reset();
+        {
+            Ac::WaveBuffer scratch(Ac::WaveBufferFormat(44100, 16, 2), Ac::WaveBufferStorage::PlanarFloat, arena);
+            scratch.SetSampleFrames(1000);
+            scratch.WriteSample(std::size_t(999u), 1, 0.75);
+            CheckNear(scratch.ReadSample(std::size_t(999u), 1), 0.75, 1.0e-6, "arena: scratch wave buffer");
+        }
+
+        arena.Release();
+        Check(arena.GetCapacity() == 0 && upstream.allocatedSize == 0, "arena: Release returns all chunks");
+
+        arena.Allocate(100);
+    }
+
+    Check(upstream.allocatedSize == 0, "arena: destructor returns all chunks");
+}
+
+static void TestHugePageAllocator()
+{
+    CountingSampleAllocator upstream;
+
+    {
+        Ac::HugePageSampleAllocator allocator(1u << 20, upstream);
+
+        Check(Ac::HugePageSampleAllocator::GetHugePageSize() > 0, "huge pages: page size");
+
+        /* Small allocations are forwarded to the upstream allocator */
+        auto small = allocator.Allocate(1000);
+        Check(upstream.allocations == 1, "huge pages: small allocation is forwarded");
+        allocator.Deallocate(small, 1000);
+
+        /* Large allocations come from the operating system */
+        const std::size_t size = 3u << 20;
+        auto large = static_cast<char*>(allocator.Allocate(size));
+        Check(upstream.allocations == 1, "huge pages: large allocation is not forwarded");
+        Check(IsAligned(large), "huge pages: block is aligned");
+
+        std::memset(large, 0x5A, size);
+        Check(large[0] == 0x5A && large[size - 1] == 0x5A, "huge pages: memory is writable");
+
+        allocator.Deallocate(large, size);
+    }
+
+    Check(upstream.allocatedSize == 0, "huge pages: all blocks are deallocated");
+}
+
+int main()
+{
+    try
+    {
+        TestWaveBufferAllocator();
+        TestDefaultAllocator();
+        TestPoolAllocator();
+        TestArenaAllocator();
+        TestHugePageAllocator();
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return CheckResult();
+}
@@ -0,0 +1,221 @@
+/*
+ * Test16_ParallelForEach.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "TestUtil.h"
+#include <cstring>
+#include <atomic>
+#include <stdexcept>
+
+
+// Returns true if both wave buffers have the same samples.
+static bool EqualSamples(const Ac::WaveBuffer& lhs, const Ac::WaveBuffer& rhs)
+{
+    if (lhs.GetSampleFrames() != rhs.GetSampleFrames())
+        return false;
+
+    for (std::size_t i = 0; i < lhs.GetSampleFrames(); ++i)
+    {
+        for (std::uint16_t chn = 0; chn < lhs.GetFormat().channels; ++chn)
+        {
+            if (lhs.ReadSample(i, chn) != rhs.ReadSample(i, chn))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+// Stateless iterator which depends on the channel, index, time point, and previous sample.
+static void Modulate(double& sample, std::uint16_t channel, std::size_t index, double timePoint)
+{
+    sample = 0.5 * sample + 0.4 * std::sin(2.0 * M_PI * 440.0 * timePoint + channel) * ((index % 7) / 7.0);
+}
+
+static void TestParallelFor(Ac::ThreadPool& pool)
+{
+    const auto desc = std::to_string(pool.GetNumThreads()) + " thread(s): ";
+
+    /* Each index must be processed exactly once */
+    const std::size_t begin = 17, end = 100017;
+    std::vector<std::atomic<int>> counters(end);
+    for (auto& c : counters)
+        c = 0;
+
+    std::atomic<bool> partitionsValid(true);
+    pool.ParallelFor(
+        begin, end, 1000,
+        [&](std::size_t partBegin, std::size_t partEnd)
+        {
+            if (partBegin >= partEnd || partBegin < begin || partEnd > end)
+                partitionsValid = false;
+            for (auto i = partBegin; i < partEnd; ++i)
+                ++counters[i];
+        }
+    );
+
+    bool exactlyOnce = true;
+    for (std::size_t i = 0; i < end; ++i)
+    {
+        if (counters[i] != (i >= begin ? 1 : 0))
+            exactlyOnce = false;
+    }
+
+    Check(partitionsValid, desc + "partitions are within the range");
+    Check(exactlyOnce, desc + "each index is processed exactly once");
+
+    /* Exceptions are re-thrown on the calling thread */
+    bool thrown = false;
+    try
+    {
+        pool.ParallelFor(
+            0, 10000, 100,
+            [](std::size_t partBegin, std::size_t partEnd)
+            {
+                if (partBegin <= 5000 && 5000 < partEnd)
+                    throw std::runtime_error("test exception");
+            }
+        );
+    }
+    catch (const std::runtime_error&)
+    {
+        thrown = true;
+    }
+    Check(thrown, desc + "exception is re-thrown");
+
+    /* Nested calls are processed on the calling thread */
+    std::atomic<std::size_t> nestedSum(0);
+    pool.ParallelFor(
+        0, 8, 1,
+        [&](std::size_t partBegin, std::size_t partEnd)
+        {
+            for (auto i = partBegin; i < partEnd; ++i)
+            {
+                pool.ParallelFor(
+                    0, 1000, 10,
+                    [&](std::size_t innerBegin, std::size_t innerEnd)
+                    {
+                        nestedSum += (innerEnd - innerBegin);
+                    }
+                );
+            }
+        }
+    );
+    Check(nestedSum == 8000, desc + "nested calls");
+}
+
+static void TestParallelForEachSample(Ac::ThreadPool& pool, const Ac::WaveBufferStorage storage)
+{
+    const auto desc = std::to_string(pool.GetNumThreads()) + " thread(s), " + (storage == Ac::WaveBufferStorage::PlanarFloat ? "planar: " : "interleaved: ");
+
+    Ac::WaveBuffer original(Ac::WaveBufferFormat(44100, 16, 2), storage);
+    original.SetSampleFrames(100000);
+    original.ForEachSample(
+        [](double& sample, std::uint16_t /*channel*/, std::size_t /*index*/, double timePoint)
+        {
+            sample = 0.5 * std::sin(2.0 * M_PI * 220.0 * timePoint);
+        }
+    );
+
+    /* Whole buffer */
+    auto serial = original;
+    serial.ForEachSample(Modulate);
+
+    auto parallel = original;
+    parallel.ParallelForEachSample(Modulate, Ac::SampleIteratorState::Stateless, &pool);
+
+    Check(EqualSamples(parallel, serial), desc + "parallel output equals serial output");
+    Check(EqualSamples(original, Ac::WaveBuffer(original)), desc + "shared copy is unchanged");
+
+    /* Index range */
+    serial = original;
+    serial.ForEachSample(Modulate, std::size_t(1234u), std::size_t(87654u));
+
+    parallel = original;
+    parallel.ParallelForEachSample(Modulate, std::size_t(1234u), std::size_t(87654u), Ac::SampleIteratorState::Stateless, &pool);
+
+    Check(EqualSamples(parallel, serial), desc + "parallel output equals serial output for an index range");
+
+    /* Time range */
+    serial = original;
+    serial.ForEachSample(Modulate, 0.25, 1.5);
+
+    parallel = original;
+    parallel.ParallelForEachSample(Modulate, 0.25, 1.5, Ac::SampleIteratorState::Stateless, &pool);
+
+    Check(EqualSamples(parallel, serial), desc + "parallel output equals serial output for a time range");
+
+    /* Stateful iterators are processed in order (this one depends on all previous samples) */
+    double serialState = 0.0, parallelState = 0.0;
+
+    serial = original;
+    serial.ForEachSample(
+        [&serialState](double& sample, std::uint16_t /*channel*/, std::size_t /*index*/, double /*timePoint*/)
+        {
+            serialState = 0.99 * serialState + 0.01 * sample;
+            sample = serialState;
+        }
+    );
+
+    parallel = original;
+    parallel.ParallelForEachSample(
+        [&parallelState](double& sample, std::uint16_t /*channel*/, std::size_t /*index*/, double /*timePoint*/)
+        {
+            parallelState = 0.99 * parallelState + 0.01 * sample;
+            sample = parallelState;
+        },
+        Ac::SampleIteratorState::Stateful,
+        &pool
+    );
+
+    Check(EqualSamples(parallel, serial), desc + "stateful iterator equals serial output");
+    Check(parallelState == serialState, desc + "stateful iterator state");
+}
+
+static void TestDefaultThreadPool()
+{
+    Check(Ac::GetDefaultThreadPool().GetNumThreads() >= 1, "default thread pool");
+
+    Ac::ThreadPool pool(3);
+    Ac::SetDefaultThreadPool(&pool);
+    Check(&Ac::GetDefaultThreadPool() == &pool, "SetDefaultThreadPool");
+
+    Ac::WaveBuffer buffer(Ac::WaveBufferFormat(44100, 16, 1));
+    buffer.SetSampleFrames(50000);
+
+    auto serial = buffer;
+    serial.ForEachSample(Modulate);
+    buffer.ParallelForEachSample(Modulate, Ac::SampleIteratorState::Stateless);
+    Check(EqualSamples(buffer, serial), "default thread pool: parallel output equals serial output");
+
+    Ac::SetDefaultThreadPool(nullptr);
+    Check(&Ac::GetDefaultThreadPool() != &pool, "SetDefaultThreadPool(null) restores the initial pool");
+}
+
+int main()
+{
+    try
+    {
+        for (std::size_t numThreads : { 1, 2, 4 })
+        {
+            Ac::ThreadPool pool(numThreads);
+            Check(pool.GetNumThreads() == numThreads, "number of threads");
+
+            TestParallelFor(pool);
+            TestParallelForEachSample(pool, Ac::WaveBufferStorage::Interleaved);
+            TestParallelForEachSample(pool, Ac::WaveBufferStorage::PlanarFloat);
+        }
+
+        TestDefaultThreadPool();
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return CheckResult();
+}
@@ -0,0 +1,125 @@
+/*
+ * Test17_MappedWaveBuffer.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "TestUtil.h"
+#include <cstdio>
+#include <cstring>
+
+
+// Returns true if both wave buffers have the same PCM data.
+static bool EqualData(const Ac::WaveBuffer& lhs, const Ac::WaveBuffer& rhs)
+{
+    return (lhs.BufferSize() == rhs.BufferSize() && std::memcmp(lhs.Data(), rhs.Data(), lhs.BufferSize()) == 0);
+}
+
+static void TestExternalData()
+{
+    /* External stereo 16-bit samples, which are kept alive by a shared pointer */
+    auto memory = std::make_shared<std::vector<std::int16_t>>(202);
+    for (std::size_t i = 0; i < memory->size(); ++i)
+        (*memory)[i] = static_cast<std::int16_t>(i * 100);
+
+    const auto original = *memory;
+    std::weak_ptr<std::vector<std::int16_t>> memoryRef = memory;
+
+    /* Odd buffer size is rounded down to whole sample frames */
+    std::shared_ptr<const char> data(memory, reinterpret_cast<const char*>(memory->data()));
+    memory.reset();
+
+    Ac::WaveBuffer buffer;
+    buffer.AttachExternalData(Ac::WaveBufferFormat(44100, 16, 2), data, 403);
+    data.reset();
+
+    const auto& constBuffer = buffer;
+
+    Check(buffer.HasExternalData(), "external data is attached");
+    Check(buffer.IsShared(), "external data is shared");
+    Check(buffer.GetSampleFrames() == 100 && buffer.BufferSize() == 400, "buffer size is rounded down to whole sample frames");
+    Check(constBuffer.Data() == reinterpret_cast<const char*>(memoryRef.lock()->data()), "constant access refers to the external data");
+    CheckNear(buffer.ReadSample(std::size_t(10u), 1), (2100.0 + 0.5) / 32767.5, 1.0e-9, "samples are read from the external data");
+
+    /* Copies share the external data */
+    auto copy = buffer;
+    Check(copy.HasExternalData(), "copies share the external data");
+
+    /* Write access duplicates the samples */
+    buffer.WriteSample(std::size_t(10u), 1, 0.5);
+
+    Check(!buffer.HasExternalData(), "write access detaches the external data");
+    Check(constBuffer.Data() != reinterpret_cast<const char*>(memoryRef.lock()->data()), "write access duplicates the samples");
+    CheckNear(buffer.ReadSample(std::size_t(10u), 1), 0.5, 1.0e-4, "written sample");
+    CheckNear(buffer.ReadSample(std::size_t(11u), 0), (2200.0 + 0.5) / 32767.5, 1.0e-9, "other samples are duplicated");
+    Check(*memoryRef.lock() == original, "external data is never modified");
+    Check(copy.HasExternalData() && copy.ReadSample(std::size_t(10u), 1) != 0.5, "copy still refers to the external data");
+
+    /* The external memory is released with the last wave buffer that refers to it */
+    copy = Ac::WaveBuffer();
+    Check(memoryRef.expired(), "external data is released with the last reference");
+}
+
+static void TestMapWaveBuffer(const Ac::WaveBufferFormat& format)
+{
+    const auto desc = "MapWaveBuffer, " + std::to_string(format.bitsPerSample) + "-bit, " + std::to_string(format.channels) + " channel(s): ";
+    const std::string filename = "Test17_MappedWaveBuffer.wav";
+
+    FileAudioSystem audioSystem;
+
+    /* Write a test file */
+    Ac::WaveBuffer buffer(format);
+    buffer.SetSampleFrames(12345);
+    buffer.ForEachSample(
+        [](double& sample, std::uint16_t channel, std::size_t /*index*/, double timePoint)
+        {
+            sample = 0.7 * std::sin(2.0 * M_PI * (300.0 + 100.0 * channel) * timePoint);
+        }
+    );
+
+    {
+        std::ofstream file(filename, std::ios_base::binary);
+        audioSystem.WriteAudioBuffer(Ac::AudioFormats::WAVE, file, buffer);
+    }
+
+    /* Map the file and compare it with the read file */
+    {
+        auto mapped = audioSystem.MapWaveBuffer(filename);
+        const auto& constMapped = mapped;
+
+        Check(mapped.HasExternalData(), desc + "samples refer to the mapped file");
+        Check(mapped.GetFormat().bitsPerSample == format.bitsPerSample && mapped.GetFormat().channels == format.channels, desc + "format");
+        Check(EqualData(mapped, buffer), desc + "mapped samples equal the written samples");
+        Check(EqualData(mapped, audioSystem.ReadWaveBuffer(filename)), desc + "mapped samples equal the read samples");
+
+        /* Writing must not modify the file */
+        mapped.WriteSample(std::size_t(100u), 0, -1.0);
+        Check(!mapped.HasExternalData(), desc + "write access detaches the mapped file");
+        CheckNear(constMapped.ReadSample(std::size_t(100u), 0), -1.0, 1.0e-6, desc + "written sample");
+    }
+
+    Check(EqualData(audioSystem.ReadWaveBuffer(filename), buffer), desc + "file is unchanged");
+
+    std::remove(filename.c_str());
+}
+
+int main()
+{
+    try
+    {
+        TestExternalData();
+        TestMapWaveBuffer(Ac::WaveBufferFormat(44100, 16, 2));
+        TestMapWaveBuffer(Ac::WaveBufferFormat(22050, 8, 1));
+
+        FileAudioSystem audioSystem;
+        Check(audioSystem.MapWaveBuffer("Test17_Missing.wav").GetSampleFrames() == 0, "MapWaveBuffer: missing file returns an empty buffer");
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return CheckResult();
+}
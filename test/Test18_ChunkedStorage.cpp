@@ -0,0 +1,110 @@
+/*
+ * Test18_ChunkedStorage.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "TestUtil.h"
+
+
+static Ac::WaveBuffer GenerateBlock(std::size_t frames, std::size_t offset)
+{
+    Ac::WaveBuffer buffer(Ac::WaveBufferFormat(44100, 16, 2));
+    buffer.SetSampleFrames(frames);
+
+    for (std::size_t i = 0; i < frames; ++i)
+    {
+        auto t = static_cast<double>(offset + i) / 44100.0;
+        buffer.WriteSample(i, 0, 0.5 * std::sin(2.0 * M_PI * 440.0 * t));
+        buffer.WriteSample(i, 1, 0.5 * std::sin(2.0 * M_PI * 660.0 * t));
+    }
+
+    return buffer;
+}
+
+static void TestAppend(std::size_t chunkSize)
+{
+    const auto desc = "chunk size " + std::to_string(chunkSize) + ": ";
+
+    /* Append blocks of varying size, smaller and larger than a chunk */
+    const std::size_t blockFrames[] = { 100, 1, 4096, 333, 20000, 7, 2048 };
+
+    Ac::WaveBuffer chunked(Ac::WaveBufferFormat(44100, 16, 2)), flat(Ac::WaveBufferFormat(44100, 16, 2));
+    chunked.SetChunkSize(chunkSize);
+
+    std::size_t frames = 0;
+    for (auto n : blockFrames)
+    {
+        auto block = GenerateBlock(n, frames);
+        chunked.Append(block);
+        flat.Append(block);
+        frames += n;
+    }
+
+    Check(chunked.GetSampleFrames() == frames, desc + "number of sample frames");
+    Check(chunked.BufferSize() == flat.BufferSize(), desc + "buffer size");
+    Check(chunked.GetNumChunks() > 1, desc + "samples are split into multiple chunks");
+
+    /* The chunks must cover the samples in order */
+    std::size_t chunkBytes = 0;
+    bool chunksEqual = true;
+    for (std::size_t i = 0; i < chunked.GetNumChunks(); ++i)
+    {
+        auto chunk = chunked.GetChunk(i);
+        if (!std::equal(chunk.Data(), chunk.Data() + chunk.BufferSize(), flat.Data() + chunkBytes))
+            chunksEqual = false;
+        chunkBytes += chunk.BufferSize();
+    }
+    Check(chunksEqual && chunkBytes == flat.BufferSize(), desc + "chunks equal the contiguous samples");
+
+    /* Reading across chunk boundaries must not flatten the chunks */
+    const auto numChunks = chunked.GetNumChunks();
+
+    std::vector<float> chunkedFrames(frames * 2), flatFrames(frames * 2);
+    for (std::size_t i = 0; i < frames; i += 999)
+    {
+        auto n = std::min(std::size_t(999u), frames - i);
+        chunked.ReadFrames(i, n, chunkedFrames.data() + i*2);
+        flat.ReadFrames(i, n, flatFrames.data() + i*2);
+    }
+    Check(chunkedFrames == flatFrames, desc + "ReadFrames equals contiguous samples");
+
+    std::vector<double> chunkedSamples, flatSamples;
+    static_cast<const Ac::WaveBuffer&>(chunked).ForEachSample(
+        [&](double sample, std::uint16_t /*channel*/, std::size_t /*index*/, double /*timePoint*/)
+        {
+            chunkedSamples.push_back(sample);
+        }
+    );
+    static_cast<const Ac::WaveBuffer&>(flat).ForEachSample(
+        [&](double sample, std::uint16_t /*channel*/, std::size_t /*index*/, double /*timePoint*/)
+        {
+            flatSamples.push_back(sample);
+        }
+    );
+    Check(chunkedSamples == flatSamples, desc + "ForEachSample equals contiguous samples");
+    Check(chunked.GetNumChunks() == numChunks, desc + "reading does not flatten the chunks");
+
+    /* Flattening merges the chunks into the same contiguous samples */
+    chunked.Flatten();
+    Check(chunked.GetNumChunks() == 1, desc + "Flatten merges the chunks");
+    Check(std::equal(flat.Data(), flat.Data() + flat.BufferSize(), static_cast<const Ac::WaveBuffer&>(chunked).Data()), desc + "flattened samples equal contiguous samples");
+}
+
+int main()
+{
+    try
+    {
+        TestAppend(1024);
+        TestAppend(1u << 16);
+        TestAppend(3);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return CheckResult();
+}
@@ -0,0 +1,276 @@
+/*
+ * Test19_SampleTransforms.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "TestUtil.h"
+#include <cstring>
+
+
+static const std::size_t silenceBegin   = 500;
+static const std::size_t silenceEnd     = 700;
+static const std::size_t numFrames      = 10000;
+
+struct BufferType
+{
+    std::string                 desc;
+    Ac::WaveBufferFormat        format;
+    Ac::WaveBufferStorage       storage;
+};
+
+// Returns the tolerance for the samples of the specified buffer type (transforms are processed in single precision).
+static double Tolerance(const BufferType& type)
+{
+    return (type.format.bitsPerSample == 16 && type.storage == Ac::WaveBufferStorage::Interleaved ? 1.001 * 2.0 / 65535.0 : 1.0e-6);
+}
+
+// Returns a stereo buffer with sine waves and DC offsets, which is surrounded by silence.
+static Ac::WaveBuffer GenerateBuffer(const BufferType& type)
+{
+    Ac::WaveBuffer buffer(type.format, type.storage);
+    buffer.SetSampleFrames(numFrames);
+
+    buffer.ForEachSample(
+        [](double& sample, std::uint16_t channel, std::size_t index, double /*timePoint*/)
+        {
+            if (index < silenceBegin || index >= numFrames - silenceEnd)
+                sample = 0.0;
+            else if (channel == 0)
+                sample = 0.5 * std::sin(0.01 * static_cast<double>(index)) + 0.1;
+            else
+                sample = 0.25 * std::sin(0.003 * static_cast<double>(index)) - 0.2;
+        }
+    );
+
+    return buffer;
+}
+
+// Returns the maximal difference between 'buffer[i]' and 'transform(original[offset + i])'.
+template <typename Transform>
+static double MaxDifference(const Ac::WaveBuffer& buffer, const Ac::WaveBuffer& original, std::size_t offset, Transform transform)
+{
+    double maxError = 0.0;
+
+    for (std::size_t i = 0; i < buffer.GetSampleFrames(); ++i)
+    {
+        for (std::uint16_t chn = 0; chn < buffer.GetFormat().channels; ++chn)
+        {
+            auto expected = std::max(-1.0, std::min(transform(original.ReadSample(offset + i, chn), offset + i), 1.0));
+            maxError = std::max(maxError, std::abs(buffer.ReadSample(i, chn) - expected));
+        }
+    }
+
+    return maxError;
+}
+
+static void TestAnalysis(const BufferType& type)
+{
+    const auto desc = type.desc + ": ";
+    const auto buffer = GenerateBuffer(type);
+
+    /* Reference levels in double precision */
+    double peak = 0.0, squareSum = 0.0;
+    for (std::size_t i = 0; i < numFrames; ++i)
+    {
+        for (std::uint16_t chn = 0; chn < 2; ++chn)
+        {
+            auto s = buffer.ReadSample(i, chn);
+            peak = std::max(peak, std::abs(s));
+            squareSum += s*s;
+        }
+    }
+    auto rms = std::sqrt(squareSum / (numFrames * 2));
+
+    CheckNear(Ac::Synthesizer::GetPeakLevel(buffer), peak, 1.0e-6, desc + "peak level");
+    CheckNear(Ac::Synthesizer::GetRMSLevel(buffer), rms, 1.0e-5, desc + "RMS level");
+    CheckNear(Ac::Synthesizer::GetPeakLevel(Ac::WaveBuffer(type.format, type.storage)), 0.0, 0.0, desc + "peak level of an empty buffer");
+    CheckNear(Ac::Synthesizer::GetRMSLevel(Ac::WaveBuffer(type.format, type.storage)), 0.0, 0.0, desc + "RMS level of an empty buffer");
+}
+
+static void TestAmplify(const BufferType& type)
+{
+    const auto desc = type.desc + ": ";
+    const auto original = GenerateBuffer(type);
+
+    /* Constant gain (with clamping) */
+    auto buffer = original;
+    Ac::Synthesizer::AmplifyWaveBuffer(buffer, 1.8);
+    CheckNear(
+        MaxDifference(buffer, original, 0, [](double s, std::size_t) { return s * 1.8; }),
+        0.0, Tolerance(type), desc + "AmplifyWaveBuffer with constant gain"
+    );
+
+    /* Gain ramp from 0.1 to 0.2 seconds */
+    const auto sampleRate   = static_cast<double>(type.format.sampleRate);
+    const auto indexFrom    = static_cast<std::size_t>(0.1 * sampleRate);
+    const auto indexTo      = static_cast<std::size_t>(0.2 * sampleRate);
+
+    buffer = original;
+    Ac::Synthesizer::AmplifyWaveBuffer(buffer, 0.0, 2.0, 0.1, 0.2);
+    CheckNear(
+        MaxDifference(
+            buffer, original, 0,
+            [=](double s, std::size_t i)
+            {
+                if (i < indexFrom || i >= indexTo)
+                    return s;
+                return s * 2.0 * static_cast<double>(i - indexFrom) / static_cast<double>(indexTo - indexFrom);
+            }
+        ),
+        0.0, Tolerance(type) + 1.0e-5, desc + "AmplifyWaveBuffer with gain ramp"
+    );
+
+    /* Normalization of the peak level */
+    buffer = original;
+    auto peak = Ac::Synthesizer::GetPeakLevel(original);
+    auto gain = Ac::Synthesizer::NormalizeWaveBuffer(buffer, 0.8);
+    CheckNear(gain, 0.8 / peak, 1.0e-5, desc + "NormalizeWaveBuffer: gain");
+    CheckNear(Ac::Synthesizer::GetPeakLevel(buffer), 0.8, Tolerance(type), desc + "NormalizeWaveBuffer: peak level");
+    CheckNear(
+        MaxDifference(buffer, original, 0, [gain](double s, std::size_t) { return s * gain; }),
+        0.0, Tolerance(type), desc + "NormalizeWaveBuffer: samples"
+    );
+
+    /* Normalization of the RMS level */
+    buffer = original;
+    Ac::Synthesizer::NormalizeWaveBufferRMS(buffer, 0.2);
+    CheckNear(Ac::Synthesizer::GetRMSLevel(buffer), 0.2, 1.0e-4, desc + "NormalizeWaveBufferRMS: RMS level");
+
+    /* Silent buffers are not amplified (16-bit PCM can not represent zero exactly) */
+    if (type.format.bitsPerSample != 16 || type.storage != Ac::WaveBufferStorage::Interleaved)
+    {
+        Ac::WaveBuffer silence(type.format, type.storage);
+        silence.SetSampleFrames(100);
+        CheckNear(Ac::Synthesizer::NormalizeWaveBuffer(silence), 1.0, 0.0, desc + "NormalizeWaveBuffer: silent buffer");
+    }
+}
+
+static void TestDCOffset(const BufferType& type)
+{
+    const auto desc = type.desc + ": ";
+    const auto original = GenerateBuffer(type);
+
+    double means[2] = { 0.0, 0.0 };
+    for (std::size_t i = 0; i < numFrames; ++i)
+    {
+        for (std::uint16_t chn = 0; chn < 2; ++chn)
+            means[chn] += original.ReadSample(i, chn) / numFrames;
+    }
+
+    auto buffer = original;
+    Ac::Synthesizer::RemoveDCOffset(buffer);
+
+    double newMeans[2] = { 0.0, 0.0 };
+    for (std::size_t i = 0; i < numFrames; ++i)
+    {
+        for (std::uint16_t chn = 0; chn < 2; ++chn)
+            newMeans[chn] += buffer.ReadSample(i, chn) / numFrames;
+    }
+
+    CheckNear(newMeans[0], 0.0, Tolerance(type), desc + "RemoveDCOffset: mean of the first channel");
+    CheckNear(newMeans[1], 0.0, Tolerance(type), desc + "RemoveDCOffset: mean of the second channel");
+    CheckNear(
+        MaxDifference(buffer, original, 0, [&](double s, std::size_t) { return s; }) -
+        std::max(std::abs(means[0]), std::abs(means[1])),
+        0.0, Tolerance(type) + 1.0e-6, desc + "RemoveDCOffset: samples are only shifted"
+    );
+}
+
+static void TestTrimAndReverse(const BufferType& type)
+{
+    const auto desc = type.desc + ": ";
+    const auto original = GenerateBuffer(type);
+
+    /* Trim the silence at both ends */
+    auto buffer = original;
+    auto removed = Ac::Synthesizer::TrimWaveBuffer(buffer);
+
+    Check(removed == silenceBegin + silenceEnd, desc + "TrimWaveBuffer: number of removed sample frames");
+    Check(buffer.GetSampleFrames() == numFrames - silenceBegin - silenceEnd, desc + "TrimWaveBuffer: number of remaining sample frames");
+    CheckNear(
+        MaxDifference(buffer, original, silenceBegin, [](double s, std::size_t) { return s; }),
+        0.0, 0.0, desc + "TrimWaveBuffer: remaining samples"
+    );
+
+    /* Trimming with a high threshold removes the quiet samples as well, a silent buffer is removed entirely */
+    buffer = original;
+    Check(Ac::Synthesizer::TrimWaveBuffer(buffer, 0.5) > removed, desc + "TrimWaveBuffer: higher threshold");
+
+    Ac::WaveBuffer silence(type.format, type.storage);
+    silence.SetSampleFrames(100);
+    Check(Ac::Synthesizer::TrimWaveBuffer(silence) == 100 && silence.GetSampleFrames() == 0, desc + "TrimWaveBuffer: silent buffer");
+
+    /* Reverse the sample frames */
+    buffer = original;
+    Ac::Synthesizer::ReverseWaveBuffer(buffer);
+
+    double maxError = 0.0;
+    for (std::size_t i = 0; i < numFrames; ++i)
+    {
+        for (std::uint16_t chn = 0; chn < 2; ++chn)
+            maxError = std::max(maxError, std::abs(buffer.ReadSample(i, chn) - original.ReadSample(numFrames - 1 - i, chn)));
+    }
+    CheckNear(maxError, 0.0, 0.0, desc + "ReverseWaveBuffer: samples are reversed");
+
+    Ac::Synthesizer::ReverseWaveBuffer(buffer);
+    CheckNear(
+        MaxDifference(buffer, original, 0, [](double s, std::size_t) { return s; }),
+        0.0, 0.0, desc + "ReverseWaveBuffer: reversing twice is lossless"
+    );
+}
+
+static void TestChunkedAnalysis()
+{
+    const BufferType type { "chunked", Ac::WaveBufferFormat(44100, 16, 2), Ac::WaveBufferStorage::Interleaved };
+    const auto original = GenerateBuffer(type);
+
+    /* Append the buffer in pieces to a chunked buffer */
+    Ac::WaveBuffer chunked(type.format);
+    chunked.SetChunkSize(4000);
+
+    for (std::size_t i = 0; i < numFrames; i += 777)
+    {
+        Ac::WaveBuffer piece(type.format);
+        piece.SetSampleFrames(std::min(std::size_t(777u), numFrames - i));
+        piece.CopyFrom(original, i, i + piece.GetSampleFrames(), 0);
+        chunked.Append(piece);
+    }
+
+    Check(chunked.GetNumChunks() > 1, "chunked: buffer has multiple chunks");
+    CheckNear(Ac::Synthesizer::GetPeakLevel(chunked), Ac::Synthesizer::GetPeakLevel(original), 0.0, "chunked: peak level");
+    CheckNear(Ac::Synthesizer::GetRMSLevel(chunked), Ac::Synthesizer::GetRMSLevel(original), 1.0e-7, "chunked: RMS level");
+
+    Check(Ac::Synthesizer::TrimWaveBuffer(chunked) == silenceBegin + silenceEnd, "chunked: TrimWaveBuffer");
+}
+
+int main()
+{
+    try
+    {
+        const BufferType types[] =
+        {
+            { "16-bit interleaved", Ac::WaveBufferFormat(44100, 16, 2),       Ac::WaveBufferStorage::Interleaved },
+            { "float interleaved",  Ac::WaveBufferFormat(48000, 32, 2, true), Ac::WaveBufferStorage::Interleaved },
+            { "planar",             Ac::WaveBufferFormat(44100, 16, 2),       Ac::WaveBufferStorage::PlanarFloat },
+        };
+
+        for (const auto& type : types)
+        {
+            TestAnalysis(type);
+            TestAmplify(type);
+            TestDCOffset(type);
+            TestTrimAndReverse(type);
+        }
+
+        TestChunkedAnalysis();
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return CheckResult();
+}
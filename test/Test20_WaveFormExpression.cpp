@@ -0,0 +1,152 @@
+/*
+ * Test20_WaveFormExpression.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "TestUtil.h"
+
+
+using namespace Ac::Synthesizer;
+
+// Returns the maximal difference between the samples of both wave buffers.
+static double MaxDifference(const Ac::WaveBuffer& lhs, const Ac::WaveBuffer& rhs)
+{
+    double maxError = 0.0;
+
+    for (std::size_t i = 0; i < lhs.GetSampleFrames(); ++i)
+    {
+        for (std::uint16_t chn = 0; chn < lhs.GetFormat().channels; ++chn)
+            maxError = std::max(maxError, std::abs(lhs.ReadSample(i, chn) - rhs.ReadSample(i, chn)));
+    }
+
+    return maxError;
+}
+
+// Returns an empty float wave buffer with the specified storage.
+static Ac::WaveBuffer MakeBuffer(const Ac::WaveBufferStorage storage, std::size_t frames)
+{
+    Ac::WaveBuffer buffer(Ac::WaveBufferFormat(44100, 32, 2, true), storage);
+    buffer.SetSampleFrames(frames);
+    return buffer;
+}
+
+static void TestEvaluate()
+{
+    const double t = 0.0123;
+
+    CheckNear(SineGenerator({ 440.0, 0.5, 0.001 }).Evaluate(t), 0.5 * std::sin((t + 0.001) * 2.0 * M_PI * 440.0), 1.0e-12, "SineWave::Evaluate");
+    CheckNear(SawGenerator({ 100.0, 0.5 }).Evaluate(0.0025), 0.5 * (0.25 * 2.0 - 1.0), 1.0e-12, "SawWave::Evaluate");
+    CheckNear(SquareGenerator({ 100.0, 0.5 }).Evaluate(0.0025), -0.5, 1.0e-12, "SquareWave::Evaluate (first half)");
+    CheckNear(SquareGenerator({ 100.0, 0.5 }).Evaluate(0.0075), 0.5, 1.0e-12, "SquareWave::Evaluate (second half)");
+    CheckNear(HalfCircleGenerator({ 100.0, 1.0 }).Evaluate(0.0025), 1.0, 1.0e-12, "HalfCircleWave::Evaluate");
+
+    /* Combined expressions */
+    auto a = SineGenerator({ 440.0, 0.5 });
+    auto b = SawGenerator({ 110.0, 0.25 });
+    auto c = SquareGenerator({ 55.0, 0.125 });
+
+    CheckNear((a + b).Evaluate(t), a.Evaluate(t) + b.Evaluate(t), 1.0e-12, "sum of expressions");
+    CheckNear((a - b).Evaluate(t), a.Evaluate(t) - b.Evaluate(t), 1.0e-12, "difference of expressions");
+    CheckNear((a * 3.0).Evaluate(t), a.Evaluate(t) * 3.0, 1.0e-12, "scaled expression (right factor)");
+    CheckNear((0.5 * (a + b - c)).Evaluate(t), 0.5 * (a.Evaluate(t) + b.Evaluate(t) - c.Evaluate(t)), 1.0e-12, "nested expression");
+
+    Check(IsWaveFormExpression<decltype(a + b - c)>::value, "IsWaveFormExpression for expressions");
+    Check(!IsWaveFormExpression<double>::value, "IsWaveFormExpression for other types");
+}
+
+static void TestBlockEqualsSample(const Ac::WaveBufferStorage storage, const std::string& desc)
+{
+    /* Frame count which is not a multiple of the block size and not a multiple of four */
+    const std::size_t frames = Ac::WaveBuffer::maxBlockSamples * 3 + 123;
+
+    auto expr = SineGenerator({ 440.0, 0.3 }) + 0.5 * SineGenerator({ 1234.5, 0.2, 0.0001 }) - SawGenerator({ 110.0, 0.1 }) + TriangleGenerator({ 220.0, 0.1 });
+
+    auto reference = MakeBuffer(storage, frames);
+    reference.ForEachSample(expr);
+
+    /* Block iteration with the inlinable template */
+    auto blocks = MakeBuffer(storage, frames);
+    blocks.ForEachBlock(expr);
+    CheckNear(MaxDifference(blocks, reference), 0.0, 1.0e-6, desc + "ForEachBlock equals ForEachSample");
+
+    /* Block iteration over an inclusive sub range, which must use the same time points */
+    auto range = MakeBuffer(storage, frames);
+    range.ForEachBlock(expr, 777, 3001);
+
+    double maxError = 0.0;
+    for (std::size_t i = 0; i < frames; ++i)
+    {
+        for (std::uint16_t chn = 0; chn < 2; ++chn)
+        {
+            auto expected = (i >= 777 && i <= 3001 ? reference.ReadSample(i, chn) : 0.0);
+            maxError = std::max(maxError, std::abs(range.ReadSample(i, chn) - expected));
+        }
+    }
+    CheckNear(maxError, 0.0, 1.0e-6, desc + "ForEachBlock over a sub range");
+
+    /* Expressions add their value to the samples */
+    blocks.ForEachBlock(expr);
+    reference.ForEachSample(expr);
+    CheckNear(MaxDifference(blocks, reference), 0.0, 2.0e-6, desc + "expressions add their value to the samples");
+
+    /* Conversion to the type erased generator */
+    WaveFormGenerator generator = expr;
+    auto erased = MakeBuffer(storage, frames);
+    erased.ForEachSample(generator);
+    reference = MakeBuffer(storage, frames);
+    reference.ForEachSample(expr);
+    CheckNear(MaxDifference(erased, reference), 0.0, 0.0, desc + "WaveFormGenerator equals the expression");
+}
+
+static void TestSeries()
+{
+    const std::size_t frames = 44100;
+
+    /* Saw-tooth wave with 32 partials */
+    WaveFormSeries<SineWave> partials;
+    for (int i = 1; i <= 32; ++i)
+        partials.Append(SineGenerator({ 110.0 * i, 0.5 / i }));
+
+    Check(partials.GetTerms().size() == 32, "WaveFormSeries: number of terms");
+
+    auto reference = MakeBuffer(Ac::WaveBufferStorage::PlanarFloat, frames);
+    reference.ForEachSample(
+        [](double& sample, std::uint16_t /*channel*/, std::size_t /*index*/, double timePoint)
+        {
+            for (int i = 1; i <= 32; ++i)
+                sample += std::sin(timePoint * 2.0 * M_PI * 110.0 * i) * 0.5 / i;
+        }
+    );
+
+    auto blocks = MakeBuffer(Ac::WaveBufferStorage::PlanarFloat, frames);
+    blocks.ForEachBlock(partials);
+
+    /* Phasor rotation must not drift within a block */
+    CheckNear(MaxDifference(blocks, reference), 0.0, 1.0e-5, "WaveFormSeries: ForEachBlock equals the reference");
+
+    /* Empty series leaves the samples unchanged */
+    WaveFormSeries<SineWave> empty;
+    auto silence = MakeBuffer(Ac::WaveBufferStorage::Interleaved, 1000);
+    silence.ForEachBlock(empty);
+    CheckNear(Ac::Synthesizer::GetPeakLevel(silence), 0.0, 0.0, "WaveFormSeries: empty series");
+}
+
+int main()
+{
+    try
+    {
+        TestEvaluate();
+        TestBlockEqualsSample(Ac::WaveBufferStorage::Interleaved, "interleaved: ");
+        TestBlockEqualsSample(Ac::WaveBufferStorage::PlanarFloat, "planar: ");
+        TestSeries();
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return CheckResult();
+}
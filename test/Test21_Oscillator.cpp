@@ -0,0 +1,273 @@
+/*
+ * Test21_Oscillator.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "TestUtil.h"
+#include <stdexcept>
+
+
+// Returns the distance (in cycles) of the specified phase to the next integral cycle.
+static double DistanceToCycle(double phase)
+{
+    auto fraction = phase - std::floor(phase);
+    return std::min(fraction, 1.0 - fraction);
+}
+
+static void TestSine()
+{
+    const std::uint32_t sampleRate = 48000;
+    const double frequency = 441.3, phase = 0.125;
+
+    Ac::Oscillator osc(Ac::OscillatorWaveForm::Sine, sampleRate, frequency, 0.75, phase);
+
+    /* Compare one second with the exact sine wave (more frames than the phasors are rotated without re-initialization) */
+    std::vector<double> samples(sampleRate);
+    osc.Generate(samples.data(), samples.size());
+
+    double maxError = 0.0;
+    for (std::size_t i = 0; i < samples.size(); ++i)
+    {
+        auto expected = 0.75 * std::sin(2.0 * M_PI * (phase + static_cast<double>(i) * frequency / sampleRate));
+        maxError = std::max(maxError, std::abs(samples[i] - expected));
+    }
+    CheckNear(maxError, 0.0, 1.0e-7, "sine: samples equal the exact sine wave");
+
+    /* Phase after one second */
+    auto expectedPhase = phase + frequency;
+    CheckNear(osc.GetPhase(), expectedPhase - std::floor(expectedPhase), 1.0e-9, "sine: phase after one second");
+
+    /* Float output */
+    std::vector<float> floatSamples(1000);
+    osc.Reset();
+    osc.Generate(floatSamples.data(), floatSamples.size());
+
+    maxError = 0.0;
+    for (std::size_t i = 0; i < floatSamples.size(); ++i)
+        maxError = std::max(maxError, std::abs(static_cast<double>(floatSamples[i]) - samples[i]));
+    CheckNear(maxError, 0.0, 1.0e-6, "sine: float samples");
+}
+
+static void TestPhaseDeterminism(const Ac::OscillatorWaveForm waveForm, const std::string& desc)
+{
+    const std::size_t frames = 20000;
+
+    Ac::Oscillator osc(waveForm, 44100, 1234.5, 0.5, 0.3);
+
+    /* Generate all frames at once */
+    std::vector<double> whole(frames);
+    osc.Generate(whole.data(), frames);
+    const auto phase = osc.GetPhase();
+
+    /* Generate the same frames in blocks of odd sizes */
+    osc.Reset();
+    CheckNear(osc.GetPhase(), 0.3, 1.0e-12, desc + "Reset restores the initial phase");
+
+    std::vector<double> pieces(frames);
+    for (std::size_t i = 0, n = 1; i < frames; i += n, n = n * 3 % 1999 + 1)
+        osc.Generate(pieces.data() + i, std::min(n, frames - i));
+
+    /* Sine phasors are initialized per call, so the samples may only differ by rounding errors */
+    double maxError = 0.0;
+    for (std::size_t i = 0; i < frames; ++i)
+        maxError = std::max(maxError, std::abs(pieces[i] - whole[i]));
+
+    CheckNear(maxError, 0.0, 1.0e-12, desc + "block size does not change the samples");
+    Check(osc.GetPhase() == phase, desc + "block size does not change the phase");
+
+    /* Copies continue independently with the same phase */
+    auto copy = osc;
+    std::vector<double> a(1000), b(1000);
+    osc.Generate(a.data(), a.size());
+    copy.Generate(b.data(), b.size());
+    Check(a == b && copy.GetPhase() == osc.GetPhase(), desc + "copies continue with the same phase");
+
+    /* The phase wraps around exactly, i.e. it equals the fractional part of the number of cycles */
+    Ac::Oscillator longOsc(waveForm, 48000, 1000.0);
+    std::vector<float> block(48000);
+    for (int i = 0; i < 60; ++i)
+        longOsc.Generate(block.data(), block.size());
+    CheckNear(DistanceToCycle(longOsc.GetPhase()), 0.0, 1.0e-9, desc + "no phase drift after one minute");
+}
+
+static void TestWaveForms()
+{
+    const std::uint32_t sampleRate = 48000;
+    const double frequency = 100.0;
+    const std::size_t frames = 4800;
+
+    /* Only samples apart from the discontinuities are compared, which are not affected by band-limiting */
+    auto isSmooth = [&](std::size_t i, double edge)
+    {
+        return DistanceToCycle(static_cast<double>(i) * frequency / sampleRate - edge) > 3.0 * frequency / sampleRate;
+    };
+
+    std::vector<double> samples(frames);
+
+    /* Saw-tooth wave rises from -1 to +1 */
+    Ac::Oscillator saw(Ac::OscillatorWaveForm::Saw, sampleRate, frequency, 0.5);
+    saw.Generate(samples.data(), frames);
+
+    double maxError = 0.0;
+    for (std::size_t i = 0; i < frames; ++i)
+    {
+        if (isSmooth(i, 0.0))
+        {
+            auto t = static_cast<double>(i) * frequency / sampleRate;
+            maxError = std::max(maxError, std::abs(samples[i] - 0.5 * ((t - std::floor(t)) * 2.0 - 1.0)));
+        }
+    }
+    CheckNear(maxError, 0.0, 1.0e-9, "saw: samples");
+
+    /* Triangle wave is in phase with the sine wave */
+    Ac::Oscillator triangle(Ac::OscillatorWaveForm::Triangle, sampleRate, frequency);
+    triangle.Generate(samples.data(), frames);
+    CheckNear(samples[60], 0.5, 1.0e-9, "triangle: rising slope");
+    CheckNear(samples[180], 0.5, 1.0e-9, "triangle: falling slope");
+    CheckNear(samples[240], 0.0, 1.0e-9, "triangle: zero crossing at half a cycle");
+    CheckNear(samples[420], -0.5, 1.0e-9, "triangle: rising slope in the second half");
+
+    /* Square wave with pulse width */
+    for (double pulseWidth : { 0.5, 0.25, 0.8 })
+    {
+        const auto desc = "square (pulse width " + std::to_string(pulseWidth) + "): ";
+
+        Ac::Oscillator square(Ac::OscillatorWaveForm::Square, sampleRate, frequency);
+        square.SetPulseWidth(pulseWidth);
+        CheckNear(square.GetPulseWidth(), pulseWidth, 0.0, desc + "GetPulseWidth");
+
+        square.Generate(samples.data(), frames);
+
+        std::size_t positive = 0;
+        bool levelsValid = true;
+        for (std::size_t i = 0; i < frames; ++i)
+        {
+            if (samples[i] > 0.0)
+                ++positive;
+            if (isSmooth(i, 0.0) && isSmooth(i, pulseWidth))
+            {
+                auto t = static_cast<double>(i) * frequency / sampleRate;
+                auto expected = (t - std::floor(t) < pulseWidth ? 1.0 : -1.0);
+                levelsValid = levelsValid && (std::abs(samples[i] - expected) < 1.0e-9);
+            }
+        }
+
+        Check(levelsValid, desc + "levels");
+        CheckNear(static_cast<double>(positive) / frames, pulseWidth, 0.01, desc + "fraction of positive samples");
+    }
+
+    /* Half-circle wave */
+    Ac::Oscillator halfCircle(Ac::OscillatorWaveForm::HalfCircle, sampleRate, frequency);
+    halfCircle.Generate(samples.data(), frames);
+    CheckNear(samples[120], 1.0, 1.0e-6, "half-circle: maximum at a quarter cycle");
+    CheckNear(samples[360], -1.0, 1.0e-6, "half-circle: minimum at three quarters of a cycle");
+    CheckNear(samples[40], std::sqrt(1.0 - std::pow(40.0 / 120.0 - 1.0, 2.0)), 1.0e-3, "half-circle: upper half circle");
+}
+
+static void TestWavetable()
+{
+    Ac::Oscillator osc(Ac::OscillatorWaveForm::Wavetable, 800, 100.0);
+
+    /* Without a wavetable, the oscillator generates silence */
+    std::vector<double> samples(16, 1.0);
+    osc.Generate(samples.data(), samples.size());
+    Check(std::all_of(samples.begin(), samples.end(), [](double s) { return s == 0.0; }), "wavetable: silence without wavetable");
+
+    /* Eight frames per cycle on a four-sample wavetable, i.e. every second sample is interpolated */
+    osc.SetWavetable({ 0.0f, 1.0f, 0.0f, -1.0f });
+    osc.Reset();
+    Check(osc.GetWaveForm() == Ac::OscillatorWaveForm::Wavetable, "wavetable: wave form");
+
+    osc.Generate(samples.data(), samples.size());
+    const double expected[] = { 0.0, 0.5, 1.0, 0.5, 0.0, -0.5, -1.0, -0.5 };
+
+    double maxError = 0.0;
+    for (std::size_t i = 0; i < samples.size(); ++i)
+        maxError = std::max(maxError, std::abs(samples[i] - expected[i % 8]));
+    CheckNear(maxError, 0.0, 1.0e-6, "wavetable: linear interpolation with wrap around");
+}
+
+static void TestParameters()
+{
+    /* Negative frequencies let the phase run backwards */
+    Ac::Oscillator osc(Ac::OscillatorWaveForm::Sine, 1000, -10.0, 1.0, 0.5);
+    std::vector<double> samples(25);
+    osc.Generate(samples.data(), samples.size());
+    CheckNear(osc.GetPhase(), 0.25, 1.0e-12, "negative frequency");
+
+    /* Frequency changes keep the phase */
+    osc.SetFrequency(20.0);
+    CheckNear(osc.GetPhase(), 0.25, 1.0e-12, "SetFrequency keeps the phase");
+    osc.Generate(samples.data(), samples.size());
+    CheckNear(osc.GetPhase(), 0.75, 1.0e-12, "phase advances with the new frequency");
+
+    osc.SetPhase(2.125);
+    CheckNear(osc.GetPhase(), 0.125, 1.0e-12, "SetPhase uses the fractional part");
+
+    /* Sample rate changes keep the frequency */
+    osc.SetSampleRate(2000);
+    Check(osc.GetSampleRate() == 2000 && osc.GetFrequency() == 20.0, "SetSampleRate");
+    osc.Generate(samples.data(), samples.size());
+    CheckNear(osc.GetPhase(), 0.375, 1.0e-12, "phase advances with the new sample rate");
+
+    /* Invalid sample rates */
+    bool thrown = false;
+    try
+    {
+        Ac::Oscillator invalid(Ac::OscillatorWaveForm::Sine, 0, 440.0);
+    }
+    catch (const std::invalid_argument&)
+    {
+        thrown = true;
+    }
+    Check(thrown, "zero sample rate throws std::invalid_argument");
+}
+
+static void TestBlockIterator()
+{
+    Ac::Oscillator osc(Ac::OscillatorWaveForm::Sine, 22050, 440.0, 0.5);
+
+    /* The oscillator adopts the sample rate of the buffer and adds its samples to all channels */
+    Ac::WaveBuffer buffer(Ac::WaveBufferFormat(44100, 32, 2, true), Ac::WaveBufferStorage::PlanarFloat);
+    buffer.SetSampleFrames(5000);
+    buffer.ForEachBlock(osc);
+
+    Check(osc.GetSampleRate() == 44100, "ForEachBlock: oscillator adopts the sample rate");
+
+    Ac::Oscillator reference(Ac::OscillatorWaveForm::Sine, 44100, 440.0, 0.5);
+    std::vector<double> samples(5000);
+    reference.Generate(samples.data(), samples.size());
+
+    double maxError = 0.0;
+    for (std::size_t i = 0; i < samples.size(); ++i)
+    {
+        for (std::uint16_t chn = 0; chn < 2; ++chn)
+            maxError = std::max(maxError, std::abs(buffer.ReadSample(i, chn) - samples[i]));
+    }
+    CheckNear(maxError, 0.0, 1.0e-6, "ForEachBlock: samples equal the generated samples");
+    CheckNear(osc.GetPhase(), reference.GetPhase(), 0.0, "ForEachBlock: phase is advanced");
+}
+
+int main()
+{
+    try
+    {
+        TestSine();
+        TestPhaseDeterminism(Ac::OscillatorWaveForm::Sine, "sine: ");
+        TestPhaseDeterminism(Ac::OscillatorWaveForm::Saw, "saw: ");
+        TestPhaseDeterminism(Ac::OscillatorWaveForm::HalfCircle, "half-circle: ");
+        TestWaveForms();
+        TestWavetable();
+        TestParameters();
+        TestBlockIterator();
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return CheckResult();
+}
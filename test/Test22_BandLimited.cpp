@@ -0,0 +1,193 @@
+/*
+ * Test22_BandLimited.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "TestUtil.h"
+
+
+using namespace Ac::Synthesizer;
+
+static const std::uint32_t sampleRate = 44100;
+
+// Returns the power of the specified DFT bin (with the Goertzel algorithm), scaled like the mean square of a sine wave.
+static double BinPower(const std::vector<double>& samples, double frequency)
+{
+    const auto coeff = 2.0 * std::cos(2.0 * M_PI * frequency / sampleRate);
+
+    double s1 = 0.0, s2 = 0.0;
+    for (auto x : samples)
+    {
+        auto s0 = x + coeff * s1 - s2;
+        s2 = s1;
+        s1 = s0;
+    }
+
+    const auto n = static_cast<double>(samples.size());
+    return 2.0 * (s1*s1 + s2*s2 - coeff*s1*s2) / (n*n);
+}
+
+/*
+Returns the ratio (in dB) of the alias energy to the total energy of one second of a periodic signal.
+The frequency must be integral, so that all harmonics are exact DFT bins. Everything apart from the harmonics is aliasing.
+*/
+static double AliasLevel(const std::vector<double>& samples, double frequency)
+{
+    double total = 0.0, mean = 0.0;
+    for (auto x : samples)
+    {
+        total += x*x;
+        mean += x;
+    }
+    total /= samples.size();
+    mean /= samples.size();
+
+    double harmonics = mean*mean;
+    for (double f = frequency; f < sampleRate / 2; f += frequency)
+        harmonics += BinPower(samples, f);
+
+    return 10.0 * std::log10(std::max(total - harmonics, 1.0e-30) / total);
+}
+
+// Returns one second of samples of the specified expression.
+template <typename Expr>
+static std::vector<double> Render(const Expr& expr)
+{
+    std::vector<double> samples(sampleRate);
+    for (std::size_t i = 0; i < samples.size(); ++i)
+        samples[i] = expr.Evaluate(static_cast<double>(i) / sampleRate);
+    return samples;
+}
+
+// Returns one second of samples of the specified oscillator.
+static std::vector<double> Render(const Ac::OscillatorWaveForm waveForm, double frequency, bool bandLimited)
+{
+    Ac::Oscillator osc(waveForm, sampleRate, frequency);
+    osc.SetBandLimited(bandLimited);
+
+    std::vector<double> samples(sampleRate);
+    osc.Generate(samples.data(), samples.size());
+    return samples;
+}
+
+static double PeakLevel(const std::vector<double>& samples)
+{
+    double peak = 0.0;
+    for (auto x : samples)
+        peak = std::max(peak, std::abs(x));
+    return peak;
+}
+
+static void TestResiduals()
+{
+    const double dt = 0.1;
+
+    /* Residuals are zero apart from the discontinuity, and continuous at its borders */
+    bool zeroOutside = true, boundedBLEP = true, boundedBLAMP = true;
+    for (int i = 0; i < 1000; ++i)
+    {
+        auto t = static_cast<double>(i) / 1000.0;
+        auto blep = PolyBLEP(t, dt), blamp = PolyBLAMP(t, dt);
+
+        if (t >= dt && t <= 1.0 - dt)
+            zeroOutside = zeroOutside && (blep == 0.0 && blamp == 0.0);
+
+        boundedBLEP = boundedBLEP && (std::abs(blep) <= 1.0);
+        boundedBLAMP = boundedBLAMP && (std::abs(blamp) <= 1.0 / 3.0);
+    }
+
+    Check(zeroOutside, "residuals are zero apart from the discontinuity");
+    Check(boundedBLEP, "PolyBLEP is within [-1, 1]");
+    Check(boundedBLAMP, "PolyBLAMP is within [-1/3, 1/3]");
+
+    CheckNear(PolyBLEP(0.0, dt), -1.0, 1.0e-12, "PolyBLEP at the step");
+    CheckNear(PolyBLEP(dt - 1.0e-12, dt), 0.0, 1.0e-9, "PolyBLEP is continuous after the step");
+    CheckNear(PolyBLEP(1.0 - dt + 1.0e-12, dt), 0.0, 1.0e-9, "PolyBLEP is continuous before the step");
+    CheckNear(PolyBLAMP(dt - 1.0e-12, dt), 0.0, 1.0e-9, "PolyBLAMP is continuous after the corner");
+    CheckNear(PolyBLAMP(0.0, dt), PolyBLAMP(1.0 - 1.0e-12, dt), 1.0e-9, "PolyBLAMP is continuous at the corner");
+}
+
+static void TestBounds()
+{
+    /* BLEP output must stay within the amplitude for all frequencies up to the Nyquist frequency */
+    for (double frequency : { 55.0, 440.0, 3200.0, 7000.0, 15000.0, 22050.0 })
+    {
+        const auto desc = std::to_string(static_cast<int>(frequency)) + " Hz: ";
+
+        CheckNear(PeakLevel(Render(BandLimitedSawGenerator({ frequency, 0.5 }, sampleRate))), 0.0, 0.5 + 1.0e-9, desc + "band-limited saw within bounds");
+        CheckNear(PeakLevel(Render(BandLimitedSquareGenerator({ frequency, 0.5 }, sampleRate))), 0.0, 0.5 + 1.0e-9, desc + "band-limited square within bounds");
+        CheckNear(PeakLevel(Render(BandLimitedTriangleGenerator({ frequency, 0.5 }, sampleRate))), 0.0, 0.5 + 1.0e-9, desc + "band-limited triangle within bounds");
+
+        CheckNear(PeakLevel(Render(Ac::OscillatorWaveForm::Saw, frequency, true)), 0.0, 1.0 + 1.0e-9, desc + "oscillator saw within bounds");
+        CheckNear(PeakLevel(Render(Ac::OscillatorWaveForm::Square, frequency, true)), 0.0, 1.0 + 1.0e-9, desc + "oscillator square within bounds");
+        CheckNear(PeakLevel(Render(Ac::OscillatorWaveForm::Triangle, frequency, true)), 0.0, 1.0 + 1.0e-9, desc + "oscillator triangle within bounds");
+    }
+
+    /* Above the Nyquist frequency, the band-limited terms equal the naive terms */
+    auto naive = Render(SquareGenerator({ 30000.0, 0.5 }));
+    auto limited = Render(BandLimitedSquareGenerator({ 30000.0, 0.5 }, sampleRate));
+    Check(naive == limited, "band-limited square equals naive square above the Nyquist frequency");
+}
+
+static void TestAliasing()
+{
+    const double frequency = 3200.0;
+
+    /* Expression terms */
+    auto sawNaive       = AliasLevel(Render(SawGenerator({ frequency })), frequency);
+    auto sawLimited     = AliasLevel(Render(BandLimitedSawGenerator({ frequency }, sampleRate)), frequency);
+    auto squareNaive    = AliasLevel(Render(SquareGenerator({ frequency })), frequency);
+    auto squareLimited  = AliasLevel(Render(BandLimitedSquareGenerator({ frequency }, sampleRate)), frequency);
+
+    Check(sawLimited < sawNaive - 10.0, "band-limited saw term reduces aliasing by more than 10 dB");
+    Check(squareLimited < squareNaive - 10.0, "band-limited square term reduces aliasing by more than 10 dB");
+
+    /* Oscillator */
+    Ac::Oscillator osc(Ac::OscillatorWaveForm::Saw, sampleRate, frequency);
+    Check(osc.IsBandLimited(), "oscillator is band-limited by default");
+
+    for (auto waveForm : { Ac::OscillatorWaveForm::Saw, Ac::OscillatorWaveForm::Square, Ac::OscillatorWaveForm::Triangle })
+    {
+        const auto desc = std::string(waveForm == Ac::OscillatorWaveForm::Saw ? "saw" : waveForm == Ac::OscillatorWaveForm::Square ? "square" : "triangle");
+
+        auto naive = AliasLevel(Render(waveForm, frequency, false), frequency);
+        auto limited = AliasLevel(Render(waveForm, frequency, true), frequency);
+
+        Check(limited < naive - (waveForm == Ac::OscillatorWaveForm::Triangle ? 3.0 : 10.0), "oscillator: band-limited " + desc + " reduces aliasing");
+    }
+
+    /* Naive oscillator equals the wave form without band-limiting, i.e. the exact saw-tooth */
+    auto naive = Render(Ac::OscillatorWaveForm::Saw, 100.0, false);
+    CheckNear(naive[110], (110.0 * 100.0 / sampleRate) * 2.0 - 1.0, 1.0e-9, "oscillator: naive saw");
+}
+
+static void TestTriangle()
+{
+    /* The triangle term is in phase with the sine wave */
+    auto triangle = TriangleGenerator({ 100.0, 0.5 });
+    CheckNear(triangle.Evaluate(0.0), 0.0, 1.0e-12, "triangle starts at zero");
+    CheckNear(triangle.Evaluate(0.0025), 0.5, 1.0e-12, "triangle peak at a quarter cycle");
+    CheckNear(triangle.Evaluate(0.005), 0.0, 1.0e-12, "triangle zero crossing at half a cycle");
+    CheckNear(triangle.Evaluate(0.0075), -0.5, 1.0e-12, "triangle trough at three quarters of a cycle");
+    CheckNear(triangle.Evaluate(0.00125), 0.25, 1.0e-12, "triangle rises linearly");
+}
+
+int main()
+{
+    try
+    {
+        TestResiduals();
+        TestBounds();
+        TestAliasing();
+        TestTriangle();
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return CheckResult();
+}
@@ -0,0 +1,217 @@
+/*
+ * Test23_NoiseGenerator.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "TestUtil.h"
+#include <thread>
+
+
+static const Ac::NoiseColor colors[] = { Ac::NoiseColor::White, Ac::NoiseColor::Pink, Ac::NoiseColor::Brown };
+
+static std::string ColorName(const Ac::NoiseColor color)
+{
+    switch (color)
+    {
+        case Ac::NoiseColor::White: return "white";
+        case Ac::NoiseColor::Pink:  return "pink";
+        case Ac::NoiseColor::Brown: return "brown";
+    }
+    return "";
+}
+
+// Returns the specified number of noise samples of the specified channel.
+static std::vector<double> Generate(Ac::NoiseGenerator& noise, std::size_t frames, std::uint16_t channel = 0)
+{
+    std::vector<double> samples(frames);
+    noise.Generate(samples.data(), frames, channel);
+    return samples;
+}
+
+// Returns the ratio of the energy of the first differences to the energy of the samples (2 for white noise, lower for darker noise).
+static double DifferenceRatio(const std::vector<double>& samples)
+{
+    double energy = 0.0, diffEnergy = 0.0;
+    for (std::size_t i = 1; i < samples.size(); ++i)
+    {
+        auto diff = samples[i] - samples[i - 1];
+        energy += samples[i]*samples[i];
+        diffEnergy += diff*diff;
+    }
+    return diffEnergy / energy;
+}
+
+static void TestSeedDeterminism(const Ac::NoiseColor color)
+{
+    const auto desc = ColorName(color) + ": ";
+    const std::size_t frames = 10000;
+
+    /* Same seed results in the same output */
+    Ac::NoiseGenerator a(color, 0.5, 42), b(color, 0.5, 42), c(color, 0.5, 43);
+
+    auto samplesA = Generate(a, frames);
+    Check(samplesA == Generate(b, frames), desc + "same seed results in the same samples");
+    Check(samplesA != Generate(c, frames), desc + "different seed results in different samples");
+    Check(a.GetSeed() == 42 && a.GetColor() == color, desc + "seed and color");
+
+    /* Output does not depend on the block sizes */
+    Ac::NoiseGenerator blocks(color, 0.5, 42);
+    std::vector<double> pieces(frames);
+    for (std::size_t i = 0, n = 1; i < frames; i += n, n = n * 7 % 601 + 1)
+        blocks.Generate(pieces.data() + i, std::min(n, frames - i));
+    Check(pieces == samplesA, desc + "block sizes do not change the samples");
+
+    /* Output does not depend on the thread */
+    std::vector<double> threadSamples;
+    std::thread worker(
+        [&]()
+        {
+            Ac::NoiseGenerator noise(color, 0.5, 42);
+            threadSamples = Generate(noise, frames);
+        }
+    );
+    worker.join();
+    Check(threadSamples == samplesA, desc + "worker thread results in the same samples");
+
+    /* Reset and Seed start over */
+    a.Reset();
+    Check(Generate(a, frames) == samplesA, desc + "Reset starts over");
+
+    c.Seed(42);
+    Check(Generate(c, frames) == samplesA && c.GetSeed() == 42, desc + "Seed starts over with the new seed");
+
+    /* Each channel has its own deterministic streams */
+    Ac::NoiseGenerator d(color, 0.5, 42);
+    auto channel1 = Generate(d, frames, 1);
+    Check(channel1 != samplesA, desc + "channels are independent");
+    Check(Generate(d, frames, 0) == samplesA, desc + "channels do not affect each other");
+
+    /* Amplitude scales the samples */
+    Ac::NoiseGenerator scaled(color, 1.0, 42);
+    auto samplesScaled = Generate(scaled, frames);
+
+    double maxError = 0.0;
+    for (std::size_t i = 0; i < frames; ++i)
+        maxError = std::max(maxError, std::abs(samplesScaled[i] * 0.5 - samplesA[i]));
+    CheckNear(maxError, 0.0, 1.0e-6, desc + "amplitude scales the samples");
+}
+
+static void TestDistribution()
+{
+    const std::size_t frames = 200000;
+
+    /* White noise is uniformly distributed in [-amplitude, amplitude) */
+    Ac::NoiseGenerator white(Ac::NoiseColor::White, 0.5, 7);
+    auto samples = Generate(white, frames);
+
+    double mean = 0.0, variance = 0.0, peak = 0.0;
+    for (auto x : samples)
+    {
+        mean += x;
+        variance += x*x;
+        peak = std::max(peak, std::abs(x));
+    }
+    mean /= frames;
+    variance /= frames;
+
+    Check(peak <= 0.5, "white: samples are within the amplitude");
+    CheckNear(mean, 0.0, 0.005, "white: mean");
+    CheckNear(variance, 0.25 / 3.0, 0.002, "white: variance");
+
+    /* Darker noise has less energy at high frequencies */
+    Ac::NoiseGenerator pink(Ac::NoiseColor::Pink, 1.0, 7), brown(Ac::NoiseColor::Brown, 1.0, 7);
+
+    auto whiteRatio = DifferenceRatio(samples);
+    auto pinkRatio  = DifferenceRatio(Generate(pink, frames));
+    auto brownRatio = DifferenceRatio(Generate(brown, frames));
+
+    CheckNear(whiteRatio, 2.0, 0.05, "white: flat spectrum");
+    Check(pinkRatio < whiteRatio * 0.75, "pink: less high-frequency energy than white noise");
+    Check(brownRatio < pinkRatio * 0.5, "brown: less high-frequency energy than pink noise");
+
+    /* Colored noise is bounded */
+    pink.Reset();
+    brown.Reset();
+    for (auto* noise : { &pink, &brown })
+    {
+        auto colored = Generate(*noise, frames);
+        double coloredPeak = 0.0;
+        for (auto x : colored)
+            coloredPeak = std::max(coloredPeak, std::abs(x));
+        Check(coloredPeak <= 1.0 && coloredPeak > 0.1, ColorName(noise->GetColor()) + ": samples are within the amplitude");
+    }
+}
+
+static void TestBlockIterator()
+{
+    /* Independent noise is added to each channel */
+    Ac::WaveBuffer buffer(Ac::WaveBufferFormat(44100, 32, 2, true));
+    buffer.SetSampleFrames(3000);
+
+    Ac::NoiseGenerator noise(Ac::NoiseColor::Pink, 0.25, 99);
+    buffer.ForEachBlock(noise);
+
+    Ac::NoiseGenerator reference(Ac::NoiseColor::Pink, 0.25, 99);
+    auto left = Generate(reference, 3000, 0), right = Generate(reference, 3000, 1);
+
+    double maxError = 0.0;
+    for (std::size_t i = 0; i < 3000; ++i)
+    {
+        maxError = std::max(maxError, std::abs(buffer.ReadSample(i, 0) - left[i]));
+        maxError = std::max(maxError, std::abs(buffer.ReadSample(i, 1) - right[i]));
+    }
+    CheckNear(maxError, 0.0, 1.0e-6, "ForEachBlock: samples equal the generated samples of each channel");
+}
+
+static void TestWaveFormGenerators()
+{
+    /* Noise generators with explicit seeds are reproducible */
+    auto render = [](const Ac::Synthesizer::WaveFormGenerator& generator)
+    {
+        Ac::WaveBuffer buffer(Ac::WaveBufferFormat(44100, 32, 2, true));
+        buffer.SetSampleFrames(2000);
+        buffer.ForEachSample(generator);
+        return buffer;
+    };
+
+    auto equal = [](const Ac::WaveBuffer& lhs, const Ac::WaveBuffer& rhs)
+    {
+        return (lhs.BufferSize() == rhs.BufferSize() && std::equal(lhs.Data(), lhs.Data() + lhs.BufferSize(), rhs.Data()));
+    };
+
+    auto white = render(Ac::Synthesizer::WhiteNoiseGenerator(0.5, 1234));
+    Check(equal(white, render(Ac::Synthesizer::WhiteNoiseGenerator(0.5, 1234))), "WhiteNoiseGenerator: same seed results in the same samples");
+    Check(!equal(white, render(Ac::Synthesizer::WhiteNoiseGenerator(0.5, 1235))), "WhiteNoiseGenerator: different seed results in different samples");
+    Check(!equal(white, render(Ac::Synthesizer::WhiteNoiseGenerator(0.5))), "WhiteNoiseGenerator: generators without seed get a new seed");
+    CheckNear(Ac::Synthesizer::GetPeakLevel(white), 0.0, 0.5, "WhiteNoiseGenerator: samples are within the amplitude");
+
+    auto pink = render(Ac::Synthesizer::PinkNoiseGenerator(0.5, 1234));
+    Check(equal(pink, render(Ac::Synthesizer::PinkNoiseGenerator(0.5, 1234))), "PinkNoiseGenerator: same seed results in the same samples");
+
+    double state = 0.0;
+    auto brown = render(Ac::Synthesizer::BrownNoiseGenerator(0.5, state));
+    CheckNear(Ac::Synthesizer::GetPeakLevel(brown), 0.0, 1.0, "BrownNoiseGenerator: random walk is within [-1, 1]");
+    CheckNear(state, brown.ReadSample(std::size_t(1999u), 1), 1.0e-6, "BrownNoiseGenerator: state is the last sample");
+}
+
+int main()
+{
+    try
+    {
+        for (auto color : colors)
+            TestSeedDeterminism(color);
+
+        TestDistribution();
+        TestBlockIterator();
+        TestWaveFormGenerators();
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return CheckResult();
+}
@@ -0,0 +1,110 @@
+/*
+ * Test24_PerlinNoise.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "TestUtil.h"
+
+
+// Returns the maximal difference between the batch evaluation and the scalar evaluation for the specified time points.
+static double MaxDifference(
+    const Ac::PerlinNoise& noise, const std::vector<double>& timePoints, const std::vector<double>& values,
+    std::uint32_t frequency, std::uint32_t octaves, double persistence)
+{
+    double maxError = 0.0;
+
+    for (std::size_t i = 0; i < timePoints.size(); ++i)
+        maxError = std::max(maxError, std::abs(values[i] - noise.Noise(timePoints[i], frequency, octaves, persistence)));
+
+    return maxError;
+}
+
+static void TestBatchEqualsScalar(std::uint32_t frequency, std::uint32_t octaves, double persistence)
+{
+    const auto desc = std::to_string(frequency) + " Hz, " + std::to_string(octaves) + " octave(s): ";
+
+    Ac::PerlinNoise noise(17);
+
+    /* Arbitrary time points, whose count is not a multiple of the internal block size */
+    std::vector<double> timePoints(1000);
+    for (std::size_t i = 0; i < timePoints.size(); ++i)
+        timePoints[i] = std::fmod(static_cast<double>(i) * 0.7391 + std::sin(static_cast<double>(i)) * 0.25, 3.0 * frequency) + 0.25;
+
+    std::vector<double> values(timePoints.size());
+    noise.Noise(timePoints.data(), values.data(), timePoints.size(), frequency, octaves, persistence);
+    CheckNear(MaxDifference(noise, timePoints, values, frequency, octaves, persistence), 0.0, 1.0e-9, desc + "array of time points");
+
+    /* Output may alias the input */
+    auto inPlace = timePoints;
+    noise.Noise(inPlace.data(), inPlace.data(), inPlace.size(), frequency, octaves, persistence);
+    Check(inPlace == values, desc + "in-place evaluation");
+
+    /* Evenly spaced time points */
+    const double timeBegin = 1.3, timeStep = 0.0137;
+    std::vector<double> range(777);
+    noise.Noise(timeBegin, timeStep, range.data(), range.size(), frequency, octaves, persistence);
+
+    for (std::size_t i = 0; i < range.size(); ++i)
+        timePoints[i] = timeBegin + static_cast<double>(i) * timeStep;
+    timePoints.resize(range.size());
+
+    CheckNear(MaxDifference(noise, timePoints, range, frequency, octaves, persistence), 0.0, 1.0e-9, desc + "evenly spaced time points");
+}
+
+static void TestPattern()
+{
+    Ac::PerlinNoise a(5), b(5), c(6);
+
+    std::vector<double> samplesA(2000), samplesB(2000), samplesC(2000);
+    a.Noise(0.0, 0.01, samplesA.data(), samplesA.size(), 4, 5);
+    b.Noise(0.0, 0.01, samplesB.data(), samplesB.size(), 4, 5);
+    c.Noise(0.0, 0.01, samplesC.data(), samplesC.size(), 4, 5);
+
+    Check(samplesA == samplesB, "same seed results in the same pattern");
+    Check(samplesA != samplesC, "different seed results in a different pattern");
+
+    c.Seed(5);
+    c.Noise(0.0, 0.01, samplesC.data(), samplesC.size(), 4, 5);
+    Check(samplesA == samplesC, "Seed changes the pattern");
+
+    /* Single octave is zero at the lattice points and within [-1, 1] */
+    bool zeroAtLattice = true, bounded = true;
+    for (int i = 0; i < 64; ++i)
+        zeroAtLattice = zeroAtLattice && (std::abs(a.Noise(static_cast<double>(i), 16)) < 1.0e-12);
+
+    std::vector<double> single(10000);
+    a.Noise(0.0, 0.00173, single.data(), single.size(), 16);
+    for (auto x : single)
+        bounded = bounded && (std::abs(x) <= 1.0);
+
+    Check(zeroAtLattice, "noise is zero at the lattice points");
+    Check(bounded, "noise is within [-1, 1]");
+
+    /* Pattern repeats after 'frequency' lattice points */
+    CheckNear(a.Noise(2.37, 4, 5, 0.5), a.Noise(6.37, 4, 5, 0.5), 1.0e-9, "pattern repeats after the period");
+
+    /* Empty batches must not access the output */
+    a.Noise(0.0, 0.1, nullptr, 0, 4, 5);
+}
+
+int main()
+{
+    try
+    {
+        TestBatchEqualsScalar(4, 1, 0.5);
+        TestBatchEqualsScalar(4, 5, 0.5);
+        TestBatchEqualsScalar(7, 3, 0.7);
+        TestBatchEqualsScalar(300, 2, 0.5);
+        TestBatchEqualsScalar(4, 10, 0.5);
+        TestPattern();
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return CheckResult();
+}
@@ -0,0 +1,133 @@
+/*
+ * Test25_Convolution.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "TestUtil.h"
+#include <random>
+
+
+static std::vector<float> GenerateNoise(std::size_t size, unsigned seed, float amplitude)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-amplitude, amplitude);
+
+    std::vector<float> samples(size);
+    for (auto& s : samples)
+        s = dist(rng);
+
+    return samples;
+}
+
+// Returns the direct convolution (in double precision) of the signal with the kernel, where the output is moved back in time by 'delay' samples.
+static std::vector<double> ConvolveReference(const std::vector<float>& signal, const std::vector<float>& kernel, std::size_t delay)
+{
+    std::vector<double> output(signal.size(), 0.0);
+
+    for (std::size_t n = 0; n < signal.size(); ++n)
+    {
+        for (std::size_t k = 0; k < kernel.size(); ++k)
+        {
+            auto i = static_cast<std::ptrdiff_t>(n + delay) - static_cast<std::ptrdiff_t>(k);
+            if (i >= 0 && i < static_cast<std::ptrdiff_t>(signal.size()))
+                output[n] += static_cast<double>(kernel[k]) * signal[static_cast<std::size_t>(i)];
+        }
+    }
+
+    return output;
+}
+
+static Ac::WaveBuffer MakeFloatBuffer(const std::vector<float>& left, const std::vector<float>& right)
+{
+    Ac::WaveBuffer buffer(Ac::WaveBufferFormat(44100, 32, 2, true));
+    buffer.SetSampleFrames(left.size());
+
+    std::vector<float> frames(left.size() * 2);
+    for (std::size_t i = 0; i < left.size(); ++i)
+    {
+        frames[i*2    ] = left[i];
+        frames[i*2 + 1] = right[i];
+    }
+    buffer.WriteFrames(0, left.size(), frames.data());
+
+    return buffer;
+}
+
+static double MaxError(const Ac::WaveBuffer& buffer, std::uint16_t channel, const std::vector<double>& expected)
+{
+    double maxError = 0.0;
+    for (std::size_t i = 0; i < expected.size(); ++i)
+        maxError = std::max(maxError, std::abs(buffer.ReadSample(i, channel) - expected[i]));
+    return maxError;
+}
+
+static void TestConvolveWaveBuffer(std::size_t kernelSize, std::size_t delay)
+{
+    const auto desc = "kernel size " + std::to_string(kernelSize) + ", delay " + std::to_string(delay) + ": ";
+
+    /* Keep the output within [-1, 1], so it's not clamped */
+    const std::size_t frames = 10000;
+    const auto left     = GenerateNoise(frames, 1, 0.5f);
+    const auto right    = GenerateNoise(frames, 2, 0.5f);
+    const auto kernel   = GenerateNoise(kernelSize, 3, 1.0f / static_cast<float>(kernelSize));
+
+    auto buffer = MakeFloatBuffer(left, right);
+    Ac::Synthesizer::ConvolveWaveBuffer(buffer, kernel, delay);
+
+    Check(buffer.GetSampleFrames() == frames, desc + "number of sample frames");
+    CheckNear(MaxError(buffer, 0, ConvolveReference(left, kernel, delay)), 0.0, 1.0e-5, desc + "max. error of left channel");
+    CheckNear(MaxError(buffer, 1, ConvolveReference(right, kernel, delay)), 0.0, 1.0e-5, desc + "max. error of right channel");
+}
+
+static void TestConvolveStereoImpulseResponse()
+{
+    const std::size_t frames = 5000;
+    const auto left     = GenerateNoise(frames, 4, 0.5f);
+    const auto right    = GenerateNoise(frames, 5, 0.5f);
+    const auto kernelL  = GenerateNoise(300, 6, 1.0f / 300);
+    const auto kernelR  = GenerateNoise(300, 7, 1.0f / 300);
+
+    auto buffer = MakeFloatBuffer(left, right);
+    Ac::Synthesizer::ConvolveWaveBuffer(buffer, MakeFloatBuffer(kernelL, kernelR));
+
+    CheckNear(MaxError(buffer, 0, ConvolveReference(left, kernelL, 0)), 0.0, 1.0e-5, "stereo impulse response: max. error of left channel");
+    CheckNear(MaxError(buffer, 1, ConvolveReference(right, kernelR, 0)), 0.0, 1.0e-5, "stereo impulse response: max. error of right channel");
+}
+
+static void TestBlurWaveBuffer()
+{
+    /* The normalized blur kernel must keep a constant signal unchanged (the boundary samples are repeated) */
+    const std::vector<float> constant(2000, 0.25f);
+
+    auto buffer = MakeFloatBuffer(constant, constant);
+    Ac::Synthesizer::BlurWaveBuffer(buffer, 0.01, 1.0, 20);
+
+    double maxError = 0.0;
+    for (std::size_t i = 0; i < constant.size(); ++i)
+        maxError = std::max(maxError, std::abs(buffer.ReadSample(i, 0) - 0.25));
+    CheckNear(maxError, 0.0, 1.0e-6, "blur: max. error of constant signal");
+}
+
+int main()
+{
+    try
+    {
+        /* Short kernels are applied directly, long kernels with the FFT block convolution */
+        TestConvolveWaveBuffer(1, 0);
+        TestConvolveWaveBuffer(7, 3);
+        TestConvolveWaveBuffer(64, 0);
+        TestConvolveWaveBuffer(1023, 511);
+        TestConvolveWaveBuffer(4000, 0);
+        TestConvolveStereoImpulseResponse();
+        TestBlurWaveBuffer();
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return CheckResult();
+}
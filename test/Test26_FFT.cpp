@@ -0,0 +1,218 @@
+/*
+ * Test26_FFT.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "TestUtil.h"
+#include <random>
+
+
+// Returns the naive discrete Fourier transform (in double precision) of the complex signal.
+static std::vector<std::complex<double>> ReferenceDFT(const std::vector<std::complex<float>>& signal, bool inverse)
+{
+    const auto n = signal.size();
+    const auto sign = (inverse ? 1.0 : -1.0);
+
+    std::vector<std::complex<double>> spectrum(n);
+
+    for (std::size_t k = 0; k < n; ++k)
+    {
+        std::complex<double> sum;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            /* Reduce the angle modulo the size to keep it accurate */
+            auto angle = sign * 2.0 * M_PI * static_cast<double>((k * i) % n) / static_cast<double>(n);
+            sum += std::complex<double>(signal[i]) * std::complex<double>(std::cos(angle), std::sin(angle));
+        }
+        spectrum[k] = sum;
+    }
+
+    return spectrum;
+}
+
+static std::vector<std::complex<float>> GenerateComplexNoise(std::size_t size, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+
+    std::vector<std::complex<float>> signal(size);
+    for (auto& s : signal)
+        s = std::complex<float>(dist(rng), dist(rng));
+
+    return signal;
+}
+
+// Returns the max. error relative to the RMS of the expected values.
+template <typename T>
+static double RelativeError(const T* values, const std::vector<std::complex<double>>& expected)
+{
+    double maxError = 0.0, energy = 0.0;
+
+    for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+        maxError = std::max(maxError, std::abs(std::complex<double>(values[i]) - expected[i]));
+        energy += std::norm(expected[i]);
+    }
+
+    return maxError / std::sqrt(energy / static_cast<double>(expected.size()));
+}
+
+static void TestComplexFFT(std::size_t size)
+{
+    const auto desc = "complex FFT of size " + std::to_string(size) + ": ";
+
+    const auto signal = GenerateComplexNoise(size, static_cast<unsigned>(size));
+    auto plan = Ac::FFTPlan::Get(size);
+
+    std::vector<std::complex<float>> spectrum(size), restored(size);
+    plan->Forward(signal.data(), spectrum.data());
+    plan->Inverse(spectrum.data(), restored.data());
+
+    CheckNear(RelativeError(spectrum.data(), ReferenceDFT(signal, false)), 0.0, 1.0e-5, desc + "forward transform equals DFT");
+    CheckNear(RelativeError(restored.data(), ReferenceDFT(spectrum, true)), 0.0, 1.0e-5, desc + "inverse transform equals inverse DFT");
+
+    /* In-place transform must equal the out-of-place transform */
+    auto inPlace = signal;
+    plan->Forward(inPlace.data(), inPlace.data());
+    Check(inPlace == spectrum, desc + "in-place transform");
+}
+
+static void TestRealFFT(std::size_t size)
+{
+    const auto desc = "real FFT of size " + std::to_string(size) + ": ";
+
+    /* Real signal as complex signal with zero imaginary parts */
+    auto complexSignal = GenerateComplexNoise(size, static_cast<unsigned>(size) + 1);
+
+    std::vector<float> signal(size);
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        signal[i] = complexSignal[i].real();
+        complexSignal[i] = signal[i];
+    }
+
+    auto plan = Ac::RealFFTPlan::Get(size);
+
+    std::vector<std::complex<float>> spectrum(plan->GetNumBins());
+    plan->Forward(signal.data(), spectrum.data());
+
+    auto expected = ReferenceDFT(complexSignal, false);
+    expected.resize(plan->GetNumBins());
+    CheckNear(RelativeError(spectrum.data(), expected), 0.0, 1.0e-5, desc + "forward transform equals DFT");
+
+    std::vector<float> restored(size);
+    plan->Inverse(spectrum.data(), restored.data());
+
+    double maxError = 0.0;
+    for (std::size_t i = 0; i < size; ++i)
+        maxError = std::max(maxError, std::abs(restored[i] / static_cast<double>(size) - signal[i]));
+    CheckNear(maxError, 0.0, 1.0e-5, desc + "inverse transform restores the signal");
+}
+
+static void TestGetFastSize()
+{
+    Check(Ac::FFTPlan::GetFastSize(1) == 1, "fast size of 1");
+    Check(Ac::FFTPlan::GetFastSize(1024) == 1024, "fast size of 1024");
+    Check(Ac::FFTPlan::GetFastSize(1025) == 1080, "fast size of 1025");
+    Check(Ac::FFTPlan::GetFastSize(7) == 8, "fast size of 7");
+}
+
+static void TestWindow()
+{
+    /* Periodic Hann windows with 50% overlap add up to one */
+    const std::size_t size = 64;
+    auto window = Ac::GenerateWindow(Ac::WindowFunction::Hann, size);
+
+    double maxError = 0.0;
+    for (std::size_t i = 0; i < size/2; ++i)
+        maxError = std::max(maxError, std::abs(window[i] + window[i + size/2] - 1.0));
+    CheckNear(maxError, 0.0, 1.0e-6, "overlap-add of periodic Hann window");
+
+    auto symmetric = Ac::GenerateWindow(Ac::WindowFunction::Blackman, size, false);
+    Check(symmetric.front() == symmetric.back(), "symmetric Blackman window");
+    CheckNear(symmetric.front(), 0.0, 1.0e-6, "first weight of Blackman window");
+}
+
+static void TestSTFT(std::size_t frameSize, std::size_t hopSize)
+{
+    const auto desc = "STFT " + std::to_string(frameSize) + "/" + std::to_string(hopSize) + ": ";
+
+    /* Stereo buffer with a tone on the left and noise on the right */
+    const std::size_t frames = 10000;
+
+    Ac::WaveBuffer buffer(Ac::WaveBufferFormat(44100, 32, 2, true));
+    buffer.SetSampleFrames(frames);
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> dist(-0.5, 0.5);
+
+    for (std::size_t i = 0; i < frames; ++i)
+    {
+        buffer.WriteSample(i, 0, 0.5 * std::sin(2.0 * M_PI * 1000.0 * static_cast<double>(i) / 44100.0));
+        buffer.WriteSample(i, 1, dist(rng));
+    }
+
+    const auto original = buffer;
+
+    /* Analysis and synthesis of unmodified spectra must reconstruct the signal */
+    Ac::STFT stft(frameSize, hopSize);
+    std::vector<std::complex<float>> spectra;
+
+    stft.Analyze(buffer, 1, spectra);
+    Check(spectra.size() == stft.GetNumFrames(frames) * stft.GetNumBins(), desc + "number of spectra");
+
+    stft.Synthesize(spectra, buffer, 1);
+
+    double maxError = 0.0;
+    for (std::size_t i = 0; i < frames; ++i)
+        maxError = std::max(maxError, std::abs(buffer.ReadSample(i, 1) - original.ReadSample(i, 1)));
+    CheckNear(maxError, 0.0, 1.0e-5, desc + "synthesis reconstructs the signal");
+
+    double leftError = 0.0;
+    for (std::size_t i = 0; i < frames; ++i)
+        leftError = std::max(leftError, std::abs(buffer.ReadSample(i, 0) - original.ReadSample(i, 0)));
+    Check(leftError == 0.0, desc + "synthesis leaves other channels unchanged");
+
+    /* The tone must peak at the bin of its frequency */
+    stft.Analyze(buffer, 0, spectra);
+
+    const auto numBins  = stft.GetNumBins();
+    const auto frame    = stft.GetNumFrames(frames) / 2;
+    std::size_t peakBin = 0;
+
+    for (std::size_t bin = 1; bin < numBins; ++bin)
+    {
+        if (std::abs(spectra[frame * numBins + bin]) > std::abs(spectra[frame * numBins + peakBin]))
+            peakBin = bin;
+    }
+
+    CheckNear(stft.GetBinFrequency(peakBin, 44100), 1000.0, stft.GetBinFrequency(1, 44100), desc + "frequency of peak bin");
+}
+
+int main()
+{
+    try
+    {
+        /* Powers of two, mixed radices, and prime sizes */
+        for (std::size_t size : { 1, 2, 8, 64, 1024, 12, 360, 1000, 7, 11, 97, 2 * 3 * 5 * 7 * 11 })
+            TestComplexFFT(size);
+
+        for (std::size_t size : { 2, 16, 1024, 480, 9, 101 })
+            TestRealFFT(size);
+
+        TestGetFastSize();
+        TestWindow();
+        TestSTFT(1024, 256);
+        TestSTFT(1000, 500);
+        TestSTFT(512, 384);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return CheckResult();
+}
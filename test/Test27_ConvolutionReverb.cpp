@@ -0,0 +1,152 @@
+/*
+ * Test27_ConvolutionReverb.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "TestUtil.h"
+#include <random>
+
+
+static std::vector<float> GenerateNoise(std::size_t size, unsigned seed, float amplitude)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-amplitude, amplitude);
+
+    std::vector<float> samples(size);
+    for (auto& s : samples)
+        s = dist(rng);
+
+    return samples;
+}
+
+// Generates an impulse response of exponentially decaying noise.
+static Ac::WaveBuffer GenerateImpulseResponse(std::size_t frames, std::uint16_t channels)
+{
+    auto noise = GenerateNoise(frames * channels, 1, 0.05f);
+
+    for (std::size_t i = 0; i < frames; ++i)
+    {
+        for (std::uint16_t chn = 0; chn < channels; ++chn)
+            noise[i*channels + chn] *= static_cast<float>(std::exp(-4.0 * static_cast<double>(i) / frames));
+    }
+
+    Ac::WaveBuffer impulseResponse(Ac::WaveBufferFormat(44100, 32, channels, true));
+    impulseResponse.SetSampleFrames(frames);
+    impulseResponse.WriteFrames(0, frames, noise.data());
+
+    return impulseResponse;
+}
+
+// Returns the output sample of the direct convolution (in double precision) of the interleaved input with the interleaved impulse response.
+static double ConvolveReference(
+    const std::vector<float>&   input,
+    std::uint16_t               channels,
+    const std::vector<float>&   impulseResponse,
+    std::uint16_t               irChannels,
+    std::size_t                 index,
+    std::uint16_t               channel)
+{
+    const auto irChannel    = static_cast<std::uint16_t>(channel % irChannels);
+    const auto irFrames     = impulseResponse.size() / irChannels;
+
+    double sum = 0.0;
+    for (std::size_t k = 0; k < irFrames && k <= index; ++k)
+        sum += static_cast<double>(impulseResponse[k*irChannels + irChannel]) * input[(index - k)*channels + channel];
+
+    return sum;
+}
+
+static void TestReverb(std::size_t irFrames, std::uint16_t irChannels, std::size_t blockSize)
+{
+    const auto desc = "IR " + std::to_string(irFrames) + "x" + std::to_string(irChannels) + ", block size " + std::to_string(blockSize) + ": ";
+
+    const std::uint16_t channels = 2;
+    const std::size_t   frames   = irFrames + 20000;
+
+    const auto impulseResponse  = GenerateImpulseResponse(irFrames, irChannels);
+    const auto input            = GenerateNoise(frames * channels, 2, 0.5f);
+
+    Ac::ConvolutionReverb reverb(impulseResponse, channels, blockSize);
+    reverb.SetWetGain(0.5f);
+    reverb.SetDryGain(0.25f);
+
+    Check(reverb.GetLatency() == blockSize, desc + "latency equals block size");
+    Check(reverb.GetTailFrames() == irFrames, desc + "tail equals length of impulse response");
+
+    /* Process the input in blocks of varying size */
+    auto output = input;
+    const std::size_t blockFrames[] = { 1, 100, 333, 4096, 7, 1000 };
+
+    for (std::size_t i = 0, j = 0; i < frames; j = (j + 1) % 6)
+    {
+        auto n = std::min(blockFrames[j], frames - i);
+        reverb.Process(output.data() + i*channels, n);
+        i += n;
+    }
+
+    /* Compare with the delayed direct convolution at the beginning and at samples spread over all partitions */
+    const auto latency = reverb.GetLatency();
+
+    std::vector<float> ir(irFrames * irChannels);
+    impulseResponse.ReadFrames(0, irFrames, ir.data());
+
+    double maxError = 0.0;
+    for (std::size_t i = 0; i < frames; i += (i < 2000 ? 1 : 97))
+    {
+        for (std::uint16_t chn = 0; chn < channels; ++chn)
+        {
+            double expected = 0.0;
+            if (i >= latency)
+                expected = 0.5 * ConvolveReference(input, channels, ir, irChannels, i - latency, chn) + 0.25 * input[(i - latency)*channels + chn];
+            maxError = std::max(maxError, std::abs(output[i*channels + chn] - expected));
+        }
+    }
+    CheckNear(maxError, 0.0, 1.0e-4, desc + "max. error against direct convolution");
+
+    /* Reset clears the input history, so a second pass must produce the same output */
+    reverb.Reset();
+
+    auto output2 = input;
+    reverb.Process(output2.data(), frames);
+
+    double maxDiff = 0.0;
+    for (std::size_t i = 0; i < output.size(); ++i)
+        maxDiff = std::max(maxDiff, static_cast<double>(std::abs(output[i] - output2[i])));
+    CheckNear(maxDiff, 0.0, 1.0e-6, desc + "output after Reset equals first output");
+}
+
+static void TestInvalidArguments()
+{
+    const auto impulseResponse = GenerateImpulseResponse(100, 1);
+
+    bool thrown = false;
+    try
+    {
+        Ac::ConvolutionReverb reverb(impulseResponse, 2, 0);
+    }
+    catch (const std::invalid_argument&)
+    {
+        thrown = true;
+    }
+    Check(thrown, "zero block size throws std::invalid_argument");
+}
+
+int main()
+{
+    try
+    {
+        TestReverb(1, 1, 64);
+        TestReverb(3000, 1, 256);
+        TestReverb(20000, 2, 128);
+        TestInvalidArguments();
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return CheckResult();
+}
@@ -0,0 +1,215 @@
+/*
+ * Test28_FDNReverb.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "TestUtil.h"
+#include <stdexcept>
+
+
+static const std::uint32_t sampleRate = 44100;
+
+// Returns the wet-only parameters without damping, so that all frequencies decay with the specified decay time.
+static Ac::Synthesizer::FDNReverbParameters WetParameters(double decayTime, double roomSize = 0.5)
+{
+    Ac::Synthesizer::FDNReverbParameters params;
+    params.roomSize     = roomSize;
+    params.decayTime    = decayTime;
+    params.damping      = 0.0;
+    params.wetGain      = 1.0;
+    params.dryGain      = 0.0;
+    return params;
+}
+
+// Returns the impulse response of the reverb for the first channel.
+static std::vector<float> ImpulseResponse(Ac::Synthesizer::FDNReverb& reverb, std::size_t frames)
+{
+    const auto channels = reverb.GetChannels();
+
+    std::vector<float> samples(frames * channels, 0.0f);
+    samples[0] = 1.0f;
+    reverb.Process(samples.data(), frames);
+
+    std::vector<float> response(frames);
+    for (std::size_t i = 0; i < frames; ++i)
+        response[i] = samples[i * channels];
+
+    return response;
+}
+
+// Returns the time (in seconds) when the Schroeder energy decay curve of the impulse response falls below the specified level (in dB).
+static double DecayTime(const std::vector<float>& response, double level)
+{
+    std::vector<double> energy(response.size() + 1, 0.0);
+    for (std::size_t i = response.size(); i-- > 0;)
+        energy[i] = energy[i + 1] + static_cast<double>(response[i]) * response[i];
+
+    const auto threshold = energy[0] * std::pow(10.0, level / 10.0);
+    for (std::size_t i = 0; i < response.size(); ++i)
+    {
+        if (energy[i] < threshold)
+            return static_cast<double>(i) / sampleRate;
+    }
+
+    return static_cast<double>(response.size()) / sampleRate;
+}
+
+static void TestDecayTime(double decayTime, std::size_t numDelayLines)
+{
+    const auto desc = "T60 = " + ToStr(decayTime) + " s, " + std::to_string(numDelayLines) + " delay lines: ";
+
+    Ac::Synthesizer::FDNReverb reverb(sampleRate, 1, WetParameters(decayTime), numDelayLines);
+    Check(reverb.GetNumDelayLines() == numDelayLines, desc + "number of delay lines");
+
+    /*
+    The energy decay curve is integrated over 2*T60, so the decay to -60 dB is measured from the extrapolated decay
+    between -5 dB and -35 dB (like the T30 measure), which is not affected by the truncated tail
+    */
+    auto response = ImpulseResponse(reverb, static_cast<std::size_t>(2.0 * decayTime * sampleRate));
+    auto t5 = DecayTime(response, -5.0), t35 = DecayTime(response, -35.0);
+    auto measured = (t35 - t5) * 2.0;
+
+    CheckNear(measured, decayTime, decayTime * 0.05, desc + "decay reaches -60 dB near T60");
+
+    /* Tail includes the longest delay line */
+    const auto t60 = static_cast<std::size_t>(decayTime * sampleRate);
+    Check(reverb.GetTailFrames() >= t60 && reverb.GetTailFrames() <= t60 + sampleRate / 5, desc + "tail frames");
+
+    /* The response must have decayed by about 60 dB after T60 (measured in windows after the initial build-up) */
+    double early = 0.0, late = 0.0;
+    const auto window = sampleRate / 20;
+    for (std::size_t i = window; i < window * 2; ++i)
+    {
+        early   += static_cast<double>(response[i]) * response[i];
+        late    += static_cast<double>(response[t60 + i]) * response[t60 + i];
+    }
+    CheckNear(10.0 * std::log10(late / early), -60.0, 6.0, desc + "level after T60");
+}
+
+static void TestBlockSizes()
+{
+    /* Processing in single frames results in the same samples as processing in large blocks */
+    auto params = WetParameters(1.5, 0.3);
+    params.damping = 0.4;
+    params.dryGain = 0.5;
+
+    Ac::Synthesizer::FDNReverb a(sampleRate, 2, params), b(sampleRate, 2, params);
+
+    std::vector<float> input(2 * 20000);
+    for (std::size_t i = 0; i < input.size(); ++i)
+        input[i] = static_cast<float>(std::sin(0.01 * static_cast<double>(i)) * (i < 4000 ? 0.5 : 0.0));
+
+    auto blocks = input, frames = input;
+    a.Process(blocks.data(), 20000);
+    for (std::size_t i = 0; i < 20000; ++i)
+        b.Process(frames.data() + i * 2, 1);
+
+    Check(blocks == frames, "single frames result in identical samples");
+
+    /* The output channels are decorrelated */
+    double correlation = 0.0, energyL = 0.0, energyR = 0.0;
+    for (std::size_t i = 8000; i < 20000; ++i)
+    {
+        correlation += blocks[i*2] * blocks[i*2 + 1];
+        energyL     += blocks[i*2] * blocks[i*2];
+        energyR     += blocks[i*2 + 1] * blocks[i*2 + 1];
+    }
+    CheckNear(correlation / std::sqrt(energyL * energyR), 0.0, 0.5, "output channels are decorrelated");
+
+    /* Reset clears the delay lines */
+    a.Reset();
+    std::vector<float> silence(2 * 1000, 0.0f);
+    a.Process(silence.data(), 1000);
+    Check(std::all_of(silence.begin(), silence.end(), [](float s) { return s == 0.0f; }), "Reset clears the delay lines");
+}
+
+static void TestParameters()
+{
+    /* Dry signal only */
+    auto params = WetParameters(1.0);
+    params.wetGain = 0.0;
+    params.dryGain = 1.0;
+
+    Ac::Synthesizer::FDNReverb dry(sampleRate, 1, params, 8);
+    std::vector<float> samples(5000);
+    for (std::size_t i = 0; i < samples.size(); ++i)
+        samples[i] = static_cast<float>(std::sin(0.05 * static_cast<double>(i)));
+    auto input = samples;
+    dry.Process(samples.data(), samples.size());
+    Check(samples == input, "dry signal is passed through");
+
+    /* Parameters are clamped */
+    params.roomSize = 2.0;
+    params.damping  = 1.5;
+    params.decayTime = -1.0;
+    dry.SetParameters(params);
+    Check(dry.GetParameters().roomSize <= 1.0 && dry.GetParameters().damping < 1.0 && dry.GetParameters().decayTime > 0.0, "parameters are clamped");
+
+    /* Invalid arguments */
+    auto throwsInvalidArgument = [](std::uint32_t rate, std::uint16_t channels, std::size_t numDelayLines)
+    {
+        try
+        {
+            Ac::Synthesizer::FDNReverb reverb(rate, channels, {}, numDelayLines);
+        }
+        catch (const std::invalid_argument&)
+        {
+            return true;
+        }
+        return false;
+    };
+
+    Check(throwsInvalidArgument(0, 2, 16), "zero sample rate throws std::invalid_argument");
+    Check(throwsInvalidArgument(sampleRate, 0, 16), "zero channels throws std::invalid_argument");
+    Check(throwsInvalidArgument(sampleRate, 2, 12), "invalid number of delay lines throws std::invalid_argument");
+}
+
+static void TestReverbWaveBuffer()
+{
+    /* Reverb of a wave buffer equals the reverb of its samples */
+    Ac::WaveBuffer buffer(Ac::WaveBufferFormat(sampleRate, 32, 2, true));
+    buffer.SetSampleFrames(10000);
+    buffer.WriteSample(std::size_t(0u), 0, 1.0);
+    buffer.WriteSample(std::size_t(0u), 1, -0.5);
+
+    auto params = WetParameters(0.8);
+    Ac::Synthesizer::ReverbWaveBuffer(buffer, params);
+
+    Ac::Synthesizer::FDNReverb reverb(sampleRate, 2, params);
+    std::vector<float> samples(2 * 10000, 0.0f);
+    samples[0] = 1.0f;
+    samples[1] = -0.5f;
+    reverb.Process(samples.data(), 10000);
+
+    double maxError = 0.0;
+    for (std::size_t i = 0; i < 10000; ++i)
+    {
+        for (std::uint16_t chn = 0; chn < 2; ++chn)
+            maxError = std::max(maxError, std::abs(buffer.ReadSample(i, chn) - samples[i*2 + chn]));
+    }
+    CheckNear(maxError, 0.0, 1.0e-6, "ReverbWaveBuffer equals FDNReverb");
+    Check(Ac::Synthesizer::GetPeakLevel(buffer) > 0.0, "ReverbWaveBuffer generates a reverb tail");
+}
+
+int main()
+{
+    try
+    {
+        TestDecayTime(0.5, 16);
+        TestDecayTime(1.0, 16);
+        TestDecayTime(1.0, 8);
+        TestDecayTime(2.5, 16);
+        TestBlockSizes();
+        TestParameters();
+        TestReverbWaveBuffer();
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return CheckResult();
+}
@@ -0,0 +1,310 @@
+/*
+ * Test29_BiquadFilter.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "TestUtil.h"
+#include <complex>
+#include <stdexcept>
+
+
+static const std::uint32_t sampleRate = 48000;
+
+// Returns the magnitude response (in dB) of the specified coefficients at the specified frequency.
+static double MagnitudeDB(const Ac::BiquadCoefficients& c, double frequency)
+{
+    const auto w = 2.0 * M_PI * frequency / sampleRate;
+    const auto z1 = std::polar(1.0, -w), z2 = std::polar(1.0, -2.0 * w);
+
+    auto h = (static_cast<double>(c.b0) + static_cast<double>(c.b1) * z1 + static_cast<double>(c.b2) * z2)
+           / (1.0 + static_cast<double>(c.a1) * z1 + static_cast<double>(c.a2) * z2);
+
+    return 20.0 * std::log10(std::abs(h));
+}
+
+// Filters the samples with a scalar reference implementation of the transposed direct form II.
+static void ReferenceFilter(const Ac::BiquadCoefficients& c, float* samples, std::size_t frames, std::size_t stride)
+{
+    float z1 = 0.0f, z2 = 0.0f;
+    for (std::size_t i = 0; i < frames; ++i)
+    {
+        auto x = samples[i * stride];
+        auto y = c.b0 * x + z1;
+        z1 = c.b1 * x - c.a1 * y + z2;
+        z2 = c.b2 * x - c.a2 * y;
+        samples[i * stride] = y;
+    }
+}
+
+// Returns the steady-state gain (in dB) of the filter bank for a sine wave with the specified frequency.
+static double MeasuredGainDB(const Ac::BiquadCoefficients& c, double frequency)
+{
+    const std::size_t frames = sampleRate;
+
+    std::vector<float> samples(frames);
+    for (std::size_t i = 0; i < frames; ++i)
+        samples[i] = static_cast<float>(std::sin(2.0 * M_PI * frequency * static_cast<double>(i) / sampleRate));
+
+    Ac::BiquadFilterBank bank(1);
+    bank.SetFilter(c, true);
+    bank.Process(samples.data(), frames);
+
+    /* Measure the second half, after the filter has settled */
+    double energy = 0.0;
+    for (std::size_t i = frames / 2; i < frames; ++i)
+        energy += static_cast<double>(samples[i]) * samples[i];
+
+    return 10.0 * std::log10(energy / (frames / 2) * 2.0);
+}
+
+static void TestMagnitudeResponse()
+{
+    using Ac::BiquadType;
+    using Ac::BiquadCoefficients;
+
+    const double f = 1000.0;
+
+    /* Butterworth low-pass and high-pass filters are -3 dB at the cutoff frequency */
+    auto lowPass = BiquadCoefficients::Compute(BiquadType::LowPass, sampleRate, f);
+    CheckNear(MagnitudeDB(lowPass, f), -3.0103, 0.01, "low-pass: -3 dB at the cutoff frequency");
+    CheckNear(MagnitudeDB(lowPass, 10.0), 0.0, 0.01, "low-pass: 0 dB in the pass band");
+    CheckNear(MagnitudeDB(lowPass, 8000.0), -20.0 * std::log10(std::pow(8.0, 2.0)), 3.0, "low-pass: -12 dB per octave in the stop band");
+    CheckNear(MeasuredGainDB(lowPass, f), -3.0103, 0.05, "low-pass: measured gain at the cutoff frequency");
+
+    auto highPass = BiquadCoefficients::Compute(BiquadType::HighPass, sampleRate, f);
+    CheckNear(MagnitudeDB(highPass, f), -3.0103, 0.01, "high-pass: -3 dB at the cutoff frequency");
+    CheckNear(MagnitudeDB(highPass, 20000.0), 0.0, 0.05, "high-pass: 0 dB in the pass band");
+    CheckNear(MeasuredGainDB(highPass, f), -3.0103, 0.05, "high-pass: measured gain at the cutoff frequency");
+
+    /* Resonance of the low-pass filter */
+    auto resonant = BiquadCoefficients::Compute(BiquadType::LowPass, sampleRate, f, 4.0);
+    CheckNear(MagnitudeDB(resonant, f), 20.0 * std::log10(4.0), 0.05, "low-pass: Q factor is the gain at the cutoff frequency");
+
+    /* Band-pass filter has 0 dB at the center frequency */
+    auto bandPass = BiquadCoefficients::Compute(BiquadType::BandPass, sampleRate, f, 2.0);
+    CheckNear(MagnitudeDB(bandPass, f), 0.0, 0.01, "band-pass: 0 dB at the center frequency");
+    Check(MagnitudeDB(bandPass, 100.0) < -15.0 && MagnitudeDB(bandPass, 10000.0) < -15.0, "band-pass: attenuation outside of the band");
+    CheckNear(MeasuredGainDB(bandPass, f), 0.0, 0.05, "band-pass: measured gain at the center frequency");
+
+    /* Notch filter removes the center frequency */
+    auto notch = BiquadCoefficients::Compute(BiquadType::Notch, sampleRate, f, 2.0);
+    Check(MagnitudeDB(notch, f) < -60.0, "notch: center frequency is removed");
+    CheckNear(MagnitudeDB(notch, 50.0), 0.0, 0.1, "notch: 0 dB outside of the band");
+
+    /* Peaking filter has the gain at the center frequency */
+    for (double gain : { 6.0, -9.0 })
+    {
+        auto peaking = BiquadCoefficients::Compute(BiquadType::Peaking, sampleRate, f, 1.5, gain);
+        CheckNear(MagnitudeDB(peaking, f), gain, 0.01, "peaking (" + ToStr(gain) + " dB): gain at the center frequency");
+        CheckNear(MagnitudeDB(peaking, 20.0), 0.0, 0.05, "peaking (" + ToStr(gain) + " dB): 0 dB apart from the center frequency");
+        CheckNear(MeasuredGainDB(peaking, f), gain, 0.05, "peaking (" + ToStr(gain) + " dB): measured gain at the center frequency");
+    }
+
+    /* Shelf filters have the gain on one side, and half of the gain at the corner frequency */
+    auto lowShelf = BiquadCoefficients::Compute(BiquadType::LowShelf, sampleRate, f, 0.7071067811865476, 6.0);
+    CheckNear(MagnitudeDB(lowShelf, 5.0), 6.0, 0.05, "low-shelf: gain below the corner frequency");
+    CheckNear(MagnitudeDB(lowShelf, f), 3.0, 0.05, "low-shelf: half of the gain at the corner frequency");
+    CheckNear(MagnitudeDB(lowShelf, 20000.0), 0.0, 0.05, "low-shelf: 0 dB above the corner frequency");
+
+    auto highShelf = BiquadCoefficients::Compute(BiquadType::HighShelf, sampleRate, f, 0.7071067811865476, -6.0);
+    CheckNear(MagnitudeDB(highShelf, 20000.0), -6.0, 0.05, "high-shelf: gain above the corner frequency");
+    CheckNear(MagnitudeDB(highShelf, f), -3.0, 0.05, "high-shelf: half of the gain at the corner frequency");
+    CheckNear(MagnitudeDB(highShelf, 5.0), 0.0, 0.05, "high-shelf: 0 dB below the corner frequency");
+
+    /* Invalid arguments */
+    bool thrown = false;
+    try
+    {
+        BiquadCoefficients::Compute(BiquadType::LowPass, sampleRate, f, 0.0);
+    }
+    catch (const std::invalid_argument&)
+    {
+        thrown = true;
+    }
+    Check(thrown, "non-positive Q factor throws std::invalid_argument");
+}
+
+static void TestFilterBank(std::size_t numLanes)
+{
+    const auto desc = std::to_string(numLanes) + " lane(s): ";
+    const std::size_t frames = 3000;
+
+    /* Individual filters for each lane */
+    Ac::BiquadFilterBank bank(numLanes);
+    std::vector<Ac::BiquadCoefficients> coeffs(numLanes);
+    for (std::size_t i = 0; i < numLanes; ++i)
+    {
+        coeffs[i] = Ac::BiquadCoefficients::Compute(Ac::BiquadType::LowPass, sampleRate, 200.0 + 300.0 * i, 0.5 + 0.1 * i);
+        bank.SetFilter(i, coeffs[i], true);
+    }
+
+    Check(bank.GetNumLanes() == numLanes && bank.GetChannels() == numLanes, desc + "number of lanes");
+    Check(bank.GetFilter(numLanes - 1).b0 == coeffs.back().b0, desc + "GetFilter");
+
+    std::vector<float> input(frames * numLanes);
+    for (std::size_t i = 0; i < input.size(); ++i)
+        input[i] = static_cast<float>(std::sin(0.37 * static_cast<double>(i)) + 0.3 * std::sin(0.011 * static_cast<double>(i)));
+
+    /* Interleaved samples */
+    auto interleaved = input;
+    bank.Process(interleaved.data(), frames);
+
+    auto reference = input;
+    for (std::size_t i = 0; i < numLanes; ++i)
+        ReferenceFilter(coeffs[i], reference.data() + i, frames, numLanes);
+
+    double maxError = 0.0;
+    for (std::size_t i = 0; i < input.size(); ++i)
+        maxError = std::max(maxError, std::abs(static_cast<double>(interleaved[i]) - reference[i]));
+    CheckNear(maxError, 0.0, 1.0e-5, desc + "interleaved lanes equal the scalar reference");
+
+    /* Planar samples */
+    std::vector<std::vector<float>> planar(numLanes, std::vector<float>(frames));
+    std::vector<float*> lanes(numLanes);
+    for (std::size_t i = 0; i < numLanes; ++i)
+    {
+        for (std::size_t j = 0; j < frames; ++j)
+            planar[i][j] = input[j * numLanes + i];
+        lanes[i] = planar[i].data();
+    }
+
+    bank.Reset();
+    bank.ProcessPlanar(lanes.data(), frames);
+
+    maxError = 0.0;
+    for (std::size_t i = 0; i < numLanes; ++i)
+    {
+        for (std::size_t j = 0; j < frames; ++j)
+            maxError = std::max(maxError, std::abs(static_cast<double>(planar[i][j]) - interleaved[j * numLanes + i]));
+    }
+    CheckNear(maxError, 0.0, 1.0e-6, desc + "planar lanes equal interleaved lanes");
+}
+
+static void TestSmoothing()
+{
+    const std::size_t frames = 20000;
+
+    auto from   = Ac::BiquadCoefficients::Compute(Ac::BiquadType::LowPass, sampleRate, 500.0);
+    auto to     = Ac::BiquadCoefficients::Compute(Ac::BiquadType::LowPass, sampleRate, 5000.0);
+
+    std::vector<float> input(frames);
+    for (std::size_t i = 0; i < frames; ++i)
+        input[i] = static_cast<float>(std::sin(0.3 * static_cast<double>(i)));
+
+    /* Smoothed coefficient change converges to the immediate change */
+    Ac::BiquadFilterBank smooth(1), immediate(1), instant(1);
+    smooth.SetFilter(from, true);
+    smooth.SetFilter(to);
+
+    immediate.SetFilter(to, true);
+
+    instant.SetSmoothingFrames(0);
+    instant.SetFilter(from, true);
+    instant.SetFilter(to);
+
+    auto a = input, b = input, c = input;
+    smooth.Process(a.data(), frames);
+    immediate.Process(b.data(), frames);
+    instant.Process(c.data(), frames);
+
+    Check(std::abs(a[10] - b[10]) > 1.0e-3, "smoothed change starts with the old coefficients");
+    CheckNear(a.back(), b.back(), 1.0e-5, "smoothed change converges to the new coefficients");
+    Check(c == b, "no smoothing applies the coefficients immediately");
+
+    /* Invalid arguments */
+    bool thrownOutOfRange = false, thrownInvalid = false;
+    try
+    {
+        smooth.SetFilter(1, to);
+    }
+    catch (const std::out_of_range&)
+    {
+        thrownOutOfRange = true;
+    }
+    try
+    {
+        Ac::BiquadFilterBank invalid(0);
+    }
+    catch (const std::invalid_argument&)
+    {
+        thrownInvalid = true;
+    }
+    Check(thrownOutOfRange, "invalid lane index throws std::out_of_range");
+    Check(thrownInvalid, "zero lanes throws std::invalid_argument");
+}
+
+static void TestEqualizer()
+{
+    const std::size_t frames = 5000;
+
+    Ac::WaveBuffer original(Ac::WaveBufferFormat(sampleRate, 32, 2, true));
+    original.SetSampleFrames(frames);
+    original.ForEachSample(
+        [](double& sample, std::uint16_t channel, std::size_t index, double /*timePoint*/)
+        {
+            sample = 0.4 * std::sin(0.05 * static_cast<double>(index) * (channel + 1)) + 0.2 * std::sin(1.3 * static_cast<double>(index));
+        }
+    );
+
+    /* Equalizer without bands passes the samples through */
+    Ac::ParametricEqualizer eq(sampleRate, 2);
+    auto buffer = original;
+    eq.ProcessWaveBuffer(buffer);
+    Check(std::equal(buffer.Data(), buffer.Data() + buffer.BufferSize(), original.Data()), "equalizer without bands passes the samples through");
+
+    /* Cascade of bands equals the cascade of filter functions */
+    eq.AddBand({ Ac::BiquadType::HighPass, 80.0 });
+    auto peakIndex = eq.AddBand({ Ac::BiquadType::Peaking, 2500.0, 1.5, -4.0 });
+    Check(eq.GetNumBands() == 2 && eq.GetBand(peakIndex).gain == -4.0, "equalizer bands");
+
+    buffer = original;
+    eq.Reset();
+    eq.ProcessWaveBuffer(buffer);
+
+    auto reference = original;
+    Ac::Synthesizer::FilterWaveBuffer(reference, Ac::BiquadType::HighPass, 80.0);
+    Ac::Synthesizer::FilterWaveBuffer(reference, Ac::BiquadType::Peaking, 2500.0, 1.5, -4.0);
+
+    double maxError = 0.0;
+    for (std::size_t i = 0; i < frames; ++i)
+    {
+        for (std::uint16_t chn = 0; chn < 2; ++chn)
+            maxError = std::max(maxError, std::abs(buffer.ReadSample(i, chn) - reference.ReadSample(i, chn)));
+    }
+    CheckNear(maxError, 0.0, 1.0e-6, "equalizer equals the cascade of FilterWaveBuffer");
+
+    eq.ClearBands();
+    Check(eq.GetNumBands() == 0, "ClearBands");
+
+    bool thrown = false;
+    try
+    {
+        eq.GetBand(0);
+    }
+    catch (const std::out_of_range&)
+    {
+        thrown = true;
+    }
+    Check(thrown, "invalid band index throws std::out_of_range");
+}
+
+int main()
+{
+    try
+    {
+        TestMagnitudeResponse();
+        for (std::size_t numLanes : { 1, 2, 3, 5, 8, 13 })
+            TestFilterBank(numLanes);
+        TestSmoothing();
+        TestEqualizer();
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return CheckResult();
+}
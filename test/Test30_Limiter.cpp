@@ -0,0 +1,189 @@
+/*
+ * Test30_Limiter.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "TestUtil.h"
+#include <random>
+
+
+// Generates a stereo signal with a quiet tone and loud bursts of noise.
+static std::vector<float> GenerateBursts(std::uint32_t sampleRate, std::size_t frames)
+{
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> dist(-1.5f, 1.5f);
+
+    std::vector<float> samples(frames * 2);
+
+    for (std::size_t i = 0; i < frames; ++i)
+    {
+        auto t = static_cast<double>(i) / sampleRate;
+        auto tone = static_cast<float>(0.3 * std::sin(2.0 * M_PI * 220.0 * t));
+        auto burst = ((i / 2000) % 5 == 2);
+
+        samples[i*2    ] = (burst ? dist(rng) : tone);
+        samples[i*2 + 1] = (burst ? dist(rng) : -tone);
+    }
+
+    return samples;
+}
+
+/*
+Returns the output of the limiter algorithm (in double precision): the required gains of the sample frames,
+their minimum within the window of 'lookAhead + 1' sample frames, the release, and the moving average over the same window.
+*/
+static std::vector<double> LimitReference(
+    const std::vector<float>&   input,
+    std::uint32_t               sampleRate,
+    double                      ceilingDB,
+    double                      releaseTime,
+    std::size_t                 lookAhead)
+{
+    const auto frames   = input.size() / 2;
+    const auto window   = lookAhead + 1;
+    const auto ceiling  = static_cast<double>(static_cast<float>(std::pow(10.0, ceilingDB / 20.0)));
+    const auto release  = std::exp(-1.0 / (releaseTime * sampleRate));
+
+    std::vector<double> required(frames), envelopes(frames), output(input.size(), 0.0);
+
+    for (std::size_t i = 0; i < frames; ++i)
+    {
+        auto peak = std::max(std::abs(input[i*2]), std::abs(input[i*2 + 1]));
+        required[i] = ceiling / std::max(static_cast<double>(peak), ceiling);
+    }
+
+    double envelope = 1.0;
+
+    for (std::size_t i = 0; i < frames; ++i)
+    {
+        /* Minimum within the window (gains before the first sample frame are one) */
+        auto minimum = 1.0;
+        for (std::size_t j = (i + 1 >= window ? i + 1 - window : 0); j <= i; ++j)
+            minimum = std::min(minimum, required[j]);
+
+        envelope = (minimum < envelope ? minimum : minimum + release * (envelope - minimum));
+        envelopes[i] = envelope;
+
+        /* Moving average over the window */
+        auto sum = 0.0;
+        for (std::size_t j = 0; j < window; ++j)
+            sum += (i >= j ? envelopes[i - j] : 1.0);
+        auto gain = sum / static_cast<double>(window);
+
+        /* Apply the gain to the delayed sample frame */
+        if (i >= lookAhead)
+        {
+            for (std::size_t chn = 0; chn < 2; ++chn)
+                output[i*2 + chn] = std::max(-ceiling, std::min(input[(i - lookAhead)*2 + chn] * gain, ceiling));
+        }
+    }
+
+    return output;
+}
+
+static void TestLimiter(double lookAheadTime)
+{
+    const auto desc = "look-ahead " + std::to_string(lookAheadTime) + " s: ";
+
+    const std::uint32_t sampleRate  = 44100;
+    const std::size_t   frames      = 20000;
+
+    Ac::LimiterParameters params;
+    params.ceiling      = -1.0;
+    params.releaseTime  = 0.05;
+
+    const auto input = GenerateBursts(sampleRate, frames);
+
+    Ac::Limiter limiter(sampleRate, 2, params, lookAheadTime);
+
+    const auto expectedLatency = std::max(std::size_t(1u), static_cast<std::size_t>(lookAheadTime * sampleRate + 0.5));
+    Check(limiter.GetLatency() == expectedLatency, desc + "latency");
+
+    /* Process in blocks of varying size and at once */
+    auto output = input;
+    const std::size_t blockFrames[] = { 1, 500, 2047, 64, 3000 };
+
+    for (std::size_t i = 0, j = 0; i < frames; j = (j + 1) % 5)
+    {
+        auto n = std::min(blockFrames[j], frames - i);
+        limiter.Process(output.data() + i*2, n);
+        i += n;
+    }
+
+    limiter.Reset();
+
+    auto outputWhole = input;
+    limiter.Process(outputWhole.data(), frames);
+
+    Check(output == outputWhole, desc + "block-wise output equals output at once");
+
+    /* The output must never exceed the ceiling and match the reference */
+    const auto ceiling = std::pow(10.0, params.ceiling / 20.0);
+
+    double peak = 0.0;
+    for (auto s : output)
+        peak = std::max(peak, static_cast<double>(std::abs(s)));
+    Check(peak <= ceiling + 1.0e-6, desc + "peak does not exceed ceiling (" + std::to_string(peak) + ")");
+
+    const auto expected = LimitReference(input, sampleRate, params.ceiling, params.releaseTime, limiter.GetLatency());
+
+    double maxError = 0.0;
+    for (std::size_t i = 0; i < output.size(); ++i)
+        maxError = std::max(maxError, std::abs(output[i] - expected[i]));
+    CheckNear(maxError, 0.0, 1.0e-5, desc + "max. error against reference");
+
+    /* The quiet tone before the first burst must pass unchanged, only delayed */
+    double toneError = 0.0;
+    for (std::size_t i = limiter.GetLatency(); i < 4000 - limiter.GetLatency() * 2; ++i)
+        toneError = std::max(toneError, static_cast<double>(std::abs(output[i*2] - input[(i - limiter.GetLatency())*2])));
+    CheckNear(toneError, 0.0, 1.0e-7, desc + "quiet signal is only delayed");
+}
+
+static void TestLimitWaveBuffer()
+{
+    /* Quiet tone with a single loud peak */
+    Ac::WaveBuffer buffer(Ac::WaveBufferFormat(44100, 32, 1, true));
+    buffer.SetSampleFrames(10000);
+    buffer.ForEachSample(
+        [](double& sample, std::uint16_t /*channel*/, std::size_t index, double timePoint)
+        {
+            sample = (index == 5000 ? 1.0 : 0.2 * std::sin(2.0 * M_PI * 440.0 * timePoint));
+        }
+    );
+
+    const auto original = buffer;
+
+    Ac::LimiterParameters params;
+    params.ceiling = -6.0;
+    Ac::Synthesizer::LimitWaveBuffer(buffer, params);
+
+    const auto ceiling = std::pow(10.0, params.ceiling / 20.0);
+
+    Check(buffer.GetSampleFrames() == original.GetSampleFrames(), "LimitWaveBuffer: number of sample frames");
+    CheckNear(buffer.ReadSample(std::size_t(5000u), 0), ceiling, 1.0e-5, "LimitWaveBuffer: peak is limited to the ceiling without time shift");
+
+    double maxError = 0.0;
+    for (std::size_t i = 0; i < 4000; ++i)
+        maxError = std::max(maxError, std::abs(buffer.ReadSample(i, 0) - original.ReadSample(i, 0)));
+    CheckNear(maxError, 0.0, 1.0e-7, "LimitWaveBuffer: samples before the look-ahead are unchanged");
+}
+
+int main()
+{
+    try
+    {
+        TestLimiter(0.005);
+        TestLimiter(0.0);
+        TestLimiter(0.02);
+        TestLimitWaveBuffer();
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return CheckResult();
+}
@@ -0,0 +1,334 @@
+/*
+ * Test31_Crossfade.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "TestUtil.h"
+#include <stdexcept>
+
+
+static const std::uint32_t sampleRate = 44100;
+
+// Audio stream which streams the samples of a wave buffer, but at most 'maxFrames' sample frames per call.
+class BufferStream : public Ac::AudioStream
+{
+
+    public:
+
+        BufferStream(const Ac::WaveBuffer& buffer, std::size_t maxFrames) :
+            buffer_     { buffer    },
+            maxFrames_  { maxFrames }
+        {
+        }
+
+        std::size_t StreamWaveBuffer(const Ac::WaveBufferView& buffer) override
+        {
+            const auto channels = buffer_.GetFormat().channels;
+            const auto frames   = std::min({ buffer.GetSampleFrames(), maxFrames_, buffer_.GetSampleFrames() - position_ });
+
+            for (std::size_t i = 0; i < frames; ++i)
+            {
+                for (std::uint16_t chn = 0; chn < channels; ++chn)
+                    buffer.WriteSample(i, chn, buffer_.ReadSample(position_ + i, chn));
+            }
+
+            position_ += frames;
+            return frames * buffer_.GetFormat().BytesPerFrame();
+        }
+
+        using Ac::AudioStream::StreamWaveBuffer;
+
+        void Seek(double timePoint) override
+        {
+            position_ = std::min(buffer_.GetIndexFromTimePoint(timePoint), buffer_.GetSampleFrames());
+        }
+
+        double TotalTime() const override
+        {
+            return buffer_.GetTotalTime();
+        }
+
+        std::vector<std::string> InfoComments() const override
+        {
+            return {};
+        }
+
+        Ac::WaveBufferFormat GetFormat() const override
+        {
+            return buffer_.GetFormat();
+        }
+
+    private:
+
+        Ac::WaveBuffer  buffer_;
+        std::size_t     maxFrames_  = 0;
+        std::size_t     position_   = 0;
+
+};
+
+// Returns a float stereo wave buffer with a sine wave of the specified frequency.
+static Ac::WaveBuffer GenerateBuffer(std::size_t frames, double frequency)
+{
+    Ac::WaveBuffer buffer(Ac::WaveBufferFormat(sampleRate, 32, 2, true));
+    buffer.SetSampleFrames(frames);
+    buffer.ForEachSample(
+        [frequency](double& sample, std::uint16_t channel, std::size_t /*index*/, double timePoint)
+        {
+            sample = 0.5 * std::sin(2.0 * M_PI * frequency * timePoint + channel);
+        }
+    );
+    return buffer;
+}
+
+// Reads all sample frames of the stream in blocks of the specified size.
+static Ac::WaveBuffer ReadStream(Ac::AudioStream& stream, std::size_t frames, std::size_t blockSize)
+{
+    Ac::WaveBuffer output(stream.GetFormat());
+    output.SetSampleFrames(frames);
+
+    for (std::size_t i = 0; i < frames;)
+    {
+        auto n = stream.StreamWaveBuffer(Ac::WaveBufferView(output, i, std::min(blockSize, frames - i))) / output.GetFormat().BytesPerFrame();
+        if (n == 0)
+            break;
+        i += n;
+    }
+
+    return output;
+}
+
+static void TestCurves()
+{
+    /* Equal-power gains sum up to one in power, linear and S-curve gains sum up to one */
+    for (auto shape : { Ac::CrossfadeShape::Linear, Ac::CrossfadeShape::EqualPower, Ac::CrossfadeShape::SCurve })
+    {
+        const auto desc = std::string(shape == Ac::CrossfadeShape::Linear ? "linear" : shape == Ac::CrossfadeShape::EqualPower ? "equal-power" : "S-curve") + ": ";
+        const auto power = (shape == Ac::CrossfadeShape::EqualPower);
+
+        Ac::CrossfadeCurve curve(shape);
+
+        double maxError = 0.0;
+        for (int i = 0; i <= 10000; ++i)
+        {
+            auto t = static_cast<double>(i) / 10000.0;
+            auto out = static_cast<double>(curve.GetFadeOutGain(t)), in = static_cast<double>(curve.GetFadeInGain(t));
+            maxError = std::max(maxError, std::abs(power ? out*out + in*in - 1.0 : out + in - 1.0));
+        }
+        CheckNear(maxError, 0.0, 1.0e-5, desc + (power ? "squared gains sum up to one" : "gains sum up to one"));
+
+        CheckNear(curve.GetFadeOutGain(0.0), 1.0, 1.0e-6, desc + "fade-out gain at the start");
+        CheckNear(curve.GetFadeInGain(0.0), 0.0, 1.0e-6, desc + "fade-in gain at the start");
+        CheckNear(curve.GetFadeOutGain(1.0), 0.0, 1.0e-6, desc + "fade-out gain at the end");
+        CheckNear(curve.GetFadeInGain(1.0), 1.0, 1.0e-6, desc + "fade-in gain at the end");
+        CheckNear(curve.GetFadeInGain(-3.0), 0.0, 1.0e-6, desc + "position before the crossfade is clamped");
+        CheckNear(curve.GetFadeInGain(5.0), 1.0, 1.0e-6, desc + "position after the crossfade is clamped");
+
+        /* Gains of consecutive frames equal the single gains */
+        std::vector<float> gainsFrom(500), gainsTo(500);
+        curve.ComputeGains(-0.1, 0.003, 500, gainsFrom.data(), gainsTo.data());
+
+        maxError = 0.0;
+        for (std::size_t i = 0; i < 500; ++i)
+        {
+            auto t = -0.1 + 0.003 * static_cast<double>(i);
+            maxError = std::max(maxError, std::abs(static_cast<double>(gainsFrom[i]) - curve.GetFadeOutGain(t)));
+            maxError = std::max(maxError, std::abs(static_cast<double>(gainsTo[i]) - curve.GetFadeInGain(t)));
+        }
+        CheckNear(maxError, 0.0, 1.0e-6, desc + "ComputeGains equals the single gains");
+    }
+
+    /* Exact shapes */
+    Ac::CrossfadeCurve equalPower(Ac::CrossfadeShape::EqualPower), sCurve(Ac::CrossfadeShape::SCurve);
+    CheckNear(equalPower.GetFadeInGain(0.3), std::sin(0.3 * M_PI * 0.5), 1.0e-6, "equal-power: sine gain");
+    CheckNear(sCurve.GetFadeInGain(0.3), 0.5 - 0.5 * std::cos(0.3 * M_PI), 1.0e-6, "S-curve: raised cosine gain");
+
+    /* Curve from a fading function */
+    Ac::CrossfadeCurve quadratic([](double& t) { t = t*t; });
+    CheckNear(quadratic.GetFadeInGain(0.5), 0.25, 1.0e-6, "fading function: fade-in gain");
+    CheckNear(quadratic.GetFadeOutGain(0.5), 0.75, 1.0e-6, "fading function: fade-out gain");
+
+    Ac::CrossfadeCurve linear(Ac::Synthesizer::FadingFunction(nullptr));
+    CheckNear(linear.GetFadeInGain(0.3), 0.3, 1.0e-6, "null fading function is linear");
+}
+
+static void TestBlend()
+{
+    Ac::CrossfadeCurve curve(Ac::CrossfadeShape::EqualPower);
+
+    /* Blend equals the scalar crossfade for all channel counts (including the mono and stereo paths) */
+    for (std::uint16_t channels : { 1, 2, 3, 6 })
+    {
+        const std::size_t frames = 1037;
+        const double position = -0.05, step = 1.0 / 900.0;
+
+        std::vector<float> from(frames * channels), to(frames * channels), output(frames * channels);
+        for (std::size_t i = 0; i < from.size(); ++i)
+        {
+            from[i] = static_cast<float>(std::sin(0.1 * static_cast<double>(i)));
+            to[i]   = static_cast<float>(std::cos(0.07 * static_cast<double>(i)));
+        }
+
+        curve.Blend(output.data(), from.data(), to.data(), frames, channels, position, step);
+
+        double maxError = 0.0;
+        for (std::size_t i = 0; i < frames; ++i)
+        {
+            auto t = position + step * static_cast<double>(i);
+            for (std::uint16_t chn = 0; chn < channels; ++chn)
+            {
+                auto j = i * channels + chn;
+                auto expected = from[j] * curve.GetFadeOutGain(t) + to[j] * curve.GetFadeInGain(t);
+                maxError = std::max(maxError, std::abs(static_cast<double>(output[j]) - expected));
+            }
+        }
+        CheckNear(maxError, 0.0, 1.0e-5, std::to_string(channels) + " channel(s): Blend equals the scalar crossfade");
+
+        /* Output may be equal to the input */
+        curve.Blend(from.data(), from.data(), to.data(), frames, channels, position, step);
+        Check(from == output, std::to_string(channels) + " channel(s): in-place Blend");
+    }
+}
+
+static void TestFadeWaveBuffers()
+{
+    const auto bufferFrom   = GenerateBuffer(sampleRate, 440.0);
+    const auto bufferTo     = GenerateBuffer(sampleRate, 660.0);
+
+    Ac::CrossfadeCurve curve(Ac::CrossfadeShape::EqualPower);
+
+    Ac::WaveBuffer buffer(bufferFrom.GetFormat());
+    buffer.SetSampleFrames(sampleRate);
+    Ac::Synthesizer::FadeWaveBuffers(buffer, bufferFrom, bufferTo, 0.25, 0.75, curve);
+
+    /*
+    Samples before the crossfade come from the first buffer, and samples after the crossfade come from the second buffer
+    (the right outline is copied up to the total time, which excludes the last sample frame)
+    */
+    double maxError = 0.0;
+    for (std::size_t i = 0; i + 1 < sampleRate; ++i)
+    {
+        auto t = (static_cast<double>(i) / sampleRate - 0.25) / 0.5;
+        for (std::uint16_t chn = 0; chn < 2; ++chn)
+        {
+            auto expected = bufferFrom.ReadSample(i, chn) * curve.GetFadeOutGain(t) + bufferTo.ReadSample(i, chn) * curve.GetFadeInGain(t);
+            maxError = std::max(maxError, std::abs(buffer.ReadSample(i, chn) - expected));
+        }
+    }
+    CheckNear(maxError, 0.0, 1.0e-5, "FadeWaveBuffers with crossfade curve");
+
+    /* Fading function is equal to the curve of this function */
+    auto fading = [](double& t) { t = t*t*(3.0 - 2.0*t); };
+
+    Ac::WaveBuffer bufferFunc(bufferFrom.GetFormat()), bufferCurve(bufferFrom.GetFormat());
+    bufferFunc.SetSampleFrames(sampleRate);
+    bufferCurve.SetSampleFrames(sampleRate);
+
+    Ac::Synthesizer::FadeWaveBuffers(bufferFunc, bufferFrom, bufferTo, 0.1, 0.6, Ac::Synthesizer::FadingFunction(fading));
+    Ac::Synthesizer::FadeWaveBuffers(bufferCurve, bufferFrom, bufferTo, 0.1, 0.6, Ac::CrossfadeCurve(fading));
+
+    Check(std::equal(bufferFunc.Data(), bufferFunc.Data() + bufferFunc.BufferSize(), bufferCurve.Data()), "FadeWaveBuffers with fading function");
+}
+
+static void TestCrossfadeStream(std::size_t maxFrames)
+{
+    const auto desc = "streams with at most " + std::to_string(maxFrames) + " frames per call: ";
+
+    const std::size_t frames = 20000, fadeBegin = 5000, fadeFrames = 4410;
+
+    const auto bufferA = GenerateBuffer(frames, 440.0);
+    const auto bufferB = GenerateBuffer(frames, 660.0);
+
+    auto sourceA = std::make_shared<BufferStream>(bufferA, maxFrames);
+    auto sourceB = std::make_shared<BufferStream>(bufferB, maxFrames);
+
+    Ac::CrossfadeStream stream(sourceA);
+    Check(stream.GetSource() == sourceA && !stream.IsCrossfading(), desc + "initial source");
+
+    /* Play the first source, then crossfade to the second source (which is read from its beginning) */
+    auto before = ReadStream(stream, fadeBegin, 1000);
+
+    Ac::CrossfadeCurve curve(Ac::CrossfadeShape::EqualPower);
+    stream.CrossfadeTo(sourceB, static_cast<double>(fadeFrames) / sampleRate, curve);
+    Check(stream.IsCrossfading() && stream.GetNextSource() == sourceB, desc + "crossfade is in progress");
+
+    auto after = ReadStream(stream, frames - fadeBegin, 1000);
+    Check(!stream.IsCrossfading() && stream.GetSource() == sourceB, desc + "crossfade is complete");
+
+    double maxError = 0.0;
+    for (std::size_t i = 0; i < fadeBegin; ++i)
+    {
+        for (std::uint16_t chn = 0; chn < 2; ++chn)
+            maxError = std::max(maxError, std::abs(before.ReadSample(i, chn) - bufferA.ReadSample(i, chn)));
+    }
+    CheckNear(maxError, 0.0, 0.0, desc + "first source is passed through");
+
+    maxError = 0.0;
+    for (std::size_t i = 0; i + fadeBegin < frames; ++i)
+    {
+        auto t = static_cast<double>(i) / fadeFrames;
+        for (std::uint16_t chn = 0; chn < 2; ++chn)
+        {
+            auto expected = bufferA.ReadSample(fadeBegin + i, chn) * curve.GetFadeOutGain(t) + bufferB.ReadSample(i, chn) * curve.GetFadeInGain(t);
+            maxError = std::max(maxError, std::abs(after.ReadSample(i, chn) - expected));
+        }
+    }
+    CheckNear(maxError, 0.0, 1.0e-5, desc + "crossfade and second source");
+
+    /* Zero duration switches immediately */
+    stream.CrossfadeTo(std::make_shared<BufferStream>(bufferA, maxFrames), 0.0);
+    Check(!stream.IsCrossfading() && stream.GetSource() != sourceB, desc + "zero duration switches immediately");
+
+    /* Seek completes the crossfade */
+    stream.CrossfadeTo(sourceB, 1.0);
+    stream.Seek(0.0);
+    Check(!stream.IsCrossfading() && stream.GetSource() == sourceB, desc + "Seek completes the crossfade");
+}
+
+static void TestCrossfadeStreamErrors()
+{
+    const auto buffer = GenerateBuffer(1000, 440.0);
+
+    auto throwsInvalidArgument = [](const std::function<void()>& func)
+    {
+        try
+        {
+            func();
+        }
+        catch (const std::invalid_argument&)
+        {
+            return true;
+        }
+        return false;
+    };
+
+    Check(throwsInvalidArgument([]() { Ac::CrossfadeStream stream(nullptr); }), "null source throws std::invalid_argument");
+
+    Ac::CrossfadeStream stream(std::make_shared<BufferStream>(buffer, 1000));
+    Check(throwsInvalidArgument([&]() { stream.CrossfadeTo(nullptr, 1.0); }), "null new source throws std::invalid_argument");
+
+    Ac::WaveBuffer mono(Ac::WaveBufferFormat(sampleRate, 32, 1, true));
+    mono.SetSampleFrames(1000);
+    Check(throwsInvalidArgument([&]() { stream.CrossfadeTo(std::make_shared<BufferStream>(mono, 1000), 1.0); }), "format mismatch throws std::invalid_argument");
+}
+
+int main()
+{
+    try
+    {
+        TestCurves();
+        TestBlend();
+        TestFadeWaveBuffers();
+        TestCrossfadeStream(100000);
+        TestCrossfadeStream(333);
+        TestCrossfadeStreamErrors();
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return CheckResult();
+}
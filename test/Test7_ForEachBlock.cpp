@@ -0,0 +1,200 @@
+/*
+ * Test7_ForEachBlock.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "TestUtil.h"
+
+
+// Returns a wave buffer with a deterministic test signal in all channels.
+static Ac::WaveBuffer GenerateBuffer(std::uint16_t bitsPerSample, std::uint16_t channels, std::size_t frames)
+{
+    Ac::WaveBuffer buffer(Ac::WaveBufferFormat(44100, bitsPerSample, channels));
+    buffer.SetSampleFrames(frames);
+
+    for (std::size_t i = 0; i < frames; ++i)
+    {
+        for (std::uint16_t chn = 0; chn < channels; ++chn)
+            buffer.WriteSample(i, chn, 0.9 * std::sin(0.013 * static_cast<double>(i) * (chn + 1) + chn));
+    }
+
+    return buffer;
+}
+
+// Returns the maximal difference between the samples of both wave buffers.
+static double MaxDifference(const Ac::WaveBuffer& lhs, const Ac::WaveBuffer& rhs)
+{
+    double maxError = 0.0;
+
+    for (std::size_t i = 0; i < lhs.GetSampleFrames(); ++i)
+    {
+        for (std::uint16_t chn = 0; chn < lhs.GetFormat().channels; ++chn)
+            maxError = std::max(maxError, std::abs(lhs.ReadSample(i, chn) - rhs.ReadSample(i, chn)));
+    }
+
+    return maxError;
+}
+
+static void TestBlockRanges(std::uint16_t channels, std::size_t indexBegin, std::size_t indexEnd)
+{
+    const auto desc = std::to_string(channels) + " channel(s), [" + std::to_string(indexBegin) + ", " + std::to_string(indexEnd) + "]: ";
+
+    auto buffer = GenerateBuffer(16, channels, 5000);
+
+    /* Record the ranges of all blocks */
+    std::size_t nextIndex   = indexBegin;
+    bool        contiguous  = true;
+    bool        blockSizes  = true;
+    bool        parameters  = true;
+
+    buffer.ForEachBlock(
+        [&](double* /*samples*/, std::size_t frames, std::uint16_t chn, std::size_t blockBegin, std::uint32_t sampleRate)
+        {
+            if (blockBegin != nextIndex || frames == 0)
+                contiguous = false;
+            if (frames * chn > Ac::WaveBuffer::maxBlockSamples)
+                blockSizes = false;
+            if (chn != channels || sampleRate != 44100)
+                parameters = false;
+            nextIndex = blockBegin + frames;
+        },
+        indexBegin, indexEnd
+    );
+
+    Check(contiguous, desc + "blocks are contiguous and in order");
+    Check(nextIndex == std::min(indexEnd, std::size_t(4999u)) + 1, desc + "blocks cover the (clamped) range exactly once");
+    Check(blockSizes, desc + "blocks do not exceed the maximal number of samples");
+    Check(parameters, desc + "number of channels and sample rate");
+}
+
+static void TestBlockModification(std::uint16_t bitsPerSample, std::uint16_t channels)
+{
+    const auto desc = std::to_string(bitsPerSample) + "-bit, " + std::to_string(channels) + " channel(s): ";
+
+    const auto original = GenerateBuffer(bitsPerSample, channels, 3000);
+
+    /* Modify samples per block (template and function object) and per sample */
+    auto blockBuffer = original;
+    blockBuffer.ForEachBlock(
+        [](double* samples, std::size_t frames, std::uint16_t chn, std::size_t /*indexBegin*/, std::uint32_t /*sampleRate*/)
+        {
+            for (std::size_t i = 0; i < frames * chn; ++i)
+                samples[i] = samples[i] * 0.5 + 0.1;
+        },
+        100, 2500
+    );
+
+    auto functionBuffer = original;
+    Ac::SampleBlockIterationFunction function = [](double* samples, std::size_t frames, std::uint16_t chn, std::size_t /*indexBegin*/, std::uint32_t /*sampleRate*/)
+    {
+        for (std::size_t i = 0; i < frames * chn; ++i)
+            samples[i] = samples[i] * 0.5 + 0.1;
+    };
+    functionBuffer.ForEachBlock(function, 100, 2500);
+
+    auto sampleBuffer = original;
+    for (std::size_t i = 100; i <= 2500; ++i)
+    {
+        for (std::uint16_t chn = 0; chn < channels; ++chn)
+            sampleBuffer.WriteSample(i, chn, sampleBuffer.ReadSample(i, chn) * 0.5 + 0.1);
+    }
+
+    /* Blocks are converted in single precision for 8- and 16-bit formats, so samples can differ by one quantization step */
+    const auto quantization = 1.001 * 2.0 / static_cast<double>((1u << bitsPerSample) - 1u);
+
+    CheckNear(MaxDifference(blockBuffer, sampleBuffer), 0.0, quantization, desc + "block modification equals sample modification");
+    CheckNear(MaxDifference(functionBuffer, blockBuffer), 0.0, 0.0, desc + "function object equals template iterator");
+
+    auto floatBuffer = original;
+    floatBuffer.ForEachBlock<float>(
+        [](float* samples, std::size_t frames, std::uint16_t chn, std::size_t /*indexBegin*/, std::uint32_t /*sampleRate*/)
+        {
+            for (std::size_t i = 0; i < frames * chn; ++i)
+                samples[i] = samples[i] * 0.5f + 0.1f;
+        },
+        100, 2500
+    );
+
+    CheckNear(MaxDifference(floatBuffer, sampleBuffer), 0.0, quantization, desc + "single precision blocks");
+
+    /* The samples outside of the range must not be modified */
+    double outsideError = 0.0;
+    for (std::uint16_t chn = 0; chn < channels; ++chn)
+    {
+        outsideError = std::max(outsideError, std::abs(blockBuffer.ReadSample(std::size_t(99u), chn) - original.ReadSample(std::size_t(99u), chn)));
+        outsideError = std::max(outsideError, std::abs(blockBuffer.ReadSample(std::size_t(2501u), chn) - original.ReadSample(std::size_t(2501u), chn)));
+    }
+    CheckNear(outsideError, 0.0, 0.0, desc + "samples outside of the range are unchanged");
+
+    /* Constant iteration must read the same samples */
+    double blockSum = 0.0, sampleSum = 0.0;
+    original.ForEachBlock(
+        [&blockSum](const double* samples, std::size_t frames, std::uint16_t chn, std::size_t /*indexBegin*/, std::uint32_t /*sampleRate*/)
+        {
+            for (std::size_t i = 0; i < frames * chn; ++i)
+                blockSum += samples[i];
+        }
+    );
+    original.ForEachSample(
+        [&sampleSum](double sample, std::uint16_t /*channel*/, std::size_t /*index*/, double /*timePoint*/)
+        {
+            sampleSum += sample;
+        }
+    );
+    CheckNear(blockSum, sampleSum, 1.0e-6, desc + "constant block iteration equals sample iteration");
+}
+
+static void TestFrameAccess()
+{
+    auto buffer = GenerateBuffer(16, 2, 1000);
+    const auto original = buffer;
+
+    /* Round trip must reproduce the PCM samples */
+    std::vector<double> samples(2000);
+    Check(buffer.ReadFrames(0, 1000, samples.data()) == 1000, "ReadFrames: number of frames");
+    Check(buffer.WriteFrames(0, 1000, samples.data()) == 1000, "WriteFrames: number of frames");
+    CheckNear(MaxDifference(buffer, original), 0.0, 0.0, "ReadFrames/WriteFrames round trip");
+
+    double readError = 0.0;
+    for (std::size_t i = 0; i < 1000; ++i)
+    {
+        readError = std::max(readError, std::abs(samples[i*2    ] - original.ReadSample(i, 0)));
+        readError = std::max(readError, std::abs(samples[i*2 + 1] - original.ReadSample(i, 1)));
+    }
+    CheckNear(readError, 0.0, 1.0e-6, "ReadFrames equals ReadSample");
+
+    /* Ranges exceeding the buffer are clamped */
+    Check(buffer.ReadFrames(990, 100, samples.data()) == 10, "ReadFrames: range is clamped to the end");
+    Check(buffer.ReadFrames(1000, 1, samples.data()) == 0, "ReadFrames: range behind the end");
+    Check(buffer.WriteFrames(995, 100, samples.data()) == 5, "WriteFrames: range is clamped to the end");
+
+    /* Samples are clamped to [-1, 1] */
+    const double clampedSamples[] = { 1.5, -3.0, 1.0, -1.0 };
+    buffer.WriteFrames(0, 2, clampedSamples);
+    CheckNear(buffer.ReadSample(std::size_t(0u), 0), buffer.ReadSample(std::size_t(1u), 0), 0.0, "WriteFrames: sample is clamped to 1");
+    CheckNear(buffer.ReadSample(std::size_t(0u), 1), buffer.ReadSample(std::size_t(1u), 1), 0.0, "WriteFrames: sample is clamped to -1");
+}
+
+int main()
+{
+    try
+    {
+        TestBlockRanges(1, 0, 4999);
+        TestBlockRanges(2, 17, 3000);
+        TestBlockRanges(3, 1000, 1000);
+        TestBlockRanges(6, 4000, 100000);
+        TestBlockModification(16, 1);
+        TestBlockModification(16, 2);
+        TestBlockModification(8, 5);
+        TestFrameAccess();
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return CheckResult();
+}
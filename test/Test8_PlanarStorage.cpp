@@ -0,0 +1,150 @@
+/*
+ * Test8_PlanarStorage.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "TestUtil.h"
+#include <cstring>
+
+
+// One quantization step of 16-bit samples (with a small margin for rounding errors)
+static const double quantization16 = 1.001 * 2.0 / 65535.0;
+
+// Returns a 16-bit wave buffer with a deterministic test signal in all channels.
+static Ac::WaveBuffer GenerateBuffer(std::uint16_t channels, std::size_t frames)
+{
+    Ac::WaveBuffer buffer(Ac::WaveBufferFormat(44100, 16, channels));
+    buffer.SetSampleFrames(frames);
+
+    for (std::size_t i = 0; i < frames; ++i)
+    {
+        for (std::uint16_t chn = 0; chn < channels; ++chn)
+            buffer.WriteSample(i, chn, 0.8 * std::sin(0.021 * static_cast<double>(i) * (chn + 1)) + 0.1 * chn);
+    }
+
+    return buffer;
+}
+
+// Returns the maximal difference between the samples of both wave buffers.
+static double MaxDifference(const Ac::WaveBuffer& lhs, const Ac::WaveBuffer& rhs)
+{
+    double maxError = 0.0;
+
+    for (std::size_t i = 0; i < lhs.GetSampleFrames(); ++i)
+    {
+        for (std::uint16_t chn = 0; chn < lhs.GetFormat().channels; ++chn)
+            maxError = std::max(maxError, std::abs(lhs.ReadSample(i, chn) - rhs.ReadSample(i, chn)));
+    }
+
+    return maxError;
+}
+
+// Returns true if both wave buffers have the same PCM data.
+static bool EqualData(const Ac::WaveBuffer& lhs, const Ac::WaveBuffer& rhs)
+{
+    return (lhs.BufferSize() == rhs.BufferSize() && std::memcmp(lhs.Data(), rhs.Data(), lhs.BufferSize()) == 0);
+}
+
+static void TestStorageConversion(std::uint16_t channels)
+{
+    const auto desc = std::to_string(channels) + " channel(s): ";
+
+    const auto interleaved = GenerateBuffer(channels, 2000);
+
+    Check(interleaved.GetStorage() == Ac::WaveBufferStorage::Interleaved, desc + "interleaved storage by default");
+    Check(interleaved.ChannelData(0) == nullptr, desc + "no channel data for interleaved storage");
+
+    /* Convert to planar storage */
+    auto planar = interleaved;
+    planar.SetStorage(Ac::WaveBufferStorage::PlanarFloat);
+
+    Check(planar.GetStorage() == Ac::WaveBufferStorage::PlanarFloat, desc + "planar storage");
+    Check(planar.GetSampleFrames() == interleaved.GetSampleFrames(), desc + "number of sample frames is unchanged");
+    Check(planar.GetFormat().bitsPerSample == 16 && planar.GetFormat().channels == channels, desc + "format is unchanged");
+    CheckNear(MaxDifference(planar, interleaved), 0.0, 1.0e-6, desc + "planar samples equal interleaved samples");
+
+    bool channelDataEqual = true;
+    for (std::uint16_t chn = 0; chn < channels; ++chn)
+    {
+        auto data = planar.ChannelData(chn);
+        if (data == nullptr)
+        {
+            channelDataEqual = false;
+            break;
+        }
+        for (std::size_t i = 0; i < planar.GetSampleFrames(); ++i)
+        {
+            if (static_cast<double>(data[i]) != planar.ReadSample(i, chn))
+                channelDataEqual = false;
+        }
+    }
+    Check(channelDataEqual, desc + "channel data equals ReadSample");
+
+    /* Round trips back to interleaved storage must reproduce the PCM data exactly */
+    Check(EqualData(planar.Interleaved(), interleaved), desc + "Interleaved() reproduces the PCM data");
+    Check(planar.GetStorage() == Ac::WaveBufferStorage::PlanarFloat, desc + "Interleaved() does not modify the storage");
+
+    auto roundTrip = planar;
+    roundTrip.SetStorage(Ac::WaveBufferStorage::Interleaved);
+    Check(roundTrip.GetStorage() == Ac::WaveBufferStorage::Interleaved, desc + "storage is interleaved again");
+    Check(EqualData(roundTrip, interleaved), desc + "SetStorage round trip reproduces the PCM data");
+
+    /* Block iteration must have the same effect on both storages */
+    auto amplify = [](double* samples, std::size_t frames, std::uint16_t chn, std::size_t /*indexBegin*/, std::uint32_t /*sampleRate*/)
+    {
+        for (std::size_t i = 0; i < frames * chn; ++i)
+            samples[i] *= 0.7;
+    };
+
+    auto amplifiedInterleaved = interleaved;
+    amplifiedInterleaved.ForEachBlock(amplify);
+
+    auto amplifiedPlanar = planar;
+    amplifiedPlanar.ForEachBlock(amplify);
+
+    CheckNear(MaxDifference(amplifiedPlanar.Interleaved(), amplifiedInterleaved), 0.0, quantization16, desc + "block iteration on planar and interleaved storage");
+}
+
+static void TestPlanarSamples()
+{
+    Ac::WaveBuffer buffer(Ac::WaveBufferFormat(44100, 16, 2), Ac::WaveBufferStorage::PlanarFloat);
+    buffer.SetSampleFrames(100);
+
+    Check(buffer.GetStorage() == Ac::WaveBufferStorage::PlanarFloat, "planar storage in constructor");
+    CheckNear(buffer.ReadSample(std::size_t(50u), 1), 0.0, 0.0, "new planar samples are zero");
+
+    /* Planar samples keep the floating-point precision, but are clamped */
+    buffer.WriteSample(std::size_t(10u), 0, 0.123456789);
+    buffer.WriteSample(std::size_t(11u), 1, -2.0);
+
+    CheckNear(buffer.ReadSample(std::size_t(10u), 0), 0.123456789, 1.0e-7, "planar sample precision");
+    CheckNear(buffer.ReadSample(std::size_t(11u), 1), -1.0, 0.0, "planar sample is clamped to -1");
+    CheckNear(buffer.ChannelData(0)[10], 0.123456789, 1.0e-7, "channel data of the first channel");
+    CheckNear(buffer.ChannelData(1)[11], -1.0, 0.0, "channel data of the second channel");
+
+    /* Resizing keeps the samples of all channels */
+    buffer.SetSampleFrames(200);
+    CheckNear(buffer.ReadSample(std::size_t(10u), 0), 0.123456789, 1.0e-7, "samples of the first channel are kept after resizing");
+    CheckNear(buffer.ReadSample(std::size_t(11u), 1), -1.0, 0.0, "samples of the second channel are kept after resizing");
+    CheckNear(buffer.ReadSample(std::size_t(150u), 1), 0.0, 0.0, "new samples after resizing are zero");
+}
+
+int main()
+{
+    try
+    {
+        TestStorageConversion(1);
+        TestStorageConversion(2);
+        TestStorageConversion(3);
+        TestPlanarSamples();
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return CheckResult();
+}
@@ -0,0 +1,227 @@
+/*
+ * Test9_PCMConversion.cpp
+ *
+ * This file is part of the "AcousticsLib" project (Copyright (c) 2016 by Lukas Hermanns)
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "TestUtil.h"
+#include <random>
+#include <cstring>
+
+
+/*
+The bulk functions (ReadFrames, WriteFrames, SetStorage) use the SIMD conversion kernels which are dispatched at runtime,
+whereas ReadSample and WriteSample use the scalar conversion. The lengths below are no multiples of the vector widths,
+so the tails of the kernels are covered as well.
+*/
+
+static const std::size_t maxLength = 70;
+
+// Returns one quantization step of the specified PCM format (with a small margin for rounding errors).
+static double Quantization(std::uint16_t bitsPerSample)
+{
+    return 1.001 * 2.0 / static_cast<double>((1u << bitsPerSample) - 1u);
+}
+
+// Returns a wave buffer with random samples.
+static Ac::WaveBuffer GenerateBuffer(std::uint16_t bitsPerSample, std::uint16_t channels, std::size_t frames, std::mt19937& rng)
+{
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+
+    Ac::WaveBuffer buffer(Ac::WaveBufferFormat(44100, bitsPerSample, channels));
+    buffer.SetSampleFrames(frames);
+
+    for (std::size_t i = 0; i < frames; ++i)
+    {
+        for (std::uint16_t chn = 0; chn < channels; ++chn)
+            buffer.WriteSample(i, chn, dist(rng));
+    }
+
+    /* Include the extreme values */
+    buffer.WriteSample(std::size_t(0u), 0, 1.0);
+    buffer.WriteSample(std::size_t(1u), 0, -1.0);
+    buffer.WriteSample(std::size_t(2u), 0, 0.0);
+
+    return buffer;
+}
+
+// Returns true if both wave buffers have the same PCM data.
+static bool EqualData(const Ac::WaveBuffer& lhs, const Ac::WaveBuffer& rhs)
+{
+    return (lhs.BufferSize() == rhs.BufferSize() && std::memcmp(lhs.Data(), rhs.Data(), lhs.BufferSize()) == 0);
+}
+
+static void TestReadFrames(std::uint16_t bitsPerSample, std::uint16_t channels)
+{
+    const auto desc = "ReadFrames, " + std::to_string(bitsPerSample) + "-bit, " + std::to_string(channels) + " channel(s): ";
+
+    std::mt19937 rng(bitsPerSample + channels);
+    const auto buffer = GenerateBuffer(bitsPerSample, channels, maxLength + 16, rng);
+
+    double  maxErrorDouble  = 0.0;
+    double  maxErrorFloat   = 0.0;
+    bool    numFrames       = true;
+    bool    noOverrun       = true;
+
+    const float sentinel = 12345.0f;
+
+    for (std::size_t offset : { 0u, 1u, 3u, 7u })
+    {
+        for (std::size_t len = 1; len <= maxLength; ++len)
+        {
+            std::vector<double> samplesDouble(len * channels + 4, static_cast<double>(sentinel));
+            std::vector<float> samplesFloat(len * channels + 4, sentinel);
+
+            if (buffer.ReadFrames(offset, len, samplesDouble.data()) != len || buffer.ReadFrames(offset, len, samplesFloat.data()) != len)
+                numFrames = false;
+
+            for (std::size_t i = 0; i < len; ++i)
+            {
+                for (std::uint16_t chn = 0; chn < channels; ++chn)
+                {
+                    auto expected = buffer.ReadSample(offset + i, chn);
+                    maxErrorDouble  = std::max(maxErrorDouble, std::abs(samplesDouble[i*channels + chn] - expected));
+                    maxErrorFloat   = std::max(maxErrorFloat, std::abs(static_cast<double>(samplesFloat[i*channels + chn]) - expected));
+                }
+            }
+
+            for (std::size_t i = len * channels; i < samplesFloat.size(); ++i)
+            {
+                if (samplesDouble[i] != static_cast<double>(sentinel) || samplesFloat[i] != sentinel)
+                    noOverrun = false;
+            }
+        }
+    }
+
+    Check(numFrames, desc + "number of frames");
+    Check(noOverrun, desc + "no samples are written behind the output range");
+    CheckNear(maxErrorDouble, 0.0, 1.0e-6, desc + "double precision equals scalar conversion");
+    CheckNear(maxErrorFloat, 0.0, 1.0e-6, desc + "single precision equals scalar conversion");
+}
+
+static void TestWriteFrames(std::uint16_t bitsPerSample, std::uint16_t channels)
+{
+    const auto desc = "WriteFrames, " + std::to_string(bitsPerSample) + "-bit, " + std::to_string(channels) + " channel(s): ";
+
+    std::mt19937 rng(bitsPerSample * channels);
+    std::uniform_real_distribution<float> dist(-1.2f, 1.2f);
+
+    const auto original = GenerateBuffer(bitsPerSample, channels, maxLength + 16, rng);
+
+    double  maxErrorDouble  = 0.0;
+    double  maxErrorFloat   = 0.0;
+    bool    outsideEqual    = true;
+    bool    roundTrip       = true;
+
+    for (std::size_t offset : { 0u, 1u, 5u, 9u })
+    {
+        for (std::size_t len = 1; len <= maxLength; ++len)
+        {
+            /* Write random samples (including clamped ones) with the bulk and the scalar functions */
+            std::vector<float> samplesFloat(len * channels);
+            for (auto& s : samplesFloat)
+                s = dist(rng);
+            std::vector<double> samplesDouble(samplesFloat.begin(), samplesFloat.end());
+
+            auto bufferFloat    = original;
+            auto bufferDouble   = original;
+            auto bufferScalar   = original;
+
+            bufferFloat.WriteFrames(offset, len, samplesFloat.data());
+            bufferDouble.WriteFrames(offset, len, samplesDouble.data());
+
+            for (std::size_t i = 0; i < len; ++i)
+            {
+                for (std::uint16_t chn = 0; chn < channels; ++chn)
+                    bufferScalar.WriteSample(offset + i, chn, samplesDouble[i*channels + chn]);
+            }
+
+            for (std::size_t i = 0; i < original.GetSampleFrames(); ++i)
+            {
+                for (std::uint16_t chn = 0; chn < channels; ++chn)
+                {
+                    auto expected = bufferScalar.ReadSample(i, chn);
+                    maxErrorFloat   = std::max(maxErrorFloat, std::abs(bufferFloat.ReadSample(i, chn) - expected));
+                    maxErrorDouble  = std::max(maxErrorDouble, std::abs(bufferDouble.ReadSample(i, chn) - expected));
+
+                    if ((i < offset || i >= offset + len) && bufferFloat.ReadSample(i, chn) != original.ReadSample(i, chn))
+                        outsideEqual = false;
+                }
+            }
+
+            /* Reading and writing the same range must reproduce the PCM data */
+            auto bufferRoundTrip = original;
+            std::vector<float> samples(len * channels);
+            bufferRoundTrip.ReadFrames(offset, len, samples.data());
+            bufferRoundTrip.WriteFrames(offset, len, samples.data());
+
+            if (!EqualData(bufferRoundTrip, original))
+                roundTrip = false;
+        }
+    }
+
+    CheckNear(maxErrorFloat, 0.0, Quantization(bitsPerSample), desc + "single precision equals scalar conversion");
+    CheckNear(maxErrorDouble, 0.0, Quantization(bitsPerSample), desc + "double precision equals scalar conversion");
+    Check(outsideEqual, desc + "samples outside of the range are unchanged");
+    Check(roundTrip, desc + "round trip reproduces the PCM data");
+}
+
+static void TestPlanarConversion(std::uint16_t channels)
+{
+    const auto desc = "planar storage, " + std::to_string(channels) + " channel(s): ";
+
+    std::mt19937 rng(channels);
+
+    bool    roundTrip   = true;
+    double  maxError    = 0.0;
+
+    for (std::size_t len = 1; len <= maxLength; ++len)
+    {
+        const auto interleaved = GenerateBuffer(16, channels, len, rng);
+
+        /* Deinterleave into planar storage and compare with the scalar conversion */
+        auto planar = interleaved;
+        planar.SetStorage(Ac::WaveBufferStorage::PlanarFloat);
+
+        for (std::uint16_t chn = 0; chn < channels; ++chn)
+        {
+            auto data = planar.ChannelData(chn);
+            for (std::size_t i = 0; i < len; ++i)
+                maxError = std::max(maxError, std::abs(static_cast<double>(data[i]) - interleaved.ReadSample(i, chn)));
+        }
+
+        /* Interleave again */
+        planar.SetStorage(Ac::WaveBufferStorage::Interleaved);
+        if (!EqualData(planar, interleaved))
+            roundTrip = false;
+    }
+
+    CheckNear(maxError, 0.0, 1.0e-6, desc + "deinterleaved samples equal scalar conversion");
+    Check(roundTrip, desc + "round trip reproduces the PCM data");
+}
+
+int main()
+{
+    try
+    {
+        for (std::uint16_t bitsPerSample : { 8, 16 })
+        {
+            for (std::uint16_t channels : { 1, 2, 3 })
+            {
+                TestReadFrames(bitsPerSample, channels);
+                TestWriteFrames(bitsPerSample, channels);
+            }
+        }
+
+        for (std::uint16_t channels : { 1, 2, 3, 6 })
+            TestPlanarConversion(channels);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return CheckResult();
+}
@@ -50,4 +50,87 @@ static void SleepFor(unsigned long milliSecs = 50)
     std::this_thread::sleep_for(std::chrono::milliseconds(milliSecs));
 }
 
+/* ----- Numeric checks ----- */
 
+static int g_failedChecks = 0;
+
+static void Check(bool condition, const std::string& desc)
+{
+    std::cout << (condition ? "passed: " : "FAILED: ") << desc << std::endl;
+    if (!condition)
+        ++g_failedChecks;
+}
+
+static void CheckNear(double value, double expected, double tolerance, const std::string& desc)
+{
+    bool condition = (std::abs(value - expected) <= tolerance);
+    std::cout << (condition ? "passed: " : "FAILED: ") << desc << " (" << value << ", expected " << expected << " +/- " << tolerance << ')' << std::endl;
+    if (!condition)
+        ++g_failedChecks;
+}
+
+// Returns the exit code of a test program, i.e. zero if all checks passed.
+static int CheckResult()
+{
+    if (g_failedChecks > 0)
+    {
+        std::cerr << g_failedChecks << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "all checks passed" << std::endl;
+    return 0;
+}
+
+
+
+/* ----- Audio files ----- */
+
+// Audio system without an audio device, which is only used to read and write audio files.
+class FileAudioSystem : public Ac::AudioSystem
+{
+
+    public:
+
+        std::string GetVersion() const override
+        {
+            return "File I/O";
+        }
+
+        Ac::AudioLimitations GetLimits() const override
+        {
+            return {};
+        }
+
+        std::unique_ptr<Ac::Sound> CreateSound() override
+        {
+            return nullptr;
+        }
+
+        void SetListenerPosition(const Gs::Vector3f& /*position*/) override
+        {
+        }
+
+        Gs::Vector3f GetListenerPosition() const override
+        {
+            return {};
+        }
+
+        void SetListenerVelocity(const Gs::Vector3f& /*velocity*/) override
+        {
+        }
+
+        Gs::Vector3f GetListenerVelocity() const override
+        {
+            return {};
+        }
+
+        void SetListenerOrientation(const Ac::ListenerOrientation& /*orientation*/) override
+        {
+        }
+
+        Ac::ListenerOrientation GetListenerOrientation() const override
+        {
+            return {};
+        }
+
+};